@@ -147,7 +147,9 @@ Foreach ($sensorFlag in $sensorFlags)
 $publisherFlag = @(`
     'BUILD_PUB_ENVIRO_DIY_PUBLISHER', `
     'BUILD_PUB_DREAM_HOST_PUBLISHER', `
-    'BUILD_PUB_THING_SPEAK_PUBLISHER')
+    'BUILD_PUB_THING_SPEAK_PUBLISHER', `
+    'BUILD_PUB_MQTT_PUBLISHER', `
+    'BUILD_PUB_CBOR_PUBLISHER')
 
 Foreach ($publisherFlag in $publisherFlags)
 {
@@ -1747,6 +1747,66 @@ Variable* sht4xTemp =
 #endif
 
 
+#if defined BUILD_SENSOR_SIMULATED_SENSOR
+// ==========================================================================
+//  Simulated Sensor, for timing a logger without any sensors attached
+// ==========================================================================
+/** Start [simulated_sensor] */
+#include <sensors/SimulatedSensor.h>
+
+// NOTE: Use -1 for any pins that don't apply or aren't being used.
+const int8_t   simPower          = -1;    // Power pin to switch, if any
+const uint32_t simWarmUp         = 500;   // Warm-up time (ms)
+const uint32_t simStabilization  = 1000;  // Stabilization time (ms)
+const uint32_t simMeasurement    = 350;   // Measurement time (ms)
+const uint8_t  simNumberReadings = 5;
+
+// Create a simulated sensor object
+SimulatedSensor simulated(simWarmUp, simStabilization, simMeasurement,
+                          simPower, simNumberReadings);
+
+// Create a value variable pointer for the simulated sensor
+Variable* simulatedValue = new SimulatedSensor_Value(
+    &simulated, "12345678-abcd-1234-ef00-1234567890ab");
+/** End [simulated_sensor] */
+#endif
+
+
+#if defined BUILD_SENSOR_TRACE_REPLAY_SENSOR
+// ==========================================================================
+//  Trace Replay Sensor, for replaying a station's sensor on the bench
+// ==========================================================================
+/** Start [trace_replay_sensor] */
+#include <sensors/TraceReplaySensor.h>
+
+// NOTE: Use -1 for any pins that don't apply or aren't being used.
+const char*   replayTraceFile      = "StationX_trace.txt";  // The trace
+const uint8_t replayTraceIndex     = 2;   // Last variable of the sensor traced
+const uint8_t replayNumValues      = 3;   // Values the sensor traced gave
+const int8_t  replayPower          = -1;  // Power pin to switch, if any
+const uint8_t replayNumberReadings = 1;
+
+// The trace, opened in setup(); each replayed sensor needs its own File
+File replayTrace;
+
+// Create a trace replay sensor object
+TraceReplaySensor replayed(&replayTrace, replayTraceIndex, replayNumValues,
+                           replayPower, replayNumberReadings);
+
+// Create the variable pointers for the replayed values
+Variable* replayedCond = new TraceReplaySensor_Value(
+    &replayed, 0, "specificConductance", "microsiemenPerCentimeter", 1,
+    "12345678-abcd-1234-ef00-1234567890ab", "ReplayedCond");
+Variable* replayedTemp = new TraceReplaySensor_Value(
+    &replayed, 1, "temperature", "degreeCelsius", 1,
+    "12345678-abcd-1234-ef00-1234567890ab", "ReplayedTemp");
+Variable* replayedDepth = new TraceReplaySensor_Value(
+    &replayed, 2, "waterDepth", "millimeter", 0,
+    "12345678-abcd-1234-ef00-1234567890ab", "ReplayedDepth");
+/** End [trace_replay_sensor] */
+#endif
+
+
 #if defined BUILD_SENSOR_TALLY_COUNTER_I2C
 // ==========================================================================
 //    Tally I2C Event Counter for rain or wind reed-switch sensors
@@ -2597,6 +2657,14 @@ Variable* variableList[] = {
     sht4xHumid,
     sht4xTemp,
 #endif
+#if defined BUILD_SENSOR_SIMULATED_SENSOR
+    simulatedValue,
+#endif
+#if defined BUILD_SENSOR_TRACE_REPLAY_SENSOR
+    replayedCond,
+    replayedTemp,
+    replayedDepth,
+#endif
 #if defined BUILD_SENSOR_TALLY_COUNTER_I2C
     tallyEvents,
 #endif
@@ -2796,6 +2864,40 @@ UbidotsPublisher ubidots(dataLogger, &modem.gsmClient, ubidotsToken,
 #endif
 
 
+#if defined BUILD_PUB_MQTT_PUBLISHER
+// ==========================================================================
+//  Generic MQTT Data Publisher
+// ==========================================================================
+/** Start [mqtt_publisher] */
+// The broker to publish to and the topic template.  In the topic, {logger} is
+// replaced with the logger ID and {feature} with the sampling feature UUID.
+const char* mqttBroker = "broker.example.com";
+const char* mqttTopic  = "stations/{logger}/data";
+
+// Create a data publisher for a generic MQTT broker
+#include <publishers/MQTTPublisher.h>
+MQTTPublisher mqttPub(dataLogger, &modem.gsmClient, mqttBroker, 1883,
+                      mqttTopic);
+/** End [mqtt_publisher] */
+#endif
+
+
+#if defined BUILD_PUB_CBOR_PUBLISHER
+// ==========================================================================
+//  Compact Binary (CBOR) Data Publisher
+// ==========================================================================
+/** Start [cbor_publisher] */
+// The receiver for the CBOR records and the path to post them to
+const char* cborHost = "receiver.example.com";
+const char* cborPath = "/api/cbor/";
+
+// Create a data publisher for a CBOR receiver
+#include <publishers/CBORPublisher.h>
+CBORPublisher cborPub(dataLogger, &modem.gsmClient, cborHost, 80, cborPath);
+/** End [cbor_publisher] */
+#endif
+
+
 // ==========================================================================
 //  Working Functions
 // ==========================================================================
@@ -2923,6 +3025,18 @@ void setup() {
     dataLogger.begin();
     /** End [setup_logger] */
 
+#if defined BUILD_SENSOR_TRACE_REPLAY_SENSOR
+    /** Start [setup_trace_replay] */
+    // The trace is read through the run, so the card is kept on and the file
+    // open
+    dataLogger.setSDKeepOpen(true);
+    dataLogger.turnOnSDcard(true);
+    if (!replayTrace.open(replayTraceFile, O_READ)) {
+        Serial.println(F("The trace to replay couldn't be opened!"));
+    }
+    /** End [setup_trace_replay] */
+#endif
+
     /** Start [setup_sensors] */
     // Note:  Please change these battery voltages to match your battery
     // Set up the sensors, except at lowest battery level
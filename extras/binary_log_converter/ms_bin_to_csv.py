@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Convert a ModularSensors binary data file back into the usual CSV file.
+
+Binary files are written by a logger with Logger::setBinaryLogging(true).
+They start with a header block:
+
+    char[4]   "MSLB"
+    uint8     format version (1)
+    uint8     number of variables, n
+    uint16    record size, 4 + 4 * n + 2, or 4 + 8 * n + 2 with offsets
+    uint16    length of the header text
+    uint8[n]  decimal resolution of each variable
+    char[]    the text of the CSV file header
+
+In version 1, it is followed by fixed size records of a uint32 local epoch
+time, one float32 per variable and a CRC-16 (CCITT) of those bytes.  Written
+with Logger::setMeasurementOffsets(true), the floats are followed by one
+int32 per variable, the millisecond offset of its measurement from the record
+time.
+
+In version 2, written with Logger::setBinaryCompression(true), it is followed
+by compressed blocks of records:
+
+    uint16    payload length, L
+    uint16    number of records in the block
+    byte[L]   for each record, the zig-zag varint of the change in the epoch
+              time, then of the change in each value scaled to a whole number
+              by its decimal resolution, then of the change in each
+              measurement offset, if there are any; the first record is
+              relative to 0
+    uint16    CRC-16 (CCITT) of the record count and the payload
+    uint16    payload length again
+
+Everything is little-endian.
+
+Usage:
+    python ms_bin_to_csv.py [--offsets] LOGGER_2024-01-01.bin [output.csv]
+
+If no output file is given, the CSV is written next to the input with a .csv
+extension.  Records or blocks with a bad CRC are reported and skipped.  With
+--offsets, the measurement offsets of a file that has them are added as more
+columns after the values.
+"""
+
+import datetime
+import os
+import struct
+import sys
+
+HEADER_FORMAT = "<4sBBHH"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16 (CCITT, polynomial 0x1021), matching Logger::crc16()."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def format_value(value, resolution):
+    """Format a value the same way Variable::formatValue() does."""
+    if resolution == 0:
+        # The logger truncates to an int16 before printing
+        as_int = int(value) if value == value else 0
+        return str(((as_int + 32768) % 65536) - 32768)
+    return "{:.{}f}".format(value, resolution)
+
+
+def read_zigzag_varint(data, offset):
+    """Read a zig-zag varint, returning the value and the next offset."""
+    result = 0
+    shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError("Varint runs past the end of the block")
+        byte = data[offset]
+        offset += 1
+        result |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return (result >> 1) ^ -(result & 1), offset
+
+
+def decode_block(payload, n_records, n_vars, resolutions, has_offsets):
+    """Decode the records of a compressed block into epochs, values and
+    measurement offsets."""
+    records = []
+    n_fields = 2 * n_vars if has_offsets else n_vars
+    last = [0] * (n_fields + 1)
+    offset = 0
+    for _ in range(n_records):
+        for i in range(n_fields + 1):
+            delta, offset = read_zigzag_varint(payload, offset)
+            last[i] += delta
+        values = [last[i + 1] / 10 ** resolutions[i] for i in range(n_vars)]
+        records.append((last[0], values, last[n_vars + 1 :]))
+    return records
+
+
+def format_time(epoch):
+    """Format a local epoch time the same way the CSV file does."""
+    dt = datetime.datetime(1970, 1, 1) + datetime.timedelta(seconds=epoch)
+    return dt.strftime("%Y-%m-%d %H:%M:%S")
+
+
+def format_line(epoch, values, resolutions, offsets, with_offsets):
+    """Format one record as a line of the CSV file."""
+    text = [format_value(v, r) for v, r in zip(values, resolutions)]
+    if with_offsets:
+        text += [str(ms) for ms in offsets]
+    return (format_time(epoch) + "," + ",".join(text) + "\r\n").encode("ascii")
+
+
+def add_offset_columns(header_text, n_vars):
+    """Add the names of the offset columns to the last line of the header."""
+    lines = header_text.split(b"\r\n")
+    last = len(lines) - 1
+    while last > 0 and not lines[last]:
+        last -= 1
+    names = ",".join("Offset_ms_{}".format(i + 1) for i in range(n_vars))
+    lines[last] += b"," + names.encode("ascii")
+    return b"\r\n".join(lines)
+
+
+def convert(in_path, out_path, with_offsets=False):
+    with open(in_path, "rb") as in_file:
+        data = in_file.read()
+
+    if len(data) < HEADER_SIZE:
+        raise ValueError("File is too short to be a binary data file")
+    magic, version, n_vars, rec_size, text_len = struct.unpack_from(
+        HEADER_FORMAT, data
+    )
+    if magic != b"MSLB":
+        raise ValueError("Not a ModularSensors binary data file")
+    if version not in (1, 2):
+        raise ValueError("Unsupported binary format version {}".format(version))
+    if rec_size not in (4 + 4 * n_vars + 2, 4 + 8 * n_vars + 2):
+        raise ValueError("Record size does not match the number of variables")
+    has_offsets = rec_size == 4 + 8 * n_vars + 2
+    with_offsets = with_offsets and has_offsets
+
+    offset = HEADER_SIZE
+    resolutions = data[offset : offset + n_vars]
+    offset += n_vars
+    header_text = data[offset : offset + text_len]
+    offset += text_len
+
+    if with_offsets:
+        header_text = add_offset_columns(header_text, n_vars)
+    offset_format = "{}i".format(n_vars) if has_offsets else ""
+    record_format = "<I{}f{}H".format(n_vars, offset_format)
+    n_records = 0
+    n_bad = 0
+    with open(out_path, "wb") as out_file:
+        out_file.write(header_text)
+        while version == 2 and offset + 8 <= len(data):
+            length, count = struct.unpack_from("<HH", data, offset)
+            end = offset + 4 + length + 4
+            if end > len(data):
+                break
+            crc, length_after = struct.unpack_from("<HH", data, end - 4)
+            if length_after != length or crc16(data[offset + 2 : end - 4]) != crc:
+                # Without a good length, the next block can't be found
+                print("Stopping at a block with a bad CRC", file=sys.stderr)
+                n_bad += 1
+                break
+            payload = data[offset + 4 : end - 4]
+            records = decode_block(
+                payload, count, n_vars, resolutions, has_offsets
+            )
+            for epoch, values, offsets in records:
+                out_file.write(
+                    format_line(epoch, values, resolutions, offsets, with_offsets)
+                )
+                n_records += 1
+            offset = end
+        while version == 1 and offset + rec_size <= len(data):
+            record = data[offset : offset + rec_size]
+            fields = struct.unpack(record_format, record)
+            if crc16(record[:-2]) != fields[-1]:
+                print(
+                    "Skipping record {} with a bad CRC".format(n_records + n_bad),
+                    file=sys.stderr,
+                )
+                n_bad += 1
+            else:
+                values = fields[1 : 1 + n_vars]
+                offsets = fields[1 + n_vars : -1]
+                out_file.write(
+                    format_line(fields[0], values, resolutions, offsets, with_offsets)
+                )
+                n_records += 1
+            offset += rec_size
+
+    if offset != len(data):
+        print("Ignoring a partial record at the end of the file", file=sys.stderr)
+    print("Converted {} records to {}".format(n_records, out_path))
+    return n_bad == 0
+
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    with_offsets = "--offsets" in args
+    args = [a for a in args if a != "--offsets"]
+    if len(args) < 1:
+        print(__doc__)
+        sys.exit(1)
+    in_path = args[0]
+    if len(args) > 1:
+        out_path = args[1]
+    else:
+        out_path = os.path.splitext(in_path)[0] + ".csv"
+    sys.exit(0 if convert(in_path, out_path, with_offsets) else 1)
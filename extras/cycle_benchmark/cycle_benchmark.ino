@@ -0,0 +1,336 @@
+/** =========================================================================
+ * @file cycle_benchmark.ino
+ * @brief Times a fixed workload through the phases of a logging cycle, so
+ * boards and library versions can be compared by their numbers.
+ *
+ * The workload is the same on every board:
+ * - an update of the processor statistics, two calculated variables and
+ * simulated sensor values that take no time of their own
+ * - the CSV line of the record
+ * - appending the record to a file on the SD card, and committing it
+ * - building the requests of the EnviroDIY and CBOR publishers, written to a
+ * client that throws them away
+ *
+ * each with arrays of 8, 32 and 64 variables.  It needs no modem or sensors,
+ * just the real time clock of the logger and an SD card; without a card, the
+ * SD columns are left empty.  It prints a table of the microseconds of each
+ * phase, averaged over a few runs, and the bytes written, followed by the
+ * board, the library version, the least free RAM there has been since setup,
+ * and the end of the program in flash.
+ *
+ * Build the library with `MS_QUIET_OUTPUT` defined, so the echo of each line
+ * written to the SD card isn't timed with it.  The SD card pins are those of
+ * a Mayfly; change them for other boards.
+ *
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * ======================================================================= */
+
+#include <Arduino.h>
+#include <ModularSensors.h>
+#include <CalibrationCurve.h>
+#include <sensors/ProcessorStats.h>
+#include <sensors/SimulatedSensor.h>
+#include <publishers/CBORPublisher.h>
+#include <publishers/EnviroDIYPublisher.h>
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/pgmspace.h>
+extern char __data_load_end;
+#elif defined(ARDUINO_ARCH_SAMD)
+extern uint32_t __etext;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+#endif
+
+
+// The numbers of variables to time the phases for
+const uint8_t arraySizes[] = {8, 32, 64};
+const uint8_t maxVariables = 64;
+// The number of times each phase is run
+const uint8_t runsPerPhase = 5;
+
+// The logger pins, those of a Mayfly
+const int8_t wakePin      = 31;
+const int8_t sdCardSSPin  = 12;
+const int8_t sdCardPwrPin = -1;
+const int8_t buttonPin    = 21;
+const int8_t greenLED     = 8;
+
+
+// A client that is always connected and throws away what is written to it.
+// It answers with an accepted HTTP response, so the publisher reads a
+// response without waiting for its timeout.
+class NullClient : public Client {
+ public:
+    void resetCount(void) {
+        bytesWritten = 0;
+    }
+
+    int connect(IPAddress, uint16_t) override {
+        return open();
+    }
+    int connect(const char*, uint16_t) override {
+        return open();
+    }
+    size_t write(uint8_t) override {
+        bytesWritten++;
+        return 1;
+    }
+    size_t write(const uint8_t*, size_t size) override {
+        bytesWritten += size;
+        return size;
+    }
+    int available() override {
+        return _connected ? strlen(_reply) - _replyPos : 0;
+    }
+    int read() override {
+        return available() ? _reply[_replyPos++] : -1;
+    }
+    int read(uint8_t* buf, size_t size) override {
+        size_t n = 0;
+        while (n < size && available()) buf[n++] = _reply[_replyPos++];
+        return n;
+    }
+    int peek() override {
+        return available() ? _reply[_replyPos] : -1;
+    }
+    void flush() override {}
+    void stop() override {
+        _connected = false;
+    }
+    uint8_t connected() override {
+        return _connected;
+    }
+    operator bool() override {
+        return _connected;
+    }
+
+    uint32_t bytesWritten = 0;
+
+ private:
+    int open(void) {
+        _connected = true;
+        _replyPos  = 0;
+        return 1;
+    }
+
+    const char* _reply =
+        "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n";
+    size_t _replyPos  = 0;
+    bool   _connected = false;
+};
+NullClient nullClient;
+
+
+// ==========================================================================
+//  The variables, logger and publishers
+// ==========================================================================
+ProcessorStats mcuBoard("bench");
+// The simulated values take none of the update's time themselves
+SimulatedSensor simulated(0, 0, 0);
+
+char      uuids[maxVariables][37];
+Variable* variableList[maxVariables];
+// Every array uses the start of the same list
+VariableArray varArray;
+Logger        dataLogger("bench", 5, &varArray);
+
+// The calculated variables use the first two simulated values
+const uint8_t                 firstSimulated = 6;
+const TemperatureCompensation compensation(0.019);
+
+float compensatedValue(void) {
+    return compensation.apply(variableList[firstSimulated]->getValue(),
+                              variableList[firstSimulated + 1]->getValue());
+}
+float batteryPercent(void) {
+    float volts = variableList[0]->getValue();
+    if (volts == -9999) return -9999;
+    return (volts - 3.3) / (4.2 - 3.3) * 100;
+}
+
+const char* registrationToken = "12345678-abcd-1234-ef00-1234567890ab";
+const char* samplingFeature   = "12345678-abcd-1234-ef00-1234567890ab";
+
+EnviroDIYPublisher EnviroDIYPOST(dataLogger, registrationToken,
+                                 samplingFeature);
+CBORPublisher      cbor(dataLogger, &nullClient, "data.example.com", 80,
+                        "/records");
+
+
+// ==========================================================================
+//  Measuring the phases
+// ==========================================================================
+// The end of the program in flash; on the SAMD boards, this includes the
+// bootloader below the program
+uint32_t getFlashEnd(void) {
+#if defined(ARDUINO_ARCH_AVR)
+    return pgm_get_far_address(__data_load_end);
+#elif defined(ARDUINO_ARCH_SAMD)
+    return reinterpret_cast<uint32_t>(&__etext) +
+        (reinterpret_cast<uint32_t>(&__data_end__) -
+         reinterpret_cast<uint32_t>(&__data_start__));
+#else
+    return 0;
+#endif
+}
+
+// Print one column of the table; a negative time leaves it empty
+void printColumn(int32_t value) {
+    Serial.print(F(" | "));
+    if (value >= 0) Serial.print(value);
+}
+
+// Time one publisher's request, returning the mean microseconds
+int32_t timePublisher(dataPublisher& publisher, uint32_t& bytes) {
+    uint32_t elapsed = 0;
+    for (uint8_t run = 0; run < runsPerPhase; run++) {
+        nullClient.resetCount();
+        uint32_t start = micros();
+        publisher.publishData(&nullClient);
+        elapsed += micros() - start;
+    }
+    bytes = nullClient.bytesWritten;
+    return elapsed / runsPerPhase;
+}
+
+void benchmark(uint8_t size, bool haveCard) {
+    static char line[768];
+    varArray.begin(size, variableList);
+    varArray.setupSensors();
+
+    // The update
+    uint32_t elapsed = 0;
+    for (uint8_t run = 0; run < runsPerPhase; run++) {
+        uint32_t start = micros();
+        varArray.completeUpdate();
+        elapsed += micros() - start;
+    }
+    int32_t update_us = elapsed / runsPerPhase;
+    Logger::markTime();
+
+    // The CSV line
+    size_t lineLen = 0;
+    elapsed        = 0;
+    for (uint8_t run = 0; run < runsPerPhase; run++) {
+        uint32_t start = micros();
+        lineLen        = dataLogger.formatSensorDataCSV(line, sizeof(line));
+        elapsed += micros() - start;
+    }
+    int32_t csv_us = elapsed / runsPerPhase;
+
+    // Appending to the SD card, and committing; the first record opens the
+    // file, so it isn't timed
+    int32_t append_us = -1;
+    int32_t commit_us = -1;
+    if (haveCard) {
+        char fileName[16];
+        snprintf(fileName, sizeof(fileName), "bench_%02u.csv", size);
+        dataLogger.setFileName(fileName);
+        dataLogger.createLogFile(true);
+        dataLogger.logToSD();
+        uint32_t appendSum = 0;
+        uint32_t commitSum = 0;
+        for (uint8_t run = 0; run < runsPerPhase; run++) {
+            uint32_t start = micros();
+            dataLogger.logToSD();
+            appendSum += micros() - start;
+            start = micros();
+            dataLogger.syncLogFile();
+            commitSum += micros() - start;
+        }
+        dataLogger.syncLogFile(true);
+        append_us = appendSum / runsPerPhase;
+        commit_us = commitSum / runsPerPhase;
+    }
+
+    // The publishers
+    uint32_t enviroDIYBytes = 0;
+    uint32_t cborBytes      = 0;
+    int32_t  enviroDIY_us   = timePublisher(EnviroDIYPOST, enviroDIYBytes);
+    int32_t  cbor_us        = timePublisher(cbor, cborBytes);
+
+    Serial.print(F("| "));
+    Serial.print(size);
+    printColumn(update_us);
+    printColumn(csv_us);
+    printColumn(lineLen);
+    printColumn(append_us);
+    printColumn(commit_us);
+    printColumn(enviroDIY_us);
+    printColumn(enviroDIYBytes);
+    printColumn(cbor_us);
+    printColumn(cborBytes);
+    Serial.println(F(" |"));
+}
+
+
+// ==========================================================================
+//  Arduino Setup Function
+// ==========================================================================
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("Cycle benchmark"));
+
+    for (uint8_t i = 0; i < maxVariables; i++) {
+        snprintf(uuids[i], sizeof(uuids[i]),
+                 "12345678-abcd-1234-ef00-1234567890%02x", i);
+    }
+    variableList[0] = new ProcessorStats_Battery(&mcuBoard, uuids[0]);
+    variableList[1] = new ProcessorStats_FreeRam(&mcuBoard, uuids[1]);
+    variableList[2] = new ProcessorStats_SampleNumber(&mcuBoard, uuids[2]);
+    variableList[3] = new ProcessorStats_MinFreeRam(&mcuBoard, uuids[3]);
+    variableList[4] = new Variable(batteryPercent, 1, "batteryVoltage",
+                                   "percent", "BattPct", uuids[4]);
+    variableList[5] = new Variable(compensatedValue, 3, "specificConductance",
+                                   "microsiemenPerCentimeter", "CompCond",
+                                   uuids[5]);
+    for (uint8_t i = firstSimulated; i < maxVariables; i++) {
+        variableList[i] = new SimulatedSensor_Value(&simulated, uuids[i]);
+    }
+    simulated.setValues(12.345, 0);
+
+    dataLogger.setLoggerPins(wakePin, sdCardSSPin, sdCardPwrPin, buttonPin,
+                             greenLED);
+    dataLogger.begin();
+    // Keep the file open, so appending and committing are timed apart
+    dataLogger.setSDKeepOpen(true, 0, 0, false);
+    // Read every response, so the time includes parsing it
+    EnviroDIYPOST.setResponseMode(dataPublisher::responseWait);
+    cbor.setResponseMode(dataPublisher::responseWait);
+}
+
+
+// ==========================================================================
+//  Arduino Loop Function
+// ==========================================================================
+void loop() {
+    dataLogger.turnOnSDcard(true);
+    bool haveCard = dataLogger.createLogFile("bench.txt");
+
+    Serial.println(F("| vars | update us | CSV us | CSV bytes | SD append us "
+                     "| SD commit us | EnviroDIY us | EnviroDIY bytes "
+                     "| CBOR us | CBOR bytes |"));
+    Serial.println(F("|---|---|---|---|---|---|---|---|---|---|"));
+    for (uint8_t size : arraySizes) benchmark(size, haveCard);
+    dataLogger.turnOffSDcard(true);
+
+    // The least free RAM is measured by an update
+    mcuBoard.update();
+    Serial.print(F("Board: "));
+    Serial.println(mcuBoard.getSensorLocation());
+    Serial.print(F("ModularSensors: "));
+    Serial.println(F(MODULAR_SENSORS_VERSION));
+    Serial.print(F("Clock: "));
+    Serial.print(F_CPU / 1000000L);
+    Serial.println(F(" MHz"));
+    Serial.print(F("Least free RAM: "));
+    Serial.print(static_cast<int32_t>(variableList[3]->getValue()));
+    Serial.println(F(" bytes"));
+    Serial.print(F("End of program in flash: "));
+    Serial.print(getFlashEnd());
+    Serial.println(F(" bytes"));
+    Serial.println();
+    delay(10000);
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Split a current logger trace into the phases of each logging cycle.
+
+A logger built with MS_PHASE_MARKER_PIN defined toggles that pin at the start
+of each phase of a cycle: wake, power up, measure, SD commit, modem attach,
+publish and sleep.  It also adds a line with the milliseconds of each phase to
+the <logger id>_phases.csv file on its SD card; phases with nothing to do in a
+cycle are left empty and are not marked on the pin.
+
+Record the logger's supply current and the marker pin with an external
+current logger and export the trace as a CSV file with a header row and the
+columns:
+
+    time in seconds, current in amps, marker pin level[, supply volts]
+
+The marker can be a logic level or a voltage; it is split halfway between
+its lowest and highest values.  Without a supply voltage column, the voltage
+given on the command line is used.
+
+Usage:
+    python ms_phase_energy.py LOGGER_phases.csv trace.csv [volts] [out.csv]
+
+Each cycle in the phases file is matched to the marker edges whose spacing
+agrees with its phase durations, so the trace may start or stop part way
+through a cycle.  The energy of each phase of each matched cycle is written,
+in millijoules, to the output file or printed, followed by the mean of each
+phase.  The sleep phase runs until the next edge, when the processor wakes.
+"""
+
+import csv
+import sys
+
+PHASES = [
+    "Wake",
+    "Power up",
+    "Measure",
+    "SD commit",
+    "Modem attach",
+    "Publish",
+    "Sleep",
+]
+SLEEP = len(PHASES) - 1
+
+# How far the spacing of the edges may be from the logged durations; millis()
+# counts whole milliseconds and the two clocks drift apart a little
+TOLERANCE_S = 0.005
+TOLERANCE_FRACTION = 0.02
+
+
+def read_phases(path):
+    """Read the cycle time and the marked phase durations of each cycle."""
+    cycles = []
+    with open(path, newline="") as phase_file:
+        reader = csv.reader(phase_file)
+        next(reader, None)
+        for row in reader:
+            if len(row) < SLEEP + 1:
+                continue
+            durations = [
+                float(cell) / 1000.0 if cell.strip() else None
+                for cell in row[1 : SLEEP + 1]
+            ]
+            cycles.append((row[0], durations))
+    return cycles
+
+
+def read_trace(path, volts):
+    """Read the times, the cumulative energy in joules and the marker edges."""
+    times = []
+    powers = []
+    markers = []
+    with open(path, newline="") as trace_file:
+        reader = csv.reader(trace_file)
+        next(reader, None)
+        for row in reader:
+            try:
+                time = float(row[0])
+                current = float(row[1])
+                marker = float(row[2])
+                supply = float(row[3]) if len(row) > 3 and row[3] else volts
+            except (ValueError, IndexError):
+                continue
+            if supply is None:
+                raise ValueError("The trace has no voltage; give the supply volts")
+            times.append(time)
+            powers.append(current * supply)
+            markers.append(marker)
+    if len(times) < 2:
+        raise ValueError("The trace has too few samples")
+
+    energy = [0.0]
+    for i in range(1, len(times)):
+        step = (powers[i] + powers[i - 1]) / 2.0 * (times[i] - times[i - 1])
+        energy.append(energy[-1] + step)
+
+    threshold = (min(markers) + max(markers)) / 2.0
+    edges = []
+    high = markers[0] > threshold
+    for i in range(1, len(markers)):
+        if (markers[i] > threshold) != high:
+            high = not high
+            edges.append(i)
+    return times, energy, edges
+
+
+def spacing_matches(times, edges, start, durations):
+    """Check if the edges from start are spaced by the given durations."""
+    for i, duration in enumerate(durations):
+        spacing = times[edges[start + i + 1]] - times[edges[start + i]]
+        if abs(spacing - duration) > TOLERANCE_S + TOLERANCE_FRACTION * duration:
+            return False
+    return True
+
+
+def split_cycles(cycles, times, energy, edges):
+    """Give the cycle time and the energy of each phase of matched cycles."""
+    results = []
+    position = 0
+    for cycle_time, durations in cycles:
+        marked = [i for i, d in enumerate(durations) if d is not None]
+        marked.append(SLEEP)
+        spacings = [durations[i] for i in marked[:-1]]
+        n_edges = len(marked)
+
+        start = position
+        while start + n_edges <= len(edges) and not spacing_matches(
+            times, edges, start, spacings
+        ):
+            start += 1
+        if start + n_edges > len(edges):
+            print("No marker edges match the cycle at " + cycle_time, file=sys.stderr)
+            continue
+
+        phase_energy = [None] * len(PHASES)
+        for i, phase in enumerate(marked):
+            begin = edges[start + i]
+            if start + i + 1 < len(edges):
+                end = edges[start + i + 1]
+            elif phase == SLEEP:
+                # The trace ended before the processor woke again
+                continue
+            phase_energy[phase] = (energy[end] - energy[begin]) * 1000.0
+        results.append((cycle_time, phase_energy))
+        # The edge ending the sleep is the wake of the next cycle
+        position = start + n_edges
+    return results
+
+
+def write_results(results, out_file):
+    writer = csv.writer(out_file, lineterminator="\n")
+    writer.writerow(["Cycle time"] + [p + " mJ" for p in PHASES] + ["Total mJ"])
+    sums = [0.0] * len(PHASES)
+    counts = [0] * len(PHASES)
+    for cycle_time, phase_energy in results:
+        row = [cycle_time]
+        for i, value in enumerate(phase_energy):
+            if value is None:
+                row.append("")
+            else:
+                row.append("{:.3f}".format(value))
+                sums[i] += value
+                counts[i] += 1
+        total = sum(v for v in phase_energy if v is not None)
+        row.append("{:.3f}".format(total))
+        writer.writerow(row)
+
+    means = [
+        "{:.3f}".format(s / c) if c else "" for s, c in zip(sums, counts)
+    ]
+    mean_total = sum(s / c for s, c in zip(sums, counts) if c)
+    writer.writerow(["Mean"] + means + ["{:.3f}".format(mean_total)])
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+    volts = float(sys.argv[3]) if len(sys.argv) > 3 else None
+    cycles = read_phases(sys.argv[1])
+    times, energy, edges = read_trace(sys.argv[2], volts)
+    results = split_cycles(cycles, times, energy, edges)
+    if len(sys.argv) > 4:
+        with open(sys.argv[4], "w", newline="") as out_file:
+            write_results(results, out_file)
+    else:
+        write_results(results, sys.stdout)
+    print(
+        "Matched {} of {} cycles to {} marker edges".format(
+            len(results), len(cycles), len(edges)
+        ),
+        file=sys.stderr,
+    )
+    sys.exit(0 if results else 1)
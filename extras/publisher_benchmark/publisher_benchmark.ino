@@ -0,0 +1,249 @@
+/** =========================================================================
+ * @file publisher_benchmark.ino
+ * @brief Times how long each publisher takes to build and write its request
+ * for arrays of 8, 32 and 64 variables, with no network.
+ *
+ * The requests are written to a client that throws them away, so this times
+ * only the work of the board; it needs no modem, sensors or SD card, just the
+ * real time clock of the logger.  For each publisher and array it prints:
+ * - the microseconds per request, averaged over a few runs
+ * - the bytes written to the client
+ * - how far the heap grew, which is where String formatting shows up; the
+ * allocations themselves can't be counted without hooking malloc()
+ * - the most stack used, from painting the free RAM before each run
+ *
+ * Run it before and after a change to the publishers to see what it did.
+ *
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * ======================================================================= */
+
+#include <Arduino.h>
+#include <ModularSensors.h>
+#include <MemoryReport.h>
+#include <sensors/SimulatedSensor.h>
+#include <publishers/DreamHostPublisher.h>
+#include <publishers/EnviroDIYPublisher.h>
+#include <publishers/ThingSpeakPublisher.h>
+#include <publishers/UbidotsPublisher.h>
+
+
+// The numbers of variables to time the requests for
+const uint8_t arraySizes[] = {8, 32, 64};
+const uint8_t maxVariables = 64;
+// The number of times each request is built
+const uint8_t runsPerRequest = 5;
+// The bytes of the free RAM, above the heap, to leave unpainted
+const uint16_t paintMargin = 64;
+// The byte the free RAM is painted with
+const uint8_t paintByte = 0xA5;
+
+
+// A client that is always connected and throws away what is written to it.
+// It answers with whatever reply it's given, so the publisher reads a
+// response without waiting for its timeout.
+class NullClient : public Client {
+ public:
+    void setReply(const uint8_t* reply, size_t replyLen) {
+        _reply    = reply;
+        _replyLen = replyLen;
+    }
+    void resetCount(void) {
+        bytesWritten = 0;
+    }
+
+    int connect(IPAddress, uint16_t) override {
+        return open();
+    }
+    int connect(const char*, uint16_t) override {
+        return open();
+    }
+    size_t write(uint8_t) override {
+        bytesWritten++;
+        return 1;
+    }
+    size_t write(const uint8_t*, size_t size) override {
+        bytesWritten += size;
+        return size;
+    }
+    int available() override {
+        return _connected ? _replyLen - _replyPos : 0;
+    }
+    int read() override {
+        return available() ? _reply[_replyPos++] : -1;
+    }
+    int read(uint8_t* buf, size_t size) override {
+        size_t n = 0;
+        while (n < size && available()) buf[n++] = _reply[_replyPos++];
+        return n;
+    }
+    int peek() override {
+        return available() ? _reply[_replyPos] : -1;
+    }
+    void flush() override {}
+    void stop() override {
+        _connected = false;
+    }
+    uint8_t connected() override {
+        return _connected;
+    }
+    operator bool() override {
+        return _connected;
+    }
+
+    uint32_t bytesWritten = 0;
+
+ private:
+    int open(void) {
+        _connected = true;
+        _replyPos  = 0;
+        return 1;
+    }
+
+    const uint8_t* _reply      = nullptr;
+    size_t         _replyLen   = 0;
+    size_t         _replyPos   = 0;
+    bool           _connected  = false;
+};
+NullClient nullClient;
+
+// The replies: an accepted HTTP request, and the MQTT CONNACK
+const char    httpReply[] = "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n";
+const uint8_t mqttReply[] = {0x20, 0x02, 0x00, 0x00};
+
+
+// ==========================================================================
+//  The variables, logger and publishers
+// ==========================================================================
+// The times don't matter; the sensor is only updated once for each array
+SimulatedSensor simulated(0, 0, 0);
+
+char      uuids[maxVariables][37];
+Variable* variableList[maxVariables];
+// Every array uses the start of the same list
+VariableArray varArray;
+Logger        dataLogger("benchmark", 5, &varArray);
+
+const char* registrationToken   = "12345678-abcd-1234-ef00-1234567890ab";
+const char* samplingFeature     = "12345678-abcd-1234-ef00-1234567890ab";
+const char* thingSpeakMQTTKey   = "XXXXXXXXXXXXXXXX";
+const char* thingSpeakChannelID = "######";
+const char* thingSpeakChannelKey = "XXXXXXXXXXXXXXXX";
+const char* ubidotsToken        = "XXXXXXXXXXXXXXXX";
+const char* ubidotsDeviceID     = "######";
+
+EnviroDIYPublisher  EnviroDIYPOST(dataLogger, registrationToken,
+                                  samplingFeature);
+DreamHostPublisher  DreamHostGET(dataLogger, "http://www.example.com/dh.php?");
+ThingSpeakPublisher TsMqtt(dataLogger, thingSpeakMQTTKey, thingSpeakChannelID,
+                           thingSpeakChannelKey);
+UbidotsPublisher    ubidots(dataLogger, ubidotsToken, ubidotsDeviceID);
+
+
+// ==========================================================================
+//  Measuring the stack
+// ==========================================================================
+// Paint the free RAM between the heap and the stack
+void paintStack(void) {
+    uint8_t  here = 0;
+    uint8_t* top  = reinterpret_cast<uint8_t*>(MemoryReport::getHeapTop());
+    if (top == nullptr) return;
+    for (uint8_t* p = top + paintMargin; p < &here - paintMargin; p++) {
+        *p = paintByte;
+    }
+}
+// The bytes of the painted RAM that are no longer painted, counted down from
+// where the paint started; the paint below the stack used is left as it was
+int32_t stackUsedSincePaint(void) {
+    uint8_t  here = 0;
+    uint8_t* top  = reinterpret_cast<uint8_t*>(MemoryReport::getHeapTop());
+    if (top == nullptr) return -9999;
+    uint8_t* p = top + paintMargin;
+    while (p < &here - paintMargin && *p == paintByte) p++;
+    return &here - paintMargin - p;
+}
+
+
+// ==========================================================================
+//  Timing one publisher
+// ==========================================================================
+void benchmark(dataPublisher& publisher, const char* name, bool mqtt) {
+    if (mqtt) {
+        nullClient.setReply(mqttReply, sizeof(mqttReply));
+    } else {
+        nullClient.setReply(reinterpret_cast<const uint8_t*>(httpReply),
+                            strlen(httpReply));
+    }
+
+    char*    heapBefore = MemoryReport::getHeapTop();
+    uint32_t elapsed    = 0;
+    int32_t  peakStack  = 0;
+    int16_t  response   = 0;
+    for (uint8_t run = 0; run < runsPerRequest; run++) {
+        nullClient.resetCount();
+        paintStack();
+        uint32_t start = micros();
+        response       = publisher.publishData(&nullClient);
+        elapsed += micros() - start;
+        int32_t stack = stackUsedSincePaint();
+        if (stack > peakStack) peakStack = stack;
+    }
+    int32_t heapGrowth = MemoryReport::getHeapTop() - heapBefore;
+
+    Serial.print(F("  "));
+    Serial.print(name);
+    Serial.print(F(": "));
+    Serial.print(elapsed / runsPerRequest);
+    Serial.print(F(" us, "));
+    Serial.print(nullClient.bytesWritten);
+    Serial.print(F(" bytes, heap grew "));
+    Serial.print(heapGrowth);
+    Serial.print(F(" bytes, stack up to "));
+    Serial.print(peakStack);
+    Serial.print(F(" bytes, response "));
+    Serial.println(response);
+}
+
+
+// ==========================================================================
+//  Arduino Setup Function
+// ==========================================================================
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("Publisher benchmark"));
+
+    for (uint8_t i = 0; i < maxVariables; i++) {
+        snprintf(uuids[i], sizeof(uuids[i]),
+                 "12345678-abcd-1234-ef00-1234567890%02x", i);
+        variableList[i] = new SimulatedSensor_Value(&simulated, uuids[i]);
+    }
+    simulated.setValues(12.345, 0);
+
+    dataLogger.begin();
+    Logger::markTime();
+    // Read every response, so the time includes parsing it
+    EnviroDIYPOST.setResponseMode(dataPublisher::responseWait);
+    DreamHostGET.setResponseMode(dataPublisher::responseWait);
+    ubidots.setResponseMode(dataPublisher::responseWait);
+}
+
+
+// ==========================================================================
+//  Arduino Loop Function
+// ==========================================================================
+void loop() {
+    for (uint8_t size : arraySizes) {
+        varArray.begin(size, variableList);
+        varArray.setupSensors();
+        varArray.completeUpdate();
+
+        Serial.print(size);
+        Serial.println(F(" variables:"));
+        benchmark(EnviroDIYPOST, "EnviroDIY", false);
+        benchmark(DreamHostGET, "DreamHost", false);
+        benchmark(TsMqtt, "ThingSpeak", true);
+        benchmark(ubidots, "Ubidots", false);
+    }
+    Serial.println();
+    delay(10000);
+}
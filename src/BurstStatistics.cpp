@@ -0,0 +1,170 @@
+/**
+ * @file BurstStatistics.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the StreamingQuantile and BurstStatistics classes.
+ */
+
+#include "BurstStatistics.h"
+
+
+// The constructor
+StreamingQuantile::StreamingQuantile(float quantile) {
+    setQuantile(quantile);
+}
+
+
+void StreamingQuantile::setQuantile(float quantile) {
+    _quantile = quantile;
+    if (_quantile < 0) _quantile = 0;
+    if (_quantile > 1) _quantile = 1;
+    reset();
+}
+
+
+// The markers start at positions 1-5 and aim for the minimum, the quantile
+// and its halfway points, and the maximum
+void StreamingQuantile::reset(void) {
+    _count = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        _heights[i]   = 0;
+        _positions[i] = i + 1;
+    }
+    _desired[0] = 1;
+    _desired[1] = 1 + 2 * _quantile;
+    _desired[2] = 1 + 4 * _quantile;
+    _desired[3] = 3 + 2 * _quantile;
+    _desired[4] = 5;
+}
+
+
+void StreamingQuantile::add(float value) {
+    // The first five values become the markers, kept in order
+    if (_count < 5) {
+        uint8_t i = _count++;
+        while (i > 0 && _heights[i - 1] > value) {
+            _heights[i] = _heights[i - 1];
+            i--;
+        }
+        _heights[i] = value;
+        return;
+    }
+    if (_count < 0xFFFF) _count++;
+
+    // Find the cell the value falls in, stretching the ends if needed
+    uint8_t cell;
+    if (value < _heights[0]) {
+        _heights[0] = value;
+        cell        = 0;
+    } else if (value >= _heights[4]) {
+        _heights[4] = value;
+        cell        = 3;
+    } else {
+        cell = 0;
+        while (value >= _heights[cell + 1]) cell++;
+    }
+
+    // Every marker above the cell moves up one place
+    for (uint8_t i = cell + 1; i < 5; i++) _positions[i]++;
+    _desired[1] += _quantile / 2;
+    _desired[2] += _quantile;
+    _desired[3] += (1 + _quantile) / 2;
+    _desired[4] += 1;
+
+    // Nudge each middle marker one place toward where it should be
+    for (uint8_t i = 1; i < 4; i++) {
+        float   offset = _desired[i] - _positions[i];
+        int32_t below  = static_cast<int32_t>(_positions[i]) -
+            _positions[i - 1];
+        int32_t above = static_cast<int32_t>(_positions[i + 1]) -
+            _positions[i];
+        if (!((offset >= 1 && above > 1) || (offset <= -1 && below > 1))) {
+            continue;
+        }
+        int8_t step = offset > 0 ? 1 : -1;
+
+        // Piecewise-parabolic prediction, falling back to linear if it would
+        // put the marker out of order
+        float slopeAbove = (_heights[i + 1] - _heights[i]) / above;
+        float slopeBelow = (_heights[i] - _heights[i - 1]) / below;
+        float height     = _heights[i] +
+            static_cast<float>(step) / (above + below) *
+                ((below + step) * slopeAbove + (above - step) * slopeBelow);
+        if (height <= _heights[i - 1] || height >= _heights[i + 1]) {
+            height = _heights[i] + step * (step > 0 ? slopeAbove : slopeBelow);
+        }
+        _heights[i] = height;
+        _positions[i] += step;
+    }
+}
+
+
+float StreamingQuantile::get(void) {
+    if (_count == 0) return -9999;
+    if (_count >= 5) return _heights[2];
+    // Interpolate between the few sorted values there are
+    float   place = _quantile * (_count - 1);
+    uint8_t lower = static_cast<uint8_t>(place);
+    if (lower >= _count - 1) return _heights[_count - 1];
+    return _heights[lower] +
+        (place - lower) * (_heights[lower + 1] - _heights[lower]);
+}
+
+
+// The constructor
+BurstStatistics::BurstStatistics(float percentile)
+    : _median(0.5),
+      _percentile(percentile / 100) {
+    reset();
+}
+
+
+void BurstStatistics::setPercentile(float percentile) {
+    _percentile.setQuantile(percentile / 100);
+    reset();
+}
+
+
+void BurstStatistics::reset(void) {
+    _count = 0;
+    _mean  = 0;
+    _m2    = 0;
+    _min   = -9999;
+    _max   = -9999;
+    _median.reset();
+    _percentile.reset();
+}
+
+
+// The mean and spread use Welford's method, the same as the sensor results
+void BurstStatistics::add(float value) {
+    if (value == -9999 || isnan(value)) return;
+    if (_count == 0xFFFF) return;
+    _count++;
+    float delta = value - _mean;
+    _mean += delta / _count;
+    _m2 += delta * (value - _mean);
+    if (_count == 1 || value < _min) _min = value;
+    if (_count == 1 || value > _max) _max = value;
+    _median.add(value);
+    _percentile.add(value);
+}
+
+
+float BurstStatistics::get(burstStatistic statistic) {
+    if (_count == 0) return statistic == BURST_COUNT ? 0 : -9999;
+    switch (statistic) {
+        case BURST_MEAN: return _mean;
+        case BURST_MEDIAN: return _median.get();
+        case BURST_MIN: return _min;
+        case BURST_MAX: return _max;
+        case BURST_STD_DEV:
+            if (_count < 2) return -9999;
+            return sqrt(_m2 / (_count - 1));
+        case BURST_PERCENTILE: return _percentile.get();
+        case BURST_COUNT: return _count;
+        default: return -9999;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file BurstStatistics.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the BurstStatistics class, which reduces a burst of fast
+ * samples to its summary statistics one sample at a time.
+ */
+
+// Header Guards
+#ifndef SRC_BURSTSTATISTICS_H_
+#define SRC_BURSTSTATISTICS_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief The statistics a burst of samples can be reduced to.
+ */
+typedef enum burstStatistic {
+    BURST_MEAN = 0,    ///< The mean of the samples
+    BURST_MEDIAN,      ///< The median of the samples
+    BURST_MIN,         ///< The smallest sample
+    BURST_MAX,         ///< The largest sample
+    BURST_STD_DEV,     ///< The sample standard deviation
+    BURST_PERCENTILE,  ///< The chosen percentile of the samples
+    BURST_COUNT        ///< The number of good samples
+} burstStatistic;
+
+/**
+ * @brief A single quantile estimated from a stream of values.
+ *
+ * This is the P² algorithm of Jain and Chlamtac (1985).  Five markers track
+ * the smallest value, the quantile and the points halfway to it on each side,
+ * and the largest value.  Each new value moves the markers toward their ideal
+ * positions, so the estimate needs only the markers and no stored values.
+ * Until the first five values arrive, the quantile is interpolated from the
+ * values themselves.
+ */
+class StreamingQuantile {
+ public:
+    /**
+     * @brief Construct a new streaming quantile object
+     *
+     * @param quantile The quantile to estimate, between 0 and 1
+     */
+    explicit StreamingQuantile(float quantile = 0.5);
+
+    /**
+     * @brief Change the quantile estimated and forget all values.
+     *
+     * @param quantile The quantile to estimate, between 0 and 1
+     */
+    void setQuantile(float quantile);
+    /**
+     * @brief Forget all values and start again.
+     */
+    void reset(void);
+    /**
+     * @brief Add a value.
+     *
+     * @param value The new value
+     */
+    void add(float value);
+    /**
+     * @brief Get the estimate of the quantile.
+     *
+     * @return **float** The quantile; -9999 if no values have been added
+     */
+    float get(void);
+
+ private:
+    float    _quantile;
+    uint16_t _count;
+    // The marker heights and their actual and ideal positions
+    float    _heights[5];
+    uint16_t _positions[5];
+    float    _desired[5];
+};
+
+
+/**
+ * @brief The running statistics of a burst of samples.
+ *
+ * The mean and standard deviation are kept with Welford's method, the minimum
+ * and maximum directly, and the median and one other percentile with
+ * StreamingQuantile estimators.  None of the samples are kept, so a burst can
+ * be as long as needed without using more memory.  Samples of -9999 are
+ * ignored.
+ */
+class BurstStatistics {
+ public:
+    /**
+     * @brief Construct a new burst statistics object
+     *
+     * @param percentile The percentile reported as #BURST_PERCENTILE, between
+     * 0 and 100.  Default is 90.
+     */
+    explicit BurstStatistics(float percentile = 90);
+
+    /**
+     * @brief Change the percentile reported as #BURST_PERCENTILE and forget
+     * all samples.
+     *
+     * @param percentile The percentile, between 0 and 100
+     */
+    void setPercentile(float percentile);
+    /**
+     * @brief Forget all samples and start again.
+     */
+    void reset(void);
+    /**
+     * @brief Add a sample.
+     *
+     * @param value The new sample; -9999 is ignored
+     */
+    void add(float value);
+    /**
+     * @brief Get one of the statistics of the samples so far.
+     *
+     * @param statistic The statistic to get
+     * @return **float** The statistic; -9999 if there aren't enough samples
+     * for it
+     */
+    float get(burstStatistic statistic);
+    /**
+     * @brief Get the number of good samples added.
+     *
+     * @return **uint16_t** The number of good samples
+     */
+    uint16_t getCount(void) {
+        return _count;
+    }
+
+ private:
+    uint16_t          _count;
+    float             _mean;
+    float             _m2;
+    float             _min;
+    float             _max;
+    StreamingQuantile _median;
+    StreamingQuantile _percentile;
+};
+
+#endif  // SRC_BURSTSTATISTICS_H_
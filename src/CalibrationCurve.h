@@ -0,0 +1,282 @@
+/**
+ * @file CalibrationCurve.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the LinearCalibration, PolynomialCalibration,
+ * FixedLinearCalibration and TemperatureCompensation classes, conversions
+ * whose constants are worked out once instead of for every sample.
+ */
+
+// Header Guards
+#ifndef SRC_CALIBRATIONCURVE_H_
+#define SRC_CALIBRATIONCURVE_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief A linear conversion, `y = slope * x + offset`.
+ *
+ * A chain of scalings and offsets, like counts to volts to microamps to lux,
+ * can be joined with then() into one curve, so each sample takes a single
+ * multiply and add.  Every function is `constexpr`, so a curve built from
+ * constants is worked out when the program is compiled; one built from
+ * constructor arguments is worked out once, when the sensor is constructed.
+ *
+ * @code{cpp}
+ * // 1 µmol m-2 s-1 per mV
+ * constexpr LinearCalibration parCurve(1000.0f * SQ212_CALIBRATION_FACTOR);
+ * float par = parCurve.apply(adcVoltage);
+ * @endcode
+ *
+ * @ingroup base_classes
+ */
+class LinearCalibration {
+ public:
+    /**
+     * @brief Construct a new linear calibration.
+     *
+     * @param slope The change of the output for each unit of the input.
+     * Default is 1.
+     * @param offset The output for an input of 0.  Default is 0.
+     */
+    constexpr explicit LinearCalibration(float slope = 1, float offset = 0)
+        : _slope(slope),
+          _offset(offset) {}
+    /**
+     * @brief Make the line through two calibration points.
+     *
+     * @param x0 The input at the first point, like the voltage of a blank
+     * @param y0 The output at the first point
+     * @param x1 The input at the second point, like the voltage of a standard
+     * @param y1 The output at the second point
+     * @return **LinearCalibration** The line through the points
+     */
+    static constexpr LinearCalibration fromPoints(float x0, float y0, float x1,
+                                                  float y1) {
+        return LinearCalibration((y1 - y0) / (x1 - x0),
+                                 y0 - x0 * ((y1 - y0) / (x1 - x0)));
+    }
+    /**
+     * @brief Join another conversion onto the output of this one.
+     *
+     * @param next The conversion applied to the output of this one
+     * @return **LinearCalibration** The two conversions as one
+     */
+    constexpr LinearCalibration then(const LinearCalibration& next) const {
+        return LinearCalibration(next._slope * _slope,
+                                 next._slope * _offset + next._offset);
+    }
+    /**
+     * @brief Convert a value.
+     *
+     * @param x The input
+     * @return **float** The output
+     */
+    constexpr float apply(float x) const {
+        return _slope * x + _offset;
+    }
+    /**
+     * @brief Get the slope of the conversion.
+     *
+     * @return **float** The slope
+     */
+    constexpr float getSlope(void) const {
+        return _slope;
+    }
+    /**
+     * @brief Get the offset of the conversion.
+     *
+     * @return **float** The offset
+     */
+    constexpr float getOffset(void) const {
+        return _offset;
+    }
+
+ private:
+    float _slope;
+    float _offset;
+};
+
+
+/**
+ * @brief A polynomial conversion, evaluated in Horner's form.
+ *
+ * The coefficients are given highest power first, so
+ * `PolynomialCalibration<2>(A, B, C)` is `A x^2 + B x + C`.  Each sample
+ * takes one multiply and add for each degree.
+ *
+ * @tparam degree The degree of the polynomial
+ *
+ * @ingroup base_classes
+ */
+template <uint8_t degree>
+class PolynomialCalibration {
+ public:
+    /**
+     * @brief Construct a new polynomial calibration.
+     *
+     * @param coefficients The degree + 1 coefficients, highest power first
+     */
+    template <typename... Coefficients>
+    constexpr explicit PolynomialCalibration(Coefficients... coefficients)
+        : _c{static_cast<float>(coefficients)...} {
+        static_assert(sizeof...(Coefficients) == degree + 1,
+                      "A polynomial needs one more coefficient than its "
+                      "degree");
+    }
+    /**
+     * @brief Convert a value.
+     *
+     * @param x The input
+     * @return **float** The output
+     */
+    float apply(float x) const {
+        float y = _c[0];
+        for (uint8_t i = 1; i <= degree; i++) y = y * x + _c[i];
+        return y;
+    }
+    /**
+     * @brief Get one of the coefficients.
+     *
+     * @param power The power of x the coefficient is for
+     * @return **float** The coefficient
+     */
+    constexpr float getCoefficient(uint8_t power) const {
+        return _c[degree - power];
+    }
+
+ private:
+    float _c[degree + 1];
+};
+
+
+/**
+ * @brief A linear conversion of integer readings, like ADC counts, in
+ * fixed-point arithmetic.
+ *
+ * The boards without a floating point unit, like the AVR boards, take far
+ * longer to multiply floats than integers.  This keeps the slope and offset
+ * as integers scaled by 2^fracBits, worked out when the program is compiled
+ * for constant arguments, so a conversion to an integer result never touches
+ * a float.  The reading times the scaled slope, plus the scaled offset, must
+ * fit in an int32_t; with the default of 16 fractional bits, a 12 bit
+ * reading leaves room for a slope up to about 8.
+ *
+ * @code{cpp}
+ * // Millivolts from the counts of a 10 bit ADC on a 3.3 V reference
+ * constexpr FixedLinearCalibration<16> toMillivolts(3300.0f / 1023);
+ * int32_t millivolts = toMillivolts.applyRounded(analogRead(A0));
+ * @endcode
+ *
+ * @tparam fracBits The fractional bits of the scaled slope and offset.
+ * Default is 16.
+ *
+ * @ingroup base_classes
+ */
+template <uint8_t fracBits = 16>
+class FixedLinearCalibration {
+    static_assert(fracBits > 0 && fracBits < 31,
+                  "The fractional bits must leave room in an int32_t");
+
+ public:
+    /**
+     * @brief Construct a new fixed-point linear calibration.
+     *
+     * @param slope The change of the output for each unit of the input
+     * @param offset The output for an input of 0.  Default is 0.
+     */
+    constexpr explicit FixedLinearCalibration(float slope, float offset = 0)
+        : _mul(toFixed(slope)),
+          _add(toFixed(offset)) {}
+    /**
+     * @brief Convert a reading, keeping the fractional bits of the output.
+     *
+     * @param raw The reading
+     * @return **int32_t** The output times 2^fracBits
+     */
+    int32_t applyFixed(int32_t raw) const {
+        return raw * _mul + _add;
+    }
+    /**
+     * @brief Convert a reading to the nearest integer output.
+     *
+     * @param raw The reading
+     * @return **int32_t** The output, rounded
+     */
+    int32_t applyRounded(int32_t raw) const {
+        return (applyFixed(raw) + (1L << (fracBits - 1))) >> fracBits;
+    }
+    /**
+     * @brief Convert a reading to a float output, with one conversion to
+     * float and one multiply.
+     *
+     * @param raw The reading
+     * @return **float** The output
+     */
+    float apply(int32_t raw) const {
+        return applyFixed(raw) * (1.0f / (1L << fracBits));
+    }
+
+ private:
+    /**
+     * @brief Scale and round a constant to the fixed-point form.
+     *
+     * @param value The constant
+     * @return **int32_t** The constant times 2^fracBits, rounded
+     */
+    static constexpr int32_t toFixed(float value) {
+        return static_cast<int32_t>(value * (1L << fracBits) +
+                                    (value < 0 ? -0.5f : 0.5f));
+    }
+
+    int32_t _mul;
+    int32_t _add;
+};
+
+
+/**
+ * @brief A linear temperature compensation, referring a value measured at
+ * one temperature to a reference temperature.
+ *
+ * The compensated value is `value / (1 + coefficient * (T - reference))`,
+ * as for the specific conductance of water, with a coefficient of about
+ * 0.019 per °C, referred to 25°C.  A missing (-9999) value or temperature
+ * gives a missing result, so this can be used straight away in the function
+ * of a calculated variable.
+ *
+ * @ingroup base_classes
+ */
+class TemperatureCompensation {
+ public:
+    /**
+     * @brief Construct a new temperature compensation.
+     *
+     * @param coefficient The fractional change of the value for each degree
+     * @param referenceTemp The temperature to refer the value to.  Default is
+     * 25.
+     */
+    constexpr explicit TemperatureCompensation(float coefficient,
+                                               float referenceTemp = 25)
+        : _coefficient(coefficient),
+          _reference(referenceTemp) {}
+    /**
+     * @brief Compensate a value.
+     *
+     * @param value The value measured
+     * @param temperature The temperature it was measured at
+     * @return **float** The value at the reference temperature
+     */
+    constexpr float apply(float value, float temperature) const {
+        return value == -9999 || temperature == -9999
+            ? -9999
+            : value / (1 + _coefficient * (temperature - _reference));
+    }
+
+ private:
+    float _coefficient;
+    float _reference;
+};
+
+#endif  // SRC_CALIBRATIONCURVE_H_
@@ -0,0 +1,116 @@
+/**
+ * @file ConsoleSink.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the ConsoleSink class.
+ */
+
+#include "ModSensorDebugger.h"
+
+#if defined(MS_CONSOLE_BUFFER_SIZE) && defined(STANDARD_SERIAL_OUTPUT)
+
+ConsoleSink msConsole(STANDARD_SERIAL_OUTPUT);
+
+
+// The constructor
+ConsoleSink::ConsoleSink(Stream& out) : _out(out) {}
+
+
+size_t ConsoleSink::write(uint8_t b) {
+    return write(&b, 1);
+}
+// Text goes straight to the port when nothing is waiting ahead of it
+size_t ConsoleSink::write(const uint8_t* buf, size_t size) {
+    if (!isListening()) {
+        _dropped += _len + size;
+        _len = 0;
+        return size;
+    }
+    drain();
+    size_t sent = 0;
+    if (_len == 0) {
+        size_t space = portSpace();
+        sent         = _out.write(buf, size < space ? size : space);
+    }
+    for (; sent < size; sent++) {
+        if (_len == MS_CONSOLE_BUFFER_SIZE) {
+            _dropped += size - sent;
+            break;
+        }
+        _buffer[(_head + _len) % MS_CONSOLE_BUFFER_SIZE] = buf[sent];
+        _len++;
+    }
+    // Report everything as written, so a print isn't cut short
+    return size;
+}
+
+
+int ConsoleSink::available() {
+    return _out.available();
+}
+int ConsoleSink::read() {
+    return _out.read();
+}
+int ConsoleSink::peek() {
+    return _out.peek();
+}
+void ConsoleSink::flush() {}
+
+
+void ConsoleSink::drain(void) {
+    if (!isListening()) {
+        _dropped += _len;
+        _len = 0;
+        return;
+    }
+    while (_len > 0) {
+        size_t space = portSpace();
+        if (space == 0) return;
+        // Only write up to the end of the ring at once
+        size_t chunk = MS_CONSOLE_BUFFER_SIZE - _head;
+        if (chunk > _len) chunk = _len;
+        if (chunk > space) chunk = space;
+        _out.write(_buffer + _head, chunk);
+        _head = (_head + chunk) % MS_CONSOLE_BUFFER_SIZE;
+        _len -= chunk;
+    }
+}
+
+
+void ConsoleSink::finish(void) {
+    if (!isListening()) {
+        _dropped += _len;
+        _len = 0;
+        return;
+    }
+    while (_len > 0) {
+        size_t chunk = MS_CONSOLE_BUFFER_SIZE - _head;
+        if (chunk > _len) chunk = _len;
+        _out.write(_buffer + _head, chunk);
+        _head = (_head + chunk) % MS_CONSOLE_BUFFER_SIZE;
+        _len -= chunk;
+    }
+    _out.flush();
+}
+
+
+// Reading the USB line state directly avoids the delay in the port's bool
+// operator
+bool ConsoleSink::isListening(void) {
+#if defined(SERIAL_PORT_USBVIRTUAL)
+    if (&_out == &SERIAL_PORT_USBVIRTUAL) {
+        return SERIAL_PORT_USBVIRTUAL.dtr();
+    }
+#endif
+    return true;
+}
+
+
+size_t ConsoleSink::portSpace(void) {
+    int space = _out.availableForWrite();
+    return space > 0 ? static_cast<size_t>(space) : 0;
+}
+
+#endif
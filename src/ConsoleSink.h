@@ -0,0 +1,107 @@
+/**
+ * @file ConsoleSink.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the ConsoleSink class, which buffers the text printed to the
+ * serial port so printing never waits for the port.
+ */
+
+// Header Guards
+#ifndef SRC_CONSOLESINK_H_
+#define SRC_CONSOLESINK_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief A stream in front of a serial port that gives the port only as much
+ * as it can take without waiting, and keeps the rest in RAM.
+ *
+ * Writing to a serial port waits whenever its transmit buffer is full, so a
+ * long printout at 115200 baud holds up the logger for tens of milliseconds.
+ * The sink instead writes only what fits in the port's transmit buffer, which
+ * the port's interrupt sends on its own, and keeps the rest in a ring buffer
+ * of #MS_CONSOLE_BUFFER_SIZE bytes.  The ring buffer is moved into the port
+ * while the processor idles in Sensor::idleProcessor() and before it sleeps.
+ * Text that doesn't fit in the ring buffer either is dropped.
+ *
+ * On a native USB port, nothing is sent while no terminal has the port open
+ * (DTR is low); everything written is dropped.
+ *
+ * This is only used when `MS_CONSOLE_BUFFER_SIZE` is defined, as a single
+ * object, `msConsole`, in front of `STANDARD_SERIAL_OUTPUT`.  PRINTOUT(),
+ * MS_DBG() and the logger's echoes then all write to it.  The port must report
+ * the space left in its transmit buffer with `availableForWrite()`, as the
+ * hardware serial and native USB ports of the AVR and SAMD cores do.
+ */
+class ConsoleSink : public Stream {
+ public:
+    /**
+     * @brief Construct a new console sink object
+     *
+     * @param out The serial port to send the text to
+     */
+    explicit ConsoleSink(Stream& out);
+
+    using Print::write;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int    available() override;
+    int    read() override;
+    int    peek() override;
+    /**
+     * @brief Does nothing; the sink never waits for the port.  Use finish()
+     * to send everything.
+     */
+    void flush() override;
+
+    /**
+     * @brief Move as much of the buffered text into the port as it can take
+     * without waiting.
+     */
+    void drain(void);
+    /**
+     * @brief Send all of the buffered text, waiting for the port, and wait
+     * for the port to finish sending it.
+     *
+     * The text is dropped instead if no one is listening.
+     */
+    void finish(void);
+    /**
+     * @brief Check if anything sent to the port can be received.
+     *
+     * @return **bool** False for a native USB port with no terminal attached,
+     * otherwise true
+     */
+    bool isListening(void);
+    /**
+     * @brief Get the number of bytes dropped since the start.
+     *
+     * @return **uint32_t** The bytes dropped
+     */
+    uint32_t getDroppedBytes(void) {
+        return _dropped;
+    }
+
+ private:
+    /**
+     * @brief Get the space left in the port's transmit buffer.
+     *
+     * @return **size_t** The bytes that can be written without waiting
+     */
+    size_t portSpace(void);
+
+    Stream&  _out;
+    uint8_t  _buffer[MS_CONSOLE_BUFFER_SIZE];
+    uint16_t _head    = 0;
+    uint16_t _len     = 0;
+    uint32_t _dropped = 0;
+};
+
+/**
+ * @brief The sink in front of `STANDARD_SERIAL_OUTPUT`.
+ */
+extern ConsoleSink msConsole;
+
+#endif  // SRC_CONSOLESINK_H_
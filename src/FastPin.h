@@ -0,0 +1,140 @@
+/**
+ * @file FastPin.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the FastPin class, a digital pin whose port register and
+ * bit mask are looked up once.
+ */
+
+// Header Guards
+#ifndef SRC_FASTPIN_H_
+#define SRC_FASTPIN_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief A digital pin read and written directly through its port registers.
+ *
+ * digitalRead() and digitalWrite() look up the port and bit of the pin in the
+ * core's pin tables on every call, and the AVR core also checks for a PWM
+ * timer on the pin.  A FastPin looks them up once, in attach(), and then reads
+ * and writes the port registers directly.  This is used for the power and
+ * control pins switched on every logging cycle: the sensor power pins, the
+ * modem pins, and the SD card power pin.
+ *
+ * It only reads and writes; the pin mode must still be set with pinMode().
+ * Unlike digitalWrite(), writing doesn't turn off PWM on the pin.
+ *
+ * On processors other than the AVR and SAMD, it falls back to digitalRead()
+ * and digitalWrite().
+ *
+ * @ingroup base_classes
+ */
+class FastPin {
+ public:
+    /**
+     * @brief Look up the port register and bit mask of a pin.
+     *
+     * @param pin The pin on the mcu; a negative number for no pin, which is
+     * then never read or written
+     */
+    void attach(int8_t pin) {
+        _pin = pin;
+#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+        _mask = 0;
+        if (pin < 0) return;
+        uint8_t port = digitalPinToPort(pin);
+        if (port == NOT_A_PIN) return;
+        _mask = digitalPinToBitMask(pin);
+        _out  = portOutputRegister(port);
+        _in   = portInputRegister(port);
+#elif defined(ARDUINO_ARCH_SAMD)
+        _mask = 0;
+        if (pin < 0) return;
+        _port = &(PORT->Group[g_APinDescription[pin].ulPort]);
+        _mask = 1ul << g_APinDescription[pin].ulPin;
+#endif
+    }
+    /**
+     * @brief Get the pin attached.
+     *
+     * @return **int8_t** The pin on the mcu; negative if there is none
+     */
+    int8_t getPin(void) const {
+        return _pin;
+    }
+
+    /**
+     * @brief Set the output of the pin high.
+     */
+    void high(void) {
+        write(true);
+    }
+    /**
+     * @brief Set the output of the pin low.
+     */
+    void low(void) {
+        write(false);
+    }
+    /**
+     * @brief Set the output of the pin.
+     *
+     * @param level True for high, false for low
+     */
+    void write(bool level) {
+#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+        if (_mask == 0) return;
+        // The read-modify-write of the port must not be interrupted
+        uint8_t oldSREG = SREG;
+        cli();
+        if (level) {
+            *_out |= _mask;
+        } else {
+            *_out &= ~_mask;
+        }
+        SREG = oldSREG;
+#elif defined(ARDUINO_ARCH_SAMD)
+        if (_mask == 0) return;
+        // The set and clear registers change only the bits written
+        if (level) {
+            _port->OUTSET.reg = _mask;
+        } else {
+            _port->OUTCLR.reg = _mask;
+        }
+#else
+        if (_pin >= 0) digitalWrite(_pin, level ? HIGH : LOW);
+#endif
+    }
+    /**
+     * @brief Read the level of the pin.
+     *
+     * For an output, this is the level it is driven to.
+     *
+     * @return **bool** True if the pin is high; false if it is low or there is
+     * no pin
+     */
+    bool read(void) const {
+#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+        return _mask != 0 && (*_in & _mask) != 0;
+#elif defined(ARDUINO_ARCH_SAMD)
+        return _mask != 0 && (_port->IN.reg & _mask) != 0;
+#else
+        return _pin >= 0 && digitalRead(_pin) == HIGH;
+#endif
+    }
+
+ private:
+    int8_t _pin = -1;
+#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+    volatile uint8_t* _out  = nullptr;
+    volatile uint8_t* _in   = nullptr;
+    uint8_t           _mask = 0;
+#elif defined(ARDUINO_ARCH_SAMD)
+    PortGroup* _port = nullptr;
+    uint32_t   _mask = 0;
+#endif
+};
+
+#endif  // SRC_FASTPIN_H_
@@ -0,0 +1,193 @@
+/**
+ * @file GzipWriter.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the GzipWriter class.
+ */
+
+#include "GzipWriter.h"
+
+#if defined(MS_GZIP_WINDOW_SIZE)
+
+// The CRC-32 of gzip, a nibble at a time
+static const uint32_t gzipCrcTable[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+    0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+// The shortest length of each deflate length code, less 3
+static const uint8_t gzipLengthBase[29] = {
+    0,  1,  2,  3,  4,  5,  6,   7,   8,   10,  12,  14,  16,  20, 24,
+    28, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 255};
+
+// The shortest distance of each deflate distance code
+static const uint16_t gzipDistanceBase[30] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+
+void GzipWriter::begin(outputFxn output) {
+    _output   = output;
+    _in       = 0;
+    _pos      = 0;
+    _crc      = 0xFFFFFFFF;
+    _outLen   = 0;
+    _bitBuf   = 0;
+    _bitCount = 0;
+    _outFill  = 0;
+    memset(_hashHead, 0, sizeof(_hashHead));
+    // The gzip header: deflate, no name or time, unknown system
+    static const uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+    for (uint8_t i = 0; i < sizeof(header); i++) putByte(header[i]);
+    // One final block with the fixed Huffman codes
+    putBits(0b011, 3);
+}
+
+
+void GzipWriter::write(const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = data[i];
+        _crc ^= c;
+        _crc = (_crc >> 4) ^ gzipCrcTable[_crc & 0x0F];
+        _crc = (_crc >> 4) ^ gzipCrcTable[_crc & 0x0F];
+        // Code what's held back once there is enough to look for a repeat in
+        if (_in - _pos >= MS_GZIP_MAX_MATCH) encodeNext();
+        _window[_in & (MS_GZIP_WINDOW_SIZE - 1)] = c;
+        _in++;
+    }
+}
+
+
+uint32_t GzipWriter::finish(void) {
+    while (_pos < _in) encodeNext();
+    // The end of the block, padded out to a whole byte
+    putSymbol(256);
+    if (_bitCount > 0) putBits(0, 8 - _bitCount);
+    // The trailer: the CRC and the length of the input
+    uint32_t crc = ~_crc;
+    for (uint8_t i = 0; i < 4; i++) putByte(crc >> (8 * i));
+    for (uint8_t i = 0; i < 4; i++) putByte(_in >> (8 * i));
+    flushOutput();
+    return _outLen;
+}
+
+
+// The bytes at the current position are matched against the last position
+// with the same hash
+void GzipWriter::encodeNext(void) {
+    uint32_t avail = _in - _pos;
+    uint16_t best  = 0;
+    uint32_t cand  = 0;
+    if (avail >= 3) {
+        uint8_t h = ((_window[_pos & (MS_GZIP_WINDOW_SIZE - 1)] << 4) ^
+                     (_window[(_pos + 1) & (MS_GZIP_WINDOW_SIZE - 1)] << 2) ^
+                     _window[(_pos + 2) & (MS_GZIP_WINDOW_SIZE - 1)]) &
+            ((1 << MS_GZIP_HASH_BITS) - 1);
+        // Only the low half of the position is kept in the table
+        cand = (_pos & 0xFFFF0000UL) | _hashHead[h];
+        if (cand >= _pos) cand -= 0x10000UL;
+        // The candidate must still be in the window
+        if (cand < _pos && _in - cand <= MS_GZIP_WINDOW_SIZE) {
+            uint16_t maxLen = avail < MS_GZIP_MAX_MATCH ? avail
+                                                        : MS_GZIP_MAX_MATCH;
+            while (best < maxLen &&
+                   _window[(cand + best) & (MS_GZIP_WINDOW_SIZE - 1)] ==
+                       _window[(_pos + best) & (MS_GZIP_WINDOW_SIZE - 1)]) {
+                best++;
+            }
+        }
+    }
+    if (best >= 3) {
+        putMatch(best, _pos - cand);
+    } else {
+        best = 1;
+        putSymbol(_window[_pos & (MS_GZIP_WINDOW_SIZE - 1)]);
+    }
+    for (uint16_t i = 0; i < best; i++, _pos++) {
+        if (_pos + 2 < _in) insertHash(_pos);
+    }
+}
+
+
+void GzipWriter::insertHash(uint32_t pos) {
+    uint8_t h = ((_window[pos & (MS_GZIP_WINDOW_SIZE - 1)] << 4) ^
+                 (_window[(pos + 1) & (MS_GZIP_WINDOW_SIZE - 1)] << 2) ^
+                 _window[(pos + 2) & (MS_GZIP_WINDOW_SIZE - 1)]) &
+        ((1 << MS_GZIP_HASH_BITS) - 1);
+    _hashHead[h] = pos & 0xFFFF;
+}
+
+
+void GzipWriter::putBits(uint16_t bits, uint8_t count) {
+    _bitBuf |= static_cast<uint32_t>(bits) << _bitCount;
+    _bitCount += count;
+    while (_bitCount >= 8) {
+        putByte(_bitBuf & 0xFF);
+        _bitBuf >>= 8;
+        _bitCount -= 8;
+    }
+}
+
+
+// Huffman codes go out most significant bit first, so they are reversed
+void GzipWriter::putSymbol(uint16_t symbol) {
+    uint16_t code;
+    uint8_t  length;
+    if (symbol < 144) {
+        code   = 0x30 + symbol;
+        length = 8;
+    } else if (symbol < 256) {
+        code   = 0x190 + symbol - 144;
+        length = 9;
+    } else if (symbol < 280) {
+        code   = symbol - 256;
+        length = 7;
+    } else {
+        code   = 0xC0 + symbol - 280;
+        length = 8;
+    }
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    putBits(reversed, length);
+}
+
+
+void GzipWriter::putMatch(uint16_t length, uint16_t distance) {
+    uint8_t lc = 28;
+    while (gzipLengthBase[lc] > length - 3) lc--;
+    putSymbol(257 + lc);
+    uint8_t lengthExtra = (lc < 8 || lc == 28) ? 0 : (lc - 4) / 4;
+    putBits(length - 3 - gzipLengthBase[lc], lengthExtra);
+
+    uint8_t dc = 29;
+    while (gzipDistanceBase[dc] > distance) dc--;
+    // The five bit distance codes are reversed too
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        reversed = (reversed << 1) | ((dc >> i) & 1);
+    }
+    putBits(reversed, 5);
+    uint8_t distanceExtra = dc < 4 ? 0 : (dc - 2) / 2;
+    putBits(distance - gzipDistanceBase[dc], distanceExtra);
+}
+
+
+void GzipWriter::putByte(uint8_t b) {
+    _outLen++;
+    if (_output == nullptr) return;
+    _outBuf[_outFill++] = b;
+    if (_outFill == sizeof(_outBuf)) flushOutput();
+}
+
+
+void GzipWriter::flushOutput(void) {
+    if (_output != nullptr && _outFill > 0) _output(_outBuf, _outFill);
+    _outFill = 0;
+}
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file GzipWriter.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the GzipWriter class, a gzip compressor with a fixed
+ * window, for compressing request bodies as they are written.
+ */
+
+// Header Guards
+#ifndef SRC_GZIPWRITER_H_
+#define SRC_GZIPWRITER_H_
+
+#include <Arduino.h>
+
+#if defined(MS_GZIP_WINDOW_SIZE)
+
+#ifndef MS_GZIP_MAX_MATCH
+/**
+ * @brief The longest repeat the GzipWriter encodes as one match.
+ *
+ * This much of the input is held back to look for repeats in, so it must be
+ * well under `MS_GZIP_WINDOW_SIZE`.  Longer repeats are encoded as several
+ * matches.  The most deflate allows is 258.
+ */
+#define MS_GZIP_MAX_MATCH 64
+#endif
+
+/**
+ * @brief The number of bits in the hash of the next three characters that
+ * GzipWriter looks up repeats by; the table takes two bytes per entry.
+ */
+#define MS_GZIP_HASH_BITS 8
+
+/**
+ * @brief A gzip compressor with a fixed window of RAM, for data written a
+ * piece at a time.
+ *
+ * Each repeat of at least three characters within the last
+ * `MS_GZIP_WINDOW_SIZE` characters is replaced by its distance and length,
+ * found from a table of the last position of each hash of three characters.
+ * Everything is coded in one deflate block with the fixed Huffman codes, so
+ * nothing has to be held back to build a code table: the output is given to
+ * the output function as it is made.  This gives up some of the compression
+ * of zlib for a few kB less RAM.
+ *
+ * The output is the same each time for the same input, so a body can be
+ * compressed once without an output function to find its length for the
+ * headers, and then again to send it.
+ *
+ * This is only used when `MS_GZIP_WINDOW_SIZE` is defined, as a power of two
+ * up to 32768.  The window and the hash table are
+ * `MS_GZIP_WINDOW_SIZE + 2^(MS_GZIP_HASH_BITS + 1)` bytes of RAM.
+ */
+class GzipWriter {
+ public:
+    /**
+     * @brief The function given the compressed output.
+     *
+     * @param data The compressed bytes
+     * @param length The number of bytes
+     */
+    typedef void (*outputFxn)(const char* data, size_t length);
+
+    /**
+     * @brief Start a new gzip stream.
+     *
+     * @param output The function to give the compressed output to, or a
+     * nullptr to only count it
+     */
+    void begin(outputFxn output);
+    /**
+     * @brief Add characters to the stream.
+     *
+     * @param data The characters to compress
+     * @param length The number of characters
+     */
+    void write(const char* data, size_t length);
+    /**
+     * @brief Compress whatever is held back and end the stream.
+     *
+     * @return **uint32_t** The total length of the compressed stream,
+     * including the gzip header and trailer
+     */
+    uint32_t finish(void);
+
+ private:
+    /**
+     * @brief Code the character at the current position, or the repeat
+     * starting there.
+     */
+    void encodeNext(void);
+    /**
+     * @brief Note the current position in the hash table.
+     *
+     * @param pos The position of the first of the three characters
+     */
+    void insertHash(uint32_t pos);
+    /**
+     * @brief Add bits to the output, least significant first.
+     *
+     * @param bits The bits
+     * @param count The number of bits, up to 16
+     */
+    void putBits(uint16_t bits, uint8_t count);
+    /**
+     * @brief Add a literal/length symbol with its fixed Huffman code.
+     *
+     * @param symbol The symbol, 0-287
+     */
+    void putSymbol(uint16_t symbol);
+    /**
+     * @brief Add the codes for a repeat.
+     *
+     * @param length The length of the repeat, 3 to #MS_GZIP_MAX_MATCH
+     * @param distance How far back the repeat starts
+     */
+    void putMatch(uint16_t length, uint16_t distance);
+    /**
+     * @brief Add a whole byte to the output.
+     *
+     * @param b The byte
+     */
+    void putByte(uint8_t b);
+    /**
+     * @brief Give the output waiting in the small output buffer to the
+     * output function.
+     */
+    void flushOutput(void);
+
+    outputFxn _output = nullptr;
+    uint8_t   _window[MS_GZIP_WINDOW_SIZE];
+    uint16_t  _hashHead[1 << MS_GZIP_HASH_BITS];
+    uint32_t  _in       = 0;
+    uint32_t  _pos      = 0;
+    uint32_t  _crc      = 0;
+    uint32_t  _outLen   = 0;
+    uint32_t  _bitBuf   = 0;
+    uint8_t   _bitCount = 0;
+    char      _outBuf[16];
+    uint8_t   _outFill = 0;
+};
+
+#endif  // MS_GZIP_WINDOW_SIZE
+
+#endif  // SRC_GZIPWRITER_H_
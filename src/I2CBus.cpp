@@ -0,0 +1,248 @@
+/**
+ * @file I2CBus.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the I2CBus class.
+ */
+
+#include "I2CBus.h"
+
+// The registered buses
+I2CBus* I2CBus::_buses[MS_MAX_I2C_BUSES] = {nullptr};
+
+
+// The constructor registers the bus in the first free slot
+I2CBus::I2CBus(TwoWire* wire, uint32_t clock_hz) : _wire(wire) {
+    setClock(clock_hz);
+    for (uint8_t i = 0; i < MS_MAX_I2C_BUSES; i++) {
+        if (_buses[i] == nullptr) {
+            _buses[i] = this;
+            return;
+        }
+    }
+}
+// Destructor
+I2CBus::~I2CBus() {
+    for (uint8_t i = 0; i < MS_MAX_I2C_BUSES; i++) {
+        if (_buses[i] == this) _buses[i] = nullptr;
+    }
+}
+
+
+void I2CBus::begin(void) {
+    _wire->begin();
+    applyClock();
+}
+
+
+void I2CBus::setClock(uint32_t clock_hz) {
+#if defined(__AVR__)
+    // The TWI of an AVR can't go past fast mode
+    if (clock_hz > 400000) {
+        MS_DBG(F("Lowering an I2C clock of"), clock_hz, F("Hz to 400000Hz"));
+        clock_hz = 400000;
+    }
+#endif
+    _clock_hz = clock_hz;
+}
+
+
+// Setting the clock restarts the SERCOM of a SAMD board, so nothing can be
+// running on it then
+void I2CBus::applyClock(void) {
+    finishAll();
+    _wire->setClock(_clock_hz);
+}
+
+
+bool I2CBus::queue(I2CTransaction* transaction) {
+    if (!transaction->isFinished()) return false;
+    transaction->status  = I2CTransaction::queued;
+    transaction->txCount = 0;
+    transaction->rxCount = 0;
+    transaction->next    = nullptr;
+    if (_queueHead == nullptr) {
+        _queueHead = transaction;
+    } else {
+        _queueTail->next = transaction;
+    }
+    _queueTail = transaction;
+    return true;
+}
+
+
+// Only the transaction at the front is ever on the bus; the next one starts
+// once its callback has been called
+void I2CBus::service(void) {
+    while (_queueHead != nullptr) {
+        I2CTransaction* transaction = _queueHead;
+#if defined(ARDUINO_ARCH_SAMD)
+        if (_sercom != nullptr) {
+            if (transaction->status == I2CTransaction::queued) {
+                startSercom(transaction);
+            }
+            if (!_useInterrupt) onService();
+            if (!transaction->isFinished()) return;
+        } else {
+            runBlocking(transaction);
+        }
+#else
+        runBlocking(transaction);
+#endif
+        _queueHead = transaction->next;
+        if (_queueHead == nullptr) _queueTail = nullptr;
+        transaction->next = nullptr;
+        if (transaction->callback != nullptr) {
+            transaction->callback(transaction);
+        }
+    }
+}
+
+
+void I2CBus::finishAll(void) {
+    while (_queueHead != nullptr) service();
+}
+
+
+// A write with nothing to read ends with a stop; one followed by a read ends
+// with a repeated start
+void I2CBus::runBlocking(I2CTransaction* transaction) {
+    transaction->status = I2CTransaction::running;
+    bool success        = true;
+    if (transaction->txLen > 0 || transaction->rxLen == 0) {
+        _wire->beginTransmission(transaction->address);
+        if (transaction->txLen > 0) {
+            _wire->write(transaction->txData, transaction->txLen);
+        }
+        success = _wire->endTransmission(
+                      static_cast<uint8_t>(transaction->rxLen == 0)) == 0;
+        if (success) transaction->txCount = transaction->txLen;
+    }
+    if (success && transaction->rxLen > 0) {
+        uint8_t received = _wire->requestFrom(
+            static_cast<uint8_t>(transaction->address),
+            static_cast<uint8_t>(transaction->rxLen));
+        while (transaction->rxCount < received && _wire->available()) {
+            transaction->rxData[transaction->rxCount++] = _wire->read();
+        }
+        success = transaction->rxCount > 0;
+    }
+    transaction->status = success ? I2CTransaction::done
+                                  : I2CTransaction::failed;
+}
+
+
+#if defined(ARDUINO_ARCH_SAMD)
+void I2CBus::setSercom(Sercom* sercom, bool useInterrupt) {
+    finishAll();
+    _sercom       = sercom;
+    _useInterrupt = useInterrupt;
+}
+
+
+// Wait out the synchronization of a command to the SERCOM
+static inline void syncSercom(Sercom* sercom) {
+    while (sercom->I2CM.SYNCBUSY.bit.SYSOP) {}
+}
+
+
+void I2CBus::startSercom(I2CTransaction* transaction) {
+    transaction->status = I2CTransaction::running;
+    _reading            = transaction->txLen == 0 && transaction->rxLen > 0;
+    _sercom->I2CM.ADDR.reg = SERCOM_I2CM_ADDR_ADDR(
+        (transaction->address << 1) | (_reading ? 1 : 0));
+    syncSercom(_sercom);
+    if (_useInterrupt) {
+        _sercom->I2CM.INTENSET.reg = SERCOM_I2CM_INTENSET_MB |
+            SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR;
+    }
+}
+
+
+void I2CBus::stopSercom(bool success) {
+    _sercom->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB |
+        SERCOM_I2CM_INTENCLR_SB | SERCOM_I2CM_INTENCLR_ERROR;
+    // Not acknowledging the last byte read tells the device to let go
+    _sercom->I2CM.CTRLB.bit.ACKACT = 1;
+    syncSercom(_sercom);
+    _sercom->I2CM.CTRLB.bit.CMD = 3;
+    syncSercom(_sercom);
+    _queueHead->status = success ? I2CTransaction::done
+                                 : I2CTransaction::failed;
+}
+
+
+// The master-on-bus flag follows each address or byte written, and the
+// slave-on-bus flag each byte read; smart mode is off, as the core leaves it
+void I2CBus::onService(void) {
+    I2CTransaction* transaction = _queueHead;
+    if (_sercom == nullptr) return;
+    if (transaction == nullptr ||
+        transaction->status != I2CTransaction::running) {
+        _sercom->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB |
+            SERCOM_I2CM_INTENCLR_SB | SERCOM_I2CM_INTENCLR_ERROR;
+        return;
+    }
+    uint8_t flags = _sercom->I2CM.INTFLAG.reg;
+    if (flags & SERCOM_I2CM_INTFLAG_ERROR) {
+        _sercom->I2CM.INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+        stopSercom(false);
+    } else if (flags & SERCOM_I2CM_INTFLAG_MB) {
+        // In a read, the master-on-bus flag means the address wasn't
+        // acknowledged
+        if (_reading || _sercom->I2CM.STATUS.bit.RXNACK ||
+            _sercom->I2CM.STATUS.bit.ARBLOST) {
+            stopSercom(false);
+        } else if (transaction->txCount < transaction->txLen) {
+            _sercom->I2CM.DATA.reg =
+                transaction->txData[transaction->txCount++];
+            syncSercom(_sercom);
+        } else if (transaction->rxLen > 0) {
+            _reading               = true;
+            _sercom->I2CM.ADDR.reg = SERCOM_I2CM_ADDR_ADDR(
+                (transaction->address << 1) | 1);
+            syncSercom(_sercom);
+        } else {
+            stopSercom(true);
+        }
+    } else if (flags & SERCOM_I2CM_INTFLAG_SB) {
+        transaction->rxData[transaction->rxCount++] = _sercom->I2CM.DATA.reg;
+        syncSercom(_sercom);
+        if (transaction->rxCount < transaction->rxLen) {
+            _sercom->I2CM.CTRLB.bit.ACKACT = 0;
+            syncSercom(_sercom);
+            _sercom->I2CM.CTRLB.bit.CMD = 2;
+            syncSercom(_sercom);
+        } else {
+            stopSercom(true);
+        }
+    }
+}
+#endif
+
+
+I2CBus* I2CBus::getBus(TwoWire* wire) {
+    for (uint8_t i = 0; i < MS_MAX_I2C_BUSES; i++) {
+        if (_buses[i] != nullptr && _buses[i]->_wire == wire) return _buses[i];
+    }
+    return nullptr;
+}
+
+
+void I2CBus::beginAll(void) {
+    for (uint8_t i = 0; i < MS_MAX_I2C_BUSES; i++) {
+        if (_buses[i] != nullptr) {
+            MS_DBG(F("Starting an I2C bus at"), _buses[i]->_clock_hz, F("Hz"));
+            _buses[i]->begin();
+        }
+    }
+}
+
+
+void I2CBus::serviceAll(void) {
+    for (uint8_t i = 0; i < MS_MAX_I2C_BUSES; i++) {
+        if (_buses[i] != nullptr) _buses[i]->service();
+    }
+}
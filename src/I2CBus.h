@@ -0,0 +1,359 @@
+/**
+ * @file I2CBus.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the I2CBus class, a hardware I2C bus with its own clock
+ * speed shared by several sensors.
+ */
+
+// Header Guards
+#ifndef SRC_I2CBUS_H_
+#define SRC_I2CBUS_H_
+
+// Debugging Statement
+// #define MS_I2CBUS_DEBUG
+
+#ifdef MS_I2CBUS_DEBUG
+#define MS_DEBUGGING_STD "I2CBus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Wire.h>
+
+#ifndef MS_MAX_I2C_BUSES
+/**
+ * @brief The most I2C buses that can be registered.
+ */
+#define MS_MAX_I2C_BUSES 4
+#endif
+
+/**
+ * @brief A write, a read, or a write followed by a repeated start and a read,
+ * queued on an I2CBus.
+ *
+ * The transaction must stay in place until it has finished.  Its callback is
+ * called from I2CBus::service(), never from an interrupt, so it can queue
+ * another transaction; it must not use the bus through the TwoWire.
+ *
+ * @ingroup base_classes
+ */
+struct I2CTransaction {
+    /**
+     * @brief The states of a transaction
+     */
+    typedef enum : uint8_t {
+        idle = 0,  ///< Not queued
+        queued,    ///< Waiting for the transactions ahead of it
+        running,   ///< On the bus
+        done,      ///< Finished with every byte acknowledged
+        failed     ///< Not acknowledged, or lost the bus
+    } status_t;
+
+    /**
+     * @brief Set what the transaction writes and reads.
+     *
+     * @param i2cAddress The 7-bit address of the device
+     * @param tx The bytes to write, which must stay valid; nullptr for none
+     * @param txBytes The number of bytes to write
+     * @param rx The buffer for the bytes read; nullptr for none
+     * @param rxBytes The number of bytes to read
+     */
+    void set(uint8_t i2cAddress, const uint8_t* tx, uint8_t txBytes,
+             uint8_t* rx, uint8_t rxBytes) {
+        address = i2cAddress;
+        txData  = tx;
+        txLen   = txBytes;
+        rxData  = rx;
+        rxLen   = rxBytes;
+    }
+    /**
+     * @brief Check whether the transaction has finished, or was never
+     * queued.
+     *
+     * @return **bool** True if the transaction isn't queued or running
+     */
+    bool isFinished(void) {
+        return status != queued && status != running;
+    }
+
+    /**
+     * @brief The 7-bit address of the device
+     */
+    uint8_t address = 0;
+    /**
+     * @brief The bytes to write
+     */
+    const uint8_t* txData = nullptr;
+    /**
+     * @brief The number of bytes to write
+     */
+    uint8_t txLen = 0;
+    /**
+     * @brief The buffer for the bytes read
+     */
+    uint8_t* rxData = nullptr;
+    /**
+     * @brief The number of bytes to read
+     */
+    uint8_t rxLen = 0;
+    /**
+     * @brief A function to call when the transaction has finished; nullptr
+     * for none
+     */
+    void (*callback)(I2CTransaction* transaction) = nullptr;
+    /**
+     * @brief Anything the callback needs, like the sensor that queued the
+     * transaction
+     */
+    void* context = nullptr;
+    /**
+     * @brief The state of the transaction
+     */
+    volatile status_t status = idle;
+    /**
+     * @brief The number of bytes written so far
+     */
+    volatile uint8_t txCount = 0;
+    /**
+     * @brief The number of bytes read so far; a device that sends fewer than
+     * asked on a blocking bus leaves this short
+     */
+    volatile uint8_t rxCount = 0;
+    /**
+     * @brief The transaction queued after this one
+     */
+    I2CTransaction* next = nullptr;
+};
+
+/**
+ * @brief A hardware I2C bus, like `Wire` or a second SERCOM on a SAMD board,
+ * run at its own clock speed for the sensors attached to it.
+ *
+ * With every sensor on `Wire` at the default 100 kHz, a slow or
+ * clock-stretching device like an Atlas EZO circuit or AM2315 sets the pace for
+ * fast ones like the SHT4x or BMP3xx.  Put the slow devices on one bus and the
+ * fast ones on another, give each bus its clock, and attach each sensor to the
+ * bus it was constructed with using Sensor::setI2CBus().
+ *
+ * Most sensor libraries call `begin()` on their TwoWire, which puts a SAMD or
+ * AVR bus back to 100 kHz.  So the VariableArray sets each bus's clock again
+ * before every step of a sensor attached to it.  Every sensor on a bus with a
+ * faster clock should be attached, or one that isn't can leave the bus at
+ * 100 kHz for the others.
+ *
+ * Every bus that is constructed is registered, up to #MS_MAX_I2C_BUSES, and
+ * can be found again from its TwoWire with getBus().
+ *
+ * On a SAMD board, a second bus is a TwoWire on a free SERCOM, set up in the
+ * sketch:
+ * @code{.cpp}
+ * #include <wiring_private.h>
+ * TwoWire Wire1(&sercom1, 11, 13);
+ * void    SERCOM1_Handler(void) {
+ *     Wire1.onService();
+ * }
+ * I2CBus fastBus(&Wire1, 400000);
+ * @endcode
+ * and after `fastBus.begin()`, `pinPeripheral()` gives the pins to the
+ * SERCOM.
+ *
+ * @note Transactions through the TwoWire block the processor, so buses don't
+ * run at the same time.  The other sensors keep taking their steps between
+ * transactions, the same as on a single bus.
+ *
+ * A sensor can instead queue an I2CTransaction on the bus with queue(), and
+ * take its result when the transaction's status says it has finished.  On a
+ * SAMD board given its SERCOM with setSercom(), the bytes clock out while the
+ * processor goes on with the other sensors' steps, the parsing of serial
+ * sensors, or an SD card commit.  The SERCOM's interrupt moves each
+ * transaction along if the sketch's handler calls onService():
+ * @code{.cpp}
+ * void SERCOM1_Handler(void) {
+ *     fastBus.onService();
+ * }
+ * fastBus.setSercom(SERCOM1, true);
+ * @endcode
+ * Otherwise the bus is polled each time a sensor idles the processor, a byte
+ * at a time.  The handlers of the board's own `Wire` are in its core, so the
+ * bus of `Wire` can only be polled.  On other boards, and with no SERCOM
+ * given, each transaction is run through the TwoWire when the bus is next
+ * serviced.  A blocking use of the bus, which always follows applyClock(),
+ * first waits for the queue to empty, so the two never overlap.
+ *
+ * @ingroup base_classes
+ */
+class I2CBus {
+ public:
+    /**
+     * @brief Construct a new I2C bus object and register it
+     *
+     * @param wire The TwoWire instance of the bus
+     * @param clock_hz The clock speed of the bus in Hz: 100000, 400000 or
+     * 1000000.  Default is 100000.
+     */
+    explicit I2CBus(TwoWire* wire, uint32_t clock_hz = 100000);
+    /**
+     * @brief Destroy the I2C bus object and unregister it
+     */
+    ~I2CBus();
+
+    /**
+     * @brief Start the bus and set its clock.
+     */
+    void begin(void);
+    /**
+     * @brief Set the clock speed of the bus.
+     *
+     * AVR boards are limited to 400 kHz; a faster clock is lowered to that.
+     *
+     * @param clock_hz The clock speed in Hz
+     */
+    void setClock(uint32_t clock_hz);
+    /**
+     * @brief Get the clock speed of the bus.
+     *
+     * @return **uint32_t** The clock speed in Hz
+     */
+    uint32_t getClock(void) {
+        return _clock_hz;
+    }
+    /**
+     * @brief Get the TwoWire instance of the bus.
+     *
+     * @return **TwoWire*** The TwoWire instance
+     */
+    TwoWire* getWire(void) {
+        return _wire;
+    }
+    /**
+     * @brief Set the clock of the bus again, in case a sensor library has put
+     * it back to the default by calling `begin()`.
+     *
+     * This first waits for every queued transaction to finish.
+     */
+    void applyClock(void);
+
+    /**
+     * @brief Queue a transaction on the bus.
+     *
+     * @param transaction The transaction, which must stay in place until it
+     * has finished
+     * @return **bool** True if it was queued; false if it already was
+     */
+    bool queue(I2CTransaction* transaction);
+    /**
+     * @brief Move the queued transactions along, calling the callback of each
+     * one that has finished.
+     *
+     * Sensor::idleProcessor() services every registered bus.
+     */
+    void service(void);
+    /**
+     * @brief Wait for every queued transaction to finish.
+     */
+    void finishAll(void);
+    /**
+     * @brief Check whether no transactions are queued on the bus.
+     *
+     * @return **bool** True if the queue is empty
+     */
+    bool isIdle(void) {
+        return _queueHead == nullptr;
+    }
+#if defined(ARDUINO_ARCH_SAMD) || defined(DOXYGEN)
+    /**
+     * @brief Give the SERCOM of the bus, so queued transactions run on it
+     * without blocking.
+     *
+     * The SERCOM must be the one of the bus's TwoWire, which starts it in
+     * begin().
+     *
+     * @param sercom The SERCOM's registers, like `SERCOM1`
+     * @param useInterrupt True if the sketch's handler of the SERCOM's
+     * interrupt calls onService(); false to poll the bus
+     */
+    void setSercom(Sercom* sercom, bool useInterrupt = false);
+    /**
+     * @brief Take the next step of the running transaction; call this from
+     * the handler of the SERCOM's interrupt.
+     */
+    void onService(void);
+#endif
+
+    /**
+     * @brief Find the registered bus of a TwoWire instance.
+     *
+     * @param wire The TwoWire instance
+     * @return **I2CBus*** The bus; nullptr if none was registered for it
+     */
+    static I2CBus* getBus(TwoWire* wire);
+    /**
+     * @brief Start every registered bus and set their clocks.
+     */
+    static void beginAll(void);
+    /**
+     * @brief Service the queue of every registered bus.
+     */
+    static void serviceAll(void);
+
+ protected:
+    /**
+     * @brief The TwoWire instance of the bus
+     */
+    TwoWire* _wire;
+    /**
+     * @brief The clock speed of the bus in Hz
+     */
+    uint32_t _clock_hz;
+    /**
+     * @brief The transaction at the front of the queue; it's the one running
+     */
+    I2CTransaction* volatile _queueHead = nullptr;
+    /**
+     * @brief The transaction at the back of the queue
+     */
+    I2CTransaction* _queueTail = nullptr;
+    /**
+     * @brief Run a transaction through the TwoWire, blocking until it has
+     * finished.
+     *
+     * @param transaction The transaction
+     */
+    void runBlocking(I2CTransaction* transaction);
+#if defined(ARDUINO_ARCH_SAMD) || defined(DOXYGEN)
+    /**
+     * @brief Put the address of a transaction on the SERCOM.
+     *
+     * @param transaction The transaction
+     */
+    void startSercom(I2CTransaction* transaction);
+    /**
+     * @brief Send a stop and set the status of the running transaction.
+     *
+     * @param success True if every byte was acknowledged
+     */
+    void stopSercom(bool success);
+    /**
+     * @brief The SERCOM of the bus; nullptr to use the TwoWire
+     */
+    Sercom* _sercom = nullptr;
+    /**
+     * @brief True if the SERCOM's interrupt moves the transactions along
+     */
+    bool _useInterrupt = false;
+    /**
+     * @brief True once the running transaction has sent its read address
+     */
+    volatile bool _reading = false;
+#endif
+    /**
+     * @brief The registered buses
+     */
+    static I2CBus* _buses[MS_MAX_I2C_BUSES];
+};
+
+#endif  // SRC_I2CBUS_H_
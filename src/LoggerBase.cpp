@@ -26,13 +26,47 @@
 int8_t Logger::_loggerTimeZone = 0;
 // Initialize the static time adjustment
 int8_t Logger::_loggerRTCOffset = 0;
+// Initialize the static sleep and wake times
+uint32_t Logger::_wakeMillis       = 0;
+uint32_t Logger::_lastAwakeTime_ms = 0;
+uint32_t Logger::_lastSleepTime_s  = 0;
+// Initialize the static cycle clock
+uint32_t Logger::_cycleEpoch       = 0;
+uint32_t Logger::_cycleMillis      = 0;
+uint32_t Logger::_cycleCheckMillis = 0;
+bool     Logger::_cycleFromAlarm   = false;
+bool     Logger::_cyclePhaseKnown  = false;
+// Initialize the wake flags
+volatile bool Logger::_alarmFired    = false;
+volatile bool Logger::_wakeRequested = false;
 // Initialize the static timestamps
 uint32_t Logger::markedLocalEpochTime = 0;
 uint32_t Logger::markedUTCEpochTime   = 0;
+uint32_t Logger::markedMillis         = 0;
+char     Logger::markedISO8601Time[MS_ISO8601_BUFFER_SIZE] = "";
 // Initialize the testing/logging flags
 volatile bool Logger::isLoggingNow = false;
 volatile bool Logger::isTestingNow = false;
 volatile bool Logger::startTesting = false;
+volatile bool Logger::stopTesting  = false;
+// Initialize the modem polled while waiting on sensors
+loggerModem* Logger::_pollingModem     = nullptr;
+Logger*      Logger::_committingLogger = nullptr;
+Logger*      Logger::_laggingLogger    = nullptr;
+// Initialize the last gasp and the SD card use count
+Logger*           Logger::_lastGaspLogger = nullptr;
+volatile bool     Logger::_inLastGasp     = false;
+volatile uint8_t  Logger::_sdBusy         = 0;
+volatile uint8_t  Logger::_sdWriting      = 0;
+volatile uint32_t Logger::_sdLastWrite_ms = 0;
+#if defined(MS_SD_LATENCY_STATS)
+// Initialize the SD card latency statistics
+uint16_t Logger::_sdLatencyHist[SD_OP_COUNT][MS_SD_LATENCY_BUCKETS] = {};
+uint32_t Logger::_sdWorstLatency_ms[SD_OP_COUNT]                    = {};
+uint16_t Logger::_sdFailures[SD_OP_COUNT]                           = {};
+uint16_t Logger::_sdRetries                                         = 0;
+bool     Logger::_sdFlushFailed                                     = false;
+#endif
 
 // Initialize the RTC for the SAMD boards
 #if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
@@ -107,7 +141,51 @@ void Logger::setLoggerID(const char* loggerID) {
 
 // Sets/Gets the logging interval
 void Logger::setLoggingInterval(uint16_t loggingIntervalMinutes) {
-    _loggingIntervalMinutes = loggingIntervalMinutes;
+    _loggingIntervalSeconds = static_cast<uint32_t>(loggingIntervalMinutes) *
+        60;
+}
+void Logger::setLoggingIntervalSeconds(uint32_t loggingIntervalSeconds) {
+    _loggingIntervalSeconds = loggingIntervalSeconds;
+}
+
+
+// Sets up the faster logging during events
+void Logger::setEventLogging(uint32_t eventIntervalSeconds,
+                             uint32_t holdOffSeconds, bool publishImmediately) {
+    _eventIntervalSeconds = eventIntervalSeconds;
+    _eventHoldOffSeconds  = holdOffSeconds;
+    _eventPublish         = publishImmediately;
+    if (_eventIntervalSeconds == 0) _eventActive = false;
+}
+bool Logger::addTrigger(Variable* variable, loggerTriggerType type,
+                        float threshold) {
+    if (_triggerCount >= MS_MAX_TRIGGERS) {
+        MS_DBG(F("No room for another trigger!"));
+        return false;
+    }
+    _triggers[_triggerCount].variable  = variable;
+    _triggers[_triggerCount].type      = type;
+    _triggers[_triggerCount].threshold = threshold;
+    _triggers[_triggerCount].lastValue = -9999;
+    _triggers[_triggerCount].lastTime  = 0;
+    _triggerCount++;
+    return true;
+}
+
+
+// Adds a history of recent values
+bool Logger::addHistory(VariableHistory* history) {
+    if (_historyCount >= MS_MAX_HISTORIES) {
+        MS_DBG(F("No room for another history!"));
+        return false;
+    }
+    _histories[_historyCount++] = history;
+    return true;
+}
+void Logger::recordHistories(void) {
+    for (uint8_t i = 0; i < _historyCount; i++) {
+        _histories[i]->record(Logger::markedUTCEpochTime);
+    }
 }
 
 
@@ -119,32 +197,65 @@ void Logger::setSamplingFeatureUUID(const char* samplingFeatureUUID) {
 // Sets up a pin controlling the power to the SD card
 void Logger::setSDCardPwr(int8_t SDCardPowerPin) {
     _SDCardPowerPin = SDCardPowerPin;
+    _SDCardPowerIO.attach(_SDCardPowerPin);
+    _sdPowered = false;
     if (_SDCardPowerPin >= 0) {
         pinMode(_SDCardPowerPin, OUTPUT);
-        digitalWrite(_SDCardPowerPin, LOW);
+        _SDCardPowerIO.low();
         MS_DBG(F("Pin"), _SDCardPowerPin, F("set as SD Card Power Pin"));
     }
 }
+// Sets how long the SD card needs after power-up and after a write
+void Logger::setSDCardTiming(uint16_t settle_ms, uint16_t housekeeping_ms) {
+    _sdSettle_ms       = settle_ms;
+    _sdHousekeeping_ms = housekeeping_ms;
+}
 // NOTE:  Structure of power switching on SD card taken from:
 // https://thecavepearlproject.org/2017/05/21/switching-off-sd-cards-for-low-power-data-logging/
+// The card is only switched once, and only what is left of the settle time is
+// waited out
 void Logger::turnOnSDcard(bool waitToSettle) {
     if (_SDCardPowerPin >= 0) {
-        digitalWrite(_SDCardPowerPin, HIGH);
-        // TODO(SRGDamia1):  figure out how long to wait
-        if (waitToSettle) { delay(6); }
+        if (!_sdPowered) {
+            _SDCardPowerIO.high();
+            _sdPowered    = true;
+            _sdPowerOn_ms = millis();
+        }
+        uint32_t sincePowerOn = millis() - _sdPowerOn_ms;
+        if (waitToSettle && sincePowerOn < _sdSettle_ms) {
+            waitForSDcard(_sdSettle_ms - sincePowerOn);
+        }
     }
 }
+// The housekeeping counts from the last write, so it has usually finished on
+// its own while the modem was publishing
 void Logger::turnOffSDcard(bool waitForHousekeeping) {
     if (_SDCardPowerPin >= 0) {
+        // Close the log file before cutting the power to it
+        syncLogFile(true);
+        if (waitForHousekeeping && _sdPowered) {
+            // Anything still writing counts as written just now
+            uint32_t sinceWrite =
+                _sdWriting > 0 ? 0 : millis() - _sdLastWrite_ms;
+            if (sinceWrite < _sdHousekeeping_ms) {
+                MS_DBG(F("Waiting"), _sdHousekeeping_ms - sinceWrite,
+                       F("ms for SD card housekeeping"));
+                waitForSDcard(_sdHousekeeping_ms - sinceWrite);
+            }
+        }
         // TODO(SRGDamia1): set All SPI pins to INPUT?
         // TODO(SRGDamia1): set ALL SPI pins HIGH (~30k pull-up)
         pinMode(_SDCardPowerPin, OUTPUT);
-        digitalWrite(_SDCardPowerPin, LOW);
-        // TODO(SRGDamia1):  wait in lower power mode
-        if (waitForHousekeeping) {
-            // Specs say up to 1s for internal housekeeping after each write
-            delay(1000);
-        }
+        _SDCardPowerIO.low();
+        _sdPowered = false;
+    }
+}
+// delay() never returns inside the watchdog interrupt
+void Logger::waitForSDcard(uint32_t wait_ms) {
+    if (_inLastGasp) {
+        for (uint32_t i = 0; i < wait_ms; i++) delayMicroseconds(1000);
+    } else {
+        Sensor::idleProcessor(wait_ms);
     }
 }
 
@@ -234,18 +345,159 @@ void Logger::setVariableArray(VariableArray* inputArray) {
 }
 
 
+// The file is named when it's first written, since the logger ID can be set
+// after the array is added
+int8_t Logger::addVariableArray(VariableArray* inputArray,
+                                uint32_t       intervalSeconds,
+                                const char*    fileName) {
+    if (_arrayCount >= MS_MAX_VARIABLE_ARRAYS || inputArray == nullptr ||
+        intervalSeconds == 0) {
+        MS_DBG(F("No room for another variable array!"));
+        return -1;
+    }
+    loggerArraySchedule& schedule = _arraySchedules[_arrayCount];
+    schedule.array                = inputArray;
+    schedule.intervalSeconds      = intervalSeconds;
+    schedule.fileName[0]          = '\0';
+    if (fileName != nullptr) {
+        strncpy(schedule.fileName, fileName, MS_FILE_NAME_SIZE - 1);
+        schedule.fileName[MS_FILE_NAME_SIZE - 1] = '\0';
+    }
+    return ++_arrayCount;
+}
+bool Logger::setPublisherArray(dataPublisher* publisher, uint8_t arrayNum) {
+    if (arrayNum > _arrayCount) return false;
+    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+        if (dataPublishers[i] == publisher) {
+            _publisherArrays[i] = arrayNum;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// The record buffer holds the values of one array, so it's emptied with each
+// switch and the values are formatted again as they're read
+void Logger::selectArray(uint8_t arrayNum) {
+    if (arrayNum == _activeArray) return;
+    if (_activeArray == 0) _mainArray = _internalArray;
+    _internalArray = arrayNum == 0 ? _mainArray
+                                   : _arraySchedules[arrayNum - 1].array;
+    _activeArray   = arrayNum;
+    _recordCount   = 0;
+    _recordLoaded  = false;
+}
+void Logger::updateDueArrays(void) {
+    for (uint8_t k = 1; k <= _arrayCount; k++) {
+        if (!isArrayDue(k)) continue;
+        MS_DBG(F("Running a complete update of variable array"), k);
+        watchDogTimer.resetWatchDog();
+        _arraySchedules[k - 1].array->setUpdatePeriod(
+            _arraySchedules[k - 1].intervalSeconds * 1000UL);
+        _arraySchedules[k - 1].array->completeUpdate();
+        watchDogTimer.resetWatchDog();
+    }
+}
+// The added arrays are written as CSV straight to their own files, so none of
+// the queue, rotation or binary settings of the main file apply to them
+void Logger::logDueArrays(void) {
+    if (_arraysDue == 0) return;
+    sdBusyGuard sdGuard;
+    // Writing another file mustn't change what's known of the main one
+    bool     tailChecked = _tailChecked;
+    uint32_t fileBytes   = _fileBytes;
+    _tailChecked         = true;
+    turnOnSDcard(true);
+    for (uint8_t k = 1; k <= _arrayCount; k++) {
+        if (!isArrayDue(k)) continue;
+        loggerArraySchedule& schedule = _arraySchedules[k - 1];
+        if (schedule.fileName[0] == '\0') {
+            snprintf(schedule.fileName, MS_FILE_NAME_SIZE, "%s_array%u.csv",
+                     _loggerID, k);
+        }
+        selectArray(k);
+        uint32_t save_ms = millis();
+        if (!openFile(schedule.fileName, true, false)) {
+            PRINTOUT(F("Unable to write to"), schedule.fileName);
+            recordSDLatency(SD_OP_SAVE, save_ms, false);
+            continue;
+        }
+        // A new file starts with the header of its own array
+        if (logFile.fileSize() == 0) printFileHeader(&logFile);
+        printSensorDataCSV(&logFile);
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
+        PRINTOUT(F("\n \\/---- Line Saved to"), schedule.fileName,
+                 F("----\\/"));
+        printSensorDataCSV(&MS_CONSOLE_OUTPUT);
+#endif
+        setFileTimestamp(logFile, T_WRITE | T_ACCESS);
+        recordSDLatency(SD_OP_SAVE, save_ms, logFile.close());
+        watchDogTimer.resetWatchDog();
+    }
+    selectArray(0);
+    _tailChecked = tailChecked;
+    _fileBytes   = fileBytes;
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
+
+
 // Returns the number of variables in the internal array
 uint8_t Logger::getArrayVarCount() {
     return _internalArray->getVariableCount();
 }
 
 
+// The SD card objects are part of the logger, but shown on their own
+void Logger::printMemoryReport(Print& out) {
+    MemoryReport::start(out);
+    uint16_t sdBytes = sizeof(sd) + sizeof(logFile);
+    MemoryReport::add(out, F("Logger"), sizeof(Logger) - sdBytes);
+    MemoryReport::add(out, F("SD card and log file"), sdBytes);
+    _internalArray->printMemoryReport(out);
+    bool hasPublishers = false;
+    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+        if (dataPublishers[i] == nullptr) continue;
+        hasPublishers = true;
+        MemoryReport::add(out, dataPublishers[i]->getEndpoint(),
+                          sizeof(dataPublisher));
+    }
+    // The publishers all share the one send buffer
+    if (hasPublishers) {
+        MemoryReport::add(out, F("Publishers' send buffer"),
+                          MS_SEND_BUFFER_SIZE);
+    }
+    if (_logModem != nullptr) {
+        MemoryReport::add(out, _logModem->getModemName(), sizeof(loggerModem));
+    }
+    // The history objects are apart from the logger, with their storage
+    for (uint8_t i = 0; i < _historyCount; i++) {
+        String name = F("History of ");
+        name += _histories[i]->getSource()->getVarCode();
+        MemoryReport::add(out, name,
+                          sizeof(VariableHistory) +
+                              _histories[i]->getStorageBytes());
+    }
+    MemoryReport::finish(out);
+}
+
+
 // This gets the name of the parent sensor, if applicable
+#if defined(MS_NO_STRING)
+const char* Logger::getParentSensorNameAtI(uint8_t position_i) {
+#else
 String Logger::getParentSensorNameAtI(uint8_t position_i) {
+#endif
     return _internalArray->arrayOfVars[position_i]->getParentSensorName();
 }
 // This gets the name and location of the parent sensor, if applicable
+#if defined(MS_NO_STRING)
+const char* Logger::getParentSensorNameAndLocationAtI(uint8_t position_i) {
+#else
 String Logger::getParentSensorNameAndLocationAtI(uint8_t position_i) {
+#endif
     return _internalArray->arrayOfVars[position_i]
         ->getParentSensorNameAndLocation();
 }
@@ -262,104 +514,1519 @@ String Logger::getVarUnitAtI(uint8_t position_i) {
 String Logger::getVarCodeAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarCode();
 }
+uint8_t Logger::formatVarCodeAtI(uint8_t position_i, char* buffer,
+                                 size_t bufferSize) {
+    return _internalArray->arrayOfVars[position_i]->formatVarCode(buffer,
+                                                                  bufferSize);
+}
 // This returns the variable UUID, if one has been assigned
 String Logger::getVarUUIDAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarUUID();
 }
-// This returns the current value of the variable as a string with the
-// correct number of significant figures
-String Logger::getValueStringAtI(uint8_t position_i) {
-    return _internalArray->arrayOfVars[position_i]->getValueString();
+uint8_t Logger::formatVarUUIDAtI(uint8_t position_i, char* buffer,
+                                 size_t bufferSize) {
+    return _internalArray->arrayOfVars[position_i]->formatVarUUID(buffer,
+                                                                  bufferSize);
+}
+bool Logger::getVarUUIDBytesAtI(uint8_t position_i, uint8_t* bytes) {
+    return _internalArray->arrayOfVars[position_i]->getVarUUIDBytes(bytes);
+}
+// This returns the current value of the variable as a string with the
+// correct number of significant figures
+#if defined(MS_NO_STRING)
+const char* Logger::getValueStringAtI(uint8_t position_i) {
+    const char* recorded = getRecordValueAtI(position_i);
+    if (recorded != nullptr) { return recorded; }
+#else
+String Logger::getValueStringAtI(uint8_t position_i) {
+    const char* recorded = getRecordValueAtI(position_i);
+    if (recorded != nullptr) { return String(recorded); }
+#endif
+    return _internalArray->arrayOfVars[position_i]->getValueString();
+}
+// This writes the current value of the variable into a buffer
+size_t Logger::formatValueAtI(uint8_t position_i, char* buffer,
+                              size_t bufferLen) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    const char* recorded = getRecordValueAtI(position_i);
+    if (recorded != nullptr) {
+        strncpy(buffer, recorded, bufferLen - 1);
+        buffer[bufferLen - 1] = '\0';
+        return strlen(buffer);
+    }
+    return _internalArray->arrayOfVars[position_i]->formatValue(buffer,
+                                                                bufferLen);
+}
+bool Logger::isValueStaleAtI(uint8_t position_i) {
+    if (_recordLoaded && _recordUpdateNumber == Variable::getUpdateNumber()) {
+        return false;
+    }
+    return _internalArray->arrayOfVars[position_i]->isValueStale(
+        _staleMaxAge_s);
+}
+// The middle of the sensor's measurements, from the start of the marked second
+int32_t Logger::getMeasurementOffsetAtI(uint8_t position_i) {
+    int32_t offset = 0;
+    if (_recordLoaded && _loadedRecord != nullptr) {
+        if (_measurementOffsets) {
+            memcpy(&offset,
+                   _loadedRecord + sizeof(uint32_t) +
+                       getArrayVarCount() * sizeof(float) +
+                       position_i * sizeof(int32_t),
+                   sizeof(offset));
+        }
+        return offset;
+    }
+    Variable* var = _internalArray->arrayOfVars[position_i];
+    if (var->isCalculated || var->parentSensor == nullptr) return offset;
+    uint32_t measured = var->parentSensor->getMeasurementMillis();
+    if (measured == 0) return offset;
+    return static_cast<int32_t>(measured - markedMillis);
+}
+// This writes a value as it goes into the data file
+size_t Logger::formatLoggedValueAtI(uint8_t position_i, char* buffer,
+                                    size_t bufferLen) {
+    if (_stalePolicy != STALE_KEEP && isValueStaleAtI(position_i)) {
+        strncpy(buffer, "-9999", bufferLen - 1);
+        buffer[bufferLen - 1] = '\0';
+        return strlen(buffer);
+    }
+    return formatValueAtI(position_i, buffer, bufferLen);
+}
+
+
+// This formats all of the current values into the record buffer
+void Logger::buildRecord(void) {
+    _recordCount        = 0;
+    _recordCursorIndex  = 0;
+    _recordCursorOffset = 0;
+    _recordUpdateNumber = Variable::getUpdateNumber();
+    _recordLoaded       = false;
+    _loadedRecord       = nullptr;
+
+    uint16_t offset = 0;
+    uint8_t  nVars  = getArrayVarCount();
+    for (uint8_t i = 0; i < nVars; i++) {
+        size_t remaining = MS_RECORD_BUFFER_SIZE - offset;
+        // Stop if a full-length value might not fit; the rest of the values
+        // will be formatted when they are read
+        if (remaining < MS_VALUE_BUFFER_SIZE) break;
+        size_t len = _internalArray->arrayOfVars[i]->formatValue(
+            _recordBuffer + offset, remaining);
+        offset += len + 1;
+        _recordCount++;
+    }
+    _recordLength = offset;
+    MS_DBG(F("Record holds"), _recordCount, F("of"), nVars, F("values in"),
+           offset, F("characters"));
+}
+
+
+// This returns the total length of all of the formatted values
+size_t Logger::getFormattedValuesLength(void) {
+    uint8_t nVars = getArrayVarCount();
+    // Every value is in the record, so just take away the terminating nulls
+    if (_recordCount == nVars &&
+        _recordUpdateNumber == Variable::getUpdateNumber()) {
+        return _recordLength - _recordCount;
+    }
+    size_t length = 0;
+    char   valueBuffer[MS_VALUE_BUFFER_SIZE];
+    for (uint8_t i = 0; i < nVars; i++) {
+        length += formatValueAtI(i, valueBuffer, sizeof(valueBuffer));
+    }
+    return length;
+}
+
+
+// This returns a pointer to a value in the record buffer, if it is current
+const char* Logger::getRecordValueAtI(uint8_t position_i) {
+    if (position_i >= _recordCount ||
+        _recordUpdateNumber != Variable::getUpdateNumber()) {
+        return nullptr;
+    }
+    // Values are almost always read in order, so start from the last one read
+    // rather than from the beginning of the buffer
+    if (position_i < _recordCursorIndex) {
+        _recordCursorIndex  = 0;
+        _recordCursorOffset = 0;
+    }
+    while (_recordCursorIndex < position_i) {
+        _recordCursorOffset += strlen(_recordBuffer + _recordCursorOffset) + 1;
+        _recordCursorIndex++;
+    }
+    return _recordBuffer + _recordCursorOffset;
+}
+
+
+// ===================================================================== //
+// Public functions for internet and dataPublishers
+// ===================================================================== //
+
+// Set up communications
+// Adds a loggerModem objct to the logger
+// loggerModem = TinyGSM modem + TinyGSM client + Modem On Off
+void Logger::attachModem(loggerModem& modem) {
+    _logModem = &modem;
+}
+
+
+// Sets whether to wake the modem before the sensor update
+void Logger::setModemPipelining(bool enablePipelining) {
+    _pipelineModem = enablePipelining;
+}
+
+
+// The network hint file is "MSNH" followed by the saved loggerModem hint
+// The time of each connection goes to the modem's history for the adaptive
+// timeout
+bool Logger::connectModemInternet(uint32_t maxConnectionTime) {
+    loadNetworkHint();
+    uint32_t started = millis();
+    bool     success = _logModem->connectInternet(maxConnectionTime);
+    _logModem->recordConnectTime(success ? millis() - started
+                                         : maxConnectionTime);
+    if (success) saveNetworkHint();
+    return success;
+}
+void Logger::loadNetworkHint(void) {
+    sdBusyGuard sdGuard(false);
+    if (_networkHintLoaded) return;
+    _networkHintLoaded = true;
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_network.bin", _loggerID);
+    File                     hintFile;
+    loggerModem::networkHint hint;
+    uint8_t                  magic[4];
+    if (_store != nullptr) {
+        if (storeRead(MS_STORE_KEY_NETWORK_HINT, &hint, sizeof(hint))) {
+            MS_DBG(F("Read the last network,"), hint.plmn,
+                   F("from the store"));
+            _logModem->setNetworkHint(hint);
+        }
+        return;
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        hintFile.open(fileName, O_READ)) {
+        if (hintFile.read(magic, 4) == 4 && memcmp(magic, "MSNH", 4) == 0 &&
+            hintFile.read(&hint, sizeof(hint)) == sizeof(hint)) {
+            MS_DBG(F("Read the last network,"), hint.plmn, F("from"),
+                   fileName);
+            _logModem->setNetworkHint(hint);
+        }
+        hintFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
+void Logger::saveNetworkHint(void) {
+    sdBusyGuard sdGuard;
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_network.bin", _loggerID);
+    File                     hintFile;
+    loggerModem::networkHint hint;
+    if (_store != nullptr && _logModem->networkHintChanged() &&
+        _logModem->getNetworkHint(hint)) {
+        if (storeWrite(MS_STORE_KEY_NETWORK_HINT, &hint, sizeof(hint))) {
+            MS_DBG(F("Saved the network,"), hint.plmn, F("to the store"));
+        }
+    } else if (_logModem->networkHintChanged() &&
+               _logModem->getNetworkHint(hint)) {
+#if defined(MS_SD_QUEUE_SIZE)
+        turnOnSDcard(true);
+#endif
+        if ((logFile.isOpen() || initializeSDCard()) &&
+            hintFile.open(fileName, O_CREAT | O_WRITE | O_TRUNC)) {
+            hintFile.write("MSNH", 4);
+            hintFile.write(reinterpret_cast<const uint8_t*>(&hint),
+                           sizeof(hint));
+            setFileTimestamp(hintFile, T_WRITE);
+            hintFile.close();
+            MS_DBG(F("Saved the network,"), hint.plmn, F("to"), fileName);
+        }
+#if defined(MS_SD_QUEUE_SIZE)
+        if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    }
+}
+#if defined(MS_MODEM_PROFILE_AT)
+// Each cycle's profile follows a line with the time of the cycle
+void Logger::saveModemProfile(void) {
+    sdBusyGuard sdGuard;
+    if (_logModem->atProfiler.getCommandCount() == 0) return;
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_atprofile.txt", _loggerID);
+    File profileFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        profileFile.open(fileName, O_CREAT | O_WRITE | O_AT_END)) {
+        profileFile.print(F("Cycle at "));
+        profileFile.println(formatDateTime_ISO8601(getNowLocalEpoch()));
+        _logModem->atProfiler.printSummary(profileFile);
+        setFileTimestamp(profileFile, T_WRITE);
+        profileFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
+#endif
+
+#if defined(MS_TRACE_BUFFER_SIZE)
+// Each cycle's trace follows a line with the time of the cycle
+void Logger::saveUpdateTrace(void) {
+    sdBusyGuard sdGuard;
+    if (UpdateTracer::getEventCount() == 0) return;
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_trace.txt", _loggerID);
+    File traceFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        traceFile.open(fileName, O_CREAT | O_WRITE | O_AT_END)) {
+        traceFile.print(F("Cycle at "));
+        traceFile.println(formatDateTime_ISO8601(getNowLocalEpoch()));
+        UpdateTracer::print(traceFile);
+        // The values close the cycle, so it can be replayed
+        char valueBuffer[MS_VALUE_BUFFER_SIZE];
+        traceFile.print(F("values"));
+        for (uint8_t i = 0; i < getArrayVarCount(); i++) {
+            formatValueAtI(i, valueBuffer, sizeof(valueBuffer));
+            traceFile.print(',');
+            traceFile.print(valueBuffer);
+        }
+        traceFile.println();
+        setFileTimestamp(traceFile, T_WRITE);
+        traceFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    UpdateTracer::clear();
+}
+#endif
+
+
+// Each phase starts with the marker pin changing level
+void Logger::markPhase(loggerCyclePhase phase) {
+    if (_phaseBudget_s[phase] > 0) {
+        watchDogTimer.startBudget(phase, _phaseBudget_s[phase]);
+    } else {
+        watchDogTimer.endBudget();
+    }
+#if defined(MS_PHASE_MARKER_PIN)
+    _phaseMarkerHigh = !_phaseMarkerHigh;
+    digitalWrite(MS_PHASE_MARKER_PIN, _phaseMarkerHigh ? HIGH : LOW);
+    _phaseStart[phase] = millis();
+    _phasesMarked |= static_cast<uint8_t>(1 << phase);
+#endif
+}
+
+
+// The phase is written by name; the one a watchdog record can't name is the
+// reset time of the whole cycle
+void Logger::saveWatchdogOverrun(void) {
+    uint8_t phase;
+    if (!watchDogTimer.getLastOverrun(&phase)) return;
+    const __FlashStringHelper* phaseName;
+    switch (phase) {
+        case PHASE_WAKE: phaseName = F("wake"); break;
+        case PHASE_POWER_UP: phaseName = F("power up"); break;
+        case PHASE_MEASURE: phaseName = F("measure"); break;
+        case PHASE_SD_COMMIT: phaseName = F("SD commit"); break;
+        case PHASE_MODEM_ATTACH: phaseName = F("modem attach"); break;
+        case PHASE_PUBLISH: phaseName = F("publish"); break;
+        case PHASE_SLEEP: phaseName = F("sleep"); break;
+        default: phaseName = F("no budget"); break;
+    }
+    PRINTOUT(F("The watchdog reset the logger during the phase:"), phaseName);
+
+    sdBusyGuard sdGuard;
+    char        fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_watchdog.txt", _loggerID);
+    File resetFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        resetFile.open(fileName, O_CREAT | O_WRITE | O_AT_END)) {
+        resetFile.print(formatDateTime_ISO8601(getNowLocalEpoch()));
+        resetFile.print(',');
+        resetFile.print(phaseName);
+        resetFile.print(',');
+        resetFile.println(phase < PHASE_COUNT ? _phaseBudget_s[phase] : 0);
+        setFileTimestamp(resetFile, T_WRITE);
+        resetFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
+#if defined(MS_PHASE_MARKER_PIN)
+// Each cycle is one line, in the order the marker pin changes
+void Logger::savePhaseTimes(void) {
+    sdBusyGuard sdGuard;
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_phases.csv", _loggerID);
+    File phaseFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        phaseFile.open(fileName, O_CREAT | O_WRITE | O_AT_END)) {
+        if (phaseFile.fileSize() == 0) {
+            phaseFile.println(F("Cycle time,Wake ms,Power up ms,Measure ms,"
+                                "SD commit ms,Modem attach ms,Publish ms,"
+                                "Sleep before s"));
+        }
+        phaseFile.print(formatDateTime_ISO8601(getNowLocalEpoch()));
+        // Each phase lasts until the next phase marked, and the sleep phase
+        // is always marked before this is saved
+        for (uint8_t phase = PHASE_WAKE; phase < PHASE_SLEEP; phase++) {
+            phaseFile.print(',');
+            if (!bitRead(_phasesMarked, phase)) continue;
+            uint8_t next = phase + 1;
+            while (next < PHASE_SLEEP && !bitRead(_phasesMarked, next)) {
+                next++;
+            }
+            phaseFile.print(_phaseStart[next] - _phaseStart[phase]);
+        }
+        phaseFile.print(',');
+        phaseFile.println(_lastSleepTime_s);
+        setFileTimestamp(phaseFile, T_WRITE);
+        phaseFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    _phasesMarked = 0;
+}
+#endif
+
+
+// The modem may already have connected while the sensors were measured
+bool Logger::finishModemConnect(uint32_t maxWait) {
+    uint32_t waitStart = millis();
+    loggerModem::modemState state = _logModem->poll();
+    while (state != loggerModem::stateConnected &&
+           state != loggerModem::stateFailed &&
+           millis() - waitStart < maxWait) {
+        watchDogTimer.resetWatchDog();
+        Sensor::idleProcessor(MS_MODEM_POLL_INTERVAL_MS);
+        state = _logModem->poll();
+    }
+    _pollingModem = nullptr;
+    // The record must be on the card before anything else is written to it
+    finishSDCommit();
+    bool connected = state == loggerModem::stateConnected;
+    if (connected) saveNetworkHint();
+    return connected;
+}
+// A step of the modem can itself wait, so it is never polled from inside
+// another poll
+void Logger::waitAndPollModem(void) {
+    static bool polling = false;
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
+    extendedWatchDogSAMD::resetWatchDog();
+#else
+    extendedWatchDogAVR::resetWatchDog();
+#endif
+    if (polling) return;
+    polling = true;
+    if (_pollingModem != nullptr &&
+        _pollingModem->poll() == loggerModem::stateConnected &&
+        _laggingLogger != nullptr) {
+        // The last records go out while the sensors are still measuring
+        Logger* logger = _laggingLogger;
+        _laggingLogger = nullptr;
+        logger->sendDueBacklogs();
+    }
+    polling = false;
+    // The commit can itself wait, and the modem is polled while it does
+    if (_committingLogger != nullptr) _committingLogger->stepSDCommit();
+}
+
+
+// The record and the checkpoint are written together, just as without the
+// overlap
+void Logger::startSDCommit(void) {
+    MS_DBG(F("Powering the SD card to commit while the modem connects"));
+    turnOnSDcard(false);
+    _sdCommitPending  = true;
+    _committingLogger = this;
+}
+void Logger::stepSDCommit(void) {
+    if (!_sdCommitPending) return;
+    if (_SDCardPowerPin >= 0 && _sdPowered &&
+        millis() - _sdPowerOn_ms < _sdSettle_ms) {
+        return;
+    }
+    finishSDCommit();
+}
+void Logger::finishSDCommit(void) {
+    if (!_sdCommitPending) return;
+    // Clear the flag first, so the waits in the commit don't start it again
+    _sdCommitPending  = false;
+    _committingLogger = nullptr;
+    // The record is always of the main array
+    uint8_t activeArray = _activeArray;
+    selectArray(0);
+    turnOnSDcard(true);
+    logToSD();
+    if (_checkpointing) saveCheckpoint();
+    selectArray(activeArray);
+}
+
+
+// Turns the watchdog's early warning to save the buffered data on or off
+void Logger::setLastGasp(bool enable, uint8_t barksBeforeReset) {
+    _lastGaspLogger = enable ? this : nullptr;
+    watchDogTimer.setEarlyWarning(enable ? &Logger::lastGasp : nullptr,
+                                  barksBeforeReset);
+}
+
+
+// Called from the watchdog interrupt; a card that was already being written
+// to when the logger locked up is left alone
+void Logger::lastGasp(void) {
+    if (_lastGaspLogger == nullptr || _sdBusy > 0) return;
+    _inLastGasp = true;
+#if defined(MS_SD_QUEUE_SIZE)
+    _lastGaspLogger->flushSDQueue();
+#endif
+    _lastGaspLogger->syncLogFile();
+    if (_lastGaspLogger->_checkpointing) _lastGaspLogger->saveCheckpoint();
+    _inLastGasp = false;
+}
+
+
+// The checkpoint file is "MSCP" followed by the loggerCheckpoint
+void Logger::saveCheckpoint(void) {
+    sdBusyGuard sdGuard;
+    loggerCheckpoint checkpoint;
+    checkpoint.lastRecordUTC       = Logger::markedUTCEpochTime;
+    checkpoint.driftRefUTC         = _driftRefUTC;
+    checkpoint.driftAdjusted       = _driftAdjusted;
+    checkpoint.lastSyncUTC         = _lastSyncUTC;
+    checkpoint.driftStepped        = _driftStepped;
+    checkpoint.driftPPM            = _driftPPM;
+    checkpoint.driftUncertaintyPPM = _driftUncertaintyPPM;
+    checkpoint.eventEndTime        = _eventEndTime;
+    checkpoint.eventActive         = _eventActive;
+    checkpoint.sensorCount         = 0;
+    for (uint8_t i = 0; i < MS_CHECKPOINT_MAX_SENSORS; i++) {
+        Sensor* sensor                = _internalArray->getSensor(i);
+        checkpoint.sensorFailures[i]  = 0;
+        checkpoint.sensorSkipsLeft[i] = 0;
+        if (sensor == nullptr) continue;
+        checkpoint.sensorCount        = i + 1;
+        checkpoint.sensorFailures[i]  = sensor->getConsecutiveFailures();
+        checkpoint.sensorSkipsLeft[i] = sensor->getFailureSkipsLeft();
+    }
+    checkpoint.connectTimeCount = _logModem != nullptr
+        ? _logModem->getConnectHistory(checkpoint.connectTimes)
+        : 0;
+
+    static_assert(sizeof(checkpoint) < 0xFF,
+                  "The checkpoint is too large for the persistent store");
+    if (_store != nullptr) {
+        // A store on a bus the watchdog may have interrupted keeps the
+        // checkpoint of the last record
+        if (_inLastGasp && !_store->getBackend()->isInterruptSafe()) return;
+        if (storeWrite(MS_STORE_KEY_CHECKPOINT, &checkpoint,
+                       sizeof(checkpoint))) {
+            MS_DBG(F("Saved a checkpoint to the store"));
+        }
+        return;
+    }
+
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_checkpoint.bin", _loggerID);
+    File checkpointFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        checkpointFile.open(fileName, O_CREAT | O_WRITE | O_TRUNC)) {
+        checkpointFile.write("MSCP", 4);
+        checkpointFile.write(reinterpret_cast<const uint8_t*>(&checkpoint),
+                             sizeof(checkpoint));
+        checkpointFile.close();
+        MS_DBG(F("Saved a checkpoint to"), fileName);
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
+bool Logger::loadCheckpoint(void) {
+    sdBusyGuard sdGuard(false);
+    loggerCheckpoint checkpoint;
+    uint8_t          magic[4];
+    bool             gotCheckpoint = false;
+
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_checkpoint.bin", _loggerID);
+    File checkpointFile;
+    if (_store != nullptr) {
+        gotCheckpoint = storeRead(MS_STORE_KEY_CHECKPOINT, &checkpoint,
+                                  sizeof(checkpoint));
+    } else {
+        turnOnSDcard(true);
+        if ((logFile.isOpen() || initializeSDCard()) &&
+            checkpointFile.open(fileName, O_READ)) {
+            gotCheckpoint = checkpointFile.read(magic, 4) == 4 &&
+                memcmp(magic, "MSCP", 4) == 0 &&
+                checkpointFile.read(&checkpoint, sizeof(checkpoint)) ==
+                    sizeof(checkpoint);
+            checkpointFile.close();
+        }
+        if (!_sdKeepOpen) turnOffSDcard(true);
+    }
+    if (!gotCheckpoint) return false;
+    // The connection times are kept from any checkpoint, since they belong
+    // to the site rather than to this run
+    if (_logModem != nullptr) {
+        _logModem->restoreConnectHistory(checkpoint.connectTimes,
+                                         checkpoint.connectTimeCount);
+    }
+
+    // Only a checkpoint from a recent record means the logger was reset in
+    // the middle of running, rather than switched off and on again
+    uint32_t now = getNowUTCEpoch();
+    if (!isRTCSane(now) || now < checkpoint.lastRecordUTC ||
+        now - checkpoint.lastRecordUTC > MS_CHECKPOINT_MAX_AGE) {
+        MS_DBG(F("The checkpoint in"), fileName, F("is too old to use"));
+        return false;
+    }
+
+    _driftRefUTC         = checkpoint.driftRefUTC;
+    _driftAdjusted       = checkpoint.driftAdjusted;
+    _lastSyncUTC         = checkpoint.lastSyncUTC;
+    _driftStepped        = checkpoint.driftStepped;
+    _driftPPM            = checkpoint.driftPPM;
+    _driftUncertaintyPPM = checkpoint.driftUncertaintyPPM;
+    _eventEndTime        = checkpoint.eventEndTime;
+    _eventActive         = checkpoint.eventActive;
+    // The sensors are only matched up if the array hasn't changed
+    bool sameSensors = checkpoint.sensorCount ==
+            _internalArray->getSensorCount() ||
+        (checkpoint.sensorCount == MS_CHECKPOINT_MAX_SENSORS &&
+         _internalArray->getSensorCount() > MS_CHECKPOINT_MAX_SENSORS);
+    for (uint8_t i = 0; i < _internalArray->getSensorCount(); i++) {
+        Sensor* sensor = _internalArray->getSensor(i);
+        if (sameSensors && i < checkpoint.sensorCount) {
+            sensor->restoreFailureState(checkpoint.sensorFailures[i],
+                                        checkpoint.sensorSkipsLeft[i]);
+        }
+        sensor->setDeferredSetup(true);
+    }
+    PRINTOUT(F("Resuming from the checkpoint of the record at"),
+             formatDateTime_ISO8601(checkpoint.lastRecordUTC));
+    return true;
+}
+
+
+// A store on the SD card needs the card started, like the files
+bool Logger::storeWrite(uint8_t key, const void* data, uint8_t len) {
+    bool onCard = _store->getBackend()->needsSDCard();
+#if defined(MS_SD_QUEUE_SIZE)
+    if (onCard) turnOnSDcard(true);
+#endif
+    bool success = (!onCard || logFile.isOpen() || initializeSDCard()) &&
+        _store->write(key, data, len);
+#if defined(MS_SD_QUEUE_SIZE)
+    if (onCard && !_sdKeepOpen) turnOffSDcard(true);
+#endif
+    return success;
+}
+bool Logger::storeRead(uint8_t key, void* data, uint8_t len) {
+    bool onCard = _store->getBackend()->needsSDCard();
+    if (onCard) turnOnSDcard(true);
+    // A value of another size is from a different build of the program
+    bool success = (!onCard || logFile.isOpen() || initializeSDCard()) &&
+        _store->read(key, data, len) == len;
+    if (onCard && !_sdKeepOpen) turnOffSDcard(true);
+    return success;
+}
+
+
+// Each setting is copied out whole, so a bad one can be skipped without
+// touching the rest
+uint8_t Logger::applySettings(const char* settings) {
+    uint8_t applied = 0;
+    char    line[48];
+    while (*settings != '\0') {
+        uint8_t len = 0;
+        while (*settings != '\0' && *settings != '\n' && *settings != ';') {
+            if (*settings != '\r' && len < sizeof(line) - 1) {
+                line[len++] = *settings;
+            }
+            settings++;
+        }
+        if (*settings != '\0') settings++;
+        line[len]    = '\0';
+        char* equals = strchr(line, '=');
+        if (len == 0 || line[0] == '#' || equals == nullptr) continue;
+        *equals           = '\0';
+        const char* value = equals + 1;
+        char*       end;
+        uint32_t    number = strtoul(value, &end, 10);
+        if (end == value) {
+            MS_DBG(F("Skipping the setting"), line, F("with no number"));
+            continue;
+        }
+
+        if (strcmp(line, "interval") == 0) {
+            if (number == 0) continue;
+            MS_DBG(F("Setting the logging interval to"), number, F("s"));
+            setLoggingIntervalSeconds(number);
+            applied++;
+        } else if (strncmp(line, "send", 4) == 0 && line[4] != '\0') {
+            uint8_t n = atoi(line + 4);
+            if (n >= MAX_NUMBER_SENDERS || dataPublishers[n] == nullptr ||
+                number == 0 || number > 255) {
+                continue;
+            }
+            uint32_t offset = *end == ',' ? strtoul(end + 1, nullptr, 10) : 0;
+            if (offset >= number) continue;
+            MS_DBG(F("Sending to publisher"), n, F("every"), number,
+                   F("intervals"));
+            dataPublishers[n]->setSendFrequency(number, offset);
+            applied++;
+        } else if (strncmp(line, "avg.", 4) == 0) {
+            Variable* variable = _internalArray->findByCode(line + 4);
+            if (variable == nullptr || variable->parentSensor == nullptr ||
+                number == 0 || number > 255) {
+                continue;
+            }
+            MS_DBG(F("Averaging"), number, F("measurements for"), line + 4);
+            variable->parentSensor->setNumberMeasurementsToAverage(number);
+            applied++;
+        } else if (strncmp(line, "timing.", 7) == 0) {
+            Variable* variable = _internalArray->findByCode(line + 7);
+            if (variable == nullptr || variable->parentSensor == nullptr ||
+                *end != ',') {
+                continue;
+            }
+            char*    stableEnd;
+            uint32_t stable = strtoul(end + 1, &stableEnd, 10);
+            if (*stableEnd != ',') continue;
+            uint32_t measure = strtoul(stableEnd + 1, nullptr, 10);
+            MS_DBG(F("Timing"), line + 7, F("at"), number, stable, measure,
+                   F("ms"));
+            variable->parentSensor->setTiming(number, stable, measure);
+            applied++;
+        } else {
+            MS_DBG(F("Skipping the unknown setting"), line);
+        }
+    }
+    return applied;
+}
+bool Logger::saveSettings(const char* settings, const char* etag) {
+    sdBusyGuard sdGuard;
+    char        fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_config.txt", _loggerID);
+    strncpy(_settingsETag, etag, sizeof(_settingsETag) - 1);
+    _settingsETag[sizeof(_settingsETag) - 1] = '\0';
+    File settingsFile;
+    bool success = false;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        settingsFile.open(fileName, O_CREAT | O_WRITE | O_TRUNC)) {
+        settingsFile.println(_settingsETag);
+        settingsFile.print(settings);
+        setFileTimestamp(settingsFile, T_WRITE);
+        settingsFile.close();
+        success = true;
+        MS_DBG(F("Saved the settings to"), fileName);
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    return success;
+}
+bool Logger::loadSettings(void) {
+    sdBusyGuard sdGuard(false);
+    char        fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_config.txt", _loggerID);
+    char     settings[MS_SETTINGS_SIZE + 1];
+    uint16_t len     = 0;
+    bool     gotFile = false;
+    File     settingsFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        settingsFile.open(fileName, O_READ)) {
+        uint8_t tagLen = 0;
+        int     c;
+        while ((c = settingsFile.read()) >= 0 && c != '\n') {
+            if (c != '\r' && tagLen < sizeof(_settingsETag) - 1) {
+                _settingsETag[tagLen++] = c;
+            }
+        }
+        _settingsETag[tagLen] = '\0';
+        len     = settingsFile.read(settings, MS_SETTINGS_SIZE);
+        gotFile = true;
+        settingsFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    if (!gotFile) return false;
+    settings[len > 0 && len <= MS_SETTINGS_SIZE ? len : 0] = '\0';
+    PRINTOUT(F("Applied"), applySettings(settings), F("settings from"),
+             fileName);
+    return true;
+}
+
+
+// The first variable of each sensor names it in the file
+uint8_t Logger::calibrateSensorTiming(uint8_t marginPercent,
+                                      bool    probeMeasurement) {
+    sdBusyGuard sdGuard;
+    char        fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_timing.txt", _loggerID);
+    uint8_t calibrated = 0;
+    File    timingFile;
+    bool    haveFile = false;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        timingFile.open(fileName, O_CREAT | O_WRITE | O_TRUNC)) {
+        haveFile = true;
+    }
+    for (uint8_t k = 0; k < _internalArray->getSensorCount(); k++) {
+        Sensor* sensor = _internalArray->getSensor(k);
+        watchDogTimer.resetWatchDog();
+        if (!sensor->calibrateTiming(marginPercent, probeMeasurement)) {
+            PRINTOUT(F("Couldn't calibrate the times of"),
+                     sensor->getSensorNameAndLocation());
+            continue;
+        }
+        calibrated++;
+        PRINTOUT(sensor->getSensorNameAndLocation(), F("times:"),
+                 sensor->getWarmUpTime(), sensor->getStabilizationTime(),
+                 sensor->getMeasurementTime(), F("ms"));
+        for (uint8_t i = 0; haveFile && i < getArrayVarCount(); i++) {
+            Variable* variable = _internalArray->arrayOfVars[i];
+            if (variable->isCalculated || variable->parentSensor != sensor) {
+                continue;
+            }
+            timingFile.print(F("timing."));
+            variable->printVarCode(timingFile);
+            timingFile.print('=');
+            timingFile.print(sensor->getWarmUpTime());
+            timingFile.print(',');
+            timingFile.print(sensor->getStabilizationTime());
+            timingFile.print(',');
+            timingFile.println(sensor->getMeasurementTime());
+            break;
+        }
+    }
+    watchDogTimer.resetWatchDog();
+    if (haveFile) {
+        setFileTimestamp(timingFile, T_WRITE);
+        timingFile.close();
+        MS_DBG(F("Saved the sensor times to"), fileName);
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    return calibrated;
+}
+// Each line is applied on its own, so the file isn't limited to the size of
+// the settings
+bool Logger::loadSensorTiming(void) {
+    sdBusyGuard sdGuard(false);
+    char        fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_timing.txt", _loggerID);
+    uint8_t applied = 0;
+    bool    gotFile = false;
+    File    timingFile;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        timingFile.open(fileName, O_READ)) {
+        char    line[48];
+        uint8_t len = 0;
+        int     c;
+        do {
+            c = timingFile.read();
+            if (c >= 0 && c != '\n') {
+                if (len < sizeof(line) - 1) line[len++] = c;
+                continue;
+            }
+            line[len] = '\0';
+            applied += applySettings(line);
+            len = 0;
+        } while (c >= 0);
+        gotFile = true;
+        timingFile.close();
+    }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+    if (!gotFile) return false;
+    PRINTOUT(F("Applied"), applied, F("sensor times from"), fileName);
+    return true;
+}
+
+
+// Takes advantage of the modem to synchronize the clock
+bool Logger::syncRTC() {
+    bool success = false;
+    if (_logModem != nullptr) {
+        // Synchronize the RTC with the network time, NTP or NIST
+        PRINTOUT(F("Attempting to connect to the internet and synchronize "
+                   "RTC"));
+        PRINTOUT(F("This may take up to two minutes!"));
+        if (_logModem->modemWake()) {
+            if (connectModemInternet(120000L)) {
+                setRTClock(_logModem->getUTCTime());
+                success = true;
+                _logModem->updateModemMetadata();
+            } else {
+                PRINTOUT(F("Could not connect to internet for clock sync."));
+            }
+        } else {
+            PRINTOUT(F("Could not wake modem for clock sync."));
+        }
+        watchDogTimer.resetWatchDog();
+        // Power down the modem - but only if there will be more than 15 seconds
+        // before the NEXT logging interval - it can take the modem that long to
+        // shut down
+
+        uint32_t setupFinishTime = getCycleLocalEpoch();
+        if (setupFinishTime % _loggingIntervalSeconds > 15) {
+            MS_DBG(F("At"), formatDateTime_ISO8601(setupFinishTime), F("with"),
+                   setupFinishTime % _loggingIntervalSeconds,
+                   F("seconds until next logging interval, putting modem to "
+                     "sleep"));
+            if (!_logModem->isPowerSaving()) {
+                _logModem->disconnectInternet();
+            }
+            _logModem->modemSleepPowerDown();
+        } else {
+            MS_DBG(F("At"), formatDateTime_ISO8601(setupFinishTime),
+                   F("there are only"),
+                   setupFinishTime % _loggingIntervalSeconds,
+                   F("seconds until next logging interval; leaving modem on "
+                     "and connected to the internet."));
+        }
+    }
+    watchDogTimer.resetWatchDog();
+    return success;
+}
+
+
+void Logger::registerDataPublisher(dataPublisher* publisher) {
+    // find the next empty spot in the publisher array
+    uint8_t i = 0;
+    for (; i < MAX_NUMBER_SENDERS; i++) {
+        if (dataPublishers[i] == publisher) {
+            MS_DBG(F("dataPublisher already registered."));
+            return;
+        }
+        if (dataPublishers[i] == nullptr) break;
+    }
+
+    // register the publisher there
+    dataPublishers[i] = publisher;
+}
+
+
+void Logger::publishDataToRemotes(void) {
+    MS_DBG(F("Sending out remote data."));
+
+    // Called on its own, outside of logDataAndPublish(), this is a session
+    bool ownSession = !_publishSessionOpen;
+    startPublishSession();
+    uint8_t order[MAX_NUMBER_SENDERS];
+    getPublishOrder(order);
+    uint32_t intervalNumber = getIntervalNumber();
+    for (uint8_t n = 0; n < MAX_NUMBER_SENDERS; n++) {
+        uint8_t i = order[n];
+        if (isPublisherInArray(i)) {
+            // Publishing late, this record waits in the backlog
+            if (_lagging && dataPublishers[i]->getBacklog() &&
+                isPublisherDue(i, intervalNumber)) {
+                continue;
+            }
+            dataPublishers[i]->resetTransferMetrics();
+            if (!isPublisherDue(i, intervalNumber)) {
+                // Keep the record to send with the next batch
+                MS_DBG(F("Publisher ["), i, F("] is not due"));
+                if (dataPublishers[i]->getSendsDeferred()) appendToBacklog(i);
+                continue;
+            }
+            if (dataPublishers[i]->isCircuitOpen(intervalNumber)) {
+                // Don't try an endpoint that keeps failing until it's time
+                MS_DBG(F("Publisher ["), i, F("] is backing off"));
+                if (dataPublishers[i]->getBacklog()) appendToBacklog(i);
+                continue;
+            }
+            if (getCycleTimeLeft() < MS_CYCLE_MIN_PUBLISH_MS) {
+                // Keep the record for the next cycle that has time
+                MS_DBG(F("No time left in the cycle for publisher ["), i,
+                       F("]"));
+                if (dataPublishers[i]->getBacklog()) appendToBacklog(i);
+                continue;
+            }
+            if (dataPublishers[i]->getPriority() > 0 &&
+                !isPublishBudgetLeft()) {
+                // Only the critical publishers may go over the budget
+                MS_DBG(F("The publishing budget is spent before publisher ["),
+                       i, F("]"));
+                if (dataPublishers[i]->getBacklog()) appendToBacklog(i);
+                continue;
+            }
+            PRINTOUT(F("\nSending data to ["), i, F("]"),
+                     dataPublishers[i]->getEndpoint());
+            // With its own socket, any publisher can leave the response
+            // until all of the requests are out
+            Client* muxClient = nullptr;
+            if (_concurrentPublish && _logModem != nullptr) {
+                muxClient = _logModem->getMuxClient(i);
+            }
+            // Only this first request may leave its response for later
+            dataPublisher::setDeferralAllowed(true, muxClient != nullptr);
+            int16_t response = muxClient != nullptr
+                ? dataPublishers[i]->publishData(muxClient)
+                : dataPublishers[i]->publishData();
+            dataPublisher::setDeferralAllowed(false);
+            watchDogTimer.resetWatchDog();
+            if (!dataPublishers[i]->responsePending()) {
+                handlePublishResult(i, response);
+            }
+        }
+    }
+    // Read the responses left while the other requests were sent
+    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+        if (isPublisherInArray(i) && dataPublishers[i]->responsePending()) {
+            PRINTOUT(F("\nReading the response from ["), i, F("]"),
+                     dataPublishers[i]->getEndpoint());
+            handlePublishResult(i, dataPublishers[i]->collectResponse());
+        }
+    }
+    // Don't leave a kept-alive connection open once everything is sent
+    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+        if (isPublisherInArray(i)) {
+            dataPublishers[i]->endPublishing();
+            dataPublishers[i]->notifyMetricVariables();
+        }
+    }
+    dataPublisher::closeConnection();
+    if (ownSession) _publishSessionOpen = false;
+}
+// A weak signal makes every byte cost more radio time, and a low battery can
+// afford less of it, so each halves the budget
+void Logger::startPublishSession(void) {
+    if (_publishSessionOpen) return;
+    _publishSessionOpen = true;
+    _sessionStart_ms    = millis();
+    _sessionStartBytes  = dataPublisher::getTotalBytesSent();
+    _sessionMillis      = _publishBudgetMillis;
+    _sessionBytes       = _publishBudgetBytes;
+    if (_publishBudgetMillis == 0 && _publishBudgetBytes == 0) return;
+    uint8_t shift   = _powerTier >= 0 ? 1 : 0;
+    int16_t rssi    = 0;
+    int16_t percent = 0;
+    if (_publishWeakRSSI != 0 && _logModem != nullptr &&
+        _logModem->getModemSignalQuality(rssi, percent) && rssi != 0 &&
+        rssi != -9999 && rssi < _publishWeakRSSI) {
+        shift++;
+    }
+    _sessionMillis >>= shift;
+    _sessionBytes >>= shift;
+    MS_DBG(F("Publishing budget is"), _sessionMillis, F("ms and"),
+           _sessionBytes, F("bytes"));
+}
+bool Logger::isPublishBudgetLeft(void) {
+    if (!_publishSessionOpen) return true;
+    if (_publishBudgetMillis > 0 &&
+        millis() - _sessionStart_ms >= _sessionMillis) {
+        return false;
+    }
+    if (_publishBudgetBytes > 0 &&
+        dataPublisher::getTotalBytesSent() - _sessionStartBytes >=
+            _sessionBytes) {
+        return false;
+    }
+    return true;
+}
+// An insertion sort keeps the publishers of the same priority in order
+void Logger::getPublishOrder(uint8_t* order) {
+    uint8_t priorities[MAX_NUMBER_SENDERS];
+    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+        uint8_t priority = dataPublishers[i] != nullptr
+            ? dataPublishers[i]->getPriority()
+            : 0xFF;
+        uint8_t j = i;
+        while (j > 0 && priorities[j - 1] > priority) {
+            order[j]      = order[j - 1];
+            priorities[j] = priorities[j - 1];
+            j--;
+        }
+        order[j]      = i;
+        priorities[j] = priority;
+    }
+}
+// The main record was built with the update; the others are built here
+void Logger::publishDueArrays(void) {
+    for (uint8_t k = 0; k <= _arrayCount; k++) {
+        if (!isArrayDue(k)) continue;
+        selectArray(k);
+        if (k != 0) buildRecord();
+        publishDataToRemotes();
+    }
+    selectArray(0);
+}
+// This saves or catches up on the backlog after a publish
+void Logger::handlePublishResult(uint8_t publisherNum, int16_t response) {
+    watchDogTimer.resetWatchDog();
+    dataPublisher* publisher = dataPublishers[publisherNum];
+    publisher->recordResult(response, getIntervalNumber());
+    if (!publisher->getBacklog() && !publisher->getSendsDeferred()) return;
+    if (dataPublisher::publishSucceeded(response)) {
+        // The connection is good, so try to catch up
+        replayBacklog(publisherNum);
+    } else if (dataPublisher::publishRetryable(response) &&
+               publisher->getBacklog()) {
+        appendToBacklog(publisherNum);
+    }
+    watchDogTimer.resetWatchDog();
+}
+// This checks if any publisher should send on this logging interval, for any
+// of the arrays due
+bool Logger::checkPublishersDue(void) {
+    bool due = false;
+    for (uint8_t k = 0; k <= _arrayCount && !due; k++) {
+        if (!isArrayDue(k)) continue;
+        selectArray(k);
+        uint32_t intervalNumber = getIntervalNumber();
+        for (uint8_t i = 0; i < MAX_NUMBER_SENDERS && !due; i++) {
+            due = isPublisherInArray(i) && isPublisherDue(i, intervalNumber) &&
+                !dataPublishers[i]->isCircuitOpen(intervalNumber);
+        }
+    }
+    selectArray(0);
+    return due;
+}
+// This returns the number of the logging interval of the marked time, as
+// counted by the selected array
+uint32_t Logger::getIntervalNumber(void) {
+    uint32_t interval = _activeArray == 0
+        ? _loggingIntervalSeconds
+        : _arraySchedules[_activeArray - 1].intervalSeconds;
+    if (interval == 0) return Logger::markedLocalEpochTime;
+    return Logger::markedLocalEpochTime / interval;
+}
+// During an event, publish every record if asked, or otherwise only the
+// records on the normal intervals.  A power tier can thin that out more.
+// Neither changes the intervals of the added arrays.
+bool Logger::isPublisherDue(uint8_t publisherNum, uint32_t intervalNumber) {
+    if (_activeArray != 0) {
+        return dataPublishers[publisherNum]->isSendDue(intervalNumber);
+    }
+    if (_powerTier >= 0) {
+        const loggerPowerTier& tier = _powerTiers[_powerTier];
+        // Count the records at the stretched interval
+        uint32_t record = intervalNumber / tier.intervalMultiplier;
+        if (tier.publishEveryX > 1 && record % tier.publishEveryX != 0) {
+            return false;
+        }
+    } else if (_eventActive) {
+        if (_eventPublish) return true;
+        if (_loggingIntervalSeconds != 0 &&
+            Logger::markedLocalEpochTime % _loggingIntervalSeconds != 0) {
+            return false;
+        }
+    }
+    return dataPublishers[publisherNum]->isSendDue(intervalNumber);
+}
+// These track the time budget of a logging cycle
+uint32_t Logger::getCycleTimeLeft(void) {
+    if (_cycleBudget_ms == 0) return 0xFFFFFFFF;
+    uint32_t elapsed = millis() - _cycleStart_ms;
+    return elapsed < _cycleBudget_ms ? _cycleBudget_ms - elapsed : 0;
+}
+void Logger::budgetSensorUpdate(void) {
+    uint32_t timeLeft = getCycleTimeLeft();
+    if (timeLeft == 0xFFFFFFFF) return;
+    // Even with no time left the sensors get one pass to be dropped cleanly
+    uint32_t budget = timeLeft > MS_CYCLE_SD_RESERVE_MS
+        ? timeLeft - MS_CYCLE_SD_RESERVE_MS
+        : 1;
+    MS_DBG(F("Sensor update has"), budget, F("ms of the cycle budget"));
+    _internalArray->setUpdateBudget(budget);
+}
+
+
+// A signal that can't be read is never held against publishing
+bool Logger::isSignalTooWeak(void) {
+    if (_minPublishRSSI == 0) return false;
+    int16_t rssi    = 0;
+    int16_t percent = 0;
+    if (!_logModem->getModemSignalQuality(rssi, percent) || rssi == 0 ||
+        rssi == -9999 || rssi >= _minPublishRSSI) {
+        _signalDeferrals = 0;
+        return false;
+    }
+    uint32_t now = Logger::markedUTCEpochTime;
+    if (_signalDeferrals == 0) _firstDeferredUTC = now;
+    if (_signalDeferrals >= _maxSignalDeferrals ||
+        now - _firstDeferredUTC >= _maxDeferredAge) {
+        PRINTOUT(F("Signal is weak at"), rssi,
+                 F("dBm, but the records have waited long enough"));
+        _signalDeferrals = 0;
+        return false;
+    }
+    _signalDeferrals++;
+    PRINTOUT(F("Signal is too weak at"), rssi,
+             F("dBm; holding the records back"));
+    return true;
+}
+
+
+// This saves the records of the arrays due for the publishers that are not
+// sending them now
+void Logger::saveUnsentRecords(bool includeDue) {
+    for (uint8_t k = 0; k <= _arrayCount; k++) {
+        if (!isArrayDue(k)) continue;
+        selectArray(k);
+        uint32_t intervalNumber = getIntervalNumber();
+        for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+            if (!isPublisherInArray(i)) continue;
+            // Nothing is sent this interval, so don't report the last
+            // transfers
+            dataPublishers[i]->resetTransferMetrics();
+            dataPublishers[i]->notifyMetricVariables();
+            if (isPublisherDue(i, intervalNumber)) {
+                // Backing off counts as not being reached
+                bool skipped = dataPublishers[i]->isCircuitOpen(intervalNumber);
+                if ((!includeDue && !skipped) ||
+                    !dataPublishers[i]->getBacklog())
+                    continue;
+            } else if (!dataPublishers[i]->getSendsDeferred()) {
+                continue;
+            }
+            appendToBacklog(i);
+            watchDogTimer.resetWatchDog();
+        }
+    }
+    selectArray(0);
+}
+// Each backlog is read back from the card, so none of the values of the
+// update underway are sent
+void Logger::sendDueBacklogs(void) {
+    _laggedSent             = true;
+    uint32_t intervalNumber = getIntervalNumber();
+    MS_DBG(F("Sending the backlogs of the due publishers"));
+#if !defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    startPublishSession();
+    uint8_t order[MAX_NUMBER_SENDERS];
+    getPublishOrder(order);
+    for (uint8_t n = 0; n < MAX_NUMBER_SENDERS; n++) {
+        uint8_t i = order[n];
+        if (!isPublisherInArray(i) || !dataPublishers[i]->getBacklog() ||
+            !isPublisherDue(i, intervalNumber) ||
+            dataPublishers[i]->isCircuitOpen(intervalNumber)) {
+            continue;
+        }
+        dataPublishers[i]->resetTransferMetrics();
+        replayBacklog(i);
+        dataPublishers[i]->endPublishing();
+        watchDogTimer.resetWatchDog();
+    }
+    dataPublisher::closeConnection();
+}
+void Logger::sendDataToRemotes(void) {
+    publishDataToRemotes();
 }
 
 
-// ===================================================================== //
-// Public functions for internet and dataPublishers
-// ===================================================================== //
+// The backlog file starts with "MSBQ", the uint16 record size, two reserved
+// bytes, and the uint32 offset of the oldest unsent record.  The records
+// follow in the binary record format.
+#define MS_BACKLOG_HEADER_SIZE 12
 
-// Set up communications
-// Adds a loggerModem objct to the logger
-// loggerModem = TinyGSM modem + TinyGSM client + Modem On Off
-void Logger::attachModem(loggerModem& modem) {
-    _logModem = &modem;
+// This writes the name of the backlog file for a publisher
+void Logger::getBacklogFileName(uint8_t publisherNum, char* buffer) {
+    snprintf(buffer, MS_FILE_NAME_SIZE, "%s_backlog%u.bin", _loggerID,
+             publisherNum);
 }
 
 
-// Takes advantage of the modem to synchronize the clock
-bool Logger::syncRTC() {
-    bool success = false;
-    if (_logModem != nullptr) {
-        // Synchronize the RTC with NIST
-        PRINTOUT(F("Attempting to connect to the internet and synchronize RTC "
-                   "with NIST"));
-        PRINTOUT(F("This may take up to two minutes!"));
-        if (_logModem->modemWake()) {
-            if (_logModem->connectInternet(120000L)) {
-                setRTClock(_logModem->getNISTTime());
-                success = true;
-                _logModem->updateModemMetadata();
-            } else {
-                PRINTOUT(F("Could not connect to internet for clock sync."));
-            }
-        } else {
-            PRINTOUT(F("Could not wake modem for clock sync."));
-        }
-        watchDogTimer.resetWatchDog();
-        // Power down the modem - but only if there will be more than 15 seconds
-        // before the NEXT logging interval - it can take the modem that long to
-        // shut down
-
-        uint32_t setupFinishTime = getNowLocalEpoch();
-        if (setupFinishTime % (_loggingIntervalMinutes * 60) > 15) {
-            MS_DBG(F("At"), formatDateTime_ISO8601(setupFinishTime), F("with"),
-                   setupFinishTime % (_loggingIntervalMinutes * 60),
-                   F("seconds until next logging interval, putting modem to "
-                     "sleep"));
-            _logModem->disconnectInternet();
-            _logModem->modemSleepPowerDown();
-        } else {
-            MS_DBG(F("At"), formatDateTime_ISO8601(setupFinishTime),
-                   F("there are only"),
-                   setupFinishTime % (_loggingIntervalMinutes * 60),
-                   F("seconds until next logging interval; leaving modem on "
-                     "and connected to the internet."));
+// This saves the current record to a publisher's backlog
+bool Logger::appendToBacklog(uint8_t publisherNum) {
+    sdBusyGuard sdGuard;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    char fileName[MS_FILE_NAME_SIZE];
+    getBacklogFileName(publisherNum, fileName);
+    uint16_t recSize = getBinaryRecordSize();
+    File     backlog;
+    bool     success = false;
+    // The card is already running if the log file is open
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        backlog.open(fileName, O_CREAT | O_RDWR)) {
+        uint8_t header[MS_BACKLOG_HEADER_SIZE];
+        bool    validHeader = backlog.fileSize() >= MS_BACKLOG_HEADER_SIZE &&
+            backlog.read(header, MS_BACKLOG_HEADER_SIZE) ==
+                MS_BACKLOG_HEADER_SIZE &&
+            memcmp(header, "MSBQ", 4) == 0 &&
+            memcmp(header + 4, &recSize, sizeof(recSize)) == 0;
+        if (!validHeader) {
+            // Start over if the file is new or the variables have changed
+            MS_DBG(F("Starting a new backlog in"), fileName);
+            uint32_t firstRecord = MS_BACKLOG_HEADER_SIZE;
+            memset(header, 0, MS_BACKLOG_HEADER_SIZE);
+            memcpy(header, "MSBQ", 4);
+            memcpy(header + 4, &recSize, sizeof(recSize));
+            memcpy(header + 8, &firstRecord, sizeof(firstRecord));
+            backlog.truncate(0);
+            backlog.write(header, MS_BACKLOG_HEADER_SIZE);
+        } else if ((backlog.fileSize() - MS_BACKLOG_HEADER_SIZE) % recSize) {
+            // Cut off a record torn by a reset, so the new one stays aligned
+            MS_DBG(F("Removing a torn record from"), fileName);
+            backlog.truncate(backlog.fileSize() -
+                             (backlog.fileSize() - MS_BACKLOG_HEADER_SIZE) %
+                                 recSize);
         }
+        uint8_t rec[recSize];
+        backlog.seekEnd();
+        success = backlog.write(rec, formatSensorDataBinary(rec, recSize)) ==
+            recSize;
+        MS_DBG(F("Saved the record to"), fileName, F("which is now"),
+               backlog.fileSize(), F("bytes"));
+        setFileTimestamp(backlog, T_WRITE);
+        success &= backlog.close();
     }
-    watchDogTimer.resetWatchDog();
+    if (!success) { PRINTOUT(F("Unable to save the record to"), fileName); }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
     return success;
 }
 
 
-void Logger::registerDataPublisher(dataPublisher* publisher) {
-    // find the next empty spot in the publisher array
-    uint8_t i = 0;
-    for (; i < MAX_NUMBER_SENDERS; i++) {
-        if (dataPublishers[i] == publisher) {
-            MS_DBG(F("dataPublisher already registered."));
-            return;
+// This sends as much of a publisher's backlog as the budget allows
+void Logger::replayBacklog(uint8_t publisherNum) {
+    sdBusyGuard sdGuard;
+#if defined(MS_SD_QUEUE_SIZE)
+    turnOnSDcard(true);
+#endif
+    char fileName[MS_FILE_NAME_SIZE];
+    getBacklogFileName(publisherNum, fileName);
+    File backlog;
+    if ((logFile.isOpen() || initializeSDCard()) &&
+        backlog.open(fileName, O_RDWR)) {
+        uint16_t recSize = getBinaryRecordSize();
+        uint8_t  header[MS_BACKLOG_HEADER_SIZE];
+        uint32_t nextRecord = 0;
+        if (backlog.read(header, MS_BACKLOG_HEADER_SIZE) ==
+                MS_BACKLOG_HEADER_SIZE &&
+            memcmp(header, "MSBQ", 4) == 0 &&
+            memcmp(header + 4, &recSize, sizeof(recSize)) == 0) {
+            memcpy(&nextRecord, header + 8, sizeof(nextRecord));
         }
-        if (dataPublishers[i] == nullptr) break;
+        uint32_t fileSize = backlog.fileSize();
+
+        if (nextRecord >= MS_BACKLOG_HEADER_SIZE && nextRecord < fileSize) {
+            MS_DBG(F("Sending up to"), (fileSize - nextRecord) / recSize,
+                   F("backlogged records from"), fileName);
+            // Keep the live record to put back afterwards
+            uint32_t liveLocal = Logger::markedLocalEpochTime;
+            uint32_t liveUTC   = Logger::markedUTCEpochTime;
+            uint8_t  rec[recSize];
+            uint32_t bytesSent = 0;
+            uint32_t start     = millis();
+            uint8_t  maxBatch =
+                dataPublishers[publisherNum]->getMaxBatchRecords();
+            while (nextRecord + recSize <= fileSize &&
+                   millis() - start < _backlogMaxMillis &&
+                   getCycleTimeLeft() >= MS_CYCLE_MIN_PUBLISH_MS &&
+                   isPublishBudgetLeft() &&
+                   (_backlogMaxBytes == 0 || bytesSent < _backlogMaxBytes)) {
+                backlog.seekSet(nextRecord);
+                if (backlog.read(rec, recSize) != recSize) break;
+                if (!checkBinaryRecord(rec)) {
+                    MS_DBG(F("Skipping a corrupt backlogged record"));
+                    nextRecord += recSize;
+                    continue;
+                }
+                int16_t response;
+                uint8_t nRecords = 1;
+                if (maxBatch > 1) {
+                    // Add the following good records to the batch, up to the
+                    // publisher's limit and the byte budget
+                    while (nRecords < maxBatch &&
+                           nextRecord + (nRecords + 1) * recSize <= fileSize &&
+                           (_backlogMaxBytes == 0 ||
+                            bytesSent + (nRecords + 1) * recSize <=
+                                _backlogMaxBytes) &&
+                           backlog.read(rec, recSize) == recSize &&
+                           checkBinaryRecord(rec)) {
+                        nRecords++;
+                    }
+                    MS_DBG(F("Sending a batch of"), nRecords, F("records"));
+                    _batchFile   = &backlog;
+                    _batchOffset = nextRecord;
+                    _batchCount  = nRecords;
+                    response     = dataPublishers[publisherNum]->publishBatch();
+                    _batchFile   = nullptr;
+                    _batchCount  = 0;
+                } else {
+                    if (!loadBinaryRecord(rec)) {
+                        MS_DBG(F("Backlogged values don't fit in the record!"));
+                        break;
+                    }
+                    response = dataPublishers[publisherNum]->publishData();
+                }
+                watchDogTimer.resetWatchDog();
+                // Stop if the connection has gone bad again; drop records
+                // the server refuses outright
+                if (!dataPublisher::publishSucceeded(response) &&
+                    dataPublisher::publishRetryable(response)) {
+                    break;
+                }
+                nextRecord += nRecords * recSize;
+                bytesSent += nRecords * recSize;
+            }
+            // Put the live record back
+            Logger::markedLocalEpochTime = liveLocal;
+            Logger::markedUTCEpochTime   = liveUTC;
+            formatDateTime_ISO8601(markedLocalEpochTime, markedISO8601Time,
+                                   sizeof(markedISO8601Time));
+            buildRecord();
+            MS_DBG(bytesSent / recSize, F("backlogged records sent in"),
+                   millis() - start, F("ms"));
+
+            // Move the ack pointer past everything sent, or empty the file
+            // once it has all gone
+            if (nextRecord >= fileSize) {
+                nextRecord = MS_BACKLOG_HEADER_SIZE;
+                backlog.truncate(MS_BACKLOG_HEADER_SIZE);
+            }
+            backlog.seekSet(8);
+            backlog.write(reinterpret_cast<uint8_t*>(&nextRecord),
+                          sizeof(nextRecord));
+            setFileTimestamp(backlog, T_WRITE);
+        }
+        backlog.close();
     }
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+}
 
-    // register the publisher there
-    dataPublishers[i] = publisher;
+
+// This checks the CRC of a binary record
+bool Logger::checkBinaryRecord(const uint8_t* record) {
+    uint16_t dataLen = getBinaryRecordSize() - sizeof(uint16_t);
+    uint16_t crc;
+    memcpy(&crc, record + dataLen, sizeof(crc));
+    return crc == crc16(record, dataLen);
 }
 
 
-void Logger::publishDataToRemotes(void) {
-    MS_DBG(F("Sending out remote data."));
+// This returns the local epoch time of a record in the batch being published
+uint32_t Logger::getBatchTime(uint8_t record_k) {
+    uint32_t localTime = 0;
+    if (_batchFile == nullptr || record_k >= _batchCount) return 0;
+    uint32_t recOffset = static_cast<uint32_t>(record_k) *
+        getBinaryRecordSize();
+    _batchFile->seekSet(_batchOffset + recOffset);
+    _batchFile->read(&localTime, sizeof(localTime));
+    return localTime;
+}
 
-    for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
-        if (dataPublishers[i] != nullptr) {
-            PRINTOUT(F("\nSending data to ["), i, F("]"),
-                     dataPublishers[i]->getEndpoint());
-            dataPublishers[i]->publishData();
-            watchDogTimer.resetWatchDog();
-        }
+
+// This formats a value from a record in the batch being published
+size_t Logger::formatBatchValueAtI(uint8_t record_k, uint8_t position_i,
+                                   char* buffer, size_t bufferLen) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    if (_batchFile == nullptr || record_k >= _batchCount) {
+        buffer[0] = '\0';
+        return 0;
     }
+    return _internalArray->arrayOfVars[position_i]->formatValue(
+        getBatchValueAtI(record_k, position_i), buffer, bufferLen);
 }
-void Logger::sendDataToRemotes(void) {
-    publishDataToRemotes();
+float Logger::getBatchValueAtI(uint8_t record_k, uint8_t position_i) {
+    float value = -9999;
+    if (_batchFile == nullptr || record_k >= _batchCount) return value;
+    uint32_t recOffset = static_cast<uint32_t>(record_k) *
+        getBinaryRecordSize();
+    _batchFile->seekSet(_batchOffset + recOffset + sizeof(uint32_t) +
+                        position_i * sizeof(float));
+    _batchFile->read(&value, sizeof(value));
+    return value;
+}
+int32_t Logger::getBatchOffsetAtI(uint8_t record_k, uint8_t position_i) {
+    int32_t offset = 0;
+    if (!_measurementOffsets || _batchFile == nullptr ||
+        record_k >= _batchCount) {
+        return offset;
+    }
+    uint32_t recOffset = static_cast<uint32_t>(record_k) *
+        getBinaryRecordSize();
+    _batchFile->seekSet(_batchOffset + recOffset + sizeof(uint32_t) +
+                        getArrayVarCount() * sizeof(float) +
+                        position_i * sizeof(int32_t));
+    _batchFile->read(&offset, sizeof(offset));
+    return offset;
+}
+
+
+// This makes a saved binary record the current record
+bool Logger::loadBinaryRecord(const uint8_t* record) {
+    uint8_t  nVars = getArrayVarCount();
+    uint32_t localTime;
+    memcpy(&localTime, record, sizeof(localTime));
+    // This is the reverse of markTime()
+    Logger::markedLocalEpochTime = localTime;
+    Logger::markedUTCEpochTime   = localTime -
+        ((uint32_t)_loggerRTCOffset) * 3600;
+    formatDateTime_ISO8601(markedLocalEpochTime, markedISO8601Time,
+                           sizeof(markedISO8601Time));
+
+    // Fill the record buffer with the saved values
+    _recordCount        = 0;
+    _recordCursorIndex  = 0;
+    _recordCursorOffset = 0;
+    _recordUpdateNumber = Variable::getUpdateNumber();
+    _recordLoaded       = true;
+    _loadedRecord       = record;
+    uint16_t offset     = 0;
+    for (uint8_t i = 0; i < nVars; i++) {
+        size_t remaining = MS_RECORD_BUFFER_SIZE - offset;
+        if (remaining < MS_VALUE_BUFFER_SIZE) return false;
+        float value;
+        memcpy(&value, record + sizeof(uint32_t) + i * sizeof(float),
+               sizeof(float));
+        offset += _internalArray->arrayOfVars[i]->formatValue(
+                      value, _recordBuffer + offset, remaining) +
+            1;
+        _recordCount++;
+    }
+    _recordLength = offset;
+    return true;
 }
 
 
@@ -461,6 +2128,7 @@ uint32_t Logger::getNowUTCEpoch(void) {
 }
 void Logger::setNowUTCEpoch(uint32_t ts) {
     rtc.setEpoch(ts);
+    _cycleEpoch = 0;
 }
 
 #elif defined ARDUINO_ARCH_SAMD
@@ -470,10 +2138,53 @@ uint32_t Logger::getNowUTCEpoch(void) {
 }
 void Logger::setNowUTCEpoch(uint32_t ts) {
     zero_sleep_rtc.setEpoch(ts);
+    _cycleEpoch = 0;
 }
 
 #endif
 
+
+// The cycle clock counts on from the last RTC time with millis()
+uint32_t Logger::getCycleUTCEpoch(void) {
+    if (_cycleEpoch == 0 ||
+        millis() - _cycleCheckMillis > MS_CYCLE_CLOCK_CHECK_MS) {
+        refreshCycleClock();
+    }
+    return _cycleEpoch + (millis() - _cycleMillis) / 1000;
+}
+uint32_t Logger::getCycleLocalEpoch(void) {
+    uint32_t currentEpochTime = getCycleUTCEpoch();
+    // Do NOT apply an offset if the timestamp is obviously bad
+    if (isRTCSane(currentEpochTime))
+        currentEpochTime += ((uint32_t)_loggerRTCOffset) * 3600;
+    return currentEpochTime;
+}
+// A clock that still agrees with the RTC is kept, since it may know where the
+// second started
+void Logger::refreshCycleClock(void) {
+    uint32_t rtcTime = getNowUTCEpoch();
+    uint32_t now     = millis();
+    _cycleCheckMillis = now;
+    _cycleFromAlarm   = false;
+    if (_cycleEpoch != 0 &&
+        _cycleEpoch + (now - _cycleMillis) / 1000 == rtcTime) {
+        return;
+    }
+    MS_DEEP_DBG(F("Restarting the cycle clock at"), rtcTime);
+    setCycleClock(rtcTime, now);
+    _cyclePhaseKnown = false;
+}
+bool Logger::getCycleUTCTime(uint32_t& epoch, uint16_t& msIntoSecond) {
+    epoch        = getCycleUTCEpoch();
+    msIntoSecond = _cyclePhaseKnown ? (millis() - _cycleMillis) % 1000 : 0;
+    return _cyclePhaseKnown;
+}
+void Logger::setCycleClock(uint32_t epochTime, uint32_t startMillis) {
+    _cycleEpoch       = epochTime;
+    _cycleMillis      = startMillis;
+    _cycleCheckMillis = startMillis;
+}
+
 // This converts the current UNIX timestamp (ie, the number of seconds
 // from January 1, 1970 00:00:00 UTC) into a DateTime object
 // The DateTime object constructor requires the number of seconds from
@@ -483,6 +2194,17 @@ DateTime Logger::dtFromEpoch(uint32_t epochTime) {
     return dt;
 }
 
+#if defined(MS_NO_STRING)
+// These write into one buffer, so each call writes over the last
+const char* Logger::formatDateTime_ISO8601(DateTime& dt) {
+    return formatDateTime_ISO8601(dt.getEpoch());
+}
+const char* Logger::formatDateTime_ISO8601(uint32_t epochTime) {
+    static char dateTimeBuffer[MS_ISO8601_BUFFER_SIZE];
+    formatDateTime_ISO8601(epochTime, dateTimeBuffer, sizeof(dateTimeBuffer));
+    return dateTimeBuffer;
+}
+#else
 // This converts a date-time object into a ISO8601 formatted string
 // It assumes the supplied date/time is in the LOGGER's timezone and adds
 // the LOGGER's offset as the time zone offset in the string.
@@ -517,6 +2239,34 @@ String Logger::formatDateTime_ISO8601(uint32_t epochTime) {
     DateTime dt = dtFromEpoch(epochTime);
     return formatDateTime_ISO8601(dt);
 }
+#endif
+
+// This writes an epoch time (unix time) into a buffer as an ISO8601 formatted
+// string.
+// It assumes the supplied date/time is in the LOGGER's timezone and adds the
+// LOGGER's offset as the time zone offset in the string.
+size_t Logger::formatDateTime_ISO8601(uint32_t epochTime, char* buffer,
+                                      size_t bufferLen) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    DateTime dt = dtFromEpoch(epochTime);
+    int      len;
+    if (_loggerTimeZone == 0) {
+        len = snprintf(buffer, bufferLen, "%04u-%02u-%02uT%02u:%02u:%02uZ",
+                       dt.year(), dt.month(), dt.date(), dt.hour(),
+                       dt.minute(), dt.second());
+    } else {
+        len = snprintf(buffer, bufferLen,
+                       "%04u-%02u-%02uT%02u:%02u:%02u%c%02d:00", dt.year(),
+                       dt.month(), dt.date(), dt.hour(), dt.minute(),
+                       dt.second(), _loggerTimeZone < 0 ? '-' : '+',
+                       abs(_loggerTimeZone));
+    }
+    if (len < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return (size_t)len < bufferLen ? len : bufferLen - 1;
+}
 
 
 // This sets the real time clock to the given time
@@ -550,9 +2300,39 @@ bool Logger::setRTClock(uint32_t UTCEpochSeconds) {
     // milliseconds behind the input time.  Given the clock is only accurate to
     // seconds (not milliseconds or less), I don't think this is a problem.
 
+    // Track how fast the RTC drifts from the true time
+    int32_t rtcError = static_cast<int32_t>(getNowUTCEpoch() -
+                                            UTCEpochSeconds);
+    if (_driftRefUTC == 0 || !isRTCSane(cur_logTZ)) {
+        _driftRefUTC   = UTCEpochSeconds;
+        _driftAdjusted = rtcError;
+    } else if (UTCEpochSeconds - _driftRefUTC >= MS_MIN_DRIFT_WINDOW) {
+        uint32_t window = UTCEpochSeconds - _driftRefUTC;
+        float    ppm    = (rtcError - _driftAdjusted) * 1e6f / window;
+        if (fabs(ppm) > 1000) {
+            // Far more than any crystal drifts; the clock must have been
+            // changed some other way, so start measuring again
+            MS_DBG(F("Ignoring an RTC drift of"), ppm, F("ppm"));
+            _driftRefUTC         = UTCEpochSeconds;
+            _driftAdjusted       = rtcError;
+            _driftPPM            = 0;
+            _driftUncertaintyPPM = 0;
+        } else {
+            _driftPPM = ppm;
+            // Each end of the window is only known to a second, and the
+            // drift of a crystal changes with its temperature
+            _driftUncertaintyPPM = max(2e6f / window, 1.0f);
+            MS_DBG(F("    RTC drift:"), _driftPPM, F("+/-"),
+                   _driftUncertaintyPPM, F("ppm"));
+        }
+    }
+    _lastSyncUTC  = UTCEpochSeconds;
+    _driftStepped = 0;
+
     // If the RTC and NIST disagree by more than 5 seconds, set the clock
     if (abs(set_logTZ - cur_logTZ) > 5) {
         setNowUTCEpoch(set_rtcTZ);
+        _driftAdjusted -= rtcError;
         PRINTOUT(F("Clock set!"));
         return true;
     } else {
@@ -561,6 +2341,72 @@ bool Logger::setRTClock(uint32_t UTCEpochSeconds) {
     }
 }
 
+// The RTC is set just as the source's next second starts
+bool Logger::setRTClockPhase(uint32_t UTCEpochSeconds, uint16_t msIntoSecond,
+                             uint16_t tolerance_ms) {
+    if (UTCEpochSeconds == 0) return false;
+    uint32_t received = millis();
+    setRTClock(UTCEpochSeconds);
+    uint32_t sourceMs = msIntoSecond + (millis() - received);
+    uint32_t epoch;
+    uint16_t ms;
+    if (getCycleUTCTime(epoch, ms)) {
+        int32_t offset = static_cast<int32_t>(epoch - UTCEpochSeconds) * 1000 +
+            ms - static_cast<int32_t>(sourceMs);
+        MS_DBG(F("    RTC second starts"), offset, F("ms from the source's"));
+        if (offset >= -tolerance_ms && offset <= tolerance_ms) return false;
+    }
+    watchDogTimer.resetWatchDog();
+    sourceMs = msIntoSecond + (millis() - received);
+    delay(1000 - sourceMs % 1000);
+    uint32_t newTime = UTCEpochSeconds + sourceMs / 1000 + 1;
+    uint32_t before  = getNowUTCEpoch();
+    setNowUTCEpoch(newTime);
+    setCycleClock(newTime, millis());
+    _cyclePhaseKnown = true;
+    // Keep the drift measured across the step
+    _driftAdjusted += static_cast<int32_t>(newTime - before);
+    PRINTOUT(F("Clock set to the start of the source's second!"));
+    return true;
+}
+
+
+void Logger::setClockSyncTolerance(uint16_t maxErrorSeconds,
+                                   uint16_t maxDaysBetween) {
+    _syncMaxError = maxErrorSeconds;
+    _syncMaxDays  = maxDaysBetween;
+}
+
+
+// Until the drift is known, sync at noon every day
+bool Logger::isClockSyncDue(void) {
+    if (!isRTCSane(Logger::markedLocalEpochTime)) return true;
+    if (_driftUncertaintyPPM == 0) {
+        return Logger::markedLocalEpochTime % 86400 == 43200;
+    }
+    if (Logger::markedUTCEpochTime < _lastSyncUTC) return false;
+    uint32_t sinceSync = Logger::markedUTCEpochTime - _lastSyncUTC;
+    if (sinceSync >= static_cast<uint32_t>(_syncMaxDays) * 86400) return true;
+    return _driftUncertaintyPPM * 1e-6f * sinceSync >= _syncMaxError;
+}
+
+
+// Steps the RTC a second at a time toward the drift-corrected time
+void Logger::correctClockDrift(void) {
+    if (_driftUncertaintyPPM == 0) return;
+    if (Logger::markedUTCEpochTime < _lastSyncUTC) return;
+    uint32_t sinceSync = Logger::markedUTCEpochTime - _lastSyncUTC;
+    int32_t  due       = static_cast<int32_t>(
+        round(-_driftPPM * 1e-6f * sinceSync));
+    if (due == _driftStepped) return;
+    int8_t step = due > _driftStepped ? 1 : -1;
+    MS_DBG(F("Stepping the RTC"), step, F("second for drift"));
+    setNowUTCEpoch(getNowUTCEpoch() + step);
+    _driftStepped += step;
+    _driftAdjusted += step;
+}
+
+
 // This checks that the logger time is within a "sane" range
 bool Logger::isRTCSane(void) {
     uint32_t curRTC = getNowLocalEpoch();
@@ -584,9 +2430,15 @@ bool Logger::isRTCSane(uint32_t epochTime) {
 // sensor was updated, just a single marked time.  By custom, this should be
 // called before updating the sensors, not after.
 void Logger::markTime(void) {
-    Logger::markedUTCEpochTime   = getNowUTCEpoch();
+    // A clock started from the alarm is only checked when a record is made
+    if (_cycleFromAlarm) refreshCycleClock();
+    Logger::markedUTCEpochTime   = getCycleUTCEpoch();
     Logger::markedLocalEpochTime = markedUTCEpochTime +
         ((uint32_t)_loggerRTCOffset) * 3600;
+    Logger::markedMillis = _cycleMillis +
+        (markedUTCEpochTime - _cycleEpoch) * 1000;
+    formatDateTime_ISO8601(markedLocalEpochTime, markedISO8601Time,
+                           sizeof(markedISO8601Time));
 }
 
 
@@ -594,16 +2446,27 @@ void Logger::markTime(void) {
 // rate
 bool Logger::checkInterval(void) {
     bool     retval;
-    uint32_t checkTime = getNowLocalEpoch();
+    uint32_t checkTime = getCycleLocalEpoch();
     MS_DBG(F("Current Unix Timestamp:"), checkTime, F("->"),
            formatDateTime_ISO8601(checkTime));
-    MS_DBG(F("Logging interval in seconds:"), (_loggingIntervalMinutes * 60));
-    MS_DBG(F("Mod of Logging Interval:"),
-           checkTime % (_loggingIntervalMinutes * 60));
+    uint32_t interval  = getActiveIntervalSeconds();
+    MS_DBG(F("Logging interval in seconds:"), interval);
+    MS_DBG(F("Mod of Logging Interval:"), checkTime % interval);
+
+    // Note every array due now, so they can share the one wake
+    _mainDue   = checkTime % interval == 0;
+    _arraysDue = 0;
+    for (uint8_t k = 0; k < _arrayCount; k++) {
+        if (checkTime % _arraySchedules[k].intervalSeconds == 0) {
+            MS_DBG(F("Variable array"), k + 1, F("is due"));
+            _arraysDue |= 1 << k;
+        }
+    }
 
-    if (checkTime % (_loggingIntervalMinutes * 60) == 0) {
+    if (_mainDue || _arraysDue != 0) {
         // Update the time variables with the current time
         markTime();
+        correctClockDrift();
         MS_DBG(F("Time marked at (unix):"), Logger::markedLocalEpochTime);
         MS_DBG(F("Time to log!"));
         retval = true;
@@ -664,14 +2527,15 @@ bool Logger::checkInterval(void) {
 
 // This checks to see if the MARKED time is an even interval of the logging rate
 bool Logger::checkMarkedInterval(void) {
-    bool retval;
+    bool     retval;
+    uint32_t interval = getActiveIntervalSeconds();
     MS_DBG(F("Marked Time:"), Logger::markedLocalEpochTime,
-           F("Logging interval in seconds:"), (_loggingIntervalMinutes * 60),
+           F("Logging interval in seconds:"), interval,
            F("Mod of Logging Interval:"),
-           Logger::markedLocalEpochTime % (_loggingIntervalMinutes * 60));
+           Logger::markedLocalEpochTime % interval);
 
     if (Logger::markedLocalEpochTime != 0 &&
-        (Logger::markedLocalEpochTime % (_loggingIntervalMinutes * 60) == 0)) {
+        (Logger::markedLocalEpochTime % interval == 0)) {
         MS_DBG(F("Time to log!"));
         retval = true;
     } else {
@@ -682,6 +2546,187 @@ bool Logger::checkMarkedInterval(void) {
 }
 
 
+// This finds the next even interval of the logging rate in the logger's time
+// and converts it back to the time kept by the RTC
+uint32_t Logger::getNextIntervalRTCEpoch(void) {
+    uint32_t rtcTime   = getCycleUTCEpoch();
+    uint32_t localTime = rtcTime;
+    if (isRTCSane(rtcTime)) localTime += ((uint32_t)_loggerRTCOffset) * 3600;
+    uint32_t interval = getActiveIntervalSeconds();
+    uint32_t next     = (localTime / interval + 1) * interval;
+    return rtcTime + (next - localTime);
+}
+
+
+// Each added array is due on the multiples of its own interval in the
+// logger's time, just like the main one
+uint32_t Logger::getNextArraysRTCEpoch(void) {
+    if (_arrayCount == 0) return 0;
+    uint32_t rtcTime   = getCycleUTCEpoch();
+    uint32_t localTime = rtcTime;
+    if (isRTCSane(rtcTime)) localTime += ((uint32_t)_loggerRTCOffset) * 3600;
+    uint32_t next = 0;
+    for (uint8_t k = 0; k < _arrayCount; k++) {
+        uint32_t interval = _arraySchedules[k].intervalSeconds;
+        uint32_t due      = (localTime / interval + 1) * interval;
+        if (next == 0 || due < next) next = due;
+    }
+    return rtcTime + (next - localTime);
+}
+
+
+// The lead is rounded up to whole seconds, since that's all the alarm can do
+uint32_t Logger::getPreWarmLead(void) {
+    if (!_preWarm || _internalArray == nullptr) return 0;
+    uint32_t lead_ms = _internalArray->getPreWarmTime();
+    return (lead_ms + 999) / 1000;
+}
+
+
+// The time to the interval is counted from where the cycle clock's second
+// started, so the update starts right as the interval turns over
+void Logger::preWarmForInterval(void) {
+    uint32_t lead = getPreWarmLead();
+    if (lead == 0) return;
+    // Nothing to do on the interval itself, or if something else woke us
+    // long before it
+    if (getCycleLocalEpoch() % getActiveIntervalSeconds() == 0) return;
+    uint32_t now          = getCycleUTCEpoch();
+    uint32_t nextInterval = getNextIntervalRTCEpoch();
+    if (nextInterval - now > lead) return;
+
+    uint32_t elapsed  = millis() - _cycleMillis;
+    uint32_t untilDue = (nextInterval - _cycleEpoch) * 1000;
+    untilDue          = untilDue > elapsed ? untilDue - elapsed : 0;
+    MS_DBG(F("Warming up the sensors"), untilDue, F("ms ahead of the interval"));
+    watchDogTimer.resetWatchDog();
+    _internalArray->preWarmSensors(untilDue);
+    watchDogTimer.resetWatchDog();
+    // The wait ended as the second turned over
+    setCycleClock(nextInterval, millis());
+}
+
+
+// These set up the low battery power tiers, keeping them in order from the
+// highest threshold to the lowest
+void Logger::setPowerPolicy(Variable* batteryVariable) {
+    _batteryVariable = batteryVariable;
+}
+bool Logger::addPowerTier(float belowVolts, uint8_t intervalMultiplier,
+                          uint8_t publishEveryX, bool shedSensors,
+                          bool modemOff) {
+    if (_powerTierCount >= MS_MAX_POWER_TIERS) {
+        MS_DBG(F("No room for another power tier!"));
+        return false;
+    }
+    uint8_t i = _powerTierCount++;
+    while (i > 0 && _powerTiers[i - 1].belowVolts < belowVolts) {
+        _powerTiers[i] = _powerTiers[i - 1];
+        i--;
+    }
+    _powerTiers[i].belowVolts         = belowVolts;
+    _powerTiers[i].intervalMultiplier = intervalMultiplier == 0
+        ? 1
+        : intervalMultiplier;
+    _powerTiers[i].publishEveryX = publishEveryX;
+    _powerTiers[i].shedSensors   = shedSensors;
+    _powerTiers[i].modemOff      = modemOff;
+    return true;
+}
+bool Logger::addSheddableSensor(Sensor* sensor) {
+    if (_shedSensorCount >= MS_MAX_SHED_SENSORS) {
+        MS_DBG(F("No room for another sheddable sensor!"));
+        return false;
+    }
+    _shedSensors[_shedSensorCount++] = sensor;
+    return true;
+}
+
+
+// A lower tier is entered as soon as the battery drops below it, but a tier is
+// only left once the battery is clearly back above it
+void Logger::checkPowerTier(void) {
+    if (_batteryVariable == nullptr || _powerTierCount == 0) return;
+    float volts = _batteryVariable->getValue();
+    if (volts == -9999) return;
+
+    int8_t below     = -1;
+    int8_t recovered = -1;
+    for (uint8_t i = 0; i < _powerTierCount; i++) {
+        if (volts < _powerTiers[i].belowVolts) below = i;
+        if (volts < _powerTiers[i].belowVolts + MS_POWER_TIER_HYSTERESIS) {
+            recovered = i;
+        }
+    }
+    int8_t tier = below;
+    if (below < _powerTier) tier = min(_powerTier, recovered);
+    if (tier == _powerTier) return;
+
+    PRINTOUT(F("Battery at"), volts, F("V; changing from power tier"),
+             _powerTier, F("to"), tier);
+    _powerTier = tier;
+    bool shed  = _powerTier >= 0 && _powerTiers[_powerTier].shedSensors;
+    for (uint8_t i = 0; i < _shedSensorCount; i++) {
+        _shedSensors[i]->setSuspended(shed);
+    }
+}
+
+
+// This starts an event when any trigger is met and ends it once none have been
+// for the hold-off time
+void Logger::checkTriggers(void) {
+    if (_eventIntervalSeconds == 0 || _triggerCount == 0) return;
+    // Events would use more power than a power tier allows
+    if (_powerTier >= 0) {
+        _eventActive = false;
+        return;
+    }
+    bool     triggered = false;
+    uint32_t now       = Logger::markedUTCEpochTime;
+    for (uint8_t i = 0; i < _triggerCount; i++) {
+        loggerTrigger& trig  = _triggers[i];
+        float          value = trig.variable->getValue();
+        if (value == -9999) continue;
+        bool met = false;
+        switch (trig.type) {
+            case TRIGGER_ABOVE: met = value > trig.threshold; break;
+            case TRIGGER_BELOW: met = value < trig.threshold; break;
+            case TRIGGER_RISING:
+            case TRIGGER_FALLING:
+                if (trig.lastValue != -9999 && now > trig.lastTime) {
+                    float perMinute = (value - trig.lastValue) * 60 /
+                        (now - trig.lastTime);
+                    if (trig.type == TRIGGER_FALLING) perMinute = -perMinute;
+                    met = perMinute > trig.threshold;
+                }
+                break;
+        }
+        trig.lastValue = value;
+        trig.lastTime  = now;
+        if (met) {
+            MS_DBG(F("Trigger"), i, F("met by"), trig.variable->getVarCode(),
+                   F("at"), value);
+            triggered = true;
+        }
+    }
+
+    if (triggered) {
+        if (!_eventActive) {
+            PRINTOUT(F("Event started; logging every"), _eventIntervalSeconds,
+                     F("seconds"));
+        }
+        _eventActive  = true;
+        _eventEndTime = Logger::markedLocalEpochTime + _eventHoldOffSeconds;
+    } else if (_eventActive &&
+               static_cast<int32_t>(Logger::markedLocalEpochTime -
+                                    _eventEndTime) >= 0) {
+        PRINTOUT(F("Event ended; logging every"), _loggingIntervalSeconds,
+                 F("seconds"));
+        _eventActive = false;
+    }
+}
+
+
 // ============================================================================
 //  Public Functions for sleeping the logger
 // ============================================================================
@@ -691,6 +2736,7 @@ bool Logger::checkMarkedInterval(void) {
 // This must be a static function (which means it can only call other static
 // funcions.)
 void Logger::wakeISR(void) {
+    _alarmFired = true;
     MS_DEEP_DBG(F("\nClock interrupt!"));
 }
 
@@ -704,22 +2750,74 @@ void Logger::systemSleep(void) {
         return;
     }
 
+    // Save any records waiting in the SD card cache
+    if (_sdKeepOpen && _sdSyncBeforeSleep && _sdRecordsSinceSync > 0) {
+        syncLogFile(false);
+    }
+
+    // If the next interval is too close to be sure of catching it with the
+    // alarm, wait for it awake instead
+    uint32_t nextInterval = getNextIntervalRTCEpoch();
+    uint32_t preWarmLead  = getPreWarmLead();
+    // Wake for an added array instead if it's due before the main one, or
+    // before the main one needs warming up
+    uint32_t nextArrays = getNextArraysRTCEpoch();
+    if (nextArrays != 0 &&
+        static_cast<int32_t>(nextInterval - preWarmLead - nextArrays) > 0) {
+        nextInterval = nextArrays;
+        preWarmLead  = 0;
+    }
+#if defined(MS_SAMD_DS3231) || not defined(ARDUINO_ARCH_SAMD)
+    uint32_t nextWake = nextInterval;
+#else
+    // The SAMD alarm is set one second early, at 59 seconds for a whole
+    // minute, because there seems to be a bit of a wake-up delay
+    uint32_t nextWake = nextInterval - 1;
+#endif
+    // Wake early enough to have the sensors stable at the interval
+    if (preWarmLead > 0) {
+        nextWake = nextInterval - preWarmLead;
+        if (static_cast<int32_t>(nextWake - getCycleUTCEpoch()) <
+            MS_MIN_ALARM_LEAD) {
+            MS_DBG(F("Sensors need to start warming up now."));
+            return;
+        }
+    }
+    if (static_cast<int32_t>(nextWake - getCycleUTCEpoch()) <
+        MS_MIN_ALARM_LEAD) {
+        MS_DBG(F("Next interval is too close to sleep; waiting for it."));
+        while (static_cast<int32_t>(nextInterval - getNowUTCEpoch()) > 0) {
+            delay(10);
+        }
+        // The second just turned over
+        setCycleClock(nextInterval, millis());
+        _cyclePhaseKnown = true;
+        return;
+    }
+
+    // millis() stops during sleep, so the sleep itself is timed by the RTC
+    _lastAwakeTime_ms   = millis() - _wakeMillis;
+    uint32_t sleepStart = getCycleUTCEpoch();
+
 #if defined(MS_SAMD_DS3231) || not defined(ARDUINO_ARCH_SAMD)
 
-    // Unfortunately, because of the way the alarm on the DS3231 is set up, it
-    // cannot interrupt on any frequencies other than every second, minute,
-    // hour, day, or date.  We could set it to alarm hourly every 5 minutes past
-    // the hour, but not every 5 minutes.  This is why we set the alarm for
-    // every minute and use the checkInterval function.  This is a hardware
-    // limitation of the DS3231; it is not due to the libraries or software.
-    MS_DBG(F("Setting alarm on DS3231 RTC for every minute."));
-    rtc.enableInterrupts(EveryMinute);
+    // The DS3231 alarm 1 can match on the hour, minute, and second, which is
+    // enough to wake exactly at the next interval of any logging rate up to a
+    // day.  It's re-armed for the following interval on every sleep.  The
+    // checkInterval function still decides whether it's time to log, so a
+    // wake from the testing button just leads back to sleep.
+    DateTime wakeDT = dtFromEpoch(nextWake);
+    MS_DBG(F("Setting alarm on DS3231 RTC for"), wakeDT.hour(), ':',
+           wakeDT.minute(), ':', wakeDT.second());
+    rtc.enableInterrupts(wakeDT.hour(), wakeDT.minute(), wakeDT.second());
 
     // Clear the last interrupt flag in the RTC status register
     // The next timed interrupt will not be sent until this is cleared
     rtc.clearINTStatus();
 
     // Set up a pin to hear clock interrupt and attach the wake ISR to it
+    _alarmFired    = false;
+    _wakeRequested = false;
     pinMode(_mcuWakePin, INPUT_PULLUP);
     enableInterrupt(_mcuWakePin, wakeISR, CHANGE);
 
@@ -729,15 +2827,14 @@ void Logger::systemSleep(void) {
     NVIC_EnableIRQ(RTC_IRQn);       // enable RTC interrupt
     NVIC_SetPriority(RTC_IRQn, 0);  // highest priority
 
-    // Alarms on the RTC built into the SAMD21 appear to be identical to those
-    // in the DS3231.  See more notes below.
-    // We're setting the alarm seconds to 59 and then seting it to go off
-    // whenever the seconds match the 59.  I'm using 59 instead of 00
-    // because there seems to be a bit of a wake-up delay
-    MS_DBG(F("Setting alarm on SAMD built-in RTC for every minute."));
+    // The RTC built into the SAMD can match a full date and time, so we set
+    // the alarm for the next interval.
+    MS_DBG(F("Setting alarm on SAMD built-in RTC for timestamp"), nextWake);
+    _alarmFired    = false;
+    _wakeRequested = false;
     zero_sleep_rtc.attachInterrupt(wakeISR);
-    zero_sleep_rtc.setAlarmSeconds(59);
-    zero_sleep_rtc.enableAlarm(zero_sleep_rtc.MATCH_SS);
+    zero_sleep_rtc.setAlarmEpoch(nextWake);
+    zero_sleep_rtc.enableAlarm(zero_sleep_rtc.MATCH_YYMMDDHHMMSS);
 
 #endif
 
@@ -747,6 +2844,9 @@ void Logger::systemSleep(void) {
 // Wait until the serial ports have finished transmitting
 // This does not clear their buffers, it just waits until they are finished
 // TODO(SRGDamia1):  Make sure can find all serial ports
+#if defined(MS_CONSOLE_BUFFER_SIZE) && defined(STANDARD_SERIAL_OUTPUT)
+    msConsole.finish();
+#endif
 #if defined(STANDARD_SERIAL_OUTPUT)
     STANDARD_SERIAL_OUTPUT.flush();  // for debugging
 #endif
@@ -770,6 +2870,9 @@ void Logger::systemSleep(void) {
     digitalWrite(SCL, LOW);
 #endif
 
+    // Gate what the sleep profile shuts down
+    if (_sleepProfile == sleepLowLeak) sleepPeripheralsOff();
+
 #if defined ARDUINO_ARCH_SAMD
 
     // Disable the watch-dog timer
@@ -791,10 +2894,18 @@ void Logger::systemSleep(void) {
     // Disable systick interrupt:  See
     // https://www.avrfreaks.net/forum/samd21-samd21e16b-sporadically-locks-and-does-not-wake-standby-sleep-mode
     SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
-    // Now go to sleep
+    // Now go to sleep, and straight back to sleep after any interrupt that
+    // doesn't need the logger awake.  An interrupt still wakes the processor
+    // from WFI while they're masked; it runs once they're unmasked.
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
-    __DSB();
-    __WFI();
+    __disable_irq();
+    while (!isWakeDue()) {
+        __DSB();
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    __enable_irq();
 
 #elif defined ARDUINO_ARCH_AVR
 
@@ -819,13 +2930,6 @@ void Logger::systemSleep(void) {
     // ADEN = ADC Enable
     ADCSRA &= ~_BV(ADEN);
 
-// turn off the brown-out detector, if possible
-// BODS = brown-out detector sleep
-// BODSE = brown-out detector sleep enable
-#if defined(BODS) && defined(BODSE)
-    sleep_bod_disable();
-#endif
-
     // disable all power-reduction modules (ie, the processor module clocks)
     // NOTE:  This only shuts down the various clocks on the processor via
     // the power reduction register!  It does NOT actually disable the
@@ -837,13 +2941,27 @@ void Logger::systemSleep(void) {
     // Set the sleep enable bit.
     sleep_enable();
 
-    // Re-enables interrupts so we can wake up again
+    // Go back to sleep after any interrupt that doesn't need the logger
+    // awake.  The flags are checked with interrupts off, and the instruction
+    // after re-enabling interrupts always runs before any interrupt, so an
+    // interrupt can't slip in between the check and the sleep.
+    while (!isWakeDue()) {
+// turn off the brown-out detector, if possible; this only lasts for the one
+// sleep
+// BODS = brown-out detector sleep
+// BODSE = brown-out detector sleep enable
+#if defined(BODS) && defined(BODSE)
+        sleep_bod_disable();
+#endif
+        // Re-enables interrupts so we can wake up again
+        interrupts();
+        // Actually put the processor into sleep mode.
+        // This must happen after the SE bit is set.
+        sleep_cpu();
+        noInterrupts();
+    }
     interrupts();
 
-    // Actually put the processor into sleep mode.
-    // This must happen after the SE bit is set.
-    sleep_cpu();
-
 #endif
     // ---------------------------------------------------------------------
 
@@ -851,6 +2969,10 @@ void Logger::systemSleep(void) {
     // ---------------------------------------------------------------------
     // -- The portion below this happens on wake up, after any wake ISR's --
 
+    // The RTC alarm wakes the processor right as its second starts
+    uint32_t wokeMillis = millis();
+    markPhase(PHASE_WAKE);
+
 #if defined ARDUINO_ARCH_SAMD
     // Reattach the USB after waking
     // Enable systick interrupt
@@ -888,6 +3010,8 @@ void Logger::systemSleep(void) {
 
 #endif
 
+    if (_sleepProfile == sleepLowLeak) sleepPeripheralsOn();
+
     // Re-enable the watch-dog timer
     watchDogTimer.enableWatchDog();
 
@@ -908,6 +3032,25 @@ void Logger::systemSleep(void) {
     // the timeout period is a useless delay.
     Wire.setTimeout(0);
 
+    // The alarm only fires at the time it was set for, so the cycle clock
+    // starts from it without reading the RTC; the RTC is read to check it
+    // when the time is marked for a record.  Otherwise, read the RTC once
+    // for this wake.
+    if (_alarmFired) {
+        setCycleClock(nextWake, wokeMillis);
+        _cycleFromAlarm  = true;
+        _cyclePhaseKnown = true;
+        _lastSleepTime_s = nextWake - sleepStart;
+    } else {
+        uint32_t wokeTime = getNowUTCEpoch();
+        setCycleClock(wokeTime, millis());
+        _lastSleepTime_s = wokeTime - sleepStart;
+    }
+    _wakeRequested = false;
+    _wakeMillis      = millis();
+    // millis() may have stopped while asleep, so no result is fresh now
+    Sensor::expireAllResults();
+
 #if defined(MS_SAMD_DS3231) || not defined(ARDUINO_ARCH_SAMD)
     // Stop the clock from sending out any interrupts while we're awake.
     // There's no reason to waste thought on the clock interrupt if it
@@ -928,19 +3071,168 @@ void Logger::systemSleep(void) {
 }
 
 
+// Sets how much of the processor is shut down while it sleeps
+void Logger::setSleepProfile(sleepProfile profile, const int8_t* parkPins,
+                             uint8_t parkPinCount) {
+    _sleepProfile = profile;
+    _parkPins     = parkPins;
+    _parkPinCount = parkPins == nullptr ? 0 : parkPinCount;
+    if (_parkPinCount > MS_MAX_SLEEP_PINS) _parkPinCount = MS_MAX_SLEEP_PINS;
+}
+
+
+// Everything changed here is saved first, so sleepPeripheralsOn() can put it
+// back exactly
+void Logger::sleepPeripheralsOff(void) {
+#if defined ARDUINO_ARCH_SAMD
+    // The ADC and DAC have to be disabled while their bus clocks still run
+#if defined(__SAMD51__)
+    _adcWasEnabled         = ADC0->CTRLA.bit.ENABLE;
+    ADC0->CTRLA.bit.ENABLE = 0;
+    while (ADC0->SYNCBUSY.bit.ENABLE) {
+        // Wait for synchronization
+    }
+    _dacWasEnabled        = DAC->CTRLA.bit.ENABLE;
+    DAC->CTRLA.bit.ENABLE = 0;
+    while (DAC->SYNCBUSY.bit.ENABLE) {
+        // Wait for synchronization
+    }
+    // The SERCOMs 4-7, ADCs, DAC and the last timers; the RTC, EIC and WDT
+    // are on bus A
+    _savedPeripherals  = MCLK->APBDMASK.reg;
+    MCLK->APBDMASK.reg = 0;
+#else
+    _adcWasEnabled        = ADC->CTRLA.bit.ENABLE;
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY) {
+        // Wait for synchronization
+    }
+    _dacWasEnabled        = DAC->CTRLA.bit.ENABLE;
+    DAC->CTRLA.bit.ENABLE = 0;
+    while (DAC->STATUS.bit.SYNCBUSY) {
+        // Wait for synchronization
+    }
+    // All of the SERCOMs, timers and analog peripherals; the RTC, EIC and
+    // WDT are on bus A
+    _savedPeripherals = PM->APBCMASK.reg;
+    PM->APBCMASK.reg  = 0;
+#endif
+#elif defined ARDUINO_ARCH_AVR
+    // The analog comparator keeps running when the ADC is powered down
+    _savedPeripherals = ACSR;
+    ACSR |= _BV(ACD);
+#endif
+
+    for (uint8_t i = 0; i < _parkPinCount; i++) {
+        int8_t pin = _parkPins[i];
+        if (pin < 0 || pin == _mcuWakePin || pin == _buttonPin) continue;
+        parkedPin& parked = _parkedPins[i];
+#if defined ARDUINO_ARCH_SAMD
+        const PinDescription& desc  = g_APinDescription[pin];
+        PortGroup&            group = PORT->Group[desc.ulPort];
+        uint32_t              mask  = 1ul << desc.ulPin;
+        parked.config               = group.PINCFG[desc.ulPin].reg;
+        parked.output               = group.DIR.reg & mask;
+        parked.high                 = group.OUT.reg & mask;
+        // An input with the input buffer, pull and multiplexer all off
+        group.DIRCLR.reg             = mask;
+        group.PINCFG[desc.ulPin].reg = 0;
+#elif defined ARDUINO_ARCH_AVR
+        uint8_t           mask = digitalPinToBitMask(pin);
+        uint8_t           port = digitalPinToPort(pin);
+        volatile uint8_t* mode = portModeRegister(port);
+        volatile uint8_t* out  = portOutputRegister(port);
+        parked.output          = *mode & mask;
+        parked.high            = *out & mask;
+        // An input without the pull-up; the input buffer is off while asleep
+        *mode &= ~mask;
+        *out &= ~mask;
+#endif
+    }
+}
+
+
+void Logger::sleepPeripheralsOn(void) {
+    for (uint8_t i = 0; i < _parkPinCount; i++) {
+        int8_t pin = _parkPins[i];
+        if (pin < 0 || pin == _mcuWakePin || pin == _buttonPin) continue;
+        const parkedPin& parked = _parkedPins[i];
+#if defined ARDUINO_ARCH_SAMD
+        const PinDescription& desc  = g_APinDescription[pin];
+        PortGroup&            group = PORT->Group[desc.ulPort];
+        uint32_t              mask  = 1ul << desc.ulPin;
+        if (parked.high) {
+            group.OUTSET.reg = mask;
+        } else {
+            group.OUTCLR.reg = mask;
+        }
+        group.PINCFG[desc.ulPin].reg = parked.config;
+        if (parked.output) group.DIRSET.reg = mask;
+#elif defined ARDUINO_ARCH_AVR
+        uint8_t           mask = digitalPinToBitMask(pin);
+        uint8_t           port = digitalPinToPort(pin);
+        volatile uint8_t* mode = portModeRegister(port);
+        volatile uint8_t* out  = portOutputRegister(port);
+        if (parked.high) *out |= mask;
+        if (parked.output) *mode |= mask;
+#endif
+    }
+
+#if defined ARDUINO_ARCH_SAMD
+#if defined(__SAMD51__)
+    MCLK->APBDMASK.reg = _savedPeripherals;
+    if (_dacWasEnabled) {
+        DAC->CTRLA.bit.ENABLE = 1;
+        while (DAC->SYNCBUSY.bit.ENABLE) {
+            // Wait for synchronization
+        }
+    }
+    if (_adcWasEnabled) {
+        ADC0->CTRLA.bit.ENABLE = 1;
+        while (ADC0->SYNCBUSY.bit.ENABLE) {
+            // Wait for synchronization
+        }
+    }
+#else
+    PM->APBCMASK.reg = _savedPeripherals;
+    if (_dacWasEnabled) {
+        DAC->CTRLA.bit.ENABLE = 1;
+        while (DAC->STATUS.bit.SYNCBUSY) {
+            // Wait for synchronization
+        }
+    }
+    if (_adcWasEnabled) {
+        ADC->CTRLA.bit.ENABLE = 1;
+        while (ADC->STATUS.bit.SYNCBUSY) {
+            // Wait for synchronization
+        }
+    }
+#endif
+#elif defined ARDUINO_ARCH_AVR
+    ACSR = static_cast<uint8_t>(_savedPeripherals);
+#endif
+}
+
+
 // ===================================================================== //
 // Public functions for logging data to an SD card
 // ===================================================================== //
 
 // This sets a file name, if you want to decide on it in advance
-void Logger::setFileName(String& fileName) {
-    _fileName = fileName;
-}
-// Same as above, with a character array (overload function)
 void Logger::setFileName(const char* fileName) {
-    auto StrName = String(fileName);
-    setFileName(StrName);
+    // Close any file left open under the old name
+    if (strcmp(fileName, _fileName) == 0) return;
+    syncLogFile(true);
+    _fileRecordCount = 0;
+    strncpy(_fileName, fileName, sizeof(_fileName) - 1);
+    _fileName[sizeof(_fileName) - 1] = '\0';
+}
+#if !defined(MS_NO_STRING)
+// Same as above, with a String (overload function)
+void Logger::setFileName(String& fileName) {
+    setFileName(fileName.c_str());
 }
+#endif
 
 
 // This generates a file name from the logger id and the current date
@@ -948,30 +3240,33 @@ void Logger::setFileName(const char* fileName) {
 // the begin() function is called.
 void Logger::generateAutoFileName(void) {
     // Generate the file name from logger ID and date
-    auto fileName = String(_loggerID);
-    fileName += "_";
-    fileName += formatDateTime_ISO8601(getNowLocalEpoch()).substring(0, 10);
-    fileName += ".csv";
+    char dateTime[MS_ISO8601_BUFFER_SIZE];
+    formatDateTime_ISO8601(getCycleLocalEpoch(), dateTime, sizeof(dateTime));
+    char fileName[MS_FILE_NAME_SIZE];
+    snprintf(fileName, sizeof(fileName), "%s_%.10s%s", _loggerID, dateTime,
+             _binaryLogging ? ".bin" : ".csv");
     setFileName(fileName);
-    _fileName = fileName;
 }
 
 
 /**
  * @brief This is a PRE-PROCESSOR MACRO to speed up generating header rows
  *
- * THIS IS NOT A FUNCTION, it is a pre-processor macro
+ * THIS IS NOT A FUNCTION, it is a pre-processor macro.  The printColumn
+ * expression prints the text for the variable at i to the stream, straight
+ * from the variable's flash or RAM, so no String is made for any cell; nVars
+ * must hold the number of variables.
  */
-#define STREAM_CSV_ROW(firstCol, function)                       \
-    stream->print("\"");                                         \
-    stream->print(firstCol);                                     \
-    stream->print("\",");                                        \
-    for (uint8_t i = 0; i < getArrayVarCount(); i++) {           \
-        stream->print("\"");                                     \
-        stream->print(function);                                 \
-        stream->print("\"");                                     \
-        if (i + 1 != getArrayVarCount()) { stream->print(","); } \
-    }                                                            \
+#define STREAM_CSV_ROW(firstCol, printColumn)       \
+    stream->print('"');                             \
+    stream->print(firstCol);                        \
+    stream->print(F("\","));                        \
+    for (uint8_t i = 0; i < nVars; i++) {           \
+        stream->print('"');                         \
+        printColumn;                                \
+        stream->print('"');                         \
+        if (i + 1 != nVars) { stream->print(','); } \
+    }                                               \
     stream->println();
 
 // This sends a file header out over an Arduino stream
@@ -991,42 +3286,368 @@ void Logger::printFileHeader(Stream* stream) {
         stream->println(',');
     }
 
+    // The variables' text is printed straight from where it's kept
+    Variable** vars  = _internalArray->arrayOfVars;
+    uint8_t    nVars = getArrayVarCount();
     // Next line will be the parent sensor names
-    STREAM_CSV_ROW(F("Sensor Name:"), getParentSensorNameAtI(i))
+    STREAM_CSV_ROW(F("Sensor Name:"), vars[i]->printParentSensorName(*stream))
     // Next comes the ODM2 variable name
-    STREAM_CSV_ROW(F("Variable Name:"), getVarNameAtI(i))
+    STREAM_CSV_ROW(F("Variable Name:"), vars[i]->printVarName(*stream))
     // Next comes the ODM2 unit name
-    STREAM_CSV_ROW(F("Result Unit:"), getVarUnitAtI(i))
+    STREAM_CSV_ROW(F("Result Unit:"), vars[i]->printVarUnit(*stream))
     // Next comes the variable UUIDs
     // We'll only add UUID's if we see a UUID for the first variable
-    if (getVarUUIDAtI(0).length() > 1) {
-        STREAM_CSV_ROW(F("Result UUID:"), getVarUUIDAtI(i))
+    char uuid[37];
+    if (formatVarUUIDAtI(0, uuid, sizeof(uuid)) > 1) {
+        STREAM_CSV_ROW(F("Result UUID:"), vars[i]->printVarUUID(*stream))
     }
 
     // We'll finish up the the custom variable codes
-    String dtRowHeader = F("Date and Time in UTC");
-    if (_loggerTimeZone > 0) {
-        dtRowHeader += '+' + _loggerTimeZone;
-    } else if (_loggerTimeZone < 0) {
-        dtRowHeader += _loggerTimeZone;
+    char dtRowHeader[28] = "Date and Time in UTC";
+    if (_loggerTimeZone != 0) {
+        snprintf(dtRowHeader + 20, sizeof(dtRowHeader) - 20, "%+d",
+                 _loggerTimeZone);
     }
-    STREAM_CSV_ROW(dtRowHeader, getVarCodeAtI(i))
+    STREAM_CSV_ROW(dtRowHeader, vars[i]->printVarCode(*stream))
 }
 
 
 // This prints a comma separated list of volues of sensor data - including the
 // time -  out over an Arduino stream
 void Logger::printSensorDataCSV(Stream* stream) {
-    String csvString = "";
-    dtFromEpoch(Logger::markedLocalEpochTime).addToString(csvString);
-    csvString += ',';
-    stream->print(csvString);
+    DateTime dt = dtFromEpoch(Logger::markedLocalEpochTime);
+    char     dateTime[21];
+    snprintf(dateTime, sizeof(dateTime), "%04u-%02u-%02u %02u:%02u:%02u,",
+             dt.year(), dt.month(), dt.date(), dt.hour(), dt.minute(),
+             dt.second());
+    stream->print(dateTime);
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
     for (uint8_t i = 0; i < getArrayVarCount(); i++) {
-        stream->print(getValueStringAtI(i));
+        formatLoggedValueAtI(i, valueBuffer, sizeof(valueBuffer));
+        stream->print(valueBuffer);
         if (i + 1 != getArrayVarCount()) { stream->print(','); }
     }
     stream->println();
 }
+// This writes the same CSV line into a buffer, without using any Strings
+size_t Logger::formatSensorDataCSV(char* buffer, size_t bufferLen) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    DateTime dt  = dtFromEpoch(Logger::markedLocalEpochTime);
+    int      len = snprintf(buffer, bufferLen, "%04u-%02u-%02u %02u:%02u:%02u,",
+                            dt.year(), dt.month(), dt.date(), dt.hour(),
+                            dt.minute(), dt.second());
+    if (len < 0 || (size_t)len >= bufferLen) return 0;
+    size_t written = len;
+    for (uint8_t i = 0; i < getArrayVarCount(); i++) {
+        // Leave room for the separator or line ending and the null
+        if (bufferLen - written < 4) return 0;
+        written += formatLoggedValueAtI(i, buffer + written,
+                                        bufferLen - written - 2);
+        if (i + 1 != getArrayVarCount()) { buffer[written++] = ','; }
+    }
+    if (bufferLen - written < 3) return 0;
+    buffer[written++] = '\r';
+    buffer[written++] = '\n';
+    buffer[written]   = '\0';
+    return written;
+}
+
+
+// This sets whether to write binary records
+void Logger::setBinaryLogging(bool enableBinary) {
+    // Start a new file if the format changes, so formats aren't mixed
+    if (enableBinary != _binaryLogging && _fileName[0] != '\0') {
+        syncLogFile(true);
+        _fileName[0] = '\0';
+    }
+    _binaryLogging = enableBinary;
+}
+// This sets whether binary records are compressed
+void Logger::setBinaryCompression(bool enableCompression) {
+    if (enableCompression != _binaryCompression && _binaryLogging &&
+        _fileName[0] != '\0') {
+        syncLogFile(true);
+        _fileName[0] = '\0';
+    }
+    _binaryCompression = enableCompression;
+}
+// This sets whether binary records carry the measurement offsets
+void Logger::setMeasurementOffsets(bool enableOffsets) {
+    if (enableOffsets != _measurementOffsets && _binaryLogging &&
+        _fileName[0] != '\0') {
+        syncLogFile(true);
+        _fileName[0] = '\0';
+    }
+    _measurementOffsets = enableOffsets;
+}
+// The size of a binary record: epoch time, one float per variable, maybe one
+// offset per variable, and a CRC
+uint16_t Logger::getBinaryRecordSize(void) {
+    uint8_t perVar = sizeof(float) +
+        (_measurementOffsets ? sizeof(int32_t) : 0);
+    return sizeof(uint32_t) + perVar * getArrayVarCount() + sizeof(uint16_t);
+}
+// This writes a binary record of the current values into a buffer
+size_t Logger::formatSensorDataBinary(uint8_t* buffer, size_t bufferLen) {
+    uint16_t recSize = getBinaryRecordSize();
+    if (buffer == nullptr || bufferLen < recSize) return 0;
+    // Both AVR and SAMD are little-endian, so the values are copied as-is
+    memcpy(buffer, &Logger::markedLocalEpochTime, sizeof(uint32_t));
+    size_t written = sizeof(uint32_t);
+    for (uint8_t i = 0; i < getArrayVarCount(); i++) {
+        float value = _internalArray->arrayOfVars[i]->getValue();
+        if (_stalePolicy != STALE_KEEP && isValueStaleAtI(i)) value = -9999;
+        memcpy(buffer + written, &value, sizeof(float));
+        written += sizeof(float);
+    }
+    for (uint8_t i = 0; _measurementOffsets && i < getArrayVarCount(); i++) {
+        int32_t offset = getMeasurementOffsetAtI(i);
+        memcpy(buffer + written, &offset, sizeof(int32_t));
+        written += sizeof(int32_t);
+    }
+    uint16_t crc = crc16(buffer, written);
+    memcpy(buffer + written, &crc, sizeof(uint16_t));
+    return written + sizeof(uint16_t);
+}
+// This writes the binary header block to a file
+void Logger::printBinaryFileHeader(File& file) {
+    // Header layout: "MSLB", format version, number of variables, record size,
+    // length of the header text, one decimal resolution per variable, and
+    // finally the text of the CSV header.
+    uint32_t start   = file.curPosition();
+    uint8_t  nVars   = getArrayVarCount();
+    uint16_t recSize = getBinaryRecordSize();
+    uint16_t textLen = 0;
+    file.write(reinterpret_cast<const uint8_t*>("MSLB"), 4);
+    file.write(static_cast<uint8_t>(_binaryCompression ? 2 : 1));
+    file.write(nVars);
+    file.write(reinterpret_cast<uint8_t*>(&recSize), sizeof(recSize));
+    file.write(reinterpret_cast<uint8_t*>(&textLen), sizeof(textLen));
+    for (uint8_t i = 0; i < nVars; i++) {
+        file.write(_internalArray->arrayOfVars[i]->getResolution());
+    }
+    uint32_t textStart = file.curPosition();
+    printFileHeader(&file);
+    // Go back and fill in the length of the header text
+    textLen = file.curPosition() - textStart;
+    file.seekSet(start + 8);
+    file.write(reinterpret_cast<uint8_t*>(&textLen), sizeof(textLen));
+    file.seekEnd();
+}
+// The length and count before a compressed block, and the CRC and length
+// after it
+#define MS_BLOCK_FRAMING_SIZE 8
+
+// A binary file's header gives where its records start and their size; a CSV
+// file is read back in chunks until a line ending
+void Logger::repairLogTail(const char* filename) {
+    File file;
+    if (!file.open(filename, O_RDWR)) return;
+    uint32_t size = file.fileSize();
+    uint32_t keep = size;
+    uint8_t  header[10];
+    if (size >= 10 && file.read(header, 10) == 10 &&
+        memcmp(header, "MSLB", 4) == 0) {
+        uint16_t recSize;
+        uint16_t textLen;
+        memcpy(&recSize, header + 6, sizeof(recSize));
+        memcpy(&textLen, header + 8, sizeof(textLen));
+        uint32_t dataStart = 10 + header[5] + textLen;
+        uint32_t blockSize = 0;
+        if (header[4] == 2 && size >= dataStart) {
+            // Check the last block, found from the length after it, and only
+            // walk the blocks from the start if it's torn
+            uint16_t lastLen = 0;
+            file.seekSet(size - sizeof(lastLen));
+            file.read(&lastLen, sizeof(lastLen));
+            uint32_t lastStart = size - MS_BLOCK_FRAMING_SIZE - lastLen;
+            if (size < dataStart + MS_BLOCK_FRAMING_SIZE + lastLen ||
+                !checkBinaryBlock(file, lastStart, &blockSize)) {
+                keep = dataStart;
+                while (checkBinaryBlock(file, keep, &blockSize)) {
+                    keep += blockSize;
+                }
+            }
+        } else if (recSize > 0 && size >= dataStart) {
+            keep = size - (size - dataStart) % recSize;
+            // Only this logger's own records can have their CRC checked
+            if (keep >= dataStart + recSize &&
+                recSize == getBinaryRecordSize()) {
+                uint8_t rec[recSize];
+                file.seekSet(keep - recSize);
+                if (file.read(rec, recSize) != recSize ||
+                    !checkBinaryRecord(rec)) {
+                    keep -= recSize;
+                }
+            }
+        }
+    } else if (size > 0) {
+        uint8_t  chunk[32];
+        uint32_t end = size;
+        keep         = 0;
+        while (keep == 0 && end > 0 && size - end < MS_TAIL_SCAN_BYTES) {
+            uint32_t start = end > sizeof(chunk) ? end - sizeof(chunk) : 0;
+            int      len   = end - start;
+            file.seekSet(start);
+            if (file.read(chunk, len) != len) break;
+            for (int i = len; i > 0; i--) {
+                if (chunk[i - 1] == '\n') {
+                    keep = start + i;
+                    break;
+                }
+            }
+            end = start;
+        }
+        // Leave the file alone if no line ending was found
+        if (keep == 0) keep = size;
+    }
+    if (keep < size) {
+        PRINTOUT(F("Removing"), size - keep,
+                 F("bytes of a torn record from the end of"), filename);
+        file.truncate(keep);
+        setFileTimestamp(file, T_WRITE);
+    }
+    file.close();
+}
+// Zig-zag puts small changes either way into the fewest varint bytes
+static uint8_t putZigZagVarint(uint8_t* buffer, int64_t value) {
+    uint64_t zz = (static_cast<uint64_t>(value) << 1) ^
+        static_cast<uint64_t>(value >> 63);
+    uint8_t len = 0;
+    while (zz >= 0x80) {
+        buffer[len++] = static_cast<uint8_t>(zz) | 0x80;
+        zz >>= 7;
+    }
+    buffer[len++] = static_cast<uint8_t>(zz);
+    return len;
+}
+// Scale a value to a whole number at its decimal resolution; a value that
+// isn't a number is stored as the usual -9999
+static int64_t scaleBinaryValue(float value, uint8_t resolution) {
+    if (isnan(value)) value = -9999;
+    float scaled = value;
+    for (uint8_t i = 0; i < resolution; i++) scaled *= 10;
+    if (scaled > 4.0e18f) return 4000000000000000000LL;
+    if (scaled < -4.0e18f) return -4000000000000000000LL;
+    return static_cast<int64_t>(scaled >= 0 ? scaled + 0.5f : scaled - 0.5f);
+}
+// Each record is compared with the one before it, so nothing needs to be
+// kept between the two passes over the records
+uint32_t Logger::encodeBlockPayload(const uint8_t* records, uint16_t count,
+                                    Print* out, uint16_t* crc) {
+    uint8_t  nVars   = getArrayVarCount();
+    uint16_t recSize = getBinaryRecordSize();
+    uint16_t nFields = _measurementOffsets ? 2 * nVars : nVars;
+    uint32_t len     = 0;
+    uint8_t  varint[10];
+    for (uint16_t r = 0; r < count; r++) {
+        const uint8_t* rec  = records + r * recSize;
+        const uint8_t* prev = r > 0 ? rec - recSize : nullptr;
+        for (uint16_t i = 0; i <= nFields; i++) {
+            int64_t value     = 0;
+            int64_t lastValue = 0;
+            if (i > nVars) {
+                // The measurement offsets are already whole numbers
+                size_t offset = sizeof(uint32_t) + nVars * sizeof(float) +
+                    (i - nVars - 1) * sizeof(int32_t);
+                int32_t ms;
+                memcpy(&ms, rec + offset, sizeof(ms));
+                value = ms;
+                if (prev != nullptr) {
+                    memcpy(&ms, prev + offset, sizeof(ms));
+                    lastValue = ms;
+                }
+            } else if (i == 0) {
+                uint32_t epoch;
+                memcpy(&epoch, rec, sizeof(epoch));
+                value = epoch;
+                if (prev != nullptr) {
+                    memcpy(&epoch, prev, sizeof(epoch));
+                    lastValue = epoch;
+                }
+            } else {
+                uint8_t res =
+                    _internalArray->arrayOfVars[i - 1]->getResolution();
+                size_t offset = sizeof(uint32_t) + (i - 1) * sizeof(float);
+                float  f;
+                memcpy(&f, rec + offset, sizeof(f));
+                value = scaleBinaryValue(f, res);
+                if (prev != nullptr) {
+                    memcpy(&f, prev + offset, sizeof(f));
+                    lastValue = scaleBinaryValue(f, res);
+                }
+            }
+            uint8_t n = putZigZagVarint(varint, value - lastValue);
+            if (out != nullptr) out->write(varint, n);
+            if (crc != nullptr) *crc = crc16(varint, n, *crc);
+            len += n;
+        }
+    }
+    return len;
+}
+// The payload is measured first so its length can go before it
+size_t Logger::printBinaryBlock(Print* out, const uint8_t* records,
+                                uint16_t count) {
+    uint32_t payloadLen = encodeBlockPayload(records, count, nullptr, nullptr);
+    if (payloadLen > 0xFFFF) return 0;
+    uint16_t len = payloadLen;
+    uint16_t crc = crc16(reinterpret_cast<const uint8_t*>(&count),
+                         sizeof(count));
+    out->write(reinterpret_cast<const uint8_t*>(&len), sizeof(len));
+    out->write(reinterpret_cast<const uint8_t*>(&count), sizeof(count));
+    encodeBlockPayload(records, count, out, &crc);
+    out->write(reinterpret_cast<const uint8_t*>(&crc), sizeof(crc));
+    out->write(reinterpret_cast<const uint8_t*>(&len), sizeof(len));
+    MS_DBG(count, F("records compressed from"), count * getBinaryRecordSize(),
+           F("to"), len + MS_BLOCK_FRAMING_SIZE, F("bytes"));
+    return len + MS_BLOCK_FRAMING_SIZE;
+}
+// This checks the framing and the CRC of a compressed block
+bool Logger::checkBinaryBlock(File& file, uint32_t start,
+                              uint32_t* blockSize) {
+    uint8_t  framing[4];
+    uint16_t len;
+    uint16_t crc = 0xFFFF;
+    if (start + MS_BLOCK_FRAMING_SIZE > file.fileSize()) return false;
+    file.seekSet(start);
+    if (file.read(framing, 4) != 4) return false;
+    memcpy(&len, framing, sizeof(len));
+    if (start + MS_BLOCK_FRAMING_SIZE + len > file.fileSize()) return false;
+    crc = crc16(framing + 2, 2, crc);
+    uint8_t  chunk[32];
+    uint16_t left = len;
+    while (left > 0) {
+        int n = left < sizeof(chunk) ? left : sizeof(chunk);
+        if (file.read(chunk, n) != n) return false;
+        crc = crc16(chunk, n, crc);
+        left -= n;
+    }
+    if (file.read(framing, 4) != 4) return false;
+    if (memcmp(framing, &crc, sizeof(crc)) != 0 ||
+        memcmp(framing + 2, &len, sizeof(len)) != 0) {
+        return false;
+    }
+    *blockSize = MS_BLOCK_FRAMING_SIZE + len;
+    return true;
+}
+// This calculates a CRC-16 (CCITT, polynomial 0x1021)
+uint16_t Logger::crc16(const uint8_t* data, size_t len, uint16_t crc) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+// This writes the current record in the SD file format
+size_t Logger::formatLogRecord(char* buffer, size_t bufferLen) {
+    if (_binaryLogging) {
+        return formatSensorDataBinary(reinterpret_cast<uint8_t*>(buffer),
+                                      bufferLen);
+    }
+    return formatSensorDataCSV(buffer, bufferLen);
+}
 
 // Protected helper function - This checks if the SD card is available and ready
 bool Logger::initializeSDCard(void) {
@@ -1036,8 +3657,13 @@ bool Logger::initializeSDCard(void) {
         PRINTOUT(F("Data will not be saved!"));
         return false;
     }
+    // Power up the card, if it isn't already on
+    turnOnSDcard(true);
     // Initialise the SD card
-    if (!sd.begin(_SDCardSSPin, SPI_FULL_SPEED)) {
+    uint32_t start_ms = millis();
+    bool     started  = sd.begin(_SDCardSSPin, SPI_FULL_SPEED);
+    recordSDLatency(SD_OP_INIT, start_ms, started);
+    if (!started) {
         PRINTOUT(F("Error: SD card failed to initialize or is missing."));
         PRINTOUT(F("Data will not be saved!"));
         return false;
@@ -1052,63 +3678,104 @@ bool Logger::initializeSDCard(void) {
 
 
 // Protected helper function - This sets a timestamp on a file
-void Logger::setFileTimestamp(File fileToStamp, uint8_t stampFlag) {
-    fileToStamp.timestamp(stampFlag, dtFromEpoch(getNowLocalEpoch()).year(),
-                          dtFromEpoch(getNowLocalEpoch()).month(),
-                          dtFromEpoch(getNowLocalEpoch()).date(),
-                          dtFromEpoch(getNowLocalEpoch()).hour(),
-                          dtFromEpoch(getNowLocalEpoch()).minute(),
-                          dtFromEpoch(getNowLocalEpoch()).second());
+void Logger::setFileTimestamp(File& fileToStamp, uint8_t stampFlag) {
+    // The clock can't be read inside the watchdog interrupt
+    if (_inLastGasp) return;
+    if (!_stampAccessTime) stampFlag &= ~T_ACCESS;
+    if (stampFlag == 0) return;
+    // While logging, use the marked time rather than reading the clock again
+    uint32_t stampTime = (Logger::isLoggingNow && markedLocalEpochTime != 0)
+        ? markedLocalEpochTime
+        : getCycleLocalEpoch();
+    DateTime dt = dtFromEpoch(stampTime);
+    fileToStamp.timestamp(stampFlag, dt.year(), dt.month(), dt.date(),
+                          dt.hour(), dt.minute(), dt.second());
+}
+
+
+// This sets which file timestamps are updated and when
+void Logger::setFileTimestampPolicy(bool updateAccessTime,
+                                    bool stampOnlyOnClose) {
+    _stampAccessTime  = updateAccessTime;
+    _stampOnlyOnClose = stampOnlyOnClose;
 }
 
 
-// Protected helper function - This opens or creates a file, converting a string
-// file name to a character file name
-bool Logger::openFile(String& filename, bool createFile,
+// Protected helper function - This opens or creates a file
+bool Logger::openFile(const char* filename, bool createFile,
                       bool writeDefaultHeader) {
+    sdBusyGuard sdGuard;
+    // Close a log file that was left open before re-using the file object
+    syncLogFile(true);
+
     // Initialise the SD card
     // skip everything else if there's no SD card, otherwise it might hang
     if (!initializeSDCard()) return false;
 
-    // Convert the string filename to a character file name for SdFat
-    unsigned int fileNameLength = filename.length() + 1;
-    char         charFileName[fileNameLength];
-    filename.toCharArray(charFileName, fileNameLength);
-
     // First attempt to open an already existing file (in write mode), so we
     // don't try to re-create something that's already there.
     // This should also prevent the header from being written over and over
     // in the file.
-    if (logFile.open(charFileName, O_WRITE | O_AT_END)) {
+    // Before the first append since the start, clear off anything a reset
+    // left half written
+    if (!_tailChecked) {
+        repairLogTail(filename);
+        _tailChecked = true;
+    }
+    uint32_t open_ms = millis();
+    if (logFile.open(filename, O_WRITE | O_AT_END)) {
         MS_DBG(F("Opened existing file:"), filename);
+        _fileBytes = logFile.fileSize();
         // Set access date time
         setFileTimestamp(logFile, T_ACCESS);
+        recordSDLatency(SD_OP_OPEN, open_ms, true);
         return true;
     } else if (createFile) {
         // Create and then open the file in write mode
-        if (logFile.open(charFileName, O_CREAT | O_WRITE | O_AT_END)) {
+        if (logFile.open(filename, O_CREAT | O_WRITE | O_AT_END)) {
             MS_DBG(F("Created new file:"), filename);
-            // Set creation date time
-            setFileTimestamp(logFile, T_CREATE);
+            _fileBytes = 0;
+            // Reserve a contiguous extent for the file, before anything is
+            // written to it
+            if (_preAllocateBytes > 0) {
+                if (logFile.preAllocate(_preAllocateBytes)) {
+                    MS_DBG(F("Pre-allocated"), _preAllocateBytes,
+                           F("bytes for the file"));
+                } else {
+                    MS_DBG(F("Unable to pre-allocate"), _preAllocateBytes,
+                           F("contiguous bytes for the file"));
+                }
+            }
+            // Note the new file in the index, if files are being rotated
+            if (writeDefaultHeader &&
+                (_fileRotation != rotateNever || _maxFileBytes > 0)) {
+                writeFileIndexEntry(Logger::markedLocalEpochTime, 0, 0);
+            }
             // Write out a header, if requested
             if (writeDefaultHeader) {
                 // Add header information
-                printFileHeader(&logFile);
+                if (_binaryLogging) {
+                    printBinaryFileHeader(logFile);
+                } else {
+                    printFileHeader(&logFile);
+                }
 // Print out the header for debugging
 #if defined(DEBUGGING_SERIAL_OUTPUT) && defined(MS_DEBUGGING_STD)
                 MS_DBG(F("\n \\/---- File Header ----\\/"));
                 printFileHeader(&DEBUGGING_SERIAL_OUTPUT);
                 MS_DBG('\n');
 #endif
-                // Set write/modification date time
-                setFileTimestamp(logFile, T_WRITE);
             }
-            // Set access date time
-            setFileTimestamp(logFile, T_ACCESS);
+            // Set the creation, write/modification (if there is a header), and
+            // access date times all at once
+            setFileTimestamp(logFile, T_CREATE | T_ACCESS |
+                                 (writeDefaultHeader ? T_WRITE : 0));
+            recordSDLatency(SD_OP_OPEN, open_ms, true);
             return true;
         } else {
             // Return false if we couldn't create the file
             MS_DBG(F("Unable to create new file:"), filename);
+            recordSDLatency(SD_OP_OPEN, open_ms, false);
             return false;
         }
     } else {
@@ -1123,11 +3790,11 @@ bool Logger::openFile(String& filename, bool createFile,
 // These functions create a file on the SD card with the given filename and
 // set the proper timestamps to the file.
 // The filename may either be the one set by
-// setFileName(String)/setFileName(void) or can be specified in the function. If
+// setFileName()/generateAutoFileName() or can be specified in the function. If
 // specified, it will also write a header to the file based on the sensors in
 // the group. This can be used to force a logger to create a file with a
 // secondary file name.
-bool Logger::createLogFile(String& filename, bool writeDefaultHeader) {
+bool Logger::createLogFile(const char* filename, bool writeDefaultHeader) {
     // Attempt to create and open a file
     if (openFile(filename, true, writeDefaultHeader)) {
         // Close the file to save it (only do this if we'd opened it)
@@ -1139,8 +3806,13 @@ bool Logger::createLogFile(String& filename, bool writeDefaultHeader) {
         return false;
     }
 }
+#if !defined(MS_NO_STRING)
+bool Logger::createLogFile(String& filename, bool writeDefaultHeader) {
+    return createLogFile(filename.c_str(), writeDefaultHeader);
+}
+#endif
 bool Logger::createLogFile(bool writeDefaultHeader) {
-    if (_fileName == "") generateAutoFileName();
+    if (_fileName[0] == '\0') generateAutoFileName();
     return createLogFile(_fileName, writeDefaultHeader);
 }
 
@@ -1148,10 +3820,12 @@ bool Logger::createLogFile(bool writeDefaultHeader) {
 // These functions write a file on the SD card with the given filename and
 // set the proper timestamps to the file.
 // The filename may either be the one set by
-// setFileName(String)/setFileName(void) or can be specified in the function. If
+// setFileName()/generateAutoFileName() or can be specified in the function. If
 // the file does not already exist, the file will be created. This can be used
 // to force a logger to write to a file with a secondary file name.
-bool Logger::logToSD(String& filename, String& rec) {
+bool Logger::logToSD(const char* filename, const char* rec) {
+    sdBusyGuard sdGuard;
+    uint32_t    save_ms = millis();
     // First attempt to open the file without creating a new one
     if (!openFile(filename, false, false)) {
         PRINTOUT(F("Could not write to existing file on SD card, attempting to "
@@ -1160,66 +3834,451 @@ bool Logger::logToSD(String& filename, String& rec) {
         // This will not attempt to generate a new file name or add a header!
         if (!openFile(filename, true, false)) {
             PRINTOUT(F("Unable to write to SD card!"));
+            recordSDLatency(SD_OP_SAVE, save_ms, false);
             return false;
         }
     }
 
     // If we could successfully open or create the file, write the data to it
+    uint32_t write_ms = millis();
+    uint32_t before   = logFile.fileSize();
     logFile.println(rec);
+    bool wrote = logFile.fileSize() > before;
+    recordSDLatency(SD_OP_WRITE, write_ms, wrote);
     // Echo the line to the serial port
     PRINTOUT(F("\n \\/---- Line Saved to SD Card ----\\/"));
     PRINTOUT(rec);
 
-    // Set write/modification date time
-    setFileTimestamp(logFile, T_WRITE);
-    // Set access date time
-    setFileTimestamp(logFile, T_ACCESS);
+    // Set the write/modification and access date times
+    setFileTimestamp(logFile, T_WRITE | T_ACCESS);
     // Close the file to save it
-    logFile.close();
+    uint32_t close_ms = millis();
+    bool     closed   = logFile.close();
+    recordSDLatency(SD_OP_CLOSE, close_ms, closed);
+    recordSDLatency(SD_OP_SAVE, save_ms, wrote && closed);
     return true;
 }
-bool Logger::logToSD(String& rec) {
+bool Logger::logToSD(const char* rec) {
     // Get a new file name if the name is blank
-    if (_fileName == "") generateAutoFileName();
+    if (_fileName[0] == '\0') generateAutoFileName();
     return logToSD(_fileName, rec);
 }
+#if !defined(MS_NO_STRING)
+bool Logger::logToSD(String& filename, String& rec) {
+    return logToSD(filename.c_str(), rec.c_str());
+}
+bool Logger::logToSD(String& rec) {
+    return logToSD(rec.c_str());
+}
+#endif
 // NOTE:  This is structured differently than the version with a string input
 // record.  This is to avoid the creation/passing of very long strings.
 bool Logger::logToSD(void) {
+    sdBusyGuard sdGuard;
     // Get a new file name if the name is blank
-    if (_fileName == "") generateAutoFileName();
+    if (_fileName[0] == '\0') generateAutoFileName();
+
+    // Start a new file if this record crosses a rotation boundary
+    checkFileRotation();
+    if (_fileRecordCount == 0) _fileStartTime = Logger::markedLocalEpochTime;
+    _fileEndTime = Logger::markedLocalEpochTime;
+    _fileRecordCount++;
+
+#if defined(MS_SD_QUEUE_SIZE)
+    // Add the record to the queue, writing out the queue first if the record
+    // will not fit in what is left of it
+    size_t recLen = formatLogRecord(_sdQueue + _sdQueueLen,
+                                    MS_SD_QUEUE_SIZE - _sdQueueLen);
+    if (recLen == 0 && _sdQueueLen > 0) {
+        if (!flushSDQueue()) return false;
+        recLen = formatLogRecord(_sdQueue, MS_SD_QUEUE_SIZE);
+    }
+    if (recLen > 0) {
+        if (_sdQueueLen == 0) _sdQueueOldest = Logger::markedUTCEpochTime;
+// Echo the line to the serial port
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
+        PRINTOUT(F("\n \\/---- Line Queued for SD Card ----\\/"));
+        printSensorDataCSV(&MS_CONSOLE_OUTPUT);
+        PRINTOUT('\n');
+#endif
+        _sdQueueLen += recLen;
+        MS_DBG(_sdQueueLen, F("of"), MS_SD_QUEUE_SIZE,
+               F("bytes queued for the SD card"));
+        if (_sdQueueMaxAge > 0 &&
+            Logger::markedUTCEpochTime - _sdQueueOldest >= _sdQueueMaxAge) {
+            return flushSDQueue();
+        }
+        return true;
+    }
+    // A record too long for the queue at all is written directly
+    MS_DBG(F("Record is too long for the SD card queue!"));
+    turnOnSDcard(true);
+#endif
 
-    // First attempt to open the file without creating a new one
-    if (!openFile(_fileName, false, false)) {
+    // If the file was left open from the last record, skip straight to
+    // writing.  Otherwise, first attempt to open the file without creating a
+    // new one
+    uint32_t save_ms = millis();
+    if (_sdKeepOpen && logFile.isOpen()) {
+        MS_DEEP_DBG(F("Writing to open file:"), _fileName);
+    } else if (!openFile(_fileName, false, false)) {
         // Next try to create a new file, bail if we couldn't create it
         // Generate a filename with the current date, if the file name isn't set
-        if (_fileName == "") generateAutoFileName();
+        if (_fileName[0] == '\0') generateAutoFileName();
         // Do add a default header to the new file!
         if (!openFile(_fileName, true, true)) {
             PRINTOUT(F("Unable to write to SD card!"));
+            recordSDLatency(SD_OP_SAVE, save_ms, false);
             return false;
         }
     }
 
     // Write the data
-    printSensorDataCSV(&logFile);
+    uint32_t write_ms = millis();
+    uint32_t before   = logFile.fileSize();
+    if (_binaryLogging) {
+        uint8_t rec[getBinaryRecordSize()];
+        size_t  recLen = formatSensorDataBinary(rec, sizeof(rec));
+        if (_binaryCompression) {
+            printBinaryBlock(&logFile, rec, 1);
+        } else {
+            logFile.write(rec, recLen);
+        }
+    } else {
+        printSensorDataCSV(&logFile);
+    }
+    _fileBytes = logFile.fileSize();
+    bool wrote = _fileBytes > before;
+    recordSDLatency(SD_OP_WRITE, write_ms, wrote);
 // Echo the line to the serial port
-#if defined(STANDARD_SERIAL_OUTPUT)
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
     PRINTOUT(F("\n \\/---- Line Saved to SD Card ----\\/"));
-    printSensorDataCSV(&STANDARD_SERIAL_OUTPUT);
+    printSensorDataCSV(&MS_CONSOLE_OUTPUT);
     PRINTOUT('\n');
 #endif
 
-    // Set write/modification date time
-    setFileTimestamp(logFile, T_WRITE);
-    // Set access date time
-    setFileTimestamp(logFile, T_ACCESS);
-    // Close the file to save it
-    logFile.close();
+    if (!_sdKeepOpen) {
+        // Set the timestamps and close the file to save it
+        bool success = syncLogFile(true) && wrote;
+        recordSDLatency(SD_OP_SAVE, save_ms, success);
+#if defined(MS_SD_QUEUE_SIZE)
+        // The caller leaves the card power to the queue
+        turnOffSDcard(true);
+#endif
+        return success;
+    }
+
+    // Leave the file open, syncing it only if the policy calls for it
+    _sdRecordsSinceSync++;
+    if ((_sdSyncEveryNRecords > 0 &&
+         _sdRecordsSinceSync >= _sdSyncEveryNRecords) ||
+        (_sdSyncIntervalSeconds > 0 &&
+         Logger::markedUTCEpochTime - _sdLastSyncTime >=
+             _sdSyncIntervalSeconds)) {
+        bool success = syncLogFile(false) && wrote;
+        recordSDLatency(SD_OP_SAVE, save_ms, success);
+        return success;
+    }
+    MS_DBG(_sdRecordsSinceSync,
+           F("records waiting to be synced to the SD card"));
+    recordSDLatency(SD_OP_SAVE, save_ms, wrote);
     return true;
 }
 
 
+// This sets whether to keep the log file open and how often to sync it
+void Logger::setSDKeepOpen(bool keepOpen, uint8_t syncEveryNRecords,
+                           uint32_t syncIntervalSeconds, bool syncBeforeSleep) {
+    // Save anything waiting if we're going back to closing the file
+    if (!keepOpen) syncLogFile(true);
+    _sdKeepOpen            = keepOpen;
+    _sdSyncEveryNRecords   = syncEveryNRecords;
+    _sdSyncIntervalSeconds = syncIntervalSeconds;
+    _sdSyncBeforeSleep     = syncBeforeSleep;
+}
+
+
+// This sets when to rotate the log file
+void Logger::setFileRotation(fileRotation rotation, uint32_t maxFileBytes) {
+    _fileRotation = rotation;
+    _maxFileBytes = maxFileBytes;
+}
+
+
+// This starts a new log file if the current one has reached a rotation
+// boundary
+void Logger::checkFileRotation(void) {
+    // Nothing to rotate if nothing has been written to the file yet
+    if (_fileRecordCount == 0) return;
+    if (_fileRotation == rotateNever && _maxFileBytes == 0) return;
+
+    DateTime fileStart = dtFromEpoch(_fileStartTime);
+    DateTime recTime   = dtFromEpoch(Logger::markedLocalEpochTime);
+    bool     newPeriod = false;
+    if (_fileRotation == rotateDaily) {
+        newPeriod = recTime.date() != fileStart.date() ||
+            recTime.month() != fileStart.month() ||
+            recTime.year() != fileStart.year();
+    } else if (_fileRotation == rotateMonthly) {
+        newPeriod = recTime.month() != fileStart.month() ||
+            recTime.year() != fileStart.year();
+    }
+    uint32_t fileBytes = _fileBytes;
+#if defined(MS_SD_QUEUE_SIZE)
+    fileBytes += _sdQueueLen;
+#endif
+    bool tooBig = _maxFileBytes > 0 && fileBytes >= _maxFileBytes;
+    if (!newPeriod && !tooBig) return;
+
+    MS_DBG(F("Closing"), _fileName, F("with"), _fileRecordCount,
+           F("records and"), fileBytes, F("bytes"));
+#if defined(MS_SD_QUEUE_SIZE)
+    // Everything queued belongs in the old file
+    flushSDQueue();
+    turnOnSDcard(true);
+#endif
+    syncLogFile(true);
+    writeFileIndexEntry(_fileStartTime, _fileEndTime, _fileRecordCount);
+#if defined(MS_SD_QUEUE_SIZE)
+    if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
+
+    // Name the new file from the logger ID and the time of its first record
+    char newFileName[MS_FILE_NAME_SIZE];
+    int  len = snprintf(newFileName, sizeof(newFileName),
+                        "%s_%04u-%02u-%02u", _loggerID, recTime.year(),
+                        recTime.month(), recTime.date());
+    // Files started because of their size need the time to be unique
+    if (tooBig && !newPeriod && len > 0 &&
+        static_cast<size_t>(len) < sizeof(newFileName)) {
+        snprintf(newFileName + len, sizeof(newFileName) - len,
+                 "_%02u%02u%02u", recTime.hour(), recTime.minute(),
+                 recTime.second());
+    }
+    strncat(newFileName, _binaryLogging ? ".bin" : ".csv",
+            sizeof(newFileName) - strlen(newFileName) - 1);
+    setFileName(newFileName);
+    _fileBytes = 0;
+    PRINTOUT(F("Data will now be saved as"), _fileName);
+}
+
+
+// This appends a line for the current log file to the index file
+bool Logger::writeFileIndexEntry(uint32_t startTime, uint32_t endTime,
+                                 uint32_t recordCount) {
+    sdBusyGuard sdGuard;
+    // The card is already running if the log file is open
+    if (!logFile.isOpen() && !initializeSDCard()) return false;
+
+    char indexName[MS_FILE_NAME_SIZE];
+    snprintf(indexName, sizeof(indexName), "%s_index.csv", _loggerID);
+    File indexFile;
+    if (!indexFile.open(indexName, O_WRITE | O_AT_END)) {
+        if (!indexFile.open(indexName, O_CREAT | O_WRITE | O_AT_END)) {
+            MS_DBG(F("Unable to write to index file:"), indexName);
+            return false;
+        }
+        setFileTimestamp(indexFile, T_CREATE);
+        indexFile.println(F("File Name,Start Time,End Time,Record Count"));
+    }
+    indexFile.print(_fileName);
+    indexFile.print(',');
+    indexFile.print(startTime);
+    indexFile.print(',');
+    indexFile.print(endTime);
+    indexFile.print(',');
+    indexFile.println(recordCount);
+    setFileTimestamp(indexFile, T_WRITE | T_ACCESS);
+    return indexFile.close();
+}
+
+
+// This commits any cached records to the card and updates the timestamps
+bool Logger::syncLogFile(bool closeFile) {
+    sdBusyGuard sdGuard(logFile.isOpen());
+    if (!logFile.isOpen()) return true;
+    // Set the write/modification and access date times, unless they're only
+    // being updated when the file is closed
+    if (closeFile || !_stampOnlyOnClose) {
+        setFileTimestamp(logFile, T_WRITE | T_ACCESS);
+    }
+    bool     success;
+    uint32_t start_ms = millis();
+    if (closeFile) {
+        success = logFile.close();
+        recordSDLatency(SD_OP_CLOSE, start_ms, success);
+    } else {
+        MS_DBG(F("Syncing"), _sdRecordsSinceSync, F("records to the SD card"));
+        success = logFile.sync();
+        recordSDLatency(SD_OP_SYNC, start_ms, success);
+    }
+    _sdRecordsSinceSync = 0;
+    _sdLastSyncTime     = Logger::markedUTCEpochTime;
+    if (!success) { PRINTOUT(F("Unable to save data to SD card!")); }
+    return success;
+}
+
+
+#if defined(MS_SD_QUEUE_SIZE)
+// This writes all queued records to the SD card
+bool Logger::flushSDQueue(void) {
+    sdBusyGuard sdGuard;
+    if (_sdQueueLen == 0) return true;
+    MS_DBG(F("Writing"), _sdQueueLen, F("queued bytes to the SD card"));
+#if defined(MS_SD_LATENCY_STATS)
+    if (_sdFlushFailed && _sdRetries < UINT16_MAX) _sdRetries++;
+#endif
+
+    turnOnSDcard(true);
+    uint32_t save_ms = millis();
+    // Get a new file name if the name is blank
+    if (_fileName[0] == '\0') generateAutoFileName();
+    if (!(_sdKeepOpen && logFile.isOpen()) &&
+        !openFile(_fileName, false, false) && !openFile(_fileName, true, true)) {
+        PRINTOUT(F("Unable to write to SD card!"));
+        // Keep the queue; the records will be retried with the next write
+        recordSDLatency(SD_OP_SAVE, save_ms, false);
+#if defined(MS_SD_LATENCY_STATS)
+        _sdFlushFailed = true;
+#endif
+        if (!_sdKeepOpen) turnOffSDcard(false);
+        return false;
+    }
+
+    uint32_t write_ms = millis();
+    size_t   written;
+    if (_binaryLogging && _binaryCompression) {
+        // The whole queue goes out as one compressed block
+        uint16_t count  = _sdQueueLen / getBinaryRecordSize();
+        uint32_t before = logFile.fileSize();
+        size_t   size   = printBinaryBlock(
+            &logFile, reinterpret_cast<uint8_t*>(_sdQueue), count);
+        written = size > 0 && logFile.fileSize() - before == size
+            ? _sdQueueLen
+            : 0;
+    } else {
+        written = logFile.write(reinterpret_cast<uint8_t*>(_sdQueue),
+                                _sdQueueLen);
+    }
+    recordSDLatency(SD_OP_WRITE, write_ms, written == _sdQueueLen);
+    _fileBytes   = logFile.fileSize();
+    bool success = syncLogFile(!_sdKeepOpen) && written == _sdQueueLen;
+    _sdQueueLen  = 0;
+    recordSDLatency(SD_OP_SAVE, save_ms, success);
+#if defined(MS_SD_LATENCY_STATS)
+    _sdFlushFailed = false;
+#endif
+    // Cut power from the SD card, waiting for housekeeping
+    if (!_sdKeepOpen) turnOffSDcard(true);
+    return success;
+}
+#endif
+
+
+#if defined(MS_SD_LATENCY_STATS)
+// This adds the time of an SD card operation to its histogram
+void Logger::recordSDLatency(sdOperation op, uint32_t start_ms,
+                             bool success) {
+    uint32_t elapsed = millis() - start_ms;
+    // The bucket is the number of bits in the time
+    uint8_t bucket = 0;
+    for (uint32_t t = elapsed; t > 0 && bucket < MS_SD_LATENCY_BUCKETS - 1;
+         t >>= 1) {
+        bucket++;
+    }
+    // Halve the whole histogram rather than overflow, keeping its shape
+    if (_sdLatencyHist[op][bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < MS_SD_LATENCY_BUCKETS; i++) {
+            _sdLatencyHist[op][i] >>= 1;
+        }
+    }
+    _sdLatencyHist[op][bucket]++;
+    if (elapsed > _sdWorstLatency_ms[op]) _sdWorstLatency_ms[op] = elapsed;
+    if (!success && _sdFailures[op] < UINT16_MAX) _sdFailures[op]++;
+    MS_DEEP_DBG(F("SD card operation"), op, F("took"), elapsed, F("ms"));
+}
+
+
+// This walks the histogram up to the bucket holding the percentile
+int32_t Logger::getSDLatencyPercentile(uint8_t percent, sdOperation op) {
+    if (op >= SD_OP_COUNT) return -9999;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < MS_SD_LATENCY_BUCKETS; i++) {
+        total += _sdLatencyHist[op][i];
+    }
+    if (total == 0) return -9999;
+    if (percent > 100) percent = 100;
+    // The rank of the percentile, rounded up
+    uint32_t rank = (total * percent + 99) / 100;
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < MS_SD_LATENCY_BUCKETS - 1; i++) {
+        seen += _sdLatencyHist[op][i];
+        if (seen >= rank) {
+            uint32_t top = i == 0 ? 0 : (1UL << i) - 1;
+            return top < _sdWorstLatency_ms[op] ? top
+                                                : _sdWorstLatency_ms[op];
+        }
+    }
+    return _sdWorstLatency_ms[op];
+}
+
+
+uint16_t Logger::getSDFailureCount(sdOperation op) {
+    if (op < SD_OP_COUNT) return _sdFailures[op];
+    // A failed save is already counted by the step that failed
+    uint32_t failures = 0;
+    for (uint8_t i = 0; i < SD_OP_SAVE; i++) failures += _sdFailures[i];
+    return failures < UINT16_MAX ? failures : UINT16_MAX;
+}
+
+
+// This prints one line for each operation, with the bucket counts
+void Logger::printSDStats(Stream* stream) {
+    stream->print(F("Operation"));
+    for (uint8_t i = 0; i < MS_SD_LATENCY_BUCKETS - 1; i++) {
+        stream->print(F(",<"));
+        stream->print(1UL << i);
+        stream->print(F("ms"));
+    }
+    stream->print(F(",>="));
+    stream->print(1UL << (MS_SD_LATENCY_BUCKETS - 2));
+    stream->println(F("ms,Worst ms,P95 ms,Failures"));
+    for (uint8_t op = 0; op < SD_OP_COUNT; op++) {
+        switch (op) {
+            case SD_OP_INIT: stream->print(F("Init")); break;
+            case SD_OP_OPEN: stream->print(F("Open")); break;
+            case SD_OP_WRITE: stream->print(F("Write")); break;
+            case SD_OP_SYNC: stream->print(F("Sync")); break;
+            case SD_OP_CLOSE: stream->print(F("Close")); break;
+            default: stream->print(F("Save")); break;
+        }
+        for (uint8_t i = 0; i < MS_SD_LATENCY_BUCKETS; i++) {
+            stream->print(',');
+            stream->print(_sdLatencyHist[op][i]);
+        }
+        stream->print(',');
+        stream->print(_sdWorstLatency_ms[op]);
+        stream->print(',');
+        stream->print(getSDLatencyPercentile(95, static_cast<sdOperation>(op)));
+        stream->print(',');
+        stream->println(_sdFailures[op]);
+    }
+    stream->print(F("Retries of queued records: "));
+    stream->println(_sdRetries);
+}
+
+
+void Logger::resetSDStats(void) {
+    memset(_sdLatencyHist, 0, sizeof(_sdLatencyHist));
+    memset(_sdWorstLatency_ms, 0, sizeof(_sdWorstLatency_ms));
+    memset(_sdFailures, 0, sizeof(_sdFailures));
+    _sdRetries     = 0;
+    _sdFlushFailed = false;
+}
+#endif
+
+
 // ===================================================================== //
 // Public functions for a "sensor testing" mode
 // ===================================================================== //
@@ -1229,7 +4288,100 @@ void Logger::testingISR() {
     if (!Logger::isTestingNow && !Logger::isLoggingNow) {
         Logger::startTesting = true;
         MS_DEEP_DBG(F("Testing flag has been set."));
+    } else if (Logger::isTestingNow) {
+        Logger::stopTesting = true;
+    }
+}
+
+
+void Logger::setStreamingMode(bool enable, streamFormat format,
+                              uint32_t maxSeconds) {
+    _streaming        = enable;
+    _streamFormat     = format;
+    _streamMaxSeconds = maxSeconds;
+}
+void Logger::setStreamingClient(Client* client, const char* host,
+                                uint16_t port) {
+    _streamClient = client;
+    _streamHost   = host;
+    _streamPort   = port;
+}
+
+
+// Each frame is formatted once for the serial port and the client
+void Logger::streamReadings(bool connected) {
+    bool toClient = connected && _streamClient != nullptr &&
+        _streamHost != nullptr && _streamClient->connect(_streamHost, _streamPort);
+    if (_streamClient != nullptr && connected && !toClient) {
+        PRINTOUT(F("Could not connect to"), _streamHost, F("to stream"));
+    }
+
+    // The press and release of the button that started testing come in the
+    // first moments, so they don't count as a stop
+    const uint32_t stopGuard_ms = 2000;
+    uint8_t        frame[getArrayVarCount() * MS_VALUE_BUFFER_SIZE + 16];
+    uint32_t       start = millis();
+    stopTesting          = false;
+    while (_streamMaxSeconds == 0 ||
+           millis() - start < _streamMaxSeconds * 1000) {
+        if (stopTesting && millis() - start > stopGuard_ms) break;
+        watchDogTimer.resetWatchDog();
+        // The sensors are already awake, so this only measures them
+        _internalArray->updateAllSensors();
+        size_t frameLen = formatStreamFrame(frame, sizeof(frame),
+                                            millis() - start);
+#if defined(STANDARD_SERIAL_OUTPUT)
+        MS_CONSOLE_OUTPUT.write(frame, frameLen);
+#endif
+        if (toClient) {
+            _streamClient->write(frame, frameLen);
+            toClient = _streamClient->connected();
+        }
+    }
+    stopTesting = false;
+    if (_streamClient != nullptr && connected) _streamClient->stop();
+}
+
+
+size_t Logger::formatStreamFrame(uint8_t* buffer, size_t bufferLen,
+                                 uint32_t elapsed_ms) {
+    uint8_t nVars = getArrayVarCount();
+    if (_streamFormat == streamBinary) {
+        size_t frameLen = 2 + 1 + sizeof(uint32_t) + sizeof(float) * nVars +
+            sizeof(uint16_t);
+        if (bufferLen < frameLen) return 0;
+        buffer[0] = 'M';
+        buffer[1] = 'S';
+        buffer[2] = nVars;
+        // Both AVR and SAMD are little-endian, so the values are copied as-is
+        memcpy(buffer + 3, &elapsed_ms, sizeof(uint32_t));
+        size_t written = 3 + sizeof(uint32_t);
+        for (uint8_t i = 0; i < nVars; i++) {
+            float value = _internalArray->arrayOfVars[i]->getValue();
+            memcpy(buffer + written, &value, sizeof(float));
+            written += sizeof(float);
+        }
+        uint16_t crc = crc16(buffer + 2, written - 2);
+        memcpy(buffer + written, &crc, sizeof(uint16_t));
+        return written + sizeof(uint16_t);
+    }
+
+    char* line = reinterpret_cast<char*>(buffer);
+    int   len  = snprintf(line, bufferLen, "%lu,",
+                          static_cast<unsigned long>(elapsed_ms));
+    if (len < 0 || (size_t)len >= bufferLen) return 0;
+    size_t written = len;
+    for (uint8_t i = 0; i < nVars; i++) {
+        // Leave room for the separator or line ending and the null
+        if (bufferLen - written < 4) return 0;
+        written += formatValueAtI(i, line + written, bufferLen - written - 2);
+        if (i + 1 != nVars) { line[written++] = ','; }
     }
+    if (bufferLen - written < 3) return 0;
+    line[written++] = '\r';
+    line[written++] = '\n';
+    line[written]   = '\0';
+    return written;
 }
 
 
@@ -1253,7 +4405,7 @@ void Logger::testingMode() {
             // Connect to the network
             watchDogTimer.resetWatchDog();
             MS_DBG(F("Connecting to the Internet..."));
-            if (_logModem->connectInternet()) {
+            if (connectModemInternet()) {
                 gotInternetConnection = true;
                 // Publish data to remotes
                 watchDogTimer.resetWatchDog();
@@ -1267,8 +4419,15 @@ void Logger::testingMode() {
     // Wake up all of the sensors
     _internalArray->sensorsWake();
 
+    if (_streaming) {
+        // The metadata is only updated once, so it doesn't slow the frames
+        if (gotInternetConnection) { _logModem->updateModemMetadata(); }
+        PRINTOUT(F("Streaming readings until the button is pressed"));
+        streamReadings(gotInternetConnection);
+    }
+
     // Update the sensors and print out data 25 times
-    for (uint8_t i = 0; i < 25; i++) {
+    for (uint8_t i = 0; i < 25 && !_streaming; i++) {
         PRINTOUT(F("------------------------------------------"));
 
         // Update the modem metadata
@@ -1289,11 +4448,11 @@ void Logger::testingMode() {
         _internalArray->updateAllSensors();
         // Print out the current logger time
         PRINTOUT(F("Current logger time is"),
-                 formatDateTime_ISO8601(getNowLocalEpoch()));
+                 formatDateTime_ISO8601(getCycleLocalEpoch()));
         PRINTOUT(F("-----------------------"));
 // Print out the sensor data
 #if defined(STANDARD_SERIAL_OUTPUT)
-        _internalArray->printSensorData(&STANDARD_SERIAL_OUTPUT);
+        _internalArray->printSensorData(&MS_CONSOLE_OUTPUT);
 #endif
         PRINTOUT(F("-----------------------"));
         watchDogTimer.resetWatchDog();
@@ -1308,7 +4467,9 @@ void Logger::testingMode() {
 
     // Turn the modem off
     if (_logModem != nullptr) {
-        if (gotInternetConnection) { _logModem->disconnectInternet(); }
+        if (gotInternetConnection && !_logModem->isPowerSaving()) {
+            _logModem->disconnectInternet();
+        }
         _logModem->modemSleepPowerDown();
     }
 
@@ -1343,14 +4504,20 @@ void Logger::begin(VariableArray* inputArray) {
 }
 void Logger::begin() {
     MS_DBG(F("Logger ID is:"), _loggerID);
-    MS_DBG(F("Logger is set to record at"), _loggingIntervalMinutes,
-           F("minute intervals."));
+    MS_DBG(F("Logger is set to record at"), _loggingIntervalSeconds,
+           F("second intervals."));
 
     MS_DBG(F(
         "Setting up a watch-dog timer to fire after 5 minutes of inactivity"));
     watchDogTimer.setupWatchDog((uint32_t)(5 * 60 * 3));
     // Enable the watchdog
     watchDogTimer.enableWatchDog();
+    // Keep the watchdog fed while waiting on sensors, unless the user has
+    // already given some other function to call during the waits.  The same
+    // function moves a pipelined modem along.
+    if (!Sensor::hasWaitCallback()) {
+        Sensor::setWaitCallback(&Logger::waitAndPollModem);
+    }
 
 #if defined ARDUINO_ARCH_SAMD
     MS_DBG(F("Beginning internal real time clock"));
@@ -1383,6 +4550,10 @@ void Logger::begin() {
     // NOTE:  This must be done here at run time not at compile time
     setLoggerPins(_mcuWakePin, _SDCardSSPin, _SDCardPowerPin, _buttonPin,
                   _ledPin);
+#if defined(MS_PHASE_MARKER_PIN)
+    pinMode(MS_PHASE_MARKER_PIN, OUTPUT);
+    digitalWrite(MS_PHASE_MARKER_PIN, LOW);
+#endif
 
 #if defined(MS_SAMD_DS3231) || not defined(ARDUINO_ARCH_SAMD)
     MS_DBG(F("Beginning DS3231 real time clock"));
@@ -1401,12 +4572,30 @@ void Logger::begin() {
 
     // Begin the internal array
     _internalArray->begin();
+    for (uint8_t k = 0; k < _arrayCount; k++) {
+        _arraySchedules[k].array->begin();
+        PRINTOUT(F("Variable array"), k + 1, F("has"),
+                 _arraySchedules[k].array->getVariableCount(),
+                 F("variables, logged every"),
+                 _arraySchedules[k].intervalSeconds, F("seconds."));
+    }
+    // Pick up where a reset left off
+    if (_checkpointing) _resumed = loadCheckpoint();
+    // The settings last fetched replace those set in the sketch
+    if (_settingsCache) loadSettings();
+    // As do the sensor times last calibrated
+    if (_timingCache) loadSensorTiming();
+    // Note the phase that ran out of time, if that's why the logger restarted
+    saveWatchdogOverrun();
     PRINTOUT(F("This logger has a variable array with"), getArrayVarCount(),
              F("variables, of which"),
              getArrayVarCount() - _internalArray->getCalculatedVariableCount(),
              F("come from"), _internalArray->getSensorCount(), F("sensors and"),
              _internalArray->getCalculatedVariableCount(),
              F("are calculated."));
+#if MS_PRINT_MEMORY_REPORT && defined(STANDARD_SERIAL_OUTPUT)
+    printMemoryReport(STANDARD_SERIAL_OUTPUT);
+#endif
 
     if (_samplingFeatureUUID != nullptr) {
         PRINTOUT(F("Sampling feature UUID is:"), _samplingFeatureUUID);
@@ -1420,12 +4609,16 @@ void Logger::begin() {
 void Logger::logData(void) {
     // Reset the watchdog
     watchDogTimer.resetWatchDog();
+    // Warm up the sensors if woken ahead of the interval to do that
+    preWarmForInterval();
 
     // Assuming we were woken up by the clock, check if the current time is an
     // even interval of the logging interval
     if (checkInterval()) {
         // Flag to notify that we're in already awake and logging a point
         Logger::isLoggingNow = true;
+        _cycleStart_ms       = millis();
+        markPhase(PHASE_POWER_UP);
         // Reset the watchdog
         watchDogTimer.resetWatchDog();
 
@@ -1433,21 +4626,50 @@ void Logger::logData(void) {
         PRINTOUT(F("------------------------------------------"));
         // Turn on the LED to show we're taking a reading
         alertOn();
-        // Power up the SD Card
-        // TODO(SRGDamia1):  Decide how much delay is needed between turning on
-        // the card and writing to it.  Could we turn it on just before writing?
-        turnOnSDcard(false);
+        // The SD card isn't powered until the record is committed
 
-        // Do a complete sensor update
-        MS_DBG(F("    Running a complete sensor update..."));
-        watchDogTimer.resetWatchDog();
-        _internalArray->completeUpdate();
-        watchDogTimer.resetWatchDog();
+        // Do a complete sensor update of each array due
+        markPhase(PHASE_MEASURE);
+        if (_mainDue) {
+            MS_DBG(F("    Running a complete sensor update..."));
+            watchDogTimer.resetWatchDog();
+            budgetSensorUpdate();
+            _internalArray->setUpdatePeriod(getActiveIntervalSeconds() *
+                                            1000UL);
+            _internalArray->completeUpdate();
+            watchDogTimer.resetWatchDog();
+            recordHistories();
+            // Switch to or from the power tier and event intervals
+            checkPowerTier();
+            checkTriggers();
+            // Format the values once for the file, the output, and the
+            // publishers
+            buildRecord();
+        }
+        updateDueArrays();
 
         // Create a csv data record and save it to the log file
-        logToSD();
-        // Cut power from the SD card, waiting for housekeeping
-        turnOffSDcard(true);
+        markPhase(PHASE_SD_COMMIT);
+#if !defined(MS_SD_QUEUE_SIZE)
+        turnOnSDcard(true);
+#endif
+        if (_mainDue) {
+            logToSD();
+            if (_checkpointing) saveCheckpoint();
+        }
+        logDueArrays();
+        markPhase(PHASE_SLEEP);
+#if defined(MS_PHASE_MARKER_PIN)
+        savePhaseTimes();
+#endif
+#if defined(MS_TRACE_BUFFER_SIZE)
+        saveUpdateTrace();
+#endif
+        // Cut power from the SD card once its housekeeping is done, unless
+        // the log file is being kept open or was written through the queue
+#if !defined(MS_SD_QUEUE_SIZE)
+        if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
 
         // Turn off the LED
         alertOff();
@@ -1468,12 +4690,16 @@ void Logger::logData(void) {
 void Logger::logDataAndPublish(void) {
     // Reset the watchdog
     watchDogTimer.resetWatchDog();
+    // Warm up the sensors if woken ahead of the interval to do that
+    preWarmForInterval();
 
     // Assuming we were woken up by the clock, check if the current time is an
     // even interval of the logging interval
     if (checkInterval()) {
         // Flag to notify that we're in already awake and logging a point
         Logger::isLoggingNow = true;
+        _cycleStart_ms       = millis();
+        markPhase(PHASE_POWER_UP);
         // Reset the watchdog
         watchDogTimer.resetWatchDog();
 
@@ -1481,75 +4707,213 @@ void Logger::logDataAndPublish(void) {
         PRINTOUT(F("------------------------------------------"));
         // Turn on the LED to show we're taking a reading
         alertOn();
-        // Power up the SD Card
-        // TODO(SRGDamia1):  Decide how much delay is needed between turning on
-        // the card and writing to it.  Could we turn it on just before writing?
-        turnOnSDcard(false);
+        // The SD card isn't powered until the record is committed
+
+        // Only wake the modem if a publisher is due to send or the clock is
+        // due for a sync
+        bool clockSyncDue = isClockSyncDue();
+        bool modemDue = _logModem != nullptr &&
+            (clockSyncDue || checkPublishersDue());
+
+        // If pipelining, start bringing the modem up now, so it can register
+        // on the network while the sensors are measuring.  It's polled
+        // whenever the sensor update waits.
+        bool wakeTried = false;
+        if (modemDue && (_pipelineModem || _publishLag)) {
+            MS_DBG(F("Starting"), _logModem->getModemName(),
+                   F("before the sensor update..."));
+            watchDogTimer.resetWatchDog();
+            loadNetworkHint();
+#if !defined(MS_SD_QUEUE_SIZE)
+            // Nothing was written, so the card can go straight back off
+            if (!_sdKeepOpen) turnOffSDcard(false);
+#endif
+            _logModem->startConnect(_logModem->getConnectTimeout(50000L));
+            _pollingModem = _logModem;
+            wakeTried     = true;
+            if (_publishLag && _mainDue) {
+                _lagging       = true;
+                _laggedSent    = false;
+                _laggingLogger = this;
+            }
+        }
 
         // Do a complete update on the variable array.
         // This this includes powering all of the sensors, getting updated
         // values, and turing them back off.
         // NOTE:  The wake function for each sensor should force sensor setup to
         // run if the sensor was not previously set up.
-        MS_DBG(F("Running a complete sensor update..."));
-        watchDogTimer.resetWatchDog();
-        _internalArray->completeUpdate();
-        watchDogTimer.resetWatchDog();
+        markPhase(PHASE_MEASURE);
+        if (_mainDue) {
+            MS_DBG(F("Running a complete sensor update..."));
+            watchDogTimer.resetWatchDog();
+            budgetSensorUpdate();
+            _internalArray->setUpdatePeriod(getActiveIntervalSeconds() *
+                                            1000UL);
+            _internalArray->completeUpdate();
+            _laggingLogger = nullptr;
+            watchDogTimer.resetWatchDog();
+            recordHistories();
+            // Switch to or from the power tier and event intervals; a new
+            // event may make the publishers due and a low battery may shed
+            // the modem
+            checkPowerTier();
+            checkTriggers();
+        }
+        updateDueArrays();
+        if (_logModem != nullptr && !modemDue) modemDue = checkPublishersDue();
+        bool modemShed = _logModem != nullptr && isModemShed();
+        if (modemShed && wakeTried) {
+            _pollingModem = nullptr;
+            _logModem->modemSleepPowerDown();
+        }
+        if (_mainDue) {
+            // Format the values once for the file, the output, and the
+            // publishers
+            buildRecord();
 
 // Print out the sensor data
-#if defined(STANDARD_SERIAL_OUTPUT)
-        MS_DBG('\n');
-        _internalArray->printSensorData(&STANDARD_SERIAL_OUTPUT);
-        MS_DBG('\n');
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
+            MS_DBG('\n');
+            _internalArray->printSensorData(&MS_CONSOLE_OUTPUT);
+            MS_DBG('\n');
 #endif
+        }
 
-        // Create a csv data record and save it to the log file
-        logToSD();
+        // Create a csv data record and save it to the log file, or, with a
+        // modem already connecting, from the wait function while it connects.
+        // The other arrays due are written straight away.
+        markPhase(PHASE_SD_COMMIT);
+        logDueArrays();
+        if (_mainDue && _overlapSDCommit && _pollingModem != nullptr) {
+            startSDCommit();
+        } else if (_mainDue) {
+#if !defined(MS_SD_QUEUE_SIZE)
+            turnOnSDcard(true);
+#endif
+            logToSD();
+            if (_checkpointing) saveCheckpoint();
+        }
 
-        if (_logModem != nullptr) {
-            MS_DBG(F("Waking up"), _logModem->getModemName(), F("..."));
-            if (_logModem->modemWake()) {
-                // Connect to the network
-                watchDogTimer.resetWatchDog();
-                MS_DBG(F("Connecting to the Internet..."));
-                if (_logModem->connectInternet()) {
-                    // Publish data to remotes
-                    watchDogTimer.resetWatchDog();
-                    publishDataToRemotes();
-                    watchDogTimer.resetWatchDog();
+        // Publishing is the first thing dropped when the cycle is out of time
+        uint32_t timeLeft = getCycleTimeLeft();
+        bool     outOfTime = _logModem != nullptr && modemDue &&
+            timeLeft < MS_CYCLE_MIN_PUBLISH_MS;
+        if (outOfTime && wakeTried) {
+            _pollingModem = nullptr;
+            finishSDCommit();
+            _logModem->modemSleepPowerDown();
+        }
 
-                    if ((Logger::markedLocalEpochTime != 0 &&
-                         Logger::markedLocalEpochTime % 86400 == 43200) ||
-                        !isRTCSane(Logger::markedLocalEpochTime)) {
-                        // Sync the clock at noon
-                        MS_DBG(F("Running a daily clock sync..."));
-                        setRTClock(_logModem->getNISTTime());
-                        watchDogTimer.resetWatchDog();
+        if (modemShed) {
+            // Save the record for when the battery has recovered
+            MS_DBG(F("Battery is too low to use the modem"));
+            saveUnsentRecords(true);
+        } else if (outOfTime) {
+            // Save the record for the next cycle with time to publish
+            MS_DBG(F("No time left in the cycle to publish"));
+            saveUnsentRecords(true);
+        } else if (_logModem != nullptr && !modemDue) {
+            // Save the record for the publishers waiting for a later interval
+            MS_DBG(F("No publishers are due; leaving the modem off"));
+            saveUnsentRecords(false);
+        } else if (_logModem != nullptr) {
+            // Leave the last of the budget for at least one publisher
+            uint32_t connectTime = _logModem->getConnectTimeout(50000L);
+            timeLeft             = getCycleTimeLeft();
+            if (timeLeft != 0xFFFFFFFF &&
+                timeLeft < connectTime + MS_CYCLE_MIN_PUBLISH_MS) {
+                connectTime = timeLeft > 2 * MS_CYCLE_MIN_PUBLISH_MS
+                    ? timeLeft - MS_CYCLE_MIN_PUBLISH_MS
+                    : MS_CYCLE_MIN_PUBLISH_MS;
+            }
+            bool connected = false;
+            markPhase(PHASE_MODEM_ATTACH);
+            watchDogTimer.resetWatchDog();
+            if (wakeTried) {
+                // Finish the connection started before the sensor update
+                MS_DBG(F("Finishing the connection to the Internet..."));
+                connected = finishModemConnect(connectTime);
+            } else {
+                MS_DBG(F("Waking up"), _logModem->getModemName(), F("..."));
+                if (_logModem->modemWake()) {
+                    // Connect to the network
+                    watchDogTimer.resetWatchDog();
+                    MS_DBG(F("Connecting to the Internet..."));
+                    connected = connectModemInternet(connectTime);
+                }
+            }
+            if (connected) {
+                // Publish data to remotes, unless the signal is too weak to
+                // be worth the power
+                markPhase(PHASE_PUBLISH);
+                watchDogTimer.resetWatchDog();
+                startPublishSession();
+                if (isSignalTooWeak()) {
+                    saveUnsentRecords(true);
+                } else {
+                    if (_lagging) {
+                        // This record goes out with the next interval, unless
+                        // the backlogs couldn't be sent during the update
+                        uint32_t intervalNumber = getIntervalNumber();
+                        for (uint8_t i = 0; i < MAX_NUMBER_SENDERS; i++) {
+                            if (isPublisherInArray(i) &&
+                                dataPublishers[i]->getBacklog() &&
+                                isPublisherDue(i, intervalNumber)) {
+                                appendToBacklog(i);
+                            }
+                        }
+                        if (!_laggedSent) sendDueBacklogs();
                     }
+                    publishDueArrays();
+                }
+                watchDogTimer.resetWatchDog();
 
-                    // Update the modem metadata
-                    MS_DBG(F("Updating modem metadata..."));
-                    _logModem->updateModemMetadata();
+                if (clockSyncDue) {
+                    // Sync the clock before it can drift too far
+                    MS_DBG(F("Running a clock sync..."));
+                    setRTClock(_logModem->getUTCTime());
+                    watchDogTimer.resetWatchDog();
+                }
+
+                // Update the modem metadata
+                MS_DBG(F("Updating modem metadata..."));
+                _logModem->updateModemMetadata();
 
-                    // Disconnect from the network
+                // Disconnect from the network, unless the modem keeps the
+                // connection through power saving mode
+                if (!_logModem->isPowerSaving()) {
                     MS_DBG(F("Disconnecting from the Internet..."));
                     _logModem->disconnectInternet();
-                } else {
-                    MS_DBG(F("Could not connect to the internet!"));
-                    watchDogTimer.resetWatchDog();
                 }
+            } else {
+                MS_DBG(F("Could not connect to the internet!"));
+                watchDogTimer.resetWatchDog();
+                saveUnsentRecords(true);
             }
             // Turn the modem off
             _logModem->modemSleepPowerDown();
         }
+        _lagging            = false;
+        _publishSessionOpen = false;
+#if defined(MS_MODEM_PROFILE_AT)
+        if (_logModem != nullptr) saveModemProfile();
+#endif
+        markPhase(PHASE_SLEEP);
+#if defined(MS_PHASE_MARKER_PIN)
+        savePhaseTimes();
+#endif
+#if defined(MS_TRACE_BUFFER_SIZE)
+        saveUpdateTrace();
+#endif
 
 
-        // Cut power from the SD card - without additional housekeeping wait
-        // TODO(SRGDamia1):  Do some sort of verification that minimum 1 sec has
-        // passed for internal SD card housekeeping before cutting power -
-        // although it seems very unlikely based on my testing that less than
-        // one second would be taken up in publishing data to remotes.
-        turnOffSDcard(false);
+        // Cut power from the SD card.  The housekeeping after the commit has
+        // run while publishing, so this only waits out whatever is left of it.
+        // Leave it on if the log file is being kept open.
+#if !defined(MS_SD_QUEUE_SIZE)
+        if (!_sdKeepOpen) turnOffSDcard(true);
+#endif
 
         // Turn off the LED
         alertOff();
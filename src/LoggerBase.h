@@ -31,6 +31,9 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableArray.h"
 #include "LoggerModem.h"
+#include "MemoryReport.h"
+#include "VariableHistory.h"
+#include "PersistentStore.h"
 
 // Bring in the libraries to handle the processor sleep/standby modes
 // The SAMD library can also the built-in clock on those modules
@@ -56,6 +59,23 @@
  */
 #define EPOCH_TIME_OFF 946684800
 
+/**
+ * @brief The size of a buffer holding an ISO8601 formatted date-time with a
+ * time zone offset, like "2020-01-01T12:00:00-05:00", and a terminating null.
+ */
+#define MS_ISO8601_BUFFER_SIZE 26
+
+#ifndef MS_FILE_NAME_SIZE
+/**
+ * @brief The size of the buffers holding the names of the files on the SD
+ * card, including the terminating null.
+ *
+ * The names are the logger ID followed by a date and time, or by the kind of
+ * file, so this must be at least 24 more than the length of the logger ID.
+ */
+#define MS_FILE_NAME_SIZE 48
+#endif
+
 #include <SdFat.h>  // To communicate with the SD card
 
 /**
@@ -63,6 +83,377 @@
  */
 #define MAX_NUMBER_SENDERS 4
 
+#ifndef MS_RECORD_BUFFER_SIZE
+/**
+ * @brief The size of the buffer holding the formatted values of the current
+ * data record.
+ *
+ * Each value takes its formatted length plus one character for a terminating
+ * null.  Any values that do not fit are formatted again each time they are
+ * read.
+ */
+#define MS_RECORD_BUFFER_SIZE 256
+#endif
+
+#ifndef MS_PRINT_MEMORY_REPORT
+/**
+ * @brief Set to 1 for Logger::begin() to print the RAM taken by the logger's
+ * objects, or to 0 to leave it out.
+ */
+#define MS_PRINT_MEMORY_REPORT 1
+#endif
+
+#ifndef MS_MIN_DRIFT_WINDOW
+/**
+ * @brief The shortest time in seconds between two clock syncs that the drift
+ * of the RTC is estimated from.
+ *
+ * The RTC only counts whole seconds, so shorter windows give very noisy
+ * estimates.
+ */
+#define MS_MIN_DRIFT_WINDOW 21600L
+#endif
+
+#ifndef MS_CLOCK_PHASE_TOLERANCE_MS
+/**
+ * @brief How far apart in milliseconds the start of each second of the RTC
+ * and of a time source may be before Logger::setRTClockPhase() sets the RTC
+ * again.
+ */
+#define MS_CLOCK_PHASE_TOLERANCE_MS 50
+#endif
+
+#ifndef MS_MIN_ALARM_LEAD
+/**
+ * @brief The fewest seconds ahead the RTC alarm is set for the next logging
+ * interval.
+ *
+ * If the next interval is any closer, it could pass before the processor is
+ * asleep and the alarm would not come until the next day, so the logger waits
+ * for it awake instead.
+ */
+#define MS_MIN_ALARM_LEAD 2
+#endif
+
+#ifndef MS_MAX_SLEEP_PINS
+/**
+ * @brief The most pins that can be disconnected while the logger sleeps with
+ * Logger::sleepLowLeak.
+ */
+#define MS_MAX_SLEEP_PINS 16
+#endif
+
+#ifndef MS_TAIL_SCAN_BYTES
+/**
+ * @brief The furthest back from the end of a CSV log file that
+ * Logger::repairLogTail() looks for the end of the last whole line.
+ *
+ * This should be at least the length of the longest record.
+ */
+#define MS_TAIL_SCAN_BYTES 1024
+#endif
+
+#ifndef MS_SD_LATENCY_BUCKETS
+/**
+ * @brief The number of buckets in each of the SD card latency histograms kept
+ * when `MS_SD_LATENCY_STATS` is defined.
+ *
+ * Bucket 0 counts the operations taking less than 1 ms, and each bucket after
+ * it holds operations up to twice as long as the one before: bucket n counts
+ * 2^(n-1) to 2^n - 1 ms.  The last bucket also counts everything longer.
+ */
+#define MS_SD_LATENCY_BUCKETS 12
+#endif
+
+/**
+ * @brief The SD card operations timed when `MS_SD_LATENCY_STATS` is defined.
+ *
+ * Define `MS_SD_LATENCY_STATS` to have the logger time each of these, keep a
+ * histogram of the times and count the failures.  A card wearing out shows up
+ * as saves creeping from tens of milliseconds to seconds well before it fails
+ * outright.
+ */
+typedef enum sdOperation {
+    SD_OP_INIT = 0,  ///< Starting the card with SdFat's begin()
+    SD_OP_OPEN,      ///< Opening or creating the log file
+    SD_OP_WRITE,     ///< Writing records into the log file
+    SD_OP_SYNC,      ///< Committing the log file while it stays open
+    SD_OP_CLOSE,     ///< Committing and closing the log file
+    SD_OP_SAVE,      ///< All of saving a record or the queue, open to close
+    SD_OP_COUNT      ///< The number of operations
+} sdOperation;
+
+/**
+ * @brief The phases of a logging cycle marked when `MS_PHASE_MARKER_PIN` is
+ * defined.
+ *
+ * Define `MS_PHASE_MARKER_PIN` as the number of a free pin to have the logger
+ * toggle it at the start of each phase and save the phase durations to the SD
+ * card.  Each phase lasts until the next one is marked; phases with nothing to
+ * do in a cycle, like the modem's on intervals with no publisher due, are not
+ * marked.
+ */
+typedef enum loggerCyclePhase {
+    PHASE_WAKE = 0,      ///< The processor waking, until the cycle begins
+    PHASE_POWER_UP,      ///< Powering the SD card and starting the modem
+    PHASE_MEASURE,       ///< The sensor update and formatting the record
+    PHASE_SD_COMMIT,     ///< Writing the record to the SD card
+    PHASE_MODEM_ATTACH,  ///< Waking the modem and connecting to the Internet
+    PHASE_PUBLISH,       ///< Publishing, the clock sync and the modem shutdown
+    PHASE_SLEEP,         ///< Powering down, until the processor wakes again
+    PHASE_COUNT          ///< The number of phases
+} loggerCyclePhase;
+
+#ifndef MS_MAX_TRIGGERS
+/**
+ * @brief The largest number of event triggers a logger can have.
+ */
+#define MS_MAX_TRIGGERS 4
+#endif
+
+/**
+ * @brief The kinds of conditions that start event logging.
+ */
+typedef enum loggerTriggerType {
+    TRIGGER_ABOVE = 0,  ///< The value is above the threshold
+    TRIGGER_BELOW,      ///< The value is below the threshold
+    TRIGGER_RISING,     ///< The value rises faster than the threshold rate
+    TRIGGER_FALLING     ///< The value falls faster than the threshold rate
+} loggerTriggerType;
+
+/**
+ * @brief A condition on one variable that starts event logging.
+ */
+typedef struct loggerTrigger {
+    /**
+     * @brief The variable checked
+     */
+    Variable* variable;
+    /**
+     * @brief The kind of condition
+     */
+    loggerTriggerType type;
+    /**
+     * @brief The threshold value, or the threshold rate of change per minute
+     */
+    float threshold;
+    /**
+     * @brief The value at the last check, for the rate of change
+     */
+    float lastValue;
+    /**
+     * @brief The UTC time of the last check
+     */
+    uint32_t lastTime;
+} loggerTrigger;
+
+#ifndef MS_MAX_HISTORIES
+/**
+ * @brief The largest number of variable histories a logger can keep.
+ */
+#define MS_MAX_HISTORIES 4
+#endif
+
+#ifndef MS_MAX_POWER_TIERS
+/**
+ * @brief The largest number of low battery power tiers a logger can have.
+ */
+#define MS_MAX_POWER_TIERS 3
+#endif
+
+#ifndef MS_MAX_SHED_SENSORS
+/**
+ * @brief The largest number of sensors that can be shed on low battery.
+ */
+#define MS_MAX_SHED_SENSORS 4
+#endif
+
+#ifndef MS_POWER_TIER_HYSTERESIS
+/**
+ * @brief How far above a power tier's threshold the battery must recover
+ * before the tier is left, in volts.
+ *
+ * This keeps a battery hovering around a threshold from switching the tier on
+ * every record.
+ */
+#define MS_POWER_TIER_HYSTERESIS 0.1
+#endif
+
+/**
+ * @brief A low battery tier with the ways the logger saves power in it.
+ */
+typedef struct loggerPowerTier {
+    /**
+     * @brief The tier applies while the battery is below this voltage
+     */
+    float belowVolts;
+    /**
+     * @brief The logging interval is multiplied by this
+     */
+    uint8_t intervalMultiplier;
+    /**
+     * @brief Publish only every this many records
+     */
+    uint8_t publishEveryX;
+    /**
+     * @brief True to suspend the sheddable sensors
+     */
+    bool shedSensors;
+    /**
+     * @brief True to leave the modem off entirely
+     */
+    bool modemOff;
+} loggerPowerTier;
+
+#ifndef MS_MAX_VARIABLE_ARRAYS
+/**
+ * @brief The largest number of variable arrays a logger can log on their own
+ * intervals, besides its main one.
+ */
+#define MS_MAX_VARIABLE_ARRAYS 2
+#endif
+
+/**
+ * @brief A variable array logged on its own interval, to its own file.
+ */
+typedef struct loggerArraySchedule {
+    /**
+     * @brief The variable array
+     */
+    VariableArray* array;
+    /**
+     * @brief The logging interval of the array, in seconds
+     */
+    uint32_t intervalSeconds;
+    /**
+     * @brief The name of the data file of the array; blank until the first
+     * record if it was left to be named after the logger ID
+     */
+    char fileName[MS_FILE_NAME_SIZE];
+} loggerArraySchedule;
+
+#ifndef MS_CYCLE_CLOCK_CHECK_MS
+/**
+ * @brief The longest the cycle clock runs from millis() before it is checked
+ * against the RTC again, in milliseconds.
+ */
+#define MS_CYCLE_CLOCK_CHECK_MS 60000L
+#endif
+
+#ifndef MS_CHECKPOINT_MAX_AGE
+/**
+ * @brief The oldest checkpoint the logger resumes from after a reset, in
+ * seconds.
+ *
+ * An older checkpoint is from before the logger was last switched off, not
+ * from a watchdog reset in the middle of logging.
+ */
+#define MS_CHECKPOINT_MAX_AGE 3600L
+#endif
+
+#ifndef MS_CHECKPOINT_MAX_SENSORS
+/**
+ * @brief The most sensors whose failure counts are kept in a checkpoint.
+ */
+#define MS_CHECKPOINT_MAX_SENSORS 16
+#endif
+
+#ifndef MS_SETTINGS_SIZE
+/**
+ * @brief The longest settings text the logger takes, in characters.
+ */
+#define MS_SETTINGS_SIZE 192
+#endif
+
+#ifndef MS_SETTINGS_ETAG_SIZE
+/**
+ * @brief The longest ETag kept for the settings, with its terminator.
+ */
+#define MS_SETTINGS_ETAG_SIZE 40
+#endif
+
+/**
+ * @brief The logger state saved after each record, so the logger can resume
+ * after a watchdog reset.
+ */
+typedef struct loggerCheckpoint {
+    /**
+     * @brief The UTC time of the last completed record
+     */
+    uint32_t lastRecordUTC;
+    /**
+     * @brief The UTC time of the first clock sync the drift is measured from
+     */
+    uint32_t driftRefUTC;
+    /**
+     * @brief The error of the RTC at the drift reference plus the seconds
+     * stepped since
+     */
+    int32_t driftAdjusted;
+    /**
+     * @brief The UTC time of the last clock sync
+     */
+    uint32_t lastSyncUTC;
+    /**
+     * @brief The seconds the RTC has been stepped since the last sync
+     */
+    int32_t driftStepped;
+    /**
+     * @brief The estimated drift of the RTC in parts per million
+     */
+    float driftPPM;
+    /**
+     * @brief The uncertainty of the drift in parts per million
+     */
+    float driftUncertaintyPPM;
+    /**
+     * @brief The UTC time the current event ends
+     */
+    uint32_t eventEndTime;
+    /**
+     * @brief True if an event was running
+     */
+    bool eventActive;
+    /**
+     * @brief The number of sensors with saved failure counts
+     */
+    uint8_t sensorCount;
+    /**
+     * @brief The failures in a row of each sensor
+     */
+    uint8_t sensorFailures[MS_CHECKPOINT_MAX_SENSORS];
+    /**
+     * @brief The updates each failing sensor has left to skip
+     */
+    uint16_t sensorSkipsLeft[MS_CHECKPOINT_MAX_SENSORS];
+    /**
+     * @brief The number of the modem's recent connection times
+     */
+    uint8_t connectTimeCount;
+    /**
+     * @brief The modem's recent connection times in tenths of a second
+     */
+    uint16_t connectTimes[MS_MODEM_CONNECT_HISTORY];
+} loggerCheckpoint;
+
+#ifndef MS_CYCLE_SD_RESERVE_MS
+/**
+ * @brief The part of a cycle's time budget kept for formatting the record and
+ * writing it to the SD card, in milliseconds.
+ */
+#define MS_CYCLE_SD_RESERVE_MS 3000L
+#endif
+
+#ifndef MS_CYCLE_MIN_PUBLISH_MS
+/**
+ * @brief The least time left in a cycle's budget for the modem to be woken or
+ * another publisher to be tried, in milliseconds.
+ *
+ * With less time left, the record is saved to the backlogs instead.
+ */
+#define MS_CYCLE_MIN_PUBLISH_MS 10000L
+#endif
+
 
 class dataPublisher;  // Forward declaration
 
@@ -173,10 +564,140 @@ class Logger {
     /**
      * @brief Get the Logging Interval.
      *
-     * @return **uint16_t** The logging interval in minutes
+     * @return **uint16_t** The logging interval in whole minutes; 0 if the
+     * interval is less than a minute
      */
     uint16_t getLoggingInterval() {
-        return _loggingIntervalMinutes;
+        return _loggingIntervalSeconds / 60;
+    }
+    /**
+     * @brief Set the logging interval in seconds.
+     *
+     * Intervals that divide evenly into a minute (such as 10, 15, or 30
+     * seconds) or into an hour keep the records on the same marks every hour.
+     * For intervals of only a few seconds, keep the log file open with
+     * setSDKeepOpen() so each record doesn't have to open and close the file.
+     *
+     * @param loggingIntervalSeconds The frequency in seconds with which to
+     * update sensor values and write data to the SD card.
+     */
+    void setLoggingIntervalSeconds(uint32_t loggingIntervalSeconds);
+    /**
+     * @brief Get the logging interval in seconds.
+     *
+     * @return **uint32_t** The logging interval in seconds
+     */
+    uint32_t getLoggingIntervalSeconds() {
+        return _loggingIntervalSeconds;
+    }
+
+    /**
+     * @brief Set up event logging, where the logger switches to a faster
+     * interval while any trigger condition is met.
+     *
+     * The triggers, added with addTrigger(), are checked after each sensor
+     * update.  While any of them is met, and for the hold-off time after the
+     * last one was, records are logged at the event interval.  After that the
+     * logger goes back to its normal interval.  The event interval should
+     * divide evenly into the normal interval so the normal records keep their
+     * times.
+     *
+     * @param eventIntervalSeconds The logging interval during an event, in
+     * seconds.
+     * @param holdOffSeconds The time after the last met trigger before the
+     * logger goes back to its normal interval, in seconds.
+     * @param publishImmediately True to send every record to every publisher
+     * during an event.  False (the default) keeps sending by the publishers'
+     * normal schedules; the extra records can still be saved for later with
+     * the publishers' batching.
+     */
+    void setEventLogging(uint32_t eventIntervalSeconds,
+                         uint32_t holdOffSeconds,
+                         bool     publishImmediately = false);
+    /**
+     * @brief Add a condition that starts event logging.
+     *
+     * @param variable The variable to check.  It does not need to be in the
+     * logger's variable array, but it is only updated with it.
+     * @param type The kind of condition
+     * @param threshold The threshold value for #TRIGGER_ABOVE and
+     * #TRIGGER_BELOW, or the threshold rate of change in units per minute for
+     * #TRIGGER_RISING and #TRIGGER_FALLING
+     * @return **bool** True if there was room for the trigger
+     */
+    bool addTrigger(Variable* variable, loggerTriggerType type,
+                    float threshold);
+    /**
+     * @brief Check whether the logger is logging at its event interval.
+     *
+     * @return **bool** True during an event
+     */
+    bool isEventActive(void) {
+        return _eventActive;
+    }
+
+    /**
+     * @brief Add a history of the recent values of a variable, kept in RAM.
+     *
+     * After each complete sensor update, before the triggers are checked,
+     * the current value of the history's variable is added to it with the
+     * time of the record.
+     *
+     * @param history The history, usually a StaticVariableHistory
+     * @return **bool** True if there was room for the history
+     */
+    bool addHistory(VariableHistory* history);
+
+    /**
+     * @brief Set the variable reporting the battery voltage for the power
+     * tiers.
+     *
+     * After each complete update, the battery voltage picks the power tier
+     * from those added with addPowerTier().  The logger enters a lower tier as
+     * soon as the battery drops below its threshold, and leaves it once the
+     * battery is #MS_POWER_TIER_HYSTERESIS above it again.  Event logging is
+     * paused while in any power tier.
+     *
+     * @param batteryVariable The battery voltage variable, usually a
+     * ProcessorStats_Battery.  It should be in the logger's variable array so
+     * it's updated with each record.
+     */
+    void setPowerPolicy(Variable* batteryVariable);
+    /**
+     * @brief Add a low battery power tier.
+     *
+     * @param belowVolts The tier applies while the battery is below this
+     * voltage.  A tier with a lower threshold is a lower tier.
+     * @param intervalMultiplier The logging interval is multiplied by this in
+     * the tier.  Default is 1.
+     * @param publishEveryX Publish only one of every this many records in the
+     * tier; the others are treated like records a publisher isn't due for.
+     * Default is 1.
+     * @param shedSensors True to suspend the sensors added with
+     * addSheddableSensor() in the tier.  Default is false.
+     * @param modemOff True to leave the modem off entirely in the tier; the
+     * records are saved to the publisher backlogs.  Default is false.
+     * @return **bool** True if there was room for the tier
+     */
+    bool addPowerTier(float belowVolts, uint8_t intervalMultiplier = 1,
+                      uint8_t publishEveryX = 1, bool shedSensors = false,
+                      bool modemOff = false);
+    /**
+     * @brief Add a power-hungry sensor, such as one with a wiper or pump, to
+     * suspend in power tiers that shed sensors.
+     *
+     * @param sensor The sensor to shed
+     * @return **bool** True if there was room for the sensor
+     */
+    bool addSheddableSensor(Sensor* sensor);
+    /**
+     * @brief Get the current power tier.
+     *
+     * @return **int8_t** The position of the tier, counting from the highest
+     * threshold; -1 for normal operation
+     */
+    int8_t getPowerTier(void) {
+        return _powerTier;
     }
 
     /**
@@ -208,25 +729,42 @@ class Logger {
      * to the SD card.
      */
     void setSDCardPwr(int8_t SDCardPowerPin);
+    /**
+     * @brief Set how long the SD card needs after power-up and after a write.
+     *
+     * The logger only powers the card while the record is committed and the
+     * other files are written.  It waits out the settle time after switching
+     * the card on, and only cuts the power once the housekeeping time has
+     * passed since the last write, usually while the modem publishes.
+     *
+     * @param settle_ms The time in milliseconds between powering on the card
+     * and beginning initialization.  Default is 6.
+     * @param housekeeping_ms The time in milliseconds the card may need after
+     * a write before its power can be cut.  Default is 1000.
+     */
+    void setSDCardTiming(uint16_t settle_ms, uint16_t housekeeping_ms);
     /**
      * @brief Send power to the SD card by setting the SDCardPowerPin `HIGH`.
      *
      * Optionally waits for the card to "settle."  Has no effect if a pin has
-     * not been set to control power to the SD card.
+     * not been set to control power to the SD card.  If the card is already
+     * on, only waits out what is left of the settle time.
      *
-     * @param waitToSettle True to add a short (6ms) delay between powering on
-     * the card and beginning initialization.  Defaults to true.
+     * @param waitToSettle True to wait the settle time set by
+     * setSDCardTiming() (6ms) between powering on the card and beginning
+     * initialization.  Defaults to true.
      */
     void turnOnSDcard(bool waitToSettle = true);
     /**
      * @brief Cut power to the SD card by setting the SDCardPowerPin `LOW`.
      *
      * Optionally waits for the card to do "housekeeping" before cutting the
-     * power.  Has o effect if a pin has not been set to control power to the SD
-     * card.
+     * power.  Has no effect if a pin has not been set to control power to the
+     * SD card.
      *
-     * @param waitForHousekeeping True to add a 1 second delay between to allow
-     * any on-chip writing to complete before cutting power.  Defaults to true.
+     * @param waitForHousekeeping True to wait until the housekeeping time set
+     * by setSDCardTiming() (1s) has passed since the last write, to allow any
+     * on-chip writing to complete before cutting power.  Defaults to true.
      */
     void turnOffSDcard(bool waitForHousekeeping = true);
 
@@ -323,7 +861,8 @@ class Logger {
      *
      * Once in testing mode, the logger will attempt to connect the the internet
      * and take 25 measurements spaced at 5 second intervals writing the results
-     * to the main output destination (ie, Serial).  Testing mode cannot be
+     * to the main output destination (ie, Serial), or stream measurements as
+     * set by setStreamingMode().  Testing mode cannot be
      * entered while the logger is taking a scheduled measureemnt.  No data is
      * written to the SD card in testing mode.
      *
@@ -388,62 +927,203 @@ class Logger {
      */
     const char* _loggerID = "MyLogger";
     /**
-     * @brief The logging interval in minutes
+     * @brief The logging interval in seconds
      */
-    uint16_t _loggingIntervalMinutes = 5;
+    uint32_t _loggingIntervalSeconds = 300;
     /**
-     * @brief Digital pin number on the mcu controlling the SD card slave
-     * select.
+     * @brief The logging interval in seconds during an event; 0 if event
+     * logging is not set up.
      */
-    int8_t _SDCardSSPin = -1;
+    uint32_t _eventIntervalSeconds = 0;
     /**
-     * @brief Digital pin number on the mcu controlling SD card power
+     * @brief The time after the last met trigger that an event lasts, in
+     * seconds.
      */
-    int8_t _SDCardPowerPin = -1;
+    uint32_t _eventHoldOffSeconds = 0;
     /**
-     * @brief Digital pin number on the mcu receiving interrupts to wake from
-     * deep-sleep.
+     * @brief The local time an event ends unless another trigger is met.
      */
-    int8_t _mcuWakePin = -1;
+    uint32_t _eventEndTime = 0;
     /**
-     * @brief Digital pin number on the mcu used to output an alert that the
-     * logger is measuring.
-     *
-     * Expected to be connected to a LED.
+     * @brief True while logging at the event interval.
      */
-    int8_t _ledPin = -1;
+    bool _eventActive = false;
     /**
-     * @brief Digital pin number on the mcu receiving interrupts to enter
-     * testing mode.
-     *
-     * Expected to be connected to a user button.
+     * @brief True to send every record during an event.
      */
-    int8_t _buttonPin = -1;
-
+    bool _eventPublish = false;
     /**
-     * @brief The sampling feature UUID
+     * @brief The conditions that start event logging.
      */
-    const char* _samplingFeatureUUID = nullptr;
-    // ^^ Start with no feature UUID
-    /**@}*/
-
-    // ===================================================================== //
+    loggerTrigger _triggers[MS_MAX_TRIGGERS];
     /**
-     * @anchor logger_internal_array
-     * @name Attached Variable Array Functions
-     * Public functions to get information about the attached variable array
+     * @brief The histories of recent values.
      */
-    /**@{*/
-    // ===================================================================== //
-
- public:
+    VariableHistory* _histories[MS_MAX_HISTORIES];
     /**
-     * @brief Set the variable array object.
-     *
-     * @param inputArray A variable array object instance.  This is NOT an array
+     * @brief The number of histories added.
+     */
+    uint8_t _historyCount = 0;
+    /**
+     * @brief The variable reporting the battery voltage for the power tiers.
+     */
+    Variable* _batteryVariable = nullptr;
+    /**
+     * @brief The power tiers, from the highest threshold to the lowest.
+     */
+    loggerPowerTier _powerTiers[MS_MAX_POWER_TIERS];
+    /**
+     * @brief The number of power tiers added.
+     */
+    uint8_t _powerTierCount = 0;
+    /**
+     * @brief The current power tier; -1 for normal operation.
+     */
+    int8_t _powerTier = -1;
+    /**
+     * @brief The sensors suspended in the tiers that shed sensors.
+     */
+    Sensor* _shedSensors[MS_MAX_SHED_SENSORS];
+    /**
+     * @brief The number of sheddable sensors added.
+     */
+    uint8_t _shedSensorCount = 0;
+    /**
+     * @brief The number of triggers added.
+     */
+    uint8_t _triggerCount = 0;
+    /**
+     * @brief Digital pin number on the mcu controlling the SD card slave
+     * select.
+     */
+    int8_t _SDCardSSPin = -1;
+    /**
+     * @brief Digital pin number on the mcu controlling SD card power
+     */
+    int8_t _SDCardPowerPin = -1;
+    /**
+     * @brief The port register and bit mask of the SD card power pin
+     */
+    FastPin _SDCardPowerIO;
+    /**
+     * @brief True while the SD card power pin is `HIGH`
+     */
+    bool _sdPowered = false;
+    /**
+     * @brief The millis() the SD card was last powered on
+     */
+    uint32_t _sdPowerOn_ms = 0;
+    /**
+     * @brief The time for the SD card to settle after power-up
+     */
+    uint16_t _sdSettle_ms = 6;
+    /**
+     * @brief The time the SD card may need after a write before its power is
+     * cut
+     */
+    uint16_t _sdHousekeeping_ms = 1000;
+    /**
+     * @brief Digital pin number on the mcu receiving interrupts to wake from
+     * deep-sleep.
+     */
+    int8_t _mcuWakePin = -1;
+    /**
+     * @brief Digital pin number on the mcu used to output an alert that the
+     * logger is measuring.
+     *
+     * Expected to be connected to a LED.
+     */
+    int8_t _ledPin = -1;
+    /**
+     * @brief Digital pin number on the mcu receiving interrupts to enter
+     * testing mode.
+     *
+     * Expected to be connected to a user button.
+     */
+    int8_t _buttonPin = -1;
+
+    /**
+     * @brief The sampling feature UUID
+     */
+    const char* _samplingFeatureUUID = nullptr;
+    // ^^ Start with no feature UUID
+    /**@}*/
+
+    // ===================================================================== //
+    /**
+     * @anchor logger_internal_array
+     * @name Attached Variable Array Functions
+     * Public functions to get information about the attached variable array
+     */
+    /**@{*/
+    // ===================================================================== //
+
+ public:
+    /**
+     * @brief Set the variable array object.
+     *
+     * @param inputArray A variable array object instance.  This is NOT an array
      * of variables, but an object of the variable array class.
      */
     void setVariableArray(VariableArray* inputArray);
+    /**
+     * @brief Add another variable array, logged on its own interval to its
+     * own file.
+     *
+     * The main array, given to setVariableArray() or begin(), keeps the
+     * logging interval and everything tied to it: the events, the power
+     * tiers, the histories, the checkpoints and the streaming.  Each added
+     * array is updated only on the multiples of its own interval, and its
+     * records are written as CSV to its own file.  The logger sleeps until
+     * whichever array is due first, and when several are due at the same
+     * time they share the one wake, and the one modem session if any of
+     * their publishers are due.
+     *
+     * A sensor in more than one array is updated once for each array that is
+     * due, so the arrays should usually hold separate sensors.
+     *
+     * @param inputArray A variable array object instance
+     * @param intervalSeconds The logging interval of the array, in seconds
+     * @param fileName The name of the data file of the array.  Defaults to
+     * the logger ID followed by "_array" and the number of the array.
+     * @return **int8_t** The number of the array, from 1, for
+     * setPublisherArray(); -1 if there was no room for it
+     */
+    int8_t addVariableArray(VariableArray* inputArray, uint32_t intervalSeconds,
+                            const char* fileName = nullptr);
+    /**
+     * @brief Send the records of one of the variable arrays to a publisher,
+     * instead of those of the main array.
+     *
+     * The publisher's send frequency then counts the intervals of that array.
+     *
+     * @param publisher A registered data publisher
+     * @param arrayNum The number returned by addVariableArray(), or 0 for the
+     * main array
+     * @return **bool** True if the publisher is registered and the array
+     * exists
+     */
+    bool setPublisherArray(dataPublisher* publisher, uint8_t arrayNum);
+    /**
+     * @brief Get the number of variable arrays added with addVariableArray().
+     *
+     * @return **uint8_t** The number of arrays, not counting the main one
+     */
+    uint8_t getVariableArrayCount() {
+        return _arrayCount;
+    }
+    /**
+     * @brief Print the RAM taken by each of the logger's objects, the free
+     * RAM and the largest free block.
+     *
+     * This covers the logger itself, with its record buffer and SD card
+     * objects; each sensor and the variables; the publishers and their
+     * shared send buffer; and the modem.  It is printed by begin() when
+     * #MS_PRINT_MEMORY_REPORT is 1.  The total is kept by MemoryReport.
+     *
+     * @param out The stream to print to
+     */
+    void printMemoryReport(Print& out);
 
     /**
      * @brief Get the number of variables in the internal variable array object.
@@ -453,6 +1133,32 @@ class Logger {
      */
     uint8_t getArrayVarCount();
 
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Get the name of the parent sensor of the variable at the given
+     * position in the internal variable array object.
+     *
+     * @note With the build flag `MS_NO_STRING`; otherwise this returns a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **const char\*** The name of the parent sensor of that
+     * variable, if applicable.
+     */
+    const char* getParentSensorNameAtI(uint8_t position_i);
+    /**
+     * @brief Get the name and pin location of the parent sensor of the variable
+     * at the given position in the internal variable array object.
+     *
+     * @note With the build flag `MS_NO_STRING`; otherwise this returns a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **const char\*** The concatenated name and pin location of the
+     * parent sensor of that variable, if applicable.
+     */
+    const char* getParentSensorNameAndLocationAtI(uint8_t position_i);
+#else
     /**
      * @brief Get the name of the parent sensor of the variable at the given
      * position in the internal variable array object.
@@ -471,6 +1177,7 @@ class Logger {
      * sensor of that variable, if applicable.
      */
     String getParentSensorNameAndLocationAtI(uint8_t position_i);
+#endif
     /**
      * @brief Get the name of the variable at the given position in the
      * internal variable array object.
@@ -501,6 +1208,18 @@ class Logger {
      * @return **String** The variable code
      */
     String getVarCodeAtI(uint8_t position_i);
+    /**
+     * @brief Write the customized code of the variable at the given position
+     * in the internal variable array object into a buffer, without making a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer, including the terminating null
+     * @return **uint8_t** The length of the code written; 0 if it doesn't fit
+     */
+    uint8_t formatVarCodeAtI(uint8_t position_i, char* buffer,
+                             size_t bufferSize);
     /**
      * @brief Get the UUID of the variable at the given position in the internal
      * variable array object.
@@ -509,6 +1228,41 @@ class Logger {
      * @return **String** The variable UUID
      */
     String getVarUUIDAtI(uint8_t position_i);
+    /**
+     * @brief Write the UUID of the variable at the given position in the
+     * internal variable array object into a buffer, without making a String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer; 37 is enough for any UUID
+     * @return **uint8_t** The length of the UUID written
+     */
+    uint8_t formatVarUUIDAtI(uint8_t position_i, char* buffer,
+                             size_t bufferSize);
+    /**
+     * @brief Get the 16 raw bytes of the UUID of the variable at the given
+     * position in the internal variable array object.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param bytes A buffer of 16 bytes for the UUID
+     * @return **bool** True if the variable has a correctly formatted UUID
+     */
+    bool getVarUUIDBytesAtI(uint8_t position_i, uint8_t* bytes);
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Get the most recent value of the variable at the given position in
+     * the internal variable array object.
+     *
+     * @note With the build flag `MS_NO_STRING`, the text may be in a buffer
+     * shared by all variables, which the next call writes over; use
+     * formatValueAtI() to keep it.  Otherwise this returns a String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **const char\*** The value of the variable as text with the
+     * correct number of significant figures.
+     */
+    const char* getValueStringAtI(uint8_t position_i);
+#else
     /**
      * @brief Get the most recent value of the variable at the given position in
      * the internal variable array object.
@@ -518,12 +1272,213 @@ class Logger {
      * number of significant figures.
      */
     String getValueStringAtI(uint8_t position_i);
+#endif
+    /**
+     * @brief Write the most recent value of the variable at the given position
+     * in the internal variable array object into a character buffer.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatValueAtI(uint8_t position_i, char* buffer, size_t bufferLen);
+    /**
+     * @brief Set what the data file does with values that were not measured
+     * for the current record.
+     *
+     * The policy applies to the data file, the serial output, and the records
+     * saved to the publishers' backlogs, which are written the same way.  A
+     * column can't be left out of the data file, so #STALE_OMIT is treated as
+     * #STALE_MISSING.  Each publisher has its own policy; see
+     * dataPublisher::setStalePolicy().
+     *
+     * @param policy What to do with the stale values.  Default is
+     * #STALE_KEEP.
+     * @param maxAgeSeconds The oldest a value can be and not be stale; see
+     * Variable::isValueStale().  Default is 0.
+     */
+    void setStalePolicy(staleValuePolicy policy, uint32_t maxAgeSeconds = 0) {
+        _stalePolicy   = policy;
+        _staleMaxAge_s = maxAgeSeconds;
+    }
+    /**
+     * @brief Check whether the value of the variable at the given position is
+     * stale.
+     *
+     * The values of a record loaded from a backlog are never stale; they
+     * were checked when the record was saved.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **bool** True if the value is older than the age given to
+     * setStalePolicy()
+     */
+    bool isValueStaleAtI(uint8_t position_i);
+    /**
+     * @brief Get when the value of the variable at the given position was
+     * measured, as an offset from the marked time.
+     *
+     * This is the middle of the parent sensor's measurements in the last
+     * update (see Sensor::getMeasurementMillis()) less the millis() at the
+     * start of the marked second, so staggered or slow sensors can be placed
+     * to the millisecond.  The start of the second is only that exact when
+     * the logger was woken by its alarm; otherwise it may be up to a second
+     * early.  For a record loaded from a backlog, this is the offset saved
+     * with it, if setMeasurementOffsets() was on.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **int32_t** The offset in milliseconds; 0 for a calculated
+     * variable or one whose sensor took no measurements
+     */
+    int32_t getMeasurementOffsetAtI(uint8_t position_i);
+
+    /**
+     * @brief Format the current values of all variables into the record buffer.
+     *
+     * This is called once after each complete update so the data file, the
+     * serial output, and every publisher all read the same formatted values
+     * instead of each formatting every value again.  The record is only used
+     * while no newer sensor update has been made; after that the values are
+     * read directly from the variables again.
+     */
+    void buildRecord(void);
+    /**
+     * @brief Get the formatted value of the variable at the given position from
+     * the current record.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return **const char\*** The formatted value, or a nullptr if the record
+     * is out of date or does not hold that variable.
+     */
+    const char* getRecordValueAtI(uint8_t position_i);
+    /**
+     * @brief Get the total number of characters in the formatted values of all
+     * variables, as written by formatValueAtI().
+     *
+     * When the current record holds every value this is read straight from
+     * the record, so publishers can size a request without formatting any
+     * values again.
+     *
+     * @return **size_t** The summed length of all of the formatted values
+     */
+    size_t getFormattedValuesLength(void);
 
  protected:
+    /**
+     * @brief Write the value of the variable at the given position as it goes
+     * into the data file, with the stale value policy applied.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatLoggedValueAtI(uint8_t position_i, char* buffer,
+                                size_t bufferLen);
+    /**
+     * @brief The formatted values of the current record, each null-terminated
+     * and stored in variable order.
+     */
+    char _recordBuffer[MS_RECORD_BUFFER_SIZE];
+    /**
+     * @brief The number of values stored in the record buffer
+     */
+    uint8_t _recordCount = 0;
+    /**
+     * @brief True if the record buffer was loaded from a backlog
+     */
+    bool _recordLoaded = false;
+    /**
+     * @brief The binary record the record buffer was loaded from, while it's
+     * being sent
+     */
+    const uint8_t* _loadedRecord = nullptr;
+    /**
+     * @brief What the data file does with stale values
+     */
+    staleValuePolicy _stalePolicy = STALE_KEEP;
+    /**
+     * @brief The oldest a value can be and not be stale, in seconds
+     */
+    uint32_t _staleMaxAge_s = 0;
+    /**
+     * @brief The number of characters used in the record buffer, including the
+     * terminating nulls
+     */
+    uint16_t _recordLength = 0;
+    /**
+     * @brief The variable update number the record was built from
+     */
+    uint32_t _recordUpdateNumber = 0;
+    /**
+     * @brief The position of the last value read from the record
+     */
+    uint8_t _recordCursorIndex = 0;
+    /**
+     * @brief The offset of the last value read from the record
+     */
+    uint16_t _recordCursorOffset = 0;
     /**
      * @brief A pointer to the internal variable array instance
      */
     VariableArray* _internalArray;
+    /**
+     * @brief The main variable array, while another is selected
+     */
+    VariableArray* _mainArray = nullptr;
+    /**
+     * @brief The variable arrays on their own intervals
+     */
+    loggerArraySchedule _arraySchedules[MS_MAX_VARIABLE_ARRAYS];
+    /**
+     * @brief The number of variable arrays added
+     */
+    uint8_t _arrayCount = 0;
+    /**
+     * @brief The array the record, the file and the publishers work on; 0 for
+     * the main array
+     */
+    uint8_t _activeArray = 0;
+    /**
+     * @brief True if the main array is due at the marked time
+     */
+    bool _mainDue = true;
+    /**
+     * @brief One bit for each added array due at the marked time
+     */
+    uint8_t _arraysDue = 0;
+
+    /**
+     * @brief Make one of the variable arrays the one the record, the file
+     * and the publishers work on.
+     *
+     * @param arrayNum The number of the array; 0 for the main array
+     */
+    void selectArray(uint8_t arrayNum);
+    /**
+     * @brief Check if a variable array is due at the marked time.
+     *
+     * @param arrayNum The number of the array; 0 for the main array
+     * @return **bool** True if the array is due
+     */
+    bool isArrayDue(uint8_t arrayNum) {
+        if (arrayNum == 0) return _mainDue;
+        return (_arraysDue >> (arrayNum - 1)) & 1;
+    }
+    /**
+     * @brief Run a complete update of each of the added arrays due at the
+     * marked time.
+     */
+    void updateDueArrays(void);
+    /**
+     * @brief Write a record of each of the added arrays due at the marked time
+     * to its file.
+     */
+    void logDueArrays(void);
     /**@}*/
 
     // ===================================================================== //
@@ -547,48 +1502,1141 @@ class Logger {
      *
      * @param modem An instance of the loggerModem class
      */
-    void attachModem(loggerModem& modem);
+    void attachModem(loggerModem& modem);
+    /**
+     * @brief Use the attahed loggerModem to synchronize the real-time clock
+     * with the network time, an NTP server, or the NIST time servers; see
+     * loggerModem::getUTCTime().
+     *
+     * @return **bool** True if clock synchronization was successful
+     */
+    bool syncRTC();
+    /**
+     * @brief Set whether the attached modem should be woken before the
+     * sensors are updated in logDataAndPublish().
+     *
+     * By default the modem is only woken after all sensors have been measured
+     * and the data has been written to the SD card.  With pipelining enabled
+     * the modem is started with loggerModem::startConnect() first and polled
+     * whenever the sensor update waits, so it wakes, registers with the
+     * network, and attaches while the sensors warm up and measure.  Publishing
+     * starts as soon as the record is saved.  This shortens the time the
+     * logger is awake each interval at the cost of running the modem for
+     * longer.  The wake and the data connection steps still take a few
+     * seconds each, which delays any sensor that is ready while they run.
+     *
+     * @warning Do not enable pipelining if the modem shares a power pin with
+     * any sensor in the variable array; the sensors will be powered down at
+     * the end of the update.
+     *
+     * @param enablePipelining True to wake the modem before the sensor update.
+     * Defaults to true.
+     */
+    void setModemPipelining(bool enablePipelining = true);
+    /**
+     * @brief Get whether the modem is woken before the sensors are updated.
+     *
+     * @return **bool** True if modem pipelining is enabled
+     */
+    bool getModemPipelining() {
+        return _pipelineModem;
+    }
+    /**
+     * @brief Set whether each record is published one interval late, while
+     * the sensors for the next record are measured.
+     *
+     * With this on, logDataAndPublish() starts the modem before the sensor
+     * update, as with setModemPipelining().  Once the modem connects, while
+     * the update is still waiting on the sensors, each due publisher with a
+     * backlog sends the records waiting in it, including the one from the last
+     * interval.  The new record goes into the backlogs afterwards, to go out
+     * with the next interval.  If the modem didn't connect in time, the
+     * backlogs are sent after the update instead, so the new record goes too
+     * and remote data is never more than one record behind.
+     *
+     * Only the publishers with a backlog (see dataPublisher::setBacklog())
+     * are sent late; the others still publish the new record after the
+     * update.
+     *
+     * @warning Do not enable this if the modem shares a power pin with any
+     * sensor in the variable array.
+     *
+     * @param enableLag True to publish the records one interval late.
+     * Defaults to true.
+     */
+    void setPublishLag(bool enableLag = true) {
+        _publishLag = enableLag;
+    }
+    /**
+     * @brief Get whether records are published one interval late.
+     *
+     * @return **bool** True if records are published during the next update
+     */
+    bool getPublishLag() {
+        return _publishLag;
+    }
+    /**
+     * @brief Set whether the SD card commit is overlapped with bringing up a
+     * pipelined modem.
+     *
+     * With this and modem pipelining both on, logDataAndPublish() only
+     * switches the SD card on when the record is ready and goes on to finish
+     * the modem connection.  The record is written from the wait function
+     * once the card has settled, while the logger is otherwise idling for the
+     * modem, and the card's housekeeping then runs during the rest of the
+     * connection.  The commit is always finished before the modem connection
+     * is used or given up on.
+     *
+     * @note SdFat writes to the card with blocking SPI transfers, so the
+     * write itself doesn't run alongside anything else; it is only moved into
+     * time that would otherwise be spent waiting on the modem.
+     *
+     * @param enableOverlap True to overlap the commit with the modem
+     * connection.  Defaults to true.
+     */
+    void setSDCommitOverlap(bool enableOverlap = true) {
+        _overlapSDCommit = enableOverlap;
+    }
+    /**
+     * @brief Set the longest each logging cycle may take.
+     *
+     * The budget starts when the logger wakes for a record.  As it runs out,
+     * the cycle drops work in order: first extra averaging, then sensors that
+     * aren't critical (see Sensor::setCritical()), and then publishing, whose
+     * records are saved to the backlogs instead.  The sensor update ends
+     * #MS_CYCLE_SD_RESERVE_MS before the end of the budget so the record is
+     * always written to the SD card.  The modem is only woken, and each
+     * publisher only tried, with at least #MS_CYCLE_MIN_PUBLISH_MS left.
+     *
+     * Pick a budget well inside the logging interval and the watchdog
+     * timeout.
+     *
+     * @param budget_ms The time budget of each cycle in milliseconds; 0 for
+     * no limit.  There is no limit until this is called.
+     */
+    void setCycleBudget(uint32_t budget_ms) {
+        _cycleBudget_ms = budget_ms;
+    }
+    /**
+     * @brief Get the time budget of each logging cycle.
+     *
+     * @return **uint32_t** The budget in milliseconds; 0 for no limit
+     */
+    uint32_t getCycleBudget(void) {
+        return _cycleBudget_ms;
+    }
+    /**
+     * @brief Set the weakest signal the logger will publish at.
+     *
+     * At the edge of coverage, retries make an upload many times slower and
+     * use many times the power.  With a gate, the signal is checked as soon
+     * as the modem is connected.  If it is weaker than the limit, nothing is
+     * published; each due publisher saves the record to its backlog, to be
+     * sent at the next cycle with a better signal.  Publishing goes ahead
+     * anyway once the records have been held back for too many cycles or
+     * for too long.  The clock is still synced.
+     *
+     * @param minRSSI The weakest RSSI to publish at, in dBm; 0 to always
+     * publish.  There is no gate until this is called.
+     * @param maxDeferrals The most cycles in a row to hold back.  Default is
+     * 12.
+     * @param maxDeferredAge The longest to hold back the oldest record, in
+     * seconds.  Default is 21600 (6 hours).
+     */
+    void setSignalGate(int16_t minRSSI, uint8_t maxDeferrals = 12,
+                       uint32_t maxDeferredAge = 21600L) {
+        _minPublishRSSI     = minRSSI;
+        _maxSignalDeferrals = maxDeferrals;
+        _maxDeferredAge     = maxDeferredAge;
+    }
+    /**
+     * @brief Set whether the logger saves a checkpoint to the SD card after
+     * each record and resumes from it in begin().
+     *
+     * The checkpoint holds the time of the last record, the clock drift and
+     * sync state, any event in progress, the failure counts of the sensors,
+     * and the modem's recent connection times.  The publisher backlogs and
+     * the last network of the modem are already kept in their own files.  If
+     * begin() finds a checkpoint less than #MS_CHECKPOINT_MAX_AGE old, it
+     * restores that state and defers the setup of every sensor to its first
+     * update, so the logger goes straight back to its schedule after a
+     * watchdog reset.  The connection times are restored from a checkpoint
+     * of any age.  Checkpoints are not saved until this is called.  With a
+     * persistent store, the checkpoint is kept there instead of on the SD card.
+     *
+     * @param enableCheckpoint True to save and resume from checkpoints
+     */
+    void setCheckpointing(bool enableCheckpoint = true) {
+        _checkpointing = enableCheckpoint;
+    }
+    /**
+     * @brief Keep the checkpoint and the last network of the modem in a
+     * persistent store, rather than in their files on the SD card.
+     *
+     * A checkpoint is written after every record, so a store in EEPROM or
+     * FRAM spares the card a file rewrite each cycle, and keeps the state of a
+     * logger whose card has failed.  A store whose backend can't be used from
+     * an interrupt, like FRAM on the I2C bus, doesn't take the checkpoint of
+     * the watchdog's last gasp; the one from the last record is kept.
+     *
+     * @param store The store, which must already have its backend; nullptr to
+     * go back to the files
+     */
+    void setPersistentStore(PersistentStore* store) {
+        _store = store;
+    }
+    /**
+     * @brief Check whether begin() resumed from a checkpoint.
+     *
+     * A sketch can use this to skip the slower parts of its own setup, like
+     * syncing the clock.
+     *
+     * @return **bool** True if the logger resumed from a checkpoint
+     */
+    bool isResumed(void) {
+        return _resumed;
+    }
+    /**
+     * @brief Apply runtime settings given as compact text, like a config
+     * fetched by a RemoteConfigPublisher.
+     *
+     * The text is a list of `key=value` settings, one to a line or separated
+     * by semicolons:
+     *
+     * - `interval=<seconds>`: the logging interval; see
+     * setLoggingIntervalSeconds()
+     * - `send<n>=<X>[,<offset>]`: the send frequency of publisher n, counting
+     * from 0 in the order they were registered; see
+     * dataPublisher::setSendFrequency()
+     * - `avg.<code>=<n>`: the number of measurements averaged by the sensor of
+     * the variable with that code; see Sensor::setNumberMeasurementsToAverage()
+     * - `timing.<code>=<warm-up>,<stabilization>,<measurement>`: the times in
+     * milliseconds of the sensor of the variable with that code; see
+     * Sensor::setTiming()
+     *
+     * Lines starting with `#` and unknown or out of range settings are
+     * skipped.  Settings left out of the text keep their current values.
+     *
+     * @param settings The settings text
+     * @return **uint8_t** The number of settings applied
+     */
+    uint8_t applySettings(const char* settings);
+    /**
+     * @brief Set whether begin() applies the settings last saved to the SD
+     * card with saveSettings().
+     *
+     * @param enable True to apply the saved settings in begin()
+     */
+    void setSettingsCache(bool enable = true) {
+        _settingsCache = enable;
+    }
+    /**
+     * @brief Save settings text, and the ETag identifying it, to the
+     * `<logger id>_config.txt` file on the SD card.
+     *
+     * The file holds the ETag on its first line and the settings after it.
+     *
+     * @param settings The settings text
+     * @param etag The ETag of the settings
+     * @return **bool** True if the file was written
+     */
+    bool saveSettings(const char* settings, const char* etag);
+    /**
+     * @brief Read the settings saved with saveSettings(), apply them, and keep
+     * their ETag.
+     *
+     * @return **bool** True if saved settings were found
+     */
+    bool loadSettings(void);
+    /**
+     * @brief Get the ETag of the settings last saved or loaded.
+     *
+     * @return **const char\*** The ETag; empty if there are no settings
+     */
+    const char* getSettingsETag(void) {
+        return _settingsETag;
+    }
+    /**
+     * @brief Measure the times of every sensor in the variable array with
+     * Sensor::calibrateTiming(), and save them to the `<logger id>_timing.txt`
+     * file on the SD card.
+     *
+     * The file holds a `timing.<code>` setting for each sensor calibrated,
+     * named for the code of its first variable.  The sensors are calibrated
+     * one at a time, each taking a few times as long as its update, so this
+     * is for a calibration mode of the sketch, like one started with the
+     * button, and not for the logging loop.
+     *
+     * @param marginPercent The margin added to each time measured, in
+     * percent; optional with a default of #MS_TIMING_MARGIN_PERCENT
+     * @param probeMeasurement False to keep the measurement times; optional
+     * with a default of true
+     * @return **uint8_t** The number of sensors calibrated
+     */
+    uint8_t calibrateSensorTiming(
+        uint8_t marginPercent = MS_TIMING_MARGIN_PERCENT,
+        bool    probeMeasurement = true);
+    /**
+     * @brief Set whether begin() applies the sensor times saved by
+     * calibrateSensorTiming().
+     *
+     * @param enable True to apply the saved times in begin()
+     */
+    void setTimingCache(bool enable = true) {
+        _timingCache = enable;
+    }
+    /**
+     * @brief Read the sensor times saved by calibrateSensorTiming() and apply
+     * them.
+     *
+     * @return **bool** True if saved times were found
+     */
+    bool loadSensorTiming(void);
+    /**
+     * @brief Set whether the logger saves what it has buffered in RAM when
+     * the watchdog is about to reset the board.
+     *
+     * The watchdog calls the logger shortly before the reset.  It then writes
+     * the records waiting in the SD card queue, syncs a log file kept open
+     * with setSDKeepOpen() and saves a checkpoint if checkpointing is on, so
+     * buffering records in RAM loses nothing to a lock-up.  If the logger was
+     * in the middle of writing to the card when it locked up, nothing is
+     * written, to keep from corrupting the card.
+     *
+     * This runs inside the watchdog interrupt, where millis() doesn't
+     * advance.  The waits for the card's power are made with busy loops and
+     * the file timestamps are not updated.  A card that no longer responds
+     * may keep the writes waiting until the reset.
+     *
+     * @param enable True to save the buffered data before a watchdog reset
+     * @param barksBeforeReset The number of 8 second barks of the watchdog
+     * left when the data is saved.  Default is 1, the last bark before the
+     * reset.
+     */
+    void setLastGasp(bool enable, uint8_t barksBeforeReset = 1);
+    /**
+     * @brief Give a phase of the logging cycle its own watchdog budget.
+     *
+     * With one reset time for the whole cycle, the watchdog must wait out the
+     * slowest phase, usually the modem attach, before it can see that any
+     * phase hung.  A phase with a budget resets the board once the budget runs
+     * out, however often the watchdog is fed in it.  For example, 60 seconds
+     * for #PHASE_MEASURE, 5 for #PHASE_SD_COMMIT and 90 for
+     * #PHASE_MODEM_ATTACH catch a hung sensor read in about a minute instead
+     * of the full reset time.  The phases without a budget keep using the
+     * reset time.  Budgets are counted in the 8 second barks of the watchdog,
+     * so they're rounded up to the next multiple of 8 seconds.
+     *
+     * When a budget runs out, begin() adds a line with the phase that
+     * overran to the `<logger id>_watchdog.txt` file on the SD card after the
+     * reset.  The phases are the ones marked for energy profiling (see
+     * markPhase()); they are marked whether or not `MS_PHASE_MARKER_PIN` is
+     * defined.
+     *
+     * @param phase The phase of the cycle
+     * @param budget_s The longest the phase may take in seconds; 0 to remove
+     * the budget
+     */
+    void setPhaseBudget(loggerCyclePhase phase, uint16_t budget_s) {
+        if (phase < PHASE_COUNT) _phaseBudget_s[phase] = budget_s;
+    }
+    /**
+     * @brief Set whether each publisher gets its own socket on the modem, so
+     * requests are sent to all of the publishers before any of the responses
+     * are read.
+     *
+     * This only works with modems that can hold several TCP connections open
+     * at once (see loggerModem::getMuxClient()), such as the SIM7080, SIM7000,
+     * BG96, and XBee3 LTE-M in bypass mode.  Publishers past the number of
+     * available sockets, and all publishers on other modems, use their own
+     * client as usual.  The server response times then overlap, instead of
+     * adding up.
+     *
+     * @param enableConcurrent True to give each publisher its own socket.
+     * Defaults to true.
+     */
+    void setConcurrentPublishing(bool enableConcurrent = true) {
+        _concurrentPublish = enableConcurrent;
+    }
+    /**
+     * @brief Get whether each publisher gets its own socket on the modem.
+     *
+     * @return **bool** True if concurrent publishing is enabled
+     */
+    bool getConcurrentPublishing() {
+        return _concurrentPublish;
+    }
+
+    /**
+     * @brief Register a data publisher object to receive data from the logger.
+     *
+     * @param publisher A dataPublisher object
+     */
+    void registerDataPublisher(dataPublisher* publisher);
+    /**
+     * @brief Publish data to all registered data publishers.
+     *
+     * Publishers that are not due on this logging interval (see
+     * dataPublisher::setSendFrequency()) save the record to their backlog
+     * instead.
+     */
+    void publishDataToRemotes(void);
+    /**
+     * @brief Check if any registered publisher is due to send on the current
+     * logging interval.
+     *
+     * @return **bool** True if at least one publisher is due to send
+     */
+    bool checkPublishersDue(void);
+    /**
+     * @brief Retained for backwards compatibility, use publishDataToRemotes()
+     * in new code.
+     *
+     * @m_deprecated_since{0,22,5}
+     */
+    void sendDataToRemotes(void);
+
+    /**
+     * @brief Set the limits on sending backlogged records after each
+     * successful publish.
+     *
+     * Backlogged records for a publisher are sent one at a time, oldest first,
+     * until the backlog is empty or one of the limits is reached.  Anything
+     * left is sent after the next successful publish.
+     *
+     * @param maxMillis The longest time in milliseconds to spend sending each
+     * publisher's backlog.  Default is 30000.
+     * @param maxBytes The most bytes of saved records to send from each
+     * publisher's backlog, or 0 for no limit.  Default is 0.
+     */
+    void setBacklogReplayBudget(uint32_t maxMillis, uint32_t maxBytes = 0) {
+        _backlogMaxMillis = maxMillis;
+        _backlogMaxBytes  = maxBytes;
+    }
+    /**
+     * @brief Set the budget of radio time and bytes for each publishing
+     * session.
+     *
+     * The publishers are sent in order of their priority (see
+     * dataPublisher::setPriority()).  The critical publishers, of priority 0,
+     * always send their records; everything else - the other publishers'
+     * records and every publisher's backlog - only goes out while some of the
+     * budget is left, counting from the first request of the session.  What's
+     * held back is saved to the backlogs and sent in a later session.
+     *
+     * The budget is halved when the signal is weaker than weakRSSI, since
+     * each byte then takes longer and more power to send, and halved again
+     * while the logger is in a low battery power tier (see addPowerTier()).
+     *
+     * @param maxMillis The most time in milliseconds for each session; 0 for
+     * no limit.
+     * @param maxBytes The most bytes to send in each session; 0 for no limit.
+     * Default is 0.
+     * @param weakRSSI The RSSI in dBm below which the budget is halved; 0 to
+     * never check the signal.  Default is -95.
+     */
+    void setPublishBudget(uint32_t maxMillis, uint32_t maxBytes = 0,
+                          int16_t weakRSSI = -95) {
+        _publishBudgetMillis = maxMillis;
+        _publishBudgetBytes  = maxBytes;
+        _publishWeakRSSI     = weakRSSI;
+    }
+
+    /**
+     * @brief Get the number of backlogged records in the batch currently
+     * being sent by dataPublisher::publishBatch().
+     *
+     * @return **uint8_t** The number of records in the batch; 0 if no batch
+     * is being sent.
+     */
+    uint8_t getBatchCount(void) {
+        return _batchCount;
+    }
+    /**
+     * @brief Get the local epoch time of a record in the batch being sent.
+     *
+     * @param record_k The position of the record in the batch
+     * @return **uint32_t** The local epoch time of the record
+     */
+    uint32_t getBatchTime(uint8_t record_k);
+    /**
+     * @brief Write a value from a record in the batch being sent into a
+     * character buffer, with the variable's decimal resolution.
+     *
+     * @param record_k The position of the record in the batch
+     * @param position_i The position of the variable in the array
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatBatchValueAtI(uint8_t record_k, uint8_t position_i,
+                               char* buffer, size_t bufferLen);
+    /**
+     * @brief Get the raw value of a variable from a record in the batch being
+     * sent.
+     *
+     * @param record_k The position of the record in the batch
+     * @param position_i The position of the variable in the array
+     * @return **float** The saved value, or -9999 if there is no such record
+     */
+    float getBatchValueAtI(uint8_t record_k, uint8_t position_i);
+    /**
+     * @brief Get the measurement offset of a variable from a record in the
+     * batch being sent.
+     *
+     * @param record_k The position of the record in the batch
+     * @param position_i The position of the variable in the array
+     * @return **int32_t** The saved offset in milliseconds, or 0 if there is
+     * no such record or the records don't hold the offsets
+     */
+    int32_t getBatchOffsetAtI(uint8_t record_k, uint8_t position_i);
+
+ protected:
+    /**
+     * @brief The longest time to spend sending each publisher's backlog
+     */
+    uint32_t _backlogMaxMillis = 30000L;
+    /**
+     * @brief The most bytes to send from each publisher's backlog
+     */
+    uint32_t _backlogMaxBytes = 0;
+    /**
+     * @brief The most time for each publishing session, in ms; 0 for no limit
+     */
+    uint32_t _publishBudgetMillis = 0;
+    /**
+     * @brief The most bytes for each publishing session; 0 for no limit
+     */
+    uint32_t _publishBudgetBytes = 0;
+    /**
+     * @brief The RSSI below which the budget is halved, in dBm; 0 to never
+     * check
+     */
+    int16_t _publishWeakRSSI = -95;
+    /**
+     * @brief True from the first request of a publishing session until the
+     * modem is done
+     */
+    bool _publishSessionOpen = false;
+    /**
+     * @brief The millis() the publishing session started
+     */
+    uint32_t _sessionStart_ms = 0;
+    /**
+     * @brief The total bytes sent by the publishers when the session started
+     */
+    uint32_t _sessionStartBytes = 0;
+    /**
+     * @brief The time budget of this session after any shrinking, in ms
+     */
+    uint32_t _sessionMillis = 0;
+    /**
+     * @brief The byte budget of this session after any shrinking
+     */
+    uint32_t _sessionBytes = 0;
+    /**
+     * @brief Start counting a publishing session against the budget, unless
+     * one is already open.
+     *
+     * This works out the session's budget from the signal and the power
+     * tier.
+     */
+    void startPublishSession(void);
+    /**
+     * @brief Check if any of the publishing session's budget is left.
+     *
+     * @return **bool** True if there's time and bytes left, or there is no
+     * budget
+     */
+    bool isPublishBudgetLeft(void);
+    /**
+     * @brief List the positions of the publishers in the order they're sent,
+     * by priority and then by when they were registered.
+     *
+     * @param order The array of #MAX_NUMBER_SENDERS positions to fill
+     */
+    void getPublishOrder(uint8_t* order);
+    /**
+     * @brief The backlog file holding the batch being sent, if any
+     */
+    File* _batchFile = nullptr;
+    /**
+     * @brief The offset in the backlog file of the first record in the batch
+     */
+    uint32_t _batchOffset = 0;
+    /**
+     * @brief The number of records in the batch being sent
+     */
+    uint8_t _batchCount = 0;
+    /**
+     * @brief Check the CRC of a binary data record.
+     *
+     * @param record A record written by formatSensorDataBinary()
+     * @return **bool** True if the CRC matches the data
+     */
+    bool checkBinaryRecord(const uint8_t* record);
+    /**
+     * @brief Write the name of the backlog file for a publisher into a
+     * buffer.
+     *
+     * @param publisherNum The position of the publisher in the logger
+     * @param buffer The buffer for the name, of #MS_FILE_NAME_SIZE
+     */
+    void getBacklogFileName(uint8_t publisherNum, char* buffer);
+    /**
+     * @brief Save the current record to the end of a publisher's backlog.
+     *
+     * @param publisherNum The position of the publisher in the logger
+     * @return **bool** True if the record was saved
+     */
+    bool appendToBacklog(uint8_t publisherNum);
+    /**
+     * @brief Send as much of a publisher's backlog as the budget allows.
+     *
+     * @param publisherNum The position of the publisher in the logger
+     */
+    void replayBacklog(uint8_t publisherNum);
+    /**
+     * @brief Get the number of the current logging interval since the epoch,
+     * from the marked time.
+     *
+     * @return **uint32_t** The logging interval number
+     */
+    uint32_t getIntervalNumber(void);
+    /**
+     * @brief Check if a publisher should send the current record.
+     *
+     * During an event the publisher sends every record if the event publishes
+     * immediately.  Otherwise it only sends on the normal logging intervals,
+     * by its own schedule.
+     *
+     * @param publisherNum The position of the publisher
+     * @param intervalNumber The number of the normal logging interval
+     * @return **bool** True if the publisher should send
+     */
+    bool isPublisherDue(uint8_t publisherNum, uint32_t intervalNumber);
+    /**
+     * @brief Get the logging interval currently in use.
+     *
+     * @return **uint32_t** The stretched interval in a power tier, the event
+     * interval during an event, otherwise the normal logging interval, in
+     * seconds
+     */
+    uint32_t getActiveIntervalSeconds(void) {
+        if (_powerTier >= 0) {
+            return _loggingIntervalSeconds *
+                _powerTiers[_powerTier].intervalMultiplier;
+        }
+        return _eventActive ? _eventIntervalSeconds : _loggingIntervalSeconds;
+    }
+    /**
+     * @brief Pick the power tier from the newest battery voltage, and suspend
+     * or resume the sheddable sensors to match.
+     *
+     * This is called once after each complete sensor update.
+     */
+    void checkPowerTier(void);
+    /**
+     * @brief Check whether the current power tier leaves the modem off.
+     *
+     * @return **bool** True if the modem should not be used
+     */
+    bool isModemShed(void) {
+        return _powerTier >= 0 && _powerTiers[_powerTier].modemOff;
+    }
+    /**
+     * @brief Get the time left in the current cycle's budget.
+     *
+     * @return **uint32_t** The time left in milliseconds; 0 if the budget is
+     * spent, or 0xFFFFFFFF if there is no budget.
+     */
+    uint32_t getCycleTimeLeft(void);
+    /**
+     * @brief Give the sensor update the cycle's budget, less the time kept
+     * for writing the record.
+     */
+    void budgetSensorUpdate(void);
+    /**
+     * @brief Check the triggers against the newest values and start, extend,
+     * or end an event.
+     *
+     * This is called once after each complete sensor update.
+     */
+    void checkTriggers(void);
+    /**
+     * @brief Add the newest values to the histories.
+     *
+     * This is called once after each complete sensor update.
+     */
+    void recordHistories(void);
+    /**
+     * @brief Save the record to a publisher's backlog if it could not be
+     * sent, or send the backlog if it was.
+     *
+     * @param publisherNum The position of the publisher in the logger
+     * @param response The result of publishing the record
+     */
+    void handlePublishResult(uint8_t publisherNum, int16_t response);
+    /**
+     * @brief Save the current record to the backlog of each publisher that
+     * will not be sending it now.
+     *
+     * @param includeDue True to also save the record for the publishers that
+     * are due but could not be reached; false for only the publishers that
+     * are waiting for a later interval.
+     */
+    void saveUnsentRecords(bool includeDue);
+    /**
+     * @brief Send the backlog of each due publisher that has one, for a
+     * logger publishing its records one interval late.
+     *
+     * Called from waitAndPollModem() once the modem connects during the sensor
+     * update, or after the update if it didn't.
+     */
+    void sendDueBacklogs(void);
+    /**
+     * @brief Make a saved binary record the current record, so the
+     * publishers send its time and values instead of the live ones.
+     *
+     * @param record A record written by formatSensorDataBinary(), with its CRC
+     * already checked
+     * @return **bool** True if all of the values fit in the record buffer.
+     */
+    bool loadBinaryRecord(const uint8_t* record);
+    /**
+     * @brief Connect the modem to the internet, trying the network it last
+     * registered on first.
+     *
+     * The last network is read from the SD card the first time this is called
+     * and saved again whenever the modem registers on a different one; see
+     * loggerModem::setNetworkHint().
+     *
+     * @param maxConnectionTime The longest time to wait for a connection, in
+     * milliseconds
+     * @return **bool** True if the modem connected
+     */
+    bool connectModemInternet(uint32_t maxConnectionTime = 50000L);
+    /**
+     * @brief Read the last network of the modem from the SD card, or the
+     * persistent store, the first time this is called.
+     */
+    void loadNetworkHint(void);
+    /**
+     * @brief Save the network of the modem to the SD card, or the persistent
+     * store, if it registered on a different one.
+     */
+    void saveNetworkHint(void);
+#if defined(MS_MODEM_PROFILE_AT)
+    /**
+     * @brief Add the AT command profile of the modem's last cycle to the
+     * `<logger id>_atprofile.txt` file on the SD card.
+     */
+    void saveModemProfile(void);
+#endif
+#if defined(MS_TRACE_BUFFER_SIZE)
+    /**
+     * @brief Add the UpdateTracer events of this cycle to the
+     * `<logger id>_trace.txt` file on the SD card, and clear them.
+     *
+     * The events are followed by a line of `values` and the value of each
+     * variable, so a TraceReplaySensor can replay the cycle.
+     */
+    void saveUpdateTrace(void);
+#endif
+    /**
+     * @brief Stream readings until the button is pressed or the time set in
+     * setStreamingMode() runs out.
+     *
+     * @param connected True if the modem is connected, so the frames can be
+     * sent to the streaming client
+     */
+    void streamReadings(bool connected);
+    /**
+     * @brief Write the streaming frame of the current values into a buffer.
+     *
+     * @param buffer The buffer to write to
+     * @param bufferLen The size of the buffer
+     * @param elapsed_ms The milliseconds since streaming began
+     * @return **size_t** The bytes written, or 0 if the frame did not fit.
+     */
+    size_t formatStreamFrame(uint8_t* buffer, size_t bufferLen,
+                             uint32_t elapsed_ms);
+    /**
+     * @brief True to stream readings in testing mode
+     */
+    bool _streaming = false;
+    /**
+     * @brief The format of the streamed frames; a streamFormat
+     */
+    uint8_t _streamFormat = streamCSV;
+    /**
+     * @brief The longest time to stream, in seconds; 0 for no limit
+     */
+    uint32_t _streamMaxSeconds = 600;
+    /**
+     * @brief The client the streamed frames are also sent to
+     */
+    Client* _streamClient = nullptr;
+    /**
+     * @brief The host the streaming client connects to
+     */
+    const char* _streamHost = nullptr;
+    /**
+     * @brief The port the streaming client connects to
+     */
+    uint16_t _streamPort = 0;
+    /**
+     * @brief Mark the start of a phase of the logging cycle.
+     *
+     * When `MS_PHASE_MARKER_PIN` is defined, this toggles that pin, so an
+     * external current logger recording it can split its trace into the
+     * phases, and notes the millis() the phase started.  It also starts the
+     * watchdog budget of the phase set with setPhaseBudget(), or ends the
+     * budget of the last phase.
+     *
+     * @param phase The phase starting
+     */
+    void markPhase(loggerCyclePhase phase);
+    /**
+     * @brief The watchdog budget of each phase of the cycle in seconds; 0 for
+     * none
+     */
+    uint16_t _phaseBudget_s[PHASE_COUNT] = {};
+    /**
+     * @brief Add a line to the `<logger id>_watchdog.txt` file on the SD card
+     * if the watchdog reset the board because a phase overran its budget.
+     */
+    void saveWatchdogOverrun(void);
+#if defined(MS_PHASE_MARKER_PIN)
+    /**
+     * @brief Add the duration of each phase of this cycle to the
+     * `<logger id>_phases.csv` file on the SD card.
+     *
+     * The phases not marked in the cycle are left empty.  Run the
+     * `extras/cycle_energy/ms_phase_energy.py` script on this file and the
+     * current logger's trace to get the energy of each phase.
+     */
+    void savePhaseTimes(void);
+    /**
+     * @brief The millis() each phase of this cycle started
+     */
+    uint32_t _phaseStart[PHASE_COUNT];
+    /**
+     * @brief A bit for each phase marked in this cycle
+     */
+    uint8_t _phasesMarked = 0;
+    /**
+     * @brief The level the marker pin was last set to
+     */
+    bool _phaseMarkerHigh = false;
+#endif
+    /**
+     * @brief Poll the modem until the connection started before the sensor
+     * update is finished.
+     *
+     * @param maxWait The longest time to keep polling, in milliseconds
+     * @return **bool** True if the modem connected
+     */
+    bool finishModemConnect(uint32_t maxWait);
+    /**
+     * @brief Reset the watchdog and poll the modem being brought up, if any.
+     *
+     * This is the wait function given to Sensor::setWaitCallback(), so the
+     * modem moves through its connection steps while the sensors are waited
+     * on.
+     */
+    static void waitAndPollModem(void);
+    /**
+     * @brief The modem being brought up during the sensor update, polled
+     * while waiting on the sensors; nullptr if none.
+     */
+    static loggerModem* _pollingModem;
+    /**
+     * @brief The logger with a record waiting to be committed from the wait
+     * function; nullptr if none.
+     */
+    static Logger* _committingLogger;
+    /**
+     * @brief The logger waiting to send its backlogs from the wait function
+     * once the modem connects; nullptr if none.
+     */
+    static Logger* _laggingLogger;
+    /**
+     * @brief Switch the SD card on and leave the record to be committed from
+     * the wait function once the card has settled.
+     */
+    void startSDCommit(void);
+    /**
+     * @brief Commit the record waiting from startSDCommit(), if the card has
+     * settled.
+     *
+     * Called from waitAndPollModem().
+     */
+    void stepSDCommit(void);
+    /**
+     * @brief Commit the record waiting from startSDCommit() now, if it hasn't
+     * been written yet.
+     */
+    void finishSDCommit(void);
+    /**
+     * @brief Save everything the logger has buffered in RAM before the
+     * watchdog resets the board.
+     *
+     * This is the early warning given to the watchdog; it runs inside the
+     * watchdog interrupt.
+     */
+    static void lastGasp(void);
+    /**
+     * @brief The logger saved by lastGasp(); nullptr if none.
+     */
+    static Logger* _lastGaspLogger;
+    /**
+     * @brief True while lastGasp() runs, so the SD card power waits use busy
+     * loops and the file timestamps are left alone.
+     */
+    static volatile bool _inLastGasp;
+    /**
+     * @brief The number of SD card operations in progress.
+     */
+    static volatile uint8_t _sdBusy;
+    /**
+     * @brief The number of SD card operations in progress that write.
+     */
+    static volatile uint8_t _sdWriting;
+    /**
+     * @brief The millis() the last SD card operation that writes finished,
+     * which the card's housekeeping counts from.
+     */
+    static volatile uint32_t _sdLastWrite_ms;
+    /**
+     * @brief Marks the SD card as in use while in scope, so lastGasp() never
+     * writes to it in the middle of another write, and tracks the time of the
+     * last write for the card's housekeeping.
+     */
+    struct sdBusyGuard {
+        explicit sdBusyGuard(bool writes = true) : _writes(writes) {
+            _sdBusy = _sdBusy + 1;
+            if (_writes) _sdWriting = _sdWriting + 1;
+        }
+        ~sdBusyGuard() {
+            _sdBusy = _sdBusy - 1;
+            if (_writes) {
+                _sdWriting      = _sdWriting - 1;
+                _sdLastWrite_ms = millis();
+            }
+        }
+        bool _writes;
+    };
+    /**
+     * @brief Add the time of an SD card operation to its histogram.
+     *
+     * This does nothing unless `MS_SD_LATENCY_STATS` is defined.
+     *
+     * @param op The operation
+     * @param start_ms The millis() the operation started
+     * @param success True if the operation succeeded; the time of a failure
+     * is counted too
+     */
+#if defined(MS_SD_LATENCY_STATS)
+    static void recordSDLatency(sdOperation op, uint32_t start_ms,
+                                bool success);
+#else
+    static void recordSDLatency(sdOperation, uint32_t, bool) {}
+#endif
+#if defined(MS_SD_LATENCY_STATS)
+    /**
+     * @brief The count of operations in each latency bucket, halved whenever
+     * one would overflow
+     */
+    static uint16_t _sdLatencyHist[SD_OP_COUNT][MS_SD_LATENCY_BUCKETS];
+    /**
+     * @brief The longest time of each operation in milliseconds
+     */
+    static uint32_t _sdWorstLatency_ms[SD_OP_COUNT];
+    /**
+     * @brief The failures of each operation
+     */
+    static uint16_t _sdFailures[SD_OP_COUNT];
+    /**
+     * @brief The writes of queued records retried after a failure
+     */
+    static uint16_t _sdRetries;
+    /**
+     * @brief True if the last write of the queued records failed
+     */
+    static bool _sdFlushFailed;
+#endif
+    /**
+     * @brief Wait on the SD card, idling the processor, or with busy loops
+     * inside the watchdog interrupt.
+     *
+     * @param wait_ms The time to wait in milliseconds
+     */
+    void waitForSDcard(uint32_t wait_ms);
+    /**
+     * @brief Save the checkpoint for the record just logged.
+     */
+    void saveCheckpoint(void);
+    /**
+     * @brief Restore the state from the checkpoint on the SD card, or in the
+     * persistent store, if there is a recent one.
+     *
+     * @return **bool** True if the state was restored
+     */
+    bool loadCheckpoint(void);
+    /**
+     * @brief Write a value to the persistent store, starting the SD card
+     * first if the store is on it.
+     *
+     * @param key The key of the value
+     * @param data The value
+     * @param len The bytes of the value
+     * @return **bool** True if the value was stored
+     */
+    bool storeWrite(uint8_t key, const void* data, uint8_t len);
+    /**
+     * @brief Read a value from the persistent store, starting the SD card
+     * first if the store is on it.
+     *
+     * @param key The key of the value
+     * @param data The buffer for the value
+     * @param len The bytes of the value
+     * @return **bool** True if a value of exactly that size was read
+     */
+    bool storeRead(uint8_t key, void* data, uint8_t len);
+
+    /**
+     * @brief The internal modem instance
+     *
+     * @note The internal #_logModem must be a POINTER not a reference because
+     * it is possible for no modem to be attached (and thus the pointer could be
+     * null).  It is not possible to have a null reference.
+     */
+    loggerModem* _logModem = nullptr;
+    // ^^ Start with no modem attached
+    /**
+     * @brief True to wake the modem before the sensors are updated
+     */
+    bool _pipelineModem = false;
+    /**
+     * @brief True to write the record while a pipelined modem connects
+     */
+    bool _overlapSDCommit = false;
+    /**
+     * @brief True to publish each record during the next sensor update
+     */
+    bool _publishLag = false;
+    /**
+     * @brief True while this cycle's due backlog publishers are sent late
+     */
+    bool _lagging = false;
+    /**
+     * @brief True once this cycle's due backlogs have been sent
+     */
+    bool _laggedSent = false;
+    /**
+     * @brief True while a record is waiting to be committed from the wait
+     * function
+     */
+    bool _sdCommitPending = false;
+    /**
+     * @brief The time budget of each logging cycle in milliseconds; 0 for no
+     * limit
+     */
+    uint32_t _cycleBudget_ms = 0;
+    /**
+     * @brief The millis() the current logging cycle started
+     */
+    uint32_t _cycleStart_ms = 0;
+    /**
+     * @brief The weakest RSSI to publish at, in dBm; 0 to always publish
+     */
+    int16_t _minPublishRSSI = 0;
+    /**
+     * @brief The most cycles in a row publishing is held back for a weak
+     * signal
+     */
+    uint8_t _maxSignalDeferrals = 12;
+    /**
+     * @brief The longest the oldest held back record waits, in seconds
+     */
+    uint32_t _maxDeferredAge = 21600L;
+    /**
+     * @brief The number of cycles in a row publishing has been held back
+     */
+    uint8_t _signalDeferrals = 0;
+    /**
+     * @brief The UTC epoch time of the first record held back
+     */
+    uint32_t _firstDeferredUTC = 0;
+    /**
+     * @brief Check the signal once the modem is connected, and decide
+     * whether to hold publishing back for a better one.
+     *
+     * @return **bool** True if the publishers should not send this cycle
+     */
+    bool isSignalTooWeak(void);
+    /**
+     * @brief True to save a checkpoint after each record
+     */
+    bool _checkpointing = false;
+    /**
+     * @brief The persistent store for the checkpoint and the network hint;
+     * nullptr to keep them in files on the SD card
+     */
+    PersistentStore* _store = nullptr;
+    /**
+     * @brief True if begin() resumed from a checkpoint
+     */
+    bool _resumed = false;
+    /**
+     * @brief True to give each publisher its own socket on the modem
+     */
+    bool _concurrentPublish = false;
+    /**
+     * @brief True once the last network has been read from the SD card
+     */
+    bool _networkHintLoaded = false;
+    /**
+     * @brief True to apply the saved settings in begin()
+     */
+    bool _settingsCache = false;
     /**
-     * @brief Use the attahed loggerModem to synchronize the real-time clock
-     * with NIST time servers.
-     *
-     * @return **bool** True if clock synchronization was successful
+     * @brief True to apply the saved sensor times in begin()
      */
-    bool syncRTC();
-
+    bool _timingCache = false;
     /**
-     * @brief Register a data publisher object to receive data from the logger.
-     *
-     * @param publisher A dataPublisher object
+     * @brief The ETag of the settings last saved or loaded
      */
-    void registerDataPublisher(dataPublisher* publisher);
+    char _settingsETag[MS_SETTINGS_ETAG_SIZE] = "";
+
     /**
-     * @brief Publish data to all registered data publishers.
+     * @brief An array of all of the attached data publishers
      */
-    void publishDataToRemotes(void);
+    dataPublisher* dataPublishers[MAX_NUMBER_SENDERS];
     /**
-     * @brief Retained for backwards compatibility, use publishDataToRemotes()
-     * in new code.
-     *
-     * @m_deprecated_since{0,22,5}
+     * @brief The variable array each publisher sends; 0 for the main array
      */
-    void sendDataToRemotes(void);
+    uint8_t _publisherArrays[MAX_NUMBER_SENDERS] = {};
 
- protected:
     /**
-     * @brief The internal modem instance
+     * @brief Check if a publisher is registered and sends the records of the
+     * selected variable array.
      *
-     * @note The internal #_logModem must be a POINTER not a reference because
-     * it is possible for no modem to be attached (and thus the pointer could be
-     * null).  It is not possible to have a null reference.
+     * @param publisherNum The position of the publisher
+     * @return **bool** True if the publisher sends the selected array
      */
-    loggerModem* _logModem = nullptr;
-    // ^^ Start with no modem attached
-
+    bool isPublisherInArray(uint8_t publisherNum) {
+        return dataPublishers[publisherNum] != nullptr &&
+            _publisherArrays[publisherNum] == _activeArray;
+    }
     /**
-     * @brief An array of all of the attached data publishers
+     * @brief Publish the records of each variable array due at the marked
+     * time, in the one modem session.
      */
-    dataPublisher* dataPublishers[MAX_NUMBER_SENDERS];
+    void publishDueArrays(void);
     /**@}*/
 
     // ===================================================================== //
@@ -729,6 +2777,54 @@ class Logger {
      */
     static void setNowUTCEpoch(uint32_t ts);
 
+    /**
+     * @brief Get the current UTC epoch time from the cycle clock.
+     *
+     * The cycle clock reads the RTC once per wake and counts on from millis()
+     * after that, so the many timestamps needed in each logging cycle don't
+     * each cost a transaction with the RTC.  When the processor is woken by
+     * the RTC alarm, the clock starts at the alarm time, so it also knows
+     * where each second begins, without reading the RTC at all; the RTC is
+     * only read to check it when the time is marked for a record.  The clock
+     * is checked against the RTC again after #MS_CYCLE_CLOCK_CHECK_MS and
+     * kept if it still agrees.
+     *
+     * Anything comparing the clock to an outside time, such as a clock sync,
+     * should use getNowUTCEpoch() instead.
+     *
+     * @return **uint32_t**  The number of seconds from 1970-01-01T00:00:00Z0000
+     */
+    static uint32_t getCycleUTCEpoch(void);
+    /**
+     * @brief Get the current epoch time from the cycle clock, corrected to
+     * the logging time zone.
+     *
+     * @return **uint32_t**  The number of seconds from January 1, 1970 in the
+     * logging time zone.
+     */
+    static uint32_t getCycleLocalEpoch(void);
+    /**
+     * @brief Get the current UTC time from the cycle clock, to the
+     * millisecond if the clock knows where the second started.
+     *
+     * The clock knows where the second started when the processor was woken
+     * by the RTC alarm, when it waited for the RTC to tick over, or when the
+     * RTC was set with setRTClockPhase().  This has the signature of a
+     * NodeLink::setTimeSource() function.
+     *
+     * @param epoch The number of seconds from 1970-01-01T00:00:00Z0000
+     * @param msIntoSecond The milliseconds into that second; 0 if unknown
+     * @return **bool** True if the milliseconds are known
+     */
+    static bool getCycleUTCTime(uint32_t& epoch, uint16_t& msIntoSecond);
+    /**
+     * @brief Check the cycle clock against the RTC now.
+     *
+     * The cycle clock keeps its place within the second if the RTC agrees
+     * with it; otherwise it restarts from the RTC time.
+     */
+    static void refreshCycleClock(void);
+
     /**
      * @brief Convert the number of seconds from January 1, 1970 to a DateTime
      * object instance.
@@ -738,6 +2834,37 @@ class Logger {
      */
     static DateTime dtFromEpoch(uint32_t epochTime);
 
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Convert a date-time object into a ISO8601 formatted string.
+     *
+     * This assumes the supplied date/time is in the LOGGER's timezone and adds
+     * the LOGGER's offset as the time zone offset in the string.
+     *
+     * @note With the build flag `MS_NO_STRING`, the text is in a buffer that
+     * the next call writes over; use the version with a buffer to keep it.
+     * Otherwise this returns a String.
+     *
+     * @param dt A DateTime object to convert
+     * @return **const char\*** An ISO8601 formatted string.
+     */
+    static const char* formatDateTime_ISO8601(DateTime& dt);
+
+    /**
+     * @brief Convert an epoch time (unix time) into a ISO8601 formatted string.
+     *
+     * This assumes the supplied date/time is in the LOGGER's timezone and adds
+     * the LOGGER's offset as the time zone offset in the string.
+     *
+     * @note With the build flag `MS_NO_STRING`, the text is in a buffer that
+     * the next call writes over; use the version with a buffer to keep it.
+     * Otherwise this returns a String.
+     *
+     * @param epochTime The number of seconds since 1970.
+     * @return **const char\*** An ISO8601 formatted string.
+     */
+    static const char* formatDateTime_ISO8601(uint32_t epochTime);
+#else
     /**
      * @brief Convert a date-time object into a ISO8601 formatted string.
      *
@@ -759,6 +2886,24 @@ class Logger {
      * @return **String** An ISO8601 formatted String.
      */
     static String formatDateTime_ISO8601(uint32_t epochTime);
+#endif
+    /**
+     * @brief Write an epoch time (unix time) into a character buffer as an
+     * ISO8601 formatted string, without creating any String objects.
+     *
+     * This assumes the supplied date/time is in the LOGGER's timezone and adds
+     * the LOGGER's offset as the time zone offset in the string.
+     *
+     * @param epochTime The number of seconds since 1970.
+     * @param buffer The buffer to write the string into; it should hold at
+     * least #MS_ISO8601_BUFFER_SIZE characters.
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    static size_t formatDateTime_ISO8601(uint32_t epochTime, char* buffer,
+                                         size_t bufferLen);
 
     /**
      * @brief Veify that the input value is sane and if so sets the real time
@@ -769,6 +2914,62 @@ class Logger {
      * the clock has been successfully set.
      */
     bool setRTClock(uint32_t UTCEpochSeconds);
+    /**
+     * @brief Set the real time clock so that each of its seconds starts when
+     * it does at a time source known to the millisecond.
+     *
+     * setRTClock() is called first to track the drift and set the seconds.
+     * Then, if the start of the RTC's second is more than the tolerance from
+     * the source's, this waits for the source's next second to start and sets
+     * the RTC to it.  Writing the seconds restarts the count within the second
+     * on a DS3231, so loggers set from the same source take their readings
+     * within a few tens of milliseconds of each other.  The SAMD's internal
+     * RTC doesn't restart its count, so the difference there can be up to a
+     * second.
+     *
+     * @param UTCEpochSeconds The current number of seconds since 1970 in UTC.
+     * @param msIntoSecond The milliseconds into that second
+     * @param tolerance_ms How far apart the starts of the seconds may be.
+     * Default is #MS_CLOCK_PHASE_TOLERANCE_MS.
+     * @return **bool** True if the clock was set
+     */
+    bool setRTClockPhase(uint32_t UTCEpochSeconds, uint16_t msIntoSecond,
+                         uint16_t tolerance_ms = MS_CLOCK_PHASE_TOLERANCE_MS);
+    /**
+     * @brief Set how far the clock may drift before it is synced again.
+     *
+     * Each time setRTClock() is called, the logger compares the RTC to the
+     * true time.  Once two syncs are at least #MS_MIN_DRIFT_WINDOW apart, it
+     * estimates how fast the RTC drifts and steps the clock to cancel the
+     * drift at each logging interval.  Instead of every day at noon, the
+     * clock is then synced when the error left after that correction could
+     * have grown past the tolerance, or after the most days between syncs.
+     *
+     * @param maxErrorSeconds The largest predicted clock error, in seconds.
+     * Default is 5.
+     * @param maxDaysBetween The most days between syncs.  Default is 30.
+     */
+    void setClockSyncTolerance(uint16_t maxErrorSeconds,
+                               uint16_t maxDaysBetween = 30);
+    /**
+     * @brief Get the estimated drift of the RTC.
+     *
+     * @return **float** The drift in parts per million; positive if the RTC
+     * runs fast.  0 if the drift has not been estimated yet.
+     */
+    float getClockDriftPPM(void) {
+        return _driftPPM;
+    }
+    /**
+     * @brief Check whether the clock should be synced in this logging
+     * interval.
+     *
+     * Until the drift has been estimated, the clock is synced every day at
+     * noon, as well as whenever the RTC is not sane.
+     *
+     * @return **bool** True if the clock should be synced now
+     */
+    bool isClockSyncDue(void);
 
     /**
      * @brief Check that the current time on the RTC is within a "sane" range.
@@ -805,8 +3006,11 @@ class Logger {
     /**
      * @brief Check if the CURRENT time is an even interval of the logging rate
      *
+     * This also notes which of the variable arrays added with
+     * addVariableArray() are due.
+     *
      * @return **bool** True if the current time on the RTC is an even interval
-     * of the logging rate.
+     * of the logging rate, or of the interval of any of the added arrays.
      */
     bool checkInterval(void);
 
@@ -819,55 +3023,404 @@ class Logger {
      * printing, etc) have the same timestamp even though the update routine may
      * take several (or many) seconds.
      *
-     * @return **bool** True if the marked time is an even interval of the
-     * logging rate.
+     * @return **bool** True if the marked time is an even interval of the
+     * logging rate.
+     */
+    bool checkMarkedInterval(void);
+    /**
+     * @brief Get the time of the next even interval of the logging rate after
+     * the current time.
+     *
+     * @return **uint32_t** The next interval as a timestamp of the RTC itself
+     * (ie, without the RTC offset applied), which is what the RTC alarms
+     * match on.
+     */
+    uint32_t getNextIntervalRTCEpoch(void);
+    /**
+     * @brief Get the time the next of the variable arrays added with
+     * addVariableArray() is due after the current time.
+     *
+     * @return **uint32_t** The next interval of any of the added arrays as a
+     * timestamp of the RTC itself; 0 if no arrays were added
+     */
+    uint32_t getNextArraysRTCEpoch(void);
+
+ protected:
+    /**
+     * @brief The static timezone data is being logged in.
+     *
+     * @note All logger objects, if multiple are used, will be in the same
+     * timezone.
+     */
+    static int8_t _loggerTimeZone;
+    /**
+     * @brief The static difference between the timezone of the RTC and the
+     * timezone data is being logged in.
+     *
+     * @note All logger objects, if multiple are used, will be will have the
+     * same offset.
+     */
+    static int8_t _loggerRTCOffset;
+    /**
+     * @brief The millis() the processor last woke up, or 0 for boot.
+     */
+    static uint32_t _wakeMillis;
+    /**
+     * @brief How long the processor was awake before it last went to sleep.
+     */
+    static uint32_t _lastAwakeTime_ms;
+    /**
+     * @brief How long the processor slept the last time it went to sleep.
+     */
+    static uint32_t _lastSleepTime_s;
+    /**
+     * @brief Start the cycle clock at a known time.
+     *
+     * @param epochTime The RTC time to start at
+     * @param startMillis The millis() at that time
+     */
+    static void setCycleClock(uint32_t epochTime, uint32_t startMillis);
+    /**
+     * @brief The RTC time the cycle clock counts on from; 0 if it needs to be
+     * read again.
+     */
+    static uint32_t _cycleEpoch;
+    /**
+     * @brief The millis() at #_cycleEpoch.
+     */
+    static uint32_t _cycleMillis;
+    /**
+     * @brief The millis() the cycle clock was last checked against the RTC.
+     */
+    static uint32_t _cycleCheckMillis;
+    /**
+     * @brief True if the cycle clock was started from the alarm time and
+     * hasn't been checked against the RTC since.
+     */
+    static bool _cycleFromAlarm;
+    /**
+     * @brief True if the cycle clock knows where each second of the RTC
+     * starts.
+     */
+    static bool _cyclePhaseKnown;
+    /**
+     * @brief Step the RTC by the drift predicted since the last clock sync,
+     * one second at a time.
+     *
+     * This is called right after the time is marked for a logging interval,
+     * so the step doesn't move the interval itself.
+     */
+    void correctClockDrift(void);
+    /**
+     * @brief The UTC time of the first clock sync the drift is measured from
+     */
+    uint32_t _driftRefUTC = 0;
+    /**
+     * @brief The error of the RTC at #_driftRefUTC plus the total seconds it
+     * has been stepped since, so the drift is the current error less this
+     */
+    int32_t _driftAdjusted = 0;
+    /**
+     * @brief The UTC time of the last clock sync
+     */
+    uint32_t _lastSyncUTC = 0;
+    /**
+     * @brief The seconds the RTC has been stepped for drift since the last
+     * clock sync
+     */
+    int32_t _driftStepped = 0;
+    /**
+     * @brief The estimated drift of the RTC in parts per million
+     */
+    float _driftPPM = 0;
+    /**
+     * @brief The uncertainty of the drift estimate in parts per million
+     */
+    float _driftUncertaintyPPM = 0;
+    /**
+     * @brief The largest predicted clock error before a sync, in seconds
+     */
+    uint16_t _syncMaxError = 5;
+    /**
+     * @brief The most days between clock syncs
+     */
+    uint16_t _syncMaxDays = 30;
+    /**@}*/
+
+    // ===================================================================== //
+    /**
+     * @anchor logger_sleep
+     * @name Clock and Timezones
+     * Public Functions for sleeping the logger
+     */
+    /**@{*/
+    // ===================================================================== //
+
+ public:
+    /**
+     * @brief Set up the Interrupt Service Request for waking
+     *
+     * In this case, we're doing nothing, we just want the processor to wake.
+     * This must be a static function (which means it can only call other static
+     * funcions.)
+     */
+    static void wakeISR(void);
+    /**
+     * @brief End the current sleep from an interrupt.
+     *
+     * systemSleep() puts the processor straight back to sleep after any
+     * interrupt other than the RTC alarm or the testing button, without
+     * touching the RTC or anything else.  Call this from your own interrupt
+     * service routine if that interrupt needs the logger awake.
+     */
+    static void requestWake(void) {
+        _wakeRequested = true;
+    }
+
+    /**
+     * @brief Put the mcu to sleep to conserve battery life and handle
+     * post-interrupt wake actions
+     *
+     * The RTC alarm is set for the next even interval of this logger's
+     * logging rate, so the processor doesn't wake in between.  With more than
+     * one logger, sleep using the logger with the shortest interval, and make
+     * the other intervals multiples of it.  Any other interrupt that wakes
+     * the processor, except the testing button and requestWake(), just sends
+     * it back to sleep.
+     *
+     * @note This DOES NOT sleep or wake the sensors!!
+     */
+    void systemSleep(void);
+    /**
+     * @brief Set whether the logger wakes ahead of each interval to warm up
+     * the sensors.
+     *
+     * Without this, the sensors are only powered once the logger wakes at the
+     * interval, so a record is stamped with the interval but measured after
+     * the longest warm-up and stabilization time, which can be 10 to 30
+     * seconds for a sonde with a wiper.  With it, systemSleep() sets the
+     * alarm that much earlier, in whole seconds, and logData() and
+     * logDataAndPublish() power and wake the sensors so they are stable right
+     * at the interval.  The measurements then start at the marked time.
+     *
+     * The lead time is found from the sensors due in the next update each
+     * time the logger goes to sleep.  If it is as long as the logging
+     * interval, the logger doesn't sleep between records at all.
+     *
+     * @param preWarm True to warm up the sensors ahead of each interval.
+     * Default is false.
+     */
+    void setPreWarm(bool preWarm) {
+        _preWarm = preWarm;
+    }
+
+ protected:
+    /**
+     * @brief True to warm up the sensors ahead of each interval
+     */
+    bool _preWarm = false;
+    /**
+     * @brief Get the whole seconds ahead of the next interval to wake, to
+     * warm up the sensors due in it.
+     *
+     * @return **uint32_t** The lead time; 0 unless setPreWarm() is on
+     */
+    uint32_t getPreWarmLead(void);
+    /**
+     * @brief Warm up the sensors for the next interval, if the logger has
+     * woken ahead of it to do that, and wait for the interval.
+     */
+    void preWarmForInterval(void);
+    /**
+     * @brief True once the RTC alarm set by systemSleep() has fired
+     */
+    static volatile bool _alarmFired;
+    /**
+     * @brief True once requestWake() has been called during a sleep
+     */
+    static volatile bool _wakeRequested;
+    /**
+     * @brief Check whether the processor should stay awake after an
+     * interrupt wakes it.
+     *
+     * @return **bool** True after the alarm, the testing button or
+     * requestWake()
+     */
+    static bool isWakeDue(void) {
+        return _alarmFired || _wakeRequested || Logger::startTesting;
+    }
+
+ public:
+    /**
+     * @brief Get how long the processor was awake before it last went to
+     * sleep.
+     *
+     * @return **uint32_t** The awake time in milliseconds, or 0 before the
+     * first sleep
+     */
+    static uint32_t getLastAwakeTime(void) {
+        return _lastAwakeTime_ms;
+    }
+    /**
+     * @brief Get how long the processor slept the last time it went to sleep,
+     * by the RTC.
+     *
+     * @return **uint32_t** The sleep time in seconds
+     */
+    static uint32_t getLastSleepTime(void) {
+        return _lastSleepTime_s;
+    }
+
+#if defined(MS_SD_LATENCY_STATS)
+    /**
+     * @brief Get the longest any SD card operation of a kind took since the
+     * start or resetSDStats().
+     *
+     * @param op The operation; default is the whole save of a record
+     * @return **uint32_t** The longest time in milliseconds
+     */
+    static uint32_t getSDWorstLatency(sdOperation op = SD_OP_SAVE) {
+        return op < SD_OP_COUNT ? _sdWorstLatency_ms[op] : 0;
+    }
+    /**
+     * @brief Get a percentile of the SD card operation times from the
+     * latency histogram.
+     *
+     * This is the upper edge of the histogram bucket the percentile falls in,
+     * but never more than the longest time seen, so it may be up to twice the
+     * true percentile.
+     *
+     * @param percent The percentile, 1 to 100
+     * @param op The operation; default is the whole save of a record
+     * @return **int32_t** The time in milliseconds, or -9999 if the operation
+     * hasn't been timed yet
+     */
+    static int32_t getSDLatencyPercentile(uint8_t     percent,
+                                          sdOperation op = SD_OP_SAVE);
+    /**
+     * @brief Get the number of SD card operations that failed since the start
+     * or resetSDStats().
+     *
+     * @param op The operation; default is #SD_OP_COUNT, for the failures of
+     * all of the steps of a save
+     * @return **uint16_t** The failures
+     */
+    static uint16_t getSDFailureCount(sdOperation op = SD_OP_COUNT);
+    /**
+     * @brief Get the number of times queued records were written again after
+     * a write to the SD card failed.
+     *
+     * @return **uint16_t** The retries
+     */
+    static uint16_t getSDRetryCount(void) {
+        return _sdRetries;
+    }
+    /**
+     * @brief Print the SD card latency histograms, worst times and failures.
+     *
+     * @param stream The Arduino stream to print to
+     */
+    static void printSDStats(Stream* stream);
+    /**
+     * @brief Clear all of the SD card latency statistics, as after putting in
+     * a new card.
+     */
+    static void resetSDStats(void);
+#endif
+
+    /**
+     * @brief How much of the processor is shut down while it sleeps.
+     */
+    typedef enum {
+        sleepStandard = 0,  ///< Only what systemSleep() always shuts down
+        sleepLowLeak        ///< Also gate the unused peripherals and pins
+    } sleepProfile;
+    /**
+     * @brief Set how much of the processor is shut down while it sleeps.
+     *
+     * systemSleep() always stops I2C and drives its pins low.  With
+     * #sleepLowLeak it also:
+     * - on a SAMD board, disables the ADC and DAC and stops the bus clocks of
+     * every peripheral not needed to wake (the SERCOMs, timers, ADC, DAC,
+     * analog comparators and the like; the RTC, EIC and watchdog are kept),
+     * - on an AVR board, turns off the analog comparator, which
+     * power_all_disable() leaves running,
+     * - disconnects each of the given pins: its pull-up and input buffer are
+     * turned off and it is left floating.
+     *
+     * Everything is restored as it was on wake.  List only pins that have
+     * nothing driving them to a level that matters while asleep, like the
+     * data pins of unpowered sensors or unused header pins; the wake pin and
+     * the button pin are never disconnected.  A sensor power pin that must
+     * stay low should not be listed unless it has a pull-down on the board.
+     *
+     * Use extras/cycle_energy/ms_phase_energy.py to measure the sleep current
+     * of a board before and after; see the
+     * [power draw FAQ](@ref page_power_parasites).
+     *
+     * @param profile The sleep profile
+     * @param parkPins The pins to disconnect while asleep; the array must
+     * outlive the logger.  Default is none.
+     * @param parkPinCount The number of pins in the array, up to
+     * #MS_MAX_SLEEP_PINS.  Default is 0.
      */
-    bool checkMarkedInterval(void);
+    void setSleepProfile(sleepProfile profile,
+                         const int8_t* parkPins     = nullptr,
+                         uint8_t       parkPinCount = 0);
 
  protected:
     /**
-     * @brief The static timezone data is being logged in.
-     *
-     * @note All logger objects, if multiple are used, will be in the same
-     * timezone.
+     * @brief The sleep profile
      */
-    static int8_t _loggerTimeZone;
+    sleepProfile _sleepProfile = sleepStandard;
     /**
-     * @brief The static difference between the timezone of the RTC and the
-     * timezone data is being logged in.
-     *
-     * @note All logger objects, if multiple are used, will be will have the
-     * same offset.
+     * @brief The pins to disconnect while asleep
      */
-    static int8_t _loggerRTCOffset;
-    /**@}*/
-
-    // ===================================================================== //
+    const int8_t* _parkPins = nullptr;
     /**
-     * @anchor logger_sleep
-     * @name Clock and Timezones
-     * Public Functions for sleeping the logger
+     * @brief The number of pins to disconnect while asleep
      */
-    /**@{*/
-    // ===================================================================== //
-
- public:
+    uint8_t _parkPinCount = 0;
     /**
-     * @brief Set up the Interrupt Service Request for waking
-     *
-     * In this case, we're doing nothing, we just want the processor to wake.
-     * This must be a static function (which means it can only call other static
-     * funcions.)
+     * @brief The state of a pin before it was disconnected for sleep
      */
-    static void wakeISR(void);
-
+    typedef struct parkedPin {
+        /// @brief The pin configuration register (SAMD only)
+        uint8_t config;
+        /// @brief True if the pin was an output
+        bool output;
+        /// @brief True if the pin was set high (or pulled up)
+        bool high;
+    } parkedPin;
     /**
-     * @brief Put the mcu to sleep to conserve battery life and handle
-     * post-interrupt wake actions
-     *
-     * @note This DOES NOT sleep or wake the sensors!!
+     * @brief The states of the disconnected pins
      */
-    void systemSleep(void);
+    parkedPin _parkedPins[MS_MAX_SLEEP_PINS];
+    /**
+     * @brief The peripheral clock mask before sleep (SAMD) or the analog
+     * comparator control register (AVR)
+     */
+    uint32_t _savedPeripherals = 0;
+    /**
+     * @brief True if the ADC was enabled before sleep (SAMD only)
+     */
+    bool _adcWasEnabled = false;
+    /**
+     * @brief True if the DAC was enabled before sleep (SAMD only)
+     */
+    bool _dacWasEnabled = false;
+    /**
+     * @brief Shut down the peripherals and pins of the #sleepLowLeak profile
+     * before sleeping.
+     */
+    void sleepPeripheralsOff(void);
+    /**
+     * @brief Restore the peripherals and pins shut down by
+     * sleepPeripheralsOff().
+     */
+    void sleepPeripheralsOn(void);
+
+ public:
 
 #if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
     /**
@@ -903,6 +3456,7 @@ class Logger {
      * @param fileName The file name
      */
     void setFileName(const char* fileName);
+#if !defined(MS_NO_STRING)
     /**
      * @brief Set the file name, if you want to decide on it in advance.
      *
@@ -912,6 +3466,7 @@ class Logger {
      * @param fileName  The file name
      */
     void setFileName(String& fileName);
+#endif
 
     /**
      * @brief Get the current filename.
@@ -920,11 +3475,21 @@ class Logger {
      * an auto-generated filename which is a concatenation of the logger id and
      * the date when the file was started.
      *
-     * @return **String** The name of the file data is currently being saved to.
+     * @note With the build flag `MS_NO_STRING`; otherwise this returns a
+     * String.
+     *
+     * @return **const char\*** The name of the file data is currently being
+     * saved to.
      */
+#if defined(MS_NO_STRING)
+    const char* getFileName(void) {
+        return _fileName;
+    }
+#else
     String getFileName(void) {
         return _fileName;
     }
+#endif
 
     /**
      * @brief Print a header out to a stream.
@@ -945,6 +3510,149 @@ class Logger {
      * but could also be the "main" Serial port for debugging.
      */
     void printSensorDataCSV(Stream* stream);
+    /**
+     * @brief Write a comma separated list of values of sensor data - including
+     * the time in the logging timezone and a trailing line ending - into a
+     * character buffer.
+     *
+     * This produces exactly the same line as printSensorDataCSV().
+     *
+     * @param buffer The buffer to write the line into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null, or 0 if the whole line did not fit.
+     */
+    size_t formatSensorDataCSV(char* buffer, size_t bufferLen);
+
+    /**
+     * @brief Set whether to save data to the SD card in the compact binary
+     * format instead of as CSV.
+     *
+     * A binary file starts with a header block holding the number of
+     * variables, their decimal resolutions, and the full text of the CSV file
+     * header.  Each record is then the uint32 local epoch time, one float32
+     * per variable, the measurement offsets if setMeasurementOffsets() is on,
+     * and a CRC-16 (CCITT) of those bytes, all little-endian.
+     * Every record is the same size, so a record can be found by its index.
+     * Use `extras/binary_log_converter/ms_bin_to_csv.py` to turn a binary file
+     * back into the usual CSV file.
+     *
+     * Auto-generated file names end in ".bin" instead of ".csv".  Only
+     * logToSD(void) writes binary records.
+     *
+     * @param enableBinary True to write binary records.
+     */
+    void setBinaryLogging(bool enableBinary = true);
+    /**
+     * @brief Get whether data is saved in the compact binary format.
+     *
+     * @return **bool** True if data is saved as binary records.
+     */
+    bool getBinaryLogging(void) {
+        return _binaryLogging;
+    }
+    /**
+     * @brief Get the size of one binary data record.
+     *
+     * @return **uint16_t** The number of bytes in each binary record.
+     */
+    uint16_t getBinaryRecordSize(void);
+    /**
+     * @brief Write a binary data record of the most recent values of all
+     * variables into a buffer.
+     *
+     * @param buffer The buffer to write the record into
+     * @param bufferLen The size of the buffer
+     * @return **size_t** The number of bytes written, or 0 if the whole
+     * record did not fit.
+     */
+    size_t formatSensorDataBinary(uint8_t* buffer, size_t bufferLen);
+    /**
+     * @brief Print the header block of a binary data file to a file.
+     *
+     * @param file The open SdFat file to write to; the header is written at
+     * the current position, which should be the start of the file.
+     */
+    void printBinaryFileHeader(File& file);
+    /**
+     * @brief Set whether binary data files are written as compressed blocks.
+     *
+     * Environmental data change little from one record to the next, so each
+     * block of records written together - the whole SD card queue if
+     * `MS_SD_QUEUE_SIZE` is set, otherwise a single record - is stored as
+     * the differences between consecutive records.  Each value is first
+     * scaled by its variable's decimal resolution to a whole number, so no
+     * more is lost than in a CSV file, and each difference is then written
+     * as a zig-zag varint, as short as one byte.  A block is:
+     *
+     * - uint16 payload length and uint16 record count
+     * - for each record, the varint of the change in the epoch time, then of
+     * the change in each scaled value; the first record in a block is relative
+     * to zero
+     * - a CRC-16 (CCITT) of the record count and payload, and the payload
+     * length again, so the last block can be found from the end of the file
+     *
+     * These files have version 2 in their header, and are also read by
+     * `extras/binary_log_converter/ms_bin_to_csv.py`.  This only applies with
+     * setBinaryLogging(); changing it starts a new file.
+     *
+     * @param enableCompression True to write compressed blocks
+     */
+    void setBinaryCompression(bool enableCompression = true);
+    /**
+     * @brief Get whether binary data files are written as compressed blocks.
+     *
+     * @return **bool** True if binary records are compressed.
+     */
+    bool getBinaryCompression(void) {
+        return _binaryCompression;
+    }
+    /**
+     * @brief Set whether the binary records carry the measurement offset of
+     * each variable.
+     *
+     * Each value in a record shares the one marked time, to the second, but
+     * with a staggered power up or slow SDI-12 and Modbus sensors, a value
+     * may have been measured many seconds after it.  With this on, each
+     * binary record has an int32 per variable after the values, the
+     * millisecond offset of its measurement from the mark, as from
+     * getMeasurementOffsetAtI(); the record size in the file header then
+     * gives 8 bytes per variable instead of 4.  In compressed blocks the
+     * offsets follow the values of each record as more zig-zag varints of
+     * their changes.  The offsets go to the SD card queue and the publisher
+     * backlogs too, so they are sent with backlogged records by the
+     * publishers that carry them, like CBORPublisher.
+     *
+     * Changing this starts a new data file; a backlog saved with the other
+     * record size can't be sent.
+     *
+     * @param enableOffsets True to save the measurement offsets
+     */
+    void setMeasurementOffsets(bool enableOffsets = true);
+    /**
+     * @brief Get whether the binary records carry measurement offsets.
+     *
+     * @return **bool** True if the offsets are saved
+     */
+    bool getMeasurementOffsets(void) {
+        return _measurementOffsets;
+    }
+    /**
+     * @brief Write binary records as one compressed block.
+     *
+     * This is the block format of setBinaryCompression().  The records are
+     * read as written by formatSensorDataBinary(), the format of the SD card
+     * queue and the publisher backlogs, so a run of backlogged records can be
+     * sent on as a single compressed block.
+     *
+     * @param out The stream to write the block to
+     * @param records The binary records
+     * @param count The number of records
+     * @return **size_t** The number of bytes written, or 0 if the block would
+     * be too long
+     */
+    size_t printBinaryBlock(Print* out, const uint8_t* records, uint16_t count);
 
     /**
      * @brief Create a file on the SD card and set the created, modified, and
@@ -960,12 +3668,18 @@ class Logger {
      * false
      * @return **bool** True if the file was successfully created.
      */
+    bool createLogFile(const char* filename, bool writeDefaultHeader = false);
+#if !defined(MS_NO_STRING)
+    /**
+     * @copydoc createLogFile(const char*, bool)
+     */
     bool createLogFile(String& filename, bool writeDefaultHeader = false);
+#endif
     /**
      * @brief Create a file on the SD card and set the created, modified, and
      * accessed timestamps in that file.
      *
-     * The filename will be the one set by setFileName(String) or generated
+     * The filename will be the one set by setFileName() or generated
      * using the logger id and the date.  If desired, a header will also be
      * written to the file based on the variable information from the variable
      * array.
@@ -976,6 +3690,62 @@ class Logger {
      */
     bool createLogFile(bool writeDefaultHeader = false);
 
+    /**
+     * @brief Set the number of bytes to reserve as one contiguous extent
+     * whenever a new log file is created.
+     *
+     * Appends to a pre-allocated file go into the reserved clusters, so the
+     * SD card does not have to search for and link a free cluster in the FAT
+     * during a write.  This keeps the write time of each record short and
+     * consistent, even on a fragmented card.  The file size shown on the card
+     * is still only the data written; the reserved space is held by the
+     * file's cluster chain.  If there is not enough contiguous free space, the
+     * file is created without pre-allocation.
+     *
+     * @param preAllocateBytes The number of bytes to reserve - for example,
+     * the size of one record times the number of records in a month - or 0
+     * to not pre-allocate.
+     */
+    void setFilePreAllocation(uint32_t preAllocateBytes) {
+        _preAllocateBytes = preAllocateBytes;
+    }
+    /**
+     * @brief Get the number of bytes reserved for each new log file.
+     *
+     * @return **uint32_t** The number of bytes reserved for each new log file
+     */
+    uint32_t getFilePreAllocation(void) {
+        return _preAllocateBytes;
+    }
+
+    /**
+     * @brief The calendar periods a log file can be rotated on.
+     */
+    typedef enum {
+        rotateNever = 0,  ///< Keep writing to the same file
+        rotateDaily,      ///< Start a new file each day
+        rotateMonthly     ///< Start a new file each month
+    } fileRotation;
+    /**
+     * @brief Set when to close the current log file and start a new one.
+     *
+     * A new file is started with the first record at or after the calendar
+     * boundary or once the current file reaches the size limit.  New files are
+     * named with the logger ID and the date of their first record, plus the
+     * time if the file was started because of its size.
+     *
+     * Whenever a file is created or closed by rotation, a line with the file
+     * name, the local epoch times of its first and last records, and its
+     * record count is appended to an index file named with the logger ID and
+     * "_index.csv".  The line written when a file is created has an end time
+     * and count of 0.  The most recent line for a file is the current one.
+     *
+     * @param rotation The calendar period, if any, to rotate files on
+     * @param maxFileBytes The size in bytes at which to start a new file, or 0
+     * for no size limit.  Default is 0.
+     */
+    void setFileRotation(fileRotation rotation, uint32_t maxFileBytes = 0);
+
     /**
      * @brief Open a file with the given name on the SD card and append the
      * given line to the bottom of it.
@@ -989,7 +3759,7 @@ class Logger {
      * @return **bool** True if the file was successfully accessed or created
      * _and_ data appended to it.
      */
-    bool logToSD(String& filename, String& rec);
+    bool logToSD(const char* filename, const char* rec);
     /**
      * @brief Open a file named with the current internal filename value and
      * append the given line to the bottom of it.
@@ -1002,7 +3772,17 @@ class Logger {
      * @return **bool** True if the file was successfully accessed or created
      * _and_ data appended to it.
      */
+    bool logToSD(const char* rec);
+#if !defined(MS_NO_STRING)
+    /**
+     * @copydoc logToSD(const char*, const char*)
+     */
+    bool logToSD(String& filename, String& rec);
+    /**
+     * @copydoc logToSD(const char*)
+     */
     bool logToSD(String& rec);
+#endif
     /**
      * @brief Open a file named with the current internal filename value and
      * append a line to the bottom of it with the most recent values of all
@@ -1017,7 +3797,246 @@ class Logger {
      */
     bool logToSD(void);
 
+    /**
+     * @brief Set whether to keep the SD card initialized and the log file open
+     * between records, and how often to commit the open file to the card.
+     *
+     * Normally the card is initialized and the file opened and closed for
+     * every record.  With the file kept open, records are only written to the
+     * SdFat cache and the file is synced when any of the enabled conditions
+     * are met.  Data written since the last sync is lost if the logger loses
+     * power or resets.
+     *
+     * @note The SD card power is left on while the file is open; the logger
+     * will not switch it off after each record.
+     *
+     * @param keepOpen True to keep the log file open between records
+     * @param syncEveryNRecords Sync after this many records; 0 to disable.
+     * Default is 1.
+     * @param syncIntervalSeconds Sync if it has been at least this many
+     * seconds since the last sync; 0 to disable.  Default is 0.
+     * @param syncBeforeSleep True to sync any unsynced records before the
+     * logger goes to sleep.  Default is true.
+     */
+    void setSDKeepOpen(bool keepOpen, uint8_t syncEveryNRecords = 1,
+                       uint32_t syncIntervalSeconds = 0,
+                       bool     syncBeforeSleep     = true);
+    /**
+     * @brief Get whether the log file is kept open between records.
+     *
+     * @return **bool** True if the log file is kept open between records.
+     */
+    bool getSDKeepOpen(void) {
+        return _sdKeepOpen;
+    }
+    /**
+     * @brief Commit any records waiting in the SdFat cache to the card and
+     * update the file timestamps.
+     *
+     * @param closeFile True to also close the file.
+     * @return **bool** True if the file was synced (or was not open).
+     */
+    bool syncLogFile(bool closeFile = false);
+    /**
+     * @brief Set which file timestamps are updated and when.
+     *
+     * Each timestamp update rewrites the file's directory entry, so skipping
+     * the ones that aren't needed shortens every write to the card.
+     *
+     * @param updateAccessTime True to update the access time when a file is
+     * opened or written.  Default is true.
+     * @param stampOnlyOnClose True to only update the write time of a log file
+     * kept open with setSDKeepOpen() when it is closed, not at every sync.
+     * Default is false.
+     */
+    void setFileTimestampPolicy(bool updateAccessTime = true,
+                                bool stampOnlyOnClose = false);
+
+ protected:
+    /**
+     * @brief True to write binary records to the SD card
+     */
+    bool _binaryLogging = false;
+    /**
+     * @brief True to write binary records as compressed blocks
+     */
+    bool _binaryCompression = false;
+    /**
+     * @brief True to save the measurement offsets with each binary record
+     */
+    bool _measurementOffsets = false;
+    /**
+     * @brief True to update the access time of files
+     */
+    bool _stampAccessTime = true;
+    /**
+     * @brief True to only update the timestamps of the log file when it is
+     * closed, not each time it is synced
+     */
+    bool _stampOnlyOnClose = false;
+    /**
+     * @brief The number of bytes to reserve for each new log file
+     */
+    uint32_t _preAllocateBytes = 0;
+    /**
+     * @brief The calendar period to rotate log files on
+     */
+    fileRotation _fileRotation = rotateNever;
+    /**
+     * @brief The size in bytes at which to rotate log files
+     */
+    uint32_t _maxFileBytes = 0;
+    /**
+     * @brief The size of the current log file when it was last written
+     */
+    uint32_t _fileBytes = 0;
+    /**
+     * @brief The number of records written to the current log file by logToSD()
+     */
+    uint32_t _fileRecordCount = 0;
+    /**
+     * @brief The local epoch time of the first record in the current log file
+     */
+    uint32_t _fileStartTime = 0;
+    /**
+     * @brief The local epoch time of the last record in the current log file
+     */
+    uint32_t _fileEndTime = 0;
+    /**
+     * @brief Close the current log file and start a new one if it has reached a
+     * rotation boundary.
+     */
+    void checkFileRotation(void);
+    /**
+     * @brief Append a line for the current log file to the index file.
+     *
+     * @param startTime The local epoch time of the first record in the file
+     * @param endTime The local epoch time of the last record in the file
+     * @param recordCount The number of records in the file
+     * @return **bool** True if the line was written
+     */
+    bool writeFileIndexEntry(uint32_t startTime, uint32_t endTime,
+                             uint32_t recordCount);
+    /**
+     * @brief Calculate a CRC-16 (CCITT) checksum.
+     *
+     * @param data The bytes to check
+     * @param len The number of bytes
+     * @param crc The starting value; the result of a previous call to
+     * continue a checksum.  Default is 0xFFFF.
+     * @return **uint16_t** The checksum
+     */
+    static uint16_t crc16(const uint8_t* data, size_t len,
+                          uint16_t crc = 0xFFFF);
+    /**
+     * @brief Encode the payload of a compressed block, writing it out and
+     * adding it to a checksum if wanted.
+     *
+     * @param records The binary records
+     * @param count The number of records
+     * @param out The stream to write the payload to; nullptr to only measure
+     * it
+     * @param crc The checksum to add the payload to; nullptr for none
+     * @return **uint32_t** The length of the payload
+     */
+    uint32_t encodeBlockPayload(const uint8_t* records, uint16_t count,
+                                Print* out, uint16_t* crc);
+    /**
+     * @brief Check a compressed block in a file.
+     *
+     * @param file The open file
+     * @param start The position of the start of the block
+     * @param blockSize Set to the size of the block, including its framing
+     * @return **bool** True if the block is whole and its CRC matches
+     */
+    bool checkBinaryBlock(File& file, uint32_t start, uint32_t* blockSize);
+    /**
+     * @brief Write the current data record into a buffer in the SD file
+     * format - binary or CSV.
+     *
+     * @param buffer The buffer to write the record into
+     * @param bufferLen The size of the buffer
+     * @return **size_t** The number of bytes written, or 0 if the whole
+     * record did not fit.
+     */
+    size_t formatLogRecord(char* buffer, size_t bufferLen);
+
+ public:
+
+#if defined(MS_SD_QUEUE_SIZE)
+    /**
+     * @brief Set the longest time a record may wait in the SD card queue
+     * before the queue is written to the card.
+     *
+     * Records are queued in RAM and written to the card together once the
+     * next record would not fit in the #MS_SD_QUEUE_SIZE byte queue, so the
+     * card only needs to be powered for one write every several records.
+     * Queued records are lost if the logger loses power or resets.
+     *
+     * @note Only available with the build flag `MS_SD_QUEUE_SIZE` set to the
+     * size of the queue in bytes.  512 matches the SD card sector size.
+     *
+     * @param maxAgeSeconds The longest time in seconds between the first
+     * record in the queue and writing the queue out; 0 to only write when the
+     * queue is full.
+     */
+    void setSDQueueMaxAge(uint32_t maxAgeSeconds) {
+        _sdQueueMaxAge = maxAgeSeconds;
+    }
+    /**
+     * @brief Write all records waiting in the SD card queue to the card.
+     *
+     * This powers the SD card for the write if it is not being kept open.
+     *
+     * @return **bool** True if the queue is empty or was written to the card.
+     */
+    bool flushSDQueue(void);
+
+ protected:
+    /**
+     * @brief The records waiting to be written to the SD card
+     */
+    char _sdQueue[MS_SD_QUEUE_SIZE];
+    /**
+     * @brief The number of characters waiting in the SD card queue
+     */
+    uint16_t _sdQueueLen = 0;
+    /**
+     * @brief The UTC epoch time of the oldest record in the SD card queue
+     */
+    uint32_t _sdQueueOldest = 0;
+    /**
+     * @brief The longest time in seconds a record may wait in the queue
+     */
+    uint32_t _sdQueueMaxAge = 0;
+#endif
+
  protected:
+    /**
+     * @brief True to keep the log file open between records
+     */
+    bool _sdKeepOpen = false;
+    /**
+     * @brief True to sync the open log file before sleeping
+     */
+    bool _sdSyncBeforeSleep = true;
+    /**
+     * @brief The number of records between syncs of the open log file
+     */
+    uint8_t _sdSyncEveryNRecords = 1;
+    /**
+     * @brief The number of records written since the last sync
+     */
+    uint8_t _sdRecordsSinceSync = 0;
+    /**
+     * @brief The maximum number of seconds between syncs of the open log file
+     */
+    uint32_t _sdSyncIntervalSeconds = 0;
+    /**
+     * @brief The UTC epoch time of the last sync of the log file
+     */
+    uint32_t _sdLastSyncTime = 0;
+
     // The SD card and file
     /**
      * @brief An internal reference to SdFat for SD card control
@@ -1030,7 +4049,7 @@ class Logger {
     /**
      * @brief An internal reference to the current filename
      */
-    String _fileName = "";
+    char _fileName[MS_FILE_NAME_SIZE] = "";
     // ^^ Initialize with no file name
 
     /**
@@ -1051,17 +4070,20 @@ class Logger {
     void generateAutoFileName(void);
 
     /**
-     * @brief Set a timestamp on a file.
+     * @brief Set timestamps on a file.
+     *
+     * The time is read from the clock only once, and not at all while logging,
+     * when the marked time is used.  Access times are skipped if disabled with
+     * setFileTimestampPolicy().
      *
-     * @param fileToStamp The filename to change the timestamp of
-     * @param stampFlag The "flag" of the timestamp to change - should be
-     * T_CREATE, T_WRITE, or T_ACCESS
+     * @param fileToStamp The file to change the timestamp of
+     * @param stampFlag The "flags" of the timestamps to change - any
+     * combination of T_CREATE, T_WRITE, and T_ACCESS
      */
-    void setFileTimestamp(File fileToStamp, uint8_t stampFlag);
+    void setFileTimestamp(File& fileToStamp, uint8_t stampFlag);
 
     /**
-     * @brief Open or creates a file, converting a string file name to a
-     * character file name.
+     * @brief Open or creates a file.
      *
      * @param filename The name of the file to open
      * @param createFile True to create the file if it did not already exist
@@ -1069,7 +4091,28 @@ class Logger {
      * created
      * @return **bool** True if a file was successfully opened or created.
      */
-    bool openFile(String& filename, bool createFile, bool writeDefaultHeader);
+    bool openFile(const char* filename, bool createFile,
+                  bool writeDefaultHeader);
+    /**
+     * @brief Cut a record torn by a reset or power loss off the end of a log
+     * file.
+     *
+     * Only the end of the file is read, so this takes the same time no matter
+     * how long the file is.  The size in the file's directory entry, which
+     * SdFat updates on each sync, is taken as the last committed offset.  In
+     * a binary file, a partial record after the last whole one is removed, as
+     * is the last record if its CRC doesn't match.  In a CSV file, anything
+     * after the last line ending is removed, looking back at most
+     * #MS_TAIL_SCAN_BYTES.
+     *
+     * @param filename The name of the log file
+     */
+    void repairLogTail(const char* filename);
+    /**
+     * @brief True once the tail of the log file has been checked since the
+     * logger started.
+     */
+    bool _tailChecked = false;
     /**@}*/
 
     // ===================================================================== //
@@ -1102,8 +4145,54 @@ class Logger {
      * to the "main" output - ie Serial - and NOT to the SD card.  After 25
      * measurements, the sensors are put to sleep, the modem is disconnected
      * from the internet, and the logger goes back to sleep.
+     *
+     * With setStreamingMode(), the readings are instead streamed as fast as
+     * the sensors allow until the button is pressed again or the time runs
+     * out.
      */
     virtual void testingMode();
+
+    /**
+     * @brief The formats readings can be streamed in.
+     */
+    typedef enum {
+        streamCSV = 0,  ///< A line of the milliseconds and values per update
+        streamBinary    ///< A compact binary frame per update
+    } streamFormat;
+    /**
+     * @brief Set testing mode to stream readings continuously instead of
+     * taking 25 readings.
+     *
+     * While streaming, the sensors are kept awake and each update starts as
+     * soon as the last one is done, so each frame comes as fast as the
+     * slowest sensor allows.  The modem metadata is only updated once, at the
+     * start.  Streaming stops when the testing button is pressed again, after
+     * the first two seconds, or after `maxSeconds`.
+     *
+     * A CSV frame is a line of the milliseconds since streaming began and the
+     * formatted values.  A binary frame is the two bytes `MS`, the uint8
+     * number of variables, the uint32 milliseconds since streaming began, one
+     * float32 per variable, and a CRC-16 (CCITT) of the bytes after `MS`, all
+     * little-endian.
+     *
+     * @param enable True to stream in testing mode; false for the 25 readings
+     * @param format The format of the frames.  Default is CSV.
+     * @param maxSeconds The longest time to stream, or 0 to stream until the
+     * button is pressed.  Default is 600.
+     */
+    void setStreamingMode(bool enable, streamFormat format = streamCSV,
+                          uint32_t maxSeconds = 600);
+    /**
+     * @brief Set a client to also send the streamed frames to.
+     *
+     * The client is connected to the host when streaming starts, if the modem
+     * connected to the internet, and stopped when streaming ends.
+     *
+     * @param client The client to send the frames on, or nullptr for none
+     * @param host The host to send the frames to
+     * @param port The port on the host
+     */
+    void setStreamingClient(Client* client, const char* host, uint16_t port);
     /**@}*/
 
     // ===================================================================== //
@@ -1178,6 +4267,20 @@ class Logger {
      */
     static uint32_t markedUTCEpochTime;
 
+    /**
+     * @brief The static millis() at the start of the marked second, for the
+     * measurement offsets.
+     */
+    static uint32_t markedMillis;
+
+    /**
+     * @brief The static "marked" local time as an ISO8601 formatted string.
+     *
+     * This is written once by markTime() so the publishers and the serial
+     * output can all use the same timestamp without re-formatting it.
+     */
+    static char markedISO8601Time[MS_ISO8601_BUFFER_SIZE];
+
     // These are flag fariables noting the current state (logging/testing)
     // NOTE:  if the logger isn't currently logging or testing or in the middle
     // of set-up, it's probably sleeping
@@ -1197,6 +4300,11 @@ class Logger {
      * "testing mode" routine when it finishes other operations.
      */
     static volatile bool startTesting;
+    /**
+     * @brief Internal flag set to true when the testing button is pressed
+     * while the logger is streaming in testing mode.
+     */
+    static volatile bool stopTesting;
     /**@}*/
 };
 
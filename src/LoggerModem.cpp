@@ -10,12 +10,18 @@
 #include "LoggerModem.h"
 
 // Initialize the static members
-int16_t loggerModem::_priorRSSI           = -9999;
-int16_t loggerModem::_priorSignalPercent  = -9999;
-float   loggerModem::_priorModemTemp      = -9999;
-float   loggerModem::_priorBatteryState   = -9999;
-float   loggerModem::_priorBatteryPercent = -9999;
-float   loggerModem::_priorBatteryVoltage = -9999;
+int16_t loggerModem::_priorRSSI               = -9999;
+int16_t loggerModem::_priorSignalPercent      = -9999;
+float   loggerModem::_priorModemTemp          = -9999;
+float   loggerModem::_priorBatteryState       = -9999;
+float   loggerModem::_priorBatteryPercent     = -9999;
+float   loggerModem::_priorBatteryVoltage     = -9999;
+uint8_t loggerModem::_metadataFields          = 0;
+float   loggerModem::_priorActivationDuration = -9999;
+float   loggerModem::_priorPoweredDuration    = -9999;
+float   loggerModem::_totalPoweredTime        = 0;
+float   loggerModem::_priorEnergyUsed         = -9999;
+float   loggerModem::_totalEnergyUsed         = 0;
 
 // Constructor
 loggerModem::loggerModem(int8_t powerPin, int8_t statusPin, bool statusLevel,
@@ -39,7 +45,12 @@ loggerModem::loggerModem(int8_t powerPin, int8_t statusPin, bool statusLevel,
       _disconnetTime_ms(max_disconnetTime_ms),
       _wakeDelayTime_ms(wakeDelayTime_ms),
       _max_atresponse_time_ms(max_atresponse_time_ms),
-      _modemName("unspecified modem") {}
+      _modemName("unspecified modem") {
+    _powerIO.attach(_powerPin);
+    _statusIO.attach(_statusPin);
+    _modemResetIO.attach(_modemResetPin);
+    _modemSleepRqIO.attach(_modemSleepRqPin);
+}
 
 // Destructor
 loggerModem::~loggerModem() {}
@@ -72,11 +83,11 @@ void loggerModem::modemPowerUp(void) {
             MS_DBG(F("Setting sleep pin"), _modemSleepRqPin, F("to"),
                    !_wakeLevel ? F("HIGH") : F("LOW"), F("while powering on"),
                    getModemName());
-            digitalWrite(_modemSleepRqPin, !_wakeLevel);
+            _modemSleepRqIO.write(!_wakeLevel);
         }
         MS_DBG(F("Powering"), getModemName(), F("with pin"), _powerPin);
         pinMode(_powerPin, OUTPUT);
-        digitalWrite(_powerPin, HIGH);
+        _powerIO.high();
         // Mark the time that the sensor was powered
         _millisPowerOn = millis();
     } else {
@@ -85,15 +96,18 @@ void loggerModem::modemPowerUp(void) {
         // Mark the power-on time, just in case it had not been marked
         if (_millisPowerOn == 0) _millisPowerOn = millis();
     }
+    if (_powerState == powerOff) setPowerState(powerAsleep);
 }
 
 void loggerModem::modemPowerDown(void) {
+    _connectState = stateOff;
     if (_powerPin >= 0) {
         MS_DBG(F("Turning off power to"), getModemName(), F("with pin"),
                _powerPin);
-        digitalWrite(_powerPin, LOW);
+        _powerIO.low();
         // Unset the power-on time
         _millisPowerOn = 0;
+        setPowerState(powerOff);
     } else {
         MS_DBG(F("Power to"), getModemName(),
                F("is not controlled by this library."));
@@ -125,11 +139,19 @@ bool loggerModem::modemSetup(void) {
         success &= modemWake();
     } else {
         MS_DBG(F("Modem was already awake and should be ready for setup."));
+        // Waking would have negotiated the baud rate
+        negotiateBaud();
     }
 
     if (success) {
         MS_DBG(F("Running modem's extra setup function ..."));
         success &= extraModemSetup();
+        if (success && _psmTAU_s > 0) {
+            MS_DBG(F("Requesting power saving mode timers ..."));
+            _powerSaving = setPowerSavingFxn();
+            MS_DBG(_powerSaving ? F("... timers accepted.")
+                                : F("... power saving mode not accepted."));
+        }
         if (success) {
             MS_DBG(F("... setup complete!  It's a"), getModemName());
         } else {
@@ -178,7 +200,13 @@ bool loggerModem::modemSleep(void) {
     // where possible I've selected a pulse time that is sufficient to wake but
     // not quite long enough to put it to sleep and am using AT commands to
     // sleep.  This *should* keep everything lined up.
-    if (!isModemAwake()) {
+    if (_powerSaving) {
+        // Leave the modem registered; it enters PSM on its own once the
+        // active time runs out
+        MS_DBG(getModemName(),
+               F("is in power saving mode; leaving it to enter PSM."));
+        modemLEDOff();
+    } else if (!isModemAwake()) {
         MS_DBG(getModemName(),
                F("is already off!  Will not run sleep function."));
     } else {
@@ -187,6 +215,7 @@ bool loggerModem::modemSleep(void) {
         success &= modemSleepFxn();
         modemLEDOff();
     }
+    if (_powerState > powerAsleep) setPowerState(powerAsleep);
     return success;
 }
 
@@ -195,9 +224,18 @@ bool loggerModem::modemSleepPowerDown(void) {
     bool     success = true;
     uint32_t start   = millis();
     MS_DBG(F("Turning"), getModemName(), F("off."));
+    _connectState = stateOff;
 
     modemSleep();
 
+    // Cutting the power would lose the network registration kept by PSM
+    if (_powerSaving) {
+        MS_DBG(F("Leaving power on so"), getModemName(),
+               F("stays registered."));
+        endPowerCycle();
+        return success;
+    }
+
     // Now power down
     if (_powerPin >= 0) {
         // If there's a status pin available, wait until modem shows it's ready
@@ -208,10 +246,10 @@ bool loggerModem::modemSleepPowerDown(void) {
                    _statusPin, F("going"), !_statusLevel ? F("HIGH") : F("LOW"),
                    F("..."));
             while (millis() - start < _disconnetTime_ms &&
-                   digitalRead(_statusPin) ==
+                   _statusIO.read() ==
                        static_cast<int>(_statusLevel)) {  // wait
             }
-            if (digitalRead(_statusPin) == static_cast<int>(_statusLevel)) {
+            if (_statusIO.read() == static_cast<int>(_statusLevel)) {
                 MS_DBG(F("... "), getModemName(),
                        F("did not successfully shut down!"));
             } else {
@@ -228,9 +266,10 @@ bool loggerModem::modemSleepPowerDown(void) {
 
         MS_DBG(F("Turning off power to"), getModemName(), F("with pin"),
                _powerPin);
-        digitalWrite(_powerPin, LOW);
+        _powerIO.low();
         // Unset the power-on time
         _millisPowerOn = 0;
+        setPowerState(powerOff);
     } else {
         // If we're not going to power the modem down, there's no reason to hold
         // up the main processor while waiting for the modem to shut down.
@@ -239,6 +278,7 @@ bool loggerModem::modemSleepPowerDown(void) {
                F("is not controlled by this library - not waiting for "
                  "shut-down to complete."));
     }
+    endPowerCycle();
 
     return success;
 }
@@ -249,15 +289,26 @@ bool loggerModem::modemHardReset(void) {
         MS_DBG(F("Doing a hard reset on the modem by setting pin"),
                _modemResetPin, _resetLevel ? F("HIGH") : F("LOW"), F("for"),
                _resetPulse_ms, F("ms"));
-        digitalWrite(_modemResetPin, _resetLevel);
+        _modemResetIO.write(_resetLevel);
         delay(_resetPulse_ms);
-        digitalWrite(_modemResetPin, !_resetLevel);
+        _modemResetIO.write(!_resetLevel);
         return true;
     } else {
         MS_DBG(F("No pin has been provided to reset the modem!"));
         return false;
     }
 }
+
+void loggerModem::setPowerSavingMode(uint32_t periodicTAUSeconds,
+                                     uint16_t activeTimeSeconds,
+                                     uint16_t eDRXSeconds) {
+    _psmTAU_s    = periodicTAUSeconds;
+    _psmActive_s = activeTimeSeconds;
+    _eDRX_s      = eDRXSeconds;
+    if (_psmTAU_s == 0) _powerSaving = false;
+}
+
+
 void loggerModem::setModemStatusLevel(bool level) {
     _statusLevel = level;
 }
@@ -285,14 +336,14 @@ void loggerModem::setModemPinModes(void) {
                    F("for modem sleep with starting value"),
                    !_wakeLevel ? F("HIGH") : F("LOW"));
             pinMode(_modemSleepRqPin, OUTPUT);
-            digitalWrite(_modemSleepRqPin, !_wakeLevel);
+            _modemSleepRqIO.write(!_wakeLevel);
         }
         if (_modemResetPin >= 0) {
             MS_DBG(F("Initializing pin"), _modemResetPin,
                    F("for modem reset with starting value"),
                    !_resetLevel ? F("HIGH") : F("LOW"));
             pinMode(_modemResetPin, OUTPUT);
-            digitalWrite(_modemResetPin, !_resetLevel);
+            _modemResetIO.write(!_resetLevel);
         }
         if (_modemLEDPin >= 0) {
             MS_DBG(F("Initializing pin"), _modemLEDPin,
@@ -313,9 +364,15 @@ bool loggerModem::updateModemMetadata(void) {
     loggerModem::_priorSignalPercent  = -9999;
     loggerModem::_priorBatteryState   = -9999;
     loggerModem::_priorBatteryPercent = -9999;
-    loggerModem::_priorBatteryPercent = -9999;
+    loggerModem::_priorBatteryVoltage = -9999;
     loggerModem::_priorModemTemp      = -9999;
 
+    // Only ask for what some Variable will report
+    if (_metadataFields == 0) {
+        MS_DBG(F("No modem metadata is needed"));
+        return true;
+    }
+
     // Initialize variable
     int16_t  rssi     = -9999;
     int16_t  percent  = -9999;
@@ -324,43 +381,431 @@ bool loggerModem::updateModemMetadata(void) {
     uint16_t volt     = 9999;
 
     // Try for up to 15 seconds to get a valid signal quality
-    uint32_t startMillis = millis();
-    do {
-        success &= getModemSignalQuality(rssi, percent);
-        loggerModem::_priorRSSI          = rssi;
-        loggerModem::_priorSignalPercent = percent;
-        if (rssi != 0 && rssi != -9999) break;
-        delay(250);
-    } while ((rssi == 0 || rssi == -9999) && millis() - startMillis < 15000L &&
-             success);
-    MS_DBG(F("CURRENT RSSI:"), rssi);
-    MS_DBG(F("CURRENT Percent signal strength:"), percent);
-
-    success &= getModemBatteryStats(state, bpercent, volt);
-    MS_DBG(F("CURRENT Modem Battery Charge State:"), state);
-    MS_DBG(F("CURRENT Modem Battery Charge Percentage:"), bpercent);
-    MS_DBG(F("CURRENT Modem Battery Voltage:"), volt);
-    if (state != 99)
-        loggerModem::_priorBatteryState = static_cast<float>(state);
-    else
-        loggerModem::_priorBatteryState = static_cast<float>(-9999);
-
-    if (bpercent != -99)
-        loggerModem::_priorBatteryPercent = static_cast<float>(bpercent);
-    else
-        loggerModem::_priorBatteryPercent = static_cast<float>(-9999);
-
-    if (volt != 9999)
-        loggerModem::_priorBatteryVoltage = static_cast<float>(volt);
-    else
-        loggerModem::_priorBatteryVoltage = static_cast<float>(-9999);
-
-    loggerModem::_priorModemTemp = getModemChipTemperature();
-    MS_DBG(F("CURRENT Modem Chip Temperature:"), loggerModem::_priorModemTemp);
+    if (_metadataFields & MODEM_SIGNAL_FIELDS) {
+        uint32_t startMillis = millis();
+        do {
+            success &= getModemSignalQuality(rssi, percent);
+            loggerModem::_priorRSSI          = rssi;
+            loggerModem::_priorSignalPercent = percent;
+            if (rssi != 0 && rssi != -9999) break;
+            delay(250);
+        } while ((rssi == 0 || rssi == -9999) &&
+                 millis() - startMillis < 15000L && success);
+        MS_DBG(F("CURRENT RSSI:"), rssi);
+        MS_DBG(F("CURRENT Percent signal strength:"), percent);
+    }
+
+    if (_metadataFields & MODEM_BATTERY_FIELDS) {
+        success &= getModemBatteryStats(state, bpercent, volt);
+        MS_DBG(F("CURRENT Modem Battery Charge State:"), state);
+        MS_DBG(F("CURRENT Modem Battery Charge Percentage:"), bpercent);
+        MS_DBG(F("CURRENT Modem Battery Voltage:"), volt);
+        if (state != 99)
+            loggerModem::_priorBatteryState = static_cast<float>(state);
+        if (bpercent != -99)
+            loggerModem::_priorBatteryPercent = static_cast<float>(bpercent);
+        if (volt != 9999)
+            loggerModem::_priorBatteryVoltage = static_cast<float>(volt);
+    }
+
+    if (_metadataFields & MODEM_TEMPERATURE_ENABLE_BITMASK) {
+        loggerModem::_priorModemTemp = getModemChipTemperature();
+        MS_DBG(F("CURRENT Modem Chip Temperature:"),
+               loggerModem::_priorModemTemp);
+    }
 
     return success;
 }
 
+
+// Most modems can only have one socket open at a time
+Client* loggerModem::getMuxClient(uint8_t socketNum) {
+    (void)socketNum;
+    return nullptr;
+}
+
+
+// Most modems only look up addresses as part of opening a connection
+bool loggerModem::lookupHostIP(const char* host, IPAddress& ip) {
+    (void)host;
+    (void)ip;
+    return false;
+}
+
+
+// Most modems take each write whole
+uint16_t loggerModem::getMaxSendSize(void) {
+    return 0;
+}
+
+
+// Most modems have no HTTP client of their own
+int16_t loggerModem::nativeHttpRequest(const char* host, uint16_t port,
+                                       bool useTls, const char* head,
+                                       size_t headLen, const char* body,
+                                       size_t bodyLen) {
+    (void)host;
+    (void)port;
+    (void)useTls;
+    (void)head;
+    (void)headLen;
+    (void)body;
+    (void)bodyLen;
+    return 0;
+}
+
+
+// Sets the serial port whose baud rate is negotiated
+void loggerModem::setBaudNegotiation(HardwareSerial* modemSerial,
+                                     uint32_t currentBaud, uint32_t maxBaud,
+                                     bool flowControl) {
+    _baudSerial  = modemSerial;
+    _modemBaud   = currentBaud;
+    _maxBaud     = maxBaud;
+    _flowControl = flowControl;
+}
+
+
+// Most modems can't negotiate their baud rate
+bool loggerModem::setBaudFxn(uint32_t baud) {
+    (void)baud;
+    return false;
+}
+bool loggerModem::testATFxn(uint32_t timeout_ms) {
+    (void)timeout_ms;
+    return false;
+}
+bool loggerModem::setFlowControlFxn(void) {
+    return false;
+}
+
+
+// The common baud rates, fastest first
+static const uint32_t modemBaudRates[] = {921600, 460800, 230400, 115200,
+                                          57600,  38400,  19200,  9600};
+#define MS_MODEM_BAUD_RATE_COUNT \
+    (sizeof(modemBaudRates) / sizeof(modemBaudRates[0]))
+
+// The modem may still be booting, so the last rate gets the longest wait
+bool loggerModem::findModemBaud(void) {
+    if (_modemBaud != 0 && testATFxn(_max_atresponse_time_ms + 500)) {
+        return true;
+    }
+    for (uint8_t i = 0; i < MS_MODEM_BAUD_RATE_COUNT; i++) {
+        if (modemBaudRates[i] == _modemBaud) continue;
+        _baudSerial->end();
+        _baudSerial->begin(modemBaudRates[i]);
+        if (testATFxn(250)) {
+            MS_DBG(getModemName(), F("answered at"), modemBaudRates[i],
+                   F("baud"));
+            _modemBaud = modemBaudRates[i];
+            return true;
+        }
+    }
+    // Leave the port as it was
+    _baudSerial->end();
+    _baudSerial->begin(_modemBaud);
+    return false;
+}
+// Each faster rate is tried until one works
+bool loggerModem::negotiateBaud(void) {
+    if (_baudSerial == nullptr) return false;
+    if (!findModemBaud()) {
+        MS_DBG(getModemName(), F("did not answer at any baud rate"));
+        return false;
+    }
+    for (uint8_t i = 0;
+         i < MS_MODEM_BAUD_RATE_COUNT && modemBaudRates[i] > _modemBaud; i++) {
+        if (modemBaudRates[i] > _maxBaud) continue;
+        uint32_t lastGood = _modemBaud;
+        MS_DBG(F("Asking"), getModemName(), F("for"), modemBaudRates[i],
+               F("baud"));
+        if (!setBaudFxn(modemBaudRates[i])) continue;
+        _baudSerial->flush();
+        _baudSerial->end();
+        _baudSerial->begin(modemBaudRates[i]);
+        delay(100);
+        bool reliable = true;
+        for (uint8_t j = 0; j < 3 && reliable; j++) reliable = testATFxn(500);
+        if (reliable) {
+            _modemBaud = modemBaudRates[i];
+            break;
+        }
+        // The link mostly works, so a few tries usually get the modem back
+        MS_DBG(modemBaudRates[i], F("baud is not reliable; going back to"),
+               lastGood);
+        bool restored = false;
+        for (uint8_t j = 0; j < 3 && !restored; j++) {
+            restored = setBaudFxn(lastGood);
+        }
+        _baudSerial->flush();
+        _baudSerial->end();
+        _baudSerial->begin(lastGood);
+        delay(100);
+        if (!testATFxn(500) && !findModemBaud()) return false;
+    }
+    if (_flowControl && !setFlowControlFxn()) {
+        MS_DBG(getModemName(), F("did not accept hardware flow control"));
+    }
+    MS_DBG(getModemName(), F("is running at"), _modemBaud, F("baud"));
+    return true;
+}
+
+
+// Most modems don't support power saving mode
+bool loggerModem::setPowerSavingFxn(void) {
+    MS_DBG(getModemName(), F("does not support power saving mode."));
+    return false;
+}
+
+
+// The units of the PSM timers, from 3GPP TS 24.008 tables 10.5.163a and
+// 10.5.163
+void loggerModem::encodePSMTimer(uint32_t seconds, bool activeTimer,
+                                 char* bits) {
+    static const uint32_t tauUnits[]    = {2, 30, 60, 600, 3600, 36000,
+                                           1152000};
+    static const uint8_t  tauCodes[]    = {3, 4, 5, 0, 1, 2, 6};
+    static const uint32_t activeUnits[] = {2, 60, 360};
+    static const uint8_t  activeCodes[] = {0, 1, 2};
+
+    const uint32_t* units  = activeTimer ? activeUnits : tauUnits;
+    const uint8_t*  codes  = activeTimer ? activeCodes : tauCodes;
+    uint8_t         nUnits = activeTimer ? 3 : 7;
+
+    // Use the largest unit if the time won't fit in any of them
+    uint8_t  u          = nUnits - 1;
+    uint32_t multiplier = 31;
+    for (uint8_t k = 0; k < nUnits; k++) {
+        uint32_t m = (seconds + units[k] - 1) / units[k];
+        if (m <= 31) {
+            u          = k;
+            multiplier = m;
+            break;
+        }
+    }
+    uint8_t value = (codes[u] << 5) | multiplier;
+    for (uint8_t b = 0; b < 8; b++) {
+        bits[b] = (value & (0x80 >> b)) ? '1' : '0';
+    }
+    bits[8] = '\0';
+}
+
+
+// The LTE-M (WB-S1) eDRX cycles, from 3GPP TS 24.008 table 10.5.5.32
+void loggerModem::encodeEDRXCycle(uint16_t seconds, char* bits) {
+    static const uint16_t cycles[] = {5,   10,  20,  41,  61,   82,
+                                      102, 123, 143, 164, 328,  655,
+                                      1311, 2621, 5243, 10486};
+    uint8_t value = 0;
+    for (uint8_t k = 1; k < 16; k++) {
+        if (cycles[k] <= seconds) value = k;
+    }
+    for (uint8_t b = 0; b < 4; b++) {
+        bits[b] = (value & (0x08 >> b)) ? '1' : '0';
+    }
+    bits[4] = '\0';
+}
+
+
+void loggerModem::setNetworkHint(const networkHint& hint) {
+    _networkHint        = hint;
+    _networkHintChanged = false;
+    // Make sure the operator code is terminated
+    _networkHint.plmn[sizeof(_networkHint.plmn) - 1] = '\0';
+}
+bool loggerModem::getNetworkHint(networkHint& hint) {
+    hint                = _networkHint;
+    _networkHintChanged = false;
+    return _networkHint.plmn[0] != '\0' || _networkHint.channel != 0;
+}
+
+
+// Most modems can't read or pin their network
+bool loggerModem::readNetworkHint(networkHint& hint) {
+    (void)hint;
+    return false;
+}
+bool loggerModem::pinNetworkFxn(const networkHint* hint) {
+    (void)hint;
+    return false;
+}
+bool loggerModem::isNetworkRegistered(void) {
+    return true;
+}
+
+
+// The connection steps only wait between polls; each step that talks to the
+// modem is a single exchange or short sequence of them
+void loggerModem::startConnect(uint32_t maxConnectionTime) {
+    MS_DBG(F("Starting to bring up"), getModemName(), F("for up to"),
+           maxConnectionTime, F("ms"));
+    _connectStart   = millis();
+    _connectTimeout = maxConnectionTime;
+    _pollPinned     = false;
+    if (_millisPowerOn == 0) modemPowerUp();
+    setModemPinModes();
+    _connectState = statePowering;
+}
+loggerModem::modemState loggerModem::poll(void) {
+    if (_connectState == stateOff || _connectState == stateConnected ||
+        _connectState == stateFailed) {
+        return _connectState;
+    }
+    uint32_t elapsed = millis() - _connectStart;
+    if (elapsed > _connectTimeout) {
+        MS_DBG(getModemName(), F("did not connect within"), _connectTimeout,
+               F("ms"));
+        if (_pollPinned) pinNetworkFxn(nullptr);
+        _pollPinned   = false;
+        _connectState = stateFailed;
+        recordConnectTime(_connectTimeout);
+        return _connectState;
+    }
+
+    switch (_connectState) {
+        case statePowering:
+            if (millis() - _millisPowerOn >= _wakeDelayTime_ms) {
+                _connectState = stateBooting;
+            }
+            break;
+        case stateBooting:
+            if (!modemWake()) {
+                _connectState = stateFailed;
+                break;
+            }
+            // Try the last network before scanning for all of them
+            if (_networkHint.plmn[0] != '\0' && !isNetworkRegistered()) {
+                MS_DBG(F("Trying the last network,"), _networkHint.plmn,
+                       F("first..."));
+                _pollPinned = pinNetworkFxn(&_networkHint);
+            }
+            _registerStart = millis();
+            _lastPoll      = millis();
+            _connectState  = stateRegistering;
+            setPowerState(powerConnecting);
+            break;
+        case stateRegistering:
+            if (millis() - _lastPoll < MS_MODEM_POLL_INTERVAL_MS) break;
+            _lastPoll = millis();
+            if (isNetworkRegistered()) {
+                MS_DBG(getModemName(), F("registered after"), elapsed,
+                       F("ms"));
+                _pollPinned   = false;
+                _connectState = stateAttaching;
+            } else if (_pollPinned &&
+                       millis() - _registerStart > MS_PINNED_ATTACH_TIME_MS) {
+                MS_DBG(F("... not found; scanning all networks..."));
+                pinNetworkFxn(nullptr);
+                _pollPinned = false;
+            } else if (_adaptiveTimeout && !_pollPinned &&
+                       millis() - _registerStart >
+                           MS_MODEM_NO_SIGNAL_GIVE_UP_MS) {
+                // With no signal at all, registration isn't coming
+                int16_t rssi    = 0;
+                int16_t percent = 0;
+                if (getModemSignalQuality(rssi, percent) && rssi == 0) {
+                    MS_DBG(getModemName(), F("has no signal; giving up"));
+                    recordConnectTime(_connectTimeout);
+                    _connectState = stateFailed;
+                }
+            }
+            break;
+        case stateAttaching:
+            _connectState = connectInternet(_connectTimeout - elapsed)
+                ? stateConnected
+                : stateFailed;
+            recordConnectTime(_connectState == stateConnected
+                                  ? millis() - _connectStart
+                                  : _connectTimeout);
+            break;
+        default: break;
+    }
+    return _connectState;
+}
+
+
+// The 95th percentile is the nearest rank in the sorted times
+uint32_t loggerModem::getConnectTimeout(uint32_t maxConnectionTime) {
+    if (!_adaptiveTimeout ||
+        _connectTimeCount < (MS_MODEM_CONNECT_HISTORY + 1) / 2) {
+        return maxConnectionTime;
+    }
+    uint16_t sorted[MS_MODEM_CONNECT_HISTORY];
+    for (uint8_t i = 0; i < _connectTimeCount; i++) {
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > _connectTimes[i]) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = _connectTimes[i];
+    }
+    uint8_t  rank    = (95 * _connectTimeCount + 99) / 100;
+    uint32_t slowest = static_cast<uint32_t>(sorted[rank - 1]) * 100;
+    uint32_t timeout = slowest + slowest / 4 + MS_MODEM_CONNECT_MARGIN_MS;
+    MS_DBG(F("Recent connections took up to"), slowest, F("ms; allowing"),
+           timeout, F("ms"));
+    return timeout < maxConnectionTime ? timeout : maxConnectionTime;
+}
+void loggerModem::recordConnectTime(uint32_t connectTime_ms) {
+    uint32_t tenths = connectTime_ms / 100;
+    if (tenths > 0xFFFF) tenths = 0xFFFF;
+    if (_connectTimeCount < MS_MODEM_CONNECT_HISTORY) _connectTimeCount++;
+    for (uint8_t i = _connectTimeCount - 1; i > 0; i--) {
+        _connectTimes[i] = _connectTimes[i - 1];
+    }
+    _connectTimes[0] = tenths;
+}
+uint8_t loggerModem::getConnectHistory(uint16_t* times) {
+    memcpy(times, _connectTimes, sizeof(_connectTimes));
+    return _connectTimeCount;
+}
+void loggerModem::restoreConnectHistory(const uint16_t* times,
+                                        uint8_t count) {
+    _connectTimeCount = count < MS_MODEM_CONNECT_HISTORY
+        ? count
+        : MS_MODEM_CONNECT_HISTORY;
+    memcpy(_connectTimes, times, _connectTimeCount * sizeof(uint16_t));
+}
+
+
+void loggerModem::updateNetworkHint(void) {
+    networkHint current = {};
+    if (!readNetworkHint(current)) return;
+    if (current.channel != 0) {
+        MS_DBG(F("Joined the access point on channel"), current.channel);
+    } else {
+        MS_DBG(F("Registered on"), current.plmn, F("with access technology"),
+               current.rat, F("on band"), current.band);
+    }
+    if (memcmp(&current, &_networkHint, sizeof(networkHint)) != 0) {
+        _networkHint        = current;
+        _networkHintChanged = true;
+    }
+}
+
+
+// This reads the address from the last quoted part of a DNS response
+bool loggerModem::parseQuotedIP(const String& response, IPAddress& ip) {
+    int end   = response.lastIndexOf('"');
+    int start = end > 0 ? response.lastIndexOf('"', end - 1) : -1;
+    if (start < 0) return false;
+    return ip.fromString(response.substring(start + 1, end).c_str());
+}
+
+// Each line of the head ends with "\r\n"
+bool loggerModem::readHttpLine(const char* head, size_t headLen, size_t& pos,
+                               String& line) {
+    line = "";
+    while (pos < headLen && head[pos] != '\r' && head[pos] != '\n') {
+        line += head[pos++];
+    }
+    while (pos < headLen && (head[pos] == '\r' || head[pos] == '\n')) {
+        if (head[pos++] == '\n') break;
+    }
+    return line.length() > 0;
+}
+
 float loggerModem::getModemRSSI() {
     float retVal = loggerModem::_priorRSSI;
     MS_DEEP_DBG(F("PRIOR RSSI:"), retVal);
@@ -391,6 +836,78 @@ float loggerModem::getModemTemperature() {
     MS_DEEP_DBG(F("PRIOR Modem Chip Temperature:"), retVal);
     return retVal;
 }
+float loggerModem::getModemActivationDuration() {
+    return loggerModem::_priorActivationDuration;
+}
+float loggerModem::getModemPoweredDuration() {
+    return loggerModem::_priorPoweredDuration;
+}
+float loggerModem::getModemTotalPoweredTime() {
+    return loggerModem::_totalPoweredTime;
+}
+float loggerModem::getModemEnergyUsed() {
+    return loggerModem::_priorEnergyUsed;
+}
+float loggerModem::getModemTotalEnergy() {
+    if (loggerModem::_priorEnergyUsed == -9999) return -9999;
+    return loggerModem::_totalEnergyUsed;
+}
+
+
+void loggerModem::setCurrentModel(float asleep_mA, float awake_mA,
+                                  float connecting_mA, float connected_mA) {
+    _stateCurrents[powerAsleep]     = asleep_mA;
+    _stateCurrents[powerAwake]      = awake_mA;
+    _stateCurrents[powerConnecting] = connecting_mA;
+    _stateCurrents[powerConnected]  = connected_mA;
+}
+uint32_t loggerModem::getPowerStateTime(modemPowerState state) {
+    if (state >= powerStateCount) return 0;
+    uint32_t stateTime = _powerStateTimes[state];
+    if (state == _powerState) stateTime += millis() - _powerStateStart;
+    return stateTime;
+}
+
+
+// The time while off isn't counted; nothing is drawn
+void loggerModem::setPowerState(modemPowerState state) {
+    uint32_t now = millis();
+    if (_powerState != powerOff) {
+        _powerStateTimes[_powerState] += now - _powerStateStart;
+    }
+    _powerState      = state;
+    _powerStateStart = now;
+}
+void loggerModem::endPowerCycle(void) {
+    // Count the time in the state the modem is left in up to now
+    setPowerState(_powerState);
+    uint32_t active = _powerStateTimes[powerAwake] +
+        _powerStateTimes[powerConnecting] + _powerStateTimes[powerConnected];
+    uint32_t powered = active + _powerStateTimes[powerAsleep];
+    _priorActivationDuration = active / 1000.0;
+    _priorPoweredDuration    = powered / 1000.0;
+    _totalPoweredTime += _priorPoweredDuration;
+
+    // A milliamp for a millisecond is 1/3600000 mAh
+    float charge   = 0;
+    bool  hasModel = false;
+    for (uint8_t i = powerAsleep; i < powerStateCount; i++) {
+        charge += _powerStateTimes[i] * _stateCurrents[i] / 3600000.0;
+        if (_stateCurrents[i] > 0) hasModel = true;
+        _powerStateTimes[i] = 0;
+    }
+    _priorEnergyUsed = hasModel ? charge : -9999;
+    if (hasModel) _totalEnergyUsed += charge;
+    MS_DBG(getModemName(), F("was active for"), _priorActivationDuration,
+           F("s and powered for"), _priorPoweredDuration, F("s this cycle"));
+#ifdef MS_MODEM_PROFILE_AT
+    atProfiler.endCycle();
+#if defined(STANDARD_SERIAL_OUTPUT)
+    PRINTOUT(getModemName(), F("AT command profile:"));
+    atProfiler.printSummary(STANDARD_SERIAL_OUTPUT);
+#endif
+#endif
+}
 
 // Helper to get approximate RSSI from CSQ (assuming no noise)
 int16_t loggerModem::getRSSIFromCSQ(int16_t csq) {
@@ -430,6 +947,93 @@ int16_t loggerModem::getPctFromRSSI(int16_t rssi) {
 }
 
 
+// Tries the time sources from the cheapest to the most expensive
+uint32_t loggerModem::getUTCTime(void) {
+    uint32_t utc = 0;
+    if (_useNITZ) {
+        utc = getNITZTime();
+        if (utc != 0) {
+            MS_DBG(F("Got the time from the network:"), utc);
+            return utc;
+        }
+    }
+    if (_useSNTP && isInternetAvailable()) {
+        utc = getSNTPTime();
+        if (utc != 0) {
+            MS_DBG(F("Got the time from"), MS_SNTP_SERVER, ':', utc);
+            return utc;
+        }
+    }
+    return getNISTTime();
+}
+
+
+void loggerModem::setTimeSources(bool useNITZ, bool useSNTP) {
+    _useNITZ = useNITZ;
+    _useSNTP = useSNTP;
+}
+
+
+// Most modems don't have a network clock or an NTP client
+uint32_t loggerModem::getNITZTime(void) {
+    return 0;
+}
+uint32_t loggerModem::getSNTPTime(void) {
+    return 0;
+}
+
+
+// The fields can be separated by anything other than a digit; a "+" or "-"
+// after the seconds starts the time zone
+uint32_t loggerModem::parseModemClock(const String& text) {
+    int32_t fields[7] = {0, 0, 0, 0, 0, 0, 0};
+    uint8_t nFields   = 0;
+    int8_t  tzSign    = 0;
+    int32_t value     = -1;
+    for (unsigned int c = text.indexOf('"') + 1;
+         c < text.length() && nFields < 7; c++) {
+        char ch = text[c];
+        if (ch >= '0' && ch <= '9') {
+            value = (value < 0 ? 0 : value * 10) + (ch - '0');
+            continue;
+        }
+        if (value >= 0) {
+            fields[nFields++] = value;
+            value             = -1;
+        }
+        if (nFields == 6 && (ch == '+' || ch == '-')) {
+            tzSign = ch == '+' ? 1 : -1;
+        } else if (nFields >= 6) {
+            break;
+        }
+    }
+    if (value >= 0 && nFields < 7) fields[nFields++] = value;
+    if (nFields < 6) return 0;
+
+    int32_t year  = fields[0] < 100 ? fields[0] + 2000 : fields[0];
+    int32_t month = fields[1];
+    int32_t day   = fields[2];
+    if (year < 2019 || year >= 2030 || month < 1 || month > 12 || day < 1 ||
+        day > 31) {
+        return 0;
+    }
+
+    // The days since 1970 from the civil date, counting years from March
+    int32_t  y    = year - (month <= 2 ? 1 : 0);
+    int32_t  m    = month > 2 ? month - 3 : month + 9;
+    uint32_t yoe  = y % 400;
+    uint32_t doy  = (153 * m + 2) / 5 + day - 1;
+    uint32_t doe  = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = (y / 400) * 146097L + doe - 719468L;
+
+    uint32_t utc = days * 86400L + fields[3] * 3600L + fields[4] * 60L +
+        fields[5];
+    // The time zone is in quarter hours
+    utc -= tzSign * fields[6] * 900L;
+    return utc;
+}
+
+
 uint32_t loggerModem::parseNISTBytes(byte nistBytes[4]) {
     // Response is returned as 32-bit number as soon as connection is made
     // Connection is then immediately closed, so there is no need to close it
@@ -35,6 +35,124 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include <Arduino.h>
+#include <Client.h>
+#include "FastPin.h"
+#ifdef MS_MODEM_PROFILE_AT
+#include "ModemCommandProfiler.h"
+#endif
+
+#ifndef MS_MODEM_MUX_CLIENTS
+/**
+ * @brief The most extra sockets a modem will open at the same time as its
+ * default client, for concurrent publishing.
+ */
+#define MS_MODEM_MUX_CLIENTS 4
+#endif
+
+#ifndef MS_SNTP_SERVER
+/**
+ * @brief The NTP server modems with a built in NTP client get the time from.
+ */
+#define MS_SNTP_SERVER "pool.ntp.org"
+#endif
+
+#ifndef MS_PINNED_ATTACH_TIME_MS
+/**
+ * @brief The longest time in milliseconds to wait for registration on the
+ * last known network before falling back to a full network scan.
+ */
+#define MS_PINNED_ATTACH_TIME_MS 15000L
+#endif
+
+#ifndef MS_WIFI_REUSE_ADDRESS
+/**
+ * @brief Set to 1 for the WiFi modems to rejoin the last access point with
+ * the address it leased them last time, skipping DHCP, or to 0 to always ask
+ * for a new lease.
+ *
+ * Turn this off if the access point's leases are short enough that the
+ * address may be given to another device while the logger sleeps.
+ */
+#define MS_WIFI_REUSE_ADDRESS 1
+#endif
+
+#ifndef MS_MODEM_POLL_INTERVAL_MS
+/**
+ * @brief The shortest time in milliseconds between the registration checks
+ * made by loggerModem::poll().
+ */
+#define MS_MODEM_POLL_INTERVAL_MS 1000L
+#endif
+
+#ifndef MS_MODEM_MAX_BAUD
+/**
+ * @brief The fastest baud rate loggerModem::setBaudNegotiation() raises the
+ * modem to by default.
+ *
+ * This is the fastest common rate the processor's UART can make closely
+ * enough at its clock speed.
+ */
+#if F_CPU <= 8000000L
+#define MS_MODEM_MAX_BAUD 38400
+#elif F_CPU <= 16000000L
+#define MS_MODEM_MAX_BAUD 57600
+#else
+#define MS_MODEM_MAX_BAUD 460800
+#endif
+#endif
+
+#ifndef MS_MODEM_CONNECT_HISTORY
+/**
+ * @brief The number of recent connection times kept by
+ * loggerModem::recordConnectTime() for the adaptive timeout.
+ */
+#define MS_MODEM_CONNECT_HISTORY 8
+#endif
+
+#ifndef MS_MODEM_CONNECT_MARGIN_MS
+/**
+ * @brief The time in milliseconds added to the slowest recent connections to
+ * make the adaptive timeout.
+ */
+#define MS_MODEM_CONNECT_MARGIN_MS 10000L
+#endif
+
+#ifndef MS_MODEM_NO_SIGNAL_GIVE_UP_MS
+/**
+ * @brief How long in milliseconds poll() waits for registration with no
+ * signal at all before giving up, when the timeout is adaptive.
+ */
+#define MS_MODEM_NO_SIGNAL_GIVE_UP_MS 20000L
+#endif
+
+/**
+ * @anchor modem_metadata_fields
+ * @name Modem metadata fields
+ * The bits of the fields updateModemMetadata() collects; each modem Variable
+ * sets its own bit.
+ */
+/**@{*/
+/// @brief The RSSI; see Modem_RSSI
+#define MODEM_RSSI_ENABLE_BITMASK 0b00000001
+/// @brief The signal percent; see Modem_SignalPercent
+#define MODEM_PERCENT_SIGNAL_ENABLE_BITMASK 0b00000010
+/// @brief The battery charge state; see Modem_BatteryState
+#define MODEM_BATTERY_STATE_ENABLE_BITMASK 0b00000100
+/// @brief The battery charge percent; see Modem_BatteryPercent
+#define MODEM_BATTERY_PERCENT_ENABLE_BITMASK 0b00001000
+/// @brief The battery voltage; see Modem_BatteryVoltage
+#define MODEM_BATTERY_VOLTAGE_ENABLE_BITMASK 0b00010000
+/// @brief The chip temperature; see Modem_Temp
+#define MODEM_TEMPERATURE_ENABLE_BITMASK 0b00100000
+/// @brief Both of the signal fields
+#define MODEM_SIGNAL_FIELDS \
+    (MODEM_RSSI_ENABLE_BITMASK | MODEM_PERCENT_SIGNAL_ENABLE_BITMASK)
+/// @brief All three of the battery fields
+#define MODEM_BATTERY_FIELDS                 \
+    (MODEM_BATTERY_STATE_ENABLE_BITMASK |    \
+     MODEM_BATTERY_PERCENT_ENABLE_BITMASK | \
+     MODEM_BATTERY_VOLTAGE_ENABLE_BITMASK)
+/**@}*/
 
 
 /**
@@ -222,13 +340,11 @@
 #define MODEM_TEMPERATURE_DEFAULT_CODE "modemTemp"
 /**@}*/
 
-#ifdef MS_CHECK_MODEM_TIMING
 /**
  * @anchor modem_activation
  * @name Modem Active Time
- * The active time from a modem-like device.
- *
- * @note This is only a testing/development diagnostic.
+ * The time a modem-like device was awake in its last cycle, from waking to
+ * being put to sleep.
  *
  * {{ @ref Modem_ActivationDuration::Modem_ActivationDuration }}
  */
@@ -250,9 +366,7 @@
 /**
  * @anchor modem_power
  * @name Modem Power Time
- * The total powered time from a modem-like device.
- *
- * @note This is only a testing/development diagnostic.
+ * The time a modem-like device was powered in its last cycle.
  *
  * {{ @ref Modem_PoweredDuration::Modem_PoweredDuration }}
  */
@@ -270,7 +384,75 @@
 /// @brief Default variable short code; "modemPoweredSec"
 #define MODEM_POWERED_DEFAULT_CODE "modemPoweredSec"
 /**@}*/
-#endif
+
+/**
+ * @anchor modem_total_power
+ * @name Modem Total Power Time
+ * The total time a modem-like device has been powered since the logger
+ * started.
+ *
+ * {{ @ref Modem_TotalPoweredTime::Modem_TotalPoweredTime }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; total powered time should
+/// have 1.
+#define MODEM_TOTAL_POWERED_RESOLUTION 1
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "timeElapsed"
+#define MODEM_TOTAL_POWERED_VAR_NAME "timeElapsed"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "second"
+#define MODEM_TOTAL_POWERED_UNIT_NAME "second"
+/// @brief Default variable short code; "modemTotalPoweredSec"
+#define MODEM_TOTAL_POWERED_DEFAULT_CODE "modemTotalPoweredSec"
+/**@}*/
+
+/**
+ * @anchor modem_energy
+ * @name Modem Energy
+ * The charge a modem-like device used in its last cycle, estimated from the
+ * time in each power state and the current model given with
+ * loggerModem::setCurrentModel().
+ *
+ * {{ @ref Modem_EnergyUsed::Modem_EnergyUsed }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the charge should have 4.
+#define MODEM_ENERGY_RESOLUTION 4
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "electricCharge"
+#define MODEM_ENERGY_VAR_NAME "electricCharge"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "milliampHour" (mAh)
+#define MODEM_ENERGY_UNIT_NAME "milliampHour"
+/// @brief Default variable short code; "modemCharge"
+#define MODEM_ENERGY_DEFAULT_CODE "modemCharge"
+/**@}*/
+
+/**
+ * @anchor modem_total_energy
+ * @name Modem Total Energy
+ * The charge a modem-like device has used since the logger started.
+ *
+ * {{ @ref Modem_TotalEnergy::Modem_TotalEnergy }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the charge should have 3.
+#define MODEM_TOTAL_ENERGY_RESOLUTION 3
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "electricCharge"
+#define MODEM_TOTAL_ENERGY_VAR_NAME "electricCharge"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "milliampHour" (mAh)
+#define MODEM_TOTAL_ENERGY_UNIT_NAME "milliampHour"
+/// @brief Default variable short code; "modemTotalCharge"
+#define MODEM_TOTAL_ENERGY_DEFAULT_CODE "modemTotalCharge"
+/**@}*/
 /**@}*/
 
 
@@ -296,6 +478,55 @@
  */
 class loggerModem {
  public:
+    /**
+     * @brief The radio access technologies a network hint can pin a modem
+     * to.
+     */
+    typedef enum {
+        ratUnknown = 0,  ///< Not known
+        ratGSM,          ///< 2G GSM/GPRS
+        ratCatM,         ///< LTE Cat-M1
+        ratNBIoT         ///< NB-IoT
+    } networkRAT;
+    /**
+     * @brief The network a cellular modem last registered on, or the access
+     * point a WiFi modem last joined.
+     */
+    typedef struct {
+        char    plmn[7];     ///< The operator's MCC and MNC, like "310410"
+        uint8_t rat;         ///< The #networkRAT
+        uint8_t band;        ///< The band number, or 0 if not known
+        uint8_t bssid[6];    ///< The access point's BSSID, if known
+        uint8_t channel;     ///< The WiFi channel, or 0 if not joined
+        uint8_t ip[4];       ///< The address the access point leased
+        uint8_t gateway[4];  ///< The gateway of the lease
+        uint8_t netmask[4];  ///< The subnet mask of the lease
+    } networkHint;
+    /**
+     * @brief The steps of bringing the modem up with startConnect() and
+     * poll().
+     */
+    typedef enum {
+        stateOff = 0,      ///< Not being brought up
+        statePowering,     ///< Waiting for the warm-up after power on
+        stateBooting,      ///< Waking and waiting for AT responses
+        stateRegistering,  ///< Waiting for network registration
+        stateAttaching,    ///< Opening the data connection
+        stateConnected,    ///< Connected to the internet
+        stateFailed        ///< Gave up
+    } modemState;
+    /**
+     * @brief The power states the modem's time is counted in.
+     */
+    typedef enum {
+        powerOff = 0,     ///< Not powered
+        powerAsleep,      ///< Powered, but asleep or warming up
+        powerAwake,       ///< Awake and answering commands
+        powerConnecting,  ///< Registering and connecting to the internet
+        powerConnected,   ///< Connected, sending data
+        powerStateCount   ///< The number of power states
+    } modemPowerState;
+
     /**
      * @brief Construct a new loggerModem object.
      *
@@ -424,6 +655,72 @@ class loggerModem {
      * state _and_ then powered off
      */
     virtual bool modemSleepPowerDown(void);
+    /**
+     * @brief Ask the network for power saving mode (PSM) timers, and
+     * optionally an extended discontinuous reception (eDRX) cycle, so the
+     * modem can stay registered between logging intervals.
+     *
+     * With power saving on, modemSleep() and modemSleepPowerDown() leave the
+     * modem powered and registered; it enters PSM by itself once the active
+     * time runs out after its last transmission.  The logger keeps the data
+     * (PDP) context open, so connectInternet() only has to wake the modem
+     * rather than search for and attach to a network.  The periodic tracking
+     * area update (TAU) should be longer than the logging interval, or the
+     * modem will wake between intervals to check in with the network.
+     *
+     * The timers are sent in modemSetup(), so this must be called before the
+     * modem is set up.  The network may grant different timers, or none.
+     * Only modems created with #MS_MODEM_SET_POWER_SAVING support this.
+     *
+     * @param periodicTAUSeconds The requested periodic TAU (T3412) in seconds;
+     * 0 to turn power saving off
+     * @param activeTimeSeconds The requested active time (T3324) in seconds
+     * @param eDRXSeconds The requested eDRX cycle in seconds, or 0 for no
+     * eDRX.  Defaults to 0.
+     */
+    void setPowerSavingMode(uint32_t periodicTAUSeconds,
+                            uint16_t activeTimeSeconds,
+                            uint16_t eDRXSeconds = 0);
+    /**
+     * @brief Check whether the modem was set up with power saving mode.
+     *
+     * @return **bool** True if the modem accepted the power saving timers
+     * from setPowerSavingMode()
+     */
+    bool isPowerSaving(void) {
+        return _powerSaving;
+    }
+    /**
+     * @brief Set the modem to run its serial port as fast as the processor
+     * can reliably follow.
+     *
+     * Most modems start at 9600 to 115200 baud, which makes the upload of a
+     * large batch take several times longer than the radio needs.  With
+     * negotiation, each time the modem is woken or set up the logger finds
+     * the rate the modem is at, from the last rate used and then the common
+     * rates, and asks it for each faster common rate in turn up to the
+     * maximum.  A rate is kept only if the modem answers three AT commands
+     * in a row at it; otherwise the modem is put back on the last good rate.
+     * Only modems created with #MS_MODEM_SET_BAUD support this.
+     *
+     * @param modemSerial The serial port the modem is on
+     * @param currentBaud The rate the serial port was started at
+     * @param maxBaud The fastest rate to use.  Default is #MS_MODEM_MAX_BAUD.
+     * @param flowControl True to turn on the modem's RTS/CTS hardware flow
+     * control.  Only use this if the serial port was created with flow
+     * control pins that are connected to the modem.  Default is false.
+     */
+    void setBaudNegotiation(HardwareSerial* modemSerial, uint32_t currentBaud,
+                            uint32_t maxBaud = MS_MODEM_MAX_BAUD,
+                            bool flowControl = false);
+    /**
+     * @brief Get the baud rate the modem was last found at.
+     *
+     * @return **uint32_t** The baud rate; 0 if the rate isn't negotiated
+     */
+    uint32_t getModemBaud(void) {
+        return _modemBaud;
+    }
     /**@}*/
 
     /**
@@ -507,6 +804,90 @@ class loggerModem {
      * the cellular network.
      */
     virtual void disconnectInternet(void) = 0;
+    /**
+     * @brief Start bringing the modem up and connected to the internet
+     * without waiting for it.
+     *
+     * Each call to poll() then moves the modem through the #modemState steps
+     * as far as it can without waiting: the warm-up and network registration
+     * are waited out between polls, while the wake and the data connection
+     * each run as a single short step.  This lets the logger measure its
+     * sensors and write to the SD card while the modem registers.
+     *
+     * @param maxConnectionTime The longest time in milliseconds for the whole
+     * bring-up, from now.  Defaults to 50,000ms (50s).
+     */
+    void startConnect(uint32_t maxConnectionTime = 50000L);
+    /**
+     * @brief Take the next step toward the connection started by
+     * startConnect(), if it is ready.
+     *
+     * Registration is checked at most every #MS_MODEM_POLL_INTERVAL_MS, so
+     * this can be called as often as convenient.
+     *
+     * @return **modemState** The step the modem is on after this poll
+     */
+    modemState poll(void);
+    /**
+     * @brief Get the step of the connection started by startConnect().
+     *
+     * @return **modemState** The step the modem is on
+     */
+    modemState getState(void) {
+        return _connectState;
+    }
+    /**
+     * @brief Set whether the connection timeout is learned from the recent
+     * connection times of this modem.
+     *
+     * Some sites always register in a few seconds, while others take most
+     * of a minute.  With an adaptive timeout, getConnectTimeout() gives the
+     * 95th percentile of the last #MS_MODEM_CONNECT_HISTORY connection times
+     * plus a quarter and #MS_MODEM_CONNECT_MARGIN_MS, so the modem doesn't
+     * sit on a hopeless attempt for the full time.  A failed attempt counts
+     * as taking its whole timeout, so the timeout grows back after failures.
+     * While connecting with poll(), the attempt is also dropped once the
+     * modem has seen no signal at all for #MS_MODEM_NO_SIGNAL_GIVE_UP_MS.
+     *
+     * @param enable True to adapt the timeout.  Default is true.
+     */
+    void setAdaptiveTimeout(bool enable = true) {
+        _adaptiveTimeout = enable;
+    }
+    /**
+     * @brief Get the time to allow for connecting to the internet.
+     *
+     * @param maxConnectionTime The longest time allowed, in milliseconds
+     * @return **uint32_t** The adaptive timeout, if enabled and at least
+     * half of the history has been filled, but no more than the maximum;
+     * otherwise the maximum.
+     */
+    uint32_t getConnectTimeout(uint32_t maxConnectionTime);
+    /**
+     * @brief Add the time a connection took to the history the adaptive
+     * timeout is learned from.
+     *
+     * Connections made with poll() are added automatically.
+     *
+     * @param connectTime_ms The time the connection took, or the timeout of
+     * a failed connection, in milliseconds
+     */
+    void recordConnectTime(uint32_t connectTime_ms);
+    /**
+     * @brief Copy out the history of connection times, to be saved.
+     *
+     * @param times An array of #MS_MODEM_CONNECT_HISTORY for the times, in
+     * tenths of a second, newest first
+     * @return **uint8_t** The number of times in the history
+     */
+    uint8_t getConnectHistory(uint16_t* times);
+    /**
+     * @brief Put back a saved history of connection times.
+     *
+     * @param times The times, in tenths of a second, newest first
+     * @param count The number of times
+     */
+    void restoreConnectHistory(const uint16_t* times, uint8_t count);
 
 
     /**
@@ -520,6 +901,32 @@ class loggerModem {
      * @return **uint32_t** The number of seconds since Jan 1, 1970 IN UTC
      */
     virtual uint32_t getNISTTime(void) = 0;
+    /**
+     * @brief Get the time from the cheapest source the modem has.
+     *
+     * The sources are tried in order:
+     * - the modem's clock (AT+CCLK), if the network has set it by NITZ; this
+     * only needs the modem to be registered
+     * - a single SNTP request from the modem's own NTP client to
+     * #MS_SNTP_SERVER
+     * - NIST's TIME protocol server over TCP, with getNISTTime()
+     *
+     * @return **uint32_t** The number of seconds since Jan 1, 1970 IN UTC, or
+     * 0 if no source was available
+     */
+    uint32_t getUTCTime(void);
+    /**
+     * @brief Set which of the cheaper time sources getUTCTime() may use
+     * before falling back to NIST.
+     *
+     * Some networks don't send NITZ, or send a time that is off by a few
+     * seconds.
+     *
+     * @param useNITZ True to use the network time in the modem's clock.
+     * Default is true.
+     * @param useSNTP True to use the modem's NTP client.  Default is true.
+     */
+    void setTimeSources(bool useNITZ, bool useSNTP = true);
     /**@}*/
 
 
@@ -576,13 +983,178 @@ class loggerModem {
      * @brief Query the modem for signal quality, battery, and temperature
      * information and store the values to the static internal variables.
      *
+     * Only the fields set with enableMetadataFields() are queried; the
+     * others are set to -9999.  With no fields set, as when the logger has no
+     * modem Variables, the modem isn't asked anything.
+     *
      * @return **bool** True indicates that the communication with the modem was
      * successful and the values of the internal static variables should be
      * valid.
      */
     virtual bool updateModemMetadata(void);
+    /**
+     * @brief Add to the metadata fields collected by updateModemMetadata().
+     *
+     * Each modem Variable adds its own field when it's created, so this is
+     * only needed for a field no Variable reports.
+     *
+     * @param fields The bits of the fields to add; see
+     * @ref modem_metadata_fields
+     */
+    static void enableMetadataFields(uint8_t fields) {
+        _metadataFields |= fields;
+    }
+    /**
+     * @brief Get the metadata fields collected by updateModemMetadata().
+     *
+     * @return **uint8_t** The bits of the fields; see
+     * @ref modem_metadata_fields
+     */
+    static uint8_t getMetadataFields(void) {
+        return _metadataFields;
+    }
+
+    /**
+     * @brief Get a client for one of the extra sockets the modem can hold
+     * open at the same time as its default client.
+     *
+     * The client is created the first time it is asked for and kept for the
+     * life of the modem.  Only modems that can multiplex several TCP
+     * connections support this.
+     *
+     * @param socketNum The number of the extra socket, starting at 0
+     * @return **Client\*** A client for the socket, or a nullptr if the modem
+     * cannot have that many sockets open.
+     */
+    virtual Client* getMuxClient(uint8_t socketNum);
+    /**
+     * @brief Look up the IP address of a host name with the modem's DNS.
+     *
+     * This lets the publishers keep the address between logging intervals
+     * and connect by IP, skipping the lookup the modem would otherwise do on
+     * every connection; see dataPublisher::setHostCache().  Only modems with
+     * a separate DNS command support this.
+     *
+     * @param host The host name to look up
+     * @param ip The address of the host, if found
+     * @return **bool** True if the address was found
+     */
+    virtual bool lookupHostIP(const char* host, IPAddress& ip);
+    /**
+     * @brief Get the most data the modem sends in one socket send.
+     *
+     * The publishers fill their TX buffer up to this before writing it to
+     * the client, so no write is split into a full send and a small one; see
+     * dataPublisher::txBufferInit().
+     *
+     * @return **uint16_t** The most bytes in one send, or 0 if the modem
+     * takes a write of any size in one go
+     */
+    virtual uint16_t getMaxSendSize(void);
+    /**
+     * @brief Send a whole HTTP request with the modem's own HTTP(S) client.
+     *
+     * The request is given to the modem in a few AT commands instead of
+     * being written into a socket; see NativeHttpClient.  Only modems with an
+     * HTTP application support this.
+     *
+     * @param host The host name to send the request to
+     * @param port The port to send the request to
+     * @param useTls True to send the request with the modem's TLS
+     * @param head The request line and headers, ending with the blank line
+     * @param headLen The length of the head
+     * @param body The body of the request
+     * @param bodyLen The length of the body; may be 0
+     * @return **int16_t** The http response code; 504 if the request was sent
+     * but there was no response; 0 if the request was not sent, so it can be
+     * sent over a socket instead.
+     */
+    virtual int16_t nativeHttpRequest(const char* host, uint16_t port,
+                                      bool useTls, const char* head,
+                                      size_t headLen, const char* body,
+                                      size_t bodyLen);
+    /**
+     * @brief Set the network to try first when connecting to the internet.
+     *
+     * If the modem isn't already registered, connectInternet() pins the
+     * modem to the operator, access technology and band of the hint for up
+     * to #MS_PINNED_ATTACH_TIME_MS.  If it cannot register there, the modem
+     * is returned to automatic selection over all technologies and bands
+     * and does a full scan.  A WiFi modem that isn't already joined rejoins
+     * the access point of the hint directly, without a scan, and with its
+     * last address if #MS_WIFI_REUSE_ADDRESS is set.  The logger saves the
+     * hint to the SD card so it is kept through a restart.  Only modems that
+     * can read and pin their network support this.
+     *
+     * @param hint The network to try first
+     */
+    void setNetworkHint(const networkHint& hint);
+    /**
+     * @brief Get the network the modem last registered on.
+     *
+     * This also clears the flag returned by networkHintChanged().
+     *
+     * @param hint The last network
+     * @return **bool** True if there is a last network
+     */
+    bool getNetworkHint(networkHint& hint);
+    /**
+     * @brief Check whether the modem registered on a different network than
+     * the hint since getNetworkHint() was last called.
+     *
+     * @return **bool** True if the hint should be saved again
+     */
+    bool networkHintChanged(void) {
+        return _networkHintChanged;
+    }
+    /**@}*/
+
+    /**
+     * @anchor modem_energy_functions
+     * @name Functions for the time and charge used in each power state
+     */
+    /**@{*/
+    /**
+     * @brief Set the current the modem draws in each power state, to estimate
+     * the charge it uses.
+     *
+     * Without a current model, the charge Variables report -9999.  The
+     * currents are best measured, since they depend on the board, the
+     * network and the signal as much as the modem.
+     *
+     * @param asleep_mA The current while powered but asleep or warming up
+     * @param awake_mA The current while awake and idle
+     * @param connecting_mA The current while registering and connecting
+     * @param connected_mA The current while connected and sending data
+     */
+    void setCurrentModel(float asleep_mA, float awake_mA, float connecting_mA,
+                         float connected_mA);
+    /**
+     * @brief Get the time the modem has spent in a power state in the current
+     * cycle.
+     *
+     * A cycle ends when the modem is put to sleep and powered down with
+     * modemSleepPowerDown(); the times are then moved to the stored values
+     * returned by the static functions.
+     *
+     * @param state The power state
+     * @return **uint32_t** The time in the state in milliseconds
+     */
+    uint32_t getPowerStateTime(modemPowerState state);
     /**@}*/
 
+#ifdef MS_MODEM_PROFILE_AT
+    /**
+     * @brief The profiler of the AT commands sent to the modem.
+     *
+     * Each TinyGSM modem is given this in place of its stream, with
+     * #MS_MODEM_AT_STREAM, when `MS_MODEM_PROFILE_AT` is defined.  Its
+     * summary is printed at the end of each power cycle, and the logger
+     * adds it to the `<logger id>_atprofile.txt` file on the SD card.
+     */
+    ModemCommandProfiler atProfiler;
+#endif
+
     /**
      * @anchor modem_static_functions
      * @name Functions to return the current value of static member variables
@@ -647,6 +1219,45 @@ class loggerModem {
      * @return **float** The stored temperature in degrees Celsius
      */
     static float getModemTemperature();
+
+    /**
+     * @brief Get the time the modem was awake in its last cycle.
+     *
+     * @return **float** The stored active time in seconds
+     */
+    static float getModemActivationDuration();
+
+    /**
+     * @brief Get the time the modem was powered in its last cycle.
+     *
+     * @return **float** The stored powered time in seconds
+     */
+    static float getModemPoweredDuration();
+
+    /**
+     * @brief Get the total time the modem has been powered since the logger
+     * started, up to the end of its last cycle.
+     *
+     * @return **float** The stored total powered time in seconds
+     */
+    static float getModemTotalPoweredTime();
+
+    /**
+     * @brief Get the charge the modem used in its last cycle.
+     *
+     * @return **float** The stored charge in mAh, or -9999 without a current
+     * model
+     */
+    static float getModemEnergyUsed();
+
+    /**
+     * @brief Get the total charge the modem has used since the logger
+     * started, up to the end of its last cycle.
+     *
+     * @return **float** The stored total charge in mAh, or -9999 without a
+     * current model
+     */
+    static float getModemTotalEnergy();
     /**@}*/
 
  protected:
@@ -701,6 +1312,159 @@ class loggerModem {
      * pull-up) for all pins connected between the modem module and the mcu.
      */
     virtual void setModemPinModes(void);
+    /**
+     * @brief Read the last quoted IP address in the text of a DNS response.
+     *
+     * @param response The text of the response, like `1,"host","1.2.3.4"`
+     * @param ip The address read
+     * @return **bool** True if an address was read
+     */
+    static bool parseQuotedIP(const String& response, IPAddress& ip);
+    /**
+     * @brief Read the next line of the head of an HTTP request.
+     *
+     * @param head The request line and headers
+     * @param headLen The length of the head
+     * @param pos The position of the line to read, which is moved to the
+     * start of the next line
+     * @param line The line read, without its line ending
+     * @return **bool** True if a line was read; false at the blank line that
+     * ends the head
+     */
+    static bool readHttpLine(const char* head, size_t headLen, size_t& pos,
+                             String& line);
+    /**
+     * @brief Write a 3GPP PSM timer as the 8 character bit string used by
+     * AT+CPSMS.
+     *
+     * The first three bits are the unit and the last five the multiplier.
+     * The smallest unit that can hold the time is used, rounding up.
+     *
+     * @param seconds The time in seconds
+     * @param activeTimer True for the active time (T3324); false for the
+     * periodic TAU (T3412)
+     * @param bits The buffer for the bit string; at least 9 characters
+     */
+    static void encodePSMTimer(uint32_t seconds, bool activeTimer, char* bits);
+    /**
+     * @brief Write an eDRX cycle as the 4 character bit string used by
+     * AT+CEDRXS.
+     *
+     * The longest LTE-M cycle that is no longer than the time is used.
+     *
+     * @param seconds The eDRX cycle in seconds
+     * @param bits The buffer for the bit string; at least 5 characters
+     */
+    static void encodeEDRXCycle(uint16_t seconds, char* bits);
+    /**
+     * @brief Send the power saving timers from setPowerSavingMode() to the
+     * modem.
+     *
+     * For the modems that support it, this function is created by the
+     * #MS_MODEM_SET_POWER_SAVING macro.  By default it does nothing and
+     * returns false.
+     *
+     * @return **bool** True if the modem accepted the timers
+     */
+    virtual bool setPowerSavingFxn(void);
+    /**
+     * @brief Ask the modem to change its baud rate.
+     *
+     * For the modems that support it, this function is created by the
+     * #MS_MODEM_SET_BAUD macro.  By default it does nothing and returns false.
+     *
+     * @param baud The new baud rate
+     * @return **bool** True if the modem accepted the rate; it answers at the
+     * old rate and then switches
+     */
+    virtual bool setBaudFxn(uint32_t baud);
+    /**
+     * @brief Check that the modem answers an AT command at the current baud
+     * rate.
+     *
+     * By default this returns false.
+     *
+     * @param timeout_ms How long to wait for the answer, in milliseconds
+     * @return **bool** True if the modem answered
+     */
+    virtual bool testATFxn(uint32_t timeout_ms);
+    /**
+     * @brief Turn on the modem's RTS/CTS hardware flow control.
+     *
+     * By default this does nothing and returns false.
+     *
+     * @return **bool** True if the modem accepted the setting
+     */
+    virtual bool setFlowControlFxn(void);
+    /**
+     * @brief Find the modem's baud rate and raise it as far as is reliable.
+     *
+     * This does nothing unless setBaudNegotiation() has been called.
+     *
+     * @return **bool** True if the modem was found
+     */
+    bool negotiateBaud(void);
+    /**
+     * @brief Find the baud rate the modem answers at, starting with the last
+     * rate used, and start the serial port at it.
+     *
+     * @return **bool** True if the modem answered at some rate
+     */
+    bool findModemBaud(void);
+    /**
+     * @brief Read the operator, access technology and band the modem is
+     * registered on.
+     *
+     * By default this does nothing and returns false.
+     *
+     * @param hint The current network
+     * @return **bool** True if the network was read
+     */
+    virtual bool readNetworkHint(networkHint& hint);
+    /**
+     * @brief Pin the modem to a network, or return it to automatic network
+     * selection.
+     *
+     * By default this does nothing and returns false.
+     *
+     * @param hint The network to pin to, or a nullptr for automatic selection
+     * @return **bool** True if the modem accepted the settings
+     */
+    virtual bool pinNetworkFxn(const networkHint* hint);
+    /**
+     * @brief Check whether the modem is registered on a network, without
+     * waiting.
+     *
+     * For the cellular modems, this function is created by the
+     * #MS_MODEM_IS_NETWORK_REGISTERED macro.  By default it returns true, so
+     * poll() goes straight to connectInternet(), which then waits for the
+     * registration or, for WiFi modems, joins the network.
+     *
+     * @return **bool** True if the modem is registered
+     */
+    virtual bool isNetworkRegistered(void);
+    /**
+     * @brief Read the current network and note if it differs from the hint.
+     *
+     * This is called by connectInternet() after the modem registers or, for
+     * WiFi modems, joins the access point.
+     */
+    void updateNetworkHint(void);
+    /**
+     * @brief Count the time in the current power state and move to a new
+     * one.
+     *
+     * The wake and connect functions of each modem and the base power and
+     * sleep functions call this as the modem changes state.
+     *
+     * @param state The new power state
+     */
+    void setPowerState(modemPowerState state);
+    /**
+     * @brief End the current cycle, moving its times and charge to the stored
+     * values and adding them to the totals.
+     */
+    void endPowerCycle(void);
     /**@}*/
 
     /**
@@ -782,6 +1546,38 @@ class loggerModem {
      * UTC
      */
     static uint32_t parseNISTBytes(byte nistBytes[4]);
+    /**
+     * @brief Convert the text of a modem clock to a UTC timestamp.
+     *
+     * The text is the quoted `"yy/MM/dd,hh:mm:ss±zz"` of AT+CCLK, with the
+     * time zone in quarter hours; a four digit year and a missing time zone
+     * also work.
+     *
+     * @param text The text of the response, starting at or before the quote
+     * @return **uint32_t** The number of seconds since January 1, 1970
+     * 00:00:00 UTC, or 0 if the time could not be read or is before 2019 or
+     * after 2030
+     */
+    static uint32_t parseModemClock(const String& text);
+    /**
+     * @brief Get the time from the modem's clock, as set by the network's
+     * NITZ message.
+     *
+     * By default this does nothing and returns 0.
+     *
+     * @return **uint32_t** The number of seconds since Jan 1, 1970 IN UTC, or
+     * 0 if the clock hasn't been set
+     */
+    virtual uint32_t getNITZTime(void);
+    /**
+     * @brief Get the time with the modem's NTP client.
+     *
+     * By default this does nothing and returns 0.
+     *
+     * @return **uint32_t** The number of seconds since Jan 1, 1970 IN UTC, or
+     * 0 if the request failed
+     */
+    virtual uint32_t getSNTPTime(void);
 
     /**
      * @anchor modem_ctor_variables
@@ -895,6 +1691,16 @@ class loggerModem {
      * Should be set to a negative number if no LED is available.
      */
     int8_t _modemLEDPin;
+    /**
+     * @brief The port registers and bit masks of the modem's power, status,
+     * reset, and sleep request pins
+     */
+    /**@{*/
+    FastPin _powerIO;
+    FastPin _statusIO;
+    FastPin _modemResetIO;
+    FastPin _modemSleepRqIO;
+    /**@}*/
 
     /**
      * @brief The processor elapsed time when the power was turned on for the
@@ -923,6 +1729,114 @@ class loggerModem {
      * modem are set to the correct mode (ie, input vs output).
      */
     bool _pinModesSet = false;
+    /**
+     * @brief The requested periodic TAU in seconds; 0 if power saving mode
+     * has not been requested.
+     */
+    uint32_t _psmTAU_s = 0;
+    /**
+     * @brief The requested PSM active time in seconds.
+     */
+    uint16_t _psmActive_s = 0;
+    /**
+     * @brief The requested eDRX cycle in seconds; 0 for no eDRX.
+     */
+    uint16_t _eDRX_s = 0;
+    /**
+     * @brief Flag.  True indicates that the modem accepted the power saving
+     * timers and should be left registered while it sleeps.
+     */
+    bool _powerSaving = false;
+    /**
+     * @brief The serial port whose baud rate is negotiated, if any
+     */
+    HardwareSerial* _baudSerial = nullptr;
+    /**
+     * @brief The baud rate the modem was last found at
+     */
+    uint32_t _modemBaud = 0;
+    /**
+     * @brief The fastest baud rate to negotiate
+     */
+    uint32_t _maxBaud = MS_MODEM_MAX_BAUD;
+    /**
+     * @brief True to turn on the modem's hardware flow control
+     */
+    bool _flowControl = false;
+    /**
+     * @brief The network the modem last registered on; an empty PLMN if not
+     * known.
+     */
+    networkHint _networkHint = {};
+    /**
+     * @brief The step of the connection started by startConnect()
+     */
+    modemState _connectState = stateOff;
+    /**
+     * @brief The power state the modem is in
+     */
+    modemPowerState _powerState = powerOff;
+    /**
+     * @brief The millis() the modem entered its power state
+     */
+    uint32_t _powerStateStart = 0;
+    /**
+     * @brief The time spent in each power state in this cycle, in
+     * milliseconds
+     */
+    uint32_t _powerStateTimes[powerStateCount] = {};
+    /**
+     * @brief The current drawn in each power state, in mA; all 0 without a
+     * current model
+     */
+    float _stateCurrents[powerStateCount] = {};
+    /**
+     * @brief The millis() the connection was started
+     */
+    uint32_t _connectStart = 0;
+    /**
+     * @brief The longest time for the whole connection, in milliseconds
+     */
+    uint32_t _connectTimeout = 0;
+    /**
+     * @brief The millis() registration started being checked
+     */
+    uint32_t _registerStart = 0;
+    /**
+     * @brief The millis() of the last registration check
+     */
+    uint32_t _lastPoll = 0;
+    /**
+     * @brief True while the modem is pinned to the hinted network
+     */
+    bool _pollPinned = false;
+    /**
+     * @brief True to learn the connection timeout from the recent
+     * connection times
+     */
+    bool _adaptiveTimeout = false;
+    /**
+     * @brief The recent connection times in tenths of a second, newest
+     * first
+     */
+    uint16_t _connectTimes[MS_MODEM_CONNECT_HISTORY] = {};
+    /**
+     * @brief The number of connection times kept
+     */
+    uint8_t _connectTimeCount = 0;
+    /**
+     * @brief Flag.  True indicates that the modem registered on a network
+     * other than the saved hint.
+     */
+    bool _networkHintChanged = false;
+    /**
+     * @brief Flag.  True to try the network time before NIST.
+     */
+    bool _useNITZ = true;
+    /**
+     * @brief Flag.  True to try the modem's NTP client before NIST.
+     */
+    bool _useSNTP = true;
     /**@}*/
 
     // NOTE:  These must be static so that the modem variables can call the
@@ -975,8 +1889,42 @@ class loggerModem {
      * Returned by #getModemBatteryVoltage().
      */
     static float _priorBatteryVoltage;
-    // static float _priorActivationDuration;
-    // static float _priorPoweredDuration;
+    /**
+     * @brief The metadata fields collected by updateModemMetadata()
+     *
+     * Set by enableMetadataFields() and the modem Variables.
+     */
+    static uint8_t _metadataFields;
+    /**
+     * @brief The time the modem was awake in its last cycle, in seconds
+     *
+     * Returned by #getModemActivationDuration().
+     */
+    static float _priorActivationDuration;
+    /**
+     * @brief The time the modem was powered in its last cycle, in seconds
+     *
+     * Returned by #getModemPoweredDuration().
+     */
+    static float _priorPoweredDuration;
+    /**
+     * @brief The total time the modem has been powered, in seconds
+     *
+     * Returned by #getModemTotalPoweredTime().
+     */
+    static float _totalPoweredTime;
+    /**
+     * @brief The charge the modem used in its last cycle, in mAh
+     *
+     * Returned by #getModemEnergyUsed().
+     */
+    static float _priorEnergyUsed;
+    /**
+     * @brief The total charge the modem has used, in mAh
+     *
+     * Returned by #getModemTotalEnergy().
+     */
+    static float _totalEnergyUsed;
     /**@}*/
 
     /**
@@ -1017,7 +1965,9 @@ class Modem_RSSI : public Variable {
                         const char* varCode = MODEM_RSSI_DEFAULT_CODE)
         : Variable(&parentModem->getModemRSSI, (uint8_t)MODEM_RSSI_RESOLUTION,
                    &*MODEM_RSSI_VAR_NAME, &*MODEM_RSSI_UNIT_NAME, varCode,
-                   uuid) {}
+                   uuid) {
+        loggerModem::enableMetadataFields(MODEM_RSSI_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_RSSI object - no action needed.
      */
@@ -1050,7 +2000,9 @@ class Modem_SignalPercent : public Variable {
         : Variable(&parentModem->getModemSignalPercent,
                    (uint8_t)MODEM_PERCENT_SIGNAL_RESOLUTION,
                    &*MODEM_PERCENT_SIGNAL_VAR_NAME,
-                   &*MODEM_PERCENT_SIGNAL_UNIT_NAME, varCode, uuid) {}
+                   &*MODEM_PERCENT_SIGNAL_UNIT_NAME, varCode, uuid) {
+        loggerModem::enableMetadataFields(MODEM_PERCENT_SIGNAL_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_SignalPercent object - no action needed.
      */
@@ -1086,7 +2038,9 @@ class Modem_BatteryState : public Variable {
         : Variable(&parentModem->getModemBatteryChargeState,
                    (uint8_t)MODEM_BATTERY_STATE_RESOLUTION,
                    &*MODEM_BATTERY_STATE_VAR_NAME,
-                   &*MODEM_BATTERY_STATE_UNIT_NAME, varCode, uuid) {}
+                   &*MODEM_BATTERY_STATE_UNIT_NAME, varCode, uuid) {
+        loggerModem::enableMetadataFields(MODEM_BATTERY_STATE_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_BatteryState object - no action needed.
      */
@@ -1122,7 +2076,9 @@ class Modem_BatteryPercent : public Variable {
         : Variable(&parentModem->getModemBatteryChargePercent,
                    (uint8_t)MODEM_BATTERY_PERCENT_RESOLUTION,
                    &*MODEM_BATTERY_PERCENT_VAR_NAME,
-                   &*MODEM_BATTERY_PERCENT_UNIT_NAME, varCode, uuid) {}
+                   &*MODEM_BATTERY_PERCENT_UNIT_NAME, varCode, uuid) {
+        loggerModem::enableMetadataFields(MODEM_BATTERY_PERCENT_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_BatteryPercent object - no action needed.
      */
@@ -1158,7 +2114,9 @@ class Modem_BatteryVoltage : public Variable {
         : Variable(&parentModem->getModemBatteryVoltage,
                    (uint8_t)MODEM_BATTERY_VOLTAGE_RESOLUTION,
                    &*MODEM_BATTERY_VOLTAGE_VAR_NAME,
-                   &*MODEM_BATTERY_VOLTAGE_UNIT_NAME, varCode, uuid) {}
+                   &*MODEM_BATTERY_VOLTAGE_UNIT_NAME, varCode, uuid) {
+        loggerModem::enableMetadataFields(MODEM_BATTERY_VOLTAGE_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_BatteryVoltage object - no action needed.
      */
@@ -1193,12 +2151,174 @@ class Modem_Temp : public Variable {
         : Variable(&parentModem->getModemTemperature,
                    (uint8_t)MODEM_TEMPERATURE_RESOLUTION,
                    &*MODEM_TEMPERATURE_VAR_NAME, &*MODEM_TEMPERATURE_UNIT_NAME,
-                   varCode, uuid) {}
+                   varCode, uuid) {
+        loggerModem::enableMetadataFields(MODEM_TEMPERATURE_ENABLE_BITMASK);
+    }
     /**
      * @brief Destroy the Modem_Temp object - no action needed.
      */
     ~Modem_Temp() {}
 };
 
+/**
+ * @brief The Variable sub-class used for the time a modem was awake in its last
+ * cycle.
+ *
+ * The value is in seconds.
+ *
+ * @ingroup modem_measured_variables
+ */
+class Modem_ActivationDuration : public Variable {
+ public:
+    /**
+     * @brief Construct a new Modem_ActivationDuration object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemActiveSec".
+     */
+    explicit Modem_ActivationDuration(
+        loggerModem* parentModem, const char* uuid = "",
+        const char* varCode = MODEM_ACTIVATION_DEFAULT_CODE)
+        : Variable(&parentModem->getModemActivationDuration,
+                   (uint8_t)MODEM_ACTIVATION_RESOLUTION,
+                   &*MODEM_ACTIVATION_VAR_NAME,
+                   &*MODEM_ACTIVATION_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_ActivationDuration object - no action needed.
+     */
+    ~Modem_ActivationDuration() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the time a modem was powered in its
+ * last cycle.
+ *
+ * The value is in seconds.
+ *
+ * @ingroup modem_measured_variables
+ */
+class Modem_PoweredDuration : public Variable {
+ public:
+    /**
+     * @brief Construct a new Modem_PoweredDuration object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemPoweredSec".
+     */
+    explicit Modem_PoweredDuration(
+        loggerModem* parentModem, const char* uuid = "",
+        const char* varCode = MODEM_POWERED_DEFAULT_CODE)
+        : Variable(&parentModem->getModemPoweredDuration,
+                   (uint8_t)MODEM_POWERED_RESOLUTION,
+                   &*MODEM_POWERED_VAR_NAME,
+                   &*MODEM_POWERED_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_PoweredDuration object - no action needed.
+     */
+    ~Modem_PoweredDuration() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the total time a modem has been
+ * powered since the logger started.
+ *
+ * The value is in seconds.
+ *
+ * @ingroup modem_measured_variables
+ */
+class Modem_TotalPoweredTime : public Variable {
+ public:
+    /**
+     * @brief Construct a new Modem_TotalPoweredTime object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemTotalPoweredSec".
+     */
+    explicit Modem_TotalPoweredTime(
+        loggerModem* parentModem, const char* uuid = "",
+        const char* varCode = MODEM_TOTAL_POWERED_DEFAULT_CODE)
+        : Variable(&parentModem->getModemTotalPoweredTime,
+                   (uint8_t)MODEM_TOTAL_POWERED_RESOLUTION,
+                   &*MODEM_TOTAL_POWERED_VAR_NAME,
+                   &*MODEM_TOTAL_POWERED_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_TotalPoweredTime object - no action needed.
+     */
+    ~Modem_TotalPoweredTime() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the charge a modem used in its last
+ * cycle, estimated from its current model.
+ *
+ * The value is in milliamp hours.
+ *
+ * @ingroup modem_measured_variables
+ */
+class Modem_EnergyUsed : public Variable {
+ public:
+    /**
+     * @brief Construct a new Modem_EnergyUsed object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemCharge".
+     */
+    explicit Modem_EnergyUsed(
+        loggerModem* parentModem, const char* uuid = "",
+        const char* varCode = MODEM_ENERGY_DEFAULT_CODE)
+        : Variable(&parentModem->getModemEnergyUsed,
+                   (uint8_t)MODEM_ENERGY_RESOLUTION,
+                   &*MODEM_ENERGY_VAR_NAME,
+                   &*MODEM_ENERGY_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_EnergyUsed object - no action needed.
+     */
+    ~Modem_EnergyUsed() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the total charge a modem has used
+ * since the logger started, estimated from its current model.
+ *
+ * The value is in milliamp hours.
+ *
+ * @ingroup modem_measured_variables
+ */
+class Modem_TotalEnergy : public Variable {
+ public:
+    /**
+     * @brief Construct a new Modem_TotalEnergy object.
+     *
+     * @param parentModem The parent modem providing the result values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "modemTotalCharge".
+     */
+    explicit Modem_TotalEnergy(
+        loggerModem* parentModem, const char* uuid = "",
+        const char* varCode = MODEM_TOTAL_ENERGY_DEFAULT_CODE)
+        : Variable(&parentModem->getModemTotalEnergy,
+                   (uint8_t)MODEM_TOTAL_ENERGY_RESOLUTION,
+                   &*MODEM_TOTAL_ENERGY_VAR_NAME,
+                   &*MODEM_TOTAL_ENERGY_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Destroy the Modem_TotalEnergy object - no action needed.
+     */
+    ~Modem_TotalEnergy() {}
+};
+
 // #include <LoggerModem.tpp>
 #endif  // SRC_LOGGERMODEM_H_
@@ -0,0 +1,107 @@
+/**
+ * @file MemoryReport.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the MemoryReport class.
+ */
+
+#include "MemoryReport.h"
+
+// Initialize the static total
+uint32_t MemoryReport::_objectBytes = 0;
+
+
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
+extern "C" char* sbrk(int i);
+
+// A free chunk of the newlib-nano heap; the size includes its header
+struct nanoFreeChunk {
+    long           size;
+    nanoFreeChunk* next;
+};
+// This is weak so a core built with the full newlib still links
+extern "C" nanoFreeChunk* __malloc_free_list __attribute__((weak));
+
+char* MemoryReport::getHeapTop(void) {
+    return static_cast<char*>(sbrk(0));
+}
+
+static uint32_t largestFreeListBlock(void) {
+    uint32_t largest = 0;
+    if (&__malloc_free_list == nullptr) return 0;
+    for (nanoFreeChunk* chunk = __malloc_free_list; chunk != nullptr;
+         chunk                = chunk->next) {
+        uint32_t usable = chunk->size - sizeof(long);
+        if (usable > largest) largest = usable;
+    }
+    return largest;
+}
+
+#elif defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+// A free block of the avr-libc heap; the size doesn't include its header
+struct __freelist {
+    size_t             sz;
+    struct __freelist* nx;
+};
+extern "C" struct __freelist* __flp;
+extern "C" char*              __brkval;
+extern "C" char               __heap_start;
+
+char* MemoryReport::getHeapTop(void) {
+    return __brkval == 0 ? &__heap_start : __brkval;
+}
+
+static uint32_t largestFreeListBlock(void) {
+    uint32_t largest = 0;
+    for (struct __freelist* block = __flp; block != nullptr;
+         block                    = block->nx) {
+        if (block->sz > largest) largest = block->sz;
+    }
+    return largest;
+}
+
+#else
+char* MemoryReport::getHeapTop(void) {
+    return nullptr;
+}
+#endif
+
+
+int32_t MemoryReport::getFreeRam(void) {
+    char* top = getHeapTop();
+    if (top == nullptr) return -9999;
+    char stack_dummy = 0;
+    return &stack_dummy - top;
+}
+
+
+int32_t MemoryReport::getLargestFreeBlock(void) {
+    int32_t freeRam = getFreeRam();
+    if (freeRam == -9999) return -9999;
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO) || \
+    defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+    int32_t listBlock = largestFreeListBlock();
+    if (listBlock > freeRam) return listBlock;
+#endif
+    return freeRam;
+}
+
+
+void MemoryReport::start(Print& out) {
+    _objectBytes = 0;
+    out.println(F("RAM used by the logger's objects:"));
+}
+
+
+void MemoryReport::finish(Print& out) {
+    out.print(F("Total of the objects: "));
+    out.print(_objectBytes);
+    out.println(F(" bytes"));
+    out.print(F("Free RAM: "));
+    out.print(getFreeRam());
+    out.print(F(" bytes, largest free block: "));
+    out.print(getLargestFreeBlock());
+    out.println(F(" bytes\n"));
+}
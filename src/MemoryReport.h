@@ -0,0 +1,99 @@
+/**
+ * @file MemoryReport.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the MemoryReport class, which measures the free RAM and
+ * adds up the RAM taken by the library's objects.
+ */
+
+// Header Guards
+#ifndef SRC_MEMORYREPORT_H_
+#define SRC_MEMORYREPORT_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief Functions to measure the free RAM, and to print and add up the RAM
+ * taken by each of the objects of a logger.
+ *
+ * Logger::begin() prints a report of the RAM of its variable array, its
+ * publishers, the SD card and the modem, with the free RAM and the largest
+ * free block left after set up.  The total of the objects is kept and can be
+ * logged by wrapping getObjectBytes() in a calculated variable; the free RAM
+ * and largest block are the same as ProcessorStats reports.
+ *
+ * The sizes are of the objects as the library knows them: a Sensor is counted
+ * as its base object and its result arrays, so any members of a particular
+ * sensor's subclass are not included.
+ */
+class MemoryReport {
+ public:
+    /**
+     * @brief Get the RAM between the top of the heap and the stack.
+     *
+     * @return **int32_t** The free RAM in bytes; -9999 if it can't be
+     * measured on this processor
+     */
+    static int32_t getFreeRam(void);
+    /**
+     * @brief Get the largest block that could be allocated; the larger of
+     * the biggest block on the heap's free list and the free RAM.
+     *
+     * @return **int32_t** The largest block in bytes; -9999 if it can't be
+     * measured on this processor
+     */
+    static int32_t getLargestFreeBlock(void);
+    /**
+     * @brief Get the top of the heap.
+     *
+     * @return **char\*** The top of the heap; nullptr if it can't be found on
+     * this processor
+     */
+    static char* getHeapTop(void);
+
+    /**
+     * @brief Print one object of the report and add it to the total.
+     *
+     * @tparam T Any printable type for the name
+     * @param out The stream to print to
+     * @param name The name of the object
+     * @param bytes The RAM taken by the object
+     */
+    template <typename T>
+    static void add(Print& out, T name, uint32_t bytes) {
+        out.print(F("  "));
+        out.print(name);
+        out.print(F(": "));
+        out.print(bytes);
+        out.println(F(" bytes"));
+        _objectBytes += bytes;
+    }
+    /**
+     * @brief Start a new report, clearing the total.
+     *
+     * @param out The stream to print to
+     */
+    static void start(Print& out);
+    /**
+     * @brief Print the total of the objects, the free RAM and the largest
+     * free block.
+     *
+     * @param out The stream to print to
+     */
+    static void finish(Print& out);
+    /**
+     * @brief Get the total RAM of the objects in the last report.
+     *
+     * @return **uint32_t** The total in bytes
+     */
+    static uint32_t getObjectBytes(void) {
+        return _objectBytes;
+    }
+
+ private:
+    static uint32_t _objectBytes;
+};
+
+#endif  // SRC_MEMORYREPORT_H_
@@ -30,6 +30,19 @@
 #endif  // ifndef STANDARD_SERIAL_OUTPUT
 
 #ifdef STANDARD_SERIAL_OUTPUT
+#if defined(MS_CONSOLE_BUFFER_SIZE)
+#include "ConsoleSink.h"
+/**
+ * @brief The stream the logger's own printouts and echoes go to.
+ *
+ * With `MS_CONSOLE_BUFFER_SIZE` defined, this is a ConsoleSink in front of
+ * `STANDARD_SERIAL_OUTPUT`, so printing never waits for the port.
+ */
+#define MS_CONSOLE_OUTPUT msConsole
+#else
+#define MS_CONSOLE_OUTPUT STANDARD_SERIAL_OUTPUT
+#endif
+
 // namespace {
 /**
  * @brief Prints text to the "debugging" serial port.  This is intended for text
@@ -40,7 +53,7 @@
  */
 template <typename T>
 static void PRINTOUT(T last) {
-    STANDARD_SERIAL_OUTPUT.println(last);
+    MS_CONSOLE_OUTPUT.println(last);
 }
 
 /**
@@ -54,8 +67,8 @@ static void PRINTOUT(T last) {
  */
 template <typename T, typename... Args>
 static void PRINTOUT(T head, Args... tail) {
-    STANDARD_SERIAL_OUTPUT.print(head);
-    STANDARD_SERIAL_OUTPUT.print(' ');
+    MS_CONSOLE_OUTPUT.print(head);
+    MS_CONSOLE_OUTPUT.print(' ');
     PRINTOUT(tail...);
 }
 // }  // namespace
@@ -64,7 +77,9 @@ static void PRINTOUT(T head, Args... tail) {
 
 #ifndef DEBUGGING_SERIAL_OUTPUT
 // #if defined(ARDUINO_SAMD_ZERO) && defined(SERIAL_PORT_USBVIRTUAL)
-#if defined(SERIAL_PORT_USBVIRTUAL)
+#if defined(MS_CONSOLE_BUFFER_SIZE) && defined(STANDARD_SERIAL_OUTPUT)
+#define DEBUGGING_SERIAL_OUTPUT msConsole
+#elif defined(SERIAL_PORT_USBVIRTUAL)
 // #define Serial SERIAL_PORT_USBVIRTUAL
 #define DEBUGGING_SERIAL_OUTPUT SERIAL_PORT_USBVIRTUAL
 #elif defined __AVR__ || defined ARDUINO_ARCH_AVR
@@ -162,7 +177,9 @@ static void MS_DBG(T head, Args... tail) {
 
 #ifndef DEEP_DEBUGGING_SERIAL_OUTPUT
 // #if defined(ARDUINO_SAMD_ZERO) && defined(SERIAL_PORT_USBVIRTUAL)
-#if defined(SERIAL_PORT_USBVIRTUAL)
+#if defined(MS_CONSOLE_BUFFER_SIZE) && defined(STANDARD_SERIAL_OUTPUT)
+#define DEEP_DEBUGGING_SERIAL_OUTPUT msConsole
+#elif defined(SERIAL_PORT_USBVIRTUAL)
 // #define Serial SERIAL_PORT_USBVIRTUAL
 #define DEEP_DEBUGGING_SERIAL_OUTPUT SERIAL_PORT_USBVIRTUAL
 #elif defined __AVR__ || defined ARDUINO_ARCH_AVR
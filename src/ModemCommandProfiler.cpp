@@ -0,0 +1,178 @@
+/**
+ * @file ModemCommandProfiler.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the ModemCommandProfiler class.
+ */
+
+#include "ModemCommandProfiler.h"
+
+
+// The constructor
+ModemCommandProfiler::ModemCommandProfiler() {}
+
+
+Stream& ModemCommandProfiler::attach(Stream& modemStream) {
+    _modemStream = &modemStream;
+    return *this;
+}
+
+
+// Only the start of each line written is looked at, up to any parameters
+size_t ModemCommandProfiler::write(uint8_t b) {
+    if (_modemStream == nullptr) return 0;
+    if (b == '\r' || b == '\n') {
+        if (_commandLen >= 2 && (_command[0] == 'A' || _command[0] == 'a') &&
+            (_command[1] == 'T' || _command[1] == 't')) {
+            if (_waiting) finishCommand(resultNone);
+            if (_cycleEnded) {
+                _cycleEnded   = false;
+                _commandCount = 0;
+                _noResults    = 0;
+                _errors       = 0;
+                _totalLatency = 0;
+                _recordCount  = 0;
+                _nextRecord   = 0;
+            }
+            _command[_commandLen] = '\0';
+            _waiting              = true;
+            _lineLen              = 0;
+            _sentAt               = millis();
+        }
+        _commandLen = 0;
+        _inParams   = false;
+    } else if (!_inParams) {
+        if (b == '=' || _commandLen >= MS_MODEM_PROFILE_COMMAND_LENGTH) {
+            _inParams = true;
+        } else {
+            _command[_commandLen++] = b;
+        }
+    }
+    return _modemStream->write(b);
+}
+size_t ModemCommandProfiler::write(const uint8_t* buf, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buf[n])) n++;
+    return n;
+}
+
+
+int ModemCommandProfiler::available() {
+    if (_modemStream == nullptr) return 0;
+    return _modemStream->available();
+}
+int ModemCommandProfiler::read() {
+    if (_modemStream == nullptr) return -1;
+    int c = _modemStream->read();
+    if (c >= 0 && _waiting) readChar(c);
+    return c;
+}
+int ModemCommandProfiler::peek() {
+    if (_modemStream == nullptr) return -1;
+    return _modemStream->peek();
+}
+void ModemCommandProfiler::flush() {
+    if (_modemStream != nullptr) _modemStream->flush();
+}
+
+
+// Only the start of each response line is kept; enough for the result codes
+void ModemCommandProfiler::readChar(int c) {
+    if (c != '\r' && c != '\n') {
+        if (_lineLen < sizeof(_line) - 1) _line[_lineLen++] = c;
+        return;
+    }
+    _line[_lineLen] = '\0';
+    _lineLen        = 0;
+    if (strcmp(_line, "OK") == 0) {
+        finishCommand(resultOK);
+    } else if (strcmp(_line, "ERROR") == 0 ||
+               strncmp(_line, "+CME ERROR", 10) == 0 ||
+               strncmp(_line, "+CMS ERROR", 10) == 0) {
+        finishCommand(resultError);
+    }
+}
+
+
+// The slowest are kept by replacing the fastest kept, the most recent by
+// going round the buffer
+void ModemCommandProfiler::finishCommand(atResult result) {
+    uint32_t latency = millis() - _sentAt;
+    _waiting         = false;
+    _commandCount++;
+    _totalLatency += latency;
+    if (result == resultNone) _noResults++;
+    if (result == resultError) _errors++;
+
+    uint8_t slot = _recordCount;
+    if (_recordCount < MS_MODEM_PROFILE_SIZE) {
+        _recordCount++;
+    } else if (MS_MODEM_PROFILE_SLOWEST) {
+        slot = 0;
+        for (uint8_t i = 1; i < _recordCount; i++) {
+            if (_records[i].latency < _records[slot].latency) slot = i;
+        }
+        if (_records[slot].latency >= latency) return;
+    } else {
+        slot        = _nextRecord;
+        _nextRecord = (_nextRecord + 1) % MS_MODEM_PROFILE_SIZE;
+    }
+    memcpy(_records[slot].command, _command, sizeof(_command));
+    _records[slot].sentAt  = _sentAt;
+    _records[slot].latency = latency;
+    _records[slot].result  = result;
+}
+
+
+void ModemCommandProfiler::endCycle(void) {
+    if (_waiting) finishCommand(resultNone);
+    _cycleEnded = true;
+}
+
+
+void ModemCommandProfiler::printSummary(Print& out) {
+    out.print(F("AT commands: "));
+    out.print(_commandCount);
+    out.print(F(", total response time "));
+    out.print(_totalLatency);
+    out.print(F(" ms, "));
+    out.print(_errors);
+    out.print(F(" errors, "));
+    out.print(_noResults);
+    out.println(F(" without a result"));
+
+    // Print in order without changing the buffer, which may still be added to
+    uint8_t order[MS_MODEM_PROFILE_SIZE];
+    for (uint8_t i = 0; i < _recordCount; i++) {
+        order[i] = MS_MODEM_PROFILE_SLOWEST ? i
+                                            : (_nextRecord + i) % _recordCount;
+    }
+    if (MS_MODEM_PROFILE_SLOWEST) {
+        for (uint8_t i = 1; i < _recordCount; i++) {
+            uint8_t  index   = order[i];
+            uint32_t latency = _records[index].latency;
+            uint8_t  j       = i;
+            for (; j > 0 && _records[order[j - 1]].latency < latency; j--) {
+                order[j] = order[j - 1];
+            }
+            order[j] = index;
+        }
+    }
+    for (uint8_t i = 0; i < _recordCount; i++) {
+        const atRecord& record = _records[order[i]];
+        out.print(F("  "));
+        out.print(record.command);
+        out.print(F(" at "));
+        out.print(record.sentAt);
+        out.print(F(" ms took "));
+        out.print(record.latency);
+        out.print(F(" ms: "));
+        switch (record.result) {
+            case resultOK: out.println(F("OK")); break;
+            case resultError: out.println(F("ERROR")); break;
+            default: out.println(F("no result")); break;
+        }
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * @file ModemCommandProfiler.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the ModemCommandProfiler class, which times the AT commands
+ * sent to a modem and the responses to them.
+ */
+
+// Header Guards
+#ifndef SRC_MODEMCOMMANDPROFILER_H_
+#define SRC_MODEMCOMMANDPROFILER_H_
+
+#include <Arduino.h>
+
+#ifndef MS_MODEM_PROFILE_SIZE
+/**
+ * @brief The number of AT commands the profiler keeps the times of.
+ */
+#define MS_MODEM_PROFILE_SIZE 8
+#endif
+
+#ifndef MS_MODEM_PROFILE_SLOWEST
+/**
+ * @brief Set to 1 for the profiler to keep the slowest commands of each
+ * cycle, or to 0 to keep the most recent ones.
+ */
+#define MS_MODEM_PROFILE_SLOWEST 1
+#endif
+
+/**
+ * @brief The most characters of each command kept.
+ *
+ * Only the command itself is kept, not its parameters, so no APN, password or
+ * data is ever printed.
+ */
+#define MS_MODEM_PROFILE_COMMAND_LENGTH 12
+
+/**
+ * @brief A stream that passes everything between TinyGSM and a modem, and
+ * times how long the modem takes to give the final result of each AT command.
+ *
+ * A command is a line written to the modem that starts with `AT`.  It is
+ * timed from the end of the line until the modem gives a line with a final
+ * result code; `OK`, `ERROR`, `+CME ERROR` or `+CMS ERROR`.  A command that is
+ * followed by another before any final result is counted as having none,
+ * timed until the next command.
+ *
+ * The profiler keeps the times of the #MS_MODEM_PROFILE_SIZE slowest or most
+ * recent commands of a cycle, by #MS_MODEM_PROFILE_SLOWEST, along with the
+ * count and total time of all of them.  endCycle() closes the cycle, and the
+ * first command after that starts the next one, so the summary of the last
+ * cycle can be printed at any time in between.
+ *
+ * This is only used when `MS_MODEM_PROFILE_AT` is defined; see
+ * loggerModem::printATProfile().
+ */
+class ModemCommandProfiler : public Stream {
+ public:
+    /**
+     * @brief The final results of a command.
+     */
+    typedef enum atResult {
+        resultNone = 0,  ///< No final result before the next command
+        resultOK,        ///< `OK`
+        resultError      ///< `ERROR`, `+CME ERROR` or `+CMS ERROR`
+    } atResult;
+
+    /**
+     * @brief Construct a new modem command profiler object
+     *
+     * The profiler passes nothing through until it is attached to the
+     * modem's stream.
+     */
+    ModemCommandProfiler();
+
+    /**
+     * @brief Attach the profiler to the stream of the modem.
+     *
+     * This returns the profiler itself, so it can be given to the
+     * TinyGSM modem in its place in an initializer list.
+     *
+     * @param modemStream The stream of the modem
+     * @return **Stream&** This profiler
+     */
+    Stream& attach(Stream& modemStream);
+
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int    available() override;
+    int    read() override;
+    int    peek() override;
+    void   flush() override;
+
+    /**
+     * @brief Close the cycle; the next command starts a new one.
+     */
+    void endCycle(void);
+    /**
+     * @brief Print the summary of the current or last cycle.
+     *
+     * This prints the count and total time of the commands and the ones kept,
+     * slowest or earliest first, each with the millis() it was sent, its time
+     * and its result.
+     *
+     * @param out The stream to print to
+     */
+    void printSummary(Print& out);
+    /**
+     * @brief Get the number of commands sent in the current or last cycle.
+     *
+     * @return **uint16_t** The number of commands
+     */
+    uint16_t getCommandCount(void) {
+        return _commandCount;
+    }
+
+ private:
+    /**
+     * @brief The time of one command
+     */
+    typedef struct atRecord {
+        /// @brief The start of the command, without its parameters
+        char command[MS_MODEM_PROFILE_COMMAND_LENGTH + 1];
+        /// @brief The millis() the command was sent
+        uint32_t sentAt;
+        /// @brief The time to the final result, in milliseconds
+        uint32_t latency;
+        /// @brief The final result; an atResult
+        uint8_t result;
+    } atRecord;
+
+    /**
+     * @brief Add a response character and finish the command at its result.
+     *
+     * @param c The character read from the modem
+     */
+    void readChar(int c);
+    /**
+     * @brief Finish the command waiting for its result.
+     *
+     * @param result The final result
+     */
+    void finishCommand(atResult result);
+
+    Stream* _modemStream = nullptr;
+    // The command being written and the one waiting for its result
+    char     _command[MS_MODEM_PROFILE_COMMAND_LENGTH + 1];
+    uint8_t  _commandLen  = 0;
+    bool     _atLineStart = true;
+    bool     _inCommand   = false;
+    bool     _inParams    = false;
+    bool     _waiting     = false;
+    uint32_t _sentAt      = 0;
+    // The response line being read
+    char    _line[12];
+    uint8_t _lineLen = 0;
+    // The commands of the cycle
+    bool     _cycleEnded   = false;
+    uint16_t _commandCount = 0;
+    uint16_t _noResults    = 0;
+    uint16_t _errors       = 0;
+    uint32_t _totalLatency = 0;
+    atRecord _records[MS_MODEM_PROFILE_SIZE];
+    uint8_t  _recordCount = 0;
+    uint8_t  _nextRecord  = 0;
+};
+
+#endif  // SRC_MODEMCOMMANDPROFILER_H_
@@ -0,0 +1,170 @@
+/**
+ * @file NativeHttpClient.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the NativeHttpClient class.
+ */
+
+#include "NativeHttpClient.h"
+
+
+// The constructor
+NativeHttpClient::NativeHttpClient(loggerModem* modem, Client* fallbackClient,
+                                   bool useTls)
+    : _modem(modem),
+      _fallbackClient(fallbackClient),
+      _useTls(useTls) {}
+// Destructor
+NativeHttpClient::~NativeHttpClient() {}
+
+
+// Nothing is connected until the request is sent
+int NativeHttpClient::connect(IPAddress ip, uint16_t port) {
+    stop();
+    _host = nullptr;
+    _ip   = ip;
+    _port = port;
+    _open = true;
+    return 1;
+}
+int NativeHttpClient::connect(const char* host, uint16_t port) {
+    stop();
+    _host = host;
+    _port = port;
+    _open = true;
+    return 1;
+}
+
+
+size_t NativeHttpClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+size_t NativeHttpClient::write(const uint8_t* buf, size_t size) {
+    if (!_open || _sent) return 0;
+    if (_passThrough) return _fallbackClient->write(buf, size);
+    if (_overflow) return size;
+    if (_requestLen + size > MS_NATIVE_HTTP_BUFFER_SIZE) {
+        MS_DBG(F("The request is too big for the modem's HTTP client"));
+        if (startFallback()) return _fallbackClient->write(buf, size);
+        // Take the rest so the publisher finishes, but don't send it
+        _overflow = true;
+        return size;
+    }
+    memcpy(_request + _requestLen, buf, size);
+    _requestLen += size;
+    return size;
+}
+
+
+// The request is sent when the publisher starts waiting for the response
+int NativeHttpClient::available() {
+    if (_passThrough) return _fallbackClient->available();
+    if (_open && !_sent && _requestLen > 0) sendRequest();
+    return _responseLen - _responsePos;
+}
+int NativeHttpClient::read() {
+    if (_passThrough) return _fallbackClient->read();
+    if (!available()) return -1;
+    return _response[_responsePos++];
+}
+int NativeHttpClient::read(uint8_t* buf, size_t size) {
+    if (_passThrough) return _fallbackClient->read(buf, size);
+    size_t n = 0;
+    while (n < size && available()) buf[n++] = _response[_responsePos++];
+    return n;
+}
+int NativeHttpClient::peek() {
+    if (_passThrough) return _fallbackClient->peek();
+    if (!available()) return -1;
+    return _response[_responsePos];
+}
+
+
+void NativeHttpClient::flush() {
+    if (_passThrough) _fallbackClient->flush();
+}
+
+
+// A request that was never read for, as when not waiting for the response,
+// is still sent
+void NativeHttpClient::stop() {
+    if (_open && !_sent && _requestLen > 0) sendRequest();
+    if (_passThrough) _fallbackClient->stop();
+    _open        = false;
+    _sent        = false;
+    _overflow    = false;
+    _passThrough = false;
+    _requestLen  = 0;
+    _responseLen = 0;
+    _responsePos = 0;
+}
+
+
+// The connection is done once the whole response has been read
+uint8_t NativeHttpClient::connected() {
+    if (_passThrough) return _fallbackClient->connected();
+    return _open && (!_sent || _responsePos < _responseLen);
+}
+NativeHttpClient::operator bool() {
+    return connected();
+}
+
+
+void NativeHttpClient::sendRequest(void) {
+    _sent                 = true;
+    _request[_requestLen] = '\0';
+    int16_t responseCode  = 0;
+    if (_overflow) {
+        responseCode = 413;
+    } else {
+        // The head ends with a blank line; the body, if any, follows it
+        char* body = strstr(_request, "\r\n\r\n");
+        char* host = strstr(_request, "\r\nHost: ");
+        if (_modem != nullptr && body != nullptr && host != nullptr &&
+            host < body) {
+            body += 4;
+            host += 8;
+            char   hostName[65];
+            size_t hostLen = strcspn(host, "\r");
+            if (hostLen > sizeof(hostName) - 1) hostLen = sizeof(hostName) - 1;
+            memcpy(hostName, host, hostLen);
+            hostName[hostLen] = '\0';
+            uint16_t port     = _useTls && _port == 80 ? 443 : _port;
+
+            MS_DBG(F("Sending"), _requestLen, F("bytes to"), hostName,
+                   F("with the modem's HTTP client"));
+            MS_START_DEBUG_TIMER;
+            responseCode = _modem->nativeHttpRequest(
+                hostName, port, _useTls, _request, body - _request, body,
+                _requestLen - (body - _request));
+            MS_DBG(F("Modem's HTTP client took"), MS_PRINT_DEBUG_TIMER,
+                   F("ms"));
+        }
+        if (responseCode == 0) {
+            MS_DBG(F("The modem's HTTP client could not send the request"));
+            if (startFallback()) return;
+            responseCode = 504;
+        }
+    }
+    // Give the publisher a status line to read, with an empty body
+    _responseLen = snprintf(_response, sizeof(_response),
+                            "HTTP/1.1 %3d \r\nContent-Length: 0\r\n\r\n",
+                            responseCode);
+    _responsePos = 0;
+}
+
+
+// There is no fallback for a TLS request, so it's never sent in the clear
+bool NativeHttpClient::startFallback(void) {
+    if (_fallbackClient == nullptr || _useTls) return false;
+    MS_DBG(F("Sending the request over the socket instead"));
+    int success = _host != nullptr ? _fallbackClient->connect(_host, _port)
+                                   : _fallbackClient->connect(_ip, _port);
+    if (!success) return false;
+    _fallbackClient->write(reinterpret_cast<const uint8_t*>(_request),
+                           _requestLen);
+    _passThrough = true;
+    return true;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file NativeHttpClient.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the NativeHttpClient class, which sends the requests of the
+ * HTTP publishers with a modem's own HTTP(S) client.
+ */
+
+// Header Guards
+#ifndef SRC_NATIVEHTTPCLIENT_H_
+#define SRC_NATIVEHTTPCLIENT_H_
+
+// Debugging Statement
+// #define MS_NATIVEHTTPCLIENT_DEBUG
+
+#ifdef MS_NATIVEHTTPCLIENT_DEBUG
+#define MS_DEBUGGING_STD "NativeHttpClient"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "LoggerModem.h"
+#include "Client.h"
+
+#ifndef MS_NATIVE_HTTP_BUFFER_SIZE
+/**
+ * @brief The largest request, headers and body together, that can be sent
+ * with the modem's own HTTP client.
+ *
+ * Larger requests, like long batches, go over the fallback socket.
+ */
+#define MS_NATIVE_HTTP_BUFFER_SIZE 1024
+#endif
+
+/**
+ * @brief A client that hands each whole HTTP request to the modem's own
+ * HTTP(S) client instead of sending it over a socket.
+ *
+ * Over a socket, every byte of a request is sent to the modem in the AT
+ * commands of the socket, a piece at a time.  The SIM7080, SIM7000 and BG96
+ * have an HTTP application that takes the whole request at once, so there is
+ * less traffic on the serial line and the processor is awake for less time.
+ * The application can also use the modem's TLS, which is too big for most
+ * boards to do themselves.
+ *
+ * This client is given to an HTTP publisher in place of the modem's
+ * gsmClient.  It keeps the request the publisher writes, up to
+ * #MS_NATIVE_HTTP_BUFFER_SIZE bytes, and sends it with
+ * loggerModem::nativeHttpRequest() when the publisher starts reading the
+ * response.  The host is taken from the request's `Host` header.  The
+ * publisher then reads a short response with only the status line.
+ *
+ * If the modem has no HTTP application, can't start the request, or the
+ * request is too big to keep, the request goes over the fallback client
+ * without the publisher knowing.  There is no fallback for TLS requests, so
+ * they are never sent in the clear.
+ *
+ * @note The MQTT publishers keep a session open over their socket, so they
+ * can't use this client.
+ */
+class NativeHttpClient : public Client {
+ public:
+    /**
+     * @brief Construct a new native HTTP client object
+     *
+     * @param modem The modem whose HTTP client sends the requests
+     * @param fallbackClient The socket to send requests over when the modem
+     * can't; usually the modem's gsmClient.  Optional.
+     * @param useTls True to send the requests with the modem's TLS.  Requests
+     * to port 80 then go to port 443.
+     */
+    NativeHttpClient(loggerModem* modem, Client* fallbackClient = nullptr,
+                     bool useTls = false);
+    /**
+     * @brief Destroy the native HTTP client object
+     */
+    virtual ~NativeHttpClient();
+
+    int     connect(IPAddress ip, uint16_t port) override;
+    int     connect(const char* host, uint16_t port) override;
+    size_t  write(uint8_t b) override;
+    size_t  write(const uint8_t* buf, size_t size) override;
+    int     available() override;
+    int     read() override;
+    int     read(uint8_t* buf, size_t size) override;
+    int     peek() override;
+    void    flush() override;
+    void    stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+ private:
+    /**
+     * @brief Send the kept request, with the modem's HTTP client or over the
+     * fallback socket, and set up the response for the publisher to read.
+     */
+    void sendRequest(void);
+    /**
+     * @brief Connect the fallback socket and send it the request so far.
+     *
+     * @return **bool** True if the rest of the request and the response now
+     * go over the fallback socket
+     */
+    bool startFallback(void);
+
+    loggerModem* _modem;
+    Client*      _fallbackClient;
+    bool         _useTls;
+    // Where the publisher connected to, for the fallback
+    const char* _host = nullptr;
+    IPAddress   _ip;
+    uint16_t    _port = 80;
+    // The state of the current request
+    bool   _open        = false;
+    bool   _sent        = false;
+    bool   _overflow    = false;
+    bool   _passThrough = false;
+    size_t _requestLen  = 0;
+    char   _request[MS_NATIVE_HTTP_BUFFER_SIZE + 1];
+    // The status line given to the publisher
+    char    _response[48];
+    uint8_t _responseLen = 0;
+    uint8_t _responsePos = 0;
+};
+
+#endif  // SRC_NATIVEHTTPCLIENT_H_
@@ -0,0 +1,154 @@
+/**
+ * @file NodeLink.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the NodeLink class.
+ */
+
+#include "NodeLink.h"
+
+// The sync bytes at the start of each frame
+#define NODE_LINK_SYNC_0 'M'
+#define NODE_LINK_SYNC_1 'N'
+
+
+// Constructor
+NodeLink::NodeLink(Stream* stream) : _stream(stream) {}
+// Destructor
+NodeLink::~NodeLink() {}
+
+
+bool NodeLink::sendFrame(uint8_t type, uint8_t nodeID, const uint8_t* payload,
+                         uint8_t length) {
+    if (_stream == nullptr || length > MS_NODE_LINK_MAX_PAYLOAD) return false;
+    uint8_t head[3] = {type, nodeID, length};
+    // The CRC runs on from the head through the payload
+    uint16_t crc = crc16(payload, length, crc16(head, sizeof(head)));
+    _stream->write(NODE_LINK_SYNC_0);
+    _stream->write(NODE_LINK_SYNC_1);
+    _stream->write(head, sizeof(head));
+    if (length > 0) _stream->write(payload, length);
+    _stream->write(static_cast<uint8_t>(crc & 0xFF));
+    _stream->write(static_cast<uint8_t>(crc >> 8));
+    _stream->flush();
+    return true;
+}
+
+
+// The sync bytes aren't kept, so the frame starts with its type
+bool NodeLink::receiveFrame(void) {
+    if (_stream == nullptr) return false;
+    if (_rxPos > 0 && millis() - _lastByte > NODE_LINK_BYTE_TIMEOUT_MS) {
+        MS_DBG(F("Dropping a partial frame"));
+        _rxPos = 0;
+    }
+    while (_stream->available() > 0) {
+        uint8_t c = _stream->read();
+        _lastByte = millis();
+        if (_rxPos == 0) {
+            if (c == NODE_LINK_SYNC_0) _rxPos = 1;
+            continue;
+        }
+        if (_rxPos == 1) {
+            if (c == NODE_LINK_SYNC_1) {
+                _rxPos = 2;
+            } else if (c != NODE_LINK_SYNC_0) {
+                _rxPos = 0;
+            }
+            continue;
+        }
+        _frame[_rxPos - 2] = c;
+        _rxPos++;
+        // Start looking for the next frame if the length can't be right
+        if (_rxPos == 5 && _frame[2] > MS_NODE_LINK_MAX_PAYLOAD) {
+            _rxPos = 0;
+            continue;
+        }
+        if (_rxPos >= 5 && _rxPos == 2 + 3 + _frame[2] + 2) {
+            _rxPos           = 0;
+            uint16_t dataLen = 3 + _frame[2];
+            uint16_t crc     = _frame[dataLen] | (_frame[dataLen + 1] << 8);
+            if (crc == crc16(_frame, dataLen)) return true;
+            MS_DBG(F("Dropping a frame with a bad CRC"));
+        }
+    }
+    return false;
+}
+
+
+int16_t NodeLink::sendRecord(uint8_t nodeID, const uint8_t* payload,
+                             uint8_t length, uint32_t timeout_ms) {
+    // Clear out anything left over, like the answer to another node
+    while (receiveFrame()) {}
+    MS_DBG(F("Sending a"), length, F("byte record from node"), nodeID);
+    if (!sendFrame(NODE_LINK_RECORD, nodeID, payload, length)) return 0;
+    uint32_t start = millis();
+    while (millis() - start < timeout_ms) {
+        if (!receiveFrame()) continue;
+        if (getFrameNode() != nodeID) continue;
+        if (getFrameType() == NODE_LINK_ACK) {
+            uint32_t gatewayTime = 0;
+            uint16_t gatewayMs   = 0xFFFF;
+            if (getFrameLength() >= sizeof(gatewayTime) + sizeof(gatewayMs)) {
+                memcpy(&gatewayTime, getFramePayload(), sizeof(gatewayTime));
+                memcpy(&gatewayMs, getFramePayload() + sizeof(gatewayTime),
+                       sizeof(gatewayMs));
+            }
+            if (gatewayTime != 0) {
+                // Count from the start of the gateway's second
+                _ackPhased = gatewayMs < 1000;
+                _ackTime   = gatewayTime;
+                _ackMillis = millis() - MS_NODE_LINK_LATENCY_MS -
+                    (_ackPhased ? gatewayMs : 0);
+            }
+            MS_DBG(F("Record taken after"), millis() - start, F("ms"));
+            return 201;
+        }
+        if (getFrameType() == NODE_LINK_BUSY) {
+            MS_DBG(F("The gateway already has a record from node"), nodeID);
+            return 429;
+        }
+    }
+    MS_DBG(F("No answer from the gateway after"), timeout_ms, F("ms"));
+    return 504;
+}
+
+
+void NodeLink::answerRecord(uint8_t nodeID, bool accepted) {
+    if (!accepted) {
+        sendFrame(NODE_LINK_BUSY, nodeID, nullptr, 0);
+        return;
+    }
+    uint32_t now = 0;
+    uint16_t ms  = 0;
+    if (_timeFxn != nullptr && !_timeFxn(now, ms)) ms = 0xFFFF;
+    uint8_t payload[sizeof(now) + sizeof(ms)];
+    memcpy(payload, &now, sizeof(now));
+    memcpy(payload + sizeof(now), &ms, sizeof(ms));
+    sendFrame(NODE_LINK_ACK, nodeID, payload, sizeof(payload));
+}
+
+
+uint32_t NodeLink::getLinkTime(void) {
+    if (_ackTime == 0) return 0;
+    return _ackTime + (millis() - _ackMillis) / 1000;
+}
+bool NodeLink::getLinkTime(uint32_t& epoch, uint16_t& msIntoSecond) {
+    uint32_t elapsed = millis() - _ackMillis;
+    epoch            = _ackTime == 0 ? 0 : _ackTime + elapsed / 1000;
+    msIntoSecond     = _ackPhased ? elapsed % 1000 : 0;
+    return _ackTime != 0 && _ackPhased;
+}
+
+
+uint16_t NodeLink::crc16(const uint8_t* data, size_t len, uint16_t crc) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file NodeLink.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the NodeLink class, the framing of compact records sent
+ * from node loggers to a gateway logger over a local radio.
+ */
+
+// Header Guards
+#ifndef SRC_NODELINK_H_
+#define SRC_NODELINK_H_
+
+// Debugging Statement
+// #define MS_NODELINK_DEBUG
+
+#ifdef MS_NODELINK_DEBUG
+#define MS_DEBUGGING_STD "NodeLink"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+
+#ifndef MS_NODE_LINK_MAX_PAYLOAD
+/**
+ * @brief The largest payload of a frame on a node link, in bytes.
+ *
+ * A record is the UTC epoch time and four bytes per variable, so the default
+ * holds a node with up to 24 variables.  The whole frame is 7 bytes more than
+ * this, which must fit in a single packet of the radio: up to 256 bytes on an
+ * XBee 900HP and 255 on most LoRa modules.
+ */
+#define MS_NODE_LINK_MAX_PAYLOAD 100
+#endif
+
+#ifndef MS_NODE_LINK_LATENCY_MS
+/**
+ * @brief The time in milliseconds from the gateway reading its clock for an
+ * acknowledgement to the node receiving the whole acknowledgement.
+ *
+ * This is mostly the time to send the 13 bytes of the frame over the serial
+ * ports at each end; about 14 ms at 9600 baud.  It's added to the gateway's
+ * time on the node.
+ */
+#define MS_NODE_LINK_LATENCY_MS 20
+#endif
+
+/**
+ * @brief The longest gap between the bytes of one frame before the partial
+ * frame is dropped, in milliseconds.
+ */
+#define NODE_LINK_BYTE_TIMEOUT_MS 200
+
+/**
+ * @brief The frame types on a node link.
+ */
+typedef enum {
+    /// A record from a node: the UTC epoch time and one float per variable
+    NODE_LINK_RECORD = 1,
+    /// The gateway has taken the record; the payload is the gateway's UTC
+    /// epoch time, or 0 if it has none, and the milliseconds into that
+    /// second, or 0xFFFF if they aren't known
+    NODE_LINK_ACK = 2,
+    /// The gateway already has a record from the node for this interval
+    NODE_LINK_BUSY = 3
+} nodeLinkFrameType;
+
+/**
+ * @brief The framing of the compact binary records that node loggers send to
+ * a gateway logger over a local radio link.
+ *
+ * The radio - an XBee 900 or a LoRa module, for example - is run in its
+ * transparent serial mode and given to the link as a Stream.  Each frame is
+ * the sync bytes "MN", the frame type, the node ID, the payload length, the
+ * payload, and a CRC-16 of everything after the sync bytes.  A node sends its
+ * record with sendRecord() and the gateway answers each one with an
+ * acknowledgement that carries its clock, to the millisecond, as a time
+ * beacon.  The nodes set their clocks from it with
+ * Logger::setRTClockPhase(), so their readings are taken at the same time as
+ * the gateway's, and only the gateway needs the network time.
+ *
+ * Node loggers send with a NodeLinkPublisher, attached to the logger through
+ * a NodeLinkModem; the gateway receives them with a NodeRelay sensor for each
+ * node.
+ *
+ * @ingroup base_classes
+ */
+class NodeLink {
+ public:
+    /**
+     * @brief Construct a new node link object
+     *
+     * @param stream The stream of the radio
+     */
+    explicit NodeLink(Stream* stream);
+    /**
+     * @brief Destroy the node link object
+     */
+    ~NodeLink();
+
+    /**
+     * @brief Get the stream of the radio.
+     *
+     * @return **Stream*** The stream
+     */
+    Stream* getStream(void) {
+        return _stream;
+    }
+    /**
+     * @brief Set the function giving the gateway's clock for its
+     * acknowledgements.
+     *
+     * @param timeFxn A function giving the current UTC epoch time and the
+     * milliseconds into that second, and returning whether the milliseconds
+     * are known, like Logger::getCycleUTCTime(); nullptr to send no time.
+     */
+    void setTimeSource(bool (*timeFxn)(uint32_t& epoch,
+                                       uint16_t& msIntoSecond)) {
+        _timeFxn = timeFxn;
+    }
+
+    /**
+     * @brief Send a frame.
+     *
+     * @param type The frame type
+     * @param nodeID The ID of the node sending or being answered
+     * @param payload The payload
+     * @param length The length of the payload, up to
+     * #MS_NODE_LINK_MAX_PAYLOAD
+     * @return **bool** True if the frame was written to the radio
+     */
+    bool sendFrame(uint8_t type, uint8_t nodeID, const uint8_t* payload,
+                   uint8_t length);
+    /**
+     * @brief Read whatever the radio has received, up to the end of the next
+     * whole frame.
+     *
+     * @return **bool** True if a frame with a good CRC has been received; it
+     * can be read with the frame getters until this is called again.
+     */
+    bool receiveFrame(void);
+    /**
+     * @brief Get the type of the last frame received.
+     *
+     * @return **uint8_t** The #nodeLinkFrameType
+     */
+    uint8_t getFrameType(void) {
+        return _frame[0];
+    }
+    /**
+     * @brief Get the node ID of the last frame received.
+     *
+     * @return **uint8_t** The node ID
+     */
+    uint8_t getFrameNode(void) {
+        return _frame[1];
+    }
+    /**
+     * @brief Get the payload length of the last frame received.
+     *
+     * @return **uint8_t** The length
+     */
+    uint8_t getFrameLength(void) {
+        return _frame[2];
+    }
+    /**
+     * @brief Get the payload of the last frame received.
+     *
+     * @return **const uint8_t*** The payload
+     */
+    const uint8_t* getFramePayload(void) {
+        return _frame + 3;
+    }
+
+    /**
+     * @brief Send a record from a node and wait for the gateway's answer.
+     *
+     * @param nodeID The ID of this node
+     * @param payload The record
+     * @param length The length of the record
+     * @param timeout_ms How long to wait for the answer
+     * @return **int16_t** 201 if the gateway took the record, 429 if it
+     * already has one for this interval, or 504 if it did not answer
+     */
+    int16_t sendRecord(uint8_t nodeID, const uint8_t* payload, uint8_t length,
+                       uint32_t timeout_ms);
+    /**
+     * @brief Answer a record from a node.
+     *
+     * @param nodeID The ID of the node
+     * @param accepted True if the record was taken; false if there's already
+     * one from the node
+     */
+    void answerRecord(uint8_t nodeID, bool accepted);
+    /**
+     * @brief Get the gateway's clock, from the last acknowledgement that
+     * carried it.
+     *
+     * @return **uint32_t** The gateway's current UTC epoch time, or 0 if no
+     * acknowledgement has given it
+     */
+    uint32_t getLinkTime(void);
+    /**
+     * @brief Get the gateway's clock to the millisecond, from the last
+     * acknowledgement that carried it.
+     *
+     * @param epoch The gateway's current UTC epoch time
+     * @param msIntoSecond The milliseconds into that second
+     * @return **bool** True if the gateway knew its clock to the millisecond
+     */
+    bool getLinkTime(uint32_t& epoch, uint16_t& msIntoSecond);
+
+ private:
+    /**
+     * @brief Calculate the CRC-16 (CCITT) of the frame.
+     *
+     * @param data The bytes to check
+     * @param len The number of bytes
+     * @param crc The starting value; the result of a previous call to
+     * continue a checksum.  Default is 0xFFFF.
+     * @return **uint16_t** The checksum
+     */
+    static uint16_t crc16(const uint8_t* data, size_t len,
+                          uint16_t crc = 0xFFFF);
+
+    Stream* _stream;
+    bool (*_timeFxn)(uint32_t& epoch, uint16_t& msIntoSecond) = nullptr;
+    /**
+     * @brief The frame being received, from the type through the CRC
+     */
+    uint8_t  _frame[MS_NODE_LINK_MAX_PAYLOAD + 5];
+    uint16_t _rxPos     = 0;
+    uint32_t _lastByte  = 0;
+    uint32_t _ackTime   = 0;
+    uint32_t _ackMillis = 0;
+    bool     _ackPhased = false;
+};
+
+#endif  // SRC_NODELINK_H_
@@ -0,0 +1,424 @@
+/**
+ * @file PersistentStore.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the PersistentStore class and its backends.
+ */
+
+#include "PersistentStore.h"
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+// Each half starts with "MSK", its generation, and the CRC of those
+static const uint8_t storeHeaderSize = 6;
+// Each record is its key and length, the value, and the CRC of those
+static const uint8_t storeRecordOverhead = 3;
+// The bytes read or copied at a time
+static const uint8_t storeChunkSize = 16;
+
+
+// ============================================================================
+//  The backends
+// ============================================================================
+
+#if defined(__AVR__)
+bool EEPROMStoreBackend::read(uint32_t address, void* data, uint16_t len) {
+    if (address + len > _size) return false;
+    eeprom_read_block(data,
+                      reinterpret_cast<const void*>(
+                          static_cast<uintptr_t>(_start + address)),
+                      len);
+    return true;
+}
+// Update only writes the bytes that changed, to spare the EEPROM
+bool EEPROMStoreBackend::write(uint32_t address, const void* data,
+                               uint16_t len) {
+    if (address + len > _size) return false;
+    eeprom_update_block(
+        data, reinterpret_cast<void*>(static_cast<uintptr_t>(_start + address)),
+        len);
+    return true;
+}
+#endif
+
+
+// The transfers are kept well inside the 32 byte buffer of Wire
+bool FRAMStoreBackend::read(uint32_t address, void* data, uint16_t len) {
+    if (address + len > _size) return false;
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (len > 0) {
+        uint8_t n = len > storeChunkSize ? storeChunkSize : len;
+        _i2c->beginTransmission(_i2cAddress);
+        _i2c->write(static_cast<uint8_t>(address >> 8));
+        _i2c->write(static_cast<uint8_t>(address));
+        if (_i2c->endTransmission(false) != 0) return false;
+        if (_i2c->requestFrom(_i2cAddress, n) != n) return false;
+        for (uint8_t k = 0; k < n; k++) bytes[k] = _i2c->read();
+        address += n;
+        bytes += n;
+        len -= n;
+    }
+    return true;
+}
+bool FRAMStoreBackend::write(uint32_t address, const void* data,
+                             uint16_t len) {
+    if (address + len > _size) return false;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (len > 0) {
+        uint8_t n = len > storeChunkSize ? storeChunkSize : len;
+        _i2c->beginTransmission(_i2cAddress);
+        _i2c->write(static_cast<uint8_t>(address >> 8));
+        _i2c->write(static_cast<uint8_t>(address));
+        _i2c->write(bytes, n);
+        if (_i2c->endTransmission() != 0) return false;
+        address += n;
+        bytes += n;
+        len -= n;
+    }
+    return true;
+}
+
+
+// A file that doesn't exist yet reads as erased, like a new store
+bool SDFileStoreBackend::read(uint32_t address, void* data, uint16_t len) {
+    if (address + len > _size) return false;
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    memset(bytes, 0xFF, len);
+    File file;
+    if (!file.open(_fileName, O_READ)) return true;
+    uint32_t fileSize = file.fileSize();
+    bool     success  = true;
+    if (fileSize > address) {
+        uint16_t n = fileSize - address < len ? fileSize - address : len;
+        success    = file.seekSet(address) && file.read(bytes, n) == n;
+    }
+    file.close();
+    return success;
+}
+// Any gap before the address is filled as erased
+bool SDFileStoreBackend::write(uint32_t address, const void* data,
+                               uint16_t len) {
+    if (address + len > _size) return false;
+    File file;
+    if (!file.open(_fileName, O_RDWR | O_CREAT)) return false;
+    bool success = file.seekEnd();
+    while (success && file.fileSize() < address) {
+        success = file.write(static_cast<uint8_t>(0xFF)) == 1;
+    }
+    success = success && file.seekSet(address) &&
+        file.write(static_cast<const uint8_t*>(data), len) == len;
+    file.close();
+    return success;
+}
+
+
+// ============================================================================
+//  The store
+// ============================================================================
+
+// The constructor
+PersistentStore::PersistentStore(PersistentStoreBackend* backend)
+    : _backend(backend) {}
+
+
+// The newer of two good halves is in use; the generations can wrap around
+bool PersistentStore::begin(void) {
+    _halfSize = _backend->getSize() / 2;
+    if (_halfSize < storeHeaderSize + storeRecordOverhead + 1) return false;
+    uint16_t generation0 = 0;
+    uint16_t generation1 = 0;
+    bool     good0       = readHeader(0, generation0);
+    bool     good1       = readHeader(1, generation1);
+    if (!good0 && !good1) {
+        MS_DBG(F("No store found; formatting it"));
+        return format();
+    }
+    if (good0 && good1) {
+        _active = static_cast<int16_t>(generation1 - generation0) > 0 ? 1 : 0;
+    } else {
+        _active = good1 ? 1 : 0;
+    }
+    _generation = _active ? generation1 : generation0;
+    scan();
+    _mounted = true;
+    MS_DBG(F("Store has"), _keyCount, F("keys in half"), _active,
+           F("of generation"), _generation, F("with"), getFreeBytes(),
+           F("bytes free"));
+    return true;
+}
+
+
+bool PersistentStore::readHeader(uint8_t half, uint16_t& generation) {
+    uint8_t header[storeHeaderSize];
+    if (!_backend->read(half * _halfSize, header, storeHeaderSize)) {
+        return false;
+    }
+    if (header[0] != 'M' || header[1] != 'S' || header[2] != 'K' ||
+        crc8(0, header, storeHeaderSize - 1) != header[storeHeaderSize - 1]) {
+        return false;
+    }
+    generation = header[3] | (static_cast<uint16_t>(header[4]) << 8);
+    return true;
+}
+bool PersistentStore::writeHeader(uint8_t half, uint16_t generation) {
+    uint8_t header[storeHeaderSize] = {'M', 'S', 'K',
+                                       static_cast<uint8_t>(generation),
+                                       static_cast<uint8_t>(generation >> 8),
+                                       0};
+    header[storeHeaderSize - 1] = crc8(0, header, storeHeaderSize - 1);
+    return _backend->write(half * _halfSize, header, storeHeaderSize);
+}
+
+
+// Reading stops at the first record that is erased, runs off the half, or
+// fails its CRC; that's where the next one goes
+void PersistentStore::scan(void) {
+    _keyCount        = 0;
+    uint32_t end     = (_active + 1) * _halfSize;
+    uint32_t address = _active * _halfSize + storeHeaderSize;
+    while (address + storeRecordOverhead <= end) {
+        uint8_t head[2];
+        if (!_backend->read(address, head, 2) || head[0] == 0 ||
+            head[0] == 0xFF) {
+            break;
+        }
+        uint32_t next = address + storeRecordOverhead + head[1];
+        uint8_t  storedCRC;
+        if (next > end || !_backend->read(next - 1, &storedCRC, 1) ||
+            crcRecord(address, head[1], crcStart(_generation)) != storedCRC) {
+            break;
+        }
+        int8_t slot = findKey(head[0]);
+        if (head[1] == 0 && slot >= 0) {
+            // A removed key; the last key takes its slot
+            _keyCount--;
+            _keys[slot]    = _keys[_keyCount];
+            _records[slot] = _records[_keyCount];
+        } else if (head[1] > 0 && slot >= 0) {
+            _records[slot] = address;
+        } else if (head[1] > 0 && _keyCount < MS_STORE_MAX_KEYS) {
+            _keys[_keyCount]    = head[0];
+            _records[_keyCount] = address;
+            _keyCount++;
+        }
+        address = next;
+    }
+    _head = address;
+}
+
+
+uint8_t PersistentStore::crcRecord(uint32_t address, uint8_t len,
+                                   uint8_t crc) {
+    uint8_t  chunk[storeChunkSize];
+    uint16_t left = len + 2;
+    while (left > 0) {
+        uint8_t n = left > storeChunkSize ? storeChunkSize : left;
+        if (!_backend->read(address, chunk, n)) return ~crc;
+        crc = crc8(crc, chunk, n);
+        address += n;
+        left -= n;
+    }
+    return crc;
+}
+uint8_t PersistentStore::crcStart(uint16_t generation) {
+    uint8_t bytes[2] = {static_cast<uint8_t>(generation),
+                        static_cast<uint8_t>(generation >> 8)};
+    return crc8(0, bytes, 2);
+}
+// CRC-8 with the polynomial x^8 + x^2 + x + 1
+uint8_t PersistentStore::crc8(uint8_t crc, const uint8_t* data,
+                              uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+
+int8_t PersistentStore::findKey(uint8_t key) {
+    for (uint8_t k = 0; k < _keyCount; k++) {
+        if (_keys[k] == key) return k;
+    }
+    return -1;
+}
+
+
+// The end of the log is marked before the record is written, so a record cut
+// short is where the next scan stops
+bool PersistentStore::append(uint8_t key, const void* data, uint8_t len,
+                             uint32_t from) {
+    uint32_t end  = (_active + 1) * _halfSize;
+    uint32_t next = _head + storeRecordOverhead + len;
+    if (next > end) return false;
+    uint8_t erased = 0xFF;
+    if (next < end && !_backend->write(next, &erased, 1)) return false;
+
+    uint8_t head[2] = {key, len};
+    uint8_t crc     = crc8(crcStart(_generation), head, 2);
+    if (!_backend->write(_head, head, 2)) return false;
+    if (data != nullptr) {
+        if (len > 0 && !_backend->write(_head + 2, data, len)) return false;
+        crc = crc8(crc, static_cast<const uint8_t*>(data), len);
+    } else {
+        uint8_t chunk[storeChunkSize];
+        for (uint8_t done = 0; done < len;) {
+            uint8_t n = len - done > storeChunkSize ? storeChunkSize
+                                                    : len - done;
+            if (!_backend->read(from + 2 + done, chunk, n) ||
+                !_backend->write(_head + 2 + done, chunk, n)) {
+                return false;
+            }
+            crc = crc8(crc, chunk, n);
+            done += n;
+        }
+    }
+    if (!_backend->write(next - 1, &crc, 1)) return false;
+
+    int8_t slot = findKey(key);
+    if (len == 0 && slot >= 0) {
+        _keyCount--;
+        _keys[slot]    = _keys[_keyCount];
+        _records[slot] = _records[_keyCount];
+    } else if (len > 0 && slot >= 0) {
+        _records[slot] = _head;
+    } else if (len > 0) {
+        _keys[_keyCount]    = key;
+        _records[_keyCount] = _head;
+        _keyCount++;
+    }
+    _head = next;
+    return true;
+}
+
+
+// The other half only takes over once its header is written, last of all;
+// until then the half in use is still the newer one
+bool PersistentStore::compact(uint8_t skipKey) {
+    uint8_t  oldActive     = _active;
+    uint16_t oldGeneration = _generation;
+    uint8_t  count         = _keyCount;
+    uint8_t  keys[MS_STORE_MAX_KEYS];
+    uint32_t records[MS_STORE_MAX_KEYS];
+    memcpy(keys, _keys, sizeof(keys));
+    memcpy(records, _records, sizeof(records));
+
+    _active     = 1 - oldActive;
+    _generation = oldGeneration + 1;
+    _head       = _active * _halfSize + storeHeaderSize;
+    _keyCount   = 0;
+    bool    success = true;
+    uint8_t erased  = 0xFF;
+    for (uint8_t k = 0; success && k < count; k++) {
+        if (keys[k] == skipKey) continue;
+        uint8_t len;
+        success = _backend->read(records[k] + 1, &len, 1) &&
+            append(keys[k], nullptr, len, records[k]);
+    }
+    success = success && _backend->write(_head, &erased, 1) &&
+        writeHeader(_active, _generation);
+    if (!success) {
+        MS_DBG(F("Couldn't move the store to half"), _active);
+        _active     = oldActive;
+        _generation = oldGeneration;
+        scan();
+        return false;
+    }
+    MS_DBG(F("Moved the store to half"), _active, F("with"), getFreeBytes(),
+           F("bytes free"));
+    return true;
+}
+
+
+// The old value is only left behind if there's no room for both
+bool PersistentStore::write(uint8_t key, const void* data, uint8_t len) {
+    if (key == 0 || key == 0xFF) return false;
+    if (!_mounted && !begin()) return false;
+    int8_t  slot   = findKey(key);
+    uint8_t oldLen = 0;
+    if (slot >= 0 && !_backend->read(_records[slot] + 1, &oldLen, 1)) {
+        return false;
+    }
+    if (slot < 0 && len == 0) return true;
+    if (slot < 0 && _keyCount >= MS_STORE_MAX_KEYS) {
+        MS_DBG(F("No room in the store for key"), key);
+        return false;
+    }
+
+    // A value that hasn't changed isn't written again
+    if (slot >= 0 && oldLen == len) {
+        uint8_t chunk[storeChunkSize];
+        bool    same = true;
+        for (uint8_t done = 0; same && done < len;) {
+            uint8_t n = len - done > storeChunkSize ? storeChunkSize
+                                                    : len - done;
+            same = _backend->read(_records[slot] + 2 + done, chunk, n) &&
+                memcmp(chunk, static_cast<const uint8_t*>(data) + done, n) ==
+                    0;
+            done += n;
+        }
+        if (same) return true;
+    }
+
+    uint32_t needed = storeRecordOverhead + len;
+    if (_head + needed > (_active + 1) * _halfSize) {
+        uint32_t live = storeHeaderSize + needed;
+        for (uint8_t k = 0; k < _keyCount; k++) {
+            uint8_t keyLen = 0;
+            _backend->read(_records[k] + 1, &keyLen, 1);
+            live += storeRecordOverhead + keyLen;
+        }
+        // Keep the old value through the move only if there's room for it
+        uint8_t skipKey = live <= _halfSize ? 0 : key;
+        if (skipKey != 0) live -= storeRecordOverhead + oldLen;
+        if (live > _halfSize) {
+            MS_DBG(F("No room in the store for"), len, F("bytes"));
+            return false;
+        }
+        if (!compact(skipKey)) return false;
+    }
+    return append(key, data, len, 0);
+}
+
+
+uint8_t PersistentStore::read(uint8_t key, void* data, uint8_t maxLen) {
+    if (!_mounted && !begin()) return 0;
+    int8_t slot = findKey(key);
+    if (slot < 0) return 0;
+    uint8_t len;
+    if (!_backend->read(_records[slot] + 1, &len, 1)) return 0;
+    uint8_t n = len < maxLen ? len : maxLen;
+    if (!_backend->read(_records[slot] + 2, data, n)) return 0;
+    return len;
+}
+
+
+bool PersistentStore::remove(uint8_t key) {
+    return write(key, nullptr, 0);
+}
+
+
+// The other half's header is spoiled first, so it can't be taken for newer
+bool PersistentStore::format(void) {
+    _halfSize = _backend->getSize() / 2;
+    if (_halfSize < storeHeaderSize + storeRecordOverhead + 1) return false;
+    uint8_t erased = 0xFF;
+    _active        = 0;
+    _generation    = 0;
+    _keyCount      = 0;
+    _head          = storeHeaderSize;
+    _mounted       = _backend->write(_halfSize, &erased, 1) &&
+        _backend->write(_head, &erased, 1) && writeHeader(0, 0);
+    return _mounted;
+}
+
+
+uint16_t PersistentStore::getFreeBytes(void) {
+    uint32_t end = (_active + 1) * _halfSize;
+    return _head < end ? end - _head : 0;
+}
@@ -0,0 +1,418 @@
+/**
+ * @file PersistentStore.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the PersistentStore class, a small wear-leveled store of
+ * values kept across resets and power loss, and the PersistentStoreBackend
+ * class with its EEPROM, FRAM and SD card file backends.
+ */
+
+// Header Guards
+#ifndef SRC_PERSISTENTSTORE_H_
+#define SRC_PERSISTENTSTORE_H_
+
+// Debugging Statement
+// #define MS_PERSISTENTSTORE_DEBUG
+
+#ifdef MS_PERSISTENTSTORE_DEBUG
+#define MS_DEBUGGING_STD "PersistentStore"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Wire.h>
+#include <SdFat.h>
+
+#ifndef MS_STORE_MAX_KEYS
+/**
+ * @brief The most keys a PersistentStore holds values for.
+ */
+#define MS_STORE_MAX_KEYS 8
+#endif
+
+/**
+ * @brief The key of the logger checkpoint in a PersistentStore.
+ */
+#define MS_STORE_KEY_CHECKPOINT 1
+/**
+ * @brief The key of the modem's network hint in a PersistentStore.
+ */
+#define MS_STORE_KEY_NETWORK_HINT 2
+/**
+ * @brief The first key free for values of the sketch's own.
+ */
+#define MS_STORE_KEY_USER 16
+
+
+/**
+ * @brief The memory a PersistentStore keeps its values in.
+ *
+ * A backend only reads and writes bytes at addresses from 0 to one less than
+ * its size; the store does the rest.
+ *
+ * @ingroup base_classes
+ */
+class PersistentStoreBackend {
+ public:
+    /**
+     * @brief Destroy the backend - no action needed.
+     */
+    virtual ~PersistentStoreBackend() {}
+    /**
+     * @brief Get the bytes of memory the backend gives the store.
+     *
+     * @return **uint32_t** The size in bytes
+     */
+    virtual uint32_t getSize(void) = 0;
+    /**
+     * @brief Read bytes from the memory.
+     *
+     * @param address The address of the first byte
+     * @param data The buffer for the bytes
+     * @param len The number of bytes
+     * @return **bool** True if the bytes were read
+     */
+    virtual bool read(uint32_t address, void* data, uint16_t len) = 0;
+    /**
+     * @brief Write bytes to the memory.
+     *
+     * @param address The address of the first byte
+     * @param data The bytes
+     * @param len The number of bytes
+     * @return **bool** True if the bytes were written
+     */
+    virtual bool write(uint32_t address, const void* data, uint16_t len) = 0;
+    /**
+     * @brief Check whether the backend can be used from an interrupt, like
+     * the watchdog's early warning.
+     *
+     * @return **bool** True if the backend works with interrupts off
+     */
+    virtual bool isInterruptSafe(void) {
+        return false;
+    }
+    /**
+     * @brief Check whether the backend needs the SD card powered and started.
+     *
+     * @return **bool** True if the backend is on the SD card
+     */
+    virtual bool needsSDCard(void) {
+        return false;
+    }
+};
+
+
+#if defined(__AVR__) || defined(DOXYGEN)
+/**
+ * @brief A backend in part of the EEPROM of an AVR board.
+ *
+ * Only the bytes that change are written.  Keep the part clear of anything
+ * else in the EEPROM, like the SDI-12 sensor info cache at its end.
+ *
+ * @ingroup base_classes
+ */
+class EEPROMStoreBackend : public PersistentStoreBackend {
+ public:
+    /**
+     * @brief Construct a new EEPROM backend.
+     *
+     * @param start The first EEPROM address of the store
+     * @param size The bytes of EEPROM the store takes
+     */
+    EEPROMStoreBackend(uint16_t start, uint16_t size)
+        : _start(start),
+          _size(size) {}
+    uint32_t getSize(void) override {
+        return _size;
+    }
+    bool read(uint32_t address, void* data, uint16_t len) override;
+    bool write(uint32_t address, const void* data, uint16_t len) override;
+    bool isInterruptSafe(void) override {
+        return true;
+    }
+
+ private:
+    uint16_t _start;
+    uint16_t _size;
+};
+#endif
+
+
+/**
+ * @brief A backend in an I2C FRAM chip, like the Fujitsu MB85RC256V.
+ *
+ * FRAM takes byte writes without wearing out, so a store in it lasts as long
+ * as the chip.  The chip is addressed with two address bytes.
+ *
+ * @ingroup base_classes
+ */
+class FRAMStoreBackend : public PersistentStoreBackend {
+ public:
+    /**
+     * @brief Construct a new FRAM backend.
+     *
+     * @param size The bytes of the chip the store takes, from its start.
+     * Default is 32768, a whole 256 kbit chip.
+     * @param i2cAddress The I2C address of the chip.  Default is 0x50.
+     * @param theI2C The I2C bus of the chip.  Default is Wire.
+     */
+    explicit FRAMStoreBackend(uint32_t size = 32768, uint8_t i2cAddress = 0x50,
+                              TwoWire* theI2C = &Wire)
+        : _size(size),
+          _i2cAddress(i2cAddress),
+          _i2c(theI2C) {}
+    uint32_t getSize(void) override {
+        return _size;
+    }
+    bool read(uint32_t address, void* data, uint16_t len) override;
+    bool write(uint32_t address, const void* data, uint16_t len) override;
+
+ private:
+    uint32_t _size;
+    uint8_t  _i2cAddress;
+    TwoWire* _i2c;
+};
+
+
+/**
+ * @brief A backend in a file on the SD card kept for the store.
+ *
+ * The file is opened and closed for each read and write, so each write is on
+ * the card when it returns.  Bytes past the end of the file read as erased.
+ *
+ * @ingroup base_classes
+ */
+class SDFileStoreBackend : public PersistentStoreBackend {
+ public:
+    /**
+     * @brief Construct a new SD card file backend.
+     *
+     * @param fileName The name of the file; it must stay valid
+     * @param size The bytes of the file the store takes.  Default is 2048.
+     */
+    explicit SDFileStoreBackend(const char* fileName, uint32_t size = 2048)
+        : _fileName(fileName),
+          _size(size) {}
+    uint32_t getSize(void) override {
+        return _size;
+    }
+    bool read(uint32_t address, void* data, uint16_t len) override;
+    bool write(uint32_t address, const void* data, uint16_t len) override;
+    bool isInterruptSafe(void) override {
+        return true;
+    }
+    bool needsSDCard(void) override {
+        return true;
+    }
+
+ private:
+    const char* _fileName;
+    uint32_t    _size;
+};
+
+
+/**
+ * @brief A small wear-leveled store of values, each under a one byte key,
+ * kept across resets and power loss.
+ *
+ * Values like the logger checkpoint change with every cycle.  Writing them
+ * over the same bytes of EEPROM each time would wear those bytes out within a
+ * few years.  This store appends each new value to a log instead, so the
+ * writes spread over the whole memory.  The memory is split into two halves.
+ * When the half in use is full, the newest value of each key is copied to the
+ * other half, and the store moves over to it.
+ *
+ * Every update is atomic.  Each value is written with a CRC, and a value cut
+ * short by a reset fails its CRC and is ignored, so the one before it is
+ * read.  The moved-to half only takes over once everything is copied to it
+ * and its header is written last.  A value the same as the one stored isn't
+ * written again.
+ *
+ * The store reads its memory once, the first time it's used, and keeps where
+ * the newest value of each key is.  Each read after that is a single read of
+ * the backend.
+ *
+ * @ingroup base_classes
+ */
+class PersistentStore {
+ public:
+    /**
+     * @brief Construct a new persistent store.
+     *
+     * @param backend The memory to keep the values in
+     */
+    explicit PersistentStore(PersistentStoreBackend* backend);
+
+    /**
+     * @brief Read the memory to find the newest value of each key,
+     * formatting it if it holds no store.
+     *
+     * The other functions call this the first time they're used.
+     *
+     * @return **bool** True if the store is ready
+     */
+    bool begin(void);
+    /**
+     * @brief Write a new value for a key.
+     *
+     * @param key The key, from 1 to 254
+     * @param data The value
+     * @param len The bytes of the value, at most 255
+     * @return **bool** True if the value was stored; false if the memory or
+     * the keys are full
+     */
+    bool write(uint8_t key, const void* data, uint8_t len);
+    /**
+     * @brief Read the value of a key.
+     *
+     * @param key The key
+     * @param data The buffer for the value
+     * @param maxLen The size of the buffer; a longer value is cut short
+     * @return **uint8_t** The bytes of the value stored; 0 if there is none
+     */
+    uint8_t read(uint8_t key, void* data, uint8_t maxLen);
+    /**
+     * @brief Remove the value of a key.
+     *
+     * @param key The key
+     * @return **bool** True if the key has no value now
+     */
+    bool remove(uint8_t key);
+    /**
+     * @brief Remove every value and start the store over.
+     *
+     * @return **bool** True if the store was formatted
+     */
+    bool format(void);
+    /**
+     * @brief Get the bytes left in the half of the memory in use, before the
+     * values are moved to the other half.
+     *
+     * @return **uint16_t** The bytes free
+     */
+    uint16_t getFreeBytes(void);
+    /**
+     * @brief Get the backend of the store.
+     *
+     * @return **PersistentStoreBackend*** The backend
+     */
+    PersistentStoreBackend* getBackend(void) {
+        return _backend;
+    }
+
+ private:
+    /**
+     * @brief Read the header of a half.
+     *
+     * @param half The half, 0 or 1
+     * @param generation The generation of the half, if it has a header
+     * @return **bool** True if the half has a good header
+     */
+    bool readHeader(uint8_t half, uint16_t& generation);
+    /**
+     * @brief Write the header of a half.
+     *
+     * @param half The half, 0 or 1
+     * @param generation The generation of the half
+     * @return **bool** True if the header was written
+     */
+    bool writeHeader(uint8_t half, uint16_t generation);
+    /**
+     * @brief Find where the newest value of each key is in the half in use,
+     * and where the next value goes.
+     */
+    void scan(void);
+    /**
+     * @brief Compute the CRC of a value as it's stored in the half in use.
+     *
+     * @param address The address of the value's key
+     * @param len The bytes of the value
+     * @param crc The CRC to add to; start with crcStart()
+     * @return **uint8_t** The CRC
+     */
+    uint8_t crcRecord(uint32_t address, uint8_t len, uint8_t crc);
+    /**
+     * @brief Start the CRC of a record with the generation, so the records
+     * left from an earlier generation never pass.
+     *
+     * @param generation The generation of the half
+     * @return **uint8_t** The starting CRC
+     */
+    static uint8_t crcStart(uint16_t generation);
+    /**
+     * @brief Add bytes to a CRC-8.
+     *
+     * @param crc The CRC so far
+     * @param data The bytes
+     * @param len The number of bytes
+     * @return **uint8_t** The CRC with the bytes added
+     */
+    static uint8_t crc8(uint8_t crc, const uint8_t* data, uint16_t len);
+    /**
+     * @brief Find the slot of a key in the index.
+     *
+     * @param key The key
+     * @return **int8_t** The slot; -1 if the key has no value
+     */
+    int8_t findKey(uint8_t key);
+    /**
+     * @brief Append a record to the half in use.
+     *
+     * @param key The key
+     * @param data The value; nullptr to copy it from the other half
+     * @param len The bytes of the value
+     * @param from The address to copy the value from, if data is nullptr
+     * @return **bool** True if the record was written
+     */
+    bool append(uint8_t key, const void* data, uint8_t len, uint32_t from);
+    /**
+     * @brief Move the newest value of each key to the other half.
+     *
+     * @param skipKey A key whose value isn't moved, because a new one is
+     * about to be written
+     * @return **bool** True if the values were moved
+     */
+    bool compact(uint8_t skipKey);
+
+    /**
+     * @brief The memory of the store
+     */
+    PersistentStoreBackend* _backend;
+    /**
+     * @brief The bytes of each half
+     */
+    uint32_t _halfSize = 0;
+    /**
+     * @brief True once begin() has read the memory
+     */
+    bool _mounted = false;
+    /**
+     * @brief The half in use
+     */
+    uint8_t _active = 0;
+    /**
+     * @brief The generation of the half in use
+     */
+    uint16_t _generation = 0;
+    /**
+     * @brief Where the next record goes in the half in use
+     */
+    uint32_t _head = 0;
+    /**
+     * @brief The number of keys with values
+     */
+    uint8_t _keyCount = 0;
+    /**
+     * @brief The keys with values
+     */
+    uint8_t _keys[MS_STORE_MAX_KEYS];
+    /**
+     * @brief The address of the newest record of each key
+     */
+    uint32_t _records[MS_STORE_MAX_KEYS];
+};
+
+#endif  // SRC_PERSISTENTSTORE_H_
@@ -0,0 +1,44 @@
+/**
+ * @file PowerRail.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the PowerRail class.
+ */
+
+#include "PowerRail.h"
+
+
+// The constructor
+PowerRail::PowerRail(int8_t powerPin, uint16_t inrush_ms)
+    : _powerPin(powerPin),
+      _inrush_ms(inrush_ms) {
+    _powerIO.attach(_powerPin);
+}
+
+
+bool PowerRail::hold(void) {
+    _users++;
+    if (_users > 1) return false;
+    if (_powerPin < 0) {
+        // Mark the power-on time, just in case it had not been marked
+        if (_millisPowerOn == 0) _millisPowerOn = millis();
+        return false;
+    }
+    MS_DBG(F("Switching on the power rail on pin"), _powerPin);
+    pinMode(_powerPin, OUTPUT);
+    _powerIO.high();
+    _millisPowerOn = millis();
+    return true;
+}
+
+
+void PowerRail::release(void) {
+    if (_users == 0) return;
+    _users--;
+    if (_users > 0 || _powerPin < 0) return;
+    MS_DBG(F("Switching off the power rail on pin"), _powerPin);
+    _powerIO.low();
+    _millisPowerOn = 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file PowerRail.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the PowerRail class, a switched power supply shared by
+ * several sensors.
+ */
+
+// Header Guards
+#ifndef SRC_POWERRAIL_H_
+#define SRC_POWERRAIL_H_
+
+// Debugging Statement
+// #define MS_POWERRAIL_DEBUG
+
+#ifdef MS_POWERRAIL_DEBUG
+#define MS_DEBUGGING_STD "PowerRail"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "FastPin.h"
+
+/**
+ * @brief A switched power supply, like the switched 12V or 3.3V of a Mayfly,
+ * shared by several sensors.
+ *
+ * Giving each sensor on a rail the same power pin switches the rail once for
+ * each of them and cuts it for all of them as soon as any one powers down.
+ * Sensors attached to a rail with Sensor::setPowerRail() instead hold the
+ * rail: it is switched on when the first of them powers up, and stays on until
+ * the last of them powers down.  All of them count their warm-up from the time
+ * the rail was switched on.
+ *
+ * VariableArray::sensorsPowerUp() powers the sensors with the longest warm-up
+ * times first, so the longest warm-up overlaps everything else, and waits for
+ * the inrush time of each rail it switches on before switching the next, so
+ * the inrush currents don't add up into a brown-out.
+ *
+ * @ingroup base_classes
+ */
+class PowerRail {
+ public:
+    /**
+     * @brief Construct a new power rail object
+     *
+     * @param powerPin The pin on the mcu switching the rail; a negative
+     * number for a rail that is always on
+     * @param inrush_ms The time in milliseconds to wait after switching the
+     * rail on before switching on anything else.  Default is 0.
+     */
+    explicit PowerRail(int8_t powerPin, uint16_t inrush_ms = 0);
+
+    /**
+     * @brief Add one to the users of the rail, switching it on if it was off.
+     *
+     * @return **bool** True if the rail was switched on by this call
+     */
+    bool hold(void);
+    /**
+     * @brief Take one from the users of the rail, switching it off after the
+     * last one.
+     */
+    void release(void);
+    /**
+     * @brief Check whether the rail is on.
+     *
+     * @return **bool** True if the rail has any users, or is always on
+     */
+    bool isPowered(void) {
+        return _powerPin < 0 || _users > 0;
+    }
+    /**
+     * @brief Get the millis() the rail was switched on.
+     *
+     * @return **uint32_t** The time the rail was switched on; 0 if it is off
+     * or has never been switched by this library
+     */
+    uint32_t getMillisPowerOn(void) {
+        return _millisPowerOn;
+    }
+    /**
+     * @brief Get the time to wait after switching the rail on before
+     * switching on anything else.
+     *
+     * @return **uint16_t** The inrush time in milliseconds
+     */
+    uint16_t getInrushTime(void) {
+        return _inrush_ms;
+    }
+    /**
+     * @brief Get the pin switching the rail.
+     *
+     * @return **int8_t** The pin on the mcu; negative if the rail is always on
+     */
+    int8_t getPowerPin(void) {
+        return _powerPin;
+    }
+
+ protected:
+    /**
+     * @brief The pin on the mcu switching the rail
+     */
+    int8_t _powerPin;
+    /**
+     * @brief The time to wait after switching the rail on
+     */
+    uint16_t _inrush_ms;
+    /**
+     * @brief The number of sensors holding the rail on
+     */
+    uint8_t _users = 0;
+    /**
+     * @brief The millis() the rail was switched on; 0 while it is off
+     */
+    uint32_t _millisPowerOn = 0;
+    /**
+     * @brief The port register and bit mask of the power pin
+     */
+    FastPin _powerIO;
+};
+
+#endif  // SRC_POWERRAIL_H_
@@ -9,11 +9,22 @@
 
 #include "SensorBase.h"
 #include "VariableBase.h"
+#include "LoggerBase.h"
+
+// Bring in the library to handle the processor idle mode
+#if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+#include <avr/sleep.h>
+#endif
 
 // ============================================================================
 //  The class and functions for interfacing with a sensor
 // ============================================================================
 
+// Initialize the static wait function
+void (*Sensor::_waitCallback)(void) = nullptr;
+// Initialize the count of wakes for shared results
+uint16_t Sensor::_wakeGeneration = 0;
+
 // The constructor
 Sensor::Sensor(const char* sensorName, const uint8_t totalReturnedValues,
                uint32_t warmUpTime_ms, uint32_t stabilizationTime_ms,
@@ -21,6 +32,7 @@ Sensor::Sensor(const char* sensorName, const uint8_t totalReturnedValues,
                uint8_t measurementsToAverage, uint8_t incCalcValues)
     : _dataPin(dataPin),
       _powerPin(powerPin),
+      _ownPowerPin(powerPin),
       _sensorName(sensorName),
       _numReturnedValues(totalReturnedValues),
       _measurementsToAverage(measurementsToAverage),
@@ -28,15 +40,51 @@ Sensor::Sensor(const char* sensorName, const uint8_t totalReturnedValues,
       _warmUpTime_ms(warmUpTime_ms),
       _stabilizationTime_ms(stabilizationTime_ms),
       _measurementTime_ms(measurementTime_ms) {
+    // Reserve exactly as much space for the results as this sensor returns
+    sensorValues               = new float[_numReturnedValues];
+    numberGoodMeasurementsMade = new uint8_t[_numReturnedValues];
+    variables                  = new Variable*[_numReturnedValues];
+    _powerIO.attach(_powerPin);
+#if defined(MS_SENSOR_FIXED_POINT)
+    _resultSums     = new int32_t[_numReturnedValues];
+    _resultDecimals = new uint8_t[_numReturnedValues];
+#endif
+#if defined(MS_SENSOR_STATISTICS)
+    _resultM2  = new float[_numReturnedValues];
+    _resultMin = new float[_numReturnedValues];
+    _resultMax = new float[_numReturnedValues];
+#endif
     // Clear arrays
-    for (uint8_t i = 0; i < MAX_NUMBER_VARS; i++) {
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
         variables[i]                  = nullptr;
         sensorValues[i]               = -9999;
         numberGoodMeasurementsMade[i] = 0;
+#if defined(MS_SENSOR_FIXED_POINT)
+        _resultSums[i]     = 0;
+        _resultDecimals[i] = 0;
+#endif
+#if defined(MS_SENSOR_STATISTICS)
+        _resultM2[i]  = 0;
+        _resultMin[i] = -9999;
+        _resultMax[i] = -9999;
+#endif
     }
 }
 // Destructor
-Sensor::~Sensor() {}
+Sensor::~Sensor() {
+    delete[] sensorValues;
+    delete[] numberGoodMeasurementsMade;
+    delete[] variables;
+#if defined(MS_SENSOR_FIXED_POINT)
+    delete[] _resultSums;
+    delete[] _resultDecimals;
+#endif
+#if defined(MS_SENSOR_STATISTICS)
+    delete[] _resultM2;
+    delete[] _resultMin;
+    delete[] _resultMax;
+#endif
+}
 
 
 // This gets the place the sensor is installed ON THE MAYFLY (ie, pin number)
@@ -47,6 +95,22 @@ String Sensor::getSensorLocation(void) {
 }
 
 
+#if defined(MS_NO_STRING)
+// This returns the name of the sensor.
+const char* Sensor::getSensorName(void) {
+    return _sensorName;
+}
+
+
+// The location is only ever made as a String here, the first time it's needed
+const char* Sensor::getSensorNameAndLocation(void) {
+    if (_sensorLabel[0] == '\0') {
+        snprintf(_sensorLabel, sizeof(_sensorLabel), "%s at %s",
+                 getSensorName(), getSensorLocation().c_str());
+    }
+    return _sensorLabel;
+}
+#else
 // This returns the name of the sensor.
 String Sensor::getSensorName(void) {
     return _sensorName;
@@ -57,6 +121,7 @@ String Sensor::getSensorName(void) {
 String Sensor::getSensorNameAndLocation(void) {
     return getSensorName() + " at " + getSensorLocation();
 }
+#endif
 
 
 // This returns the number of the power pin
@@ -65,6 +130,18 @@ int8_t Sensor::getPowerPin(void) {
 }
 
 
+// A sensor coming off a rail goes back to its own pin
+void Sensor::setPowerRail(PowerRail* rail) {
+    if (_railHeld) {
+        _powerRail->release();
+        _railHeld = false;
+    }
+    _powerRail = rail;
+    _powerPin  = rail != nullptr ? rail->getPowerPin() : _ownPowerPin;
+    _powerIO.attach(_powerPin);
+}
+
+
 // These functions get and set the number of readings to average for a sensor
 // Generally these values should be set in the constructor
 void Sensor::setNumberMeasurementsToAverage(uint8_t nReadings) {
@@ -73,6 +150,362 @@ void Sensor::setNumberMeasurementsToAverage(uint8_t nReadings) {
 uint8_t Sensor::getNumberMeasurementsToAverage(void) {
     return _measurementsToAverage;
 }
+// The result arrays are allocated in the constructor, one entry for each value
+uint16_t Sensor::getResultBytes(void) {
+    uint16_t perValue = sizeof(float) + sizeof(uint8_t) + sizeof(Variable*);
+#if defined(MS_SENSOR_STATISTICS)
+    perValue += 3 * sizeof(float);
+#endif
+#if defined(MS_SENSOR_FIXED_POINT)
+    perValue += sizeof(int32_t) + sizeof(uint8_t);
+#endif
+    return sizeof(Sensor) + _numReturnedValues * perValue;
+}
+
+
+// These functions get and set how often the sensor is measured within a
+// variable array
+void Sensor::setUpdateInterval(uint8_t updateInterval,
+                               bool    markSkippedValues) {
+    // An interval of 0 makes no sense, treat it as every update
+    _updateInterval    = updateInterval == 0 ? 1 : updateInterval;
+    _updatesUntilDue   = 0;
+    _markSkippedValues = markSkippedValues;
+}
+uint8_t Sensor::getUpdateInterval(void) {
+    return _updateInterval;
+}
+bool Sensor::getMarkSkippedValues(void) {
+    return _markSkippedValues;
+}
+
+
+// These functions set up adaptive averaging, where the sensor stops taking
+// readings once the standard error of the mean of one result is small enough
+void Sensor::setAdaptiveAveraging(float maxStandardError, uint8_t resultNumber,
+                                  uint8_t minMeasurements) {
+    _adaptiveMaxStdError  = maxStandardError;
+    _adaptiveResultNumber = resultNumber;
+    // We need at least two readings to have any estimate of the spread
+    _adaptiveMinMeasurements = minMeasurements < 2 ? 2 : minMeasurements;
+}
+float Sensor::getAdaptiveStandardError(void) {
+    return _adaptiveMaxStdError;
+}
+
+
+// This checks if the standard error of the adaptive result has dropped below
+// the threshold.  The variance is the running M2 over n-1 and the standard
+// error is the standard deviation over the square root of n, so we compare the
+// squares to avoid the square roots:  M2 / (n * (n-1)) <= threshold^2
+bool Sensor::isAveragingConverged(void) {
+    if (_adaptiveMaxStdError <= 0) return false;
+    if (_adaptiveResultNumber >= _numReturnedValues) return false;
+    uint8_t n = numberGoodMeasurementsMade[_adaptiveResultNumber];
+    if (n < _adaptiveMinMeasurements) return false;
+    bool converged = _adaptiveM2 <=
+        _adaptiveMaxStdError * _adaptiveMaxStdError * n * (n - 1);
+    if (converged) {
+        MS_DBG(getSensorNameAndLocation(), F("converged after"), n,
+               F("good readings"));
+    }
+    return converged;
+}
+
+
+// These functions set up burst sampling, where each measurement is a fast run
+// of raw samples reduced as they are taken
+void Sensor::setBurstMode(uint16_t nSamples, uint16_t sampleRate_Hz,
+                          float percentile) {
+    _burstSamples     = nSamples;
+    _burstInterval_us = 1000000UL / (sampleRate_Hz == 0 ? 1 : sampleRate_Hz);
+    _burstPercentile  = percentile;
+}
+uint16_t Sensor::getBurstSamples(void) {
+    return _burstSamples;
+}
+
+
+// These functions suspend and resume the sensor entirely
+void Sensor::setSuspended(bool suspended) {
+    if (suspended != _suspended) {
+        MS_DBG(getSensorNameAndLocation(),
+               suspended ? F("suspended") : F("resumed"));
+    }
+    _suspended = suspended;
+    // A sensor kept powered since its last update isn't left on while it's
+    // suspended
+    if (suspended && _millisPowerOn != 0 && _powerPin >= 0) powerDown();
+}
+bool Sensor::isSuspended(void) {
+    return _suspended;
+}
+void Sensor::setDeferredSetup(bool deferSetup) {
+    _deferSetup = deferSetup;
+}
+bool Sensor::getDeferredSetup(void) {
+    return _deferSetup;
+}
+void Sensor::setCritical(bool critical) {
+    _critical = critical;
+}
+bool Sensor::isCritical(void) {
+    return _critical;
+}
+
+
+// These functions tune the times of the sensor to the unit
+void Sensor::setTiming(uint32_t warmUpTime_ms, uint32_t stabilizationTime_ms,
+                       uint32_t measurementTime_ms) {
+    _warmUpTime_ms        = warmUpTime_ms;
+    _stabilizationTime_ms = stabilizationTime_ms;
+    _measurementTime_ms   = measurementTime_ms;
+}
+// The values are taken out of the result arrays one reading at a time, so
+// they're left cleared
+bool Sensor::takeTimedReading(uint32_t wait_ms, float values[]) {
+    clearValues();
+    startSingleMeasurement();
+    uint32_t start = millis();
+    while (millis() - start < wait_ms) {
+        // wait
+    }
+    addSingleMeasurementResult();
+    averageMeasurements();
+    bool allGood = true;
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        values[i] = numberGoodMeasurementsMade[i] > 0 ? sensorValues[i]
+                                                      : -9999;
+        if (values[i] == -9999) allGood = false;
+    }
+    clearValues();
+    return allGood;
+}
+// Each step is measured with the old times of the steps after it, so a
+// reading taken too soon is never mistaken for one that's settled
+bool Sensor::calibrateTiming(uint8_t marginPercent, bool probeMeasurement) {
+    uint32_t oldWarmUp  = _warmUpTime_ms;
+    uint32_t oldStable  = _stabilizationTime_ms;
+    uint32_t oldMeasure = _measurementTime_ms;
+    float    values[MAX_NUMBER_VARS];
+    float    lastValues[MAX_NUMBER_VARS];
+    MS_DBG(F("Calibrating the times of"), getSensorNameAndLocation());
+
+    // The warm-up, from off to the first successful wake; a sensor whose
+    // power isn't switched keeps its old warm-up
+    bool fromOff = _powerPin >= 0;
+    powerDown();
+    if (fromOff) delay(1000);  // Let the sensor drain before it's timed
+    powerUp();
+    uint32_t warmUp = oldWarmUp;
+    bool     awake  = false;
+    while (!awake) {
+        uint32_t elapsed = millis() - _millisPowerOn;
+        awake            = wake();
+        if (awake) {
+            if (fromOff) warmUp = elapsed;
+        } else if (elapsed >= oldWarmUp) {
+            break;
+        } else {
+            delay(MS_TIMING_POLL_MS);
+        }
+    }
+    if (!awake) {
+        // One last try with the whole warm-up, as in an update
+        while (millis() - _millisPowerOn < oldWarmUp) {
+            // wait
+        }
+        awake = wake();
+    }
+    if (!awake) {
+        MS_DBG(getSensorNameAndLocation(), F("didn't wake; times unchanged"));
+        sleep();
+        powerDown();
+        return false;
+    }
+    uint32_t wokeAt = _millisSensorActivated;
+
+    // The stabilization, to the first of a run of settled readings
+    uint32_t stable    = oldStable;
+    uint32_t runStart  = 0;
+    uint8_t  runLength = 0;
+    bool     anyGood   = false;
+    bool     settled   = false;
+    while (!settled) {
+        uint32_t readingAt = millis();
+        bool     good      = takeTimedReading(oldMeasure, values);
+        anyGood |= good;
+        bool within = good && runLength > 0;
+        for (uint8_t i = 0; within && i < _numReturnedValues; i++) {
+            within = fabs(values[i] - lastValues[i]) <=
+                MS_TIMING_SETTLE_FRACTION * fabs(lastValues[i]);
+        }
+        if (!good) {
+            runLength = 0;
+        } else if (!within) {
+            runStart  = readingAt;
+            runLength = 1;
+        } else {
+            runLength++;
+        }
+        for (uint8_t i = 0; i < _numReturnedValues; i++) {
+            lastValues[i] = values[i];
+        }
+        if (runLength >= MS_TIMING_SETTLE_READINGS) {
+            settled = true;
+            stable  = runStart - wokeAt;
+        } else if (readingAt - wokeAt > oldStable &&
+                   (runLength == 0 || runStart - wokeAt > oldStable)) {
+            // Past the old stabilization time with no run started before it
+            break;
+        }
+    }
+    if (!anyGood) {
+        MS_DBG(getSensorNameAndLocation(),
+               F("gave no good readings; times unchanged"));
+        sleep();
+        powerDown();
+        return false;
+    }
+
+    // The measurement time, as the shortest eighth that gives good results
+    uint32_t measure = oldMeasure;
+    if (probeMeasurement && oldMeasure > 0) {
+        for (uint8_t eighths = 1; eighths < 8; eighths++) {
+            uint32_t wait_ms = oldMeasure * eighths / 8;
+            uint8_t  good    = 0;
+            while (good < MS_TIMING_SETTLE_READINGS &&
+                   takeTimedReading(wait_ms, values)) {
+                good++;
+            }
+            if (good == MS_TIMING_SETTLE_READINGS) {
+                measure = wait_ms;
+                break;
+            }
+        }
+    }
+    sleep();
+    powerDown();
+
+    // Add the margin, but never take longer than before
+    uint32_t times[3]    = {warmUp, stable, measure};
+    uint32_t oldTimes[3] = {oldWarmUp, oldStable, oldMeasure};
+    for (uint8_t k = 0; k < 3; k++) {
+        times[k] += times[k] * marginPercent / 100;
+        if (times[k] > oldTimes[k]) times[k] = oldTimes[k];
+    }
+    setTiming(times[0], times[1], times[2]);
+    MS_DBG(getSensorNameAndLocation(), F("times calibrated to"), times[0],
+           times[1], times[2], F("ms from"), oldWarmUp, oldStable, oldMeasure);
+    return true;
+}
+
+
+// These functions decide whether the sensor is kept powered between updates
+void Sensor::setPowerCosts(float idleCurrent_mA, float warmUpCurrent_mA) {
+    _idleCurrent_mA   = idleCurrent_mA;
+    _warmUpCurrent_mA = warmUpCurrent_mA;
+}
+// The sensor idles until it's due again, counting the updates it's skipped
+bool Sensor::isKeepingPowerCheaper(uint32_t updatePeriod_ms) {
+    if (_warmUpCurrent_mA <= 0 || _suspended) return false;
+    bool anyGood = false;
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        if (numberGoodMeasurementsMade[i] > 0) anyGood = true;
+    }
+    if (!anyGood) return false;
+    float idleTime_ms = static_cast<float>(updatePeriod_ms) *
+        (static_cast<uint32_t>(_updatesUntilDue) + 1);
+    return _idleCurrent_mA * idleTime_ms < _warmUpCurrent_mA * _warmUpTime_ms;
+}
+
+
+// These functions set up skipping a sensor that keeps failing
+void Sensor::setFailureBackoff(uint8_t failuresToSkip,
+                               uint16_t maxSkipUpdates) {
+    _failuresToSkip = failuresToSkip;
+    _maxSkipUpdates = maxSkipUpdates;
+}
+uint8_t Sensor::getConsecutiveFailures(void) {
+    return _consecutiveFailures;
+}
+bool Sensor::isBackingOff(void) {
+    return _backingOff;
+}
+uint16_t Sensor::getFailureSkipsLeft(void) {
+    return _failureSkipsLeft;
+}
+void Sensor::restoreFailureState(uint8_t failures, uint16_t skipsLeft) {
+    _consecutiveFailures = failures;
+    _failureSkipsLeft    = skipsLeft;
+}
+
+
+// An update with no good results at all is a failure.  Past the threshold,
+// the number of updates skipped doubles with each failure.
+void Sensor::recordUpdateResult(void) {
+    bool anyGood = false;
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        if (numberGoodMeasurementsMade[i] > 0) anyGood = true;
+    }
+    if (anyGood) {
+        if (_failuresToSkip > 0 && _consecutiveFailures >= _failuresToSkip) {
+            PRINTOUT(getSensorNameAndLocation(), F("has recovered"));
+        }
+        _consecutiveFailures = 0;
+        _resultValid         = true;
+        _resultMillis        = millis();
+        _resultTime          = Logger::markedUTCEpochTime;
+        _resultGeneration    = _wakeGeneration;
+        return;
+    }
+    if (_consecutiveFailures < 255) _consecutiveFailures++;
+    if (_failuresToSkip == 0 || _consecutiveFailures < _failuresToSkip) return;
+
+    uint8_t  doublings = _consecutiveFailures - _failuresToSkip;
+    uint32_t skip      = doublings < 16 ? 1UL << doublings : _maxSkipUpdates;
+    if (skip > _maxSkipUpdates) skip = _maxSkipUpdates;
+    _failureSkipsLeft = skip;
+    PRINTOUT(getSensorNameAndLocation(), F("failed"), _consecutiveFailures,
+             F("times in a row; skipping it for"), skip, F("updates"));
+}
+
+
+// These functions share a sensor's last good result between updates
+void Sensor::setResultMaxAge(uint32_t maxAge_ms) {
+    _resultMaxAge_ms = maxAge_ms;
+}
+bool Sensor::hasFreshResult(void) {
+    return _resultMaxAge_ms > 0 && _resultValid &&
+        _resultGeneration == _wakeGeneration &&
+        millis() - _resultMillis <= _resultMaxAge_ms;
+}
+void Sensor::expireAllResults(void) {
+    _wakeGeneration++;
+}
+
+
+// This checks if the sensor is due to be measured and counts down to the next
+// time it will be
+bool Sensor::checkUpdateDue(void) {
+    _backingOff = false;
+    if (_suspended) return false;
+    if (_failureSkipsLeft > 0) {
+        _failureSkipsLeft--;
+        _backingOff = true;
+        MS_DBG(getSensorNameAndLocation(), F("is failing; skipped for"),
+               _failureSkipsLeft, F("more update[s]"));
+        return false;
+    }
+    if (_updatesUntilDue == 0) {
+        _updatesUntilDue = _updateInterval - 1;
+        return true;
+    }
+    _updatesUntilDue--;
+    MS_DBG(getSensorNameAndLocation(), F("will be skipped for"),
+           _updatesUntilDue + 1, F("more update[s]"));
+    return false;
+}
 
 
 // This returns the 8-bit code for the current status of the sensor.
@@ -91,12 +524,23 @@ uint8_t Sensor::getStatus(void) {
 
 // This turns on sensor power
 void Sensor::powerUp(void) {
-    if (_powerPin >= 0) {
+    if (_powerRail != nullptr) {
+        // The rail is only switched by the first of its sensors to power up
+        if (!_railHeld) {
+            MS_DBG(F("Powering"), getSensorNameAndLocation(),
+                   F("from the rail on pin"), _powerPin);
+            _powerRail->hold();
+            _railHeld = true;
+        }
+        // The warm-up counts from when the rail came on
+        _millisPowerOn = _powerRail->getMillisPowerOn();
+        if (_millisPowerOn == 0) _millisPowerOn = millis();
+    } else if (_powerPin >= 0) {
         MS_DBG(F("Powering"), getSensorNameAndLocation(), F("with pin"),
                _powerPin);
         // Set the pin mode, just in case
         pinMode(_powerPin, OUTPUT);
-        digitalWrite(_powerPin, HIGH);
+        _powerIO.high();
         // Mark the time that the sensor was powered
         _millisPowerOn = millis();
     } else {
@@ -112,10 +556,15 @@ void Sensor::powerUp(void) {
 
 // This turns off sensor power
 void Sensor::powerDown(void) {
+    // The rail stays on until the last of its sensors lets go of it
+    if (_railHeld) {
+        _powerRail->release();
+        _railHeld = false;
+    }
     if (_powerPin >= 0) {
         MS_DBG(F("Turning off power to"), getSensorNameAndLocation(),
                F("with pin"), _powerPin);
-        digitalWrite(_powerPin, LOW);
+        if (_powerRail == nullptr) _powerIO.low();
         // Unset the power-on time
         _millisPowerOn = 0;
         // Unset the activation time
@@ -153,6 +602,11 @@ bool Sensor::setup(void) {
     if (_dataPin >= 0)
         pinMode(_dataPin, INPUT);  // NOTE:  Not turning on pull-up!
 
+#if defined(MS_NO_STRING)
+    // Make the name and location now, rather than during a later cycle
+    getSensorNameAndLocation();
+#endif
+
     // Set the status bit marking that the sensor has been set up (bit 0)
     _sensorStatus |= 0b00000001;
 
@@ -182,6 +636,9 @@ bool Sensor::wake(void) {
     _millisSensorActivated = millis();
     // Set the status bit for sensor wake/activation success (bit 4)
     _sensorStatus |= 0b00010000;
+    // Record how long the sensor took from power on to waking
+    _lastWarmUpTime_ms        = _millisSensorActivated - _millisPowerOn;
+    _lastStabilizationTime_ms = 0;
 
     return true;
 }
@@ -222,6 +679,12 @@ bool Sensor::startSingleMeasurement(void) {
     if (bitRead(_sensorStatus, 4)) {
         // Mark the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        // Record how long the sensor took from waking to the first
+        // measurement request
+        if (_lastStabilizationTime_ms == 0) {
+            _lastStabilizationTime_ms = _millisMeasurementRequested -
+                _millisSensorActivated;
+        }
         // Set the status bit for measurement start success (bit 6)
         _sensorStatus |= 0b01000000;
     } else {
@@ -238,6 +701,10 @@ bool Sensor::startSingleMeasurement(void) {
 
 
 void Sensor::registerVariable(int sensorVarNum, Variable* var) {
+    // There's only room for the number of values the sensor returns.
+    // NOTE:  This is usually called during static initialization, before any
+    // serial port is running, so we can't print a debugging message here.
+    if (sensorVarNum < 0 || sensorVarNum >= _numReturnedValues) return;
     variables[sensorVarNum] = var;
 }
 
@@ -259,15 +726,32 @@ void Sensor::notifyVariables(void) {
                    F("!  No update sent!"));
         }
     }
+    // Each statistic variable passes the update on to the next in the list
+    if (_statVariables != nullptr) { _statVariables->onSensorUpdate(this); }
 }
 
 
 // This function just empties the value array
 void Sensor::clearValues(void) {
     MS_DBG(F("Clearing value array for"), getSensorNameAndLocation());
+    _adaptiveM2       = 0;
+    _resultValid      = false;
+    _midpointCount    = 0;
+#if defined(MS_SENSOR_FIXED_POINT)
+    _fixedPointResults = 0;
+#endif
     for (uint8_t i = 0; i < _numReturnedValues; i++) {
         sensorValues[i]               = -9999;
         numberGoodMeasurementsMade[i] = 0;
+#if defined(MS_SENSOR_FIXED_POINT)
+        _resultSums[i]     = 0;
+        _resultDecimals[i] = 0;
+#endif
+#if defined(MS_SENSOR_STATISTICS)
+        _resultM2[i]  = 0;
+        _resultMin[i] = -9999;
+        _resultMax[i] = -9999;
+#endif
     }
 }
 
@@ -276,6 +760,35 @@ void Sensor::clearValues(void) {
 // averaged
 void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                                            float   resultValue) {
+#if defined(MS_SENSOR_FIXED_POINT)
+    if (_fixedPointResults & (1 << resultNumber)) {
+        foldFixedPointResult(resultNumber);
+    }
+#endif
+    // Update the running spread of the values before the new value goes into
+    // the sum.  This is Welford's method; the running mean is the current sum
+    // divided by the number of good results so far.
+    if (resultValue != -9999 && numberGoodMeasurementsMade[resultNumber] > 0) {
+        uint8_t nOld    = numberGoodMeasurementsMade[resultNumber];
+        float   meanOld = sensorValues[resultNumber] / nOld;
+        float   meanNew = meanOld + (resultValue - meanOld) / (nOld + 1);
+        float   deltaM2 = (resultValue - meanOld) * (resultValue - meanNew);
+        if (resultNumber == _adaptiveResultNumber) {
+            _adaptiveM2 += deltaM2;
+        }
+#if defined(MS_SENSOR_STATISTICS)
+        _resultM2[resultNumber] += deltaM2;
+        if (resultValue < _resultMin[resultNumber]) {
+            _resultMin[resultNumber] = resultValue;
+        }
+        if (resultValue > _resultMax[resultNumber]) {
+            _resultMax[resultNumber] = resultValue;
+        }
+    } else if (resultValue != -9999) {
+        _resultMin[resultNumber] = resultValue;
+        _resultMax[resultNumber] = resultValue;
+#endif
+    }
     // If the new result is good and there was were only bad results, set the
     // result value as the new result and add 1 to the good result total
     if (sensorValues[resultNumber] == -9999 && resultValue != -9999) {
@@ -305,21 +818,88 @@ void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
 }
 void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                                            int16_t resultValue) {
-    float float_val = resultValue;  // cast the int16_t to a float
-    verifyAndAddMeasurementResult(resultNumber, float_val);
+    verifyAndAddMeasurementResult(resultNumber,
+                                  static_cast<int32_t>(resultValue), 0);
 }
 void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                                            int32_t resultValue) {
-    auto float_val =
-        static_cast<float>(resultValue);  // cast the int32_t to a float
-    verifyAndAddMeasurementResult(resultNumber, float_val);
+    verifyAndAddMeasurementResult(resultNumber, resultValue, 0);
 }
 
 
+// The powers of ten for the decimal places of a scaled whole number result
+static const uint32_t resultScales[] = {1, 10, 100, 1000, 10000, 100000,
+                                        1000000};
+
+// A failed result is -9999 at any scale
+void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
+                                           int32_t resultValue,
+                                           uint8_t decimals) {
+    if (decimals > 6) decimals = 6;
+#if defined(MS_SENSOR_FIXED_POINT) && !defined(MS_SENSOR_STATISTICS)
+    uint8_t resultBit = 1 << resultNumber;
+    bool    fixed     = numberGoodMeasurementsMade[resultNumber] == 0 ||
+        (_fixedPointResults & resultBit);
+    // The spread of the adaptive result needs the float of each value
+    if (_adaptiveMaxStdError > 0 && resultNumber == _adaptiveResultNumber) {
+        fixed = false;
+    }
+    if (fixed && resultValue != -9999 &&
+        numberGoodMeasurementsMade[resultNumber] > 0) {
+        int32_t sum = _resultSums[resultNumber];
+        fixed       = _resultDecimals[resultNumber] == decimals &&
+            (resultValue > 0 ? sum <= INT32_MAX - resultValue
+                             : sum >= INT32_MIN - resultValue);
+    }
+    if (fixed) {
+        if (resultValue == -9999) {
+            MS_DBG(F("Ignoring bad result for variable"), resultNumber,
+                   F("from"), getSensorNameAndLocation());
+            return;
+        }
+        if (numberGoodMeasurementsMade[resultNumber] == 0) {
+            _resultSums[resultNumber]     = 0;
+            _resultDecimals[resultNumber] = decimals;
+            _fixedPointResults |= resultBit;
+        }
+        MS_DBG(F("Adding"), resultValue, F("e-"), decimals,
+               F("to result array for variable"), resultNumber, F("from"),
+               getSensorNameAndLocation());
+        _resultSums[resultNumber] += resultValue;
+        numberGoodMeasurementsMade[resultNumber] += 1;
+        return;
+    }
+#endif
+    float floatValue = static_cast<float>(resultValue);
+    if (resultValue != -9999 && decimals > 0) {
+        floatValue /= resultScales[decimals];
+    }
+    verifyAndAddMeasurementResult(resultNumber, floatValue);
+}
+#if defined(MS_SENSOR_FIXED_POINT)
+void Sensor::foldFixedPointResult(uint8_t resultNumber) {
+    sensorValues[resultNumber] = static_cast<float>(_resultSums[resultNumber]) /
+        resultScales[_resultDecimals[resultNumber]];
+    _fixedPointResults &= ~(1 << resultNumber);
+}
+#endif
+
+
 void Sensor::averageMeasurements(void) {
     MS_DBG(F("Averaging results from"), getSensorNameAndLocation(), F("over"),
            _measurementsToAverage, F("reading[s]"));
     for (uint8_t i = 0; i < _numReturnedValues; i++) {
+#if defined(MS_SENSOR_FIXED_POINT)
+        // The one float division of a result summed as whole numbers
+        if (_fixedPointResults & (1 << i)) {
+            sensorValues[i] = static_cast<float>(_resultSums[i]) /
+                (static_cast<float>(resultScales[_resultDecimals[i]]) *
+                 numberGoodMeasurementsMade[i]);
+            _fixedPointResults &= ~(1 << i);
+            MS_DBG(F("    ->Result #"), i, ':', sensorValues[i]);
+            continue;
+        }
+#endif
         if (numberGoodMeasurementsMade[i] > 0)
             sensorValues[i] /= numberGoodMeasurementsMade[i];
         MS_DBG(F("    ->Result #"), i, ':', sensorValues[i]);
@@ -327,6 +907,90 @@ void Sensor::averageMeasurements(void) {
 }
 
 
+// By default a sensor can't take burst samples
+float Sensor::readBurstSample(void) {
+    return -9999;
+}
+
+
+// This takes the burst samples on a fixed schedule from the start of the burst
+// so a slow sample doesn't shift all of the ones after it
+bool Sensor::takeBurst(BurstStatistics& stats) {
+    stats.setPercentile(_burstPercentile);
+    MS_DBG(getSensorNameAndLocation(), F("taking a burst of"), _burstSamples,
+           F("samples"));
+    MS_START_DEBUG_TIMER;
+    uint32_t burstStart = micros();
+    for (uint16_t i = 0; i < _burstSamples; i++) {
+        uint32_t due = static_cast<uint32_t>(i) * _burstInterval_us;
+        while (micros() - burstStart < due) {}
+        stats.add(readBurstSample());
+    }
+    MS_DBG(stats.getCount(), F("good samples in"), MS_PRINT_DEBUG_TIMER,
+           F("ms"));
+    return stats.getCount() > 0;
+}
+
+
+void Sensor::addBurstResult(uint8_t resultNumber, BurstStatistics& stats,
+                            burstStatistic statistic) {
+    verifyAndAddMeasurementResult(resultNumber, stats.get(statistic));
+}
+
+
+#if defined(MS_SENSOR_STATISTICS)
+// These return the running statistics of the results of the last update
+float Sensor::getResultStdDev(uint8_t resultNumber) {
+    if (numberGoodMeasurementsMade[resultNumber] < 2) return -9999;
+    return sqrt(_resultM2[resultNumber] /
+                (numberGoodMeasurementsMade[resultNumber] - 1));
+}
+float Sensor::getResultMin(uint8_t resultNumber) {
+    return _resultMin[resultNumber];
+}
+float Sensor::getResultMax(uint8_t resultNumber) {
+    return _resultMax[resultNumber];
+}
+uint8_t Sensor::getResultCount(uint8_t resultNumber) {
+    return numberGoodMeasurementsMade[resultNumber];
+}
+#endif
+
+
+// These return the actual time taken by each step of the last update
+uint32_t Sensor::getLastWarmUpTime(void) {
+    return _lastWarmUpTime_ms;
+}
+uint32_t Sensor::getLastStabilizationTime(void) {
+    return _lastStabilizationTime_ms;
+}
+uint32_t Sensor::getLastMeasurementTime(void) {
+    return _lastMeasurementTime_ms;
+}
+// The mean is kept as a running mean, so the sum of the times can't overflow
+void Sensor::markMeasurementTime(void) {
+    if (bitRead(_sensorStatus, 6)) {
+        _lastMeasurementTime_ms = millis() - _millisMeasurementRequested;
+        uint32_t mid = _millisMeasurementRequested +
+            _lastMeasurementTime_ms / 2;
+        if (_midpointCount < 0xFF) _midpointCount++;
+        _millisMeasurementMid += static_cast<int32_t>(
+                                     mid - _millisMeasurementMid) /
+            _midpointCount;
+    }
+    // A failed start still talked to the sensor, so it counts
+    _millisLastResult = millis();
+}
+
+
+// This adds a statistic variable to the front of the list
+Variable* Sensor::registerStatisticVariable(Variable* var) {
+    Variable* previousHead = _statVariables;
+    _statVariables         = var;
+    return previousHead;
+}
+
+
 // This updates a sensor value by checking it's power, waking it, taking as many
 // readings as requested, then putting the sensor to sleep and powering down.
 bool Sensor::update(void) {
@@ -355,15 +1019,23 @@ bool Sensor::update(void) {
 
     // loop through as many measurements as requested
     for (uint8_t j = 0; j < _measurementsToAverage; j++) {
-        // start a measurement
+        // wait until the sensor can be read again
+        waitForMeasurementInterval();
+        // start a measurement, at the clock of the sensor's I2C bus
+        applyI2CClock();
         ret_val &= startSingleMeasurement();
         // wait for the measurement to finish
         waitForMeasurementCompletion();
         // get the measurement result
+        markMeasurementTime();
+        applyI2CClock();
         ret_val &= addSingleMeasurementResult();
+        // stop early if the average has already settled
+        if (isAveragingConverged()) break;
     }
 
     averageMeasurements();
+    recordUpdateResult();
 
     // Put the sensor back to sleep if it had been activated
     if (wasActive) { sleep(); }
@@ -384,12 +1056,20 @@ bool Sensor::checkPowerOn(bool debug) {
         MS_DBG(F("Checking power status:  Power to"),
                getSensorNameAndLocation());
     }
-    if (_powerPin >= 0) {
-        auto powerBitNumber =
-            static_cast<int8_t>(log(digitalPinToBitMask(_powerPin)) / log(2));
-
-        if (bitRead(*portInputRegister(digitalPinToPort(_powerPin)),
-                    powerBitNumber) == LOW) {
+    if (_powerRail != nullptr && _powerPin >= 0) {
+        // The rail may be on for the other sensors on it
+        bool powered = _railHeld && _powerRail->isPowered();
+        if (debug) { MS_DBG(powered ? F("is held on.") : F("is not held.")); }
+        if (!powered) {
+            _millisPowerOn = 0;
+            _sensorStatus &= 0b10000001;
+        } else {
+            if (_millisPowerOn == 0) _millisPowerOn = millis();
+            _sensorStatus |= 0b00000110;
+        }
+        return powered;
+    } else if (_powerPin >= 0) {
+        if (!_powerIO.read()) {
             if (debug) { MS_DBG(F("was off.")); }
             // Reset time of power on, in-case it was set to a value
             _millisPowerOn = 0;
@@ -447,12 +1127,10 @@ bool Sensor::isWarmedUp(bool debug) {
 
 // This delays until enough time has passed for the sensor to "warm up" - that
 // is - to be ready to communicate and to be asked to take readings
-// NOTE:  This is "blocking" - that is, nothing else can happen during this
-// wait.
+// NOTE:  This is "blocking" - that is, nothing else but the wait function can
+// happen during this wait.  The processor idles between checks.
 void Sensor::waitForWarmUp(void) {
-    while (!isWarmedUp()) {
-        // wait
-    }
+    while (!isWarmedUp()) { idleProcessor(1); }
 }
 
 
@@ -485,12 +1163,10 @@ bool Sensor::isStable(bool debug) {
 
 // This delays until enough time has passed for the sensor to stabilize before
 // taking readings
-// NOTE:  This is "blocking" - that is, nothing else can happen during this
-// wait.
+// NOTE:  This is "blocking" - that is, nothing else but the wait function can
+// happen during this wait.  The processor idles between checks.
 void Sensor::waitForStability(void) {
-    while (!isStable()) {
-        // wait
-    }
+    while (!isStable()) { idleProcessor(1); }
 }
 
 
@@ -524,10 +1200,104 @@ bool Sensor::isMeasurementComplete(bool debug) {
 }
 
 // This delays until enough time has passed for the sensor to give a new value
-// NOTE:  This is "blocking" - that is, nothing else can happen during this
-// wait.
+// NOTE:  This is "blocking" - that is, nothing else but the wait function can
+// happen during this wait.  The processor idles between checks.
 void Sensor::waitForMeasurementCompletion(void) {
-    while (!isMeasurementComplete()) {
-        // wait
+    while (!isMeasurementComplete()) { idleProcessor(1); }
+}
+
+
+// This returns the time remaining until the sensor is warmed up.  The checks
+// exactly mirror those in isWarmedUp() so the two will always agree.
+uint32_t Sensor::getWarmUpTimeRemaining(void) {
+    if (!bitRead(_sensorStatus, 2)) { return 0; }
+    uint32_t elapsed_since_power_on = millis() - _millisPowerOn;
+    if (elapsed_since_power_on > _warmUpTime_ms) { return 0; }
+    return _warmUpTime_ms - elapsed_since_power_on + 1;
+}
+
+
+// This returns the time remaining until the sensor is stable.  The checks
+// exactly mirror those in isStable() so the two will always agree.
+uint32_t Sensor::getStabilizationTimeRemaining(void) {
+    if (!bitRead(_sensorStatus, 4)) { return 0; }
+    uint32_t elapsed_since_wake_up = millis() - _millisSensorActivated;
+    if (elapsed_since_wake_up > _stabilizationTime_ms) { return 0; }
+    return _stabilizationTime_ms - elapsed_since_wake_up + 1;
+}
+
+
+// This returns the time until a new measurement may start, so that its result
+// comes at least the minimum interval after the last one
+uint32_t Sensor::getIntervalTimeRemaining(void) {
+    if (_minMeasurementInterval_ms == 0 || _millisLastResult == 0) {
+        return 0;
+    }
+    if (_minMeasurementInterval_ms <= _measurementTime_ms) { return 0; }
+    uint32_t wait    = _minMeasurementInterval_ms - _measurementTime_ms;
+    uint32_t elapsed = millis() - _millisLastResult;
+    if (elapsed >= wait) { return 0; }
+    return wait - elapsed;
+}
+
+
+// This delays until a new measurement may start
+void Sensor::waitForMeasurementInterval(void) {
+    uint32_t remaining;
+    while ((remaining = getIntervalTimeRemaining()) > 0) {
+        idleProcessor(remaining);
+    }
+}
+
+
+// This returns the time remaining until the measurement is complete.  The
+// checks exactly mirror those in isMeasurementComplete() so the two will always
+// agree.
+uint32_t Sensor::getMeasurementTimeRemaining(void) {
+    if (!bitRead(_sensorStatus, 6)) { return 0; }
+    uint32_t elapsed_since_meas_start = millis() - _millisMeasurementRequested;
+    if (elapsed_since_meas_start > _measurementTime_ms) { return 0; }
+    return _measurementTime_ms - elapsed_since_meas_start + 1;
+}
+
+
+// This sets the function to call while waiting on a sensor
+void Sensor::setWaitCallback(void (*waitCallback)(void)) {
+    _waitCallback = waitCallback;
+}
+
+
+// This checks if a function to call while waiting has been set
+bool Sensor::hasWaitCallback(void) {
+    return _waitCallback != nullptr;
+}
+
+
+// This idles the processor until the given time has passed.  In idle mode
+// the clocks for the timers, serial ports, and I2C all keep running and any
+// interrupt - including the millis() timer tick - wakes the processor.  We run
+// the wait function and go back to idle after each wake until the full time
+// has passed.
+void Sensor::idleProcessor(uint32_t idleTime_ms) {
+    uint32_t start = millis();
+    while (millis() - start < idleTime_ms) {
+        if (_waitCallback != nullptr) { _waitCallback(); }
+        // Move any queued I2C transactions along
+        I2CBus::serviceAll();
+#if defined(MS_CONSOLE_BUFFER_SIZE) && defined(STANDARD_SERIAL_OUTPUT)
+        // Let the serial port's interrupt send more of the printouts
+        msConsole.drain();
+#endif
+#if defined(ARDUINO_ARCH_AVR) || defined(__AVR__)
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+#elif defined(ARDUINO_ARCH_SAMD)
+        // Make sure we're only going to lightest sleep; the deep sleep bit is
+        // left set after the logger's full system sleep.  SysTick will wake
+        // the processor every millisecond.
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        __DSB();
+        __WFI();
+#endif
     }
 }
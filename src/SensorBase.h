@@ -34,12 +34,68 @@
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 #include <pins_arduino.h>
+#include "BurstStatistics.h"
+#include "PowerRail.h"
+#include "I2CBus.h"
+#include "FastPin.h"
 
 /**
  * @brief The largest number of variables from a single sensor
+ *
+ * @note The result arrays of each sensor are sized to the number of values
+ * that sensor actually returns when it is constructed; this is only an upper
+ * bound.
  */
 #define MAX_NUMBER_VARS 8
 
+#ifndef SENSOR_BURST_DEFAULT_RATE_HZ
+/**
+ * @brief The default sampling rate of a burst, in samples per second.
+ */
+#define SENSOR_BURST_DEFAULT_RATE_HZ 100
+#endif
+
+#ifndef MS_TIMING_MARGIN_PERCENT
+/**
+ * @brief The margin added to each time measured by Sensor::calibrateTiming(),
+ * in percent.
+ */
+#define MS_TIMING_MARGIN_PERCENT 25
+#endif
+
+#ifndef MS_TIMING_POLL_MS
+/**
+ * @brief The time between tries to wake a sensor while its warm-up is
+ * measured by Sensor::calibrateTiming(), in milliseconds.
+ */
+#define MS_TIMING_POLL_MS 50
+#endif
+
+#ifndef MS_TIMING_SETTLE_FRACTION
+/**
+ * @brief The largest change between readings, as a fraction of the reading,
+ * for Sensor::calibrateTiming() to count the sensor as stable.
+ */
+#define MS_TIMING_SETTLE_FRACTION 0.01
+#endif
+
+#ifndef MS_TIMING_SETTLE_READINGS
+/**
+ * @brief The readings in a row that must stay within
+ * #MS_TIMING_SETTLE_FRACTION of each other, and the good results in a row
+ * needed at the shortest measurement time, in Sensor::calibrateTiming().
+ */
+#define MS_TIMING_SETTLE_READINGS 3
+#endif
+
+#if defined(MS_NO_STRING) && !defined(MS_SENSOR_LABEL_SIZE)
+/**
+ * @brief The size of the buffer each sensor keeps its name and location in,
+ * with the build flag `MS_NO_STRING`.  Longer text is cut short.
+ */
+#define MS_SENSOR_LABEL_SIZE 40
+#endif
+
 
 class Variable;  // Forward declaration
 
@@ -126,6 +182,28 @@ class Sensor {
      * @return **String** Text describing how the sensor is attached to the mcu.
      */
     virtual String getSensorLocation(void);
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Get the name of the sensor.
+     *
+     * @return **const char\*** The sensor name as given in the constructor.
+     */
+    virtual const char* getSensorName(void);
+    /**
+     * @brief Get the name and location of the sensor, without making a
+     * String.
+     *
+     * The text is made once, when the sensor is set up or first asked for
+     * it, and kept in a buffer of #MS_SENSOR_LABEL_SIZE.
+     *
+     * @note Only available with the build flag `MS_NO_STRING`; otherwise
+     * this returns a String.
+     *
+     * @return **const char\*** A concatenation of the sensor name and its
+     * "location" - how it is connected to the mcu.
+     */
+    const char* getSensorNameAndLocation(void);
+#else
     /**
      * @brief Get the name of the sensor.
      *
@@ -139,12 +217,150 @@ class Sensor {
      * - how it is connected to the mcu.
      */
     String getSensorNameAndLocation(void);
+#endif
+    /**
+     * @brief Print the name of the sensor, as given in the constructor,
+     * without making a String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printSensorName(Print& out) {
+        return out.print(_sensorName);
+    }
     /**
      * @brief Get the pin number controlling sensor power.
      *
      * @return **int8_t** The pin on the mcu controlling power to the sensor.
      */
     virtual int8_t getPowerPin(void);
+    /**
+     * @brief Power the sensor from a rail shared with other sensors, instead
+     * of switching its power pin itself.
+     *
+     * The sensor's power pin becomes the rail's pin.  The rail is switched on
+     * with the first of its sensors to power up and off with the last to
+     * power down, and each sensor's warm-up counts from when the rail came
+     * on.  See PowerRail.
+     *
+     * @param rail The rail; nullptr to go back to switching the power pin
+     * given in the constructor
+     */
+    void setPowerRail(PowerRail* rail);
+    /**
+     * @brief Get the rail powering the sensor.
+     *
+     * @return **PowerRail*** The rail; nullptr if the sensor switches its own
+     * power pin
+     */
+    PowerRail* getPowerRail(void) {
+        return _powerRail;
+    }
+    /**
+     * @brief Attach the sensor to the I2C bus it was constructed with, so the
+     * bus is at its own clock speed for each of the sensor's measurements.
+     * See I2CBus.
+     *
+     * @param bus The bus; nullptr if the sensor isn't on a registered bus
+     */
+    void setI2CBus(I2CBus* bus) {
+        _i2cBus = bus;
+    }
+    /**
+     * @brief Get the I2C bus the sensor is attached to.
+     *
+     * @return **I2CBus*** The bus; nullptr if it isn't attached to one
+     */
+    I2CBus* getI2CBus(void) {
+        return _i2cBus;
+    }
+    /**
+     * @brief Set the clock of the sensor's I2C bus again, if it is attached
+     * to one.
+     *
+     * The VariableArray calls this before starting a measurement and before
+     * collecting its result, since sensor libraries often reset the clock in
+     * `begin()`.
+     */
+    void applyI2CClock(void) {
+        if (_i2cBus != nullptr) _i2cBus->applyClock();
+    }
+    /**
+     * @brief Get the time the sensor needs after power is applied before it
+     * can be woken.
+     *
+     * @return **uint32_t** The warm-up time in milliseconds
+     */
+    uint32_t getWarmUpTime(void) {
+        return _warmUpTime_ms;
+    }
+    /**
+     * @brief Get the time the sensor needs after waking before it gives
+     * stable values.
+     *
+     * @return **uint32_t** The stabilization time in milliseconds
+     */
+    uint32_t getStabilizationTime(void) {
+        return _stabilizationTime_ms;
+    }
+    /**
+     * @brief Get the time the sensor needs after a measurement is started
+     * before its result can be collected.
+     *
+     * @return **uint32_t** The measurement time in milliseconds
+     */
+    uint32_t getMeasurementTime(void) {
+        return _measurementTime_ms;
+    }
+    /**
+     * @brief Set the warm-up, stabilization and measurement times, in place of
+     * the ones the sensor's constructor took from its datasheet.
+     *
+     * The Logger sets the times of the sensors from the `timing.<code>`
+     * settings, like those saved by Logger::calibrateSensorTiming().
+     *
+     * @param warmUpTime_ms The warm-up time in milliseconds
+     * @param stabilizationTime_ms The stabilization time in milliseconds
+     * @param measurementTime_ms The measurement time in milliseconds
+     */
+    void setTiming(uint32_t warmUpTime_ms, uint32_t stabilizationTime_ms,
+                   uint32_t measurementTime_ms);
+    /**
+     * @brief Measure the warm-up, stabilization and measurement times of this
+     * unit of the sensor, and use them from now on.
+     *
+     * The times given by each sensor's constructor come from its datasheet,
+     * and most units are ready well before them.  This powers the sensor up
+     * from off and measures, in turn:
+     * - the warm-up, as the time until the first wake() that succeeds, tried
+     * every #MS_TIMING_POLL_MS
+     * - the stabilization, as the time from waking to the first of
+     * #MS_TIMING_SETTLE_READINGS readings in a row that stay within
+     * #MS_TIMING_SETTLE_FRACTION of each other, each taken with the full
+     * measurement time
+     * - the measurement time, as the shortest of eighths of the full time
+     * that gives good results #MS_TIMING_SETTLE_READINGS times in a row
+     *
+     * Each time measured is then lengthened by the margin, but never past the
+     * time it replaces, and a step that can't be measured keeps its old time.
+     * The sensor is put to sleep and powered down afterwards.  This takes a
+     * few times as long as an update of the sensor; run it with the sensor
+     * set up and in its usual surroundings, not in the logging loop.
+     *
+     * @note A sensor that answers a result request early with its last
+     * result, instead of failing, can't be told from one that has finished,
+     * like some I2C sensors that hand back their last conversion.  Leave the
+     * measurement time of those sensors alone.
+     *
+     * @param marginPercent The margin added to each time measured, in
+     * percent; optional with a default of #MS_TIMING_MARGIN_PERCENT
+     * @param probeMeasurement False to keep the measurement time; optional
+     * with a default of true
+     * @return **bool** True if the sensor woke and gave good results to
+     * measure its times with
+     */
+    bool calibrateTiming(uint8_t marginPercent   = MS_TIMING_MARGIN_PERCENT,
+                         bool    probeMeasurement = true);
 
     /**
      * @brief Set the number measurements to average.
@@ -164,6 +380,302 @@ class Sensor {
      * @copydetails _measurementsToAverage
      */
     uint8_t getNumberMeasurementsToAverage(void);
+    /**
+     * @brief Get the RAM taken by the sensor: its base object and the result
+     * arrays allocated for its values.
+     *
+     * Members added by a particular sensor's subclass are not counted.
+     *
+     * @return **uint16_t** The RAM in bytes
+     */
+    uint16_t getResultBytes(void);
+
+    /**
+     * @brief Enable adaptive averaging, where the sensor stops taking readings
+     * as soon as the average of one of its results has settled.
+     *
+     * After each reading, the standard error of the mean of the chosen result
+     * is checked against the threshold.  Once it is at or below the threshold
+     * no more readings are taken for this update.  The number of measurements
+     * to average becomes the maximum number of readings.
+     *
+     * @param maxStandardError The largest acceptable standard error of the
+     * mean, in the units of the result.  Use 0 to disable adaptive averaging.
+     * @param resultNumber The position of the result to check within the
+     * result array.  Optional with a default value of 0.
+     * @param minMeasurements The smallest number of good readings to take
+     * before checking the standard error.  Optional with a default value of 3;
+     * values less than 2 are treated as 2.
+     */
+    void setAdaptiveAveraging(float maxStandardError, uint8_t resultNumber = 0,
+                              uint8_t minMeasurements = 3);
+    /**
+     * @brief Get the standard error threshold for adaptive averaging.
+     *
+     * @return **float** The largest acceptable standard error of the mean; 0
+     * if adaptive averaging is disabled.
+     */
+    float getAdaptiveStandardError(void);
+    /**
+     * @brief Check whether adaptive averaging is enabled and the average of
+     * the chosen result has settled enough that no more readings are needed.
+     *
+     * @return **bool** True if no more readings are needed in this update.
+     */
+    bool isAveragingConverged(void);
+
+    /**
+     * @brief Enable burst sampling, where each measurement is a fast run of
+     * raw samples reduced to a few statistics on the fly.
+     *
+     * @copydetails _burstSamples
+     *
+     * @param nSamples The number of samples in each burst.  Use 0 to disable
+     * burst sampling.
+     * @param sampleRate_Hz The rate to take the samples at, in samples per
+     * second.  Default is #SENSOR_BURST_DEFAULT_RATE_HZ.  If a sample takes
+     * longer than the interval, the next is taken right away.
+     * @param percentile The percentile to calculate alongside the median,
+     * between 0 and 100.  Default is 90.
+     */
+    void setBurstMode(uint16_t nSamples,
+                      uint16_t sampleRate_Hz = SENSOR_BURST_DEFAULT_RATE_HZ,
+                      float    percentile    = 90);
+    /**
+     * @brief Get the number of samples in each burst.
+     *
+     * @return **uint16_t** The number of samples; 0 if burst sampling is
+     * disabled.
+     */
+    uint16_t getBurstSamples(void);
+
+    /**
+     * @brief Set how often the sensor should be measured relative to the
+     * updates of the variable array it is in.
+     *
+     * @copydetails _updateInterval
+     *
+     * @param updateInterval The sensor will be measured on the first of every
+     * this many variable array updates.  Use 1 (the default) to measure the
+     * sensor on every update.
+     * @param markSkippedValues True to set the sensor's values to -9999 on the
+     * updates when it is not measured; false (the default) to keep reporting
+     * the values from the last time it was measured.
+     */
+    void setUpdateInterval(uint8_t updateInterval,
+                           bool    markSkippedValues = false);
+    /**
+     * @brief Get how often the sensor is measured relative to the updates of
+     * the variable array it is in.
+     *
+     * @return **uint8_t** The number of variable array updates between
+     * measurements of the sensor.
+     */
+    uint8_t getUpdateInterval(void);
+    /**
+     * @brief Check whether the sensor should be measured in this update of the
+     * variable array and count down to the next update.
+     *
+     * This should only be called once per variable array update.
+     *
+     * @return **bool** True if the sensor should be measured in this update.
+     */
+    bool checkUpdateDue(void);
+    /**
+     * @brief Check whether the sensor will be measured in the next update of
+     * the variable array, without counting down to it.
+     *
+     * @return **bool** True if the next call to checkUpdateDue() will return
+     * true
+     */
+    bool isUpdateDueNext(void) {
+        return !_suspended && _failureSkipsLeft == 0 && _updatesUntilDue == 0;
+    }
+    /**
+     * @brief Get whether the sensor's values should be set to -9999 on the
+     * updates when it is not measured.
+     *
+     * @return **bool** True if the values of skipped updates are marked
+     */
+    bool getMarkSkippedValues(void);
+    /**
+     * @brief Suspend or resume measuring the sensor.
+     *
+     * A suspended sensor is not powered, woken, or measured in any update of
+     * the variable array, and its values are set to -9999.  The Logger uses
+     * this to shed power-hungry sensors when the battery is low.
+     *
+     * @param suspended True to suspend the sensor; false to resume it
+     */
+    void setSuspended(bool suspended);
+    /**
+     * @brief Check whether the sensor is suspended.
+     *
+     * @return **bool** True if the sensor is suspended
+     */
+    bool isSuspended(void);
+    /**
+     * @brief Set whether the sensor's setup can wait for its first update.
+     *
+     * A deferred sensor is skipped by VariableArray::setupSensors() and set up
+     * in its first complete update instead, once it is powered and warmed up
+     * for that update anyway.  Only defer sensors whose setup doesn't need to
+     * be seen at boot.  No sensor is deferred until this is called.
+     *
+     * @param deferSetup True to set the sensor up in its first update
+     */
+    void setDeferredSetup(bool deferSetup = true);
+    /**
+     * @brief Check whether the sensor's setup waits for its first update.
+     *
+     * @return **bool** True if the setup is deferred
+     */
+    bool getDeferredSetup(void);
+    /**
+     * @brief Set whether the sensor is critical to the logged record.
+     *
+     * When a complete update runs short of time, sensors that aren't critical
+     * are dropped before those that are.  Every sensor is critical until this
+     * is called.
+     *
+     * @param critical False to let the sensor be dropped first
+     */
+    void setCritical(bool critical);
+    /**
+     * @brief Check whether the sensor is critical to the logged record.
+     *
+     * @return **bool** True if the sensor is critical
+     */
+    bool isCritical(void);
+    /**
+     * @brief Set the currents that decide whether the sensor is kept powered
+     * between complete updates.
+     *
+     * Some sensors take more energy to warm up again than to sit powered,
+     * asleep, until their next update, at least at short logging intervals.
+     * Once these are set, each complete update compares the charge the sensor
+     * would draw idling until its next update with the charge of warming it
+     * up again, and leaves it powered when that's cheaper.  Its next update
+     * then needs no warm-up.  Sensors sharing a power pin are only kept
+     * powered if it's cheaper for every one of them.  Every sensor is powered
+     * down after its update until this is called.
+     *
+     * @param idleCurrent_mA The current the sensor draws powered but asleep,
+     * in milliamps
+     * @param warmUpCurrent_mA The current the sensor draws while it warms up,
+     * in milliamps; 0 to always power it down
+     */
+    void setPowerCosts(float idleCurrent_mA, float warmUpCurrent_mA);
+    /**
+     * @brief Check whether keeping the sensor powered until its next update
+     * costs less than powering it down and warming it up again.
+     *
+     * A sensor is never kept powered without the currents of setPowerCosts(),
+     * or if it got no good result in this update, so that a failing sensor is
+     * still power cycled.
+     *
+     * @param updatePeriod_ms The time between updates of the variable array,
+     * in milliseconds
+     * @return **bool** True if the sensor should be kept powered
+     */
+    bool isKeepingPowerCheaper(uint32_t updatePeriod_ms);
+
+    /**
+     * @brief Set up skipping the sensor after it fails repeatedly.
+     *
+     * An update fails when none of the sensor's results are good, most often
+     * because the sensor didn't wake or answer.  After the given number of
+     * failures in a row the sensor is skipped - not powered, woken, or
+     * measured - for a number of updates that doubles with each further
+     * failure, up to the maximum.  Its values are -9999 while it's skipped.
+     * It's then tried again, and the first good update resets the count.  This
+     * is off until this is called.
+     *
+     * @param failuresToSkip The number of failures in a row before the sensor
+     * is skipped; 0 to never skip it.  Default is 3.
+     * @param maxSkipUpdates The most updates to skip between tries.  Default
+     * is 64.
+     */
+    void setFailureBackoff(uint8_t  failuresToSkip = 3,
+                           uint16_t maxSkipUpdates = 64);
+    /**
+     * @brief Get the number of updates in a row that the sensor has failed.
+     *
+     * @return **uint8_t** The number of failures in a row; 0 if the last
+     * update was good
+     */
+    uint8_t getConsecutiveFailures(void);
+    /**
+     * @brief Check whether the sensor was skipped in the last update because
+     * of repeated failures.
+     *
+     * @return **bool** True if the sensor is backing off
+     */
+    bool isBackingOff(void);
+    /**
+     * @brief Get the number of updates left to skip before the failing
+     * sensor is tried again.
+     *
+     * @return **uint16_t** The number of updates left to skip
+     */
+    uint16_t getFailureSkipsLeft(void);
+    /**
+     * @brief Restore the failure count and skips saved before a reset.
+     *
+     * @param failures The number of failures in a row
+     * @param skipsLeft The number of updates left to skip
+     */
+    void restoreFailureState(uint8_t failures, uint16_t skipsLeft);
+    /**
+     * @brief Count the result of an update toward the failure backoff.
+     *
+     * This is called once at the end of each update, after the results are
+     * averaged.
+     */
+    void recordUpdateResult(void);
+
+    /**
+     * @brief Let the sensor's last result stand in for a new update for up
+     * to the given age.
+     *
+     * When more than one logger or variable array shares the sensor, an
+     * update that finds a good result from within this age uses it instead
+     * of powering, waking, and measuring the sensor again, so the sensor is
+     * measured only once for loggers that fire together.  A result never
+     * outlasts the processor sleeping; see expireAllResults().  Results are
+     * not shared until this is called.
+     *
+     * @param maxAge_ms The oldest result to use, in milliseconds; 0 to
+     * always measure again.
+     */
+    void setResultMaxAge(uint32_t maxAge_ms);
+    /**
+     * @brief Check whether the sensor has a good result young enough to use
+     * instead of updating it again.
+     *
+     * @return **bool** True if the last result can be used
+     */
+    bool hasFreshResult(void);
+    /**
+     * @brief Get the time of the record the last good result was measured
+     * for.
+     *
+     * The values a skipped or shared update leaves standing keep this time,
+     * so Variable::isValueStale() can tell them from new ones.
+     *
+     * @return **uint32_t** The UTC epoch time, from
+     * Logger::markedUTCEpochTime; 0 if there hasn't been a good result
+     */
+    uint32_t getResultTime(void) {
+        return _resultTime;
+    }
+    /**
+     * @brief Mark the results of every sensor as too old to share.
+     *
+     * millis() may stop while the processor sleeps, so the Logger calls this
+     * each time it wakes.
+     */
+    static void expireAllResults(void);
 
     /**
      * @brief Get the 8-bit code for the current status of the sensor.
@@ -320,8 +832,10 @@ class Sensor {
 
     /**
      * @brief The array of result values for each sensor.
+     *
+     * This has one entry for each of the #_numReturnedValues.
      */
-    float sensorValues[MAX_NUMBER_VARS];
+    float* sensorValues = nullptr;
 
     /**
      * @brief Clear the values array - that is, sets all values to -9999.
@@ -345,17 +859,173 @@ class Sensor {
     void verifyAndAddMeasurementResult(uint8_t resultNumber,
                                        int16_t resultValue);
     /**
-     * @brief Average the results of all measurements by dividing the sum of
-     * all measurements by the number of measurements taken.
+     * @brief Verify that a measurement is OK (ie, not -9999) before adding it
+     * to the result array
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @param resultValue The value of the result.
      */
     void verifyAndAddMeasurementResult(uint8_t resultNumber,
                                        int32_t resultValue);
+    /**
+     * @brief Verify that a measurement given as a scaled whole number is OK
+     * (ie, not -9999) before adding it to the result array
+     *
+     * This is for raw readings that are really fixed-point, like a register
+     * in hundredths of a degree.  With the build flag
+     * `MS_SENSOR_FIXED_POINT`, these are summed as whole numbers and only
+     * turned into a float once, when they are averaged; the float math of
+     * each measurement is skipped.  Results that need their running spread,
+     * with `MS_SENSOR_STATISTICS` or for adaptive averaging, are still summed
+     * as floats, as are those whose sum would overflow.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @param resultValue The value of the result, in units of
+     * 10^-decimals; -9999 for a failed result.
+     * @param decimals The number of decimal places in the value, 0 to 6.  It
+     * should be the same for every measurement of a result.
+     */
+    void verifyAndAddMeasurementResult(uint8_t resultNumber,
+                                       int32_t resultValue, uint8_t decimals);
     /**
      * @brief Average the results of all measurements by dividing the sum of
      * all measurements by the number of measurements taken.
      */
     void averageMeasurements(void);
 
+    /**
+     * @brief Take a single raw sample for a burst.
+     *
+     * Sensors supporting burst sampling override this with the fastest read
+     * they can make, without any of the waits of a full measurement.  It is
+     * only called by takeBurst(), after the measurement has been started.
+     *
+     * @return **float** The raw sample; -9999 if it failed.  The default
+     * implementation always fails.
+     */
+    virtual float readBurstSample(void);
+    /**
+     * @brief Take a burst of samples with readBurstSample() at the configured
+     * rate and reduce them.
+     *
+     * @param stats The statistics to add the samples to.  They are reset
+     * to the configured percentile first.
+     * @return **bool** True if any good samples were taken.
+     */
+    bool takeBurst(BurstStatistics& stats);
+    /**
+     * @brief Add one of the statistics of a burst to the result array.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @param stats The statistics of the burst
+     * @param statistic The statistic to add
+     */
+    void addBurstResult(uint8_t resultNumber, BurstStatistics& stats,
+                        burstStatistic statistic);
+
+#if defined(MS_SENSOR_STATISTICS)
+    /**
+     * @brief Get the sample standard deviation of the measurements averaged
+     * for a result in the last update.
+     *
+     * The statistics are accumulated one reading at a time as they are added to
+     * the result array (Welford's method), so no raw readings are kept.  These
+     * are only available when the library is built with
+     * `MS_SENSOR_STATISTICS` defined.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The standard deviation; -9999 if fewer than two good
+     * measurements were made.
+     */
+    float getResultStdDev(uint8_t resultNumber);
+    /**
+     * @brief Get the smallest of the measurements averaged for a result in the
+     * last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The minimum; -9999 if no good measurements were made.
+     */
+    float getResultMin(uint8_t resultNumber);
+    /**
+     * @brief Get the largest of the measurements averaged for a result in the
+     * last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **float** The maximum; -9999 if no good measurements were made.
+     */
+    float getResultMax(uint8_t resultNumber);
+    /**
+     * @brief Get the number of good measurements averaged for a result in the
+     * last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return **uint8_t** The number of good measurements
+     */
+    uint8_t getResultCount(uint8_t resultNumber);
+#endif
+
+    /**
+     * @brief Get the time between powering the sensor and successfully waking
+     * it in the last update.
+     *
+     * This is the actual elapsed time, which may be longer than the warm-up
+     * time if the sensor was waiting on others.  Comparing it over many
+     * updates shows whether the warm-up time can be tuned.
+     *
+     * @return **uint32_t** The elapsed time in milliseconds
+     */
+    uint32_t getLastWarmUpTime(void);
+    /**
+     * @brief Get the time between successfully waking the sensor and starting
+     * the first measurement in the last update.
+     *
+     * @return **uint32_t** The elapsed time in milliseconds
+     */
+    uint32_t getLastStabilizationTime(void);
+    /**
+     * @brief Get the time between requesting the last measurement and
+     * collecting its result.
+     *
+     * @return **uint32_t** The elapsed time in milliseconds
+     */
+    uint32_t getLastMeasurementTime(void);
+    /**
+     * @brief Get when the measurements of the last update were taken.
+     *
+     * Each measurement is taken to be at the middle of the time from its
+     * request to its result, and the time given is the mean of those of all
+     * of the update's measurements, so it matches the averaged values.
+     *
+     * @return **uint32_t** The processor elapsed time (millis()) at the
+     * middle of the measurements; 0 if none were taken
+     */
+    uint32_t getMeasurementMillis(void) {
+        return _midpointCount > 0 ? _millisMeasurementMid : 0;
+    }
+    /**
+     * @brief Record the time since the current measurement was requested,
+     * and the time of the result for the minimum measurement interval.
+     *
+     * This is called just before the result of a measurement is collected.
+     * It also adds the middle of the measurement to the mean given by
+     * getMeasurementMillis().
+     */
+    void markMeasurementTime(void);
+
+    /**
+     * @brief Register a variable reporting a statistic or timing of the
+     * sensor's results.
+     *
+     * Statistic variables are kept in a list separate from the main variable
+     * array so they don't take the place of the variable reporting the value
+     * itself.
+     *
+     * @param var A pointer to the statistic Variable object.
+     * @return **Variable\*** The statistic variable previously at the head of
+     * the list, which the new variable must notify after itself.
+     */
+    Variable* registerStatisticVariable(Variable* var);
+
     /**
      * @brief Register a variable object to a sensor.
      *
@@ -436,6 +1106,117 @@ class Sensor {
      */
     void waitForMeasurementCompletion(void);
 
+    /**
+     * @brief Get the number of milliseconds remaining before the sensor should
+     * be warmed up.
+     *
+     * This is the time remaining before isWarmedUp() is expected to return
+     * true.  It is used by the VariableArray to decide how long the processor
+     * can idle before any sensor needs attention.
+     *
+     * @return **uint32_t** The number of milliseconds remaining in the warm-up
+     * period; 0 if the sensor is already warmed up or cannot warm up.
+     */
+    virtual uint32_t getWarmUpTimeRemaining(void);
+    /**
+     * @brief Get the number of milliseconds remaining before the sensor should
+     * be stable.
+     *
+     * This is the time remaining before isStable() is expected to return true.
+     *
+     * @return **uint32_t** The number of milliseconds remaining in the
+     * stabilization period; 0 if the sensor is already stable or cannot
+     * stabilize.
+     */
+    virtual uint32_t getStabilizationTimeRemaining(void);
+    /**
+     * @brief Get the number of milliseconds remaining before the current
+     * measurement should be complete.
+     *
+     * This is the time remaining before isMeasurementComplete() is expected to
+     * return true.
+     *
+     * @return **uint32_t** The number of milliseconds remaining in the
+     * measurement; 0 if the measurement should already be complete or no
+     * measurement was successfully started.
+     */
+    virtual uint32_t getMeasurementTimeRemaining(void);
+
+    /**
+     * @brief Set the shortest time the sensor needs between the results of
+     * two measurements.
+     *
+     * Some sensors, like the AOSong AM2315 and DHT, return stale or failed
+     * values if they are read again too soon.  With an interval set, no new
+     * measurement is started until its result would come at least this long
+     * after the last one.  The VariableArray works on the other sensors in the
+     * meantime.
+     *
+     * @param minInterval_ms The shortest time between results in
+     * milliseconds; 0 for no limit.
+     */
+    void setMinMeasurementInterval(uint32_t minInterval_ms) {
+        _minMeasurementInterval_ms = minInterval_ms;
+    }
+    /**
+     * @brief Get the shortest time the sensor needs between the results of
+     * two measurements.
+     *
+     * @return **uint32_t** The shortest time between results in milliseconds;
+     * 0 for no limit.
+     */
+    uint32_t getMinMeasurementInterval(void) {
+        return _minMeasurementInterval_ms;
+    }
+    /**
+     * @brief Get the number of milliseconds remaining before a new measurement
+     * may be started.
+     *
+     * A measurement may start once the last result plus the minimum interval
+     * is no more than the measurement time away.
+     *
+     * @return **uint32_t** The number of milliseconds remaining before a
+     * measurement may be started; 0 if one may be started now.
+     */
+    uint32_t getIntervalTimeRemaining(void);
+    /**
+     * @brief Hold all further program execution until a new measurement may
+     * be started.
+     */
+    void waitForMeasurementInterval(void);
+
+    /**
+     * @brief Set a function to be called each time the processor wakes while
+     * waiting on a sensor.
+     *
+     * While waiting, the processor is put into idle mode and woken by the next
+     * interrupt (on most boards, the millis() timer tick - about once a
+     * millisecond).  The wait function is called on each of those wakes, so it
+     * must be short.  The Logger uses this to reset the watchdog during long
+     * waits unless a different function has already been set.
+     *
+     * @param waitCallback A function to call while waiting; nullptr to clear
+     * the function.
+     */
+    static void setWaitCallback(void (*waitCallback)(void));
+    /**
+     * @brief Check whether a wait function has been set.
+     *
+     * @return **bool** True if a wait function has been set
+     */
+    static bool hasWaitCallback(void);
+    /**
+     * @brief Put the processor into its lightest sleep (idle) mode until the
+     * given time has passed, running the wait function on each wake.
+     *
+     * Timers, serial ports, I2C, and all interrupts remain active during idle,
+     * so millis() keeps counting and no communication with the sensors is
+     * lost.  On boards without a known idle mode this is a simple wait.
+     *
+     * @param idleTime_ms The time in milliseconds to idle.
+     */
+    static void idleProcessor(uint32_t idleTime_ms);
+
 
  protected:
     /**
@@ -450,10 +1231,38 @@ class Sensor {
      * @note SIGNED int, to allow negative numbers for unused pins
      */
     int8_t _powerPin;
+    /**
+     * @brief The power pin given in the constructor, used again if the sensor
+     * is taken off a rail
+     */
+    int8_t _ownPowerPin;
+    /**
+     * @brief The rail powering the sensor; nullptr if it switches its own
+     * power pin
+     */
+    PowerRail* _powerRail = nullptr;
+    /**
+     * @brief True while the sensor is holding its rail on
+     */
+    bool _railHeld = false;
+    /**
+     * @brief The I2C bus the sensor is attached to; nullptr if none
+     */
+    I2CBus* _i2cBus = nullptr;
+    /**
+     * @brief The port register and bit mask of the power pin
+     */
+    FastPin _powerIO;
     /**
      * @brief The sensor name.
      */
     const char* _sensorName;
+#if defined(MS_NO_STRING)
+    /**
+     * @brief The name and location of the sensor, made once.
+     */
+    char _sensorLabel[MS_SENSOR_LABEL_SIZE] = "";
+#endif
     /**
      * @brief The number of values the sensor is capable of reporting.
      *
@@ -472,6 +1281,143 @@ class Sensor {
      * requested.
      */
     uint8_t _measurementsToAverage;
+    /**
+     * @brief The largest acceptable standard error for adaptive averaging; 0
+     * when adaptive averaging is disabled.
+     */
+    float _adaptiveMaxStdError = 0;
+    /**
+     * @brief The running sum of squared differences from the mean of the
+     * result checked for adaptive averaging.
+     */
+    float _adaptiveM2 = 0;
+    /**
+     * @brief The position of the result checked for adaptive averaging.
+     */
+    uint8_t _adaptiveResultNumber = 0;
+    /**
+     * @brief The smallest number of good readings before the adaptive
+     * averaging check is made.
+     */
+    uint8_t _adaptiveMinMeasurements = 3;
+    /**
+     * @brief The number of raw samples in each burst; 0 when burst sampling is
+     * disabled.
+     *
+     * In a burst, each measurement is a tight loop of samples taken at a set
+     * rate.  The samples are reduced as they are taken to their mean, median,
+     * minimum, maximum, standard deviation and one percentile, so none of them
+     * are kept in memory.  A sensor supporting bursts overrides
+     * readBurstSample() and, from its addSingleMeasurementResult(), calls
+     * takeBurst() and puts the statistics it reports into its result slots
+     * with addBurstResult().  Sensors without a burst override ignore this.
+     */
+    uint16_t _burstSamples = 0;
+    /**
+     * @brief The time between the starts of samples in a burst, in
+     * microseconds.
+     */
+    uint32_t _burstInterval_us = 1000000UL / SENSOR_BURST_DEFAULT_RATE_HZ;
+    /**
+     * @brief The percentile calculated in a burst, between 0 and 100.
+     */
+    float _burstPercentile = 90;
+    /**
+     * @brief The number of variable array updates between measurements of the
+     * sensor.
+     *
+     * This allows sensors that change slowly or use a lot of power to be
+     * measured less often than the others attached to the same logger.  For
+     * example, with a 5 minute logging interval, an update interval of 12
+     * measures the sensor once an hour.  On the updates when it is not
+     * measured, the sensor is not powered or woken at all.
+     */
+    uint8_t _updateInterval = 1;
+    /**
+     * @brief The number of variable array updates left before the sensor
+     * should be measured again.
+     */
+    uint8_t _updatesUntilDue = 0;
+    /**
+     * @brief True to mark the sensor's values as -9999 on skipped updates.
+     */
+    bool _markSkippedValues = false;
+    /**
+     * @brief True while the sensor is suspended and skipped in every update.
+     */
+    bool _suspended = false;
+    /**
+     * @brief True if the sensor is kept when an update runs short of time.
+     */
+    bool _critical = true;
+    /**
+     * @brief The current the sensor draws powered but asleep, in milliamps
+     */
+    float _idleCurrent_mA = 0;
+    /**
+     * @brief The current the sensor draws while it warms up, in milliamps; 0
+     * if it's always powered down
+     */
+    float _warmUpCurrent_mA = 0;
+    /**
+     * @brief Take one reading for calibrateTiming(), waiting a fixed time
+     * between starting the measurement and collecting its result.
+     *
+     * @param wait_ms The time to wait for the result, in milliseconds
+     * @param values The values of the reading; -9999 for those that failed
+     * @return **bool** True if every value of the reading was good
+     */
+    bool takeTimedReading(uint32_t wait_ms, float values[]);
+    /**
+     * @brief True if the sensor is set up in its first update instead of at
+     * boot.
+     */
+    bool _deferSetup = false;
+    /**
+     * @brief The number of failures in a row before the sensor is skipped; 0
+     * to never skip it.
+     */
+    uint8_t _failuresToSkip = 0;
+    /**
+     * @brief The number of updates in a row the sensor has failed.
+     */
+    uint8_t _consecutiveFailures = 0;
+    /**
+     * @brief The most updates to skip between tries of a failing sensor.
+     */
+    uint16_t _maxSkipUpdates = 64;
+    /**
+     * @brief The number of updates left to skip before trying the sensor
+     * again.
+     */
+    uint16_t _failureSkipsLeft = 0;
+    /**
+     * @brief True if the last update was skipped because of failures.
+     */
+    bool _backingOff = false;
+    /**
+     * @brief The oldest result shared with another update, in milliseconds;
+     * 0 to never share results.
+     */
+    uint32_t _resultMaxAge_ms = 0;
+    /**
+     * @brief The millis() the last good result was finished.
+     */
+    uint32_t _resultMillis = 0;
+    /**
+     * @brief The UTC epoch time of the record the last good result was
+     * measured for.
+     */
+    uint32_t _resultTime = 0;
+    /**
+     * @brief The wake the last good result was finished in; it is only
+     * shared within the same one.
+     */
+    uint16_t _resultGeneration = 0;
+    /**
+     * @brief True if the sensor values hold a good result.
+     */
+    bool _resultValid = false;
     /**
      * @brief The number of included calculated variables from the
      * sensor, if any.
@@ -486,7 +1432,86 @@ class Sensor {
      * @brief Array with the number of valid measurement values taken by the
      * sensor in the current update cycle.
      */
-    uint8_t numberGoodMeasurementsMade[MAX_NUMBER_VARS];
+    uint8_t* numberGoodMeasurementsMade = nullptr;
+#if defined(MS_SENSOR_FIXED_POINT)
+    /**
+     * @brief Array with the sums of the results given as scaled whole
+     * numbers in the current update cycle.
+     */
+    int32_t* _resultSums = nullptr;
+    /**
+     * @brief Array with the number of decimal places of each of
+     * #_resultSums.
+     */
+    uint8_t* _resultDecimals = nullptr;
+    /**
+     * @brief The bits of the results that are summed in #_resultSums rather
+     * than in #sensorValues.
+     */
+    uint8_t _fixedPointResults = 0;
+    /**
+     * @brief Move a result summed as a whole number into #sensorValues, to
+     * go on as a float.
+     *
+     * @param resultNumber The position of the result within the result array.
+     */
+    void foldFixedPointResult(uint8_t resultNumber);
+#endif
+#if defined(MS_SENSOR_STATISTICS)
+    /**
+     * @brief Array with the running sum of squared differences from the mean
+     * of the measurement values in the current update cycle.
+     */
+    float* _resultM2 = nullptr;
+    /**
+     * @brief Array with the smallest measurement value in the current update
+     * cycle.
+     */
+    float* _resultMin = nullptr;
+    /**
+     * @brief Array with the largest measurement value in the current update
+     * cycle.
+     */
+    float* _resultMax = nullptr;
+#endif
+    /**
+     * @brief The head of the list of variables reporting statistics or timing
+     * of the sensor's results.
+     */
+    Variable* _statVariables = nullptr;
+    /**
+     * @brief The elapsed time from power on to a successful wake in the last
+     * update.
+     */
+    uint32_t _lastWarmUpTime_ms = 0;
+    /**
+     * @brief The elapsed time from a successful wake to the first measurement
+     * request in the last update.
+     */
+    uint32_t _lastStabilizationTime_ms = 0;
+    /**
+     * @brief The elapsed time from the last measurement request to its result.
+     */
+    uint32_t _lastMeasurementTime_ms = 0;
+    /**
+     * @brief The shortest time between the results of two measurements, or 0
+     * for no limit.
+     */
+    uint32_t _minMeasurementInterval_ms = 0;
+    /**
+     * @brief The processor elapsed time when the result of the last
+     * measurement was collected, or 0 if none has been.
+     */
+    uint32_t _millisLastResult = 0;
+    /**
+     * @brief The processor elapsed time at the middle of the measurements of
+     * the current update, averaged over them
+     */
+    uint32_t _millisMeasurementMid = 0;
+    /**
+     * @brief The number of measurements in #_millisMeasurementMid
+     */
+    uint8_t _midpointCount = 0;
 
     /**
      * @brief The time needed from the when a sensor has power until it's ready
@@ -539,11 +1564,25 @@ class Sensor {
 
     /**
      * @brief An array for each sensor containing the variable objects tied to
-     * that sensor.  The #MAX_NUMBER_VARS cannot be determined on a per-sensor
-     * basis, because of the way memory is used on an Arduino.  It must be
-     * defined once for the whole class.
+     * that sensor.
+     *
+     * This and the other result arrays are allocated exactly once, in the
+     * constructor, with one entry for each of the #_numReturnedValues.  Sensor
+     * objects are normally created once at global scope and never destroyed,
+     * so this cannot fragment the heap, but it does let a single value sensor
+     * reserve only one slot instead of #MAX_NUMBER_VARS.
+     */
+    Variable** variables = nullptr;
+
+    /**
+     * @brief The function to call while waiting on any sensor.
+     */
+    static void (*_waitCallback)(void);
+    /**
+     * @brief A count of the processor's wakes, so results aren't shared across
+     * a sleep.
      */
-    Variable* variables[MAX_NUMBER_VARS];
+    static uint16_t _wakeGeneration;
 };
 
 #endif  // SRC_SENSORBASE_H_
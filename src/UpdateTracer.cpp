@@ -0,0 +1,55 @@
+/**
+ * @file UpdateTracer.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the UpdateTracer class.
+ */
+
+#include "UpdateTracer.h"
+
+#if defined(MS_TRACE_BUFFER_SIZE)
+
+// Initialize the static buffer
+UpdateTracer::traceEntry UpdateTracer::_entries[MS_TRACE_BUFFER_SIZE];
+uint16_t                 UpdateTracer::_next = 0;
+
+
+// Once the buffer has wrapped, the oldest event kept is the next overwritten
+void UpdateTracer::print(Print& out) {
+    uint16_t first = 0;
+    if (_next > MS_TRACE_BUFFER_SIZE) {
+        first = _next - MS_TRACE_BUFFER_SIZE;
+        out.print(_next - MS_TRACE_BUFFER_SIZE);
+        out.println(F(" earlier events were overwritten"));
+    }
+    for (uint16_t i = first; i != _next; i++) {
+        const traceEntry& entry = _entries[i & (MS_TRACE_BUFFER_SIZE - 1)];
+        out.print(entry.time);
+        out.print(',');
+        out.print(getEventName(entry.event));
+        out.print(',');
+        out.println(entry.index);
+    }
+}
+
+
+const __FlashStringHelper* UpdateTracer::getEventName(uint8_t event) {
+    switch (event) {
+        case TRACE_UPDATE_START: return F("update start");
+        case TRACE_POWERED: return F("powered");
+        case TRACE_AWAKE: return F("awake");
+        case TRACE_WAKE_FAILED: return F("wake failed");
+        case TRACE_MEASURING: return F("measuring");
+        case TRACE_START_FAILED: return F("start failed");
+        case TRACE_RESULT: return F("result");
+        case TRACE_OUT_OF_TIME: return F("out of time");
+        case TRACE_ASLEEP: return F("asleep");
+        case TRACE_POWERED_DOWN: return F("powered down");
+        case TRACE_UPDATE_END: return F("update end");
+        default: return F("unknown");
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file UpdateTracer.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the UpdateTracer class, which keeps a compact record of the
+ * steps of each sensor through a variable array update.
+ */
+
+// Header Guards
+#ifndef SRC_UPDATETRACER_H_
+#define SRC_UPDATETRACER_H_
+
+#include <Arduino.h>
+
+/**
+ * @brief The steps of a sensor through an update that are traced.
+ */
+typedef enum traceEvent {
+    TRACE_UPDATE_START = 0,  ///< The update began; the index is the sensors
+    TRACE_POWERED,           ///< The sensor was powered
+    TRACE_AWAKE,             ///< The sensor woke
+    TRACE_WAKE_FAILED,       ///< The sensor did not wake
+    TRACE_MEASURING,         ///< A measurement was started
+    TRACE_START_FAILED,      ///< A measurement could not be started
+    TRACE_RESULT,            ///< The result of a measurement was collected
+    TRACE_OUT_OF_TIME,       ///< The rest of the measurements were dropped
+    TRACE_ASLEEP,            ///< The sensor was put to sleep
+    TRACE_POWERED_DOWN,      ///< The power to the sensor was cut
+    TRACE_UPDATE_END         ///< The update ended; the index is the sensors
+} traceEvent;
+
+#if defined(MS_TRACE_BUFFER_SIZE)
+/**
+ * @brief Record a step of an update in the UpdateTracer.
+ *
+ * This does nothing unless `MS_TRACE_BUFFER_SIZE` is defined.
+ */
+#define MS_TRACE(event, index) UpdateTracer::record(event, index)
+#else
+#define MS_TRACE(event, index)
+#endif
+
+#if defined(MS_TRACE_BUFFER_SIZE)
+static_assert((MS_TRACE_BUFFER_SIZE & (MS_TRACE_BUFFER_SIZE - 1)) == 0,
+              "MS_TRACE_BUFFER_SIZE must be a power of two");
+
+/**
+ * @brief A ring buffer of the steps of the sensors through the updates of a
+ * variable array.
+ *
+ * Printing the timing of an update with the debugging outputs takes so long
+ * that it changes the timing.  With `MS_TRACE_BUFFER_SIZE` defined as a power
+ * of two, VariableArray::completeUpdate() instead records each change of a
+ * sensor's status here, as the event, the position of the sensor's last
+ * variable in the array and the millis() it happened.  Recording an event
+ * only stores those 6 bytes, so it is cheap enough to leave on in the field.
+ *
+ * The buffer keeps the most recent #MS_TRACE_BUFFER_SIZE events.  The logger
+ * adds the trace of each cycle to the `<logger id>_trace.txt` file on the SD
+ * card, with the values of the cycle, and then clears it; it can also be
+ * printed at any time with print().  A TraceReplaySensor replays the cycles
+ * of one sensor from the file, for timing changes against a real station.
+ */
+class UpdateTracer {
+ public:
+    /**
+     * @brief Record one event.
+     *
+     * @param event The step of the update
+     * @param index The position in the variable array of the sensor's last
+     * variable
+     */
+    static void record(traceEvent event, uint8_t index) {
+        traceEntry& entry = _entries[_next & (MS_TRACE_BUFFER_SIZE - 1)];
+        entry.time        = millis();
+        entry.event       = event;
+        entry.index       = index;
+        _next++;
+    }
+    /**
+     * @brief Forget all of the events.
+     */
+    static void clear(void) {
+        _next = 0;
+    }
+    /**
+     * @brief Get the number of events recorded since the buffer was cleared,
+     * including any that have been overwritten.
+     *
+     * @return **uint16_t** The number of events
+     */
+    static uint16_t getEventCount(void) {
+        return _next;
+    }
+    /**
+     * @brief Print the events kept, oldest first.
+     *
+     * Each event is a line with its millis(), the name of the event and the
+     * position of the variable.
+     *
+     * @param out The stream to print to
+     */
+    static void print(Print& out);
+
+ private:
+    /**
+     * @brief One recorded event
+     */
+    typedef struct traceEntry {
+        /// @brief The millis() of the event
+        uint32_t time;
+        /// @brief The event; a traceEvent
+        uint8_t event;
+        /// @brief The position of the sensor's last variable in the array
+        uint8_t index;
+    } traceEntry;
+
+    /**
+     * @brief Get the name of an event.
+     *
+     * @param event The event
+     * @return **const __FlashStringHelper*** The name
+     */
+    static const __FlashStringHelper* getEventName(uint8_t event);
+
+    static traceEntry _entries[MS_TRACE_BUFFER_SIZE];
+    static uint16_t   _next;
+};
+#endif
+
+#endif  // SRC_UPDATETRACER_H_
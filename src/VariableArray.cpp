@@ -15,6 +15,7 @@ VariableArray::VariableArray() {}
 VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[])
     : arrayOfVars(variableList),
       _variableCount(variableCount) {
+    buildSensorIndex();
     _maxSamplestoAverage = countMaxToAverage();
     _sensorCount         = getSensorCount();
 }
@@ -22,6 +23,7 @@ VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[],
                              const char* uuids[])
     : arrayOfVars(variableList),
       _variableCount(variableCount) {
+    buildSensorIndex();
     _maxSamplestoAverage = countMaxToAverage();
     _sensorCount         = getSensorCount();
     matchUUIDs(uuids);
@@ -35,23 +37,35 @@ void VariableArray::begin(uint8_t variableCount, Variable* variableList[],
     _variableCount = variableCount;
     arrayOfVars    = variableList;
 
+    buildSensorIndex();
     _maxSamplestoAverage = countMaxToAverage();
     _sensorCount         = getSensorCount();
     matchUUIDs(uuids);
     checkVariableUUIDs();
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    buildLookupIndex();
+#endif
 }
 void VariableArray::begin(uint8_t variableCount, Variable* variableList[]) {
     _variableCount = variableCount;
     arrayOfVars    = variableList;
 
+    buildSensorIndex();
     _maxSamplestoAverage = countMaxToAverage();
     _sensorCount         = getSensorCount();
     checkVariableUUIDs();
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    buildLookupIndex();
+#endif
 }
 void VariableArray::begin() {
+    buildSensorIndex();
     _maxSamplestoAverage = countMaxToAverage();
     _sensorCount         = getSensorCount();
     checkVariableUUIDs();
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    buildLookupIndex();
+#endif
 }
 
 // This counts and returns the number of calculated variables
@@ -83,6 +97,17 @@ void VariableArray::matchUUIDs(const char* uuids[]) {
     }
 }
 
+// This finds the sensor with the given place among the unique sensors
+Sensor* VariableArray::getSensor(uint8_t sensorNumber) {
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (!isLastVarFromSensor(i)) continue;
+        if (sensorNumber == 0) return arrayOfVars[i]->parentSensor;
+        sensorNumber--;
+    }
+    return nullptr;
+}
+
+
 // Public functions for interfacing with a list of sensors
 // This sets up all of the sensors in the list
 // NOTE:  Calculated variables will always be skipped in this process because
@@ -103,46 +128,67 @@ bool VariableArray::setupSensors(void) {
     MS_DBG(F("Running sensor setup functions."));
 
     // Check for any sensors that have been set up outside of this (ie, the
-    // modem)
+    // modem) or that will be set up in their first update.  Power up all of
+    // the others together so they warm up at the same time.
     uint8_t nSensorsSetup = 0;
+    bool    pendingSetup[_variableCount];
+    bool    poweredHere[_variableCount];
     for (uint8_t i = 0; i < _variableCount; i++) {
-        if (isLastVarFromSensor(i)  // Skip non-unique sensors
-            && bitRead(arrayOfVars[i]->parentSensor->getStatus(), 0) ==
-                1  // already set up
-        ) {
+        pendingSetup[i] = false;
+        poweredHere[i]  = false;
+        if (!isLastVarFromSensor(i)) continue;  // Skip non-unique sensors
+        Sensor* sensor = arrayOfVars[i]->parentSensor;
+        if (bitRead(sensor->getStatus(), 0) == 1) {
             MS_DBG(F("   "), arrayOfVars[i]->getParentSensorNameAndLocation(),
                    F("was already set up!"));
-
             nSensorsSetup++;
+        } else if (sensor->getDeferredSetup()) {
+            MS_DBG(F("   "), arrayOfVars[i]->getParentSensorNameAndLocation(),
+                   F("will be set up in its first update."));
+            nSensorsSetup++;
+        } else {
+            pendingSetup[i] = true;
         }
     }
+    powerUpInOrder(pendingSetup, poweredHere);
 
     // We're going to keep looping through all of the sensors and check if each
     // one has been on long enough to be warmed up.  Once it has, we'll set it
     // up and increment the counter marking that's been done.
-    // We keep looping until they've all been done.
+    // We keep looping until they've all been done, idling until the next
+    // sensor is warm.
     while (nSensorsSetup < _sensorCount) {
+        uint32_t nextWarm = 0xFFFFFFFF;
         for (uint8_t i = 0; i < _variableCount; i++) {
-            if (isLastVarFromSensor(i)  // Skip non-unique sensors
-                && bitRead(arrayOfVars[i]->parentSensor->getStatus(), 0) ==
-                    0  // only set up if it has not yet been set up
-            ) {
-                MS_DBG(F("    Set up of"),
-                       arrayOfVars[i]->getParentSensorNameAndLocation(),
-                       F("..."));
+            if (!pendingSetup[i]) continue;
+            Sensor* sensor = arrayOfVars[i]->parentSensor;
+            if (!sensor->isWarmedUp()) {
+                uint32_t warmUpLeft = sensor->getWarmUpTimeRemaining();
+                if (warmUpLeft < nextWarm) nextWarm = warmUpLeft;
+                continue;
+            }
+            MS_DBG(F("    Set up of"),
+                   arrayOfVars[i]->getParentSensorNameAndLocation(), F("..."));
 
-                bool sensorSuccess =
-                    arrayOfVars[i]->parentSensor->setup();  // set it up
-                success &= sensorSuccess;
-                nSensorsSetup++;
+            bool sensorSuccess = sensor->setup();  // set it up
+            success &= sensorSuccess;
+            nSensorsSetup++;
+            pendingSetup[i] = false;
 
-                if (!sensorSuccess) {
-                    MS_DBG(F("        ... setup failed!"));
-                } else {
-                    MS_DBG(F("        ... setup succeeded."));
-                }
+            if (!sensorSuccess) {
+                MS_DBG(F("        ... setup failed!"));
+            } else {
+                MS_DBG(F("        ... setup succeeded."));
             }
         }
+        if (nSensorsSetup < _sensorCount && nextWarm != 0xFFFFFFFF) {
+            Sensor::idleProcessor(nextWarm);
+        }
+    }
+
+    // Cut the power that was turned on here
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (poweredHere[i]) arrayOfVars[i]->parentSensor->powerDown();
     }
 
     if (success) { MS_DBG(F("... Success!")); }
@@ -158,12 +204,66 @@ bool VariableArray::setupSensors(void) {
 // sensor.
 void VariableArray::sensorsPowerUp(void) {
     MS_DBG(F("Powering up sensors..."));
+    bool lastSensorVariable[_variableCount];
     for (uint8_t i = 0; i < _variableCount; i++) {
-        if (isLastVarFromSensor(i)) {  // Skip non-unique sensors
-            MS_DBG(F("    Powering up"),
-                   arrayOfVars[i]->getParentSensorNameAndLocation());
+        lastSensorVariable[i] = isLastVarFromSensor(i);
+    }
+    powerUpInOrder(lastSensorVariable);
+}
+
 
-            arrayOfVars[i]->parentSensor->powerUp();
+// Picking the longest remaining warm-up each time is quadratic, but there are
+// only ever a handful of sensors
+void VariableArray::powerUpInOrder(const bool lastSensorVariable[],
+                                   bool       poweredHere[]) {
+    bool done[_variableCount];
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        done[i] = !lastSensorVariable[i];
+    }
+    uint32_t lastSwitch_ms = 0;
+    uint16_t lastInrush_ms = 0;
+    while (true) {
+        int16_t next = -1;
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            if (done[i]) continue;
+            if (next < 0 ||
+                arrayOfVars[i]->parentSensor->getWarmUpTime() >
+                    arrayOfVars[next]->parentSensor->getWarmUpTime()) {
+                next = i;
+            }
+        }
+        if (next < 0) break;
+        done[next]     = true;
+        Sensor* sensor = arrayOfVars[next]->parentSensor;
+        if (poweredHere != nullptr) {
+            if (sensor->checkPowerOn()) continue;
+            poweredHere[next] = true;
+        }
+
+        // Only the first sensor on a rail or a shared pin switches it
+        PowerRail* rail     = sensor->getPowerRail();
+        int8_t     pin      = sensor->getPowerPin();
+        bool       switches = rail != nullptr ? !rail->isPowered() : pin >= 0;
+        for (uint8_t j = 0; switches && rail == nullptr && j < _variableCount;
+             j++) {
+            if (j != next && done[j] && lastSensorVariable[j] &&
+                arrayOfVars[j]->parentSensor->getPowerPin() == pin) {
+                switches = false;
+            }
+        }
+        if (switches && lastInrush_ms > 0 &&
+            millis() - lastSwitch_ms < lastInrush_ms) {
+            Sensor::idleProcessor(lastInrush_ms - (millis() - lastSwitch_ms));
+        }
+
+        MS_DBG(F("    Powering up"),
+               arrayOfVars[next]->getParentSensorNameAndLocation());
+        sensor->powerUp();
+        MS_TRACE(TRACE_POWERED, next);
+        if (switches) {
+            lastSwitch_ms = millis();
+            lastInrush_ms = rail != nullptr ? rail->getInrushTime()
+                                            : _powerStagger_ms;
         }
     }
 }
@@ -224,8 +324,10 @@ bool VariableArray::sensorsWake(void) {
                 nSensorsAwake++;
 
                 if (sensorSuccess) {
+                    MS_TRACE(TRACE_AWAKE, i);
                     MS_DBG(F("        ... wake up succeeded."));
                 } else {
+                    MS_TRACE(TRACE_WAKE_FAILED, i);
                     MS_DBG(F("        ... wake up failed!"));
                 }
             }
@@ -251,6 +353,7 @@ bool VariableArray::sensorsSleep(void) {
 
             bool sensorSuccess = arrayOfVars[i]->parentSensor->sleep();
             success &= sensorSuccess;
+            MS_TRACE(TRACE_ASLEEP, i);
 
             if (sensorSuccess) {
                 MS_DBG(F("        ... successfully put to sleep."));
@@ -270,12 +373,14 @@ bool VariableArray::sensorsSleep(void) {
 // sensor.
 void VariableArray::sensorsPowerDown(void) {
     MS_DBG(F("Powering down sensors..."));
+    _keptPowered = false;
     for (uint8_t i = 0; i < _variableCount; i++) {
         if (isLastVarFromSensor(i)) {  // Skip non-unique sensors
             MS_DBG(F("    Powering down"),
                    arrayOfVars[i]->getParentSensorNameAndLocation());
 
             arrayOfVars[i]->parentSensor->powerDown();
+            MS_TRACE(TRACE_POWERED_DOWN, i);
         }
     }
 }
@@ -299,12 +404,12 @@ bool VariableArray::updateAllSensors(void) {
 #endif
 
     // Create an array with the unique-ness value (so we can skip the function
-    // calls later)
+    // calls later).  Sensors that are not due to be measured on this update
+    // are left out of the mask entirely.
     MS_DBG(F("Creating a mask array with the uniqueness for each sensor.."));
-    bool lastSensorVariable[_variableCount];
-    for (uint8_t i = 0; i < _variableCount; i++) {
-        lastSensorVariable[i] = isLastVarFromSensor(i);
-    }
+    bool    lastSensorVariable[_variableCount];
+    uint8_t nSensorsToUpdate = buildUpdateMask(lastSensorVariable);
+    MS_TRACE(TRACE_UPDATE_START, nSensorsToUpdate);
 
     // Create an array for the number of measurements already completed and set
     // all to zero
@@ -361,12 +466,14 @@ bool VariableArray::updateAllSensors(void) {
         }
     }
 
-    while (nSensorsCompleted < _sensorCount) {
+    while (nSensorsCompleted < nSensorsToUpdate) {
         for (uint8_t i = 0; i < _variableCount; i++) {
             /***
             // THIS IS PURELY FOR DEEP DEBUGGING OF THE TIMING!
             // Leave this whole section commented out unless you want excessive
             // printouts (ie, thousands of lines) of the timing information!!
+            // Defining MS_TRACE_BUFFER_SIZE traces the same changes of status
+            // without printing anything until the update is done.
             if (lastSensorVariable[i] and
                 nMeasurementsToAverage[i] > nMeasurementsCompleted[i])
             {
@@ -389,8 +496,12 @@ bool VariableArray::updateAllSensors(void) {
             // Only do checks on sensors that still have measurements to finish
             if (lastSensorVariable[i] &&
                 nMeasurementsToAverage[i] > nMeasurementsCompleted[i]) {
-                // first, make sure the sensor is stable
-                if (arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
+                // first, make sure the sensor is stable, and can be read
+                // again if it isn't already measuring
+                if (arrayOfVars[i]->parentSensor->isStable(deepDebugTiming) &&
+                    (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 5) ||
+                     arrayOfVars[i]->parentSensor->getIntervalTimeRemaining() ==
+                         0)) {
                     // now, if the sensor is not currently measuring...
                     if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 5) ==
                         0) {  // NO attempt yet to start a measurement
@@ -401,15 +512,20 @@ bool VariableArray::updateAllSensors(void) {
                                arrayOfVars[i]->getParentSensorNameAndLocation(),
                                '-');
 
+                        // Put back the clock of its I2C bus, in case another
+                        // sensor's library reset it
+                        arrayOfVars[i]->parentSensor->applyI2CClock();
                         bool sensorSuccess_start =
                             arrayOfVars[i]
                                 ->parentSensor->startSingleMeasurement();
                         success &= sensorSuccess_start;
 
                         if (sensorSuccess_start) {
+                            MS_TRACE(TRACE_MEASURING, i);
                             MS_DBG(F("   ... reading started! <<---"), i, '.',
                                    nMeasurementsCompleted[i] + 1);
                         } else {
+                            MS_TRACE(TRACE_START_FAILED, i);
                             MS_DBG(F("   ... failed to start reading! <<---"),
                                    i, '.', nMeasurementsCompleted[i] + 1);
                         }
@@ -432,10 +548,13 @@ bool VariableArray::updateAllSensors(void) {
                                arrayOfVars[i]->getParentSensorNameAndLocation(),
                                F("..."));
 
+                        arrayOfVars[i]->parentSensor->markMeasurementTime();
+                        arrayOfVars[i]->parentSensor->applyI2CClock();
                         bool sensorSuccess_result =
                             arrayOfVars[i]
                                 ->parentSensor->addSingleMeasurementResult();
                         success &= sensorSuccess_result;
+                        MS_TRACE(TRACE_RESULT, i);
                         nMeasurementsCompleted[i] +=
                             1;  // increment the number of measurements that
                                 // sensor has completed
@@ -448,6 +567,16 @@ bool VariableArray::updateAllSensors(void) {
                                      "<<---"),
                                    i, '.', nMeasurementsCompleted[i]);
                         }
+
+                        // If the average has already settled, skip the rest
+                        // of the readings
+                        if (nMeasurementsCompleted[i] <
+                                nMeasurementsToAverage[i] &&
+                            arrayOfVars[i]
+                                ->parentSensor->isAveragingConverged()) {
+                            nMeasurementsCompleted[i] =
+                                nMeasurementsToAverage[i];
+                        }
                     }
                 }
 
@@ -464,6 +593,14 @@ bool VariableArray::updateAllSensors(void) {
                 }
             }
         }
+
+        // Rather than immediately looping back through all of the sensors,
+        // idle until the soonest time at which any sensor will be ready.
+        if (nSensorsCompleted < nSensorsToUpdate) {
+            Sensor::idleProcessor(getTimeToNextDeadline(
+                lastSensorVariable, nMeasurementsToAverage,
+                nMeasurementsCompleted));
+        }
     }
 
     // Average measurements and notify varibles of the updates
@@ -474,13 +611,17 @@ bool VariableArray::updateAllSensors(void) {
                         arrayOfVars[i]->getParentSensorNameAndLocation(),
                         F("---"));
             arrayOfVars[i]->parentSensor->averageMeasurements();
+            arrayOfVars[i]->parentSensor->recordUpdateResult();
             MS_DEEP_DBG(F("--- Notifying variables from"),
                         arrayOfVars[i]->getParentSensorNameAndLocation(),
                         F("---"));
             arrayOfVars[i]->parentSensor->notifyVariables();
         }
     }
+    markSkippedSensors(lastSensorVariable);
+    updateCalculatedVariables();
     MS_DBG(F("... Complete. <<-----"));
+    MS_TRACE(TRACE_UPDATE_END, nSensorsCompleted);
 
     return success;
 }
@@ -489,8 +630,10 @@ bool VariableArray::updateAllSensors(void) {
 // This function is an even more complete version of the updateAllSensors
 // function - it handles power up/down and wake/sleep.
 bool VariableArray::completeUpdate(void) {
-    bool    success           = true;
-    uint8_t nSensorsCompleted = 0;
+    bool     success           = true;
+    uint8_t  nSensorsCompleted = 0;
+    uint32_t updateStart       = millis();
+    uint8_t  shedLevel         = 0;
 
 #ifdef MS_VARIABLEARRAY_DEBUG_DEEP
     bool deepDebugTiming = true;
@@ -499,12 +642,12 @@ bool VariableArray::completeUpdate(void) {
 #endif
 
     // Create an array with the unique-ness value (so we can skip the function
-    // calls later)
+    // calls later).  Sensors that are not due to be measured on this update
+    // are left out of the mask entirely.
     MS_DBG(F("Creating a mask array with the uniqueness for each sensor.."));
-    bool lastSensorVariable[_variableCount];
-    for (uint8_t i = 0; i < _variableCount; i++) {
-        lastSensorVariable[i] = isLastVarFromSensor(i);
-    }
+    bool    lastSensorVariable[_variableCount];
+    uint8_t nSensorsToUpdate = buildUpdateMask(lastSensorVariable);
+    MS_TRACE(TRACE_UPDATE_START, nSensorsToUpdate);
 
     // Create an array for the number of measurements already completed and set
     // all to zero
@@ -624,17 +767,34 @@ bool VariableArray::completeUpdate(void) {
     }
     MS_DBG(F("   ... Complete. <<-----"));
 
-    // power up all of the sensors together
+    // power up all of the sensors together; sensors already warmed up ahead
+    // of the update, or kept powered since the last one, keep the power they
+    // have
     MS_DBG(F("----->> Powering up all sensors together. ..."));
-    sensorsPowerUp();
+    if (_preWarmed || _keptPowered) {
+        bool poweredHere[_variableCount];
+        for (uint8_t i = 0; i < _variableCount; i++) { poweredHere[i] = false; }
+        powerUpInOrder(lastSensorVariable, poweredHere);
+        _preWarmed = false;
+    } else {
+        powerUpInOrder(lastSensorVariable);
+    }
     MS_DBG(F("   ... Complete. <<-----"));
 
-    while (nSensorsCompleted < _sensorCount) {
+    while (nSensorsCompleted < nSensorsToUpdate) {
+        uint8_t newShedLevel = getShedLevel(millis() - updateStart);
+        if (newShedLevel != shedLevel) {
+            MS_DBG(F("Update is running short of time; shed level"),
+                   newShedLevel);
+            shedLevel = newShedLevel;
+        }
         for (uint8_t i = 0; i < _variableCount; i++) {
             /***
             // THIS IS PURELY FOR DEEP DEBUGGING OF THE TIMING!
             // Leave this whole section commented out unless you want excessive
             // printouts (ie, thousands of lines) of the timing information!!
+            // Defining MS_TRACE_BUFFER_SIZE traces the same changes of status
+            // without printing anything until the update is done.
             if (lastSensorVariable[i] and
                 nMeasurementsToAverage[i] > nMeasurementsCompleted[i]) {
                 MS_DEEP_DBG(
@@ -670,6 +830,14 @@ bool VariableArray::completeUpdate(void) {
                     && arrayOfVars[i]->parentSensor->isWarmedUp(
                            deepDebugTiming)  // and if it is already warmed up
                 ) {
+                    // A deferred setup runs now that the sensor is warm
+                    if (bitRead(arrayOfVars[i]->parentSensor->getStatus(),
+                                0) == 0) {
+                        MS_DBG(i, F("--->> Setting up"),
+                               arrayOfVars[i]->getParentSensorNameAndLocation(),
+                               F("..."));
+                        success &= arrayOfVars[i]->parentSensor->setup();
+                    }
                     MS_DBG(i, F("--->> Waking"),
                            arrayOfVars[i]->getParentSensorNameAndLocation(),
                            F("..."));
@@ -681,8 +849,10 @@ bool VariableArray::completeUpdate(void) {
                     success &= sensorSuccess_wake;
 
                     if (sensorSuccess_wake) {
+                        MS_TRACE(TRACE_AWAKE, i);
                         MS_DBG(F("   ... wake up success. <<---"), i);
                     } else {
+                        MS_TRACE(TRACE_WAKE_FAILED, i);
                         MS_DBG(F("   ... wake up failed! <<---"), i);
                     }
                 }
@@ -710,10 +880,14 @@ bool VariableArray::completeUpdate(void) {
                 }
 
                 // If the sensor was successfully awoken/activated...
-                // .. make sure the sensor is stable
+                // .. make sure the sensor is stable, and can be read again if
+                // it isn't already measuring
                 if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 4) ==
                         1 &&
-                    arrayOfVars[i]->parentSensor->isStable(deepDebugTiming)) {
+                    arrayOfVars[i]->parentSensor->isStable(deepDebugTiming) &&
+                    (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 5) ||
+                     arrayOfVars[i]->parentSensor->getIntervalTimeRemaining() ==
+                         0)) {
                     // If no attempt has yet been made to start a measurement,
                     // start one
                     if (bitRead(arrayOfVars[i]->parentSensor->getStatus(), 5) ==
@@ -725,15 +899,20 @@ bool VariableArray::completeUpdate(void) {
                                arrayOfVars[i]->getParentSensorNameAndLocation(),
                                F("..."));
 
+                        // Put back the clock of its I2C bus, in case another
+                        // sensor's library reset it
+                        arrayOfVars[i]->parentSensor->applyI2CClock();
                         bool sensorSuccess_start =
                             arrayOfVars[i]
                                 ->parentSensor->startSingleMeasurement();
                         success &= sensorSuccess_start;
 
                         if (sensorSuccess_start) {
+                            MS_TRACE(TRACE_MEASURING, i);
                             MS_DBG(F("   ... start reading succeeded. <<---"),
                                    i, '.', nMeasurementsCompleted[i] + 1);
                         } else {
+                            MS_TRACE(TRACE_START_FAILED, i);
                             MS_DBG(F("   ... start reading failed! <<---"), i,
                                    '.', nMeasurementsCompleted[i] + 1);
                         }
@@ -754,10 +933,13 @@ bool VariableArray::completeUpdate(void) {
                                arrayOfVars[i]->getParentSensorNameAndLocation(),
                                F("..."));
 
+                        arrayOfVars[i]->parentSensor->markMeasurementTime();
+                        arrayOfVars[i]->parentSensor->applyI2CClock();
                         bool sensorSuccess_result =
                             arrayOfVars[i]
                                 ->parentSensor->addSingleMeasurementResult();
                         success &= sensorSuccess_result;
+                        MS_TRACE(TRACE_RESULT, i);
                         nMeasurementsCompleted[i] +=
                             1;  // increment the number of measurements that
                                 // sensor has completed
@@ -773,9 +955,39 @@ bool VariableArray::completeUpdate(void) {
                                      "<<---"),
                                    i, '.', nMeasurementsCompleted[i]);
                         }
+
+                        // If the average has already settled, skip the rest
+                        // of the readings
+                        if (nMeasurementsCompleted[i] <
+                                nMeasurementsToAverage[i] &&
+                            arrayOfVars[i]
+                                ->parentSensor->isAveragingConverged()) {
+                            nCompletedOnPin[powerPinIndex[i]] +=
+                                nMeasurementsToAverage[i] -
+                                nMeasurementsCompleted[i];
+                            nMeasurementsCompleted[i] =
+                                nMeasurementsToAverage[i];
+                        }
                     }
                 }
 
+                // If the update is out of time for this sensor, skip the rest
+                // of its readings
+                if (nMeasurementsCompleted[i] < nMeasurementsToAverage[i] &&
+                    (shedLevel >= 3 ||
+                     (shedLevel >= 2 &&
+                      !arrayOfVars[i]->parentSensor->isCritical()) ||
+                     (shedLevel >= 1 && nMeasurementsCompleted[i] > 0))) {
+                    MS_DBG(i, F("--->> Out of time for"),
+                           arrayOfVars[i]->getParentSensorNameAndLocation(),
+                           F("after"), nMeasurementsCompleted[i],
+                           F("measurements"));
+                    MS_TRACE(TRACE_OUT_OF_TIME, i);
+                    nCompletedOnPin[powerPinIndex[i]] +=
+                        nMeasurementsToAverage[i] - nMeasurementsCompleted[i];
+                    nMeasurementsCompleted[i] = nMeasurementsToAverage[i];
+                }
+
                 // If all the measurements are done
                 if (nMeasurementsCompleted[i] == nMeasurementsToAverage[i]) {
                     MS_DBG(i, F("--->> Finished all measurements from"),
@@ -786,6 +998,7 @@ bool VariableArray::completeUpdate(void) {
                     bool sensorSuccess_sleep =
                         arrayOfVars[i]->parentSensor->sleep();
                     success &= sensorSuccess_sleep;
+                    MS_TRACE(TRACE_ASLEEP, i);
 
                     if (sensorSuccess_sleep) {
                         MS_DBG(F("   ... succeeded in putting sensor to sleep. "
@@ -796,18 +1009,40 @@ bool VariableArray::completeUpdate(void) {
                     }
 
                     // Now cut the power, if ready, to this sensors and all that
-                    // share the pin
+                    // share the pin, unless it costs less to keep all of them
+                    // powered until their next update
                     if (nCompletedOnPin[powerPinIndex[i]] ==
                         nMeasurementsOnPin[powerPinIndex[i]]) {
-                        for (uint8_t k = 0; k < _variableCount; k++) {
+                        bool keepPower = _updatePeriod_ms > 0;
+                        for (uint8_t k = 0; keepPower && k < _variableCount;
+                             k++) {
                             if (powerPinIndex[k] == powerPinIndex[i] &&
                                 lastSensorVariable[k]) {
-                                arrayOfVars[k]->parentSensor->powerDown();
+                                keepPower &= arrayOfVars[k]
+                                                 ->parentSensor
+                                                 ->isKeepingPowerCheaper(
+                                                     _updatePeriod_ms);
+                            }
+                        }
+                        if (keepPower) _keptPowered = true;
+                        for (uint8_t k = 0; k < _variableCount; k++) {
+                            if (powerPinIndex[k] != powerPinIndex[i] ||
+                                !lastSensorVariable[k]) {
+                                continue;
+                            }
+                            if (keepPower) {
                                 MS_DBG(k, F("--->>"),
                                        arrayOfVars[k]
                                            ->getParentSensorNameAndLocation(),
-                                       F("powered down. <<---"), k);
+                                       F("kept powered. <<---"), k);
+                                continue;
                             }
+                            arrayOfVars[k]->parentSensor->powerDown();
+                            MS_TRACE(TRACE_POWERED_DOWN, k);
+                            MS_DBG(k, F("--->>"),
+                                   arrayOfVars[k]
+                                       ->getParentSensorNameAndLocation(),
+                                   F("powered down. <<---"), k);
                         }
                     }
 
@@ -817,7 +1052,19 @@ bool VariableArray::completeUpdate(void) {
                 }
             }
         }
+
+        // Rather than immediately looping back through all of the sensors,
+        // idle until the soonest time at which any sensor will be ready, or
+        // the update must drop more of its work.
+        if (nSensorsCompleted < nSensorsToUpdate) {
+            uint32_t idleTime = getTimeToNextDeadline(
+                lastSensorVariable, nMeasurementsToAverage,
+                nMeasurementsCompleted);
+            uint32_t shedTime = getTimeToNextShed(millis() - updateStart);
+            Sensor::idleProcessor(idleTime < shedTime ? idleTime : shedTime);
+        }
     }
+    _updateBudget_ms = 0;
 
     // Average measurements and notify varibles of the updates
     MS_DBG(F("----->> Averaging results and notifying all variables. ..."));
@@ -826,13 +1073,20 @@ bool VariableArray::completeUpdate(void) {
             MS_DBG(F("--- Averaging results from"),
                    arrayOfVars[i]->getParentSensorNameAndLocation(), F("---"));
             arrayOfVars[i]->parentSensor->averageMeasurements();
+            arrayOfVars[i]->parentSensor->recordUpdateResult();
             MS_DBG(F("--- Notifying variables from"),
                    arrayOfVars[i]->getParentSensorNameAndLocation(), F("---"));
             arrayOfVars[i]->parentSensor->notifyVariables();
         }
     }
+    markSkippedSensors(lastSensorVariable);
+    updateCalculatedVariables();
     MS_DBG(F("... Complete. <<-----"));
 
+    _lastUpdateTime_ms = millis() - updateStart;
+    MS_TRACE(TRACE_UPDATE_END, nSensorsCompleted);
+    MS_DBG(F("Complete update took"), _lastUpdateTime_ms, F("ms"));
+
     return success;
 }
 
@@ -840,11 +1094,13 @@ bool VariableArray::completeUpdate(void) {
 // This function prints out the results for any connected sensors to a stream
 //  Calculated Variable results will be included
 void VariableArray::printSensorData(Stream* stream) {
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
     for (uint8_t i = 0; i < _variableCount; i++) {
+        arrayOfVars[i]->formatValue(valueBuffer, sizeof(valueBuffer));
         if (arrayOfVars[i]->isCalculated) {
             stream->print(arrayOfVars[i]->getVarName());
             stream->print(F(" is calculated to be "));
-            stream->print(arrayOfVars[i]->getValueString());
+            stream->print(valueBuffer);
             stream->print(F(" "));
             stream->print(arrayOfVars[i]->getVarUnit());
             stream->println();
@@ -870,7 +1126,7 @@ void VariableArray::printSensorData(Stream* stream) {
             stream->print(F(" reports "));
             stream->print(arrayOfVars[i]->getVarName());
             stream->print(F(" is "));
-            stream->print(arrayOfVars[i]->getValueString());
+            stream->print(valueBuffer);
             stream->print(F(" "));
             stream->print(arrayOfVars[i]->getVarUnit());
             stream->println();
@@ -879,25 +1135,338 @@ void VariableArray::printSensorData(Stream* stream) {
 }
 
 
-// Check for unique sensors
-bool VariableArray::isLastVarFromSensor(int arrayIndex) {
-    // Calculated Variables are never the last variable from a sensor, simply
-    // because the don't come from a sensor at all.
-    if (arrayOfVars[arrayIndex]->isCalculated) {
-        return false;
-    } else {
-        String sensNameLoc =
-            arrayOfVars[arrayIndex]->getParentSensorNameAndLocation();
+// Build the index of unique sensors.  Each sensor is marked on the last of its
+// variables in the array so that all of the variables from a sensor have been
+// passed before the sensor is handled.  This is done once at begin so we don't
+// need to search the array on every pass through the update loops.
+void VariableArray::buildSensorIndex(void) {
+    memset(_lastVarFromSensor, 0, sizeof(_lastVarFromSensor));
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        // Calculated Variables are never the last variable from a sensor,
+        // simply because the don't come from a sensor at all.
+        if (arrayOfVars[i]->isCalculated) { continue; }
+        Sensor* parent = arrayOfVars[i]->parentSensor;
+        if (parent == nullptr) { continue; }
         bool unique = true;
-        for (int j = arrayIndex + 1; j < _variableCount; j++) {
-            if (sensNameLoc ==
-                arrayOfVars[j]->getParentSensorNameAndLocation()) {
+        for (uint8_t j = i + 1; j < _variableCount; j++) {
+            if (!arrayOfVars[j]->isCalculated &&
+                arrayOfVars[j]->parentSensor == parent) {
                 unique = false;
                 break;
             }
         }
-        return unique;
+        if (unique) { bitSet(_lastVarFromSensor[i / 8], i % 8); }
+    }
+}
+
+
+// The UUID is written out whether it is text, in flash or raw bytes
+bool VariableArray::getLookupKey(uint8_t arrayIndex, bool byUUID,
+                                 char* buffer, size_t bufferSize) {
+    if (byUUID) {
+        return arrayOfVars[arrayIndex]->formatVarUUID(buffer, bufferSize) > 0;
     }
+    return arrayOfVars[arrayIndex]->formatVarCode(buffer, bufferSize) > 0;
+}
+
+
+uint16_t VariableArray::hashKey(const char* key, bool foldCase) {
+    uint32_t hash = 2166136261UL;
+    for (; *key != '\0'; key++) {
+        hash ^= static_cast<uint8_t>(foldCase ? tolower(*key) : *key);
+        hash *= 16777619UL;
+    }
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+
+#if MS_VARIABLE_INDEX_SLOTS > 0
+static_assert((MS_VARIABLE_INDEX_SLOTS & (MS_VARIABLE_INDEX_SLOTS - 1)) == 0,
+              "MS_VARIABLE_INDEX_SLOTS must be a power of two");
+
+// Each table is open-addressed with linear probing; a variable whose key is
+// already in the table isn't added again, so the first of any duplicates is
+// the one found
+void VariableArray::buildLookupIndex(void) {
+    char key[37];
+    for (uint8_t t = 0; t < 2; t++) {
+        bool     byUUID = t == 0;
+        uint16_t filled = 0;
+        memset(_keySlots[t], 0, sizeof(_keySlots[t]));
+        _indexComplete[t] = true;
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            if (!getLookupKey(i, byUUID, key, sizeof(key))) continue;
+            if (findByKey(key, byUUID) != nullptr) continue;
+            // Always leave an empty slot to end the probes
+            if (filled >= MS_VARIABLE_INDEX_SLOTS - 1) {
+                _indexComplete[t] = false;
+                break;
+            }
+            uint16_t hash = hashKey(key, byUUID);
+            uint16_t slot = hash & (MS_VARIABLE_INDEX_SLOTS - 1);
+            while (_keySlots[t][slot] != 0) {
+                slot = (slot + 1) & (MS_VARIABLE_INDEX_SLOTS - 1);
+            }
+            _keyHashes[t][slot] = hash;
+            _keySlots[t][slot]  = i + 1;
+            filled++;
+        }
+    }
+    MS_DBG(F("Indexed the variable UUIDs and codes"));
+}
+#endif
+
+
+// UUIDs are hex, so the case of their letters doesn't matter
+static bool keysMatch(const char* key, const char* other, bool byUUID) {
+    return (byUUID ? strcasecmp(key, other) : strcmp(key, other)) == 0;
+}
+Variable* VariableArray::findByUUID(const char* uuid) {
+    return findByKey(uuid, true);
+}
+Variable* VariableArray::findByCode(const char* varCode) {
+    return findByKey(varCode, false);
+}
+// The array is searched if the table is missing or incomplete
+Variable* VariableArray::findByKey(const char* key, bool byUUID) {
+    if (key == nullptr || *key == '\0') return nullptr;
+    char candidate[37];
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    uint8_t  t    = byUUID ? 0 : 1;
+    uint16_t hash = hashKey(key, byUUID);
+    uint16_t slot = hash & (MS_VARIABLE_INDEX_SLOTS - 1);
+    while (_keySlots[t][slot] != 0) {
+        uint8_t i = _keySlots[t][slot] - 1;
+        if (_keyHashes[t][slot] == hash &&
+            getLookupKey(i, byUUID, candidate, sizeof(candidate)) &&
+            keysMatch(candidate, key, byUUID)) {
+            return arrayOfVars[i];
+        }
+        slot = (slot + 1) & (MS_VARIABLE_INDEX_SLOTS - 1);
+    }
+    if (_indexComplete[t]) return nullptr;
+#endif
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (getLookupKey(i, byUUID, candidate, sizeof(candidate)) &&
+            keysMatch(candidate, key, byUUID)) {
+            return arrayOfVars[i];
+        }
+    }
+    return nullptr;
+}
+
+
+// Check for unique sensors
+bool VariableArray::isLastVarFromSensor(int arrayIndex) {
+    return bitRead(_lastVarFromSensor[arrayIndex / 8], arrayIndex % 8);
+}
+
+
+// Fill in the uniqueness mask for the sensors that are due to be measured on
+// this update and return how many of them there are
+uint8_t VariableArray::buildUpdateMask(bool lastSensorVariable[]) {
+    uint8_t nSensorsToUpdate = 0;
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        // A result another update just finished is used as it is, without
+        // counting down the sensor's interval again
+        lastSensorVariable[i] = isLastVarFromSensor(i) &&
+            !arrayOfVars[i]->parentSensor->hasFreshResult() &&
+            arrayOfVars[i]->parentSensor->checkUpdateDue();
+        if (lastSensorVariable[i]) nSensorsToUpdate++;
+    }
+    MS_DBG(nSensorsToUpdate, F("of"), _sensorCount,
+           F("sensors are due to be updated."));
+    return nSensorsToUpdate;
+}
+
+
+// Mark all of the old calculated values as out of date and then run each
+// calculation once.  Calculated inputs to a calculation are evaluated as they
+// are needed, so the values are computed in dependency order.
+void VariableArray::updateCalculatedVariables(void) {
+    Variable::invalidateCalculatedValues();
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (arrayOfVars[i]->isCalculated) { arrayOfVars[i]->getValue(); }
+    }
+}
+
+
+// Set the values of the sensors that were skipped in this update to -9999,
+// if they've asked for that, are suspended, or keep failing.  Sensors with a
+// shared result pass it on instead.
+void VariableArray::markSkippedSensors(bool lastSensorVariable[]) {
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (!isLastVarFromSensor(i) || lastSensorVariable[i]) continue;
+        if (arrayOfVars[i]->parentSensor->hasFreshResult()) {
+            MS_DBG(F("Using the last result from"),
+                   arrayOfVars[i]->getParentSensorNameAndLocation());
+            arrayOfVars[i]->parentSensor->notifyVariables();
+        } else if (arrayOfVars[i]->parentSensor->getMarkSkippedValues() ||
+                   arrayOfVars[i]->parentSensor->isSuspended() ||
+                   arrayOfVars[i]->parentSensor->isBackingOff()) {
+            arrayOfVars[i]->parentSensor->clearValues();
+            arrayOfVars[i]->parentSensor->notifyVariables();
+        }
+    }
+}
+
+
+// The sensors that the next update will measure, as buildUpdateMask() will
+// find them, without counting any of them down
+uint32_t VariableArray::getPreWarmTime(void) {
+    uint32_t longest = 0;
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (!isLastVarFromSensor(i)) continue;
+        Sensor* sensor = arrayOfVars[i]->parentSensor;
+        if (sensor->hasFreshResult() || !sensor->isUpdateDueNext()) continue;
+        uint32_t lead = sensor->getWarmUpTime() +
+            sensor->getStabilizationTime();
+        if (lead > longest) longest = lead;
+    }
+    return longest;
+}
+
+
+// Each sensor is switched on and woken as late as it can be to be ready when
+// the lead time is up
+bool VariableArray::preWarmSensors(uint32_t leadTime_ms) {
+    bool     success = true;
+    uint32_t start   = millis();
+    bool     pending[_variableCount];
+    bool     powerNow[_variableCount];
+    bool     poweredHere[_variableCount];
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        Sensor* sensor = arrayOfVars[i]->parentSensor;
+        pending[i]     = isLastVarFromSensor(i) && !sensor->hasFreshResult() &&
+            sensor->isUpdateDueNext();
+        poweredHere[i] = false;
+    }
+    MS_DBG(F("Warming up sensors for the update in"), leadTime_ms, F("ms"));
+
+    while (true) {
+        uint32_t elapsed  = millis() - start;
+        uint32_t left     = elapsed < leadTime_ms ? leadTime_ms - elapsed : 0;
+        uint32_t nextDue  = left;
+        bool     anyPower = false;
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            powerNow[i] = false;
+            if (!pending[i]) continue;
+            Sensor*  sensor = arrayOfVars[i]->parentSensor;
+            uint32_t stab   = sensor->getStabilizationTime();
+            uint32_t lead   = sensor->getWarmUpTime() + stab;
+            if (bitRead(sensor->getStatus(), 2) == 0 && !poweredHere[i]) {
+                // Not powered yet
+                if (left <= lead) {
+                    powerNow[i] = true;
+                    anyPower    = true;
+                } else if (left - lead < nextDue) {
+                    nextDue = left - lead;
+                }
+            } else if (sensor->isWarmedUp()) {
+                // Powered and warm; wake it in time to be stable
+                if (left <= stab) {
+                    if (bitRead(sensor->getStatus(), 0) == 0) {
+                        success &= sensor->setup();
+                    }
+                    MS_DBG(F("    Waking"),
+                           arrayOfVars[i]->getParentSensorNameAndLocation(),
+                           F("ahead of the update"));
+                    success &= sensor->wake();
+                    pending[i] = false;
+                } else if (left - stab < nextDue) {
+                    nextDue = left - stab;
+                }
+            } else {
+                uint32_t warmUpLeft = sensor->getWarmUpTimeRemaining();
+                if (warmUpLeft < nextDue) nextDue = warmUpLeft;
+            }
+        }
+        if (anyPower) {
+            powerUpInOrder(powerNow, poweredHere);
+            // A sensor sharing a pin that was already on isn't powered here
+            for (uint8_t i = 0; i < _variableCount; i++) {
+                if (powerNow[i]) poweredHere[i] = true;
+            }
+            continue;
+        }
+        if (left == 0) break;
+        Sensor::idleProcessor(nextDue > 0 ? nextDue : 1);
+    }
+    _preWarmed = true;
+    return success;
+}
+
+
+// This returns the time until a sensor is ready for the next step in its
+// update cycle.  The status bits tell us which step the sensor is waiting on.
+uint32_t VariableArray::getTimeToNextStep(Sensor* sensor) {
+    uint8_t status = sensor->getStatus();
+    // No attempt has been made to wake the sensor; waiting for warm-up
+    if (bitRead(status, 3) == 0) { return sensor->getWarmUpTimeRemaining(); }
+    // The wake failed; the sensor will be skipped on the next pass
+    if (bitRead(status, 4) == 0) { return 0; }
+    // No measurement has been started; waiting for stabilization and for the
+    // sensor to be ready to read again
+    if (bitRead(status, 5) == 0) {
+        uint32_t stabilization = sensor->getStabilizationTimeRemaining();
+        uint32_t interval      = sensor->getIntervalTimeRemaining();
+        return stabilization > interval ? stabilization : interval;
+    }
+    // A measurement has been started; waiting for it to finish
+    return sensor->getMeasurementTimeRemaining();
+}
+
+
+// This returns the time until the first of the unfinished sensors is ready
+uint32_t VariableArray::getTimeToNextDeadline(bool    lastSensorVariable[],
+                                              uint8_t nMeasurementsToAverage[],
+                                              uint8_t nMeasurementsCompleted[]) {
+    uint32_t nextDeadline = 0xFFFFFFFF;
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (lastSensorVariable[i] &&
+            nMeasurementsToAverage[i] > nMeasurementsCompleted[i]) {
+            uint32_t timeToNextStep =
+                getTimeToNextStep(arrayOfVars[i]->parentSensor);
+            if (timeToNextStep < nextDeadline) {
+                nextDeadline = timeToNextStep;
+            }
+            // No reason to keep looking if something is ready now
+            if (nextDeadline == 0) { break; }
+        }
+    }
+    // If nothing is pending, there's nothing to wait for
+    if (nextDeadline == 0xFFFFFFFF) { nextDeadline = 0; }
+    MS_DEEP_DBG(F("Next sensor deadline in"), nextDeadline, F("ms"));
+    return nextDeadline;
+}
+
+
+// The shed levels start at fixed shares of the update's budget
+uint8_t VariableArray::getShedLevel(uint32_t elapsed_ms) {
+    if (_updateBudget_ms == 0) return 0;
+    if (elapsed_ms >= _updateBudget_ms) return 3;
+    if (elapsed_ms >= _updateBudget_ms / 100 * MS_SHED_SENSORS_PERCENT) {
+        return 2;
+    }
+    if (elapsed_ms >= _updateBudget_ms / 100 * MS_SHED_AVERAGING_PERCENT) {
+        return 1;
+    }
+    return 0;
+}
+uint32_t VariableArray::getTimeToNextShed(uint32_t elapsed_ms) {
+    if (_updateBudget_ms == 0) return 0xFFFFFFFF;
+    uint32_t nextShed;
+    switch (getShedLevel(elapsed_ms)) {
+        case 0:
+            nextShed = _updateBudget_ms / 100 * MS_SHED_AVERAGING_PERCENT;
+            break;
+        case 1:
+            nextShed = _updateBudget_ms / 100 * MS_SHED_SENSORS_PERCENT;
+            break;
+        case 2: nextShed = _updateBudget_ms; break;
+        default: return 0xFFFFFFFF;
+    }
+    return nextShed - elapsed_ms;
 }
 
 
@@ -916,16 +1485,42 @@ uint8_t VariableArray::countMaxToAverage(void) {
 }
 
 
+// Each unique sensor is counted once, on the last of its variables
+void VariableArray::printMemoryReport(Print& out) {
+    for (uint8_t i = 0; i < _variableCount; i++) {
+        if (!isLastVarFromSensor(i)) continue;
+        Sensor* sensor = arrayOfVars[i]->parentSensor;
+        MemoryReport::add(out, sensor->getSensorNameAndLocation(),
+                          sensor->getResultBytes());
+    }
+    MemoryReport::add(out, F("Variables and their list"),
+                      _variableCount * (sizeof(Variable) + sizeof(Variable*)));
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    MemoryReport::add(out, F("Variable look up tables"),
+                      sizeof(_keyHashes) + sizeof(_keySlots));
+#endif
+    MemoryReport::add(out, F("Variable array"), sizeof(VariableArray));
+}
+
+
 // Check that all variable have valid UUID's, if they are assigned
 bool VariableArray::checkVariableUUIDs(void) {
-    bool success = true;
+    bool    success = true;
+    uint8_t uuid[16];
+    uint8_t other[16];
     for (uint8_t i = 0; i < _variableCount; i++) {
         if (!arrayOfVars[i]->checkUUIDFormat()) {
             PRINTOUT(arrayOfVars[i]->getVarCode(), F("has an invalid UUID!"));
             success = false;
         }
+        // Compare the raw bytes, so text and binary UUIDs compare alike
+        bool hasUUID = arrayOfVars[i]->getVarUUIDBytes(uuid);
         for (uint8_t j = i + 1; j < _variableCount; j++) {
-            if (arrayOfVars[i]->getVarUUID() == arrayOfVars[j]->getVarUUID()) {
+            bool same = hasUUID
+                ? arrayOfVars[j]->getVarUUIDBytes(other) &&
+                    memcmp(uuid, other, 16) == 0
+                : arrayOfVars[i]->getVarUUID() == arrayOfVars[j]->getVarUUID();
+            if (same) {
                 PRINTOUT(arrayOfVars[i]->getVarCode(),
                          F("has a non-unique UUID!"));
                 success = false;
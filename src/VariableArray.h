@@ -31,6 +31,39 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "MemoryReport.h"
+#include "UpdateTracer.h"
+
+#ifndef MS_SHED_AVERAGING_PERCENT
+/**
+ * @brief The percent of an update's time budget after which sensors with a
+ * result stop taking measurements to average.
+ */
+#define MS_SHED_AVERAGING_PERCENT 60
+#endif
+#ifndef MS_SHED_SENSORS_PERCENT
+/**
+ * @brief The percent of an update's time budget after which sensors that
+ * aren't critical are dropped.
+ */
+#define MS_SHED_SENSORS_PERCENT 80
+#endif
+#ifndef MS_VARIABLE_INDEX_SLOTS
+/**
+ * @brief The number of slots in each of the hash tables used to find
+ * variables by UUID and by code; a power of two, or 0 for none.
+ *
+ * Each slot takes 3 bytes in each of the two tables.  The tables work best
+ * with at least twice as many slots as variables; variables that don't fit
+ * are still found by searching the array.  Without tables, every look up
+ * searches the array.
+ */
+#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+#define MS_VARIABLE_INDEX_SLOTS 0
+#else
+#define MS_VARIABLE_INDEX_SLOTS 128
+#endif
+#endif
 
 
 /**
@@ -172,6 +205,75 @@ class VariableArray {
      * @return **uint8_t** The number of sensors
      */
     uint8_t getSensorCount(void);
+    /**
+     * @brief Get one of the sensors associated with the variables in the
+     * array.
+     *
+     * The sensors are numbered in the order of the last variable from each
+     * one in the array.
+     *
+     * @param sensorNumber The number of the sensor, from 0 to one less than
+     * getSensorCount()
+     * @return **Sensor*** The sensor; nullptr if there is no such sensor
+     */
+    Sensor* getSensor(uint8_t sensorNumber);
+    /**
+     * @brief Get the time taken by the last completeUpdate().
+     *
+     * To log or publish this, wrap it in the calculation function of a
+     * calculated variable.
+     *
+     * @return **uint32_t** The duration of the last complete update in
+     * milliseconds
+     */
+    uint32_t getLastUpdateTime(void) {
+        return _lastUpdateTime_ms;
+    }
+    /**
+     * @brief Set the longest the next complete update may take.
+     *
+     * As the update runs short of time, work is dropped in steps: past
+     * #MS_SHED_AVERAGING_PERCENT of the budget, sensors with at least one
+     * result stop averaging; past #MS_SHED_SENSORS_PERCENT, sensors that
+     * aren't critical are dropped; and at the end of the budget every sensor
+     * still unfinished is dropped.  Dropped sensors are put to sleep and
+     * powered down, and report whatever they measured, or -9999.
+     *
+     * The budget applies to the next completeUpdate() only.
+     *
+     * @param budget_ms The time budget in milliseconds; 0 for no limit
+     */
+    void setUpdateBudget(uint32_t budget_ms) {
+        _updateBudget_ms = budget_ms;
+    }
+    /**
+     * @brief Set the time between complete updates of the array.
+     *
+     * Sensors given their currents with Sensor::setPowerCosts() are kept
+     * powered after an update when idling for this long, until their next
+     * update, costs less than warming them up again.  The Logger sets this
+     * before each update from its logging interval.
+     *
+     * @param period_ms The time between updates in milliseconds; 0 (the
+     * default) to power every sensor down after its update
+     */
+    void setUpdatePeriod(uint32_t period_ms) {
+        _updatePeriod_ms = period_ms;
+    }
+    /**
+     * @brief Set the time to wait after switching on the power pin of one
+     * sensor before switching on the next.
+     *
+     * Sensors on a PowerRail wait for the rail's own inrush time instead.
+     * Either way, the sensors with the longest warm-up times are powered
+     * first.
+     *
+     * @param stagger_ms The time in milliseconds; 0 (the default) to switch
+     * them all at once
+     */
+    void setPowerStagger(uint16_t stagger_ms) {
+        _powerStagger_ms = stagger_ms;
+    }
 
     /**
      * @brief Match UUID's from the given variables in the variable array.
@@ -182,6 +284,27 @@ class VariableArray {
      * @param uuids An array of UUID's
      */
     void matchUUIDs(const char* uuids[]);
+    /**
+     * @brief Find the variable with the given UUID.
+     *
+     * The UUIDs are indexed in a hash table by begin(), so this doesn't
+     * search the array; see #MS_VARIABLE_INDEX_SLOTS.  The case of the hex
+     * digits doesn't matter.
+     *
+     * @param uuid The UUID text
+     * @return **Variable*** The variable; nullptr if none has the UUID
+     */
+    Variable* findByUUID(const char* uuid);
+    /**
+     * @brief Find the variable with the given code.
+     *
+     * The codes are indexed in a hash table by begin(), like the UUIDs.  If
+     * several variables share a code, the first in the array is found.
+     *
+     * @param varCode The variable code
+     * @return **Variable*** The variable; nullptr if none has the code
+     */
+    Variable* findByCode(const char* varCode);
 
     // Public functions for interfacing with a list of sensors
     /**
@@ -193,6 +316,13 @@ class VariableArray {
      * respond to its setup command, the command is called 5 times in attempt to
      * make a connection.  If all sensors are set up successfully, returns true.
      *
+     * All of the sensors are powered up together and each is set up as soon
+     * as it is warmed up, so the whole setup takes about as long as the
+     * slowest sensor rather than the sum of all of them.  Sensors powered up
+     * here are powered down again at the end.  Sensors with
+     * Sensor::setDeferredSetup() are skipped and set up in their first
+     * complete update instead.
+     *
      * @return **bool** True indicates all sensors have been set up
      * successfully.
      */
@@ -201,7 +331,10 @@ class VariableArray {
     /**
      * @brief Power up each sensor.
      *
-     * Runs the powerUp sensor function for each unique sensor.
+     * Runs the powerUp sensor function for each unique sensor, the ones with
+     * the longest warm-up times first.  A sensor switching on a power pin or
+     * rail waits out the inrush of the last one switched on first; see
+     * setPowerStagger() and PowerRail.
      */
     void sensorsPowerUp(void);
 
@@ -234,8 +367,9 @@ class VariableArray {
      * @brief Update the values for all connected sensors.
      *
      * Does not power or wake/sleep sensors.  Returns a boolean indication the
-     * overall success.  Does NOT return any values.  Repeatedly checks each
-     * sensor's readiness state to optimize timing.
+     * overall success.  Does NOT return any values.  Each sensor is serviced as
+     * soon as it is ready; between those deadlines the processor is put into
+     * idle mode rather than continuously re-checking every sensor.
      *
      * @return **bool** True if all steps of the update succeeded.
      */
@@ -248,13 +382,38 @@ class VariableArray {
      * them and waking and putting them to sleep.
      *
      * Returns a boolean indication the overall success.  Does NOT return any
-     * values.  Repeatedly checks each sensor's readiness state to optimize
-     * timing.
+     * values.  Each sensor is serviced as soon as it is ready; between those
+     * deadlines the processor is put into idle mode rather than continuously
+     * re-checking every sensor.
      *
      * @return **bool** True if all steps of the update succeeded.
      */
     bool completeUpdate(void);
 
+    /**
+     * @brief Get how long before the next update its sensors need to be
+     * powered for them all to be warmed up and stable at its start.
+     *
+     * @return **uint32_t** The longest warm-up plus stabilization time of the
+     * sensors due in the next update, in milliseconds
+     */
+    uint32_t getPreWarmTime(void);
+    /**
+     * @brief Power up and wake the sensors due in the next update ahead of
+     * it, so they are stable when it starts.
+     *
+     * Each sensor is powered its warm-up plus stabilization time before the
+     * end of the lead time, and woken its stabilization time before it, so no
+     * sensor is on for longer than it has to be.  This returns at the end of
+     * the lead time, idling the processor in between.  The next
+     * completeUpdate() then starts measuring the sensors right away, without
+     * powering them up again.
+     *
+     * @param leadTime_ms The time until the update, in milliseconds
+     * @return **bool** True if every sensor woke
+     */
+    bool preWarmSensors(uint32_t leadTime_ms);
+
     /**
      * @brief Print out the results for all connected sensors to a stream
      *
@@ -268,6 +427,14 @@ class VariableArray {
      */
     void printSensorData(Stream* stream = &Serial);
 
+    /**
+     * @brief Print the RAM taken by each sensor and by the variables, and add
+     * them to the MemoryReport.
+     *
+     * @param out The stream to print to
+     */
+    void printMemoryReport(Print& out);
+
  protected:
     /**
      * @brief The count of variables in the array
@@ -281,12 +448,177 @@ class VariableArray {
      * @brief The maximum number of samples to average of an single sensor.
      */
     uint8_t _maxSamplestoAverage;
+    /**
+     * @brief The duration of the last complete update in milliseconds.
+     */
+    uint32_t _lastUpdateTime_ms = 0;
+    /**
+     * @brief The time budget of the next complete update in milliseconds; 0
+     * for no limit.
+     */
+    uint32_t _updateBudget_ms = 0;
+    /**
+     * @brief The time to wait after switching a sensor's power pin on
+     */
+    uint16_t _powerStagger_ms = 0;
+    /**
+     * @brief True once preWarmSensors() has powered the sensors for the next
+     * update
+     */
+    bool _preWarmed = false;
+    /**
+     * @brief The time between complete updates in milliseconds; 0 if unknown
+     */
+    uint32_t _updatePeriod_ms = 0;
+    /**
+     * @brief True once a complete update has left sensors powered for the
+     * next one, until sensorsPowerDown() powers them all down
+     */
+    bool _keptPowered = false;
 
  private:
+    /**
+     * @brief A bitmask with one bit for each variable in the array, set if the
+     * variable is the last one in the array from its parent sensor.
+     *
+     * This is built once by buildSensorIndex() so the update loops don't need
+     * to search the whole array for each variable on every pass.
+     */
+    uint8_t _lastVarFromSensor[32] = {0};
+    /**
+     * @brief Build the unique sensor bitmask for the current list of
+     * variables.
+     */
+    void    buildSensorIndex(void);
+    /**
+     * @brief Get the UUID or code of a variable as text.
+     *
+     * @param arrayIndex The position of the variable in the array
+     * @param byUUID True for the UUID, false for the code
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer
+     * @return **bool** True if the variable has the key and it fit
+     */
+    bool getLookupKey(uint8_t arrayIndex, bool byUUID, char* buffer,
+                      size_t bufferSize);
+    /**
+     * @brief Find a variable by its UUID or code.
+     *
+     * @param key The UUID or code
+     * @param byUUID True to find by UUID, false by code
+     * @return **Variable*** The variable; nullptr if there is none
+     */
+    Variable* findByKey(const char* key, bool byUUID);
+    /**
+     * @brief Hash a UUID or code; 32 bit FNV-1a folded to 16 bits.
+     *
+     * @param key The UUID or code
+     * @param foldCase True to ignore the case of letters, for UUIDs
+     * @return **uint16_t** The hash
+     */
+    static uint16_t hashKey(const char* key, bool foldCase);
+#if MS_VARIABLE_INDEX_SLOTS > 0
+    /**
+     * @brief Build the hash tables of the variable UUIDs and codes.
+     */
+    void buildLookupIndex(void);
+    /**
+     * @brief The hashes of the keys in each slot of the UUID (0) and code (1)
+     * tables
+     */
+    uint16_t _keyHashes[2][MS_VARIABLE_INDEX_SLOTS];
+    /**
+     * @brief One more than the position in the array of the variable in each
+     * slot of the UUID (0) and code (1) tables; 0 for an empty slot
+     */
+    uint8_t _keySlots[2][MS_VARIABLE_INDEX_SLOTS];
+    /**
+     * @brief False if a table filled up before every variable was added to
+     * it, or if it hasn't been built
+     */
+    bool _indexComplete[2] = {false, false};
+#endif
     bool    isLastVarFromSensor(int arrayIndex);
+    /**
+     * @brief Fill a uniqueness mask for only those sensors which are due to be
+     * measured on this update.
+     *
+     * This counts down each sensor's update interval, so it must be called
+     * exactly once per update.
+     *
+     * @param lastSensorVariable The mask to fill, one entry per variable
+     * @return **uint8_t** The number of sensors to be measured on this update
+     */
+    uint8_t buildUpdateMask(bool lastSensorVariable[]);
+    /**
+     * @brief Power up the sensors in a mask, longest warm-up first, waiting
+     * out the inrush of each power pin or rail switched on before switching
+     * the next.
+     *
+     * @param lastSensorVariable The sensors to power, one entry per variable
+     * as filled by buildUpdateMask()
+     * @param poweredHere If not nullptr, sensors that already have power are
+     * skipped and the entry of each sensor powered up is set
+     */
+    void powerUpInOrder(const bool lastSensorVariable[],
+                        bool       poweredHere[] = nullptr);
+    /**
+     * @brief Set the values of any sensors skipped in this update to -9999, if
+     * the sensor asked to mark skipped values.
+     *
+     * @param lastSensorVariable The mask of sensors measured in this update
+     */
+    void markSkippedSensors(bool lastSensorVariable[]);
+    /**
+     * @brief Mark all calculated values as out of date and evaluate each of the
+     * calculated variables in the array once.
+     */
+    void updateCalculatedVariables(void);
     uint8_t countMaxToAverage(void);
     bool    checkVariableUUIDs(void);
 
+    /**
+     * @brief Get the number of milliseconds until a sensor will be ready for
+     * its next step in the update cycle - wake, start a measurement, or
+     * collect a result.
+     *
+     * @param sensor The sensor to check
+     * @return **uint32_t** The time in milliseconds until the next deadline
+     * for the sensor; 0 if the sensor is ready now.
+     */
+    uint32_t getTimeToNextStep(Sensor* sensor);
+    /**
+     * @brief Get the number of milliseconds until any sensor with unfinished
+     * measurements will be ready for its next step.
+     *
+     * @param lastSensorVariable The uniqueness mask for each variable
+     * @param nMeasurementsToAverage The number of measurements to take from
+     * each variable's sensor
+     * @param nMeasurementsCompleted The number of measurements already
+     * completed by each variable's sensor
+     * @return **uint32_t** The time in milliseconds until the soonest deadline;
+     * 0 if any sensor is ready now.
+     */
+    uint32_t getTimeToNextDeadline(bool    lastSensorVariable[],
+                                   uint8_t nMeasurementsToAverage[],
+                                   uint8_t nMeasurementsCompleted[]);
+    /**
+     * @brief Get how much work an update must drop to fit its time budget.
+     *
+     * @param elapsed_ms The time since the update started
+     * @return **uint8_t** 0 to drop nothing, 1 to stop averaging, 2 to also
+     * drop sensors that aren't critical, or 3 to drop every sensor.
+     */
+    uint8_t getShedLevel(uint32_t elapsed_ms);
+    /**
+     * @brief Get the time until an update must drop more of its work.
+     *
+     * @param elapsed_ms The time since the update started
+     * @return **uint32_t** The time in milliseconds until the next shed level;
+     * 0xFFFFFFFF if there is no budget or nothing more to drop.
+     */
+    uint32_t getTimeToNextShed(uint32_t elapsed_ms);
+
 #ifdef MS_VARIABLEARRAY_DEBUG_DEEP
     /**
      * @brief Prints out the contents of an array with even spaces and commas
@@ -313,4 +645,56 @@ class VariableArray {
 #endif  // DEEP_DEBUGGING_SERIAL_OUTPUT
 };
 
+
+/**
+ * @brief A variable array whose number of variables is fixed when the program
+ * is compiled, holding its own list of the variables.
+ *
+ * This is a VariableArray, so it's given to a Logger in the same way.  The
+ * variables are given straight to the constructor, so there is no separate
+ * list of pointers to keep the count of in step with.  The count is checked
+ * against the template parameter when the program is compiled.  The list is
+ * part of the object, with no heap.
+ *
+ * @code{cpp}
+ * StaticVariableArray<3> varArray(new ProcessorStats_Battery(&mcuBoard),
+ *                                 new MaximDS3231_Temp(&ds3231),
+ *                                 new Modem_RSSI(&modem));
+ * @endcode
+ *
+ * As for a VariableArray, the table of unique sensors is built once, when
+ * the array is begun, and not on each update.
+ *
+ * @tparam variableCount The number of variables in the array
+ *
+ * @ingroup base_classes
+ */
+template <uint8_t variableCount>
+class StaticVariableArray : public VariableArray {
+ public:
+    /**
+     * @brief Construct a new static variable array object
+     *
+     * @tparam Variables The types of the variables
+     * @param variables Pointers to the variable objects.  The pointers may be
+     * to calculated or measured variable objects.  There must be exactly
+     * `variableCount` of them.
+     */
+    template <typename... Variables>
+    explicit StaticVariableArray(Variables*... variables)
+        : VariableArray(),
+          _variables{variables...} {
+        static_assert(sizeof...(Variables) == variableCount,
+                      "The number of variables must match the array size");
+        arrayOfVars    = _variables;
+        _variableCount = variableCount;
+    }
+
+ private:
+    /**
+     * @brief The list of the variables
+     */
+    Variable* _variables[variableCount];
+};
+
 #endif  // SRC_VARIABLEARRAY_H_
@@ -9,11 +9,16 @@
 
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "LoggerBase.h"
+#include "VariableHistory.h"
 
 // ============================================================================
 //  The class and functions for interfacing with a specific variable.
 // ============================================================================
 
+// Initialize the static count of sensor updates
+uint32_t Variable::_updateNumber = 0;
+
 // The constructor for a measured variable - that is, one whose values are
 // updated by a sensor.
 Variable::Variable(Sensor* parentSense, const uint8_t sensorVarNum,
@@ -83,6 +88,11 @@ Variable* Variable::begin(Sensor* parentSense, const char* uuid) {
     setVarUUID(uuid);
     return begin(parentSense);
 }
+Variable* Variable::begin(Sensor* parentSense,
+                          const __FlashStringHelper* uuid) {
+    setVarUUID(uuid);
+    return begin(parentSense);
+}
 Variable* Variable::begin(Sensor* parentSense) {
     attachSensor(parentSense);
     return this;
@@ -122,15 +132,101 @@ void Variable::attachSensor(Sensor* parentSense) {
 // This function should never be called for a calculated variable
 void Variable::onSensorUpdate(Sensor* parentSense) {
     if (!isCalculated) {
-        _currentValue = parentSense->sensorValues[_sensorVarNum];
+        switch (_statistic) {
+#if defined(MS_SENSOR_STATISTICS)
+            case VariableStatistic::stdDev:
+                _currentValue = parentSense->getResultStdDev(_sensorVarNum);
+                break;
+            case VariableStatistic::minimum:
+                _currentValue = parentSense->getResultMin(_sensorVarNum);
+                break;
+            case VariableStatistic::maximum:
+                _currentValue = parentSense->getResultMax(_sensorVarNum);
+                break;
+            case VariableStatistic::count:
+                _currentValue = parentSense->getResultCount(_sensorVarNum);
+                break;
+#endif
+            case SensorTimingVariable::warmUp:
+                _currentValue = parentSense->getLastWarmUpTime();
+                break;
+            case SensorTimingVariable::stabilization:
+                _currentValue = parentSense->getLastStabilizationTime();
+                break;
+            case SensorTimingVariable::measurement:
+                _currentValue = parentSense->getLastMeasurementTime();
+                break;
+            case SensorHealthVariable::failures:
+                _currentValue = parentSense->getConsecutiveFailures();
+                break;
+            default:
+                _currentValue = parentSense->sensorValues[_sensorVarNum];
+                break;
+        }
         MS_DBG(F("... received"), _currentValue);
+        // Pass the update along the sensor's list of statistic variables
+        if (_nextStatVariable != nullptr) {
+            _nextStatVariable->onSensorUpdate(parentSense);
+        }
     }
 }
 
 
+// This ties a statistic variable to its parent sensor without taking the
+// place of the variable for the result itself
+void Variable::attachSensorStatistic(Sensor* parentSense, uint8_t statistic) {
+    _statistic        = statistic;
+    parentSensor      = parentSense;
+    _nextStatVariable = parentSensor->registerStatisticVariable(this);
+}
+
+
+// This makes a calculated variable an aggregate of another variable
+void Variable::attachAggregate(Variable* source, uint8_t statistic) {
+    _statistic         = statistic;
+    _varName           = source->_varName;
+    _varUnit           = source->_varUnit;
+    _decimalResolution = source->_decimalResolution;
+    _inFlash           = (_inFlash & ~(nameInFlash | unitInFlash)) |
+        (source->_inFlash & (nameInFlash | unitInFlash));
+    if (statistic == AggregateVariable::count) {
+        setVarUnit("count");
+        _decimalResolution = 0;
+    }
+}
+
+
+// A calculation is only as fresh as its oldest input
+uint32_t Variable::getValueTime(void) {
+    if (!isCalculated) {
+        return parentSensor != nullptr ? parentSensor->getResultTime() : 0;
+    }
+    if (_isCalculating) return 0;
+    _isCalculating  = true;
+    uint32_t oldest = 0;
+    for (uint8_t i = 0; i < _nCalcInputs; i++) {
+        uint32_t inputTime = _calcInputs[i]->getValueTime();
+        if (inputTime != 0 && (oldest == 0 || inputTime < oldest)) {
+            oldest = inputTime;
+        }
+    }
+    _isCalculating = false;
+    return oldest;
+}
+bool Variable::isValueStale(uint32_t maxAgeSeconds) {
+    uint32_t valueTime = getValueTime();
+    return valueTime != 0 &&
+        Logger::markedUTCEpochTime - valueTime > maxAgeSeconds;
+}
+
+
 // This is a helper - it returns the name of the parent sensor, if applicable
 // This is needed for dealing with variables in arrays
+#if defined(MS_NO_STRING)
+const char* Variable::getParentSensorName(void) {
+#else
 String Variable::getParentSensorName(void) {
+#endif
     if (isCalculated) {
         return "Calculated";
     } else if (parentSensor == nullptr) {
@@ -140,11 +236,21 @@ String Variable::getParentSensorName(void) {
         return parentSensor->getSensorName();
     }
 }
+// This prints the parent sensor name straight from the sensor
+size_t Variable::printParentSensorName(Print& out) {
+    if (isCalculated) return out.print(F("Calculated"));
+    if (parentSensor == nullptr) return 0;
+    return parentSensor->printSensorName(out);
+}
 
 
 // This is a helper - it returns the name and location of the parent sensor, if
 // applicable This is needed for dealing with variables in arrays
+#if defined(MS_NO_STRING)
+const char* Variable::getParentSensorNameAndLocation(void) {
+#else
 String Variable::getParentSensorNameAndLocation(void) {
+#endif
     if (isCalculated) {
         return "Calculated";
     } else if (parentSensor == nullptr) {
@@ -162,6 +268,23 @@ void Variable::setCalculation(float (*calcFxn)()) {
 }
 
 
+// This sets the variables used as inputs to a calculated variable
+void Variable::setCalculationInputs(Variable* calcInputs[], uint8_t nInputs) {
+    if (isCalculated) {
+        _calcInputs  = calcInputs;
+        _nCalcInputs = nInputs;
+    }
+}
+
+
+// This marks all cached calculated values as out of date
+void Variable::invalidateCalculatedValues(void) {
+    _updateNumber++;
+    // Skip zero on roll-over, it means nothing is cached
+    if (_updateNumber == 0) _updateNumber = 1;
+}
+
+
 // This gets/sets the variable's resolution for value strings
 uint8_t Variable::getResolution(void) {
     return _decimalResolution;
@@ -173,68 +296,226 @@ void Variable::setResolution(uint8_t decimalResolution) {
 // This gets/sets the variable's name using
 // http://vocabulary.odm2.org/variablename/
 String Variable::getVarName(void) {
-    return _varName;
+    return fieldString(_varName, nameInFlash);
+}
+size_t Variable::printVarName(Print& out) {
+    return printField(out, _varName, nameInFlash);
 }
 void Variable::setVarName(const char* varName) {
     _varName = varName;
+    _inFlash &= ~nameInFlash;
+}
+void Variable::setVarName(const __FlashStringHelper* varName) {
+    _varName = reinterpret_cast<const char*>(varName);
+    _inFlash |= nameInFlash;
 }
 
 // This gets/sets the variable's unit using http://vocabulary.odm2.org/units/
 String Variable::getVarUnit(void) {
-    return _varUnit;
+    return fieldString(_varUnit, unitInFlash);
+}
+size_t Variable::printVarUnit(Print& out) {
+    return printField(out, _varUnit, unitInFlash);
 }
 void Variable::setVarUnit(const char* varUnit) {
     _varUnit = varUnit;
+    _inFlash &= ~unitInFlash;
+}
+void Variable::setVarUnit(const __FlashStringHelper* varUnit) {
+    _varUnit = reinterpret_cast<const char*>(varUnit);
+    _inFlash |= unitInFlash;
 }
 
 // This returns a customized code for the variable
 String Variable::getVarCode(void) {
-    return _varCode;
+    return fieldString(_varCode, codeInFlash);
+}
+size_t Variable::printVarCode(Print& out) {
+    return printField(out, _varCode, codeInFlash);
+}
+uint8_t Variable::formatVarCode(char* buffer, size_t bufferSize) {
+    return copyField(_varCode, codeInFlash, buffer, bufferSize);
 }
 // This sets the variable code to a new custom value
 void Variable::setVarCode(const char* varCode) {
     _varCode = varCode;
+    _inFlash &= ~codeInFlash;
+}
+void Variable::setVarCode(const __FlashStringHelper* varCode) {
+    _varCode = reinterpret_cast<const char*>(varCode);
+    _inFlash |= codeInFlash;
 }
 
 // This returns the variable UUID, if one has been assigned
 String Variable::getVarUUID(void) {
-    return _uuid;
+    if (_uuidIsBytes) {
+        char uuid[37];
+        formatVarUUID(uuid, sizeof(uuid));
+        return String(uuid);
+    }
+    return fieldString(_uuid, uuidInFlash);
+}
+size_t Variable::printVarUUID(Print& out) {
+    if (_uuidIsBytes) {
+        char uuid[37];
+        formatVarUUID(uuid, sizeof(uuid));
+        return out.print(uuid);
+    }
+    return printField(out, _uuid, uuidInFlash);
 }
 // This sets the UUID
 void Variable::setVarUUID(const char* uuid) {
-    _uuid = uuid;
+    _uuid        = uuid;
+    _uuidIsBytes = false;
+    _inFlash &= ~uuidInFlash;
+}
+void Variable::setVarUUID(const __FlashStringHelper* uuid) {
+    _uuid        = reinterpret_cast<const char*>(uuid);
+    _uuidIsBytes = false;
+    _inFlash |= uuidInFlash;
+}
+void Variable::setVarUUID(const uint8_t* uuidBytes) {
+    _uuid        = reinterpret_cast<const char*>(uuidBytes);
+    _uuidIsBytes = true;
+    _inFlash &= ~uuidInFlash;
+}
+// The text is copied out of flash to be read
+bool Variable::getVarUUIDBytes(uint8_t* bytes) {
+    if (_uuid == nullptr) return false;
+    if (_uuidIsBytes) {
+        memcpy(bytes, _uuid, 16);
+        return true;
+    }
+    char uuid[37];
+    if (_inFlash & uuidInFlash) {
+        strncpy_P(uuid, _uuid, sizeof(uuid) - 1);
+    } else {
+        strncpy(uuid, _uuid, sizeof(uuid) - 1);
+    }
+    uuid[sizeof(uuid) - 1] = '\0';
+    return parseUUID(uuid, bytes);
+}
+uint8_t Variable::formatVarUUID(char* buffer, size_t bufferSize) {
+    if (_uuidIsBytes && _uuid != nullptr) {
+        if (bufferSize < 37) return 0;
+        formatUUID(reinterpret_cast<const uint8_t*>(_uuid), buffer);
+        return 36;
+    }
+    return copyField(_uuid, uuidInFlash, buffer, bufferSize);
 }
 // This checks that the UUID is properly formatted
 bool Variable::checkUUIDFormat(void) {
-    // If no UUID, move on
-    if (strlen(_uuid) == 0) { return true; }
+    // If no UUID, move on; raw bytes are always a UUID
+    if (_uuid == nullptr || _uuidIsBytes) { return true; }
+
+    // Work on a copy, one character longer than a UUID to catch long ones
+    char uuid[38];
+    if (_inFlash & uuidInFlash) {
+        strncpy_P(uuid, _uuid, sizeof(uuid) - 1);
+    } else {
+        strncpy(uuid, _uuid, sizeof(uuid) - 1);
+    }
+    uuid[sizeof(uuid) - 1] = '\0';
+    if (strlen(uuid) == 0) { return true; }
 
     // Should be 36 characters long with dashes
-    if (strlen(_uuid) != 36) {
-        MS_DBG(F("UUID length for"), getVarCode(), '(', _uuid, ')',
-               F("is incorrect, should be 36 characters not"), strlen(_uuid));
+    if (strlen(uuid) != 36) {
+        MS_DBG(F("UUID length for"), getVarCode(), '(', uuid, ')',
+               F("is incorrect, should be 36 characters not"), strlen(uuid));
         return false;
     }
 
     // "12345678-abcd-1234-ef00-1234567890ab"
     const char* acceptableChars = "0123456789abcdefABCDEF-";
-    if (_uuid[8] != '-' || _uuid[13] != '-' || _uuid[18] != '-' ||
-        _uuid[23] != '-') {
-        MS_DBG(F("UUID format for"), getVarCode(), '(', _uuid, ')',
+    if (uuid[8] != '-' || uuid[13] != '-' || uuid[18] != '-' ||
+        uuid[23] != '-') {
+        MS_DBG(F("UUID format for"), getVarCode(), '(', uuid, ')',
                F("is incorrect, expecting dashes at positions 9, 14, 19, and "
                  "24."));
         return false;
     }
-    int first_invalid = strspn(_uuid, acceptableChars);
+    int first_invalid = strspn(uuid, acceptableChars);
     if (first_invalid != 36) {
-        MS_DBG(F("UUID for"), getVarCode(), '(', _uuid, ')',
-               F("has a bad character"), _uuid[first_invalid], F("at"), first_invalid);
+        MS_DBG(F("UUID for"), getVarCode(), '(', uuid, ')',
+               F("has a bad character"), uuid[first_invalid], F("at"),
+               first_invalid);
         return false;
     }
     return true;
 }
 
 
+// The dashes must be in the usual places, as checked by checkUUIDFormat()
+bool Variable::parseUUID(const char* text, uint8_t* bytes) {
+    if (strlen(text) != 36) return false;
+    uint8_t nDigits = 0;
+    for (uint8_t c = 0; c < 36; c++) {
+        if (c == 8 || c == 13 || c == 18 || c == 23) {
+            if (text[c] != '-') return false;
+            continue;
+        }
+        uint8_t digit;
+        if (text[c] >= '0' && text[c] <= '9') {
+            digit = text[c] - '0';
+        } else if (text[c] >= 'a' && text[c] <= 'f') {
+            digit = text[c] - 'a' + 10;
+        } else if (text[c] >= 'A' && text[c] <= 'F') {
+            digit = text[c] - 'A' + 10;
+        } else {
+            return false;
+        }
+        if (nDigits % 2 == 0) {
+            bytes[nDigits / 2] = digit << 4;
+        } else {
+            bytes[nDigits / 2] |= digit;
+        }
+        nDigits++;
+    }
+    return true;
+}
+void Variable::formatUUID(const uint8_t* bytes, char* buffer) {
+    const char* hexDigits = "0123456789abcdef";
+    uint8_t     c         = 0;
+    for (uint8_t b = 0; b < 16; b++) {
+        if (b == 4 || b == 6 || b == 8 || b == 10) buffer[c++] = '-';
+        buffer[c++] = hexDigits[bytes[b] >> 4];
+        buffer[c++] = hexDigits[bytes[b] & 0x0F];
+    }
+    buffer[c] = '\0';
+}
+
+
+// A field in flash is read out of it into the String
+String Variable::fieldString(const char* text, flashField field) {
+    if (text == nullptr) return String();
+    if (_inFlash & field) {
+        return String(reinterpret_cast<const __FlashStringHelper*>(text));
+    }
+    return String(text);
+}
+size_t Variable::printField(Print& out, const char* text, flashField field) {
+    if (text == nullptr) return 0;
+    if (_inFlash & field) {
+        return out.print(reinterpret_cast<const __FlashStringHelper*>(text));
+    }
+    return out.print(text);
+}
+uint8_t Variable::copyField(const char* text, flashField field, char* buffer,
+                            size_t bufferSize) {
+    if (bufferSize == 0) return 0;
+    buffer[0] = '\0';
+    if (text == nullptr) return 0;
+    size_t len = (_inFlash & field) ? strlen_P(text) : strlen(text);
+    if (len >= bufferSize) return 0;
+    if (_inFlash & field) {
+        strcpy_P(buffer, text);
+    } else {
+        strcpy(buffer, text);
+    }
+    return len;
+}
+
+
 // This returns the current value of the variable as a float
 float Variable::getValue(bool updateValue) {
     if (isCalculated) {
@@ -242,7 +523,32 @@ float Variable::getValue(bool updateValue) {
         // the calculation because we don't know which sensors those are.
         // Make sure you update the parent sensors manually for a calculated
         // variable!!
-        return _calcFxn();
+        // The result is cached until the next update of the sensor values so
+        // the calculation isn't repeated for every use of the value.
+        if (updateValue || _updateNumber == 0 ||
+            _calcUpdateNumber != _updateNumber) {
+            if (_isCalculating) {
+                MS_DBG(F("ERROR! Circular calculation for"), getVarCode());
+                return _currentValue;
+            }
+            _isCalculating = true;
+            // Evaluate any calculated inputs first
+            for (uint8_t i = 0; i < _nCalcInputs; i++) {
+                if (_calcInputs[i]->isCalculated) _calcInputs[i]->getValue();
+            }
+            // Variables set by their owner, like publisher metrics, have no
+            // calculation to run
+            if (_statistic >= DerivedVariable::expMean) {
+                static_cast<DerivedVariable*>(this)->update();
+            } else if (_statistic >= AggregateVariable::mean) {
+                static_cast<AggregateVariable*>(this)->addSample();
+            } else if (_calcFxn != nullptr) {
+                _currentValue = _calcFxn();
+            }
+            _calcUpdateNumber = _updateNumber;
+            _isCalculating    = false;
+        }
+        return _currentValue;
     } else {
         if (updateValue) parentSensor->update();
         return _currentValue;
@@ -252,12 +558,288 @@ float Variable::getValue(bool updateValue) {
 
 // This returns the current value of the variable as a string
 // with the correct number of significant figures
+#if defined(MS_NO_STRING)
+const char* Variable::getValueString(bool updateValue) {
+    static char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    formatValue(valueBuffer, sizeof(valueBuffer), updateValue);
+    return valueBuffer;
+}
+#else
 String Variable::getValueString(bool updateValue) {
-    // Need this because otherwise get extra spaces in strings from int
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    formatValue(valueBuffer, sizeof(valueBuffer), updateValue);
+    return String(valueBuffer);
+}
+#endif
+
+
+// This writes the current value of the variable into a buffer with the correct
+// number of significant figures
+size_t Variable::formatValue(char* buffer, size_t bufferLen, bool updateValue) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    return formatValue(getValue(updateValue), buffer, bufferLen);
+}
+// This writes a value with 0 to 6 decimal places by scaling the float's
+// mantissa to a whole number of the last decimal place, rounded half away from
+// zero like dtostrf.  The digits are made by subtracting powers of ten, as
+// divisions take a library call on AVR and SAMD21 boards.  It returns 0 for
+// values of 2^23 or more, infinities and NaN, which are left to dtostrf.
+static size_t formatFixedPoint(float value, uint8_t decimals, char* buffer) {
+    static const uint32_t scales[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    static const uint32_t powers[] = {1000000000, 100000000, 10000000,
+                                      1000000,    100000,    10000,
+                                      1000,       100,       10,
+                                      1};
+    if (decimals > 6) return 0;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t exponent = (bits >> 23) & 0xFF;
+    if (exponent >= 150) return 0;
+
+    // The value is the 24-bit mantissa over 2^shift; anything under 2^-21,
+    // including zero and the subnormals, rounds to 0 at any resolution
+    uint32_t whole = 0;
+    uint8_t  shift = 150 - exponent;
+    if (exponent > 0 && shift < 45) {
+        uint64_t scaled = static_cast<uint64_t>((bits & 0x7FFFFF) | 0x800000) *
+            scales[decimals];
+        scaled = (scaled + (1ULL << (shift - 1))) >> shift;
+        if (scaled > 0xFFFFFFFFUL) return 0;
+        whole = scaled;
+    }
+
+    size_t len = 0;
+    if (bits & 0x80000000UL) buffer[len++] = '-';
+    bool started = false;
+    for (uint8_t i = 0; i < 10; i++) {
+        uint8_t below = 9 - i;
+        char    digit = '0';
+        while (whole >= powers[i]) {
+            whole -= powers[i];
+            digit++;
+        }
+        // Leading zeros are skipped down to the ones place
+        if (!started && digit == '0' && below > decimals) continue;
+        started       = true;
+        buffer[len++] = digit;
+        if (below == decimals && decimals > 0) buffer[len++] = '.';
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+
+// This writes any value into a buffer with this variable's resolution
+size_t Variable::formatValue(float value, char* buffer, size_t bufferLen) {
+    if (buffer == nullptr || bufferLen == 0) return 0;
+    // Format into a buffer that is always big enough, then copy as much as
+    // fits into the caller's buffer
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
     if (_decimalResolution == 0) {
-        auto val = static_cast<int16_t>(getValue(updateValue));
-        return String(val);
-    } else {
-        return String(getValue(updateValue), _decimalResolution);
+        // Need this because otherwise get extra spaces in strings from int
+        itoa(static_cast<int16_t>(value), valueBuffer, 10);
+    } else if (!formatFixedPoint(value, _decimalResolution, valueBuffer)) {
+        // NOTE:  printf on AVR doesn't support floats; the String class also
+        // uses dtostrf
+        dtostrf(value, 1, _decimalResolution, valueBuffer);
+    }
+    strncpy(buffer, valueBuffer, bufferLen - 1);
+    buffer[bufferLen - 1] = '\0';
+    return strlen(buffer);
+}
+
+
+// ============================================================================
+//  The functions for aggregating a variable over a window of time
+// ============================================================================
+
+AggregateVariable::AggregateVariable(Variable* source, aggregate stat,
+                                     uint16_t    windowMinutes,
+                                     const char* uuid, const char* varCode)
+    : Variable(static_cast<float (*)()>(nullptr), 0, "", "", varCode, uuid),
+      _source(source),
+      _stat(stat),
+      _windowSeconds(static_cast<uint32_t>(windowMinutes) * 60) {
+    if (_windowSeconds == 0) _windowSeconds = 60;
+    attachAggregate(source, stat);
+    setCalculationInputs(&_source, 1);
+}
+
+
+// This adds the source's value to the window, after reporting the window if
+// it's over
+void AggregateVariable::addSample(void) {
+    // Only take one value for each logging interval
+    uint32_t now = Logger::markedLocalEpochTime;
+    if (now == 0 || now == _lastSample) return;
+    _lastSample = now;
+
+    uint32_t window = now / _windowSeconds;
+    if (window != _window) {
+        if (_window != 0) {
+            // Report the window that just ended
+            switch (_stat) {
+                case mean:
+                    _currentValue = _count > 0 ? _sum / _count : -9999;
+                    break;
+                case minimum: _currentValue = _count > 0 ? _min : -9999; break;
+                case maximum: _currentValue = _count > 0 ? _max : -9999; break;
+                default: _currentValue = _count; break;
+            }
+            MS_DBG(F("Aggregate of"), getVarCode(), F("for the window:"),
+                   _currentValue);
+        }
+        _window = window;
+        _count  = 0;
+        _sum    = 0;
+    }
+
+    float value = _source->getValue();
+    if (value == -9999) return;
+    if (_count == 0 || value < _min) _min = value;
+    if (_count == 0 || value > _max) _max = value;
+    _sum += value;
+    _count++;
+}
+
+
+// ============================================================================
+//  The functions for values derived from the running state of a variable
+// ============================================================================
+
+DerivedVariable::DerivedVariable(Variable* source, kernel kern,
+                                 float parameter, const char* uuid,
+                                 const char* varCode)
+    : Variable(static_cast<float (*)()>(nullptr), 0, "", "", varCode, uuid),
+      _source(source),
+      _kernel(kern),
+      _parameter(parameter) {
+    if (_kernel == dailyTotal) {
+        _resetSeconds = 86400L;
+    } else if (_kernel == minSinceReset || _kernel == maxSinceReset) {
+        _resetSeconds = static_cast<uint32_t>(_parameter * 3600);
+    }
+    attachAggregate(source, kern);
+    setCalculationInputs(&_source, 1);
+}
+DerivedVariable::DerivedVariable(VariableHistory* history, uint16_t records,
+                                 const char* uuid, const char* varCode)
+    : Variable(static_cast<float (*)()>(nullptr), 0, "", "", varCode, uuid),
+      _source(history->getSource()),
+      _history(history),
+      _kernel(windowMean),
+      _parameter(0),
+      _records(records) {
+    if (_records >= _history->getCapacity()) {
+        _records = _history->getCapacity() - 1;
+    }
+    if (_records == 0) _records = 1;
+    attachAggregate(_source, windowMean);
+    setCalculationInputs(&_source, 1);
+}
+
+
+void DerivedVariable::reset(void) {
+    _state     = 0;
+    _stateTime = 0;
+    _count     = 0;
+    if (_kernel == dailyTotal) {
+        _currentValue = 0;
+    } else if (_kernel != windowMean) {
+        _currentValue = -9999;
+    }
+}
+
+
+// The running sum is checked against all of the window now and then, so
+// float rounding can't build up
+void DerivedVariable::sumWindow(void) {
+    uint16_t n = _history->getCount() < _records ? _history->getCount()
+                                                 : _records;
+    _state = 0;
+    _count = 0;
+    for (uint16_t b = 0; b < n; b++) {
+        float value = _history->getValue(b);
+        if (value == -9999) continue;
+        _state += value;
+        _count++;
+    }
+    _sumCountdown = _records;
+}
+
+
+void DerivedVariable::update(void) {
+    // Only take one value for each logging interval
+    uint32_t now = Logger::markedLocalEpochTime;
+    if (now == 0 || now == _lastUpdate) return;
+    _lastUpdate = now;
+
+    if (_resetSeconds != 0 && now / _resetSeconds != _period) {
+        _period = now / _resetSeconds;
+        reset();
+    }
+
+    if (_kernel == windowMean) {
+        // This is the same record the logger adds after the update
+        _history->record(Logger::markedUTCEpochTime);
+        if (_history->getTime(1) != _stateTime || _sumCountdown == 0) {
+            // Records were added without this seeing them
+            sumWindow();
+        } else {
+            float value = _history->getValue(0);
+            if (value != -9999) {
+                _state += value;
+                _count++;
+            }
+            if (_history->getCount() > _records) {
+                float old = _history->getValue(_records);
+                if (old != -9999) {
+                    _state -= old;
+                    _count--;
+                }
+            }
+            _sumCountdown--;
+        }
+        _stateTime    = _history->getTime(0);
+        _currentValue = _count > 0 ? _state / _count : -9999;
+        return;
+    }
+
+    float value = _source->getValue();
+    switch (_kernel) {
+        case expMean:
+            if (value == -9999) break;
+            if (_count == 0) _state = value;
+            _state += _parameter * (value - _state);
+            _count        = 1;
+            _currentValue = _state;
+            break;
+        case rateOfChange:
+            if (value == -9999) {
+                _currentValue = -9999;
+                break;
+            }
+            _currentValue = _count > 0 && now > _stateTime
+                ? (value - _state) * 60 / (now - _stateTime)
+                : -9999;
+            _state     = value;
+            _stateTime = now;
+            _count     = 1;
+            break;
+        case dailyTotal:
+            if (value != -9999) _state += value;
+            _currentValue = _state;
+            break;
+        case minSinceReset:
+        case maxSinceReset:
+            if (value != -9999 &&
+                (_count == 0 ||
+                 (_kernel == minSinceReset ? value < _state
+                                           : value > _state))) {
+                _state = value;
+                _count = 1;
+            }
+            _currentValue = _count > 0 ? _state : -9999;
+            break;
     }
 }
@@ -22,11 +22,32 @@
 
 // Forward Declared Dependences
 class Sensor;
+class VariableHistory;
 
 // Included Dependencies
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 
+/**
+ * @brief The size of a character buffer large enough to hold any variable
+ * value formatted as text, including the terminating null.
+ */
+#define MS_VALUE_BUFFER_SIZE 33
+
+/**
+ * @brief What the data file or a publisher does with a value that was not
+ * measured for the current record.
+ *
+ * A sensor that is measured every few updates, shares an earlier result, or
+ * is skipped while it's failing can leave its last value standing in the
+ * record; see Variable::isValueStale().
+ */
+typedef enum staleValuePolicy {
+    STALE_KEEP = 0,  ///< Keep the last value, as if it were new
+    STALE_MISSING,   ///< Replace the value with -9999
+    STALE_OMIT       ///< Leave the value out, where it can be left out
+} staleValuePolicy;
+
 /**
  * @brief The variable class for a value and related metadata.
  *
@@ -163,6 +184,18 @@ class Variable {
      * @return Variable A pointer to the variable object
      */
     Variable* begin(Sensor* parentSense, const char* uuid);
+    /**
+     * @brief Begin for the Variable object with a UUID kept in flash
+     *
+     * @param parentSense The Sensor object supplying values.  Supercedes any
+     * Sensor supplied in the constructor.
+     * @param uuid A universally unique identifier for the variable, as from
+     * the F() macro.  Supercedes any value supplied in the constructor.
+     * @return Variable A pointer to the variable object
+     *
+     * @see setVarUUID(const __FlashStringHelper*)
+     */
+    Variable* begin(Sensor* parentSense, const __FlashStringHelper* uuid);
     /**
      * @brief Begin for the Variable object
      *
@@ -233,6 +266,31 @@ class Variable {
      * @param parentSense  The Sensor object supplying values.
      */
     void onSensorUpdate(Sensor* parentSense);
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Get the parent sensor name, if applicable
+     *
+     * This is a helper needed for dealing with variables in arrays
+     *
+     * @note With the build flag `MS_NO_STRING`; otherwise this returns a
+     * String.
+     *
+     * @return **const char\*** The parent sensor name
+     */
+    const char* getParentSensorName(void);
+    /**
+     * @brief Get the parent sensor name and location, if applicable.
+     *
+     * This is a helper needed for dealing with variables in arrays
+     *
+     * @note With the build flag `MS_NO_STRING`; otherwise this returns a
+     * String.
+     *
+     * @return **const char\*** The parent sensor's concatentated name and
+     * location.
+     */
+    const char* getParentSensorNameAndLocation(void);
+#else
     /**
      * @brief Get the parent sensor name, if applicable
      *
@@ -249,6 +307,15 @@ class Variable {
      * @return **String** The parent sensor's concatentated name and location.
      */
     String getParentSensorNameAndLocation(void);
+#endif
+    /**
+     * @brief Print the parent sensor name, or "Calculated", without making a
+     * String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printParentSensorName(Print& out);
 
     /**
      * @brief Set the calculation function for a calculted variable
@@ -256,6 +323,42 @@ class Variable {
      * @param calcFxn Any function returning a float value.
      */
     void setCalculation(float (*calcFxn)());
+    /**
+     * @brief Declare the variables used as inputs to the calculation function
+     * of a calculated variable.
+     *
+     * Any calculated inputs will be evaluated before this variable's
+     * calculation is run.  Declaring the inputs is optional - calculated
+     * inputs read with getValue() inside the calculation function are also
+     * evaluated on demand - but it makes the order of evaluation explicit.
+     *
+     * @param calcInputs An array of pointers to the input variables.  The
+     * array must remain in memory as long as this variable is used.
+     * @param nInputs The number of variables in the array
+     */
+    void setCalculationInputs(Variable* calcInputs[], uint8_t nInputs);
+    /**
+     * @brief Mark the values of all calculated variables as out of date.
+     *
+     * The result of each calculation is cached so that a calculated variable
+     * which is read many times after a single update - for the data file, the
+     * serial output, and each publisher - only runs its calculation once.
+     * This is called by the VariableArray after each update of the sensor
+     * values.
+     */
+    static void invalidateCalculatedValues(void);
+    /**
+     * @brief Get the number of the most recent update of the sensor values.
+     *
+     * This is incremented each time invalidateCalculatedValues() is called,
+     * so anything caching variable values can compare it to know if its
+     * copy is still current.
+     *
+     * @return **uint32_t** The current update number
+     */
+    static uint32_t getUpdateNumber(void) {
+        return _updateNumber;
+    }
 
     // This gets/sets the variable's resolution for value strings
     /**
@@ -276,6 +379,14 @@ class Variable {
      * @return **String** The variable name
      */
     String getVarName(void);
+    /**
+     * @brief Print the variable name, from flash or RAM, without making a
+     * String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printVarName(Print& out);
     /**
      * @brief Set the variable name.
      *
@@ -286,12 +397,27 @@ class Variable {
      * controlled vocabulary.
      */
     void setVarName(const char* varName);
+    /**
+     * @brief Set the variable name from text kept in flash, as by the F()
+     * macro, so it takes no RAM on AVR boards.
+     *
+     * @param varName The name of the variable per the ODM2 variable name
+     * controlled vocabulary.
+     */
+    void setVarName(const __FlashStringHelper* varName);
     /**
      * @brief Get the variable unit
      *
      * @return **String** The variable unit
      */
     String getVarUnit(void);
+    /**
+     * @brief Print the variable unit without making a String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printVarUnit(Print& out);
     /**
      * @brief Set the variable unit.
      *
@@ -302,12 +428,36 @@ class Variable {
      * vocabulary.
      */
     void setVarUnit(const char* varUnit);
+    /**
+     * @brief Set the variable unit from text kept in flash, as by the F()
+     * macro.
+     *
+     * @param varUnit The unit of the variable per the ODM2 unit controlled
+     * vocabulary.
+     */
+    void setVarUnit(const __FlashStringHelper* varUnit);
     /**
      * @brief Get the customized code for the variable
      *
      * @return **String** The customized code for the variable
      */
     String getVarCode(void);
+    /**
+     * @brief Print the variable code without making a String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printVarCode(Print& out);
+    /**
+     * @brief Write the variable code into a buffer, without making a String.
+     *
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer, including the terminating null
+     * @return **uint8_t** The length of the text written; 0 if there is no
+     * code or it doesn't fit
+     */
+    uint8_t formatVarCode(char* buffer, size_t bufferSize);
     /**
      * @brief Set a customized code for the variable
      *
@@ -315,6 +465,13 @@ class Variable {
      * text helping to identify the variable in files.
      */
     void setVarCode(const char* varCode);
+    /**
+     * @brief Set a customized code for the variable from text kept in flash,
+     * as by the F() macro.
+     *
+     * @param varCode A custom code for the variable.
+     */
+    void setVarCode(const __FlashStringHelper* varCode);
     // This gets/sets the variable UUID, if one has been assigned
     /**
      * @brief Get the customized code for the variable
@@ -322,12 +479,84 @@ class Variable {
      * @return **String** The customized code for the variable
      */
     String getVarUUID(void);
+    /**
+     * @brief Print the UUID as text without making a String.
+     *
+     * @param out The stream to print to
+     * @return **size_t** The number of characters printed
+     */
+    size_t printVarUUID(Print& out);
     /**
      * @brief Set a customized code for the variable
      *
      * @param uuid A universally unique identifier for the variable.
      */
     void setVarUUID(const char* uuid);
+    /**
+     * @brief Set the UUID from text kept in flash, as by the F() macro.
+     *
+     * A UUID given as a string literal in a constructor is copied into RAM
+     * at start up on AVR boards; 37 bytes for every variable.  Setting it
+     * this way in `setup()` instead leaves it in flash, where it is read from
+     * each time it is printed.
+     *
+     * @code{cpp}
+     * variableList[0]->setVarUUID(F("12345678-abcd-1234-ef00-1234567890ab"));
+     * @endcode
+     *
+     * @param uuid A universally unique identifier for the variable.
+     */
+    void setVarUUID(const __FlashStringHelper* uuid);
+    /**
+     * @brief Set the UUID as its 16 raw bytes.
+     *
+     * The bytes are not copied, so they must stay where they are; a `const`
+     * array at global scope is best.  This takes 16 bytes instead of the 37
+     * of the text, needs no check of its format, and is written out as text
+     * straight into the output buffers only when the data is sent.
+     *
+     * @code{cpp}
+     * const uint8_t tempUUID[16] = {0x12, 0x34, 0x56, 0x78, 0xab, 0xcd,
+     *                               0x12, 0x34, 0xef, 0x00, 0x12, 0x34,
+     *                               0x56, 0x78, 0x90, 0xab};
+     * variableList[0]->setVarUUID(tempUUID);
+     * @endcode
+     *
+     * @param uuidBytes The 16 bytes of the UUID, in the order they are
+     * written
+     */
+    void setVarUUID(const uint8_t* uuidBytes);
+    /**
+     * @brief Get the 16 raw bytes of the UUID.
+     *
+     * @param bytes A buffer of 16 bytes for the UUID
+     * @return **bool** True if the variable has a correctly formatted UUID
+     */
+    bool getVarUUIDBytes(uint8_t* bytes);
+    /**
+     * @brief Write the UUID as text into a buffer, without making a String.
+     *
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer; 37 is enough for any UUID
+     * @return **uint8_t** The length of the text written; 0 if there is no
+     * UUID or it doesn't fit
+     */
+    uint8_t formatVarUUID(char* buffer, size_t bufferSize);
+    /**
+     * @brief Read the text of a UUID into its 16 bytes.
+     *
+     * @param text The UUID text, as "12345678-abcd-1234-ef00-1234567890ab"
+     * @param bytes A buffer of 16 bytes for the UUID
+     * @return **bool** True if the text is a correctly formatted UUID
+     */
+    static bool parseUUID(const char* text, uint8_t* bytes);
+    /**
+     * @brief Write the 16 bytes of a UUID as its text.
+     *
+     * @param bytes The 16 bytes of the UUID
+     * @param buffer A buffer of at least 37 characters for the text
+     */
+    static void formatUUID(const uint8_t* bytes, char* buffer);
     /**
      * @brief Verify the the UUID is correctly formatted
      *
@@ -341,11 +570,52 @@ class Variable {
     /**
      * @brief Get current value of the variable as a float
      *
+     * For a calculated variable, the result of the calculation is cached until
+     * the next update of a variable array.
+     *
      * @param updateValue True to ask the parent sensor to measure and return a
-     * new value.  Default is false.
+     * new value, or to force a calculated variable to re-run its calculation.
+     * Default is false.
      * @return **float** The current value of the variable
      */
     float getValue(bool updateValue = false);
+    /**
+     * @brief Get the time of the record the current value was measured for.
+     *
+     * This is the time of the parent sensor's last good result.  A
+     * calculated variable takes the oldest time of the variables given to
+     * setCalculationInputs().
+     *
+     * @return **uint32_t** The UTC epoch time; 0 if it isn't known, as for a
+     * calculation with no inputs set or a sensor never measured on a logger
+     */
+    uint32_t getValueTime(void);
+    /**
+     * @brief Check whether the current value is older than the record that
+     * is being made.
+     *
+     * @param maxAgeSeconds The oldest a value can be and not be stale.
+     * Default is 0, so only values measured for the current record are
+     * fresh.
+     * @return **bool** True if the value is older than the age allowed; false
+     * if it's fresh or its time isn't known
+     */
+    bool isValueStale(uint32_t maxAgeSeconds = 0);
+#if defined(MS_NO_STRING)
+    /**
+     * @brief Get current value of the variable as text with the correct
+     * decimal resolution, without making a String.
+     *
+     * @note With the build flag `MS_NO_STRING`, the text is in a buffer
+     * shared by all variables, which the next call writes over; use
+     * formatValue() to keep it.  Otherwise this returns a String.
+     *
+     * @param updateValue True to ask the parent sensor to measure and return a
+     * new value.  Default is false.
+     * @return **const char\*** The current value of the variable
+     */
+    const char* getValueString(bool updateValue = false);
+#else
     /**
      * @brief Get current value of the variable as a string with the correct
      * decimal resolution
@@ -355,6 +625,40 @@ class Variable {
      * @return **String** The current value of the variable
      */
     String getValueString(bool updateValue = false);
+#endif
+    /**
+     * @brief Write the current value of the variable into a character buffer
+     * with the correct decimal resolution.
+     *
+     * This gives exactly the same text as getValueString() without creating a
+     * String on the heap.
+     *
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null.  A buffer of #MS_VALUE_BUFFER_SIZE is always big
+     * enough for any value.
+     * @param updateValue True to ask the parent sensor to measure and return a
+     * new value.  Default is false.
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatValue(char* buffer, size_t bufferLen,
+                       bool updateValue = false);
+    /**
+     * @brief Write the given value into a character buffer with this
+     * variable's decimal resolution.
+     *
+     * This is used to format values that were saved earlier, such as records
+     * replayed from a backlog.
+     *
+     * @param value The value to format
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatValue(float value, char* buffer, size_t bufferLen);
 
     /**
      * @brief Pointer to the parent sensor
@@ -377,6 +681,31 @@ class Variable {
 
  private:
     float (*_calcFxn)(void) = nullptr;
+    /**
+     * @brief The input variables to the calculation, if declared
+     */
+    Variable** _calcInputs = nullptr;
+    /**
+     * @brief The number of declared input variables to the calculation
+     */
+    uint8_t _nCalcInputs = 0;
+    /**
+     * @brief The update number when the calculated value was last cached
+     */
+    uint32_t _calcUpdateNumber = 0;
+    /**
+     * @brief True while the calculation is running; used to break circular
+     * dependencies between calculated variables.
+     */
+    bool _isCalculating = false;
+    /**
+     * @brief A count of sensor updates, used to check if cached calculated
+     * values are still current.
+     *
+     * Zero means no update has been counted and calculated values are not
+     * cached at all.
+     */
+    static uint32_t _updateNumber;
 
     const uint8_t _sensorVarNum      = 0;
     uint8_t       _decimalResolution = 0;
@@ -385,6 +714,434 @@ class Variable {
     const char* _varUnit = nullptr;
     const char* _varCode = nullptr;
     const char* _uuid    = nullptr;
+    /**
+     * @brief The bits of the text fields that point to flash rather than to
+     * RAM
+     */
+    uint8_t _inFlash = 0;
+    /**
+     * @brief True if _uuid points to the 16 raw bytes of the UUID rather than
+     * to its text
+     */
+    bool _uuidIsBytes = false;
+    /**
+     * @brief The bits of _inFlash
+     */
+    enum flashField {
+        nameInFlash = 0x01,
+        unitInFlash = 0x02,
+        codeInFlash = 0x04,
+        uuidInFlash = 0x08
+    };
+    /**
+     * @brief Make a String of one of the text fields, from flash or RAM.
+     *
+     * @param text The field
+     * @param field The bit of the field in _inFlash
+     * @return **String** The text
+     */
+    String fieldString(const char* text, flashField field);
+    /**
+     * @brief Print one of the text fields, from flash or RAM.
+     *
+     * @param out The stream to print to
+     * @param text The field
+     * @param field The bit of the field in _inFlash
+     * @return **size_t** The number of characters printed
+     */
+    size_t printField(Print& out, const char* text, flashField field);
+    /**
+     * @brief Copy one of the text fields, from flash or RAM, into a buffer.
+     *
+     * @param text The field
+     * @param field The bit of the field in _inFlash
+     * @param buffer The buffer for the text
+     * @param bufferSize The size of the buffer, including the terminating null
+     * @return **uint8_t** The length of the text; 0 if there is none or it
+     * doesn't fit
+     */
+    uint8_t copyField(const char* text, flashField field, char* buffer,
+                      size_t bufferSize);
+
+
+ protected:
+    /**
+     * @brief Attach this variable to a sensor as a report of a statistic or
+     * timing of the sensor's results rather than of a result itself.
+     *
+     * @param parentSense The Sensor object supplying values.
+     * @param statistic The statistic to report
+     */
+    void attachSensorStatistic(Sensor* parentSense, uint8_t statistic);
+    /**
+     * @brief Make this variable report an aggregate of another variable's
+     * values, taking the name, unit, and resolution of that variable.
+     *
+     * @param source The variable to aggregate
+     * @param statistic The aggregate to report
+     */
+    void attachAggregate(Variable* source, uint8_t statistic);
+
+ private:
+    /**
+     * @brief The statistic or timing of the sensor update reported by this
+     * variable; 0 for the result value itself.
+     */
+    uint8_t _statistic = 0;
+    /**
+     * @brief The next variable in the parent sensor's list of statistic
+     * variables.
+     */
+    Variable* _nextStatVariable = nullptr;
+};
+
+
+#if defined(MS_SENSOR_STATISTICS)
+/**
+ * @brief The variable class for a statistic of the measurements averaged to
+ * create a sensor result.
+ *
+ * This can be used to report the spread of the readings behind an averaged
+ * value as a data quality metric without taking any extra readings or keeping
+ * any raw readings in memory.  The statistics are only collected when the
+ * library is built with `MS_SENSOR_STATISTICS` defined.
+ *
+ * @ingroup base_classes
+ */
+class VariableStatistic : public Variable {
+ public:
+    /**
+     * @brief The statistics a VariableStatistic can report.
+     */
+    enum statistic : uint8_t {
+        stdDev = 1,  ///< The sample standard deviation of the readings
+        minimum,     ///< The smallest of the readings
+        maximum,     ///< The largest of the readings
+        count        ///< The number of good readings
+    };
+
+    /**
+     * @brief Construct a new VariableStatistic object.
+     *
+     * @param parentSense The parent sensor
+     * @param sensorVarNum The position in the sensor's value array of the
+     * result to report a statistic of
+     * @param stat The statistic to report
+     * @param decimalResolution The resolution (in decimal places) of the
+     * statistic.
+     * @param varName The name of the variable per the [ODM2 variable name
+     * controlled vocabulary](http://vocabulary.odm2.org/variablename/)
+     * @param varUnit The unit of the variable per the [ODM2 unit controlled
+     * vocabulary](http://vocabulary.odm2.org/units/)
+     * @param varCode A custom code for the variable.  This can be any short
+     * text helping to identify the variable in files.
+     * @param uuid A universally unique identifier for the variable.
+     */
+    VariableStatistic(Sensor* parentSense, const uint8_t sensorVarNum,
+                      statistic stat, uint8_t decimalResolution,
+                      const char* varName, const char* varUnit,
+                      const char* varCode, const char* uuid = "")
+        : Variable(sensorVarNum, decimalResolution, varName, varUnit,
+                   varCode) {
+        setVarUUID(uuid);
+        attachSensorStatistic(parentSense, stat);
+    }
+    /**
+     * @brief Destroy the VariableStatistic object - no action needed.
+     */
+    ~VariableStatistic() {}
+};
+#endif
+
+
+/**
+ * @brief The variable class for the actual time taken by one step of a
+ * sensor's update.
+ *
+ * These can be logged and published to tune the warm-up, stabilization, and
+ * measurement times of a sensor from real data.  The values are in
+ * milliseconds.
+ *
+ * @ingroup base_classes
+ */
+class SensorTimingVariable : public Variable {
+ public:
+    /**
+     * @brief The steps of the update a SensorTimingVariable can report.
+     *
+     * These don't overlap the VariableStatistic statistics.
+     */
+    enum timing : uint8_t {
+        warmUp = 16,    ///< From power on to a successful wake
+        stabilization,  ///< From the wake to the first measurement request
+        measurement     ///< From the last measurement request to its result
+    };
+
+    /**
+     * @brief Construct a new SensorTimingVariable object.
+     *
+     * @param parentSense The parent sensor
+     * @param step The step of the update to report the time of
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "SensorTime".
+     */
+    SensorTimingVariable(Sensor* parentSense, timing step,
+                         const char* uuid    = "",
+                         const char* varCode = "SensorTime")
+        : Variable(static_cast<uint8_t>(0), static_cast<uint8_t>(0),
+                   "elapsedTime", "millisecond", varCode) {
+        setVarUUID(uuid);
+        attachSensorStatistic(parentSense, step);
+    }
+    /**
+     * @brief Destroy the SensorTimingVariable object - no action needed.
+     */
+    ~SensorTimingVariable() {}
+};
+
+
+
+/**
+ * @brief The variable class for the health of a sensor.
+ *
+ * This reports the number of updates in a row the sensor has failed, so 0
+ * means the last update was good.  With Sensor::setFailureBackoff(), the count
+ * keeps its value while the sensor is skipped, and shows why the sensor's
+ * values are missing.
+ *
+ * @ingroup base_classes
+ */
+class SensorHealthVariable : public Variable {
+ public:
+    /**
+     * @brief The kinds of health a SensorHealthVariable can report.
+     *
+     * These don't overlap the VariableStatistic statistics or the
+     * SensorTimingVariable timings.
+     */
+    enum health : uint8_t {
+        failures = 24  ///< The number of failed updates in a row
+    };
+
+    /**
+     * @brief Construct a new SensorHealthVariable object.
+     *
+     * @param parentSense The parent sensor
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "SensorFailures".
+     */
+    explicit SensorHealthVariable(Sensor*     parentSense,
+                                  const char* uuid    = "",
+                                  const char* varCode = "SensorFailures")
+        : Variable(static_cast<uint8_t>(0), static_cast<uint8_t>(0),
+                   "counter", "count", varCode) {
+        setVarUUID(uuid);
+        attachSensorStatistic(parentSense, failures);
+    }
+    /**
+     * @brief Destroy the SensorHealthVariable object - no action needed.
+     */
+    ~SensorHealthVariable() {}
+};
+
+
+/**
+ * @brief The variable class for the mean, minimum, maximum, or count of
+ * another variable's values over a window of time.
+ *
+ * This is the aggregation stage for loggers that measure often but only
+ * publish a summary.  After each sensor update the value of the source
+ * variable is added to the running statistics of the current window; the
+ * windows line up with the clock, like the logging intervals.  Once a window
+ * is over, this variable reports its result until the next window ends.  So
+ * a logger measuring every minute and publishing the 15-minute mean can put
+ * an AggregateVariable with a 15 minute window in the variable array, send
+ * it alone to a publisher with dataPublisher::setVariableSubset(), and have
+ * the publisher send on every 15th interval without keeping the records in
+ * between; see dataPublisher::setSaveSkippedRecords().  The data file still
+ * gets every value of the source variable.
+ *
+ * Missing (-9999) values are left out of the statistics; a window with no
+ * good values reports -9999.
+ *
+ * @ingroup base_classes
+ */
+class AggregateVariable : public Variable {
+ public:
+    /**
+     * @brief The aggregates an AggregateVariable can report.
+     *
+     * These don't overlap the VariableStatistic statistics, the
+     * SensorTimingVariable timings, or the SensorHealthVariable health.
+     */
+    enum aggregate : uint8_t {
+        mean = 32,  ///< The average of the values in the window
+        minimum,    ///< The smallest of the values in the window
+        maximum,    ///< The largest of the values in the window
+        count       ///< The number of good values in the window
+    };
+
+    /**
+     * @brief Construct a new AggregateVariable object.
+     *
+     * @param source The variable to aggregate.  It must be updated with
+     * this variable - usually by being in the same variable array.
+     * @param stat The aggregate to report
+     * @param windowMinutes The length of each window in minutes; this
+     * should be a multiple of the logging interval.
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "Aggregate".
+     */
+    AggregateVariable(Variable* source, aggregate stat, uint16_t windowMinutes,
+                      const char* uuid = "", const char* varCode = "Aggregate");
+    /**
+     * @brief Destroy the AggregateVariable object - no action needed.
+     */
+    ~AggregateVariable() {}
+
+    /**
+     * @brief Add the current value of the source variable to the window,
+     * finishing the window first if its time is over.
+     *
+     * This is called by getValue() once for each sensor update.
+     */
+    void addSample(void);
+
+ private:
+    Variable* _source;
+    uint8_t   _stat;
+    uint32_t  _windowSeconds;
+    uint32_t  _window     = 0;
+    uint32_t  _lastSample = 0;
+    float     _sum        = 0;
+    float     _min        = 0;
+    float     _max        = 0;
+    uint16_t  _count      = 0;
+};
+
+
+/**
+ * @brief The variable class for a value derived from the running state of
+ * another variable: a moving average, a rate of change, a daily total, or
+ * the minimum or maximum since a reset.
+ *
+ * These replace the global statics a calculation function would otherwise
+ * need to keep its state between updates.  Each kernel does a fixed amount
+ * of work for each sensor update, and is declared like any other variable:
+ *
+ * @code{cpp}
+ * Variable* stageSmooth =
+ *     new DerivedVariable(stage, DerivedVariable::expMean, 0.2);
+ * Variable* rainToday =
+ *     new DerivedVariable(rainPerInterval, DerivedVariable::dailyTotal);
+ * // The mean of the last 12 records, from a history of 24
+ * Variable* stageHourly = new DerivedVariable(&stageHistory, 12);
+ * @endcode
+ *
+ * The derived value takes the name, unit and resolution of the source
+ * variable; give a rate of change its own unit with setVarUnit().  Missing
+ * (-9999) values are left out of the running state.  A rate of change or a
+ * moving average with no good values yet reports -9999.
+ *
+ * @ingroup base_classes
+ */
+class DerivedVariable : public Variable {
+ public:
+    /**
+     * @brief The kernels a DerivedVariable can run.
+     *
+     * These don't overlap the AggregateVariable aggregates.
+     */
+    enum kernel : uint8_t {
+        expMean = 40,   ///< An exponential moving average; the parameter is
+                        ///< the weight of each new value, from 0 to 1
+        windowMean,     ///< The mean of a number of the newest records of
+                        ///< a VariableHistory
+        rateOfChange,   ///< The change per minute since the last good value
+        dailyTotal,     ///< The sum of the values since local midnight
+        minSinceReset,  ///< The smallest value since the last reset; the
+                        ///< parameter is the hours between resets, or 0 to
+                        ///< only reset with reset()
+        maxSinceReset   ///< The largest value since the last reset; the
+                        ///< parameter is the hours between resets, or 0 to
+                        ///< only reset with reset()
+    };
+
+    /**
+     * @brief Construct a new DerivedVariable object.
+     *
+     * @param source The variable the value is derived from.  It must be
+     * updated with this variable - usually by being in the same variable
+     * array.
+     * @param kern The kernel to run; any but #windowMean
+     * @param parameter The parameter of the kernel, if it has one.  Default
+     * is 0.
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "Derived".
+     */
+    DerivedVariable(Variable* source, kernel kern, float parameter = 0,
+                    const char* uuid = "", const char* varCode = "Derived");
+    /**
+     * @brief Construct a new DerivedVariable object reporting the mean of the
+     * newest records of a history.
+     *
+     * The values leaving the window are read back from the history, so the
+     * history must keep more records than the window.
+     *
+     * @param history The history of the source variable, added to the
+     * logger with Logger::addHistory()
+     * @param records The number of records averaged; at most one less than
+     * the capacity of the history
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "Derived".
+     */
+    DerivedVariable(VariableHistory* history, uint16_t records,
+                    const char* uuid = "", const char* varCode = "Derived");
+    /**
+     * @brief Destroy the DerivedVariable object - no action needed.
+     */
+    ~DerivedVariable() {}
+
+    /**
+     * @brief Forget the running state and start again.
+     */
+    void reset(void);
+    /**
+     * @brief Add the current value of the source variable to the running
+     * state, resetting it first if a reset is due.
+     *
+     * This is called by getValue() once for each sensor update.
+     */
+    void update(void);
+
+ private:
+    /**
+     * @brief Add up the window of the history again, from its values.
+     */
+    void sumWindow(void);
+
+    Variable*        _source;
+    VariableHistory* _history      = nullptr;
+    uint8_t          _kernel;
+    float            _parameter;
+    uint32_t         _resetSeconds = 0;
+    uint32_t         _period       = 0;
+    uint32_t         _lastUpdate   = 0;
+    float            _state        = 0;
+    uint32_t         _stateTime    = 0;
+    uint16_t         _count        = 0;
+    uint16_t         _records      = 0;
+    uint16_t         _sumCountdown = 0;
 };
 
 #endif  // SRC_VARIABLEBASE_H_
@@ -0,0 +1,178 @@
+/**
+ * @file VariableHistory.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the VariableHistory class.
+ */
+
+#include "VariableHistory.h"
+
+// A missing value, stored scaled
+#define HISTORY_MISSING_SCALED INT16_MIN
+
+
+// Constructors
+VariableHistory::VariableHistory(Variable* source, int16_t* values,
+                                 uint32_t* times, uint16_t capacity,
+                                 uint8_t decimalPlaces)
+    : _source(source),
+      _scaled(values),
+      _floats(nullptr),
+      _times(times),
+      _capacity(capacity),
+      _scale(1) {
+    for (uint8_t i = 0; i < decimalPlaces; i++) _scale *= 10;
+}
+VariableHistory::VariableHistory(Variable* source, float* values,
+                                 uint32_t* times, uint16_t capacity,
+                                 uint8_t decimalPlaces)
+    : _source(source),
+      _scaled(nullptr),
+      _floats(values),
+      _times(times),
+      _capacity(capacity),
+      _scale(1) {
+    (void)decimalPlaces;
+}
+
+
+void VariableHistory::record(uint32_t time) {
+    if (_source == nullptr || time == 0) return;
+    if (_count > 0 && _times[indexOf(0)] == time) return;
+    add(time, _source->getValue());
+}
+
+
+void VariableHistory::add(uint32_t time, float value) {
+    _times[_head] = time;
+    if (_scaled != nullptr) {
+        int16_t scaled = HISTORY_MISSING_SCALED;
+        if (value != -9999) {
+            float s = value * _scale;
+            // The missing value is kept out of the range of good ones
+            if (s > INT16_MAX) {
+                MS_DBG(F("Clipping"), value, F("to fit the history"));
+                s = INT16_MAX;
+            } else if (s < INT16_MIN + 1) {
+                MS_DBG(F("Clipping"), value, F("to fit the history"));
+                s = INT16_MIN + 1;
+            }
+            scaled = static_cast<int16_t>(s < 0 ? s - 0.5 : s + 0.5);
+        }
+        _scaled[_head] = scaled;
+    } else {
+        _floats[_head] = value;
+    }
+    _head = (_head + 1) % _capacity;
+    if (_count < _capacity) _count++;
+}
+
+
+void VariableHistory::clear(void) {
+    _head  = 0;
+    _count = 0;
+}
+
+
+uint32_t VariableHistory::getStorageBytes(void) {
+    uint8_t valueBytes = _scaled != nullptr ? sizeof(int16_t) : sizeof(float);
+    return static_cast<uint32_t>(_capacity) * (valueBytes + sizeof(uint32_t));
+}
+
+
+float VariableHistory::getValue(uint16_t back) {
+    if (back >= _count) return -9999;
+    uint16_t i = indexOf(back);
+    if (_scaled == nullptr) return _floats[i];
+    if (_scaled[i] == HISTORY_MISSING_SCALED) return -9999;
+    return _scaled[i] / _scale;
+}
+
+
+uint32_t VariableHistory::getTime(uint16_t back) {
+    if (back >= _count) return 0;
+    return _times[indexOf(back)];
+}
+
+
+uint16_t VariableHistory::getLast(float* values, uint16_t k) {
+    uint16_t n = k < _count ? k : _count;
+    for (uint16_t i = 0; i < n; i++) values[i] = getValue(n - 1 - i);
+    return n;
+}
+
+
+// The times only grow, so the window ends at the first value too old for it
+uint16_t VariableHistory::countInWindow(uint32_t windowSeconds) {
+    if (windowSeconds == 0 || _count == 0) return _count;
+    uint32_t newest = getTime(0);
+    uint16_t n      = 0;
+    while (n < _count && newest - getTime(n) < windowSeconds) n++;
+    return n;
+}
+
+
+float VariableHistory::getMean(uint32_t windowSeconds) {
+    uint16_t n     = countInWindow(windowSeconds);
+    float    sum   = 0;
+    uint16_t count = 0;
+    for (uint16_t b = 0; b < n; b++) {
+        float value = getValue(b);
+        if (value == -9999) continue;
+        sum += value;
+        count++;
+    }
+    return count > 0 ? sum / count : -9999;
+}
+
+
+float VariableHistory::getMin(uint32_t windowSeconds) {
+    uint16_t n      = countInWindow(windowSeconds);
+    float    result = -9999;
+    for (uint16_t b = 0; b < n; b++) {
+        float value = getValue(b);
+        if (value == -9999) continue;
+        if (result == -9999 || value < result) result = value;
+    }
+    return result;
+}
+
+
+float VariableHistory::getMax(uint32_t windowSeconds) {
+    uint16_t n      = countInWindow(windowSeconds);
+    float    result = -9999;
+    for (uint16_t b = 0; b < n; b++) {
+        float value = getValue(b);
+        if (value == -9999) continue;
+        if (result == -9999 || value > result) result = value;
+    }
+    return result;
+}
+
+
+// The times are taken from the newest, so a float keeps their precision
+float VariableHistory::getSlope(uint32_t windowSeconds) {
+    uint16_t n      = countInWindow(windowSeconds);
+    uint32_t newest = getTime(0);
+    uint16_t count  = 0;
+    float    sumX   = 0;
+    float    sumY   = 0;
+    float    sumXY  = 0;
+    float    sumXX  = 0;
+    for (uint16_t b = 0; b < n; b++) {
+        float value = getValue(b);
+        if (value == -9999) continue;
+        float minutes = -static_cast<float>(newest - getTime(b)) / 60;
+        sumX += minutes;
+        sumY += value;
+        sumXY += minutes * value;
+        sumXX += minutes * minutes;
+        count++;
+    }
+    if (count < 2) return -9999;
+    float denominator = count * sumXX - sumX * sumX;
+    if (denominator == 0) return -9999;
+    return (count * sumXY - sumX * sumY) / denominator;
+}
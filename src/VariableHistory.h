@@ -0,0 +1,257 @@
+/**
+ * @file VariableHistory.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the VariableHistory class, which keeps the recent values of
+ * a variable in RAM, and the StaticVariableHistory class holding its storage.
+ */
+
+// Header Guards
+#ifndef SRC_VARIABLEHISTORY_H_
+#define SRC_VARIABLEHISTORY_H_
+
+// Debugging Statement
+// #define MS_VARIABLEHISTORY_DEBUG
+
+#ifdef MS_VARIABLEHISTORY_DEBUG
+#define MS_DEBUGGING_STD "VariableHistory"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "VariableBase.h"
+
+/**
+ * @brief A circular history of the most recent values of one variable, kept
+ * in RAM.
+ *
+ * Once added to a logger with Logger::addHistory(), the value of the source
+ * variable and the time of the record are added after each complete sensor
+ * update, so rates of change, triggers and other derived values can look back
+ * without reading the data file on the SD card.  The storage is fixed when the
+ * program is compiled, by a StaticVariableHistory.  Each value is kept either
+ * as a float, or as an int16_t scaled by the variable's decimal places; a
+ * scaled value out of the int16_t range is clipped to it.
+ *
+ * The windows of the queries count back from the time of the newest value, so
+ * a window of 3600 takes the values of the last hour of records.  Missing
+ * (-9999) values are kept, so the history stays in step with the records, but
+ * are left out of the statistics.
+ *
+ * @ingroup base_classes
+ */
+class VariableHistory {
+ public:
+    /**
+     * @brief Record the current value of the source variable at a time.
+     *
+     * Only one value is kept for each time, so this can be called more than
+     * once for a record.
+     *
+     * @param time The UTC epoch time of the record
+     */
+    void record(uint32_t time);
+    /**
+     * @brief Add a value to the history, replacing the oldest once it's full.
+     *
+     * @param time The UTC epoch time of the value
+     * @param value The value
+     */
+    void add(uint32_t time, float value);
+    /**
+     * @brief Forget all of the values.
+     */
+    void clear(void);
+
+    /**
+     * @brief Get the variable whose values are kept.
+     *
+     * @return **Variable\*** The source variable
+     */
+    Variable* getSource(void) {
+        return _source;
+    }
+    /**
+     * @brief Get the number of values kept.
+     *
+     * @return **uint16_t** The number of values
+     */
+    uint16_t getCount(void) {
+        return _count;
+    }
+    /**
+     * @brief Get the most values that can be kept.
+     *
+     * @return **uint16_t** The capacity of the history
+     */
+    uint16_t getCapacity(void) {
+        return _capacity;
+    }
+    /**
+     * @brief Get the RAM taken by the stored values and their times.
+     *
+     * @return **uint32_t** The storage in bytes
+     */
+    uint32_t getStorageBytes(void);
+
+    /**
+     * @brief Get one of the values kept.
+     *
+     * @param back The number of values back from the newest; 0 for the newest
+     * @return **float** The value; -9999 if there aren't that many values
+     */
+    float getValue(uint16_t back = 0);
+    /**
+     * @brief Get the time of one of the values kept.
+     *
+     * @param back The number of values back from the newest; 0 for the newest
+     * @return **uint32_t** The UTC epoch time of the value; 0 if there aren't
+     * that many values
+     */
+    uint32_t getTime(uint16_t back = 0);
+    /**
+     * @brief Copy out the newest values, oldest first.
+     *
+     * @param values The array to copy the values into
+     * @param k The most values to copy; the size of the array
+     * @return **uint16_t** The number of values copied
+     */
+    uint16_t getLast(float* values, uint16_t k);
+    /**
+     * @brief Get the mean of the values in a window.
+     *
+     * @param windowSeconds The length of the window back from the newest
+     * value, in seconds; 0 for every value kept
+     * @return **float** The mean; -9999 if there are no good values
+     */
+    float getMean(uint32_t windowSeconds = 0);
+    /**
+     * @brief Get the smallest of the values in a window.
+     *
+     * @param windowSeconds The length of the window back from the newest
+     * value, in seconds; 0 for every value kept
+     * @return **float** The minimum; -9999 if there are no good values
+     */
+    float getMin(uint32_t windowSeconds = 0);
+    /**
+     * @brief Get the largest of the values in a window.
+     *
+     * @param windowSeconds The length of the window back from the newest
+     * value, in seconds; 0 for every value kept
+     * @return **float** The maximum; -9999 if there are no good values
+     */
+    float getMax(uint32_t windowSeconds = 0);
+    /**
+     * @brief Get the least squares slope of the values in a window, in units
+     * per minute like the rates of the logger's triggers.
+     *
+     * @param windowSeconds The length of the window back from the newest
+     * value, in seconds; 0 for every value kept
+     * @return **float** The slope; -9999 if there are fewer than two good
+     * values at different times
+     */
+    float getSlope(uint32_t windowSeconds = 0);
+
+ protected:
+    /**
+     * @brief Construct a new variable history keeping scaled values.
+     *
+     * @param source The variable whose values are kept
+     * @param values The storage for the scaled values
+     * @param times The storage for the times
+     * @param capacity The number of values the storage holds
+     * @param decimalPlaces The decimal places kept of each value
+     */
+    VariableHistory(Variable* source, int16_t* values, uint32_t* times,
+                    uint16_t capacity, uint8_t decimalPlaces);
+    /**
+     * @brief Construct a new variable history keeping float values.
+     *
+     * @param source The variable whose values are kept
+     * @param values The storage for the values
+     * @param times The storage for the times
+     * @param capacity The number of values the storage holds
+     * @param decimalPlaces Unused; floats keep their own precision
+     */
+    VariableHistory(Variable* source, float* values, uint32_t* times,
+                    uint16_t capacity, uint8_t decimalPlaces);
+
+ private:
+    /**
+     * @brief Get the position in the storage of a value.
+     *
+     * @param back The number of values back from the newest
+     * @return **uint16_t** The position
+     */
+    uint16_t indexOf(uint16_t back) {
+        return (_head + _capacity - 1 - back) % _capacity;
+    }
+    /**
+     * @brief Get the number of values in a window.
+     *
+     * @param windowSeconds The length of the window; 0 for every value
+     * @return **uint16_t** The number of values, back from the newest
+     */
+    uint16_t countInWindow(uint32_t windowSeconds);
+
+    Variable* _source;
+    int16_t*  _scaled;
+    float*    _floats;
+    uint32_t* _times;
+    uint16_t  _capacity;
+    float     _scale;
+    uint16_t  _head  = 0;
+    uint16_t  _count = 0;
+};
+
+
+/**
+ * @brief A variable history with its storage, sized when the program is
+ * compiled.
+ *
+ * @code{cpp}
+ * // The last 96 values of stage, to the millimeter
+ * StaticVariableHistory<96> stageHistory(stageVariable, 3);
+ * // ...
+ * dataLogger.addHistory(&stageHistory);
+ * // ...
+ * float risePerMinute = stageHistory.getSlope(3600);
+ * @endcode
+ *
+ * @tparam capacity The number of values kept
+ * @tparam T The type each value is stored as; int16_t (the default) for
+ * values scaled by the decimal places, taking 6 bytes for each value and its
+ * time, or float for 8 bytes
+ *
+ * @ingroup base_classes
+ */
+template <uint16_t capacity, typename T = int16_t>
+class StaticVariableHistory : public VariableHistory {
+ public:
+    /**
+     * @brief Construct a new static variable history object
+     *
+     * @param source The variable whose values are kept
+     * @param decimalPlaces The decimal places kept of each scaled value; the
+     * values times 10^decimalPlaces must fit in an int16_t.  Default is 2.
+     */
+    explicit StaticVariableHistory(Variable* source, uint8_t decimalPlaces = 2)
+        : VariableHistory(source, _values, _times, capacity, decimalPlaces) {
+        static_assert(capacity > 0, "A history must hold at least one value");
+    }
+
+ private:
+    /**
+     * @brief The values kept
+     */
+    T _values[capacity];
+    /**
+     * @brief The times of the values kept
+     */
+    uint32_t _times[capacity];
+};
+
+#endif  // SRC_VARIABLEHISTORY_H_
@@ -18,6 +18,20 @@
 #include <avr/wdt.h>
 
 volatile uint32_t extendedWatchDogAVR::_barksUntilReset = 0;
+volatile uint32_t extendedWatchDogAVR::_barkCount       = 0;
+uint32_t          extendedWatchDogAVR::_warningBarks    = 1;
+volatile bool     extendedWatchDogAVR::_warned          = false;
+volatile bool     extendedWatchDogAVR::_budgetActive    = false;
+volatile uint8_t  extendedWatchDogAVR::_budgetTag       = 0;
+uint32_t          extendedWatchDogAVR::_resetTime_s     = 0;
+
+void (*extendedWatchDogAVR::_earlyWarning)(void) = nullptr;
+
+// The record of the last reset by the watchdog is in memory that isn't
+// cleared at start up, so it lasts through the reset
+#define MS_WATCHDOG_OVERRUN_MAGIC 0x57444F47UL
+static volatile uint32_t overrunMagic __attribute__((section(".noinit")));
+static volatile uint8_t  overrunTag __attribute__((section(".noinit")));
 
 extendedWatchDogAVR::extendedWatchDogAVR() {}
 extendedWatchDogAVR::~extendedWatchDogAVR() {
@@ -67,7 +81,10 @@ void extendedWatchDogAVR::enableWatchDog() {
     //  4 seconds: 0bxx1xx000
     //  8 seconds: 0bxx1xx001
 
-    extendedWatchDogAVR::_barksUntilReset = _resetTime_s / 8;
+    // A budget started before the watchdog was enabled is kept
+    if (!extendedWatchDogAVR::_budgetActive) {
+        extendedWatchDogAVR::_barksUntilReset = _resetTime_s / 8;
+    }
     MS_DBG(F("The watch dog is enabled in interrupt-only mode."));
     MS_DBG(F("The interrupt will fire"), extendedWatchDogAVR::_barksUntilReset,
            F("times before the system resets."));
@@ -81,22 +98,66 @@ void extendedWatchDogAVR::disableWatchDog() {
 
 
 void extendedWatchDogAVR::resetWatchDog() {
+    // Feeding the watchdog doesn't extend a budget
+    if (extendedWatchDogAVR::_budgetActive) return;
     extendedWatchDogAVR::_barksUntilReset = _resetTime_s / 8;
+    extendedWatchDogAVR::_warned          = false;
     // Reset the watchdog.
     wdt_reset();
 }
 
 
+void extendedWatchDogAVR::setEarlyWarning(void (*callback)(void),
+                                          uint32_t barksBeforeReset) {
+    _earlyWarning = callback;
+    _warningBarks = barksBeforeReset > 0 ? barksBeforeReset : 1;
+    _warned       = false;
+}
+
+
+void extendedWatchDogAVR::startBudget(uint8_t tag, uint32_t budget_s) {
+    // The ISR reads these, so don't let it fire part way through
+    uint8_t oldSREG = SREG;
+    cli();
+    extendedWatchDogAVR::_budgetTag       = tag;
+    extendedWatchDogAVR::_budgetActive    = true;
+    extendedWatchDogAVR::_barksUntilReset = budget_s > 8 ? (budget_s + 7) / 8
+                                                         : 1;
+    extendedWatchDogAVR::_warned          = false;
+    wdt_reset();
+    SREG = oldSREG;
+}
+
+
+void extendedWatchDogAVR::endBudget(void) {
+    extendedWatchDogAVR::_budgetActive = false;
+    resetWatchDog();
+}
+
+
+bool extendedWatchDogAVR::getLastOverrun(uint8_t* tag) {
+    if (overrunMagic != MS_WATCHDOG_OVERRUN_MAGIC) return false;
+    overrunMagic = 0;
+    *tag         = overrunTag;
+    return true;
+}
+
+
 /**
  * @brief ISR for watchdog early warning
  */
 ISR(WDT_vect) {
     extendedWatchDogAVR::_barksUntilReset--;  // Increament down the counter,
                                               // makes multi cycle WDT possible
+    extendedWatchDogAVR::_barkCount++;
     // MS_DBG(F("\nWatchdog interrupt!"),
     // extendedWatchDogAVR::_barksUntilReset);
     if (extendedWatchDogAVR::_barksUntilReset <= 0) {
-        MCUSR = 0;  // reset flags
+        overrunTag = extendedWatchDogAVR::_budgetActive
+            ? extendedWatchDogAVR::_budgetTag
+            : 0xFF;
+        overrunMagic = MS_WATCHDOG_OVERRUN_MAGIC;
+        MCUSR        = 0;  // reset flags
 
         // Put timer in reset-only mode:
         WDTCSR |= 0b00011000;  // Enter config mode.
@@ -109,6 +170,15 @@ ISR(WDT_vect) {
         // wdt_reset();  // not needed
     } else {
         wdt_reset();  // start timer again (still in interrupt-only mode)
+        // Give the early warning once the timer has been restarted, so the
+        // callback has the full 8s before the next bark
+        if (extendedWatchDogAVR::_earlyWarning != nullptr &&
+            !extendedWatchDogAVR::_warned &&
+            extendedWatchDogAVR::_barksUntilReset <=
+                extendedWatchDogAVR::_warningBarks) {
+            extendedWatchDogAVR::_warned = true;
+            extendedWatchDogAVR::_earlyWarning();
+        }
     }
 }
 
@@ -67,8 +67,57 @@ class extendedWatchDogAVR {
 
     /**
      * @brief Reset the watchdog's clock to prevent the board from resetting.
+     *
+     * This is static so it can be used as a callback; there is only one
+     * watchdog on the processor.
+     */
+    static void resetWatchDog();
+    /**
+     * @brief Set a function to call from the watchdog interrupt shortly before
+     * the watchdog resets the board.
+     *
+     * The function is called once, when the given number of barks are left
+     * before the reset, and is called again only after the watchdog has been
+     * reset.  It runs inside the interrupt, with the next bark 8 seconds
+     * away, so it should only save what would otherwise be lost.  Nothing
+     * that waits on millis() or on another interrupt can be used in it.
+     *
+     * @param callback The function to call; nullptr to stop calling one
+     * @param barksBeforeReset The number of barks left when the function is
+     * called; 1 (the default) calls it at the last bark before the reset.
+     */
+    static void setEarlyWarning(void (*callback)(void),
+                                uint32_t barksBeforeReset = 1);
+    /**
+     * @brief Give the code that follows a budget of its own, instead of the
+     * reset time given to setupWatchDog().
+     *
+     * Until endBudget() or the next startBudget(), resetWatchDog() does
+     * nothing, so the board is reset once the budget runs out no matter how
+     * often the watchdog is fed.  The budget is counted in the 8 second barks
+     * of the watchdog, so it is rounded up to the next multiple of 8 seconds.
+     * If the budget runs out, the tag is kept through the reset and can be
+     * read with getLastOverrun().
+     *
+     * @param tag A number identifying the code given the budget
+     * @param budget_s The budget in seconds
+     */
+    static void startBudget(uint8_t tag, uint32_t budget_s);
+    /**
+     * @brief End the budget given with startBudget() and reset the watchdog.
      */
-    void resetWatchDog();
+    static void endBudget(void);
+    /**
+     * @brief Check whether the watchdog reset the board the last time it
+     * restarted, and for which budget.
+     *
+     * This can only be read once; the record is cleared when it is read.
+     *
+     * @param tag Set to the tag of the budget that ran out, or 0xFF if the
+     * reset time given to setupWatchDog() ran out instead
+     * @return **bool** True if the watchdog reset the board
+     */
+    static bool getLastOverrun(uint8_t* tag);
 
 
     /**
@@ -76,9 +125,35 @@ class extendedWatchDogAVR {
      * before the watchdog reset is allowed.
      */
     static volatile uint32_t _barksUntilReset;
+    /**
+     * @brief The number of times the pre-reset interrupt has fired since the
+     * processor started.
+     */
+    static volatile uint32_t _barkCount;
+    /**
+     * @brief The function to call before the reset; nullptr for none.
+     */
+    static void (*_earlyWarning)(void);
+    /**
+     * @brief The number of barks left when the early warning is given.
+     */
+    static uint32_t _warningBarks;
+    /**
+     * @brief True once the early warning has been given since the watchdog
+     * was last reset.
+     */
+    static volatile bool _warned;
+    /**
+     * @brief True while a budget given with startBudget() is being counted.
+     */
+    static volatile bool _budgetActive;
+    /**
+     * @brief The tag of the budget being counted.
+     */
+    static volatile uint8_t _budgetTag;
 
  private:
-    uint32_t _resetTime_s;
+    static uint32_t _resetTime_s;
 };
 
 #endif  // SRC_WATCHDOGS_WATCHDOGAVR_H_
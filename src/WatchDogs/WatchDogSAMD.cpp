@@ -15,6 +15,20 @@
 #if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
 
 volatile uint32_t extendedWatchDogSAMD::_barksUntilReset = 0;
+volatile uint32_t extendedWatchDogSAMD::_barkCount       = 0;
+uint32_t          extendedWatchDogSAMD::_warningBarks    = 1;
+volatile bool     extendedWatchDogSAMD::_warned          = false;
+volatile bool     extendedWatchDogSAMD::_budgetActive    = false;
+volatile uint8_t  extendedWatchDogSAMD::_budgetTag       = 0;
+uint32_t          extendedWatchDogSAMD::_resetTime_s     = 0;
+
+void (*extendedWatchDogSAMD::_earlyWarning)(void) = nullptr;
+
+// The record of the last reset by the watchdog is in memory that isn't
+// cleared at start up, so it lasts through the reset
+#define MS_WATCHDOG_OVERRUN_MAGIC 0x57444F47UL
+static volatile uint32_t overrunMagic __attribute__((section(".noinit")));
+static volatile uint8_t  overrunTag __attribute__((section(".noinit")));
 
 extendedWatchDogSAMD::extendedWatchDogSAMD() {}
 extendedWatchDogSAMD::~extendedWatchDogSAMD() {
@@ -152,7 +166,10 @@ void extendedWatchDogSAMD::disableWatchDog() {
 
 
 void extendedWatchDogSAMD::resetWatchDog() {
+    // Feeding the watchdog doesn't extend a budget
+    if (extendedWatchDogSAMD::_budgetActive) return;
     extendedWatchDogSAMD::_barksUntilReset = _resetTime_s / 8;
+    extendedWatchDogSAMD::_warned          = false;
     // Write the watchdog clear key value (0xA5) to the watchdog
     // clear register to clear the watchdog timer and reset it.
     WDT->CLEAR.reg = WDT_CLEAR_CLEAR_KEY;
@@ -161,6 +178,44 @@ void extendedWatchDogSAMD::resetWatchDog() {
     WDT->INTFLAG.bit.EW = 1;
 }
 
+void extendedWatchDogSAMD::setEarlyWarning(void (*callback)(void),
+                                           uint32_t barksBeforeReset) {
+    _earlyWarning = callback;
+    _warningBarks = barksBeforeReset > 0 ? barksBeforeReset : 1;
+    _warned       = false;
+}
+
+
+void extendedWatchDogSAMD::startBudget(uint8_t tag, uint32_t budget_s) {
+    // The ISR reads these, so don't let it fire part way through
+    NVIC_DisableIRQ(WDT_IRQn);
+    extendedWatchDogSAMD::_budgetTag       = tag;
+    extendedWatchDogSAMD::_budgetActive    = true;
+    extendedWatchDogSAMD::_barksUntilReset = budget_s > 8 ? (budget_s + 7) / 8
+                                                          : 1;
+    extendedWatchDogSAMD::_warned          = false;
+    WDT->CLEAR.reg                         = WDT_CLEAR_CLEAR_KEY;
+    waitForWDTBitSync();
+    WDT->INTFLAG.bit.EW = 1;
+    NVIC_ClearPendingIRQ(WDT_IRQn);
+    NVIC_EnableIRQ(WDT_IRQn);
+}
+
+
+void extendedWatchDogSAMD::endBudget(void) {
+    extendedWatchDogSAMD::_budgetActive = false;
+    resetWatchDog();
+}
+
+
+bool extendedWatchDogSAMD::getLastOverrun(uint8_t* tag) {
+    if (overrunMagic != MS_WATCHDOG_OVERRUN_MAGIC) return false;
+    overrunMagic = 0;
+    *tag         = overrunTag;
+    return true;
+}
+
+
 void extendedWatchDogSAMD::waitForWDTBitSync() {
 #if defined(__SAMD51__)
     while (WDT->SYNCBUSY.reg) {
@@ -178,10 +233,15 @@ void extendedWatchDogSAMD::waitForWDTBitSync() {
 void WDT_Handler(void) {
     // Increament down the counter, makes multi cycle WDT possible
     extendedWatchDogSAMD::_barksUntilReset--;
+    extendedWatchDogSAMD::_barkCount++;
     // MS_DBG(F("\nWatchdog interrupt!"),
     // extendedWatchDogSAMD::_barksUntilReset);
     if (extendedWatchDogSAMD::_barksUntilReset <=
         0) {  // Clear Early Warning (EW) Interrupt Flag
+        overrunTag = extendedWatchDogSAMD::_budgetActive
+            ? extendedWatchDogSAMD::_budgetTag
+            : 0xFF;
+        overrunMagic = MS_WATCHDOG_OVERRUN_MAGIC;
         WDT->INTFLAG.bit.EW = 1;
         // Writing a value different than WDT_CLEAR_CLEAR_KEY causes reset
         WDT->CLEAR.reg = 0xFF;
@@ -202,6 +262,15 @@ void WDT_Handler(void) {
 #endif
         // Clear Early Warning (EW) Interrupt Flag
         WDT->INTFLAG.bit.EW = 1;
+        // Give the early warning once the timer has been cleared, so the
+        // callback has the full 8s before the next bark
+        if (extendedWatchDogSAMD::_earlyWarning != nullptr &&
+            !extendedWatchDogSAMD::_warned &&
+            extendedWatchDogSAMD::_barksUntilReset <=
+                extendedWatchDogSAMD::_warningBarks) {
+            extendedWatchDogSAMD::_warned = true;
+            extendedWatchDogSAMD::_earlyWarning();
+        }
     }
 }
 
@@ -11,6 +11,26 @@
 #include "dataPublisherBase.h"
 
 char dataPublisher::txBuffer[MS_SEND_BUFFER_SIZE] = {'\0'};
+uint16_t       dataPublisher::txBufferLen       = 0;
+Client*        dataPublisher::txBufferOutClient = nullptr;
+uint16_t       dataPublisher::txBufferSendSize  = MS_SEND_BUFFER_SIZE - 1;
+dataPublisher* dataPublisher::txBufferPublisher = nullptr;
+uint32_t       dataPublisher::_totalBytesSent   = 0;
+
+bool        dataPublisher::_keepAlive  = false;
+Client*     dataPublisher::_openClient = nullptr;
+const char* dataPublisher::_openHost   = nullptr;
+uint16_t    dataPublisher::_openPort   = 0;
+
+dataPublisher::hostCacheEntry dataPublisher::_hostCache[MS_HOST_CACHE_SIZE] =
+    {};
+uint32_t dataPublisher::_hostCacheTTL = 0;
+
+uint32_t dataPublisher::_responseTimeoutMin = 2000L;
+uint32_t dataPublisher::_responseTimeoutMax = 10000L;
+uint32_t dataPublisher::_responseTimeAvg    = 0;
+bool     dataPublisher::_deferralAllowed    = false;
+bool     dataPublisher::_deferAll           = false;
 
 // Basic chunks of HTTP
 const char* dataPublisher::getHeader  = "GET ";
@@ -37,7 +57,9 @@ dataPublisher::dataPublisher(Logger& baseLogger, Client* inClient,
     _baseLogger->registerDataPublisher(this);  // register self with logger
 }
 // Destructor
-dataPublisher::~dataPublisher() {}
+dataPublisher::~dataPublisher() {
+    clearRequestPrefix();
+}
 
 
 // Sets the client
@@ -54,13 +76,369 @@ void dataPublisher::attachToLogger(Logger& baseLogger) {
 
 
 // Sets the parameters for frequency of sending and any offset, if needed
-// NOTE:  These parameters are not currently used!!
 void dataPublisher::setSendFrequency(uint8_t sendEveryX, uint8_t sendOffset) {
     _sendEveryX = sendEveryX;
     _sendOffset = sendOffset;
 }
 
 
+// This connects a client, reusing the connection kept open if it is to the
+// same place
+bool dataPublisher::connectClient(Client* outClient, const char* host,
+                                  uint16_t port) {
+    // Count the bytes of the coming request for this publisher
+    txBufferPublisher = this;
+    if (_openClient == outClient && outClient->connected() &&
+        _openPort == port && strcmp(_openHost, host) == 0) {
+        MS_DBG(F("Reusing the open connection to"), host);
+        _lastConnectTime = 0;
+        return true;
+    }
+    closeConnection();
+    uint32_t start = millis();
+    if (!openConnection(outClient, host, port)) return false;
+    _lastConnectTime = millis() - start;
+    if (_keepAlive) {
+        _openClient = outClient;
+        _openHost   = host;
+        _openPort   = port;
+    }
+    return true;
+}
+
+
+// This connects by the saved address of the host, looking it up again when
+// it's old or doesn't work
+bool dataPublisher::openConnection(Client* outClient, const char* host,
+                                   uint16_t port) {
+    loggerModem* modem = _baseLogger != nullptr ? _baseLogger->_logModem
+                                                : nullptr;
+    if (_hostCacheTTL == 0 || modem == nullptr) {
+        return outClient->connect(host, port);
+    }
+    uint32_t now = Logger::markedUTCEpochTime != 0
+        ? Logger::markedUTCEpochTime
+        : Logger::getCycleUTCEpoch();
+
+    // Find the host, or else the oldest entry to replace
+    hostCacheEntry* entry = &_hostCache[0];
+    for (uint8_t i = 0; i < MS_HOST_CACHE_SIZE; i++) {
+        if (_hostCache[i].host != nullptr &&
+            strcmp(_hostCache[i].host, host) == 0) {
+            entry = &_hostCache[i];
+            break;
+        }
+        if (_hostCache[i].resolvedAt < entry->resolvedAt) {
+            entry = &_hostCache[i];
+        }
+    }
+    if (entry->host != nullptr && strcmp(entry->host, host) == 0 &&
+        now - entry->resolvedAt < _hostCacheTTL) {
+        MS_DBG(F("Connecting to the saved address of"), host);
+        if (outClient->connect(entry->ip, port)) return true;
+        MS_DBG(F("The saved address failed; looking it up again"));
+    }
+
+    entry->host = nullptr;
+    IPAddress ip;
+    if (!modem->lookupHostIP(host, ip)) {
+        return outClient->connect(host, port);
+    }
+    entry->host       = host;
+    entry->ip         = ip;
+    entry->resolvedAt = now;
+    return outClient->connect(ip, port);
+}
+
+
+// This keeps the connection open for another request, if possible, or
+// closes it
+void dataPublisher::releaseClient(Client* outClient) {
+    if (_keepAlive && _openClient == outClient &&
+        finishResponse(outClient, 5000L)) {
+        MS_DBG(F("Keeping the connection to"), _openHost, F("open"));
+        return;
+    }
+    if (_openClient == outClient) _openClient = nullptr;
+    outClient->stop();
+}
+
+
+// This closes the connection being kept open, if any
+void dataPublisher::closeConnection(void) {
+    if (_openClient == nullptr) return;
+    MS_DBG(F("Closing the connection to"), _openHost);
+    _openClient->stop();
+    _openClient = nullptr;
+}
+
+
+// This reads the headers and the body of a response, so nothing is left
+// waiting on the connection
+bool dataPublisher::finishResponse(Client* outClient, uint32_t timeout) {
+    char     line[24];
+    uint8_t  lineLen       = 0;
+    bool     headersDone   = false;
+    bool     keepOpen      = true;
+    int32_t  contentLength = -1;
+    uint32_t start         = millis();
+    // Read the rest of the status line and the headers, one line at a time
+    while (!headersDone && millis() - start < timeout) {
+        if (!outClient->available()) {
+            if (!outClient->connected()) return false;
+            delay(2);
+            continue;
+        }
+        char c = outClient->read();
+        if (c == '\r') continue;
+        if (c != '\n') {
+            // Only the start of each line is needed
+            if (lineLen < sizeof(line) - 1) line[lineLen++] = c;
+            continue;
+        }
+        line[lineLen] = '\0';
+        if (lineLen == 0) {
+            headersDone = true;
+        } else if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            contentLength = atol(line + 15);
+        } else if (strncasecmp(line, "Connection: close", 17) == 0 ||
+                   strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+            // Chunked bodies are not worth decoding just to skip them
+            keepOpen = false;
+        }
+        lineLen = 0;
+    }
+    // Without a length, the body only ends when the server closes the socket
+    if (!headersDone || contentLength < 0) return false;
+    while (contentLength > 0 && millis() - start < timeout) {
+        if (outClient->available()) {
+            outClient->read();
+            contentLength--;
+        } else if (!outClient->connected()) {
+            return false;
+        } else {
+            delay(2);
+        }
+    }
+    return keepOpen && contentLength == 0;
+}
+
+
+// This handles the response to a request in the publisher's response mode
+int16_t dataPublisher::finishRequest(Client* outClient) {
+    if (_responseMode == responseFireAndForget) {
+        MS_DBG(F("Not waiting for a response"));
+        if (_openClient == outClient) _openClient = nullptr;
+        outClient->stop();
+        return 202;
+    }
+    if (_deferralAllowed &&
+        (_responseMode == responseDeferred || _deferAll)) {
+        MS_DBG(F("Leaving the response to be read later"));
+        // The socket is not free for another request until it is read
+        if (_openClient == outClient) _openClient = nullptr;
+        _pendingClient = outClient;
+        _pendingSent   = millis();
+        return 0;
+    }
+    int16_t responseCode = readResponseCode(outClient, millis());
+    releaseClient(outClient);
+    return responseCode;
+}
+
+
+// This reads the response to a deferred request
+int16_t dataPublisher::collectResponse(void) {
+    if (_pendingClient == nullptr) return 0;
+    Client* outClient = _pendingClient;
+    _pendingClient    = nullptr;
+    int16_t responseCode = readResponseCode(outClient, _pendingSent);
+    outClient->stop();
+    return responseCode;
+}
+
+
+// This waits for the start of a response and reads the http code
+int16_t dataPublisher::readResponseCode(Client* outClient, uint32_t sentAt) {
+    // Wait three times as long as responses usually take, within the limits
+    uint32_t timeout = _responseTimeoutMax;
+    if (_responseTimeAvg != 0 && _responseTimeAvg * 3 < timeout) {
+        timeout = _responseTimeAvg * 3;
+        if (timeout < _responseTimeoutMin) timeout = _responseTimeoutMin;
+    }
+    while ((millis() - sentAt) < timeout && outClient->available() < 12) {
+        delay(10);
+    }
+
+    // Read only the first 12 characters of the response
+    // We're only reading as far as the http code, anything beyond that
+    // we don't care about.
+    char    statusLine[13] = "";
+    int16_t responseCode   = 504;
+    if (outClient->available() >= 12 &&
+        outClient->readBytes(statusLine, 12) == 12) {
+        uint32_t elapsed = millis() - sentAt;
+        _responseTimeAvg = _responseTimeAvg == 0
+            ? elapsed
+            : (_responseTimeAvg * 3 + elapsed) / 4;
+        statusLine[12]    = '\0';
+        responseCode      = atoi(statusLine + 9);
+        _lastResponseTime = elapsed;
+        MS_DBG(F("Response after"), elapsed, F("ms"));
+    } else {
+        // Give the next response the full time
+        MS_DBG(F("No response after"), timeout, F("ms"));
+        _responseTimeAvg  = 0;
+        _lastResponseTime = -1;
+    }
+
+    PRINTOUT(F("-- Response Code --"));
+    PRINTOUT(responseCode);
+
+    return responseCode;
+}
+
+
+// This counts failures and sets when to try again
+void dataPublisher::recordResult(int16_t response, uint32_t intervalNumber) {
+    _lastResult = response;
+    if (publishSucceeded(response)) {
+        markValuesSent();
+        if (_failuresToOpen > 0 && _consecutiveFailures >= _failuresToOpen) {
+            PRINTOUT(F("Publishing to"), getEndpoint(), F("has recovered"));
+        }
+        _consecutiveFailures = 0;
+        return;
+    }
+    // Rejected data says nothing about whether the endpoint is up
+    if (!publishRetryable(response)) return;
+    if (_consecutiveFailures < 255) _consecutiveFailures++;
+    if (_failuresToOpen == 0 || _consecutiveFailures < _failuresToOpen) return;
+
+    // Double the wait with each failure past the threshold, then add jitter
+    uint8_t  doublings = _consecutiveFailures - _failuresToOpen;
+    uint32_t skip      = doublings < 16 ? 1UL << doublings : _maxSkipIntervals;
+    if (skip > _maxSkipIntervals) skip = _maxSkipIntervals;
+    skip += random(skip / 2 + 1);
+    _retryInterval = intervalNumber + 1 + skip;
+    PRINTOUT(F("Publishing to"), getEndpoint(), F("failed"),
+             _consecutiveFailures, F("times in a row; skipping it for"), skip,
+             F("intervals"));
+}
+
+
+// This checks a value against the missing value and its deadband
+bool dataPublisher::isValueSentAtI(uint8_t position_i) {
+    if (_stalePolicy == STALE_OMIT &&
+        _baseLogger->isValueStaleAtI(position_i)) {
+        return false;
+    }
+    if (!_omitMissing && _deadbands == nullptr) return true;
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    formatSentValueAtI(position_i, valueBuffer, sizeof(valueBuffer));
+    float value = atof(valueBuffer);
+    if (_omitMissing && value == -9999) return false;
+    if (_deadbands == nullptr || _lastSentValues == nullptr ||
+        _deadbands[position_i] < 0 || isnan(_lastSentValues[position_i])) {
+        return true;
+    }
+    return fabs(value - _lastSentValues[position_i]) > _deadbands[position_i];
+}
+
+
+// A stale value that can't be left out is sent as missing
+size_t dataPublisher::formatSentValueAtI(uint8_t position_i, char* buffer,
+                                         size_t bufferLen) {
+    if (_stalePolicy != STALE_KEEP &&
+        _baseLogger->isValueStaleAtI(position_i)) {
+        strncpy(buffer, "-9999", bufferLen - 1);
+        buffer[bufferLen - 1] = '\0';
+        return strlen(buffer);
+    }
+    return _baseLogger->formatValueAtI(position_i, buffer, bufferLen);
+}
+
+
+// This counts the values to send and how long they are
+size_t dataPublisher::getSentValuesLength(uint8_t& nSent) {
+    if (!_omitMissing && _deadbands == nullptr && _subset == nullptr &&
+        _stalePolicy == STALE_KEEP) {
+        nSent = _baseLogger->getArrayVarCount();
+        return _baseLogger->getFormattedValuesLength();
+    }
+    char   valueBuffer[MS_VALUE_BUFFER_SIZE];
+    size_t valuesLength = 0;
+    nSent               = 0;
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        if (!isValueSentAtI(i)) continue;
+        nSent++;
+        valuesLength += formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+    }
+    return valuesLength;
+}
+
+
+// This keeps the values that were just accepted to compare against
+void dataPublisher::markValuesSent(void) {
+    if (_deadbands == nullptr) return;
+    uint8_t nVars = _baseLogger->getArrayVarCount();
+    if (_lastSentValues == nullptr) {
+        _lastSentValues = new float[nVars];
+        for (uint8_t i = 0; i < nVars; i++) _lastSentValues[i] = NAN;
+    }
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        // The values are checked again just as they were for the request
+        if (!isValueSentAtI(i)) continue;
+        formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+        _lastSentValues[i] = atof(valueBuffer);
+    }
+}
+
+
+// This returns a measure of the transfers in the last interval
+float dataPublisher::getTransferMetric(transferMetric metric) {
+    switch (metric) {
+        case connectTime:
+            return _lastConnectTime < 0 ? -9999 : _lastConnectTime;
+        case responseTime:
+            return _lastResponseTime < 0 ? -9999 : _lastResponseTime;
+        case bytesSent: return _bytesSent;
+        case lastResult: return _lastResult;
+        case failureCount: return _consecutiveFailures;
+        default: return -9999;
+    }
+}
+
+
+// This clears the transfer measures for a new interval
+void dataPublisher::resetTransferMetrics(void) {
+    _lastConnectTime  = -1;
+    _lastResponseTime = -1;
+    _bytesSent        = 0;
+    _lastResult       = -9999;
+}
+
+
+// This adds a variable to the front of the list of metric variables
+PublisherMetricVariable* dataPublisher::registerMetricVariable(
+    PublisherMetricVariable* metricVariable) {
+    PublisherMetricVariable* next = _metricVariables;
+    _metricVariables              = metricVariable;
+    return next;
+}
+
+
+// This passes the transfer measures along the list of metric variables
+void dataPublisher::notifyMetricVariables(void) {
+    if (_metricVariables != nullptr) {
+        _metricVariables->onPublisherUpdate(this);
+    }
+}
+
+
 // "Begins" the publisher - attaches client and logger
 void dataPublisher::begin(Logger& baseLogger, Client* inClient) {
     setClient(inClient);
@@ -68,40 +446,186 @@ void dataPublisher::begin(Logger& baseLogger, Client* inClient) {
 }
 void dataPublisher::begin(Logger& baseLogger) {
     attachToLogger(baseLogger);
+    renderRequestPrefix();
 }
 
 
 // Empties the outgoing buffer
 void dataPublisher::emptyTxBuffer(void) {
     MS_DBG(F("Dumping the TX Buffer"));
-    for (int i = 0; i < MS_SEND_BUFFER_SIZE; i++) { txBuffer[i] = '\0'; }
+    txBufferLen = 0;
+    txBuffer[0] = '\0';
+}
+
+
+// Empties the outgoing buffer and sets where to send it when it fills
+void dataPublisher::txBufferInit(Client* outClient) {
+    txBufferOutClient = outClient;
+    txBufferSendSize  = MS_SEND_BUFFER_SIZE - 1;
+    // Send no more at once than the modem does, so no write is split
+    loggerModem* modem =
+        (outClient != nullptr && txBufferPublisher != nullptr &&
+         txBufferPublisher->_baseLogger != nullptr)
+        ? txBufferPublisher->_baseLogger->_logModem
+        : nullptr;
+    if (modem != nullptr) {
+        uint16_t maxSend = modem->getMaxSendSize();
+        if (maxSend > 0 && maxSend < txBufferSendSize) {
+            txBufferSendSize = maxSend;
+        }
+    }
+    emptyTxBuffer();
+}
+
+
+// Adds characters to the outgoing buffer, sending it out as it fills
+void dataPublisher::txBufferAppend(const char* data, size_t length) {
+    while (length > 0) {
+        // A run of at least a whole send with nothing waiting ahead of it
+        // goes to the client from where it is, without a copy
+        if (txBufferLen == 0 && txBufferOutClient != nullptr &&
+            length >= txBufferSendSize) {
+            txBufferSend(data, txBufferSendSize);
+            data += txBufferSendSize;
+            length -= txBufferSendSize;
+            continue;
+        }
+        size_t space = txBufferSendSize - txBufferLen;
+        if (space == 0) {
+            if (txBufferOutClient == nullptr) {
+                MS_DBG(F("TX Buffer is full, dropping"), length,
+                       F("characters!"));
+                break;
+            }
+            txBufferFlush();
+            continue;
+        }
+        size_t chunk = length < space ? length : space;
+        memcpy(txBuffer + txBufferLen, data, chunk);
+        txBufferLen += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    txBuffer[txBufferLen] = '\0';
+}
+void dataPublisher::txBufferAppend(const char* s) {
+    txBufferAppend(s, strlen(s));
+}
+void dataPublisher::txBufferAppend(char c) {
+    txBufferAppend(&c, 1);
+}
+
+
+// Sends the outgoing buffer to the client and empties it
+void dataPublisher::txBufferFlush(bool addNewLine) {
+    if (txBufferOutClient == nullptr) return;
+    // The line ending goes out with the rest, not in a send of its own
+    if (addNewLine) txBufferAppend("\r\n", 2);
+    if (txBufferLen == 0) return;
+    txBufferSend(txBuffer, txBufferLen);
+    emptyTxBuffer();
+}
+
+
+// Writes characters to the client, echoing them and counting them
+void dataPublisher::txBufferSend(const char* data, size_t length) {
+// Send the characters to the serial for debugging
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
+    MS_CONSOLE_OUTPUT.write(data, length);
+    MS_CONSOLE_OUTPUT.flush();
+#endif
+    txBufferOutClient->write(reinterpret_cast<const uint8_t*>(data), length);
+    txBufferOutClient->flush();
+    if (txBufferPublisher != nullptr) txBufferPublisher->_bytesSent += length;
+    _totalBytesSent += length;
 }
 
 
 // Returns how much space is left in the buffer
 int dataPublisher::bufferFree(void) {
-    MS_DBG(F("Current TX Buffer Size:"), strlen(txBuffer));
-    return MS_SEND_BUFFER_SIZE - strlen(txBuffer);
+    MS_DBG(F("Current TX Buffer Size:"), txBufferLen);
+    return txBufferSendSize - txBufferLen;
 }
 
 
 // Sends the tx buffer to a stream and then clears it
 void dataPublisher::printTxBuffer(Stream* stream, bool addNewLine) {
 // Send the out buffer so far to the serial for debugging
-#if defined(STANDARD_SERIAL_OUTPUT)
-    STANDARD_SERIAL_OUTPUT.write(txBuffer, strlen(txBuffer));
+#if defined(STANDARD_SERIAL_OUTPUT) && !defined(MS_QUIET_OUTPUT)
+    MS_CONSOLE_OUTPUT.write(txBuffer, txBufferLen);
     if (addNewLine) { PRINTOUT('\n'); }
-    STANDARD_SERIAL_OUTPUT.flush();
+    MS_CONSOLE_OUTPUT.flush();
 #endif
-    stream->write(txBuffer, strlen(txBuffer));
+    stream->write(txBuffer, txBufferLen);
     if (addNewLine) { stream->print("\r\n"); }
     stream->flush();
+    if (stream == txBufferOutClient) {
+        uint16_t sent = txBufferLen + (addNewLine ? 2 : 0);
+        if (txBufferPublisher != nullptr) txBufferPublisher->_bytesSent += sent;
+        _totalBytesSent += sent;
+    }
 
     // empty the buffer after printing it
     emptyTxBuffer();
 }
 
 
+// By default, there is no prefix
+uint8_t dataPublisher::getRequestPrefixParts(const char* parts[]) {
+    (void)parts;
+    return 0;
+}
+
+
+// This joins the pieces of the request prefix into one block
+void dataPublisher::renderRequestPrefix(void) {
+    clearRequestPrefix();
+    const char* parts[MS_REQUEST_PREFIX_PARTS];
+    uint8_t     nParts = getRequestPrefixParts(parts);
+    if (nParts == 0) return;
+    size_t len = 0;
+    for (uint8_t i = 0; i < nParts; i++) {
+        if (parts[i] != nullptr) len += strlen(parts[i]);
+    }
+    _requestPrefix = new char[len + 1];
+    if (_requestPrefix == nullptr) return;
+    char* end = _requestPrefix;
+    for (uint8_t i = 0; i < nParts; i++) {
+        if (parts[i] == nullptr) continue;
+        size_t partLen = strlen(parts[i]);
+        memcpy(end, parts[i], partLen);
+        end += partLen;
+    }
+    *end              = '\0';
+    _requestPrefixLen = len;
+    MS_DBG(F("Rendered a request prefix of"), len, F("characters"));
+}
+
+
+// This frees the request prefix
+void dataPublisher::clearRequestPrefix(void) {
+    delete[] _requestPrefix;
+    _requestPrefix    = nullptr;
+    _requestPrefixLen = 0;
+}
+
+
+// This adds the request prefix to the outgoing buffer with one copy
+void dataPublisher::txBufferAppendPrefix(void) {
+    if (_requestPrefix == nullptr) renderRequestPrefix();
+    if (_requestPrefix != nullptr) {
+        txBufferAppend(_requestPrefix, _requestPrefixLen);
+        return;
+    }
+    // Without the RAM for the block, add the pieces one at a time
+    const char* parts[MS_REQUEST_PREFIX_PARTS];
+    uint8_t     nParts = getRequestPrefixParts(parts);
+    for (uint8_t i = 0; i < nParts; i++) {
+        if (parts[i] != nullptr) txBufferAppend(parts[i]);
+    }
+}
+
+
 // This sends data on the "default" client of the modem
 int16_t dataPublisher::publishData() {
     if (_inClient == nullptr) {
@@ -111,6 +635,20 @@ int16_t dataPublisher::publishData() {
         return publishData(_inClient);
     }
 }
+// Publishers that can't send batches just report that nothing was sent
+int16_t dataPublisher::publishBatch(Client* outClient) {
+    (void)outClient;
+    MS_DBG(F("This publisher cannot send batches of records!"));
+    return 0;
+}
+int16_t dataPublisher::publishBatch() {
+    if (_inClient == nullptr) {
+        PRINTOUT(F("ERROR! No web client assigned to publish data!"));
+        return 0;
+    } else {
+        return publishBatch(_inClient);
+    }
+}
 // Duplicates for backwards compatibility
 int16_t dataPublisher::sendData(Client* outClient) {
     return publishData(outClient);
@@ -147,3 +685,37 @@ String dataPublisher::parseMQTTState(int state) {
         default: return String(state) + ": UNKNOWN";
     }
 }
+
+
+// ============================================================================
+//  Functions for the variables reporting on a publisher's transfers
+// ============================================================================
+
+PublisherMetricVariable::PublisherMetricVariable(
+    dataPublisher* parentPublisher, dataPublisher::transferMetric metric,
+    const char* uuid, const char* varCode)
+    : Variable(static_cast<float (*)()>(nullptr), 0, "counter", "count",
+               varCode, uuid),
+      _metric(metric) {
+    switch (metric) {
+        case dataPublisher::connectTime:
+        case dataPublisher::responseTime:
+            setVarName("elapsedTime");
+            setVarUnit("millisecond");
+            break;
+        case dataPublisher::bytesSent: setVarUnit("byte"); break;
+        case dataPublisher::lastResult: setVarUnit("dimensionless"); break;
+        default: break;
+    }
+    _nextMetricVariable = parentPublisher->registerMetricVariable(this);
+}
+
+
+// This takes the value from the publisher and passes the update along
+void PublisherMetricVariable::onPublisherUpdate(
+    dataPublisher* parentPublisher) {
+    _currentValue = parentPublisher->getTransferMetric(_metric);
+    if (_nextMetricVariable != nullptr) {
+        _nextMetricVariable->onPublisherUpdate(parentPublisher);
+    }
+}
@@ -47,12 +47,38 @@
 #define MS_SEND_BUFFER_SIZE 750
 #endif
 
+/**
+ * @def MS_HOST_CACHE_SIZE
+ * @brief The number of host addresses kept by dataPublisher::setHostCache().
+ *
+ * This can be changed by setting the build flag MS_HOST_CACHE_SIZE when
+ * compiling.
+ *
+ * @ingroup the_publishers
+ */
+#ifndef MS_HOST_CACHE_SIZE
+#define MS_HOST_CACHE_SIZE 4
+#endif
+
+/**
+ * @def MS_REQUEST_PREFIX_PARTS
+ * @brief The most pieces a publisher can join into its request prefix; see
+ * dataPublisher::getRequestPrefixParts().
+ *
+ * @ingroup the_publishers
+ */
+#ifndef MS_REQUEST_PREFIX_PARTS
+#define MS_REQUEST_PREFIX_PARTS 12
+#endif
+
 // Included Dependencies
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 #include "LoggerBase.h"
 #include "Client.h"
 
+class PublisherMetricVariable;
+
 /**
  * @brief The dataPublisher class is a virtual class used by other publishers to
  * distribute data online.
@@ -86,11 +112,10 @@ class dataPublisher {
      * logger.
      *
      * @param baseLogger The logger supplying the data to be published
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -107,11 +132,10 @@ class dataPublisher {
      * @param inClient An Arduino client instance to use to print data to.
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -148,15 +172,495 @@ class dataPublisher {
      * @brief Set the parameters for frequency of sending and any offset, if
      * needed.
      *
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * The publisher only sends on logging intervals where the number of the
+     * interval since the epoch, modulo sendEveryX, equals sendOffset.  The
+     * records from the skipped intervals are saved to this publisher's backlog
+     * on the SD card and sent after the next successful publish, as a batch if
+     * the publisher supports it, unless setSaveSkippedRecords() turns that
+     * off.  The logger only wakes the modem on intervals
+     * where at least one publisher is due.
      *
-     * @note These parameters are not currently used!
+     * @param sendEveryX Send on every Xth logging interval; 0 or 1 to send on
+     * every interval
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX
      */
     void setSendFrequency(uint8_t sendEveryX, uint8_t sendOffset);
+    /**
+     * @brief Set whether the records from the intervals skipped by
+     * setSendFrequency() are saved and sent later.
+     *
+     * Turn this off for a publisher that only sends a summary of each
+     * window, as with AggregateVariable, so the records in between are only
+     * logged to the SD card.
+     *
+     * @param saveSkipped True to save the skipped records to the backlog.
+     * Default is true.
+     */
+    void setSaveSkippedRecords(bool saveSkipped) {
+        _saveSkipped = saveSkipped;
+    }
+
+    /**
+     * @brief Set whether to keep a backlog on the SD card of the records that
+     * could not be sent to this publisher.
+     *
+     * When enabled, the logger saves each record that failed with a timeout,
+     * a lost connection, or a server (5xx) error to a backlog file for this
+     * publisher.  After the next successful publish, saved records are sent
+     * oldest first, within the budget set by
+     * Logger::setBacklogReplayBudget().  Records rejected by the server with
+     * any other error are dropped, since they would never be accepted.
+     *
+     * @param enableBacklog True to keep a backlog of unsent records
+     */
+    void setBacklog(bool enableBacklog = true) {
+        _useBacklog = enableBacklog;
+    }
+    /**
+     * @brief Check if the publisher should send on a logging interval.
+     *
+     * @param intervalNumber The number of the logging interval since the epoch
+     * @return **bool** True if the publisher is due to send on that interval
+     */
+    bool isSendDue(uint32_t intervalNumber) {
+        if (_sendEveryX <= 1) return true;
+        return intervalNumber % _sendEveryX == _sendOffset % _sendEveryX;
+    }
+    /**
+     * @brief Set the priority of the publisher.
+     *
+     * The logger sends the publishers in order of priority, lowest number
+     * first; publishers of the same priority go in the order they were
+     * registered.  A critical publisher, of priority 0, always sends its
+     * record, while the others only send theirs, and every publisher only
+     * sends its backlog, while there's some of the session's budget left
+     * (see Logger::setPublishBudget()).  A record held back by the budget is
+     * saved to the backlog if one is kept.
+     *
+     * @param priority The priority; 0 for critical.  Default is 1.
+     */
+    void setPriority(uint8_t priority) {
+        _priority = priority;
+    }
+    /**
+     * @brief Get the priority of the publisher.
+     *
+     * @return **uint8_t** The priority; 0 for critical
+     */
+    uint8_t getPriority(void) {
+        return _priority;
+    }
+    /**
+     * @brief Get the bytes sent by all of the publishers since the program
+     * started, for budgeting a session.
+     *
+     * @return **uint32_t** The bytes sent, as counted by the transfer
+     * measures
+     */
+    static uint32_t getTotalBytesSent(void) {
+        return _totalBytesSent;
+    }
+    /**
+     * @brief Set how the publisher backs off from an endpoint that keeps
+     * failing.
+     *
+     * After the given number of failed publishes in a row, counting only the
+     * failures worth retrying (see publishRetryable()), the publisher's
+     * "circuit" opens.  The publisher is then skipped, without waking the
+     * modem for it, and its records are saved to the backlog if one is kept.
+     * It is tried again after a number of logging intervals that doubles with
+     * each further failure, up to the maximum, plus a random jitter of up to
+     * half as many intervals so that a fleet of loggers does not retry all at
+     * once.  The first success closes the circuit again.  Backoff is
+     * off until this is called.
+     *
+     * @param failuresToOpen The number of failures in a row that open the
+     * circuit; 0 to never skip the publisher.  Default is 3.
+     * @param maxSkipIntervals The most logging intervals to wait between
+     * tries.  Default is 64.
+     */
+    void setRetryBackoff(uint8_t failuresToOpen = 3,
+                         uint16_t maxSkipIntervals = 64) {
+        _failuresToOpen   = failuresToOpen;
+        _maxSkipIntervals = maxSkipIntervals;
+    }
+    /**
+     * @brief Check if the publisher is being skipped after repeated failures.
+     *
+     * @param intervalNumber The number of the logging interval since the epoch
+     * @return **bool** True if the publisher should not be tried on that
+     * interval
+     */
+    bool isCircuitOpen(uint32_t intervalNumber) {
+        return _failuresToOpen > 0 && _consecutiveFailures >= _failuresToOpen &&
+            static_cast<int32_t>(intervalNumber - _retryInterval) < 0;
+    }
+    /**
+     * @brief Update the failure count and backoff from the result of a
+     * publish.
+     *
+     * @param response The value returned by publishData()
+     * @param intervalNumber The number of the logging interval of the publish
+     */
+    void recordResult(int16_t response, uint32_t intervalNumber);
+    /**
+     * @brief Check if the publisher sends less often than every logging
+     * interval, saving the records from the skipped intervals.
+     *
+     * @return **bool** True if sendEveryX is more than 1 and the skipped
+     * records are saved
+     */
+    bool getSendsDeferred(void) {
+        return _sendEveryX > 1 && _saveSkipped;
+    }
+    /**
+     * @brief Get whether a backlog of unsent records is kept.
+     *
+     * @return **bool** True if a backlog of unsent records is kept
+     */
+    bool getBacklog(void) {
+        return _useBacklog;
+    }
+    /**
+     * @brief Set which of the logger's variables this publisher sends.
+     *
+     * Every variable is still logged to the SD card, but only these are
+     * formatted and sent, in the order given - for ThingSpeak, the first 8
+     * of them fill the channel's fields.  The backlog keeps every variable,
+     * so the subset can be changed without losing saved records.
+     *
+     * @param positions An array of positions in the logger's variable array,
+     * which must stay in memory; a nullptr sends every variable.
+     * @param count The number of positions in the array
+     */
+    void setVariableSubset(const uint8_t* positions, uint8_t count) {
+        _subset      = positions;
+        _subsetCount = positions != nullptr ? count : 0;
+    }
+    /**
+     * @brief Get the number of variables this publisher sends.
+     *
+     * @return **uint8_t** The size of the subset, or of the whole variable
+     * array if no subset is set
+     */
+    uint8_t getSentVarCount(void) {
+        return _subset != nullptr ? _subsetCount
+                                  : _baseLogger->getArrayVarCount();
+    }
+    /**
+     * @brief Get the position in the logger's variable array of one of the
+     * variables this publisher sends.
+     *
+     * @param n The number of the sent variable, from 0 to getSentVarCount()
+     * @return **uint8_t** The position of the variable in the logger's array
+     */
+    uint8_t getSentVarPosition(uint8_t n) {
+        return _subset != nullptr ? _subset[n] : n;
+    }
+    /**
+     * @brief Set whether to leave missing (-9999) values out of the request
+     * for the current record.
+     *
+     * Only publishers that name each value they send - the EnviroDIY,
+     * Ubidots, and ThingSpeak publishers - can leave values out.  Batches of
+     * backlogged records are always sent whole.
+     *
+     * @param omitMissing True to leave out missing values
+     */
+    void setOmitMissing(bool omitMissing = true) {
+        _omitMissing = omitMissing;
+    }
+    /**
+     * @brief Set how much each variable's value must change before it is sent
+     * again.
+     *
+     * Each value is compared with the value of the same variable in the last
+     * request the server accepted, and is left out of the request unless it
+     * differs by more than the variable's deadband.  As with
+     * setOmitMissing(), this is only done by publishers that name each
+     * value, and only for the current record.
+     *
+     * @param deadbands An array holding a deadband for each variable, in the
+     * order of the logger's variable array, which must stay in memory; use a
+     * negative deadband to always send a variable.  A nullptr sends every
+     * value.
+     */
+    void setChangeDeadbands(const float* deadbands) {
+        _deadbands = deadbands;
+    }
+    /**
+     * @brief Set what this publisher does with values that were not measured
+     * for the current record.
+     *
+     * Values are stale by the age given to Logger::setStalePolicy().  As for
+     * setOmitMissing(), only the EnviroDIY, Ubidots, and ThingSpeak
+     * publishers can leave values out with #STALE_OMIT; the others send
+     * -9999.  Records replayed from a backlog are sent as they were saved.
+     *
+     * @param policy What to do with the stale values.  Default is
+     * #STALE_KEEP.
+     */
+    void setStalePolicy(staleValuePolicy policy) {
+        _stalePolicy = policy;
+    }
+    /**
+     * @brief Check if the value of the variable at the given position in the
+     * current record should be sent.
+     *
+     * @param position_i The position of the variable in the logger's array
+     * @return **bool** False if the value is missing and missing values are
+     * left out, if it's stale and stale values are left out, or if it has
+     * not moved beyond its deadband.
+     */
+    bool isValueSentAtI(uint8_t position_i);
+    /**
+     * @brief Write the value of the variable at the given position as this
+     * publisher sends it, with its stale value policy applied.
+     *
+     * @param position_i The position of the variable in the logger's array
+     * @param buffer The buffer to write the value into
+     * @param bufferLen The size of the buffer, including space for the
+     * terminating null
+     * @return **size_t** The number of characters written, not including the
+     * terminating null.
+     */
+    size_t formatSentValueAtI(uint8_t position_i, char* buffer,
+                              size_t bufferLen);
+    /**
+     * @brief Check if the result of publishData() means the data was accepted.
+     *
+     * @param response The value returned by publishData()
+     * @return **bool** True for a 2xx HTTP response, or 1 from an MQTT
+     * publisher.
+     */
+    static bool publishSucceeded(int16_t response) {
+        return response == 1 || (response >= 200 && response < 300);
+    }
+    /**
+     * @brief Check if a failed publishData() is worth trying again later.
+     *
+     * @param response The value returned by publishData()
+     * @return **bool** True if the failure was from the connection, a timeout,
+     * rate limiting, or the server - not from the data itself.
+     */
+    static bool publishRetryable(int16_t response) {
+        return response <= 0 || response == 408 || response == 429 ||
+            response >= 500;
+    }
+
+    /**
+     * @brief Get the most backlogged records this publisher can send in one
+     * request with publishBatch().
+     *
+     * @return **uint8_t** The most records per request; 1 if the publisher
+     * can only send one record at a time with publishData().
+     */
+    virtual uint8_t getMaxBatchRecords(void) {
+        return 1;
+    }
+    /**
+     * @brief Send all of the records in the logger's current backlog batch in
+     * a single request.
+     *
+     * The records are read with Logger::getBatchCount(),
+     * Logger::getBatchTime(), and Logger::formatBatchValueAtI().  This is only
+     * called for publishers that return more than 1 from
+     * getMaxBatchRecords(), which must override it.
+     *
+     * @param outClient An Arduino client instance to use to print data to.
+     * @return **int16_t** The result of publishing data.  May be an http
+     * response code or a result code from PubSubClient.
+     */
+    virtual int16_t publishBatch(Client* outClient);
+    /**
+     * @brief Send the logger's current backlog batch using the client set
+     * for this publisher.
+     *
+     * @return **int16_t** The result of publishing data.
+     */
+    virtual int16_t publishBatch(void);
+
+    /**
+     * @brief Set whether HTTP publishers keep their connection open between
+     * requests.
+     *
+     * With keep-alive enabled, a publisher that finishes a request reads the
+     * whole response and leaves the socket open.  The next request to the
+     * same host and port on the same client - from another publisher or from
+     * the backlog - reuses it instead of opening a new connection.  The
+     * connection is closed at the end of Logger::publishDataToRemotes(), when
+     * a different host is needed, or when the server asks to close it.
+     *
+     * @param keepAlive True to reuse connections between requests
+     */
+    static void setKeepAlive(bool keepAlive = true) {
+        _keepAlive = keepAlive;
+    }
+    /**
+     * @brief Get whether HTTP publishers keep their connection open between
+     * requests.
+     *
+     * @return **bool** True if connections are reused between requests
+     */
+    static bool getKeepAlive(void) {
+        return _keepAlive;
+    }
+    /**
+     * @brief Close any connection being kept open between requests.
+     */
+    static void closeConnection(void);
+    /**
+     * @brief Set whether HTTP publishers connect by the saved IP address of
+     * their host instead of its name.
+     *
+     * Opening a connection by name makes the modem look up the host on
+     * every logging interval, which can take a second or two on a cellular
+     * link.  With the cache, each host is looked up once with
+     * loggerModem::lookupHostIP() and its address is kept for the given
+     * time.  If a connection to a kept address fails, the host is looked up
+     * again.  Nothing changes for modems that can't look up addresses on
+     * their own.
+     *
+     * @param ttlSeconds How long to keep each address, in seconds; 0 to
+     * always connect by name.  Default is 3600.
+     */
+    static void setHostCache(uint32_t ttlSeconds = 3600L) {
+        _hostCacheTTL = ttlSeconds;
+    }
+
+    /**
+     * @brief The ways an HTTP publisher can handle the server's response.
+     */
+    typedef enum {
+        responseWait = 0,       ///< Wait for the response code
+        responseFireAndForget,  ///< Close after sending; assume success
+        responseDeferred        ///< Read the response after other requests
+    } responseMode;
+    /**
+     * @brief Set how this publisher handles the server's response.
+     *
+     * By default each request waits for the response code.  Requests that
+     * are safe to repeat can be sent without waiting, which reports 202
+     * (Accepted) as the result.  Failed sends are then never backlogged.
+     *
+     * With responseDeferred, Logger::publishDataToRemotes() sends the
+     * requests of all of the other publishers before reading this
+     * publisher's response.  This only helps when this publisher has its own
+     * client, on a modem that supports several sockets at once.
+     *
+     * @param mode The way to handle the response
+     */
+    void setResponseMode(responseMode mode) {
+        _responseMode = mode;
+    }
+    /**
+     * @brief Get how this publisher handles the server's response.
+     *
+     * @return **responseMode** The way responses are handled
+     */
+    responseMode getResponseMode(void) {
+        return _responseMode;
+    }
+    /**
+     * @brief Set the limits on how long to wait for a server response.
+     *
+     * The wait adapts to the response times seen so far: it is three times
+     * the running average, kept between these limits.  Until a response has
+     * been timed, or after a response times out, the full maximum is used.
+     *
+     * @param minMillis The shortest wait, in milliseconds.  Default is 2000.
+     * @param maxMillis The longest wait, in milliseconds.  Default is 10000.
+     */
+    static void setResponseTimeout(uint32_t minMillis, uint32_t maxMillis) {
+        _responseTimeoutMin = minMillis;
+        _responseTimeoutMax = maxMillis;
+    }
+    /**
+     * @brief Set whether publishers in the responseDeferred mode may leave
+     * their response to be read later.
+     *
+     * Logger::publishDataToRemotes() allows this while it sends the first
+     * request of each publisher; at all other times responses are read right
+     * away.
+     *
+     * @param allowDeferred True to let responses be read later
+     * @param deferAll True to also defer the responses of publishers in the
+     * responseWait mode, as when each publisher has its own socket.
+     */
+    static void setDeferralAllowed(bool allowDeferred, bool deferAll = false) {
+        _deferralAllowed = allowDeferred;
+        _deferAll        = allowDeferred && deferAll;
+    }
+    /**
+     * @brief Check if this publisher has sent a request whose response has
+     * not been read yet.
+     *
+     * @return **bool** True if a response is waiting to be collected
+     */
+    bool responsePending(void) {
+        return _pendingClient != nullptr;
+    }
+    /**
+     * @brief Read the response to a request sent in the responseDeferred
+     * mode and finish with its connection.
+     *
+     * @return **int16_t** The http response code, or 504 if there was no
+     * response.
+     */
+    int16_t collectResponse(void);
+
+    /**
+     * @brief Finish up after Logger::publishDataToRemotes() has sent
+     * everything for this interval.
+     *
+     * Publishers that keep a connection open across several records, like
+     * MQTTPublisher, close it here.  The default does nothing.
+     */
+    virtual void endPublishing(void) {}
+
+    /**
+     * @brief The measures of a publisher's transfers that can be logged and
+     * published with a PublisherMetricVariable.
+     */
+    typedef enum {
+        connectTime = 0,  ///< The time to open the last connection, in ms
+        responseTime,     ///< The time to the last response, in ms
+        bytesSent,        ///< The bytes sent in all of the interval's requests
+        lastResult,       ///< The result of publishing the interval's record
+        failureCount      ///< The retryable failures in a row
+    } transferMetric;
+    /**
+     * @brief Get a measure of this publisher's transfers in the last logging
+     * interval it was sent data in.
+     *
+     * The connection and response times are from the last request of the
+     * interval, including requests sending the backlog.  A connection that
+     * was kept open from an earlier request counts as 0 ms.
+     *
+     * @param metric The measure to get
+     * @return **float** The value, or -9999 if nothing was measured
+     */
+    float getTransferMetric(transferMetric metric);
+    /**
+     * @brief Clear the transfer measures before a new logging interval.
+     */
+    void resetTransferMetrics(void);
+    /**
+     * @brief Add a variable to the list of variables reporting this
+     * publisher's transfer measures.
+     *
+     * @param metricVariable The variable to add
+     * @return **PublisherMetricVariable\*** The variable that was first in
+     * the list before, which the new variable passes updates on to.
+     */
+    PublisherMetricVariable* registerMetricVariable(
+        PublisherMetricVariable* metricVariable);
+    /**
+     * @brief Pass the current transfer measures to the variables reporting
+     * them.
+     */
+    void notifyMetricVariables(void);
 
     /**
      * @brief Begin the publisher - linking it to the client and logger.
@@ -279,10 +783,271 @@ class dataPublisher {
      */
     Client* _inClient = nullptr;
 
+    /**
+     * @brief How this publisher handles the server's response
+     */
+    responseMode _responseMode = responseWait;
+    /**
+     * @brief The client waiting for the response, in the responseDeferred
+     * mode
+     */
+    Client* _pendingClient = nullptr;
+    /**
+     * @brief The time in milliseconds the pending request was sent
+     */
+    uint32_t _pendingSent = 0;
+    /**
+     * @brief Finish a request whose last part has been sent, handling the
+     * response in this publisher's response mode.
+     *
+     * @param outClient The client the request was sent on
+     * @return **int16_t** The http response code; 202 if the response was
+     * not read; 0 if it was left pending.
+     */
+    int16_t finishRequest(Client* outClient);
+    /**
+     * @brief Wait for the status line of an HTTP response and read its code.
+     *
+     * @param outClient The client the response is coming from
+     * @param sentAt The time in milliseconds the request was sent, which the
+     * wait is counted from.
+     * @return **int16_t** The http response code, or 504 if there was no
+     * response.
+     */
+    int16_t readResponseCode(Client* outClient, uint32_t sentAt);
+    /**
+     * @brief The shortest time to wait for a response
+     */
+    static uint32_t _responseTimeoutMin;
+    /**
+     * @brief The longest time to wait for a response
+     */
+    static uint32_t _responseTimeoutMax;
+    /**
+     * @brief The running average of the response times, or 0 if unknown
+     */
+    static uint32_t _responseTimeAvg;
+    /**
+     * @brief True while responses may be left to be read later
+     */
+    static bool _deferralAllowed;
+    /**
+     * @brief True while responses of publishers in the responseWait mode are
+     * also left to be read later
+     */
+    static bool _deferAll;
+    /**
+     * @brief True to keep connections open between requests
+     */
+    static bool _keepAlive;
+    /**
+     * @brief The client holding the connection kept open, if any
+     */
+    static Client* _openClient;
+    /**
+     * @brief The host of the connection kept open
+     */
+    static const char* _openHost;
+    /**
+     * @brief The port of the connection kept open
+     */
+    static uint16_t _openPort;
+    /**
+     * @brief Connect a client to a host, reusing the connection kept open
+     * from the last request if it is to the same host and port.
+     *
+     * @param outClient The client to connect
+     * @param host The host name to connect to
+     * @param port The port to connect to
+     * @return **bool** True if the client is connected
+     */
+    bool connectClient(Client* outClient, const char* host, uint16_t port);
+    /**
+     * @brief Open a new connection to a host, by its saved address if the
+     * host cache is on.
+     *
+     * @param outClient The client to connect
+     * @param host The host name to connect to
+     * @param port The port to connect to
+     * @return **bool** True if the client is connected
+     */
+    bool openConnection(Client* outClient, const char* host, uint16_t port);
+    /**
+     * @brief A host address saved by the host cache.
+     */
+    typedef struct {
+        const char* host;        ///< The host name, or a nullptr if unused
+        IPAddress   ip;          ///< The address of the host
+        uint32_t    resolvedAt;  ///< The UTC epoch time of the lookup
+    } hostCacheEntry;
+    /**
+     * @brief The saved host addresses
+     */
+    static hostCacheEntry _hostCache[MS_HOST_CACHE_SIZE];
+    /**
+     * @brief How long to keep each address, in seconds; 0 for no cache
+     */
+    static uint32_t _hostCacheTTL;
+    /**
+     * @brief Finish with a client after reading the response code, either
+     * keeping the connection open for the next request or closing it.
+     *
+     * @param outClient The client used for the request
+     */
+    static void releaseClient(Client* outClient);
+    /**
+     * @brief Read the rest of an HTTP response, after its first 12
+     * characters, so the connection can carry another request.
+     *
+     * @param outClient The client the response is coming from
+     * @param timeout The longest time in milliseconds to wait for the response
+     * @return **bool** True if the whole response was read and the server did
+     * not ask to close the connection.
+     */
+    static bool finishResponse(Client* outClient, uint32_t timeout);
+
+    /**
+     * @brief Count the values of the current record that will be sent and
+     * the length of their formatted text.
+     *
+     * @param nSent The number of values to send
+     * @return **size_t** The summed length of the values to send
+     */
+    size_t getSentValuesLength(uint8_t& nSent);
+    /**
+     * @brief Save the values just accepted by the server as the ones later
+     * values are compared with.
+     */
+    void markValuesSent(void);
+    /**
+     * @brief The positions of the variables to send, or a nullptr for all
+     */
+    const uint8_t* _subset = nullptr;
+    /**
+     * @brief The number of positions in #_subset
+     */
+    uint8_t _subsetCount = 0;
+    /**
+     * @brief True to leave missing values out of requests
+     */
+    bool _omitMissing = false;
+    /**
+     * @brief What to do with stale values
+     */
+    staleValuePolicy _stalePolicy = STALE_KEEP;
+    /**
+     * @brief The deadband of each variable, or a nullptr to send every value
+     */
+    const float* _deadbands = nullptr;
+    /**
+     * @brief The value of each variable in the last accepted request, or NAN
+     * if it hasn't been sent
+     */
+    float* _lastSentValues = nullptr;
+
+    /**
+     * @brief The time to open the last connection, in ms, or -1
+     */
+    int32_t _lastConnectTime = -1;
+    /**
+     * @brief The time to the last response, in ms, or -1
+     */
+    int32_t _lastResponseTime = -1;
+    /**
+     * @brief The bytes sent since the transfer measures were reset
+     */
+    uint32_t _bytesSent = 0;
+    /**
+     * @brief The result of publishing the interval's record, or -9999
+     */
+    int16_t _lastResult = -9999;
+    /**
+     * @brief The first of the variables reporting the transfer measures
+     */
+    PublisherMetricVariable* _metricVariables = nullptr;
+    /**
+     * @brief The publisher whose request is going out through the TX buffer;
+     * the bytes sent to the client are counted for it.
+     */
+    static dataPublisher* txBufferPublisher;
+    /**
+     * @brief The bytes sent by all of the publishers since the program
+     * started
+     */
+    static uint32_t _totalBytesSent;
+
     /**
      * @brief A buffer for outgoing data.
+     *
+     * The buffer is always kept null terminated, so it holds at most
+     * #MS_SEND_BUFFER_SIZE - 1 characters.
      */
     static char txBuffer[MS_SEND_BUFFER_SIZE];
+    /**
+     * @brief The number of characters currently in the TX buffer
+     */
+    static uint16_t txBufferLen;
+    /**
+     * @brief The client the TX buffer is sent to when it fills, if any
+     */
+    static Client* txBufferOutClient;
+    /**
+     * @brief The most characters sent to the client in one write: the size of
+     * the TX buffer, or the most the modem sends at once, if less
+     */
+    static uint16_t txBufferSendSize;
+    /**
+     * @brief Empty the TX buffer and set where it is sent when it fills.
+     *
+     * With a client, the buffer is sent whenever it holds as much as the
+     * logger's modem sends at once (loggerModem::getMaxSendSize()), so each
+     * write to the client is one whole send of the modem.
+     *
+     * @param outClient The client to send the buffer to whenever it is full,
+     * or a nullptr to keep everything in the buffer - as for an MQTT message
+     * that must be published whole.
+     */
+    static void txBufferInit(Client* outClient);
+    /**
+     * @brief Add characters to the end of the TX buffer, sending the buffer to
+     * the client set by txBufferInit() each time it fills.
+     *
+     * Without a client, anything that does not fit is dropped.  With one, a
+     * run of at least a whole send added while the buffer is empty is written
+     * to the client straight from where it is, without a copy.
+     *
+     * @param data The characters to add
+     * @param length The number of characters to add
+     */
+    static void txBufferAppend(const char* data, size_t length);
+    /**
+     * @brief Add a null-terminated string to the end of the TX buffer.
+     *
+     * @param s The string to add
+     */
+    static void txBufferAppend(const char* s);
+    /**
+     * @brief Add one character to the end of the TX buffer.
+     *
+     * @param c The character to add
+     */
+    static void txBufferAppend(char c);
+    /**
+     * @brief Send whatever is in the TX buffer to the client set by
+     * txBufferInit() and empty it.
+     *
+     * @param addNewLine True to add a new line ("\r\n") at the end, sent in
+     * the same write as the rest
+     */
+    static void txBufferFlush(bool addNewLine = false);
+    /**
+     * @brief Write characters to the client set by txBufferInit(), echo them
+     * to the debugging port, and count them as sent.
+     *
+     * @param data The characters to write
+     * @param length The number of characters to write
+     */
+    static void txBufferSend(const char* data, size_t length);
     /**
      * @brief Get the number of empty spots in the buffer.
      *
@@ -290,7 +1055,7 @@ class dataPublisher {
      */
     static int bufferFree(void);
     /**
-     * @brief Fill the TX buffer with nulls ('\0').
+     * @brief Empty the TX buffer.
      */
     static void emptyTxBuffer(void);
     /**
@@ -305,15 +1070,89 @@ class dataPublisher {
     static void printTxBuffer(Stream* stream, bool addNewLine = false);
 
     /**
-     * @brief Unimplemented; intended for future use to enable caching and bulk
-     * publishing.
+     * @brief Get the pieces of the start of the request that are the same for
+     * every request, like the request line and the host and token headers.
+     *
+     * Only the content length and the body of an HTTP request usually change
+     * from one request to the next, so publishers put everything up to the
+     * content length in the prefix.
+     *
+     * @param parts An array of #MS_REQUEST_PREFIX_PARTS to fill with the
+     * pieces, in order; a nullptr piece is skipped.
+     * @return **uint8_t** The number of pieces; 0 if the publisher has no
+     * prefix
+     */
+    virtual uint8_t getRequestPrefixParts(const char* parts[]);
+    /**
+     * @brief Join the pieces of the request prefix into one block of RAM, so
+     * each request adds it to the TX buffer with a single copy.
+     *
+     * This is done by begin(), or by txBufferAppendPrefix() for the first
+     * request after clearRequestPrefix().
+     */
+    void renderRequestPrefix(void);
+    /**
+     * @brief Free the rendered request prefix, so it is rendered again for
+     * the next request.
+     *
+     * The setters of anything in the prefix call this.
+     */
+    void clearRequestPrefix(void);
+    /**
+     * @brief Add the request prefix to the TX buffer, rendering it first if
+     * it isn't already.
+     *
+     * Without the RAM for the rendered block, the pieces are added one at a
+     * time.
+     */
+    void txBufferAppendPrefix(void);
+    /**
+     * @brief The rendered request prefix, or a nullptr
+     */
+    char* _requestPrefix = nullptr;
+    /**
+     * @brief The number of characters in the rendered request prefix
+     */
+    uint16_t _requestPrefixLen = 0;
+
+    /**
+     * @brief Send on every Xth logging interval
      */
     uint8_t _sendEveryX = 1;
     /**
-     * @brief Unimplemented; intended for future use to enable publishing data
-     * at a time slightly delayed from when it is collected.
+     * @brief The number of logging intervals to delay sending after each
+     * multiple of #_sendEveryX
      */
     uint8_t _sendOffset = 0;
+    /**
+     * @brief The priority of the publisher; 0 for critical
+     */
+    uint8_t _priority = 1;
+    /**
+     * @brief True to save the records from the skipped intervals
+     */
+    bool _saveSkipped = true;
+    /**
+     * @brief True to keep a backlog of unsent records on the SD card
+     */
+    bool _useBacklog = false;
+    /**
+     * @brief The number of failures in a row that open the circuit; 0 to
+     * never open it
+     */
+    uint8_t _failuresToOpen = 0;
+    /**
+     * @brief The most logging intervals to wait between tries
+     */
+    uint16_t _maxSkipIntervals = 64;
+    /**
+     * @brief The number of retryable failures in a row
+     */
+    uint8_t _consecutiveFailures = 0;
+    /**
+     * @brief The first logging interval the publisher may be tried again
+     */
+    uint32_t _retryInterval = 0;
 
     // Basic chunks of HTTP
     /**
@@ -334,4 +1173,56 @@ class dataPublisher {
     static const char* hostHeader;
 };
 
+
+
+/**
+ * @brief The variable class for a measure of a publisher's transfers, like
+ * the time to connect or the bytes sent.
+ *
+ * The values are from the publisher's last logging interval, so they are
+ * logged and published with the record of the following interval.  On
+ * intervals where nothing is sent to the publisher, the times are -9999 and
+ * the bytes sent are 0.  These can be used to compare cellular carriers and
+ * payload formats across a fleet of loggers.
+ *
+ * @note The publisher must be created before the variable array holding this
+ * variable, so create the publisher with its empty constructor and tie it to
+ * the logger with begin(...) in the set-up function.
+ *
+ * @ingroup the_publishers
+ */
+class PublisherMetricVariable : public Variable {
+ public:
+    /**
+     * @brief Construct a new PublisherMetricVariable object.
+     *
+     * @param parentPublisher The publisher to report on
+     * @param metric The measure of its transfers to report
+     * @param uuid A universally unique identifier for the variable; optional
+     * with the default value of an empty string.
+     * @param varCode A custom code for the variable; optional with the
+     * default value of "PublisherMetric".
+     */
+    PublisherMetricVariable(dataPublisher*                parentPublisher,
+                            dataPublisher::transferMetric metric,
+                            const char*                   uuid    = "",
+                            const char* varCode = "PublisherMetric");
+    /**
+     * @brief Destroy the PublisherMetricVariable object - no action needed.
+     */
+    ~PublisherMetricVariable() {}
+
+    /**
+     * @brief Take the value from the publisher and pass the update on to the
+     * next variable reporting on the same publisher.
+     *
+     * @param parentPublisher The publisher reporting its measures
+     */
+    void onPublisherUpdate(dataPublisher* parentPublisher);
+
+ private:
+    dataPublisher::transferMetric _metric;
+    PublisherMetricVariable*      _nextMetricVariable = nullptr;
+};
+
 #endif  // SRC_DATAPUBLISHERBASE_H_
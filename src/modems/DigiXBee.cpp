@@ -34,7 +34,7 @@ bool DigiXBee::modemWakeFxn(void) {
         // Don't go to sleep if there's not a wake pin!
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                _wakeLevel ? F("HIGH") : F("LOW"), F("to wake"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         return true;
     } else {
         return true;
@@ -47,9 +47,38 @@ bool DigiXBee::modemSleepFxn(void) {
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                !_wakeLevel ? F("HIGH") : F("LOW"), F("to put"), _modemName,
                F("to sleep"));
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
         return true;
     } else {
         return true;
     }
 }
+
+
+// The pin isn't trusted until it has shown the XBee go down; just after the
+// reset command it can still show the XBee awake from before the reboot
+bool DigiXBee::waitForReboot(uint32_t maxWait_ms) {
+    uint32_t start = millis();
+    if (_statusPin < 0) {
+        MS_DBG(F("Waiting"), maxWait_ms, F("ms for"), _modemName,
+               F("to reboot"));
+        while (millis() - start < maxWait_ms) {
+            // wait
+        }
+        return false;
+    }
+
+    MS_DBG(F("Waiting up to"), maxWait_ms, F("ms for pin"), _statusPin,
+           F("to show"), _modemName, F("reboot..."));
+    bool wentDown = false;
+    while (millis() - start < maxWait_ms) {
+        if (_statusIO.read() != static_cast<int>(_statusLevel)) {
+            wentDown = true;
+        } else if (wentDown) {
+            MS_DBG(F("... rebooted after"), millis() - start, F("ms."));
+            return true;
+        }
+    }
+    MS_DBG(F("... the pin didn't show a reboot."));
+    return false;
+}
@@ -152,6 +152,14 @@
  */
 #define XBEE_DISCONNECT_TIME_MS 15000L
 
+/**
+ * @brief The silence the XBee needs on its serial input before the `+++` that
+ * puts it into command mode, plus a little margin.
+ *
+ * This is the default 1 second command mode guard time (`GT`).
+ */
+#define XBEE_GUARD_TIME_MS 1010
+
 // Included Dependencies
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
@@ -198,6 +206,20 @@ class DigiXBee : public loggerModem {
  protected:
     bool modemSleepFxn(void) override;
     bool modemWakeFxn(void) override;
+
+    /**
+     * @brief Wait out a reboot of the XBee, like the one forced by the `FR`
+     * command, watching the status pin.
+     *
+     * With a status pin, this returns as soon as the pin has shown the XBee
+     * go down and come back up, so the wait lasts only as long as the reboot
+     * does.  Without a status pin, or if the pin never shows the reboot, this
+     * waits the whole maximum.
+     *
+     * @param maxWait_ms The longest to wait, in milliseconds
+     * @return **bool** True if the status pin showed the XBee reboot
+     */
+    bool waitForReboot(uint32_t maxWait_ms);
 };
 /**@}*/
 #endif  // SRC_MODEMS_DIGIXBEE_H_
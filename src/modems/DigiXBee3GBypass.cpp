@@ -22,7 +22,7 @@ DigiXBee3GBypass::DigiXBee3GBypass(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -37,8 +37,10 @@ MS_MODEM_WAKE(DigiXBee3GBypass);
 MS_MODEM_CONNECT_INTERNET(DigiXBee3GBypass);
 MS_MODEM_DISCONNECT_INTERNET(DigiXBee3GBypass);
 MS_MODEM_IS_INTERNET_AVAILABLE(DigiXBee3GBypass);
+MS_MODEM_IS_NETWORK_REGISTERED(DigiXBee3GBypass);
 
 MS_MODEM_GET_NIST_TIME(DigiXBee3GBypass);
+MS_MODEM_GET_NITZ_TIME(DigiXBee3GBypass);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(DigiXBee3GBypass);
 MS_MODEM_GET_MODEM_BATTERY_DATA(DigiXBee3GBypass);
@@ -49,12 +51,17 @@ MS_MODEM_GET_MODEM_TEMPERATURE_DATA(DigiXBee3GBypass);
 bool DigiXBee3GBypass::extraModemSetup(void) {
     bool success = false;
     MS_DBG(F("Putting XBee into command mode..."));
+    uint32_t lastSent = millis();
     for (uint8_t i = 0; i < 5; i++) {
-        /** First, wait the required guard time before entering command mode. */
-        delay(1010);
+        /** First, wait the required guard time before entering command mode.
+         * Retries only wait what's left of it after the failed try. */
+        while (millis() - lastSent < XBEE_GUARD_TIME_MS) {
+            // wait
+        }
         /** Now, enter command mode to set all pin I/O functionality. */
         gsmModem.streamWrite(GF("+++"));
-        success = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
+        lastSent = millis();
+        success  = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
         if (success) break;
     }
     if (success) {
@@ -124,8 +131,9 @@ bool DigiXBee3GBypass::extraModemSetup(void) {
         MS_DBG(F("Resetting the module to reboot in bypass mode..."));
         gsmModem.sendAT(GF("FR"));
         success &= gsmModem.waitResponse(5000L, GF("OK\r")) == 1;
-        /** Allow 5s for the unit to reset. */
-        delay(5000L);
+        /** Allow up to 5s for the unit to reset, or only as long as the
+         * status pin shows the reset takes. */
+        waitForReboot(5000L);
         /** Re-initialize the TinyGSM u-blox instance. */
         MS_DBG(F("Attempting to reconnect to the u-blox SARA U201 module..."));
         success &= gsmModem.testAT(15000L);
@@ -149,11 +157,16 @@ bool DigiXBee3GBypass::modemHardReset(void) {
     // If the u-blox cellular component isn't responding but the Digi processor
     // is, use the Digi API to reset the cellular component
     MS_DBG(F("Returning XBee to command mode..."));
+    uint32_t lastSent = millis();
     for (uint8_t i = 0; i < 5; i++) {
-        // Wait the required guard time before entering command mode
-        delay(1010);
+        // Wait the required guard time before entering command mode; a retry
+        // only waits what's left of it after the failed try
+        while (millis() - lastSent < XBEE_GUARD_TIME_MS) {
+            // wait
+        }
         gsmModem.streamWrite(GF("+++"));  // enter command mode
-        success = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
+        lastSent = millis();
+        success  = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
         if (success) break;
     }
     if (success) {
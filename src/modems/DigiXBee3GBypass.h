@@ -155,6 +155,7 @@ class DigiXBee3GBypass : public DigiXBee {
 
  protected:
     bool isInternetAvailable(void) override;
+    bool isNetworkRegistered(void) override;
     /**
      * @copybrief loggerModem::extraModemSetup()
      *
@@ -164,8 +165,9 @@ class DigiXBee3GBypass : public DigiXBee {
      *
      * @return **bool** True if the extra setup succeeded.
      */
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    bool     isModemAwake(void) override;
 
  private:
     const char* _apn;
@@ -0,0 +1,727 @@
+/**
+ * @file DigiXBeeCellularApi.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the DigiXBeeCellularApi and DigiXBeeApiClient classes.
+ */
+
+// Included Dependencies
+#include "DigiXBeeCellularApi.h"
+
+// The API frame types used
+#define XBEE_FRAME_START 0x7E
+#define XBEE_FRAME_ESCAPE 0x7D
+#define XBEE_FRAME_AT_COMMAND 0x08
+#define XBEE_FRAME_SOCKET_CREATE 0x40
+#define XBEE_FRAME_SOCKET_CONNECT 0x42
+#define XBEE_FRAME_SOCKET_CLOSE 0x43
+#define XBEE_FRAME_SOCKET_SEND 0x44
+#define XBEE_FRAME_AT_RESPONSE 0x88
+#define XBEE_FRAME_TX_STATUS 0x89
+#define XBEE_FRAME_MODEM_STATUS 0x8A
+#define XBEE_FRAME_CREATE_RESPONSE 0xC0
+#define XBEE_FRAME_CONNECT_RESPONSE 0xC2
+#define XBEE_FRAME_CLOSE_RESPONSE 0xC3
+#define XBEE_FRAME_SOCKET_RECEIVE 0xCD
+#define XBEE_FRAME_SOCKET_STATUS 0xCF
+
+// The XBee's clock counts from January 1, 2000
+#define XBEE_EPOCH_OFFSET 946684800L
+
+
+// In API mode 2 the start, escape and flow control bytes are escaped
+static void writeEscaped(Stream* stream, uint8_t b) {
+    if (b == XBEE_FRAME_START || b == XBEE_FRAME_ESCAPE || b == 0x11 ||
+        b == 0x13) {
+        stream->write(static_cast<uint8_t>(XBEE_FRAME_ESCAPE));
+        b ^= 0x20;
+    }
+    stream->write(b);
+}
+
+
+// Wait for the OK of a command in command mode
+static bool waitForOK(Stream* stream, uint32_t timeout_ms) {
+    uint32_t startMillis = millis();
+    char     last        = 0;
+    while (millis() - startMillis < timeout_ms) {
+        if (!stream->available()) continue;
+        char c = stream->read();
+        if (last == 'O' && c == 'K') return true;
+        last = c;
+    }
+    return false;
+}
+
+
+// Constructor
+DigiXBeeApiClient::DigiXBeeApiClient(DigiXBeeCellularApi* modem, bool useTls)
+    : _modem(modem),
+      _useTls(useTls) {}
+// Destructor
+DigiXBeeApiClient::~DigiXBeeApiClient() {}
+
+
+int DigiXBeeApiClient::connect(IPAddress ip, uint16_t port) {
+    uint8_t address[4] = {ip[0], ip[1], ip[2], ip[3]};
+    return openSocket(0, address, 4, port);
+}
+int DigiXBeeApiClient::connect(const char* host, uint16_t port) {
+    return openSocket(1, reinterpret_cast<const uint8_t*>(host), strlen(host),
+                      port);
+}
+
+
+int DigiXBeeApiClient::openSocket(uint8_t addressType, const uint8_t* address,
+                                  size_t addressLen, uint16_t port) {
+    stop();
+    _rxHead = 0;
+    _rxTail = 0;
+
+    uint8_t create[3] = {XBEE_FRAME_SOCKET_CREATE, _modem->nextFrameId(),
+                         static_cast<uint8_t>(_useTls ? 4 : 1)};
+    _modem->sendFrame(create, 3);
+    if (!_modem->waitFrame(XBEE_FRAME_CREATE_RESPONSE, create[1]) ||
+        _modem->_frame[3] != 0) {
+        MS_DBG(F("The XBee could not create a socket"));
+        return 0;
+    }
+    _socket = _modem->_frame[2];
+
+    uint8_t header[6] = {XBEE_FRAME_SOCKET_CONNECT,
+                         _modem->nextFrameId(),
+                         static_cast<uint8_t>(_socket),
+                         static_cast<uint8_t>(port >> 8),
+                         static_cast<uint8_t>(port & 0xFF),
+                         addressType};
+    _modem->sendFrame(header, 6, address, addressLen);
+    if (!_modem->waitFrame(XBEE_FRAME_CONNECT_RESPONSE, header[1]) ||
+        _modem->_frame[3] != 0) {
+        MS_DBG(F("The XBee could not start connecting socket"), _socket);
+        stop();
+        return 0;
+    }
+    // The socket status frame comes once the connection is made or fails
+    _modem->waitFrame(XBEE_FRAME_SOCKET_STATUS, _socket,
+                      XBEE_API_CONNECT_TIME_MS);
+    if (!_connected) {
+        MS_DBG(F("Socket"), _socket, F("did not connect"));
+        stop();
+        return 0;
+    }
+    MS_DBG(F("Socket"), _socket, F("connected"));
+    return 1;
+}
+
+
+size_t DigiXBeeApiClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+size_t DigiXBeeApiClient::write(const uint8_t* buf, size_t size) {
+    size_t sent = 0;
+    while (_connected && sent < size) {
+        size_t len = size - sent;
+        if (len > XBEE_API_MAX_SEND) len = XBEE_API_MAX_SEND;
+        uint8_t header[4] = {XBEE_FRAME_SOCKET_SEND, _modem->nextFrameId(),
+                             static_cast<uint8_t>(_socket), 0};
+        _modem->sendFrame(header, 4, buf + sent, len);
+        if (!_modem->waitFrame(XBEE_FRAME_TX_STATUS, header[1]) ||
+            _modem->_frame[2] != 0) {
+            MS_DBG(F("The XBee could not send on socket"), _socket);
+            break;
+        }
+        sent += len;
+    }
+    return sent;
+}
+
+
+int DigiXBeeApiClient::available() {
+    _modem->pumpFrames();
+    return (_rxHead + XBEE_API_RX_BUFFER - _rxTail) % XBEE_API_RX_BUFFER;
+}
+int DigiXBeeApiClient::read() {
+    if (!available()) return -1;
+    uint8_t b = _rx[_rxTail];
+    _rxTail   = (_rxTail + 1) % XBEE_API_RX_BUFFER;
+    return b;
+}
+int DigiXBeeApiClient::read(uint8_t* buf, size_t size) {
+    size_t n = 0;
+    while (n < size && available()) buf[n++] = read();
+    return n;
+}
+int DigiXBeeApiClient::peek() {
+    if (!available()) return -1;
+    return _rx[_rxTail];
+}
+
+
+void DigiXBeeApiClient::flush() {
+    _modem->_modemStream->flush();
+}
+
+
+void DigiXBeeApiClient::stop() {
+    if (_socket >= 0) {
+        uint8_t header[3] = {XBEE_FRAME_SOCKET_CLOSE, _modem->nextFrameId(),
+                             static_cast<uint8_t>(_socket)};
+        _modem->sendFrame(header, 3);
+        _modem->waitFrame(XBEE_FRAME_CLOSE_RESPONSE, header[1]);
+    }
+    _socket    = -1;
+    _connected = false;
+}
+
+
+// The data already received can still be read after the socket closes
+uint8_t DigiXBeeApiClient::connected() {
+    return available() > 0 || _connected;
+}
+DigiXBeeApiClient::operator bool() {
+    return connected();
+}
+
+
+// Bytes that arrive with the buffer full are lost
+void DigiXBeeApiClient::receive(uint8_t b) {
+    uint16_t next = (_rxHead + 1) % XBEE_API_RX_BUFFER;
+    if (next == _rxTail) return;
+    _rx[_rxHead] = b;
+    _rxHead      = next;
+}
+
+
+// Constructor/Destructor
+DigiXBeeCellularApi::DigiXBeeCellularApi(Stream* modemStream, int8_t powerPin,
+                                         int8_t statusPin, bool useCTSStatus,
+                                         int8_t      modemResetPin,
+                                         int8_t      modemSleepRqPin,
+                                         const char* apn)
+    : DigiXBee(powerPin, statusPin, useCTSStatus, modemResetPin,
+               modemSleepRqPin),
+      gsmClient(this),
+      _modemStream(modemStream),
+      _apn(apn) {
+    _modemName = "Digi XBee3 Cellular";
+}
+
+// Destructor
+DigiXBeeCellularApi::~DigiXBeeCellularApi() {}
+
+
+bool DigiXBeeCellularApi::isModemAwake(void) {
+    if (_statusPin >= 0) {
+        bool levelNow = _statusIO.read();
+        MS_DBG(getModemName(), F("status pin"), _statusPin, F("level = "),
+               levelNow ? F("HIGH") : F("LOW"), F("meaning"), getModemName(),
+               F("should be"), levelNow == _statusLevel ? F("on") : F("off"));
+        return levelNow == _statusLevel;
+    }
+    // Without a status pin, check if the modem answers a command
+    return testATFxn(1000L);
+}
+
+
+bool DigiXBeeCellularApi::modemWake(void) {
+    // Power up
+    if (_millisPowerOn == 0) { modemPowerUp(); }
+
+    // Because the modem calls wake BEFORE the first setup, we must set the pin
+    // modes in the wake function.
+    setModemPinModes();
+    if (millis() - _millisPowerOn < _wakeDelayTime_ms) {
+        MS_DBG(F("Wait"), _wakeDelayTime_ms - (millis() - _millisPowerOn),
+               F("ms longer for warm-up"));
+        while (millis() - _millisPowerOn < _wakeDelayTime_ms) {
+            // wait
+        }
+    }
+
+    if (isModemAwake()) {
+        MS_DBG(getModemName(),
+               F("was already on! Will not run wake function."));
+    } else {
+        MS_DBG(F("Running wake function for"), getModemName());
+        if (!modemWakeFxn()) {
+            MS_DBG(F("Wake function for"), getModemName(),
+                   F("did not run as expected!"));
+        }
+    }
+
+    // Find the modem's baud rate and raise it, if negotiating
+    negotiateBaud();
+
+    // Before it's first set up, the XBee may not be in API mode yet
+    bool success = false;
+    if (!_hasBeenSetup) {
+        success = modemSetup();
+    } else {
+        uint8_t resets = 0;
+        while (!success && resets < 2) {
+            MS_DBG(F("\nWaiting up to"), _max_atresponse_time_ms, F("ms for"),
+                   getModemName(), F("to respond to API frames..."));
+            success = testATFxn(_max_atresponse_time_ms + 500);
+            if (!success) {
+                MS_DBG(F("No response to API frames!"));
+                MS_DBG(F("Attempting a hard reset on the modem! "), resets + 1);
+                if (!modemHardReset()) break;
+                resets++;
+            }
+        }
+    }
+
+    if (success) {
+        modemLEDOn();
+        if (_powerState < powerAwake) setPowerState(powerAwake);
+        MS_DBG(getModemName(), F("should be awake and ready to go."));
+    } else {
+        MS_DBG(getModemName(), F("failed to wake!"));
+    }
+    return success;
+}
+
+
+bool DigiXBeeCellularApi::testATFxn(uint32_t timeout_ms) {
+    uint32_t startMillis = millis();
+    do {
+        if (atCommand("AI", nullptr, 0, nullptr, 0, 500L) >= 0) return true;
+    } while (millis() - startMillis < timeout_ms);
+    return false;
+}
+
+
+bool DigiXBeeCellularApi::extraModemSetup(void) {
+    bool     success = true;
+    uint32_t apiMode = 0;
+    MS_DBG(F("Checking the XBee's API mode..."));
+    if (!atGet("AP", apiMode) || apiMode != 2) {
+        success = enterApiMode() && atGet("AP", apiMode) && apiMode == 2;
+    }
+    if (!success) {
+        MS_DBG(F("... the XBee could not be put into API mode!"));
+        return false;
+    }
+
+    MS_DBG(F("Setting I/O Pins..."));
+    /** Enable pin sleep functionality on `DIO8`, status indication on
+     * `DIO9`, CTS on `DIO7`, association indication on `DIO5` and the RSSI
+     * PWM output on `DIO10`, as for transparent mode. */
+    success &= atSet("D8", 1);
+    success &= atSet("D9", 1);
+    success &= atSet("D7", 1);
+    success &= atSet("D5", 1);
+    success &= atSet("P0", 1);
+    MS_DBG(F("Setting Sleep Options..."));
+    /** Enable pin sleep and disassociate for the lowest power deep sleep. */
+    success &= atSet("SM", 1);
+    success &= atSet("SO", 0);
+    MS_DBG(F("Setting Other Options..."));
+    /** Disable remote manager and USB direct. */
+    success &= atSet("DO", 0);
+    success &= atSet("P1", 0);
+    MS_DBG(F("Setting the APN..."));
+    success &= atCommand("AN", reinterpret_cast<const uint8_t*>(_apn),
+                         strlen(_apn)) >= 0;
+    /** Write all changes to flash and apply them, without a restart. */
+    MS_DBG(F("Applying changes..."));
+    success &= atCommand("WR") >= 0;
+    success &= atCommand("AC") >= 0;
+
+    if (success) {
+        MS_DBG(F("... setup successful!"));
+    } else {
+        MS_DBG(F("... setup failed!"));
+    }
+    return success;
+}
+
+
+// This is only needed once; the mode is written to flash
+bool DigiXBeeCellularApi::enterApiMode(void) {
+    MS_DBG(F("Putting XBee into command mode to set API mode..."));
+    // The default guard time is 1s of silence on each side of the +++
+    delay(1100L);
+    _modemStream->print(F("+++"));
+    delay(1100L);
+    if (!waitForOK(_modemStream, 2000L)) return false;
+    _modemStream->print(F("ATAP2\r"));
+    if (!waitForOK(_modemStream, 1000L)) return false;
+    _modemStream->print(F("ATWR\r"));
+    if (!waitForOK(_modemStream, 1000L)) return false;
+    _modemStream->print(F("ATCN\r"));
+    waitForOK(_modemStream, 1000L);
+    _rxState = 0;
+    return true;
+}
+
+
+bool DigiXBeeCellularApi::connectInternet(uint32_t maxConnectionTime) {
+    bool success = true;
+
+    // Power up, if necessary
+    if (_millisPowerOn == 0) { modemPowerUp(); }
+
+    // Check if the modem was awake, wake it if not
+    if (!isModemAwake()) {
+        MS_DBG(F("Waking up the modem to connect to the internet ..."));
+        success &= modemWake();
+    }
+    if (!success) return false;
+
+    MS_DBG(F("\nWaiting up to"), maxConnectionTime / 1000,
+           F("seconds for the XBee to connect to the internet..."));
+    setPowerState(powerConnecting);
+    uint32_t startMillis = millis();
+    // Leave the airplane mode of the last disconnect
+    uint32_t airplane = 0;
+    if (atGet("AM", airplane) && airplane != 0) {
+        atSet("AM", 0);
+        atCommand("AC");
+    }
+    while (millis() - startMillis < maxConnectionTime) {
+        if (isInternetAvailable()) {
+            MS_DBG(F("... Connected after"), millis() - startMillis,
+                   F("milliseconds."));
+            setPowerState(powerConnected);
+            return true;
+        }
+        delay(250);
+    }
+    MS_DBG(F("...Internet connection failed."));
+    setPowerState(powerAwake);
+    return false;
+}
+
+
+// The XBee has no command to detach, so it goes into airplane mode
+void DigiXBeeCellularApi::disconnectInternet(void) {
+    uint32_t startMillis = millis();
+    atSet("AM", 1);
+    atCommand("AC");
+    if (_powerState > powerAwake) setPowerState(powerAwake);
+    MS_DBG(F("Disconnected from cellular network after"),
+           millis() - startMillis, F("milliseconds."));
+}
+
+
+// The association indication is 0 when connected to the internet and 0x23
+// while registered but still connecting
+bool DigiXBeeCellularApi::isInternetAvailable(void) {
+    uint32_t association = 0xFF;
+    return atGet("AI", association) && association == 0;
+}
+bool DigiXBeeCellularApi::isNetworkRegistered(void) {
+    uint32_t association = 0xFF;
+    return atGet("AI", association) &&
+        (association == 0 || association == 0x23);
+}
+
+
+uint32_t DigiXBeeCellularApi::getNISTTime(void) {
+    /* bail if not connected to the internet */
+    if (!isInternetAvailable()) {
+        MS_DBG(F("No internet connection, cannot connect to NIST."));
+        return 0;
+    }
+
+    /* Try up to 12 times to get a timestamp from NIST */
+    for (uint8_t i = 0; i < 12; i++) {
+        // Must ensure that we do not ping the daylight more than once every 4
+        // seconds.  NIST clearly specifies here that this is a requirement for
+        // all software that accesses its servers:
+        // https://tf.nist.gov/tf-cgi/servers.cgi
+        while (millis() < _lastNISTrequest + 4000) {
+            // wait
+        }
+
+        /* Make TCP connection */
+        MS_DBG(F("\nConnecting to NIST daytime Server"));
+        /* This is the IP address of time-e-wwv.nist.gov  */
+        IPAddress ip(132, 163, 97, 6);
+        bool      connectionMade = gsmClient.connect(ip, 37);
+        _lastNISTrequest         = millis();
+
+        /* Wait up to 5 seconds for a response */
+        if (connectionMade) {
+            uint32_t start = millis();
+            while (gsmClient.available() < 4 && millis() - start < 5000L) {
+                // wait
+            }
+
+            if (gsmClient.available() >= 4) {
+                MS_DBG(F("NIST responded after"), millis() - start, F("ms"));
+                byte response[4] = {0};
+                gsmClient.read(response, 4);
+                gsmClient.stop();
+                return parseNISTBytes(response);
+            } else {
+                MS_DBG(F("NIST Time server did not respond!"));
+                gsmClient.stop();
+            }
+        } else {
+            MS_DBG(F("Unable to open TCP to NIST!"));
+        }
+    }
+    return 0;
+}
+
+
+// The DT command gives the network time in seconds since 2000
+uint32_t DigiXBeeCellularApi::getNITZTime(void) {
+    uint32_t xbeeTime = 0;
+    if (!atGet("DT", xbeeTime)) return 0;
+    uint32_t utc = xbeeTime + XBEE_EPOCH_OFFSET;
+    // Before 2019, the clock hasn't been set
+    if (utc < 1546300800L) return 0;
+    return utc;
+}
+
+
+// The DB command gives the magnitude of the RSSI in dBm
+bool DigiXBeeCellularApi::getModemSignalQuality(int16_t& rssi,
+                                                int16_t& percent) {
+    MS_DBG(F("Getting signal quality:"));
+    uint32_t dB = 0;
+    if (!atGet("DB", dB)) {
+        rssi    = 0;
+        percent = 0;
+        return false;
+    }
+    rssi    = -static_cast<int16_t>(dB);
+    percent = getPctFromRSSI(rssi);
+    MS_DBG(F("RSSI:"), rssi, F("Percent signal:"), percent);
+    return true;
+}
+
+
+bool DigiXBeeCellularApi::getModemBatteryStats(uint8_t& chargeState,
+                                               int8_t&  percent,
+                                               uint16_t& milliVolts) {
+    MS_DBG(F("Getting modem supply voltage:"));
+    uint32_t supply = 0;
+    chargeState     = 99;
+    percent         = -99;
+    if (!atGet("%V", supply)) {
+        milliVolts = 9999;
+        return false;
+    }
+    milliVolts = supply;
+    return true;
+}
+
+
+float DigiXBeeCellularApi::getModemChipTemperature(void) {
+    MS_DBG(F("Getting temperature:"));
+    uint32_t temp = 0;
+    if (!atGet("TP", temp)) return static_cast<float>(-9999);
+    // The temperature is a signed 16 bit value
+    float tempC = static_cast<int16_t>(temp);
+    MS_DBG(F("Temperature:"), tempC);
+    return tempC;
+}
+
+
+// The XBee3 has its own sockets, so every client is a separate socket
+Client* DigiXBeeCellularApi::getMuxClient(uint8_t socketNum) {
+    if (socketNum >= MS_MODEM_MUX_CLIENTS) return nullptr;
+    if (_muxClients[socketNum] == nullptr) {
+        _muxClients[socketNum] = new DigiXBeeApiClient(this);
+    }
+    return _muxClients[socketNum];
+}
+
+
+// The LA command looks up a host name and gives its 4 byte address
+bool DigiXBeeCellularApi::lookupHostIP(const char* host, IPAddress& ip) {
+    uint8_t address[4];
+    if (atCommand("LA", reinterpret_cast<const uint8_t*>(host), strlen(host),
+                  address, 4, 15000L) != 4) {
+        return false;
+    }
+    ip = IPAddress(address[0], address[1], address[2], address[3]);
+    return true;
+}
+
+
+int16_t DigiXBeeCellularApi::atCommand(const char* command,
+                                       const uint8_t* param, size_t paramLen,
+                                       uint8_t* response, size_t responseMax,
+                                       uint32_t timeout_ms) {
+    uint8_t header[4] = {XBEE_FRAME_AT_COMMAND, nextFrameId(),
+                         static_cast<uint8_t>(command[0]),
+                         static_cast<uint8_t>(command[1])};
+    sendFrame(header, 4, param, paramLen);
+    // The response is the type, frame ID, command, status and any value
+    if (!waitFrame(XBEE_FRAME_AT_RESPONSE, header[1], timeout_ms)) {
+        MS_DBG(F("No response to"), command);
+        return -1;
+    }
+    if (_frameLen < 5 || _frame[4] != 0) {
+        MS_DBG(F("Command"), command, F("failed with status"), _frame[4]);
+        return -1;
+    }
+    size_t valueLen = _frameLen - 5;
+    if (valueLen > responseMax) valueLen = responseMax;
+    if (response != nullptr) memcpy(response, _frame + 5, valueLen);
+    return valueLen;
+}
+
+
+// Numbers are sent most significant byte first, without leading zeros
+bool DigiXBeeCellularApi::atSet(const char* command, uint32_t value) {
+    uint8_t param[4];
+    uint8_t paramLen = 0;
+    for (int8_t shift = 24; shift >= 0; shift -= 8) {
+        uint8_t b = (value >> shift) & 0xFF;
+        if (b != 0 || paramLen > 0 || shift == 0) param[paramLen++] = b;
+    }
+    return atCommand(command, param, paramLen) >= 0;
+}
+bool DigiXBeeCellularApi::atGet(const char* command, uint32_t& value) {
+    uint8_t response[4];
+    int16_t len = atCommand(command, nullptr, 0, response, 4);
+    if (len <= 0) return false;
+    value = 0;
+    for (int16_t i = 0; i < len; i++) value = (value << 8) | response[i];
+    return true;
+}
+
+
+void DigiXBeeCellularApi::sendFrame(const uint8_t* header, size_t headerLen,
+                                    const uint8_t* payload,
+                                    size_t         payloadLen) {
+    uint16_t length = headerLen + payloadLen;
+    uint8_t  sum    = 0;
+    _modemStream->write(static_cast<uint8_t>(XBEE_FRAME_START));
+    writeEscaped(_modemStream, length >> 8);
+    writeEscaped(_modemStream, length & 0xFF);
+    for (size_t i = 0; i < headerLen; i++) {
+        writeEscaped(_modemStream, header[i]);
+        sum += header[i];
+    }
+    for (size_t i = 0; i < payloadLen; i++) {
+        writeEscaped(_modemStream, payload[i]);
+        sum += payload[i];
+    }
+    writeEscaped(_modemStream, 0xFF - sum);
+}
+
+
+uint8_t DigiXBeeCellularApi::nextFrameId(void) {
+    if (++_frameId == 0) _frameId = 1;
+    return _frameId;
+}
+
+
+// A frame is the start byte, a two byte length, the data and a checksum;
+// reading stops once a frame has been kept so it isn't written over
+bool DigiXBeeCellularApi::pumpFrames(void) {
+    _frameReady = false;
+    while (!_frameReady && _modemStream->available()) {
+        uint8_t b = _modemStream->read();
+        // A start byte is never escaped, so it always starts a new frame
+        if (b == XBEE_FRAME_START) {
+            _rxState  = 1;
+            _rxEscape = false;
+            continue;
+        }
+        if (_rxState == 0) continue;
+        if (b == XBEE_FRAME_ESCAPE) {
+            _rxEscape = true;
+            continue;
+        }
+        if (_rxEscape) {
+            b ^= 0x20;
+            _rxEscape = false;
+        }
+
+        switch (_rxState) {
+            case 1:
+                _rxLength = static_cast<uint16_t>(b) << 8;
+                _rxState  = 2;
+                break;
+            case 2:
+                _rxLength |= b;
+                _rxCount  = 0;
+                _rxSum    = 0;
+                _rxClient = nullptr;
+                _rxState  = _rxLength > 0 ? 3 : 0;
+                break;
+            case 3:
+                _rxSum += b;
+                // Socket data goes straight to its client
+                if (_frame[0] == XBEE_FRAME_SOCKET_RECEIVE && _rxCount >= 4) {
+                    if (_rxClient != nullptr) _rxClient->receive(b);
+                } else if (_rxCount < XBEE_API_FRAME_BUFFER) {
+                    _frame[_rxCount] = b;
+                }
+                if (_frame[0] == XBEE_FRAME_SOCKET_RECEIVE && _rxCount == 2) {
+                    _rxClient = findClient(b);
+                }
+                if (++_rxCount == _rxLength) _rxState = 4;
+                break;
+            case 4:
+                _rxState = 0;
+                if (static_cast<uint8_t>(_rxSum + b) != 0xFF) {
+                    MS_DBG(F("Bad checksum on XBee frame type"), _frame[0]);
+                    break;
+                }
+                _frameLen = _rxLength < XBEE_API_FRAME_BUFFER
+                    ? _rxLength
+                    : XBEE_API_FRAME_BUFFER;
+                handleFrame();
+                break;
+        }
+    }
+    return _frameReady;
+}
+
+
+bool DigiXBeeCellularApi::waitFrame(uint8_t frameType, uint8_t frameId,
+                                    uint32_t timeout_ms) {
+    uint32_t startMillis = millis();
+    do {
+        // Any other response kept is stale and dropped
+        if (pumpFrames() && _frame[0] == frameType && _frame[1] == frameId) {
+            return true;
+        }
+    } while (millis() - startMillis < timeout_ms);
+    return false;
+}
+
+
+void DigiXBeeCellularApi::handleFrame(void) {
+    switch (_frame[0]) {
+        // The data is already with its client
+        case XBEE_FRAME_SOCKET_RECEIVE: break;
+        case XBEE_FRAME_MODEM_STATUS:
+            MS_DBG(F("XBee modem status:"), _frame[1]);
+            break;
+        // A closed socket's ID can be given out again
+        case XBEE_FRAME_SOCKET_STATUS: {
+            DigiXBeeApiClient* client = findClient(_frame[1]);
+            if (client != nullptr) {
+                client->_connected = _frame[2] == 0;
+                if (!client->_connected) client->_socket = -1;
+            }
+            _frameReady = true;
+            break;
+        }
+        default: _frameReady = true; break;
+    }
+}
+
+
+DigiXBeeApiClient* DigiXBeeCellularApi::findClient(int16_t socket) {
+    if (socket < 0) return nullptr;
+    if (gsmClient._socket == socket) return &gsmClient;
+    for (uint8_t i = 0; i < MS_MODEM_MUX_CLIENTS; i++) {
+        if (_muxClients[i] != nullptr && _muxClients[i]->_socket == socket) {
+            return _muxClients[i];
+        }
+    }
+    return nullptr;
+}
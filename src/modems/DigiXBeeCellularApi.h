@@ -0,0 +1,337 @@
+/**
+ * @file DigiXBeeCellularApi.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the DigiXBeeCellularApi class for Digi Cellular XBee3's
+ * operating in API mode, and the DigiXBeeApiClient class for its sockets.
+ */
+
+// Header Guards
+#ifndef SRC_MODEMS_DIGIXBEECELLULARAPI_H_
+#define SRC_MODEMS_DIGIXBEECELLULARAPI_H_
+
+// Debugging Statement
+// #define MS_DIGIXBEECELLULARAPI_DEBUG
+
+#ifdef MS_DIGIXBEECELLULARAPI_DEBUG
+#define MS_DEBUGGING_STD "DigiXBeeCellularApi"
+#endif
+
+/** @ingroup modem_digi_cellular */
+/**@{*/
+
+#ifndef XBEE_API_RX_BUFFER
+/**
+ * @brief The size of the receive buffer of each API mode socket.
+ *
+ * In API mode the XBee sends received data as soon as it arrives, rather than
+ * holding it until asked, so data that doesn't fit before it's read is lost.
+ */
+#define XBEE_API_RX_BUFFER 128
+#endif
+#ifndef XBEE_API_FRAME_BUFFER
+/**
+ * @brief The size of the buffer for the API frames other than received
+ * socket data; the AT command responses and socket statuses.
+ */
+#define XBEE_API_FRAME_BUFFER 64
+#endif
+/**
+ * @brief The time to wait for the response to an API frame.
+ */
+#define XBEE_API_RESPONSE_TIME_MS 5000L
+/**
+ * @brief The time to wait for a socket to connect after the XBee starts
+ * connecting it.
+ */
+#define XBEE_API_CONNECT_TIME_MS 30000L
+/**
+ * @brief The most data sent in one socket send frame.
+ */
+#define XBEE_API_MAX_SEND 1500
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "DigiXBee.h"
+
+class DigiXBeeCellularApi;
+
+/**
+ * @brief A TCP socket on a Digi XBee3 Cellular in API mode.
+ *
+ * The socket is opened, written to and closed with the XBee3's extended socket
+ * API frames.  The data received on it is put into its own buffer by the
+ * modem as the frames arrive, so any number of sockets can be open at once
+ * without the modem leaving a mode or switching between them.
+ */
+class DigiXBeeApiClient : public Client {
+ public:
+    /**
+     * @brief Construct a new Digi XBee API client object
+     *
+     * @param modem The modem the socket is opened on
+     * @param useTls True to open the socket with TLS
+     */
+    explicit DigiXBeeApiClient(DigiXBeeCellularApi* modem, bool useTls = false);
+    /**
+     * @brief Destroy the Digi XBee API client object
+     */
+    virtual ~DigiXBeeApiClient();
+
+    int     connect(IPAddress ip, uint16_t port) override;
+    int     connect(const char* host, uint16_t port) override;
+    size_t  write(uint8_t b) override;
+    size_t  write(const uint8_t* buf, size_t size) override;
+    int     available() override;
+    int     read() override;
+    int     read(uint8_t* buf, size_t size) override;
+    int     peek() override;
+    void    flush() override;
+    void    stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+ private:
+    friend class DigiXBeeCellularApi;
+    /**
+     * @brief Create the socket on the modem and connect it.
+     *
+     * @param addressType 0 for an IPv4 address, 1 for a host name
+     * @param address The address, 4 bytes or the host name
+     * @param addressLen The length of the address
+     * @param port The port to connect to
+     * @return **int** 1 if the socket connected
+     */
+    int openSocket(uint8_t addressType, const uint8_t* address,
+                   size_t addressLen, uint16_t port);
+    /**
+     * @brief Add a byte received on the socket to the buffer.
+     *
+     * @param b The byte received
+     */
+    void receive(uint8_t b);
+
+    DigiXBeeCellularApi* _modem;
+    bool                 _useTls;
+    // The socket ID given by the modem, or -1 if none is open
+    int16_t _socket    = -1;
+    bool    _connected = false;
+    // The received data not yet read
+    uint8_t  _rx[XBEE_API_RX_BUFFER];
+    uint16_t _rxHead = 0;
+    uint16_t _rxTail = 0;
+};
+
+
+/**
+ * @brief The loggerModem subclass for Digi XBee3 Cellular modems operating in
+ * API mode.
+ *
+ * In transparent mode, every AT command and every query of the signal or
+ * connection state means entering command mode with the `+++` sequence, which
+ * has a guard time of silence on each side, and leaving it again.  In API mode
+ * (`AP2`, with escaping) the commands, the socket data and the modem status
+ * all go as framed packets on the same serial line, so a command is a single
+ * round trip of a few milliseconds.  The sockets are the XBee3's own, so
+ * several can be open at once; see getMuxClient().
+ *
+ * This does not use TinyGSM.  On its first setup the XBee is switched into
+ * API mode with command mode, just once; it stays in API mode after that,
+ * even after a power cycle.
+ *
+ * @note Only XBee3 Cellular modules, with the extended socket frames, can be
+ * used in API mode this way.  The XBee3 Wi-Fi uses the same socket frames and
+ * could share this, but DigiXBeeWifi still uses transparent mode.
+ */
+class DigiXBeeCellularApi : public DigiXBee {
+ public:
+    /**
+     * @brief Construct a new Digi XBee Cellular API object
+     *
+     * The constuctor initializes all of the provided member variables,
+     * constructs a loggerModem parent class with the appropriate timing for the
+     * module, and creates a client linked to the modem.
+     *
+     * @param modemStream The Arduino stream instance for serial communication.
+     * @param powerPin @copydoc loggerModem::_powerPin
+     * @param statusPin @copydoc loggerModem::_statusPin
+     * This can be either the pin named `ON/SLEEP_N/DIO9` or `CTS_N/DIO7` pin in
+     * Digi's hardware reference.
+     * @param useCTSStatus True to use the `CTS_N/DIO7` pin of the XBee as a
+     * status indicator rather than the true status (`ON/SLEEP_N/DIO9`) pin.
+     * This inverts the loggerModem::_statusLevel.
+     * @param modemResetPin @copydoc loggerModem::_modemResetPin
+     * This shold be the pin called `RESET_N` in Digi's hardware reference.
+     * @param modemSleepRqPin @copydoc loggerModem::_modemSleepRqPin
+     * This shold be the pin called `DTR_N/SLEEP_RQ/DIO8` in Digi's hardware
+     * reference.
+     * @param apn The Access Point Name (APN) for the SIM card.
+     *
+     * @see DigiXBee::DigiXBee
+     */
+    DigiXBeeCellularApi(Stream* modemStream, int8_t powerPin, int8_t statusPin,
+                        bool useCTSStatus, int8_t modemResetPin,
+                        int8_t modemSleepRqPin, const char* apn);
+    /**
+     * @brief Destroy the Digi XBee Cellular API object - no action needed
+     */
+    ~DigiXBeeCellularApi();
+
+    bool modemWake(void) override;
+
+    bool connectInternet(uint32_t maxConnectionTime = 50000L) override;
+    void disconnectInternet(void) override;
+
+    uint32_t getNISTTime(void) override;
+
+    bool  getModemSignalQuality(int16_t& rssi, int16_t& percent) override;
+    bool  getModemBatteryStats(uint8_t& chargeState, int8_t& percent,
+                               uint16_t& milliVolts) override;
+    float getModemChipTemperature(void) override;
+
+    Client* getMuxClient(uint8_t socketNum) override;
+    bool    lookupHostIP(const char* host, IPAddress& ip) override;
+    /**
+     * @copydoc loggerModem::getMaxSendSize()
+     */
+    uint16_t getMaxSendSize(void) override {
+        return XBEE_API_MAX_SEND;
+    }
+
+    /**
+     * @brief Public reference to the default client.
+     */
+    DigiXBeeApiClient gsmClient;
+
+ protected:
+    bool isInternetAvailable(void) override;
+    bool isNetworkRegistered(void) override;
+    /**
+     * @copybrief loggerModem::extraModemSetup()
+     *
+     * For XBees in API mode, this switches the XBee into API mode if it isn't
+     * already, enables pin sleep, sets the DIO pins to the expected functions,
+     * sets the APN, and applies the changes.
+     *
+     * @return **bool** True if the extra setup succeeded.
+     */
+    bool     extraModemSetup(void) override;
+    bool     isModemAwake(void) override;
+    bool     testATFxn(uint32_t timeout_ms) override;
+    uint32_t getNITZTime(void) override;
+
+ private:
+    friend class DigiXBeeApiClient;
+
+    /**
+     * @brief Send an AT command in an API frame and wait for its response.
+     *
+     * @param command The two letter command
+     * @param param The parameter of the command, in binary for numbers; an
+     * empty parameter queries the command's setting
+     * @param paramLen The length of the parameter
+     * @param response The value returned, if any
+     * @param responseMax The size of the response buffer
+     * @param timeout_ms The time to wait for the response
+     * @return **int16_t** The length of the value returned, or -1 if the
+     * command failed or got no response
+     */
+    int16_t atCommand(const char* command, const uint8_t* param = nullptr,
+                      size_t paramLen = 0, uint8_t* response = nullptr,
+                      size_t   responseMax = 0,
+                      uint32_t timeout_ms  = XBEE_API_RESPONSE_TIME_MS);
+    /**
+     * @brief Set a numeric AT command.
+     *
+     * @param command The two letter command
+     * @param value The value to set
+     * @return **bool** True if the command succeeded
+     */
+    bool atSet(const char* command, uint32_t value);
+    /**
+     * @brief Query a numeric AT command.
+     *
+     * @param command The two letter command
+     * @param value The value returned
+     * @return **bool** True if the command succeeded
+     */
+    bool atGet(const char* command, uint32_t& value);
+    /**
+     * @brief Send an API frame, escaping the bytes that need it.
+     *
+     * The frame data is given in two parts so a payload can be sent from
+     * where it is without copying it behind its header.
+     *
+     * @param header The frame type and the fixed fields
+     * @param headerLen The length of the header
+     * @param payload The variable data of the frame
+     * @param payloadLen The length of the payload
+     */
+    void sendFrame(const uint8_t* header, size_t headerLen,
+                   const uint8_t* payload = nullptr, size_t payloadLen = 0);
+    /**
+     * @brief Get the next frame ID, skipping 0, which asks for no response.
+     *
+     * @return **uint8_t** The frame ID
+     */
+    uint8_t nextFrameId(void);
+    /**
+     * @brief Read and handle all the frame bytes waiting on the serial line.
+     *
+     * Received socket data goes to the client of the socket and socket
+     * statuses update it; any other frame is kept for waitFrame().
+     *
+     * @return **bool** True if a frame other than socket data is now kept
+     */
+    bool pumpFrames(void);
+    /**
+     * @brief Wait for the response frame of the given type and frame ID.
+     *
+     * @param frameType The type of the response frame
+     * @param frameId The frame ID of the request
+     * @param timeout_ms The time to wait
+     * @return **bool** True if the response was received; it is then in
+     * _frame
+     */
+    bool waitFrame(uint8_t frameType, uint8_t frameId,
+                   uint32_t timeout_ms = XBEE_API_RESPONSE_TIME_MS);
+    /**
+     * @brief Handle a whole received frame.
+     */
+    void handleFrame(void);
+    /**
+     * @brief Find the client with the given socket ID.
+     *
+     * @param socket The socket ID
+     * @return **DigiXBeeApiClient\*** The client, or a nullptr if none has the
+     * socket
+     */
+    DigiXBeeApiClient* findClient(int16_t socket);
+    /**
+     * @brief Switch the XBee into API mode with the `+++` command mode.
+     *
+     * @return **bool** True if the XBee took the commands
+     */
+    bool enterApiMode(void);
+
+    Stream*            _modemStream;
+    const char*        _apn;
+    DigiXBeeApiClient* _muxClients[MS_MODEM_MUX_CLIENTS] = {};
+    uint8_t            _frameId                          = 0;
+    // The state of the frame being received
+    uint8_t            _rxState  = 0;
+    bool               _rxEscape = false;
+    uint16_t           _rxLength = 0;
+    uint16_t           _rxCount  = 0;
+    uint8_t            _rxSum    = 0;
+    DigiXBeeApiClient* _rxClient = nullptr;
+    // The last whole frame other than socket data
+    uint8_t  _frame[XBEE_API_FRAME_BUFFER];
+    uint16_t _frameLen   = 0;
+    bool     _frameReady = false;
+};
+/**@}*/
+#endif  // SRC_MODEMS_DIGIXBEECELLULARAPI_H_
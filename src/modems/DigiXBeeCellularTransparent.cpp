@@ -23,7 +23,7 @@ DigiXBeeCellularTransparent::DigiXBeeCellularTransparent(
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger, modemResetPin),
 #else
-      gsmModem(*modemStream, modemResetPin),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream), modemResetPin),
 #endif
       gsmClient(gsmModem),
       _apn(apn),
@@ -40,6 +40,7 @@ MS_MODEM_WAKE(DigiXBeeCellularTransparent);
 MS_MODEM_CONNECT_INTERNET(DigiXBeeCellularTransparent);
 MS_MODEM_DISCONNECT_INTERNET(DigiXBeeCellularTransparent);
 MS_MODEM_IS_INTERNET_AVAILABLE(DigiXBeeCellularTransparent);
+MS_MODEM_IS_NETWORK_REGISTERED(DigiXBeeCellularTransparent);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(DigiXBeeCellularTransparent);
 MS_MODEM_GET_MODEM_BATTERY_DATA(DigiXBeeCellularTransparent);
@@ -51,7 +52,7 @@ bool DigiXBeeCellularTransparent::modemWakeFxn(void) {
         // Don't go to sleep if there's not a wake pin!
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                _wakeLevel ? F("HIGH") : F("LOW"), F("to wake"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         MS_DBG(F("Turning off airplane mode..."));
         if (gsmModem.commandMode()) {
             gsmModem.sendAT(GF("AM"), 0);
@@ -83,7 +84,7 @@ bool DigiXBeeCellularTransparent::modemSleepFxn(void) {
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                !_wakeLevel ? F("HIGH") : F("LOW"), F("to put"), _modemName,
                F("to sleep"));
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
         return true;
     } else {
         return true;
@@ -253,13 +254,21 @@ bool DigiXBeeCellularTransparent::updateModemMetadata(void) {
     loggerModem::_priorSignalPercent  = -9999;
     loggerModem::_priorBatteryState   = -9999;
     loggerModem::_priorBatteryPercent = -9999;
-    loggerModem::_priorBatteryPercent = -9999;
+    loggerModem::_priorBatteryVoltage = -9999;
     loggerModem::_priorModemTemp      = -9999;
 
+    // Only ask for what some Variable will report
+    bool needSignal = _metadataFields & MODEM_SIGNAL_FIELDS;
+    bool needTemp   = _metadataFields & MODEM_TEMPERATURE_ENABLE_BITMASK;
+    if (!needSignal && !needTemp) {
+        MS_DBG(F("No modem metadata is needed"));
+        return success;
+    }
+
     // Initialize variable
     int16_t signalQual = -9999;
 
-    // Enter command mode only once
+    // Enter command mode only once for all of the fields
     MS_DBG(F("Entering Command Mode:"));
     gsmModem.commandMode();
 
@@ -268,25 +277,30 @@ bool DigiXBeeCellularTransparent::updateModemMetadata(void) {
     // modem response, and a real response from the modem of no service/signal.
     // The TinyGSM getSignalQuality function returns the same "no signal"
     // value (99 CSQ or 0 RSSI) in all 3 cases.
-    uint32_t startMillis = millis();
-    do {
-        MS_DBG(F("Getting signal quality:"));
-        signalQual = gsmModem.getSignalQuality();
-        MS_DBG(F("Raw signal quality:"), signalQual);
-        if (signalQual != 0 && signalQual != -9999) break;
-        delay(250);
-    } while ((signalQual == 0 || signalQual == -9999) &&
-             millis() - startMillis < 15000L && success);
+    if (needSignal) {
+        uint32_t startMillis = millis();
+        do {
+            MS_DBG(F("Getting signal quality:"));
+            signalQual = gsmModem.getSignalQuality();
+            MS_DBG(F("Raw signal quality:"), signalQual);
+            if (signalQual != 0 && signalQual != -9999) break;
+            delay(250);
+        } while ((signalQual == 0 || signalQual == -9999) &&
+                 millis() - startMillis < 15000L && success);
 
-    // Convert signal quality to RSSI
-    loggerModem::_priorRSSI = signalQual;
-    MS_DBG(F("CURRENT RSSI:"), signalQual);
-    loggerModem::_priorSignalPercent = getPctFromRSSI(signalQual);
-    MS_DBG(F("CURRENT Percent signal strength:"), getPctFromRSSI(signalQual));
+        // Convert signal quality to RSSI
+        loggerModem::_priorRSSI = signalQual;
+        MS_DBG(F("CURRENT RSSI:"), signalQual);
+        loggerModem::_priorSignalPercent = getPctFromRSSI(signalQual);
+        MS_DBG(F("CURRENT Percent signal strength:"),
+               getPctFromRSSI(signalQual));
+    }
 
-    MS_DBG(F("Getting chip temperature:"));
-    loggerModem::_priorModemTemp = getModemChipTemperature();
-    MS_DBG(F("CURRENT Modem temperature:"), loggerModem::_priorModemTemp);
+    if (needTemp) {
+        MS_DBG(F("Getting chip temperature:"));
+        loggerModem::_priorModemTemp = getModemChipTemperature();
+        MS_DBG(F("CURRENT Modem temperature:"), loggerModem::_priorModemTemp);
+    }
 
     // Exit command modem
     MS_DBG(F("Leaving Command Mode:"));
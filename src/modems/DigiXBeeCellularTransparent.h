@@ -188,6 +188,7 @@ class DigiXBeeCellularTransparent : public DigiXBee {
 
  protected:
     bool isInternetAvailable(void) override;
+    bool isNetworkRegistered(void) override;
     bool modemWakeFxn(void) override;
     bool modemSleepFxn(void) override;
     /**
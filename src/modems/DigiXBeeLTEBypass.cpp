@@ -22,7 +22,7 @@ DigiXBeeLTEBypass::DigiXBeeLTEBypass(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -37,8 +37,11 @@ MS_MODEM_WAKE(DigiXBeeLTEBypass);
 MS_MODEM_CONNECT_INTERNET(DigiXBeeLTEBypass);
 MS_MODEM_DISCONNECT_INTERNET(DigiXBeeLTEBypass);
 MS_MODEM_IS_INTERNET_AVAILABLE(DigiXBeeLTEBypass);
+MS_MODEM_IS_NETWORK_REGISTERED(DigiXBeeLTEBypass);
 
 MS_MODEM_GET_NIST_TIME(DigiXBeeLTEBypass);
+MS_MODEM_GET_NITZ_TIME(DigiXBeeLTEBypass);
+MS_MODEM_GET_MUX_CLIENT(DigiXBeeLTEBypass);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(DigiXBeeLTEBypass);
 MS_MODEM_GET_MODEM_BATTERY_DATA(DigiXBeeLTEBypass);
@@ -47,12 +50,17 @@ MS_MODEM_GET_MODEM_TEMPERATURE_DATA(DigiXBeeLTEBypass);
 bool DigiXBeeLTEBypass::extraModemSetup(void) {
     bool success = false;
     MS_DBG(F("Putting XBee into command mode..."));
+    uint32_t lastSent = millis();
     for (uint8_t i = 0; i < 5; i++) {
-        /** First, wait the required guard time before entering command mode. */
-        delay(1010);
+        /** First, wait the required guard time before entering command mode.
+         * Retries only wait what's left of it after the failed try. */
+        while (millis() - lastSent < XBEE_GUARD_TIME_MS) {
+            // wait
+        }
         /** Now, enter command mode to set all pin I/O functionality. */
         gsmModem.streamWrite(GF("+++"));
-        success = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
+        lastSent = millis();
+        success  = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
         if (success) break;
     }
     if (success) {
@@ -127,8 +135,9 @@ bool DigiXBeeLTEBypass::extraModemSetup(void) {
         MS_DBG(F("Resetting the module to reboot in bypass mode..."));
         gsmModem.sendAT(GF("FR"));
         success &= gsmModem.waitResponse(5000L, GF("OK\r")) == 1;
-        /** Allow 5s for the unit to reset. */
-        delay(500);
+        /** Allow up to 500ms for the unit to reset, or only as long as the
+         * status pin shows the reset takes. */
+        waitForReboot(500);
         /** Re-initialize the TinyGSM SARA R4 instance. */
         MS_DBG(F("Attempting to reconnect to the u-blox SARA R410M module..."));
         success &= gsmModem.init();
@@ -151,11 +160,16 @@ bool DigiXBeeLTEBypass::modemHardReset(void) {
     // If the u-blox cellular component isn't responding but the Digi processor
     // is, use the Digi API to reset the cellular component
     MS_DBG(F("Returning XBee to command mode..."));
+    uint32_t lastSent = millis();
     for (uint8_t i = 0; i < 5; i++) {
-        // Wait the required guard time before entering command mode
-        delay(1010);
+        // Wait the required guard time before entering command mode; a retry
+        // only waits what's left of it after the failed try
+        while (millis() - lastSent < XBEE_GUARD_TIME_MS) {
+            // wait
+        }
         gsmModem.streamWrite(GF("+++"));  // enter command mode
-        success = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
+        lastSent = millis();
+        success  = gsmModem.waitResponse(2000, GF("OK\r")) == 1;
         if (success) break;
     }
     if (success) {
@@ -147,6 +147,8 @@ class DigiXBeeLTEBypass : public DigiXBee {
 
     uint32_t getNISTTime(void) override;
 
+    Client* getMuxClient(uint8_t socketNum) override;
+
     bool  getModemSignalQuality(int16_t& rssi, int16_t& percent) override;
     bool  getModemBatteryStats(uint8_t& chargeState, int8_t& percent,
                                uint16_t& milliVolts) override;
@@ -169,6 +171,7 @@ class DigiXBeeLTEBypass : public DigiXBee {
 
  protected:
     bool isInternetAvailable(void) override;
+    bool isNetworkRegistered(void) override;
     /**
      * @copybrief loggerModem::extraModemSetup()
      *
@@ -178,10 +181,15 @@ class DigiXBeeLTEBypass : public DigiXBee {
      *
      * @return **bool** True if the extra setup succeeded.
      */
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    bool     isModemAwake(void) override;
 
  private:
+    /**
+     * @brief Clients for the extra sockets used for concurrent publishing
+     */
+    TinyGsmClient* _muxClients[MS_MODEM_MUX_CLIENTS] = {};
     const char* _apn;
 };
 /**@}*/
@@ -22,7 +22,7 @@ DigiXBeeWifi::DigiXBeeWifi(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger, modemResetPin),
 #else
-      gsmModem(*modemStream, modemResetPin),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream), modemResetPin),
 #endif
       gsmClient(gsmModem),
       _ssid(ssid),
@@ -250,9 +250,14 @@ bool DigiXBeeWifi::updateModemMetadata(void) {
     loggerModem::_priorSignalPercent  = -9999;
     loggerModem::_priorBatteryState   = -9999;
     loggerModem::_priorBatteryPercent = -9999;
-    loggerModem::_priorBatteryPercent = -9999;
+    loggerModem::_priorBatteryVoltage = -9999;
     loggerModem::_priorModemTemp      = -9999;
 
+    // Only ask for what some Variable will report
+    bool needSignal  = _metadataFields & MODEM_SIGNAL_FIELDS;
+    bool needVoltage = _metadataFields & MODEM_BATTERY_VOLTAGE_ENABLE_BITMASK;
+    bool needTemp    = _metadataFields & MODEM_TEMPERATURE_ENABLE_BITMASK;
+
     // Initialize variable
     int16_t  rssi    = -9999;
     int16_t  percent = -9999;
@@ -260,34 +265,39 @@ bool DigiXBeeWifi::updateModemMetadata(void) {
 
     // Try up to 5 times to get a signal quality - that is, ping NIST 5 times
     // and see if the value updates
-    int8_t num_pings_remaining = 5;
-    do {
-        getModemSignalQuality(rssi, percent);
-        MS_DBG(F("Raw signal quality:"), rssi);
-        if (percent != 0 && percent != -9999) break;
-        num_pings_remaining--;
-    } while ((percent == 0 || percent == -9999) && num_pings_remaining);
-
-    // Convert signal quality to RSSI
-    loggerModem::_priorRSSI          = rssi;
-    loggerModem::_priorSignalPercent = percent;
+    if (needSignal) {
+        int8_t num_pings_remaining = 5;
+        do {
+            getModemSignalQuality(rssi, percent);
+            MS_DBG(F("Raw signal quality:"), rssi);
+            if (percent != 0 && percent != -9999) break;
+            num_pings_remaining--;
+        } while ((percent == 0 || percent == -9999) && num_pings_remaining);
+
+        // Convert signal quality to RSSI
+        loggerModem::_priorRSSI          = rssi;
+        loggerModem::_priorSignalPercent = percent;
+    }
 
+    if (!needVoltage && !needTemp) return success;
 
     // Enter command mode only once for temp and battery
     MS_DBG(F("Entering Command Mode:"));
     success &= gsmModem.commandMode();
 
-    MS_DBG(F("Getting input voltage:"));
-    volt = gsmModem.getBattVoltage();
-    MS_DBG(F("CURRENT Modem input battery voltage:"), volt);
-    if (volt != 9999)
-        loggerModem::_priorBatteryVoltage = static_cast<float>(volt);
-    else
-        loggerModem::_priorBatteryVoltage = static_cast<float>(-9999);
+    if (needVoltage) {
+        MS_DBG(F("Getting input voltage:"));
+        volt = gsmModem.getBattVoltage();
+        MS_DBG(F("CURRENT Modem input battery voltage:"), volt);
+        if (volt != 9999)
+            loggerModem::_priorBatteryVoltage = static_cast<float>(volt);
+    }
 
-    MS_DBG(F("Getting chip temperature:"));
-    loggerModem::_priorModemTemp = getModemChipTemperature();
-    MS_DBG(F("CURRENT Modem temperature:"), loggerModem::_priorModemTemp);
+    if (needTemp) {
+        MS_DBG(F("Getting chip temperature:"));
+        loggerModem::_priorModemTemp = getModemChipTemperature();
+        MS_DBG(F("CURRENT Modem temperature:"), loggerModem::_priorModemTemp);
+    }
 
     // Exit command modem
     MS_DBG(F("Leaving Command Mode:"));
@@ -295,3 +305,64 @@ bool DigiXBeeWifi::updateModemMetadata(void) {
 
     return success;
 }
+
+
+// The channel is in hex and the addresses are dotted
+bool DigiXBeeWifi::readNetworkHint(networkHint& hint) {
+    if (!gsmModem.commandMode()) return false;
+    gsmModem.sendAT(GF("CH"));
+    hint.channel = strtoul(gsmModem.stream.readStringUntil('\r').c_str(),
+                           nullptr, 16);
+    IPAddress addresses[3];
+    bool      success = hint.channel != 0;
+    gsmModem.sendAT(GF("MY"));
+    success &= addresses[0].fromString(gsmModem.stream.readStringUntil('\r'));
+    gsmModem.sendAT(GF("GW"));
+    success &= addresses[1].fromString(gsmModem.stream.readStringUntil('\r'));
+    gsmModem.sendAT(GF("MK"));
+    success &= addresses[2].fromString(gsmModem.stream.readStringUntil('\r'));
+    gsmModem.exitCommand();
+    for (uint8_t i = 0; success && i < 4; i++) {
+        hint.ip[i]      = addresses[0][i];
+        hint.gateway[i] = addresses[1][i];
+        hint.netmask[i] = addresses[2][i];
+    }
+    return success;
+}
+
+
+bool DigiXBeeWifi::pinNetworkFxn(const networkHint* hint) {
+#if MS_WIFI_REUSE_ADDRESS
+    if (hint != nullptr && hint->ip[0] == 0) return false;
+    if (!gsmModem.commandMode()) return false;
+    if (hint == nullptr) {
+        MS_DBG(F("Turning DHCP back on"));
+        gsmModem.sendAT(GF("MA"), 0);
+        gsmModem.waitResponse();
+    } else {
+        MS_DBG(F("Reusing the last address"));
+        char text[16];
+        gsmModem.sendAT(GF("MA"), 1);
+        gsmModem.waitResponse();
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", hint->ip[0], hint->ip[1],
+                 hint->ip[2], hint->ip[3]);
+        gsmModem.sendAT(GF("MY"), text);
+        gsmModem.waitResponse();
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", hint->gateway[0],
+                 hint->gateway[1], hint->gateway[2], hint->gateway[3]);
+        gsmModem.sendAT(GF("GW"), text);
+        gsmModem.waitResponse();
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", hint->netmask[0],
+                 hint->netmask[1], hint->netmask[2], hint->netmask[3]);
+        gsmModem.sendAT(GF("MK"), text);
+        gsmModem.waitResponse();
+    }
+    // Write the changes to flash and apply them
+    gsmModem.writeChanges();
+    gsmModem.exitCommand();
+    return true;
+#else
+    (void)hint;
+    return false;
+#endif
+}
@@ -154,6 +154,19 @@ class DigiXBeeWifi : public DigiXBee {
      */
     bool extraModemSetup(void) override;
     bool isModemAwake(void) override;
+    bool readNetworkHint(networkHint& hint) override;
+    /**
+     * @copybrief loggerModem::pinNetworkFxn()
+     *
+     * The XBee can't pick an access point by its BSSID, so this only gives
+     * it the address of its last lease, if #MS_WIFI_REUSE_ADDRESS is set.
+     * The address is written to flash, so the XBee skips DHCP whenever it
+     * joins until automatic selection turns DHCP back on.
+     *
+     * @param hint The access point to join, or a nullptr to use DHCP again
+     * @return **bool** True if the XBee took the address
+     */
+    bool pinNetworkFxn(const networkHint* hint) override;
 
  private:
     const char* _ssid;
@@ -24,7 +24,7 @@ EspressifESP8266::EspressifESP8266(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _modemStream(modemStream),
@@ -78,30 +78,49 @@ bool EspressifESP8266::ESPwaitForBoot(void) {
 // These can be functions of any type and must return a boolean
 bool EspressifESP8266::modemWakeFxn(void) {
     bool success = true;
-    if (_powerPin >= 0) {  // Turns on when power is applied
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+    if (_powerSaving) {
+        // Still associated; only the light sleep has to end
+        if (_modemSleepRqPin >= 0) {
+            MS_DBG(F("Setting pin"), _modemSleepRqPin,
+                   _wakeLevel ? F("HIGH") : F("LOW"),
+                   F("to wake ESP8266 from light sleep"));
+            _modemSleepRqIO.write(_wakeLevel);
+        }
+        if (_statusPin >= 0) {
+            uint32_t start = millis();
+            while (millis() - start < _statusTime_ms &&
+                   _statusIO.read() != static_cast<int>(_statusLevel)) {
+                // wait
+            }
+            success = _statusIO.read() == static_cast<int>(_statusLevel);
+        } else if (_modemSleepRqPin >= 0) {
+            delay(ESP8266_LIGHT_SLEEP_WAKE_MS);
+        }
+        return success;
+    } else if (_powerPin >= 0) {  // Turns on when power is applied
+        _modemSleepRqIO.write(!_wakeLevel);
         success &= ESPwaitForBoot();
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, _wakeLevel);
+            _modemSleepRqIO.write(_wakeLevel);
         }
         return success;
     } else if (_modemResetPin >= 0) {
         MS_DBG(F("Sending a reset pulse to pin"), _modemResetPin,
                F("to wake ESP8266 from deep sleep"));
-        digitalWrite(_modemResetPin, LOW);
+        _modemResetIO.low();
         delay(_resetPulse_ms);
-        digitalWrite(_modemResetPin, HIGH);
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemResetIO.high();
+        _modemSleepRqIO.write(!_wakeLevel);
         success &= ESPwaitForBoot();
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, _wakeLevel);
+            _modemSleepRqIO.write(_wakeLevel);
         }
         return success;
     } else if (_modemSleepRqPin >= 0) {
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                _wakeLevel ? F("HIGH") : F("LOW"),
                F("to wake ESP8266 from light sleep"));
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         return success;
     } else {
         return true;
@@ -115,7 +134,7 @@ bool EspressifESP8266::modemSleepFxn(void) {
         MS_DBG(F("Requesting deep sleep for ESP8266"));
         bool retVal = gsmModem.poweroff();
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, !_wakeLevel);
+            _modemSleepRqIO.write(!_wakeLevel);
         }
         return retVal;
     } else {  // DON'T go to sleep if we can't wake up!
@@ -123,11 +142,142 @@ bool EspressifESP8266::modemSleepFxn(void) {
     }
 }
 
+// In light sleep the wake pin goes back to its sleep level, so the ESP can
+// drop back into light sleep once it's idle
+bool EspressifESP8266::modemSleep(void) {
+    if (_powerSaving && _modemSleepRqPin >= 0) {
+        _modemSleepRqIO.write(!_wakeLevel);
+    }
+    return loggerModem::modemSleep();
+}
+
+
+// The sleep mode is sent by the modem setup in place of power saving timers
+void EspressifESP8266::setKeepAssociated(bool keepAssociated, int8_t wakePin,
+                                         int8_t espWakeGPIO, int8_t statusPin,
+                                         int8_t espStatusGPIO) {
+    // The status GPIO is only set up along with light sleep
+    if (wakePin >= 0 && espWakeGPIO >= 0) {
+        _modemSleepRqPin = wakePin;
+        _modemSleepRqIO.attach(wakePin);
+        _espWakeGPIO = espWakeGPIO;
+        if (statusPin >= 0 && espStatusGPIO >= 0) {
+            _statusPin = statusPin;
+            _statusIO.attach(statusPin);
+            _espStatusGPIO = espStatusGPIO;
+        }
+    }
+    setPowerSavingMode(keepAssociated ? 1 : 0, 0);
+}
+
+
+// Light sleep needs its wake GPIO, and the status GPIO if there is one, set
+// first; modem sleep needs neither
+bool EspressifESP8266::setPowerSavingFxn(void) {
+    if (_modemSleepRqPin >= 0) {
+        MS_DBG(F("Waking the ESP from light sleep with its GPIO"),
+               _espWakeGPIO);
+        if (_statusPin >= 0) {
+            gsmModem.sendAT(GF("+WAKEUPGPIO=1,"),
+                            static_cast<int>(_espWakeGPIO), ',',
+                            static_cast<int>(_wakeLevel), ',',
+                            static_cast<int>(_espStatusGPIO), ',',
+                            static_cast<int>(_statusLevel));
+        } else {
+            gsmModem.sendAT(GF("+WAKEUPGPIO=1,"),
+                            static_cast<int>(_espWakeGPIO), ',',
+                            static_cast<int>(_wakeLevel));
+        }
+        if (gsmModem.waitResponse() != 1) return false;
+        MS_DBG(F("Putting the ESP in light sleep between intervals"));
+        gsmModem.sendAT(GF("+SLEEP=1"));
+    } else {
+        MS_DBG(F("Putting the ESP in modem sleep between intervals"));
+        gsmModem.sendAT(GF("+SLEEP=2"));
+    }
+    return gsmModem.waitResponse() == 1;
+}
+
+
 // Set up the light-sleep status pin, if applicable
 bool EspressifESP8266::extraModemSetup(void) {
-    if (_modemSleepRqPin >= 0) { digitalWrite(_modemSleepRqPin, !_wakeLevel); }
+    if (_modemSleepRqPin >= 0) { _modemSleepRqIO.write(!_wakeLevel); }
     gsmModem.init();
     gsmClient.init(&gsmModem);
     _modemName = gsmModem.getModemName();
     return true;
 }
+
+
+// The BSSID and channel follow the SSID in the join status, and the address,
+// gateway and mask each have a line of the address status
+bool EspressifESP8266::readNetworkHint(networkHint& hint) {
+    gsmModem.sendAT(GF("+CWJAP_CUR?"));
+    if (gsmModem.waitResponse(GF("+CWJAP_CUR:")) != 1) return false;
+    String response = gsmModem.stream.readStringUntil('\n');
+    gsmModem.waitResponse();
+    int bssid = response.indexOf('"', response.indexOf('"', 1) + 1) + 1;
+    if (bssid <= 0) return false;
+    const char* text = response.c_str() + bssid;
+    for (uint8_t i = 0; i < 6; i++) {
+        char* end;
+        hint.bssid[i] = strtoul(text, &end, 16);
+        text          = end + 1;
+    }
+    hint.channel = atoi(text + 1);
+    if (hint.channel == 0) return false;
+
+    gsmModem.sendAT(GF("+CIPSTA_CUR?"));
+    IPAddress addresses[3];
+    bool      success = true;
+    success &= gsmModem.waitResponse(GF("ip:\"")) == 1 &&
+        addresses[0].fromString(gsmModem.stream.readStringUntil('"'));
+    success &= gsmModem.waitResponse(GF("gateway:\"")) == 1 &&
+        addresses[1].fromString(gsmModem.stream.readStringUntil('"'));
+    success &= gsmModem.waitResponse(GF("netmask:\"")) == 1 &&
+        addresses[2].fromString(gsmModem.stream.readStringUntil('"'));
+    gsmModem.waitResponse();
+    // Without the address the hint is still good for the BSSID
+    for (uint8_t i = 0; success && i < 4; i++) {
+        hint.ip[i]      = addresses[0][i];
+        hint.gateway[i] = addresses[1][i];
+        hint.netmask[i] = addresses[2][i];
+    }
+    return true;
+}
+
+
+// A static address takes the place of the DHCP lease until DHCP is turned on
+// again
+bool EspressifESP8266::pinNetworkFxn(const networkHint* hint) {
+    if (hint == nullptr) {
+        MS_DBG(F("Turning DHCP back on"));
+        gsmModem.sendAT(GF("+CWDHCP_CUR=1,1"));
+        return gsmModem.waitResponse() == 1;
+    }
+    char text[18];
+#if MS_WIFI_REUSE_ADDRESS
+    if (hint->ip[0] != 0) {
+        MS_DBG(F("Reusing the last address"));
+        char gateway[16];
+        char netmask[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", hint->ip[0], hint->ip[1],
+                 hint->ip[2], hint->ip[3]);
+        snprintf(gateway, sizeof(gateway), "%u.%u.%u.%u", hint->gateway[0],
+                 hint->gateway[1], hint->gateway[2], hint->gateway[3]);
+        snprintf(netmask, sizeof(netmask), "%u.%u.%u.%u", hint->netmask[0],
+                 hint->netmask[1], hint->netmask[2], hint->netmask[3]);
+        gsmModem.sendAT(GF("+CIPSTA_CUR=\""), text, GF("\",\""), gateway,
+                        GF("\",\""), netmask, '"');
+        gsmModem.waitResponse();
+    }
+#endif
+    snprintf(text, sizeof(text), "%02x:%02x:%02x:%02x:%02x:%02x",
+             hint->bssid[0], hint->bssid[1], hint->bssid[2], hint->bssid[3],
+             hint->bssid[4], hint->bssid[5]);
+    MS_DBG(F("Joining access point"), text, F("on channel"), hint->channel);
+    gsmModem.sendAT(GF("+CWJAP_CUR=\""), _ssid, GF("\",\""), _pwd,
+                    GF("\",\""), text, '"');
+    return gsmModem.waitResponse(MS_PINNED_ATTACH_TIME_MS, GF("OK"),
+                                 GF("FAIL")) == 1;
+}
@@ -164,6 +164,13 @@
  * The serial response time on waking from light sleep is 5ms.
  */
 #define ESP8266_ATRESPONSE_TIME_MS 700
+/**
+ * @brief The time to wait after the wake pin brings the ESP out of light sleep
+ * if there is no status pin to show it's ready.
+ *
+ * Espressif suggests waiting at least 5ms before the next AT command.
+ */
+#define ESP8266_LIGHT_SLEEP_WAKE_MS 5
 
 /**
  * @brief The loggerModem::_disconnetTime_ms.
@@ -219,6 +226,53 @@ class EspressifESP8266 : public loggerModem {
     ~EspressifESP8266();
 
     bool modemWake(void) override;
+    /**
+     * @copydoc loggerModem::modemSleep()
+     *
+     * When the ESP is kept associated, this sets the wake pin back to its
+     * sleep level, so the ESP can drop back into light sleep once it's idle.
+     */
+    bool modemSleep(void) override;
+
+    /**
+     * @brief Keep the ESP powered and associated with the access point
+     * between logging intervals, in light sleep or modem sleep, instead of
+     * putting it in deep sleep or cutting its power.
+     *
+     * Each cycle in deep sleep has to join the access point and get a DHCP
+     * lease again, which takes a few seconds at full power.  Kept associated,
+     * the ESP only wakes its radio for the beacons it must hear (set by the
+     * access point's DTIM period), so at intervals of a few minutes on a
+     * well-powered site it uses less charge than reconnecting, and publishing
+     * starts as soon as it's awake.  At long intervals, deep sleep is still
+     * cheaper.
+     *
+     * With a wake pin, the ESP is put in light sleep and that pin brings it
+     * out; with a status pin as well, the ESP shows on it when it's ready for
+     * commands.  Without a wake pin, the ESP is put in modem sleep, where it
+     * answers commands at once.  The sleep mode is sent when the modem is set
+     * up, so this must be called before that.  The logger doesn't disconnect
+     * a modem kept associated; see loggerModem::isPowerSaving().
+     *
+     * @note The AT firmware has no command for the station's own listen
+     * interval, so the DTIM period of the access point sets how often the
+     * ESP wakes.
+     *
+     * @param keepAssociated True to keep the ESP associated between
+     * intervals
+     * @param wakePin The mcu pin wired to the ESP GPIO that wakes it from
+     * light sleep; -1 to use modem sleep.  It's held at the
+     * #ESP8266_WAKE_LEVEL to wake it.
+     * @param espWakeGPIO The number of the ESP GPIO the wake pin is wired to
+     * @param statusPin The mcu pin wired to the ESP GPIO that shows it's
+     * awake from light sleep; -1 for none.  It's at the #ESP8266_STATUS_LEVEL
+     * when the ESP is awake.
+     * @param espStatusGPIO The number of the ESP GPIO the status pin is wired
+     * to
+     */
+    void setKeepAssociated(bool keepAssociated, int8_t wakePin = -1,
+                           int8_t espWakeGPIO = -1, int8_t statusPin = -1,
+                           int8_t espStatusGPIO = -1);
 
     bool connectInternet(uint32_t maxConnectionTime = 50000L) override;
     void disconnectInternet(void) override;
@@ -257,11 +311,41 @@ class EspressifESP8266 : public loggerModem {
     bool modemWakeFxn(void) override;
     bool extraModemSetup(void) override;
     bool isModemAwake(void) override;
+    bool readNetworkHint(networkHint& hint) override;
+    /**
+     * @copybrief loggerModem::pinNetworkFxn()
+     *
+     * For the ESP, this joins the access point of the hint by its BSSID
+     * and, if #MS_WIFI_REUSE_ADDRESS is set, with its last address instead
+     * of asking for a lease.  Returning to automatic selection turns DHCP
+     * back on.
+     *
+     * @param hint The access point to join, or a nullptr to use DHCP again
+     * @return **bool** True if the ESP joined the access point
+     */
+    bool pinNetworkFxn(const networkHint* hint) override;
+    /**
+     * @copybrief loggerModem::setPowerSavingFxn()
+     *
+     * For the ESP, this sets up the light sleep or modem sleep of
+     * setKeepAssociated() in place of power saving timers.
+     *
+     * @return **bool** True if the ESP accepted the sleep mode
+     */
+    bool setPowerSavingFxn(void) override;
 
  private:
     bool        ESPwaitForBoot(void);
     const char* _ssid;
     const char* _pwd;
+    /**
+     * @brief The ESP GPIO that wakes it from light sleep
+     */
+    int8_t _espWakeGPIO = -1;
+    /**
+     * @brief The ESP GPIO that shows it's awake
+     */
+    int8_t _espStatusGPIO = -1;
 };
 
 /**
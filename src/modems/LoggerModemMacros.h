@@ -15,6 +15,23 @@
 #define SRC_MODEMS_LOGGERMODEMMACROS_H_
 
 
+/**
+ * @brief The stream a TinyGSM modem is given in the initializer list of a
+ * specific modem subclass.
+ *
+ * When `MS_MODEM_PROFILE_AT` is defined, this is the modem's
+ * loggerModem::atProfiler, attached to the modem's stream, so every AT
+ * command TinyGSM sends is timed.  Otherwise it is the modem's stream itself.
+ *
+ * @param modemStream A pointer to the stream of the modem
+ */
+#ifdef MS_MODEM_PROFILE_AT
+#define MS_MODEM_AT_STREAM(modemStream) atProfiler.attach(*modemStream)
+#else
+#define MS_MODEM_AT_STREAM(modemStream) *modemStream
+#endif
+
+
 /**
  * @brief Creates an extraModemSetup() function for a specific modem subclass.
  *
@@ -63,7 +80,7 @@
         } else if (_statusPin >= 0) {                                          \
             /** If there's a status pin, use that to determine if the modem is \
              * awake. */                                                       \
-            bool levelNow = digitalRead(_statusPin);                           \
+            bool levelNow = _statusIO.read();                                  \
             MS_DBG(getModemName(), F("status pin"), _statusPin, F("level = "), \
                    levelNow ? F("HIGH") : F("LOW"), F("meaning"),              \
                    getModemName(), F("should be"),                             \
@@ -127,6 +144,9 @@
             }                                                                  \
         }                                                                      \
                                                                                \
+        /** Find the modem's baud rate and raise it, if negotiating. */        \
+        negotiateBaud();                                                       \
+                                                                               \
         uint8_t resets  = 0;                                                   \
         bool    success = false;                                               \
         while (!success && resets < 2) {                                       \
@@ -169,6 +189,7 @@
                                                                                \
         if (success) {                                                         \
             modemLEDOn();                                                      \
+            if (_powerState < powerAwake) setPowerState(powerAwake);           \
             MS_DBG(getModemName(), F("should be awake and ready to go."));     \
         } else {                                                               \
             MS_DBG(getModemName(), F("failed to wake!"));                      \
@@ -198,6 +219,23 @@
         return gsmModem.isGprsConnected();            \
     }
 
+/**
+ * @brief Creates an isNetworkRegistered() function for a specific cellular
+ * modem subclass.
+ *
+ * This is a passthrough to isNetworkConnected() for the specific TinyGSM
+ * modem type, which checks the registration once without waiting.
+ *
+ * @param specificModem The modem subclass
+ *
+ * @return The text of an isNetworkRegistered() function specific to a single
+ * modem subclass.
+ */
+#define MS_MODEM_IS_NETWORK_REGISTERED(specificModem) \
+    bool specificModem::isNetworkRegistered(void) {   \
+        return gsmModem.isNetworkConnected();         \
+    }
+
 #ifndef TINY_GSM_MODEM_XBEE
 /**
  * @brief Creates a text string of the functions to call for a specific modem to
@@ -275,10 +313,34 @@
                                                                              \
         if (success) {                                                       \
             MS_START_DEBUG_TIMER                                             \
+            setPowerState(powerConnecting);                                  \
             MS_DBG(F("\nWaiting up to"), maxConnectionTime / 1000,           \
                    F("seconds for cellular network registration..."));       \
-            if (gsmModem.waitForNetwork(maxConnectionTime)) {                \
-                MS_MODEM_SET_APN                                             \
+            bool registered = false;                                         \
+            if (_networkHint.plmn[0] != '\0' &&                              \
+                !gsmModem.isNetworkConnected()) {                            \
+                /** Try the last network before scanning for all of them */  \
+                MS_DBG(F("Trying the last network,"), _networkHint.plmn,     \
+                       F("first..."));                                       \
+                uint32_t pinnedTime = maxConnectionTime <                    \
+                        MS_PINNED_ATTACH_TIME_MS                             \
+                    ? maxConnectionTime                                      \
+                    : MS_PINNED_ATTACH_TIME_MS;                              \
+                registered = pinNetworkFxn(&_networkHint) &&                 \
+                    gsmModem.waitForNetwork(pinnedTime);                     \
+                if (!registered) {                                           \
+                    MS_DBG(F("... not found; scanning all networks..."));    \
+                    pinNetworkFxn(nullptr);                                  \
+                }                                                            \
+            }                                                                \
+            if (registered || gsmModem.waitForNetwork(maxConnectionTime)) {  \
+                updateNetworkHint();                                         \
+                if (_powerSaving && isInternetAvailable()) {                 \
+                    /** The PDP context was kept through PSM */              \
+                    MS_DBG(F("... Data connection kept while asleep."));     \
+                } else {                                                     \
+                    MS_MODEM_SET_APN                                         \
+                }                                                            \
                 MS_DBG(F("... Connected after"), MS_PRINT_DEBUG_TIMER,       \
                        F("milliseconds."));                                  \
                 success = true;                                              \
@@ -287,6 +349,9 @@
                 success = false;                                             \
             }                                                                \
         }                                                                    \
+        if (_powerState == powerConnecting) {                                \
+            setPowerState(success ? powerConnected : powerAwake);            \
+        }                                                                    \
         if (!wasPowered) {                                                   \
             MS_DBG(F("Modem was powered to connect to the internet!  "       \
                      "Remember to turn it off when you're done."));          \
@@ -311,12 +376,45 @@
  * @return The text of a disconnectInternet() function specific to a single
  * modem subclass.
  */
-#define MS_MODEM_DISCONNECT_INTERNET(specificModem)           \
-    void specificModem::disconnectInternet(void) {            \
-        MS_START_DEBUG_TIMER;                                 \
-        gsmModem.gprsDisconnect();                            \
-        MS_DBG(F("Disconnected from cellular network after"), \
-               MS_PRINT_DEBUG_TIMER, F("milliseconds."));     \
+#define MS_MODEM_DISCONNECT_INTERNET(specificModem)              \
+    void specificModem::disconnectInternet(void) {               \
+        MS_START_DEBUG_TIMER;                                    \
+        gsmModem.gprsDisconnect();                               \
+        if (_powerState > powerAwake) setPowerState(powerAwake); \
+        MS_DBG(F("Disconnected from cellular network after"),    \
+               MS_PRINT_DEBUG_TIMER, F("milliseconds."));        \
+    }
+
+/**
+ * @brief Creates a setPowerSavingFxn() function for a specific modem subclass.
+ *
+ * This requests the 3GPP power saving mode timers with AT+CPSMS and, if an
+ * eDRX cycle was given, the LTE-M eDRX cycle with AT+CEDRXS.
+ *
+ * @param specificModem The modem subclass
+ *
+ * @return The text of a setPowerSavingFxn() function specific to a single
+ * modem subclass.
+ */
+#define MS_MODEM_SET_POWER_SAVING(specificModem)                           \
+    bool specificModem::setPowerSavingFxn(void) {                          \
+        char tauBits[9];                                                   \
+        char activeBits[9];                                                \
+        encodePSMTimer(_psmTAU_s, false, tauBits);                         \
+        encodePSMTimer(_psmActive_s, true, activeBits);                    \
+        MS_DBG(F("Requesting a periodic TAU of"), tauBits,                 \
+               F("and an active time of"), activeBits);                    \
+        gsmModem.sendAT(GF("+CPSMS=1,,,\""), tauBits, GF("\",\""),         \
+                        activeBits, '"');                                  \
+        bool success = gsmModem.waitResponse() == 1;                       \
+        if (success && _eDRX_s > 0) {                                      \
+            char eDRXBits[5];                                              \
+            encodeEDRXCycle(_eDRX_s, eDRXBits);                            \
+            MS_DBG(F("Requesting an eDRX cycle of"), eDRXBits);            \
+            gsmModem.sendAT(GF("+CEDRXS=1,4,\""), eDRXBits, '"');          \
+            success &= gsmModem.waitResponse() == 1;                       \
+        }                                                                  \
+        return success;                                                    \
     }
 
 #else  // from #if defined TINY_GSM_MODEM_HAS_GPRS (ie, this is wifi)
@@ -389,22 +487,45 @@
                                                                              \
         if (success) {                                                       \
             MS_START_DEBUG_TIMER                                             \
+            setPowerState(powerConnecting);                                  \
             MS_DBG(F("\nAttempting to connect to WiFi network..."));         \
             if (!(gsmModem.isNetworkConnected())) {                          \
-                MS_DBG(F("Sending credentials..."));                         \
-                for (uint8_t i = 0; i < 5; i++) {                            \
-                    if (gsmModem.networkConnect(_ssid, _pwd)) { break; }     \
+                bool joined = false;                                         \
+                if (_networkHint.channel != 0) {                             \
+                    /** Rejoin the last access point without a scan */       \
+                    MS_DBG(F("Rejoining the last access point..."));         \
+                    uint32_t pinnedTime = maxConnectionTime <                \
+                            MS_PINNED_ATTACH_TIME_MS                         \
+                        ? maxConnectionTime                                  \
+                        : MS_PINNED_ATTACH_TIME_MS;                          \
+                    joined = pinNetworkFxn(&_networkHint) &&                 \
+                        gsmModem.waitForNetwork(pinnedTime);                 \
+                    if (!joined) {                                           \
+                        MS_DBG(F("... not found; scanning for it..."));      \
+                        pinNetworkFxn(nullptr);                              \
+                    }                                                        \
                 }                                                            \
-                MS_DBG(F("Waiting up to"), maxConnectionTime / 1000,         \
-                       F("seconds for connection"));                         \
-                if (!gsmModem.waitForNetwork(maxConnectionTime)) {           \
-                    MS_DBG(F("... WiFi connection failed"));                 \
-                    return false;                                            \
+                if (!joined) {                                               \
+                    MS_DBG(F("Sending credentials..."));                     \
+                    for (uint8_t i = 0; i < 5; i++) {                        \
+                        if (gsmModem.networkConnect(_ssid, _pwd)) { break; } \
+                    }                                                        \
+                    MS_DBG(F("Waiting up to"), maxConnectionTime / 1000,     \
+                           F("seconds for connection"));                     \
+                    if (!gsmModem.waitForNetwork(maxConnectionTime)) {       \
+                        MS_DBG(F("... WiFi connection failed"));             \
+                        setPowerState(powerAwake);                           \
+                        return false;                                        \
+                    }                                                        \
                 }                                                            \
             }                                                                \
+            updateNetworkHint();                                             \
             MS_DBG(F("... WiFi connected after"), MS_PRINT_DEBUG_TIMER,      \
                    F("milliseconds!"));                                      \
         }                                                                    \
+        if (_powerState == powerConnecting) {                                \
+            setPowerState(success ? powerConnected : powerAwake);            \
+        }                                                                    \
         if (!wasPowered) {                                                   \
             MS_DBG(F("Modem was powered to connect to the internet!  "       \
                      "Remember to turn it off when you're done."));          \
@@ -429,16 +550,69 @@
  * @return The text of a disconnectInternet() function specific to a single
  * modem subclass.
  */
-#define MS_MODEM_DISCONNECT_INTERNET(specificModem)       \
-    void specificModem::disconnectInternet(void) {        \
-        MS_START_DEBUG_TIMER;                             \
-        gsmModem.networkDisconnect();                     \
-        MS_DBG(F("Disconnected from WiFi network after"), \
-               MS_PRINT_DEBUG_TIMER, F("milliseconds.")); \
+#define MS_MODEM_DISCONNECT_INTERNET(specificModem)              \
+    void specificModem::disconnectInternet(void) {               \
+        MS_START_DEBUG_TIMER;                                    \
+        gsmModem.networkDisconnect();                            \
+        if (_powerState > powerAwake) setPowerState(powerAwake); \
+        MS_DBG(F("Disconnected from WiFi network after"),        \
+               MS_PRINT_DEBUG_TIMER, F("milliseconds."));        \
     }
 #endif  // #if defined TINY_GSM_MODEM_HAS_GPRS
 
 
+/**
+ * @brief Creates the setBaudFxn(), testATFxn() and setFlowControlFxn()
+ * functions for a specific modem subclass.
+ *
+ * These use the V.250 commands AT+IPR to set the baud rate and AT+IFC to
+ * turn on RTS/CTS flow control, which most cellular modules support.
+ *
+ * @param specificModem The modem subclass
+ *
+ * @return The text of the baud rate functions specific to a single modem
+ * subclass.
+ */
+#define MS_MODEM_SET_BAUD(specificModem)                 \
+    bool specificModem::setBaudFxn(uint32_t baud) {      \
+        gsmModem.sendAT(GF("+IPR="), baud);              \
+        return gsmModem.waitResponse() == 1;             \
+    }                                                    \
+    bool specificModem::testATFxn(uint32_t timeout_ms) { \
+        return gsmModem.testAT(timeout_ms);              \
+    }                                                    \
+    bool specificModem::setFlowControlFxn(void) {        \
+        gsmModem.sendAT(GF("+IFC=2,2"));                 \
+        return gsmModem.waitResponse() == 1;             \
+    }
+
+
+/**
+ * @brief Creates a getMuxClient() function for a specific modem subclass.
+ *
+ * The modem's default gsmClient uses socket 0, so the extra sockets start at
+ * 1.  The subclass must have a #MS_MODEM_MUX_CLIENTS long array of
+ * TinyGsmClient pointers named _muxClients.
+ *
+ * @param specificModem The modem subclass
+ *
+ * @return The text of a getMuxClient() function specific to a single modem
+ * subclass.
+ */
+#define MS_MODEM_GET_MUX_CLIENT(specificModem)                             \
+    Client* specificModem::getMuxClient(uint8_t socketNum) {              \
+        if (socketNum >= MS_MODEM_MUX_CLIENTS ||                          \
+            socketNum + 1 >= TINY_GSM_MUX_COUNT) {                        \
+            return nullptr;                                               \
+        }                                                                 \
+        if (_muxClients[socketNum] == nullptr) {                          \
+            _muxClients[socketNum] = new TinyGsmClient(gsmModem,          \
+                                                       socketNum + 1);    \
+        }                                                                 \
+        return _muxClients[socketNum];                                    \
+    }
+
+
 /**
  * @brief Creates a getNISTTime() function for a specific modem subclass.
  *
@@ -499,6 +673,28 @@
         return 0;                                                             \
     }
 
+/**
+ * @brief Creates a getNITZTime() function for a specific modem subclass.
+ *
+ * This reads the modem's clock with AT+CCLK.  The clock is only valid once the
+ * network has set it with a NITZ message; until then most modems report a
+ * default date that is rejected.
+ *
+ * @param specificModem The modem subclass
+ *
+ * @return The text of a getNITZTime() function specific to a single modem
+ * subclass.
+ */
+#define MS_MODEM_GET_NITZ_TIME(specificModem)                     \
+    uint32_t specificModem::getNITZTime(void) {                   \
+        gsmModem.sendAT(GF("+CCLK?"));                            \
+        if (gsmModem.waitResponse(GF("+CCLK: ")) != 1) return 0;  \
+        String response = gsmModem.stream.readStringUntil('\n');  \
+        gsmModem.waitResponse();                                  \
+        MS_DBG(F("Modem clock:"), response);                      \
+        return parseModemClock(response);                         \
+    }
+
 #if defined(TINY_GSM_MODEM_XBEE) || defined(TINY_GSM_MODEM_ESP8266)
 /**
  * @brief Creates a text string of the functions to convert the signal quality
@@ -0,0 +1,118 @@
+/**
+ * @file NodeLinkModem.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the NodeLinkModem class.
+ */
+
+// Included Dependencies
+#include "NodeLinkModem.h"
+
+
+// Constructor
+NodeLinkModem::NodeLinkModem(NodeLink* link, int8_t powerPin, int8_t statusPin,
+                             int8_t modemSleepRqPin, bool wakeLevel)
+    : loggerModem(powerPin, statusPin, NODE_LINK_STATUS_LEVEL, -1,
+                  NODE_LINK_RESET_LEVEL, NODE_LINK_RESET_PULSE_MS,
+                  modemSleepRqPin, wakeLevel, NODE_LINK_WAKE_PULSE_MS,
+                  NODE_LINK_STATUS_TIME_MS, NODE_LINK_DISCONNECT_TIME_MS,
+                  NODE_LINK_WAKE_DELAY_MS, NODE_LINK_ATRESPONSE_TIME_MS),
+      _link(link) {
+    _modemName = F("Node Link Radio");
+}
+
+// Destructor
+NodeLinkModem::~NodeLinkModem() {}
+
+
+// The radio answers no commands, so it's ready once it has warmed up
+bool NodeLinkModem::modemWake(void) {
+    if (_millisPowerOn == 0) modemPowerUp();
+    // The modem calls wake before the first setup, so set the pin modes here
+    setModemPinModes();
+    if (!isModemAwake()) {
+        MS_DBG(F("Running wake function for"), getModemName());
+        modemWakeFxn();
+    }
+    while (millis() - _millisPowerOn < _wakeDelayTime_ms) {
+        // wait
+    }
+    if (!_hasBeenSetup) modemSetup();
+    // Clear out anything the radio heard while it was asleep
+    Stream* stream = _link->getStream();
+    while (stream != nullptr && stream->available() > 0) stream->read();
+    modemLEDOn();
+    if (_powerState < powerAwake) setPowerState(powerAwake);
+    return true;
+}
+
+
+bool NodeLinkModem::connectInternet(uint32_t maxConnectionTime) {
+    (void)maxConnectionTime;
+    setPowerState(powerConnected);
+    return true;
+}
+void NodeLinkModem::disconnectInternet(void) {
+    if (_powerState > powerAwake) setPowerState(powerAwake);
+}
+bool NodeLinkModem::isInternetAvailable(void) {
+    return true;
+}
+
+
+uint32_t NodeLinkModem::getNISTTime(void) {
+    return _link->getLinkTime();
+}
+
+
+// The radio has no readings to give
+bool NodeLinkModem::getModemSignalQuality(int16_t& rssi, int16_t& percent) {
+    rssi    = -9999;
+    percent = -9999;
+    return false;
+}
+bool NodeLinkModem::getModemBatteryStats(uint8_t& chargeState, int8_t& percent,
+                                         uint16_t& milliVolts) {
+    chargeState = 99;
+    percent     = -99;
+    milliVolts  = 9999;
+    return false;
+}
+float NodeLinkModem::getModemChipTemperature(void) {
+    return -9999;
+}
+
+
+// The sleep request pin is held at its wake level to keep the radio awake
+bool NodeLinkModem::modemWakeFxn(void) {
+    if (_modemSleepRqPin >= 0) {
+        MS_DBG(F("Setting pin"), _modemSleepRqPin,
+               _wakeLevel ? F("HIGH") : F("LOW"), F("to wake"), _modemName);
+        _modemSleepRqIO.write(_wakeLevel);
+    }
+    return true;
+}
+bool NodeLinkModem::modemSleepFxn(void) {
+    if (_modemSleepRqPin >= 0) {
+        MS_DBG(F("Setting pin"), _modemSleepRqPin,
+               !_wakeLevel ? F("HIGH") : F("LOW"), F("to put"), _modemName,
+               F("to sleep"));
+        _modemSleepRqIO.write(!_wakeLevel);
+    }
+    return true;
+}
+bool NodeLinkModem::extraModemSetup(void) {
+    return true;
+}
+
+
+// Without a status pin, the radio is awake whenever it's powered and its
+// sleep request pin is at the wake level
+bool NodeLinkModem::isModemAwake(void) {
+    if (_statusPin >= 0) return _statusIO.read() == _statusLevel;
+    if (_powerPin >= 0 && _millisPowerOn == 0) return false;
+    if (_modemSleepRqPin >= 0) return _powerState >= powerAwake;
+    return true;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file NodeLinkModem.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the NodeLinkModem subclass of loggerModem for the local
+ * radio of a node logger sending its records to a gateway logger.
+ */
+/* clang-format off */
+/**
+ * @defgroup modem_node_link Node Link Radio
+ *
+ * @ingroup the_modems
+ *
+ * @tableofcontents
+ * @m_footernavigation
+ *
+ * @section modem_node_link_notes Introduction
+ *
+ * Several loggers within radio range of each other can share one cellular
+ * uplink.  Each node logger sends its records over a local radio - an XBee
+ * 900 or a LoRa module in transparent serial mode - to a gateway logger with
+ * a NodeLinkPublisher.  The gateway takes each node's values into its own
+ * records with a NodeRelay sensor and sends them on with its publishers and
+ * its one cellular modem.
+ *
+ * This modem only powers and wakes the radio and gives the logger its clock
+ * from the gateway.  There is no Internet connection to make, and the radio
+ * has no signal, battery, or temperature readings to report.  Configure the
+ * radio's own network, like the DigiMesh network ID or the LoRa frequency and
+ * spreading factor, ahead of time.
+ *
+ * @section modem_node_link_example Example Code
+ * @code{cpp}
+ * NodeLink          radioLink(&Serial1);
+ * NodeLinkModem     radio(&radioLink, radioPowerPin, -1, radioSleepRqPin);
+ * NodeLinkPublisher toGateway(dataLogger, &radioLink, nodeID);
+ * // ...
+ * dataLogger.attachModem(radio);
+ * @endcode
+ */
+/* clang-format on */
+
+// Header Guards
+#ifndef SRC_MODEMS_NODELINKMODEM_H_
+#define SRC_MODEMS_NODELINKMODEM_H_
+
+// Debugging Statement
+// #define MS_NODELINKMODEM_DEBUG
+
+#ifdef MS_NODELINKMODEM_DEBUG
+#define MS_DEBUGGING_STD "NodeLinkModem"
+#endif
+
+/** @ingroup modem_node_link */
+/**@{*/
+
+/**
+ * @brief The loggerModem::_statusTime_ms.
+ * The radio's status pin, if there is one, is read as soon as it is awake.
+ */
+#define NODE_LINK_STATUS_TIME_MS 15
+/**
+ * @brief The loggerModem::_statusLevel.
+ */
+#define NODE_LINK_STATUS_LEVEL HIGH
+/**
+ * @brief The loggerModem::_resetLevel.
+ * The radio is not reset by the logger.
+ */
+#define NODE_LINK_RESET_LEVEL LOW
+/**
+ * @brief The loggerModem::_resetPulse_ms.
+ */
+#define NODE_LINK_RESET_PULSE_MS 0
+/**
+ * @brief The loggerModem::_wakePulse_ms.
+ * The sleep request pin is held at the wake level, as for an XBee.
+ */
+#define NODE_LINK_WAKE_PULSE_MS 0
+/**
+ * @brief The loggerModem::_wakeDelayTime_ms.
+ * An XBee 900HP or a LoRa module is ready to send within about 100 ms of being
+ * powered or woken.
+ */
+#define NODE_LINK_WAKE_DELAY_MS 100
+/**
+ * @brief The loggerModem::_max_atresponse_time_ms.
+ * The radio is never sent AT commands.
+ */
+#define NODE_LINK_ATRESPONSE_TIME_MS 0
+/**
+ * @brief The loggerModem::_disconnetTime_ms.
+ */
+#define NODE_LINK_DISCONNECT_TIME_MS 50
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "LoggerModem.h"
+#include "NodeLink.h"
+
+
+/**
+ * @brief The loggerModem subclass for the [local radio](@ref modem_node_link)
+ * of a node logger.
+ */
+class NodeLinkModem : public loggerModem {
+ public:
+    /**
+     * @brief Construct a new node link modem object
+     *
+     * @param link The node link run over the radio
+     * @param powerPin @copydoc loggerModem::_powerPin
+     * @param statusPin @copydoc loggerModem::_statusPin
+     * This is the pin the radio sets to HIGH when it is awake.
+     * @param modemSleepRqPin @copydoc loggerModem::_modemSleepRqPin
+     * @param wakeLevel The level of the sleep request pin that keeps the
+     * radio awake; LOW for an XBee.  Default is LOW.
+     */
+    NodeLinkModem(NodeLink* link, int8_t powerPin, int8_t statusPin = -1,
+                  int8_t modemSleepRqPin = -1, bool wakeLevel = LOW);
+    /**
+     * @brief Destroy the node link modem object - no action taken
+     */
+    ~NodeLinkModem();
+
+    bool modemWake(void) override;
+
+    /**
+     * @brief There is no connection to make over the local radio.
+     *
+     * @param maxConnectionTime Unused
+     * @return **bool** True
+     */
+    bool connectInternet(uint32_t maxConnectionTime = 50000L) override;
+    void disconnectInternet(void) override;
+
+    /**
+     * @brief Get the gateway's clock from the last record it acknowledged.
+     *
+     * @return **uint32_t** The current UTC epoch time by the gateway's clock,
+     * or 0 if no acknowledgement has given it
+     */
+    uint32_t getNISTTime(void) override;
+
+    bool  getModemSignalQuality(int16_t& rssi, int16_t& percent) override;
+    bool  getModemBatteryStats(uint8_t& chargeState, int8_t& percent,
+                               uint16_t& milliVolts) override;
+    float getModemChipTemperature(void) override;
+
+ protected:
+    bool isInternetAvailable(void) override;
+    bool modemSleepFxn(void) override;
+    bool modemWakeFxn(void) override;
+    bool extraModemSetup(void) override;
+    bool isModemAwake(void) override;
+
+ private:
+    NodeLink* _link;
+};
+/**@}*/
+#endif  // SRC_MODEMS_NODELINKMODEM_H_
@@ -24,7 +24,7 @@ QuectelBG96::QuectelBG96(Stream* modemStream, int8_t powerPin, int8_t statusPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -39,9 +39,174 @@ MS_MODEM_WAKE(QuectelBG96);
 
 MS_MODEM_CONNECT_INTERNET(QuectelBG96);
 MS_MODEM_DISCONNECT_INTERNET(QuectelBG96);
+MS_MODEM_SET_POWER_SAVING(QuectelBG96);
 MS_MODEM_IS_INTERNET_AVAILABLE(QuectelBG96);
+MS_MODEM_IS_NETWORK_REGISTERED(QuectelBG96);
+MS_MODEM_SET_BAUD(QuectelBG96);
 
 MS_MODEM_GET_NIST_TIME(QuectelBG96);
+MS_MODEM_GET_NITZ_TIME(QuectelBG96);
+
+// The time comes back as "+QNTP: 0,"yyyy/MM/dd,hh:mm:ss±zz""
+uint32_t QuectelBG96::getSNTPTime(void) {
+    gsmModem.sendAT(GF("+QNTP=1,\""), MS_SNTP_SERVER, GF("\",123"));
+    if (gsmModem.waitResponse() != 1) return 0;
+    if (gsmModem.waitResponse(15000L, GF("+QNTP: ")) != 1) return 0;
+    String response = gsmModem.stream.readStringUntil('\n');
+    MS_DBG(F("NTP response:"), response);
+    if (!response.startsWith("0,")) return 0;
+    return parseModemClock(response);
+}
+MS_MODEM_GET_MUX_CLIENT(QuectelBG96);
+
+// After the OK come a "+QIURC: "dnsgip",<err>,<count>,<ttl>" line and then
+// one "+QIURC: "dnsgip",<ip>" line per address
+bool QuectelBG96::lookupHostIP(const char* host, IPAddress& ip) {
+    gsmModem.sendAT(GF("+QIDNSGIP=1,\""), host, '"');
+    if (gsmModem.waitResponse() != 1) return false;
+    if (gsmModem.waitResponse(12000L, GF("+QIURC: \"dnsgip\",")) != 1) {
+        return false;
+    }
+    String status = gsmModem.stream.readStringUntil('\n');
+    if (!status.startsWith("0,")) return false;
+    if (gsmModem.waitResponse(2000L, GF("+QIURC: \"dnsgip\",")) != 1) {
+        return false;
+    }
+    String response = gsmModem.stream.readStringUntil('\n');
+    MS_DBG(F("Looked up"), host, F("as"), response);
+    return parseQuotedIP(response, ip);
+}
+
+// With "requestheader" on, the whole request is sent as it is; the URL only
+// gives the host.  The result comes after the OK as
+// "+QHTTPPOST: <err>,<code>,<length>"
+int16_t QuectelBG96::nativeHttpRequest(const char* host, uint16_t port,
+                                       bool useTls, const char* head,
+                                       size_t headLen, const char* body,
+                                       size_t bodyLen) {
+    bool isGet = strncmp(head, "GET ", 4) == 0;
+    if (!isGet && strncmp(head, "POST ", 5) != 0) return 0;
+
+    gsmModem.sendAT(GF("+QHTTPCFG=\"contextid\",1"));
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+QHTTPCFG=\"requestheader\",1"));
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+QHTTPCFG=\"responseheader\",0"));
+    gsmModem.waitResponse();
+    if (useTls) {
+        gsmModem.sendAT(GF("+QHTTPCFG=\"sslctxid\",1"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QSSLCFG=\"sslversion\",1,4"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QSSLCFG=\"seclevel\",1,0"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QSSLCFG=\"sni\",1,1"));
+        gsmModem.waitResponse();
+    }
+    String url = String(useTls ? "https://" : "http://") + host + ':' + port;
+    gsmModem.sendAT(GF("+QHTTPURL="), url.length(), GF(",10"));
+    if (gsmModem.waitResponse(10000L, GF("CONNECT")) != 1) return 0;
+    gsmModem.stream.print(url);
+    if (gsmModem.waitResponse(10000L) != 1) return 0;
+
+    if (isGet) {
+        gsmModem.sendAT(GF("+QHTTPGET=60,"), headLen + bodyLen);
+    } else {
+        gsmModem.sendAT(GF("+QHTTPPOST="), headLen + bodyLen, GF(",60,60"));
+    }
+    if (gsmModem.waitResponse(60000L, GF("CONNECT")) != 1) return 0;
+    gsmModem.stream.write(reinterpret_cast<const uint8_t*>(head), headLen);
+    gsmModem.stream.write(reinterpret_cast<const uint8_t*>(body), bodyLen);
+    gsmModem.stream.flush();
+
+    // Once the request is sent, a failure can't be sent again
+    int16_t responseCode = 504;
+    if (gsmModem.waitResponse(60000L) == 1 &&
+        gsmModem.waitResponse(60000L, isGet ? GF("+QHTTPGET: ")
+                                            : GF("+QHTTPPOST: ")) == 1) {
+        String response = gsmModem.stream.readStringUntil('\n');
+        MS_DBG(F("HTTP response:"), response);
+        if (response.startsWith("0,")) {
+            responseCode = response.substring(2).toInt();
+        }
+    }
+    return responseCode;
+}
+
+// The network comes back as
+// "+QNWINFO: "CAT-M1","310410","LTE BAND 12",5110"
+bool QuectelBG96::readNetworkHint(networkHint& hint) {
+    gsmModem.sendAT(GF("+QNWINFO"));
+    if (gsmModem.waitResponse(GF("+QNWINFO: ")) != 1) return false;
+    String response = gsmModem.stream.readStringUntil('\n');
+    gsmModem.waitResponse();
+
+    if (response.startsWith("\"CAT-M1\"")) {
+        hint.rat = ratCatM;
+    } else if (response.startsWith("\"CAT-NB1\"")) {
+        hint.rat = ratNBIoT;
+    } else if (response.startsWith("\"GSM\"") ||
+               response.startsWith("\"GPRS\"") ||
+               response.startsWith("\"EDGE\"")) {
+        hint.rat = ratGSM;
+    } else {
+        return false;
+    }
+    // The operator is the second quoted field
+    int    start = response.indexOf('"', response.indexOf(',')) + 1;
+    String plmn  = response.substring(start, response.indexOf('"', start));
+    if (start <= 0 || plmn.length() < 5 || plmn.length() > 6) return false;
+    strcpy(hint.plmn, plmn.c_str());
+    int band  = response.indexOf("BAND ");
+    hint.band = band >= 0 ? response.substring(band + 5).toInt() : 0;
+    return true;
+}
+
+
+bool QuectelBG96::pinNetworkFxn(const networkHint* hint) {
+    if (hint == nullptr) {
+        MS_DBG(F("Returning to automatic network selection"));
+        gsmModem.sendAT(GF("+QCFG=\"nwscanmode\",0,1"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QCFG=\"iotopmode\",2,1"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QCFG=\"band\",F,400A0E189F,A0E189F,1"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+COPS=0"));
+        return gsmModem.waitResponse() == 1;
+    }
+    if (hint->rat == ratUnknown) return false;
+
+    MS_DBG(F("Pinning to"), hint->plmn, F("on band"), hint->band);
+    if (hint->rat == ratGSM) {
+        gsmModem.sendAT(GF("+QCFG=\"nwscanmode\",1,1"));
+        gsmModem.waitResponse();
+    } else {
+        gsmModem.sendAT(GF("+QCFG=\"nwscanmode\",3,1"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+QCFG=\"iotopmode\","),
+                        hint->rat == ratCatM ? 0 : 1, GF(",1"));
+        gsmModem.waitResponse();
+        if (hint->band > 0 && hint->band <= 76) {
+            // The band mask is in hex, with bit 0 for band 1; a 0 leaves the
+            // mask for the other technology as it is
+            char    mask[21];
+            uint8_t zeros = (hint->band - 1) / 4;
+            mask[0]       = '0' + (1 << ((hint->band - 1) % 4));
+            memset(mask + 1, '0', zeros);
+            mask[zeros + 1] = '\0';
+            gsmModem.sendAT(GF("+QCFG=\"band\",0,"),
+                            hint->rat == ratCatM ? mask : "0", ',',
+                            hint->rat == ratCatM ? "0" : mask, GF(",1"));
+            gsmModem.waitResponse();
+        }
+    }
+    // The access technology for manual selection: 0 GSM, 8 Cat-M1, 9 NB-IoT
+    uint8_t act = hint->rat == ratGSM ? 0 : (hint->rat == ratCatM ? 8 : 9);
+    // Manual selection returns once the modem has tried to register
+    gsmModem.sendAT(GF("+COPS=1,2,\""), hint->plmn, GF("\","), act);
+    return gsmModem.waitResponse(MS_PINNED_ATTACH_TIME_MS) == 1;
+}
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(QuectelBG96);
 MS_MODEM_GET_MODEM_BATTERY_DATA(QuectelBG96);
@@ -55,9 +220,11 @@ bool QuectelBG96::modemWakeFxn(void) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         delay(_wakePulse_ms);  // ≥100ms
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
+        // Waking from PSM is not a reboot, so there's no ready message
+        if (_powerSaving) return true;
         return gsmModem.waitResponse(10000L, GF("RDY")) == 1;
     }
     return true;
@@ -75,7 +242,7 @@ bool QuectelBG96::modemSleepFxn(void) {
 }
 
 bool QuectelBG96::modemHardReset(void) {
-    digitalWrite(_modemSleepRqPin, !_wakeLevel);  // set the wake pin high
+    _modemSleepRqIO.write(!_wakeLevel);  // set the wake pin high
     bool success = loggerModem::modemHardReset();
     if (success) { return gsmModem.waitResponse(10000L, GF("RDY")) == 1; }
     return false;
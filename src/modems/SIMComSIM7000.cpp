@@ -24,7 +24,7 @@ SIMComSIM7000::SIMComSIM7000(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -40,8 +40,133 @@ MS_MODEM_WAKE(SIMComSIM7000);
 MS_MODEM_CONNECT_INTERNET(SIMComSIM7000);
 MS_MODEM_DISCONNECT_INTERNET(SIMComSIM7000);
 MS_MODEM_IS_INTERNET_AVAILABLE(SIMComSIM7000);
+MS_MODEM_IS_NETWORK_REGISTERED(SIMComSIM7000);
+MS_MODEM_SET_BAUD(SIMComSIM7000);
 
 MS_MODEM_GET_NIST_TIME(SIMComSIM7000);
+MS_MODEM_GET_NITZ_TIME(SIMComSIM7000);
+
+// The NTP client sets the modem clock, in UTC, which is then read back
+uint32_t SIMComSIM7000::getSNTPTime(void) {
+    gsmModem.sendAT(GF("+CNTP=\""), MS_SNTP_SERVER, GF("\",0"));
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+CNTP"));
+    if (gsmModem.waitResponse(10000L, GF("+CNTP: 1")) != 1) {
+        MS_DBG(F("NTP time sync failed"));
+        return 0;
+    }
+    return getNITZTime();
+}
+MS_MODEM_GET_MUX_CLIENT(SIMComSIM7000);
+
+// The address comes after the OK as "+CDNSGIP: 1,<host>,<ip>"
+bool SIMComSIM7000::lookupHostIP(const char* host, IPAddress& ip) {
+    gsmModem.sendAT(GF("+CDNSGIP=\""), host, '"');
+    if (gsmModem.waitResponse() != 1) return false;
+    if (gsmModem.waitResponse(12000L, GF("+CDNSGIP: ")) != 1) return false;
+    String response = gsmModem.stream.readStringUntil('\n');
+    MS_DBG(F("Looked up"), host, F("as"), response);
+    return response.startsWith("1,") && parseQuotedIP(response, ip);
+}
+
+// The HTTP(S) application takes the headers one at a time and the body in
+// one piece, and then reports "+SHREQ: "POST",<code>,<length>"
+int16_t SIMComSIM7000::nativeHttpRequest(const char* host, uint16_t port,
+                                         bool useTls, const char* head,
+                                         size_t headLen, const char* body,
+                                         size_t bodyLen) {
+    // The request line is "<method> <path> HTTP/1.1"
+    size_t pos = 0;
+    String line;
+    if (!readHttpLine(head, headLen, pos, line)) return 0;
+    int     pathStart = line.indexOf(' ') + 1;
+    int     pathEnd   = line.indexOf(' ', pathStart);
+    String  path      = line.substring(pathStart, pathEnd);
+    uint8_t method    = 0;
+    if (line.startsWith("GET ")) method = 1;
+    if (line.startsWith("PUT ")) method = 2;
+    if (line.startsWith("POST ")) method = 3;
+    if (method == 0 || pathStart <= 0 || pathEnd < 0) return 0;
+    // The application holds at most 4096 bytes of body
+    if (bodyLen > 4096) return 0;
+
+    // The HTTP application runs on the app network, not the TCP/IP context
+    gsmModem.sendAT(GF("+CNACT?"));
+    if (gsmModem.waitResponse(GF("+CNACT: 1")) != 1) {
+        gsmModem.sendAT(GF("+CNACT=1,\""), _apn, '"');
+        if (gsmModem.waitResponse() != 1 ||
+            gsmModem.waitResponse(30000L, GF("+APP PDP: ACTIVE")) != 1) {
+            return 0;
+        }
+    } else {
+        gsmModem.waitResponse();
+    }
+    if (useTls) {
+        gsmModem.sendAT(GF("+CSSLCFG=\"sslversion\",1,3"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+CSSLCFG=\"sni\",1,\""), host, '"');
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+SHSSL=1,\"\""));
+        if (gsmModem.waitResponse() != 1) return 0;
+    }
+    gsmModem.sendAT(GF("+SHCONF=\"URL\",\""),
+                    useTls ? GF("https://") : GF("http://"), host, ':', port,
+                    '"');
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+SHCONF=\"BODYLEN\",4096"));
+    gsmModem.waitResponse();
+    gsmModem.sendAT(GF("+SHCONF=\"HEADERLEN\",350"));
+    gsmModem.waitResponse();
+    gsmModem.sendAT(GF("+SHCONN"));
+    if (gsmModem.waitResponse(30000L) != 1) return 0;
+
+    // The modem adds its own host and length headers
+    gsmModem.sendAT(GF("+SHCHEAD"));
+    gsmModem.waitResponse();
+    while (readHttpLine(head, headLen, pos, line)) {
+        int colon = line.indexOf(':');
+        if (colon <= 0) continue;
+        String name  = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        value.trim();
+        if (name.equalsIgnoreCase("Host") ||
+            name.equalsIgnoreCase("Content-Length")) {
+            continue;
+        }
+        gsmModem.sendAT(GF("+SHAHEAD=\""), name, GF("\",\""), value, '"');
+        gsmModem.waitResponse();
+    }
+    bool success = true;
+    if (bodyLen > 0) {
+        gsmModem.sendAT(GF("+SHBOD="), bodyLen, GF(",10000"));
+        success = gsmModem.waitResponse(GF(">")) == 1;
+        if (success) {
+            gsmModem.stream.write(reinterpret_cast<const uint8_t*>(body),
+                                  bodyLen);
+            gsmModem.stream.flush();
+            success = gsmModem.waitResponse(10000L) == 1;
+        }
+    }
+    if (!success) {
+        gsmModem.sendAT(GF("+SHDISC"));
+        gsmModem.waitResponse();
+        return 0;
+    }
+
+    // Once the request is made, a failure can't be sent again
+    int16_t responseCode = 504;
+    gsmModem.sendAT(GF("+SHREQ=\""), path, GF("\","), method);
+    if (gsmModem.waitResponse() == 1 &&
+        gsmModem.waitResponse(60000L, GF("+SHREQ: ")) == 1) {
+        String response = gsmModem.stream.readStringUntil('\n');
+        MS_DBG(F("HTTP response:"), response);
+        int comma = response.indexOf(',');
+        if (comma > 0) responseCode = response.substring(comma + 1).toInt();
+    }
+    gsmModem.sendAT(GF("+SHDISC"));
+    gsmModem.waitResponse();
+    return responseCode;
+}
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SIMComSIM7000);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SIMComSIM7000);
@@ -55,9 +180,9 @@ bool SIMComSIM7000::modemWakeFxn(void) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         delay(_wakePulse_ms);  // >1s
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
     }
     return true;
 }
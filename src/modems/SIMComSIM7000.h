@@ -190,6 +190,12 @@ class SIMComSIM7000 : public loggerModem {
 
     uint32_t getNISTTime(void) override;
 
+    Client* getMuxClient(uint8_t socketNum) override;
+    bool    lookupHostIP(const char* host, IPAddress& ip) override;
+    int16_t nativeHttpRequest(const char* host, uint16_t port, bool useTls,
+                              const char* head, size_t headLen,
+                              const char* body, size_t bodyLen) override;
+
     bool  getModemSignalQuality(int16_t& rssi, int16_t& percent) override;
     bool  getModemBatteryStats(uint8_t& chargeState, int8_t& percent,
                                uint16_t& milliVolts) override;
@@ -209,13 +215,23 @@ class SIMComSIM7000 : public loggerModem {
     TinyGsmClient gsmClient;
 
  protected:
-    bool isInternetAvailable(void) override;
-    bool modemSleepFxn(void) override;
-    bool modemWakeFxn(void) override;
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     isInternetAvailable(void) override;
+    bool     isNetworkRegistered(void) override;
+    bool     setBaudFxn(uint32_t baud) override;
+    bool     testATFxn(uint32_t timeout_ms) override;
+    bool     setFlowControlFxn(void) override;
+    bool     modemSleepFxn(void) override;
+    bool     modemWakeFxn(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    uint32_t getSNTPTime(void) override;
+    bool     isModemAwake(void) override;
 
  private:
+    /**
+     * @brief Clients for the extra sockets used for concurrent publishing
+     */
+    TinyGsmClient* _muxClients[MS_MODEM_MUX_CLIENTS] = {};
     const char* _apn;
 };
 /**@}*/
@@ -24,7 +24,7 @@ SIMComSIM7080::SIMComSIM7080(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -39,9 +39,186 @@ MS_MODEM_WAKE(SIMComSIM7080);
 
 MS_MODEM_CONNECT_INTERNET(SIMComSIM7080);
 MS_MODEM_DISCONNECT_INTERNET(SIMComSIM7080);
+MS_MODEM_SET_POWER_SAVING(SIMComSIM7080);
 MS_MODEM_IS_INTERNET_AVAILABLE(SIMComSIM7080);
+MS_MODEM_IS_NETWORK_REGISTERED(SIMComSIM7080);
+MS_MODEM_SET_BAUD(SIMComSIM7080);
 
 MS_MODEM_GET_NIST_TIME(SIMComSIM7080);
+MS_MODEM_GET_NITZ_TIME(SIMComSIM7080);
+
+// The NTP client sets the modem clock, in UTC, which is then read back
+uint32_t SIMComSIM7080::getSNTPTime(void) {
+    gsmModem.sendAT(GF("+CNTP=\""), MS_SNTP_SERVER, GF("\",0"));
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+CNTP"));
+    if (gsmModem.waitResponse(10000L, GF("+CNTP: 1")) != 1) {
+        MS_DBG(F("NTP time sync failed"));
+        return 0;
+    }
+    return getNITZTime();
+}
+MS_MODEM_GET_MUX_CLIENT(SIMComSIM7080);
+
+// The address comes after the OK as "+CDNSGIP: 1,<host>,<ip>"
+bool SIMComSIM7080::lookupHostIP(const char* host, IPAddress& ip) {
+    gsmModem.sendAT(GF("+CDNSGIP=\""), host, GF("\",1,10000"));
+    if (gsmModem.waitResponse() != 1) return false;
+    if (gsmModem.waitResponse(12000L, GF("+CDNSGIP: ")) != 1) return false;
+    String response = gsmModem.stream.readStringUntil('\n');
+    MS_DBG(F("Looked up"), host, F("as"), response);
+    return response.startsWith("1,") && parseQuotedIP(response, ip);
+}
+
+// The HTTP(S) application takes the headers one at a time and the body in
+// one piece, and then reports "+SHREQ: "POST",<code>,<length>"
+int16_t SIMComSIM7080::nativeHttpRequest(const char* host, uint16_t port,
+                                         bool useTls, const char* head,
+                                         size_t headLen, const char* body,
+                                         size_t bodyLen) {
+    // The request line is "<method> <path> HTTP/1.1"
+    size_t pos = 0;
+    String line;
+    if (!readHttpLine(head, headLen, pos, line)) return 0;
+    int     pathStart = line.indexOf(' ') + 1;
+    int     pathEnd   = line.indexOf(' ', pathStart);
+    String  path      = line.substring(pathStart, pathEnd);
+    uint8_t method    = 0;
+    if (line.startsWith("GET ")) method = 1;
+    if (line.startsWith("PUT ")) method = 2;
+    if (line.startsWith("POST ")) method = 3;
+    if (method == 0 || pathStart <= 0 || pathEnd < 0) return 0;
+    // The application holds at most 4096 bytes of body
+    if (bodyLen > 4096) return 0;
+    if (useTls) {
+        gsmModem.sendAT(GF("+CSSLCFG=\"sslversion\",1,3"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+CSSLCFG=\"sni\",1,\""), host, '"');
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+SHSSL=1,\"\""));
+        if (gsmModem.waitResponse() != 1) return 0;
+    }
+    gsmModem.sendAT(GF("+SHCONF=\"URL\",\""),
+                    useTls ? GF("https://") : GF("http://"), host, ':', port,
+                    '"');
+    if (gsmModem.waitResponse() != 1) return 0;
+    gsmModem.sendAT(GF("+SHCONF=\"BODYLEN\",4096"));
+    gsmModem.waitResponse();
+    gsmModem.sendAT(GF("+SHCONF=\"HEADERLEN\",350"));
+    gsmModem.waitResponse();
+    gsmModem.sendAT(GF("+SHCONN"));
+    if (gsmModem.waitResponse(30000L) != 1) return 0;
+
+    // The modem adds its own host and length headers
+    gsmModem.sendAT(GF("+SHCHEAD"));
+    gsmModem.waitResponse();
+    while (readHttpLine(head, headLen, pos, line)) {
+        int colon = line.indexOf(':');
+        if (colon <= 0) continue;
+        String name  = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        value.trim();
+        if (name.equalsIgnoreCase("Host") ||
+            name.equalsIgnoreCase("Content-Length")) {
+            continue;
+        }
+        gsmModem.sendAT(GF("+SHAHEAD=\""), name, GF("\",\""), value, '"');
+        gsmModem.waitResponse();
+    }
+    bool success = true;
+    if (bodyLen > 0) {
+        gsmModem.sendAT(GF("+SHBOD="), bodyLen, GF(",10000"));
+        success = gsmModem.waitResponse(GF(">")) == 1;
+        if (success) {
+            gsmModem.stream.write(reinterpret_cast<const uint8_t*>(body),
+                                  bodyLen);
+            gsmModem.stream.flush();
+            success = gsmModem.waitResponse(10000L) == 1;
+        }
+    }
+    if (!success) {
+        gsmModem.sendAT(GF("+SHDISC"));
+        gsmModem.waitResponse();
+        return 0;
+    }
+
+    // Once the request is made, a failure can't be sent again
+    int16_t responseCode = 504;
+    gsmModem.sendAT(GF("+SHREQ=\""), path, GF("\","), method);
+    if (gsmModem.waitResponse() == 1 &&
+        gsmModem.waitResponse(60000L, GF("+SHREQ: ")) == 1) {
+        String response = gsmModem.stream.readStringUntil('\n');
+        MS_DBG(F("HTTP response:"), response);
+        int comma = response.indexOf(',');
+        if (comma > 0) responseCode = response.substring(comma + 1).toInt();
+    }
+    gsmModem.sendAT(GF("+SHDISC"));
+    gsmModem.waitResponse();
+    return responseCode;
+}
+
+// The network comes back as
+// "+CPSI: LTE CAT-M1,Online,310-410,0x4804,...,EUTRAN-BAND12,..."
+bool SIMComSIM7080::readNetworkHint(networkHint& hint) {
+    gsmModem.sendAT(GF("+CPSI?"));
+    if (gsmModem.waitResponse(GF("+CPSI: ")) != 1) return false;
+    String response = gsmModem.stream.readStringUntil('\n');
+    gsmModem.waitResponse();
+
+    if (response.startsWith("LTE CAT-M1")) {
+        hint.rat = ratCatM;
+    } else if (response.startsWith("LTE NB-IOT")) {
+        hint.rat = ratNBIoT;
+    } else {
+        return false;
+    }
+    // The operator is the third field, with a dash between the MCC and MNC
+    int    start = response.indexOf(',', response.indexOf(',') + 1) + 1;
+    String plmn  = response.substring(start, response.indexOf(',', start));
+    plmn.replace("-", "");
+    if (start <= 0 || plmn.length() < 5 || plmn.length() > 6) return false;
+    strcpy(hint.plmn, plmn.c_str());
+    int band  = response.indexOf("BAND");
+    hint.band = band >= 0 ? response.substring(band + 4).toInt() : 0;
+    return true;
+}
+
+
+// The SIM7080 only has LTE Cat-M1 and NB-IoT
+bool SIMComSIM7080::pinNetworkFxn(const networkHint* hint) {
+    if (hint == nullptr) {
+        MS_DBG(F("Returning to automatic network selection"));
+        gsmModem.sendAT(GF("+CNMP=2"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+CMNB=3"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+CBANDCFG=\"CAT-M\",1,2,3,4,5,8,12,13,14,18,19,20,"
+                           "25,26,27,28,66,85"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+CBANDCFG=\"NB-IOT\",1,2,3,4,5,8,12,13,18,19,20,"
+                           "25,26,28,66,71,85"));
+        gsmModem.waitResponse();
+        gsmModem.sendAT(GF("+COPS=0"));
+        return gsmModem.waitResponse() == 1;
+    }
+    if (hint->rat != ratCatM && hint->rat != ratNBIoT) return false;
+
+    MS_DBG(F("Pinning to"), hint->plmn, F("on band"), hint->band);
+    gsmModem.sendAT(GF("+CNMP=38"));
+    gsmModem.waitResponse();
+    gsmModem.sendAT(GF("+CMNB="), hint->rat == ratCatM ? 1 : 2);
+    gsmModem.waitResponse();
+    if (hint->band > 0) {
+        gsmModem.sendAT(GF("+CBANDCFG="),
+                        hint->rat == ratCatM ? GF("\"CAT-M\",")
+                                             : GF("\"NB-IOT\","),
+                        hint->band);
+        gsmModem.waitResponse();
+    }
+    // Manual selection returns once the modem has tried to register
+    gsmModem.sendAT(GF("+COPS=1,2,\""), hint->plmn, '"');
+    return gsmModem.waitResponse(MS_PINNED_ATTACH_TIME_MS) == 1;
+}
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SIMComSIM7080);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SIMComSIM7080);
@@ -55,9 +232,11 @@ bool SIMComSIM7080::modemWakeFxn(void) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         delay(_wakePulse_ms);  // >1s
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
+        // Waking from PSM is not a reboot, so there's no ready message
+        if (_powerSaving) return true;
         return gsmModem.waitResponse(30000L, GF("SMS Ready")) == 1;
     }
     return true;
@@ -24,7 +24,7 @@ SIMComSIM800::SIMComSIM800(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -40,8 +40,11 @@ MS_MODEM_WAKE(SIMComSIM800);
 MS_MODEM_CONNECT_INTERNET(SIMComSIM800);
 MS_MODEM_DISCONNECT_INTERNET(SIMComSIM800);
 MS_MODEM_IS_INTERNET_AVAILABLE(SIMComSIM800);
+MS_MODEM_IS_NETWORK_REGISTERED(SIMComSIM800);
+MS_MODEM_SET_BAUD(SIMComSIM800);
 
 MS_MODEM_GET_NIST_TIME(SIMComSIM800);
+MS_MODEM_GET_NITZ_TIME(SIMComSIM800);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SIMComSIM800);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SIMComSIM800);
@@ -50,14 +53,16 @@ MS_MODEM_GET_MODEM_TEMPERATURE_DATA(SIMComSIM800);
 // Create the wake and sleep methods for the modem
 // These can be functions of any type and must return a boolean
 bool SIMComSIM800::modemWakeFxn(void) {
+    // Kept connected, it's still on; a pulse on `PWRKEY` would turn it off
+    if (_powerSaving) return true;
     // Must power on and then pulse on
     if (_modemSleepRqPin >= 0) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for"), _modemName);
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         delay(_wakePulse_ms);  // >1s
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
     }
     return true;
 }
@@ -74,3 +79,68 @@ bool SIMComSIM800::modemSleepFxn(void) {
         return true;
     }
 }
+
+// Kept connected, the SIM800 is let into sleep mode in place of the sleep
+// function
+bool SIMComSIM800::modemSleep(void) {
+    if (_powerSaving) {
+        if (_dtrPin >= 0) {
+            MS_DBG(F("Setting DTR pin"), _dtrPin,
+                   !SIM800_DTR_WAKE_LEVEL ? F("HIGH") : F("LOW"),
+                   F("to let the SIM800 sleep"));
+            digitalWrite(_dtrPin, !SIM800_DTR_WAKE_LEVEL);
+            _inSleepMode = true;
+        } else {
+            MS_DBG(F("Letting the SIM800 sleep once its serial port is idle"));
+            gsmModem.sendAT(GF("+CSCLK=2"));
+            _inSleepMode = gsmModem.waitResponse() == 1;
+        }
+    }
+    return loggerModem::modemSleep();
+}
+
+
+// The sleep mode is checked by the modem setup in place of power saving
+// timers
+void SIMComSIM800::setKeepConnected(bool keepConnected, int8_t dtrPin) {
+    _dtrPin = dtrPin;
+    setPowerSavingMode(keepConnected ? 1 : 0, 0);
+}
+
+
+// With a DTR pin, sleep mode 1 is set once and DTR does the rest; without
+// one, sleep mode 2 is only set as the modem is let sleep, so it can't fall
+// asleep while it's in use
+bool SIMComSIM800::setPowerSavingFxn(void) {
+    if (_dtrPin >= 0) {
+        MS_DBG(F("Letting the SIM800 sleep while DTR is HIGH"));
+        gsmModem.sendAT(GF("+CSCLK=1"));
+    } else {
+        gsmModem.sendAT(GF("+CSCLK=0"));
+    }
+    return gsmModem.waitResponse() == 1;
+}
+
+
+// The wake function isn't run if the status pin shows the SIM800 is on, so
+// the serial port is woken here
+void SIMComSIM800::setModemPinModes(void) {
+    loggerModem::setModemPinModes();
+    if (_dtrPin >= 0) {
+        pinMode(_dtrPin, OUTPUT);
+        digitalWrite(_dtrPin, SIM800_DTR_WAKE_LEVEL);
+    }
+    if (!_inSleepMode) return;
+    _inSleepMode = false;
+    if (_dtrPin >= 0) {
+        MS_DBG(F("Woke SIM800 from sleep mode with DTR pin"), _dtrPin);
+        delay(SIM800_SLEEP_WAKE_MS);
+    } else {
+        // The first character wakes the serial port and is lost
+        MS_DBG(F("Waking SIM800 from sleep mode by its serial port"));
+        gsmModem.sendAT(GF(""));
+        gsmModem.waitResponse(SIM800_SLEEP_WAKE_MS);
+        gsmModem.sendAT(GF("+CSCLK=0"));
+        gsmModem.waitResponse();
+    }
+}
@@ -140,6 +140,19 @@
  * shutdown in case it is not monitored.
  */
 #define SIM800_DISCONNECT_TIME_MS 15000L
+/**
+ * @brief The level of the `DTR` pin that keeps the SIM800 awake when it's
+ * kept connected in sleep mode 1 (`AT+CSCLK=1`).
+ *
+ * The SIM800 enters sleep mode once `DTR` is held `HIGH` and it's idle.  When
+ * `DTR` is pulled `LOW`, the serial port answers again after 50ms.
+ */
+#define SIM800_DTR_WAKE_LEVEL LOW
+/**
+ * @brief The time to wait for the serial port after waking the SIM800 from
+ * sleep mode, by its `DTR` pin or by a first character sent to it.
+ */
+#define SIM800_SLEEP_WAKE_MS 100
 
 // Included Dependencies
 #include "ModSensorDebugger.h"
@@ -186,6 +199,39 @@ class SIMComSIM800 : public loggerModem {
     ~SIMComSIM800();
 
     bool modemWake(void) override;
+    /**
+     * @copydoc loggerModem::modemSleep()
+     *
+     * When the SIM800 is kept connected, this lets it into sleep mode
+     * instead of powering it off.
+     */
+    bool modemSleep(void) override;
+
+    /**
+     * @brief Keep the SIM800 registered, with its GPRS context open, in
+     * sleep mode between logging intervals, instead of powering it off.
+     *
+     * Each cycle from power off has to register with the network, attach to
+     * GPRS and open a PDP context again, often 10-30 seconds at up to 2A.  In
+     * sleep mode the SIM800 draws about 1mA and keeps all of them, so
+     * publishing starts as soon as it's awake.  At intervals of hours, off is
+     * still cheaper.
+     *
+     * With a `DTR` pin, the SIM800 is put in sleep mode 1 (`AT+CSCLK=1`),
+     * which it enters when `DTR` is `HIGH` and leaves when it's `LOW`.
+     * Without one, it's put in sleep mode 2 (`AT+CSCLK=2`) as the logger lets
+     * it sleep, which it enters once its serial port is idle; the first
+     * character sent to it then wakes it and is lost.  The sleep mode is
+     * checked when the modem is set up, so this must be called before that.
+     * The logger doesn't disconnect a modem kept connected; see
+     * loggerModem::isPowerSaving().
+     *
+     * @param keepConnected True to keep the SIM800 connected between
+     * intervals
+     * @param dtrPin The mcu pin wired to the `DTR` pin of the SIM800; -1 to
+     * wake it by its serial port
+     */
+    void setKeepConnected(bool keepConnected, int8_t dtrPin = -1);
 
     bool connectInternet(uint32_t maxConnectionTime = 50000L) override;
     void disconnectInternet(void) override;
@@ -211,14 +257,43 @@ class SIMComSIM800 : public loggerModem {
     TinyGsmClient gsmClient;
 
  protected:
-    bool isInternetAvailable(void) override;
-    bool modemSleepFxn(void) override;
-    bool modemWakeFxn(void) override;
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     isInternetAvailable(void) override;
+    bool     isNetworkRegistered(void) override;
+    bool     setBaudFxn(uint32_t baud) override;
+    bool     testATFxn(uint32_t timeout_ms) override;
+    bool     setFlowControlFxn(void) override;
+    bool     modemSleepFxn(void) override;
+    bool     modemWakeFxn(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    bool     isModemAwake(void) override;
+    /**
+     * @copybrief loggerModem::setPowerSavingFxn()
+     *
+     * For the SIM800, this checks the sleep mode of setKeepConnected() in
+     * place of power saving timers.
+     *
+     * @return **bool** True if the SIM800 accepted the sleep mode
+     */
+    bool setPowerSavingFxn(void) override;
+    /**
+     * @copydoc loggerModem::setModemPinModes()
+     *
+     * When the SIM800 is kept connected, this also wakes its serial port from
+     * sleep mode, before the modem checks that it answers.
+     */
+    void setModemPinModes(void) override;
 
  private:
     const char* _apn;
+    /**
+     * @brief The mcu pin wired to the `DTR` pin of the SIM800
+     */
+    int8_t _dtrPin = -1;
+    /**
+     * @brief True while the SIM800 has been let into sleep mode
+     */
+    bool _inSleepMode = false;
 };
 /**@}*/
 #endif  // SRC_MODEMS_SIMCOMSIM800_H_
@@ -24,7 +24,7 @@ SequansMonarch::SequansMonarch(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -39,8 +39,11 @@ MS_MODEM_WAKE(SequansMonarch);
 MS_MODEM_CONNECT_INTERNET(SequansMonarch);
 MS_MODEM_DISCONNECT_INTERNET(SequansMonarch);
 MS_MODEM_IS_INTERNET_AVAILABLE(SequansMonarch);
+MS_MODEM_IS_NETWORK_REGISTERED(SequansMonarch);
+MS_MODEM_SET_BAUD(SequansMonarch);
 
 MS_MODEM_GET_NIST_TIME(SequansMonarch);
+MS_MODEM_GET_NITZ_TIME(SequansMonarch);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SequansMonarch);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SequansMonarch);
@@ -55,7 +58,7 @@ bool SequansMonarch::modemWakeFxn(void) {
         // Drop the RTS if it's connected - this won't wake the board,
         // but the library will be confused if the pin is the wrong level
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, _wakeLevel);
+            _modemSleepRqIO.write(_wakeLevel);
         }
         // Wait for system start
         MS_DBG(F("Waiting for modem start-up message"));
@@ -64,7 +67,7 @@ bool SequansMonarch::modemWakeFxn(void) {
         // Drop the RTS if it's connected - this won't wake the board,
         // but the library will be confused if the pin is the wrong level
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, _wakeLevel);
+            _modemSleepRqIO.write(_wakeLevel);
         }
         // Hard reset is only way to wake from shut-down
         modemHardReset();
@@ -77,7 +80,7 @@ bool SequansMonarch::modemWakeFxn(void) {
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                _wakeLevel ? F("HIGH") : F("LOW"), F("to bring"), _modemName,
                F("out of power save mode"));
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         return true;
     } else {
         return true;
@@ -97,7 +100,7 @@ bool SequansMonarch::modemSleepFxn(void) {
         // check this pin as an indication of whether the board is awake even if
         // it's not being used as the main wake source
         if (_modemSleepRqPin >= 0) {
-            digitalWrite(_modemSleepRqPin, !_wakeLevel);
+            _modemSleepRqIO.write(!_wakeLevel);
         }
         return retVal;
     } else if (_modemSleepRqPin >= 0) {
@@ -105,7 +108,7 @@ bool SequansMonarch::modemSleepFxn(void) {
         MS_DBG(F("Setting pin"), _modemSleepRqPin,
                !_wakeLevel ? F("HIGH") : F("LOW"), F("to enable"), _modemName,
                F("to enter power save mode"));
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
         return true;
     } else {  // DON'T go to sleep if we can't wake up!
         return true;
@@ -242,11 +242,16 @@ class SequansMonarch : public loggerModem {
     TinyGsmClient gsmClient;
 
  protected:
-    bool isInternetAvailable(void) override;
-    bool modemSleepFxn(void) override;
-    bool modemWakeFxn(void) override;
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     isInternetAvailable(void) override;
+    bool     isNetworkRegistered(void) override;
+    bool     setBaudFxn(uint32_t baud) override;
+    bool     testATFxn(uint32_t timeout_ms) override;
+    bool     setFlowControlFxn(void) override;
+    bool     modemSleepFxn(void) override;
+    bool     modemWakeFxn(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    bool     isModemAwake(void) override;
 
  private:
     const char* _apn;
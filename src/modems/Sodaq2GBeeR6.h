@@ -99,6 +99,8 @@
  * `PWR_KEY` itself is not exposed - it is tied inversely to the power in to the
  * module.  This leaves no way to wake up from minimum power mode.  To prevent
  * large power draw, the module must be powered off between data points.
+ * The module can instead be kept connected in sleep mode 2, woken by its
+ * serial port, with SIMComSIM800::setKeepConnected() and no `DTR` pin.
  *
  * @note The normal `Vin` pin of the Bee socket (pin 1) is used for voltage
  * reference only.
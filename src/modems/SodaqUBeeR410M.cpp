@@ -25,7 +25,7 @@ SodaqUBeeR410M::SodaqUBeeR410M(HardwareSerial* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem) {
     _apn         = apn;
@@ -44,7 +44,7 @@ SodaqUBeeR410M::SodaqUBeeR410M(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -59,9 +59,13 @@ MS_MODEM_WAKE(SodaqUBeeR410M);
 
 MS_MODEM_CONNECT_INTERNET(SodaqUBeeR410M);
 MS_MODEM_DISCONNECT_INTERNET(SodaqUBeeR410M);
+MS_MODEM_SET_POWER_SAVING(SodaqUBeeR410M);
 MS_MODEM_IS_INTERNET_AVAILABLE(SodaqUBeeR410M);
+MS_MODEM_IS_NETWORK_REGISTERED(SodaqUBeeR410M);
+MS_MODEM_SET_BAUD(SodaqUBeeR410M);
 
 MS_MODEM_GET_NIST_TIME(SodaqUBeeR410M);
+MS_MODEM_GET_NITZ_TIME(SodaqUBeeR410M);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SodaqUBeeR410M);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SodaqUBeeR410M);
@@ -75,7 +79,7 @@ bool SodaqUBeeR410M::modemWakeFxn(void) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for Sodaq UBee R410M"));
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
 
         // If possible, monitor the v_int pin waiting for it to become high
         // before ending pulse
@@ -83,9 +87,9 @@ bool SodaqUBeeR410M::modemWakeFxn(void) {
             uint32_t startTimer = millis();
             // 0.15-3.2s pulse for wake on SARA R4/N4 (ie, max is 3.2s)
             // Wait no more than 3.2s
-            while (digitalRead(_statusPin) != static_cast<int>(_statusLevel) &&
+            while (_statusIO.read() != static_cast<int>(_statusLevel) &&
                    millis() - startTimer < 3200L) {}
-            if (digitalRead(_statusPin) == static_cast<int>(_statusLevel)) {
+            if (_statusIO.read() == static_cast<int>(_statusLevel)) {
                 // Print when the pin lit up, if it lights up before end of 3.2s
                 MS_DBG(F("Status pin came on after"), millis() - startTimer,
                        F("ms"));
@@ -98,7 +102,7 @@ bool SodaqUBeeR410M::modemWakeFxn(void) {
             // Say how long we pulsed for
             MS_DBG(F("Pulsed for"), millis() - startTimer, F("ms"));
 
-            if (digitalRead(_statusPin) != static_cast<int>(_statusLevel)) {
+            if (_statusIO.read() != static_cast<int>(_statusLevel)) {
                 // make note if the pin never lit up!
                 MS_DBG(F("Status pin never turned on!"));
             }
@@ -106,12 +110,13 @@ bool SodaqUBeeR410M::modemWakeFxn(void) {
             delay(_wakePulse_ms);  // 0.15-3.2s pulse for wake on SARA R4/N4
         }
 
-        digitalWrite(_modemSleepRqPin, HIGH);
+        _modemSleepRqIO.high();
 // Need to slow down R4/N4's default 115200 baud rate for slow processors
 // The baud rate setting is NOT saved to non-volatile memory, so it must
 // be changed every time after loosing power.
 #if F_CPU == 8000000L
-        if (_powerPin >= 0) {
+        // The baud rate is kept when waking from PSM
+        if (_powerPin >= 0 && !_powerSaving) {
             MS_DBG(F("Waiting for UART to become active and requesting a "
                      "slower baud rate."));
             delay(_max_atresponse_time_ms +
@@ -150,9 +155,9 @@ bool SodaqUBeeR410M::modemHardReset(void) {
                _modemResetPin, _resetLevel ? F("HIGH") : F("LOW"), F("for"),
                _resetPulse_ms, F("ms"));
         MS_DBG(F("Please be patient"));
-        digitalWrite(_modemResetPin, _resetLevel);
+        _modemResetIO.write(_resetLevel);
         delay(_resetPulse_ms);
-        digitalWrite(_modemResetPin, !_resetLevel);
+        _modemResetIO.write(!_resetLevel);
 #if F_CPU == 8000000L
         MS_DBG(F("Waiting for UART to become active and requesting a slower "
                  "baud rate."));
@@ -24,7 +24,7 @@ SodaqUBeeU201::SodaqUBeeU201(Stream* modemStream, int8_t powerPin,
       _modemATDebugger(*modemStream, DEEP_DEBUGGING_SERIAL_OUTPUT),
       gsmModem(_modemATDebugger),
 #else
-      gsmModem(*modemStream),
+      gsmModem(MS_MODEM_AT_STREAM(modemStream)),
 #endif
       gsmClient(gsmModem),
       _apn(apn) {
@@ -39,8 +39,11 @@ MS_MODEM_WAKE(SodaqUBeeU201);
 MS_MODEM_CONNECT_INTERNET(SodaqUBeeU201);
 MS_MODEM_DISCONNECT_INTERNET(SodaqUBeeU201);
 MS_MODEM_IS_INTERNET_AVAILABLE(SodaqUBeeU201);
+MS_MODEM_IS_NETWORK_REGISTERED(SodaqUBeeU201);
+MS_MODEM_SET_BAUD(SodaqUBeeU201);
 
 MS_MODEM_GET_NIST_TIME(SodaqUBeeU201);
+MS_MODEM_GET_NITZ_TIME(SodaqUBeeU201);
 
 MS_MODEM_GET_MODEM_SIGNAL_QUALITY(SodaqUBeeU201);
 MS_MODEM_GET_MODEM_BATTERY_DATA(SodaqUBeeU201);
@@ -49,6 +52,8 @@ MS_MODEM_GET_MODEM_TEMPERATURE_DATA(SodaqUBeeU201);
 // Create the wake and sleep methods for the modem
 // These can be functions of any type and must return a boolean
 bool SodaqUBeeU201::modemWakeFxn(void) {
+    // Kept connected, it's still on
+    if (_powerSaving) return true;
     // SARA/LISA U2/G2 and SARA G3 series turn on when power is applied
     // No pulsing required in this case
     if (_powerPin >= 0) { return true; }
@@ -56,10 +61,10 @@ bool SodaqUBeeU201::modemWakeFxn(void) {
         MS_DBG(F("Sending a"), _wakePulse_ms, F("ms"),
                _wakeLevel ? F("HIGH") : F("LOW"), F("wake-up pulse on pin"),
                _modemSleepRqPin, F("for Sodaq UBee U201"));
-        digitalWrite(_modemSleepRqPin, _wakeLevel);
+        _modemSleepRqIO.write(_wakeLevel);
         // 50-80µs pulse for wake on SARA/LISA U2/G2
         delayMicroseconds(_wakePulse_ms);
-        digitalWrite(_modemSleepRqPin, !_wakeLevel);
+        _modemSleepRqIO.write(!_wakeLevel);
         return true;
     } else {
         return true;
@@ -79,6 +84,71 @@ bool SodaqUBeeU201::modemSleepFxn(void) {
     }
 }
 
+// Kept connected, the U201 is let into its low power idle in place of the
+// sleep function
+bool SodaqUBeeU201::modemSleep(void) {
+    if (_powerSaving) {
+        if (_dtrPin >= 0) {
+            MS_DBG(F("Setting DTR pin"), _dtrPin,
+                   !U201_DTR_WAKE_LEVEL ? F("HIGH") : F("LOW"),
+                   F("to let the U201 idle"));
+            digitalWrite(_dtrPin, !U201_DTR_WAKE_LEVEL);
+            _inSleepMode = true;
+        } else {
+            MS_DBG(F("Letting the U201 idle once its serial port is idle"));
+            gsmModem.sendAT(GF("+UPSV=1"));
+            _inSleepMode = gsmModem.waitResponse() == 1;
+        }
+    }
+    return loggerModem::modemSleep();
+}
+
+
+// The power saving mode is checked by the modem setup in place of power
+// saving timers
+void SodaqUBeeU201::setKeepConnected(bool keepConnected, int8_t dtrPin) {
+    _dtrPin = dtrPin;
+    setPowerSavingMode(keepConnected ? 1 : 0, 0);
+}
+
+
+// With a DTR pin, DTR-controlled power saving is set once and DTR does the
+// rest; without one, cyclic idle is only set as the modem is let sleep, so it
+// can't idle while it's in use
+bool SodaqUBeeU201::setPowerSavingFxn(void) {
+    if (_dtrPin >= 0) {
+        MS_DBG(F("Letting the U201 idle while DTR is HIGH"));
+        gsmModem.sendAT(GF("+UPSV=3"));
+    } else {
+        gsmModem.sendAT(GF("+UPSV=0"));
+    }
+    return gsmModem.waitResponse() == 1;
+}
+
+
+// The wake function isn't run if the status pin shows the U201 is on, so the
+// serial port is woken here
+void SodaqUBeeU201::setModemPinModes(void) {
+    loggerModem::setModemPinModes();
+    if (_dtrPin >= 0) {
+        pinMode(_dtrPin, OUTPUT);
+        digitalWrite(_dtrPin, U201_DTR_WAKE_LEVEL);
+    }
+    if (!_inSleepMode) return;
+    _inSleepMode = false;
+    if (_dtrPin >= 0) {
+        MS_DBG(F("Woke U201 from low power idle with DTR pin"), _dtrPin);
+        delay(U201_SLEEP_WAKE_MS);
+    } else {
+        // The first character wakes the serial port and is lost
+        MS_DBG(F("Waking U201 from low power idle by its serial port"));
+        gsmModem.sendAT(GF(""));
+        gsmModem.waitResponse(U201_SLEEP_WAKE_MS);
+        gsmModem.sendAT(GF("+UPSV=0"));
+        gsmModem.waitResponse();
+    }
+}
+
 bool SodaqUBeeU201::extraModemSetup(void) {
     bool success = gsmModem.init();
     gsmClient.init(&gsmModem);
@@ -136,6 +136,19 @@
  * low.  We allow up to 15 seconds for shutdown in case it is not monitored.
  */
 #define U201_DISCONNECT_TIME_MS 15000L
+/**
+ * @brief The level of the `DTR` pin that keeps the SARA U201 awake when it's
+ * kept connected in DTR-controlled power saving (`AT+UPSV=3`).
+ *
+ * The module enters its low power idle once `DTR` is held `HIGH` (OFF) and
+ * it's idle, and its serial port answers again once `DTR` is `LOW` (ON).
+ */
+#define U201_DTR_WAKE_LEVEL LOW
+/**
+ * @brief The time to wait for the serial port after waking the SARA U201 from
+ * low power idle, by its `DTR` pin or by a first character sent to it.
+ */
+#define U201_SLEEP_WAKE_MS 100
 
 
 // Included Dependencies
@@ -192,6 +205,38 @@ class SodaqUBeeU201 : public loggerModem {
     ~SodaqUBeeU201();
 
     bool modemWake(void) override;
+    /**
+     * @copydoc loggerModem::modemSleep()
+     *
+     * When the U201 is kept connected, this lets it into its low power idle
+     * instead of powering it off.
+     */
+    bool modemSleep(void) override;
+
+    /**
+     * @brief Keep the U201 registered, with its PDP context open, in its low
+     * power idle between logging intervals, instead of powering it off.
+     *
+     * Each cycle from power off has to register with the network, attach and
+     * activate a PDP context again, often 10-30 seconds at the module's
+     * highest current.  In low power idle it draws around 1mA and keeps all
+     * of them, so publishing starts as soon as it's awake.  At intervals of
+     * hours, off is still cheaper.
+     *
+     * With a `DTR` pin, the U201 is put in DTR-controlled power saving
+     * (`AT+UPSV=3`), which lets it idle while `DTR` is `HIGH`.  Without one,
+     * it's put in cyclic idle (`AT+UPSV=1`) as the logger lets it sleep, which
+     * it enters once its serial port is idle; the first character sent to it
+     * then wakes it and is lost.  The power saving mode is checked when the
+     * modem is set up, so this must be called before that.  The logger
+     * doesn't disconnect a modem kept connected; see
+     * loggerModem::isPowerSaving().
+     *
+     * @param keepConnected True to keep the U201 connected between intervals
+     * @param dtrPin The mcu pin wired to the `DTR` pin of the U201; -1 to
+     * wake it by its serial port
+     */
+    void setKeepConnected(bool keepConnected, int8_t dtrPin = -1);
 
     bool connectInternet(uint32_t maxConnectionTime = 50000L) override;
     void disconnectInternet(void) override;
@@ -217,14 +262,43 @@ class SodaqUBeeU201 : public loggerModem {
     TinyGsmClient gsmClient;
 
  protected:
-    bool isInternetAvailable(void) override;
-    bool modemSleepFxn(void) override;
-    bool modemWakeFxn(void) override;
-    bool extraModemSetup(void) override;
-    bool isModemAwake(void) override;
+    bool     isInternetAvailable(void) override;
+    bool     isNetworkRegistered(void) override;
+    bool     setBaudFxn(uint32_t baud) override;
+    bool     testATFxn(uint32_t timeout_ms) override;
+    bool     setFlowControlFxn(void) override;
+    bool     modemSleepFxn(void) override;
+    bool     modemWakeFxn(void) override;
+    bool     extraModemSetup(void) override;
+    uint32_t getNITZTime(void) override;
+    bool     isModemAwake(void) override;
+    /**
+     * @copybrief loggerModem::setPowerSavingFxn()
+     *
+     * For the U201, this checks the power saving mode of setKeepConnected()
+     * in place of power saving timers.
+     *
+     * @return **bool** True if the U201 accepted the power saving mode
+     */
+    bool setPowerSavingFxn(void) override;
+    /**
+     * @copydoc loggerModem::setModemPinModes()
+     *
+     * When the U201 is kept connected, this also wakes its serial port from
+     * low power idle, before the modem checks that it answers.
+     */
+    void setModemPinModes(void) override;
 
  private:
     const char* _apn;
+    /**
+     * @brief The mcu pin wired to the `DTR` pin of the U201
+     */
+    int8_t _dtrPin = -1;
+    /**
+     * @brief True while the U201 has been let into its low power idle
+     */
+    bool _inSleepMode = false;
 };
 /**@}*/
 #endif  // SRC_MODEMS_SODAQUBEEU201_H_
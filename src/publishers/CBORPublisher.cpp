@@ -0,0 +1,416 @@
+/**
+ * @file CBORPublisher.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the CBORPublisher class.
+ */
+
+#include "CBORPublisher.h"
+
+
+// ============================================================================
+//  Functions for a receiver of CBOR records
+// ============================================================================
+
+// Constructors
+CBORPublisher::CBORPublisher() : dataPublisher() {}
+CBORPublisher::CBORPublisher(Logger& baseLogger, uint8_t sendEveryX,
+                             uint8_t sendOffset)
+    : dataPublisher(baseLogger, sendEveryX, sendOffset) {}
+CBORPublisher::CBORPublisher(Logger& baseLogger, Client* inClient,
+                             const char* host, uint16_t port, const char* path,
+                             uint8_t sendEveryX, uint8_t sendOffset)
+    : dataPublisher(baseLogger, inClient, sendEveryX, sendOffset) {
+    setReceiver(host, port, path);
+}
+// Destructor
+CBORPublisher::~CBORPublisher() {}
+
+
+void CBORPublisher::setReceiver(const char* host, uint16_t port,
+                                const char* path) {
+    _host = host;
+    _port = port;
+    _path = path;
+    clearRequestPrefix();
+}
+
+
+void CBORPublisher::setAuthHeader(const char* headerName,
+                                  const char* headerValue) {
+    _authHeaderName  = headerName;
+    _authHeaderValue = headerValue;
+    clearRequestPrefix();
+}
+
+
+// A way to begin with everything already set
+void CBORPublisher::begin(Logger& baseLogger, Client* inClient,
+                          const char* host, uint16_t port, const char* path) {
+    setReceiver(host, port, path);
+    dataPublisher::begin(baseLogger, inClient);
+}
+
+
+// This writes the head of a CBOR data item: the major type and the argument
+uint8_t CBORPublisher::writeHead(bool send, uint8_t majorType,
+                                 uint32_t value) {
+    uint8_t head[5];
+    uint8_t len;
+    majorType <<= 5;
+    if (value < 24) {
+        head[0] = majorType | value;
+        len     = 1;
+    } else if (value <= 0xFF) {
+        head[0] = majorType | 24;
+        head[1] = value;
+        len     = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = majorType | 25;
+        head[1] = value >> 8;
+        head[2] = value & 0xFF;
+        len     = 3;
+    } else {
+        head[0] = majorType | 26;
+        head[1] = value >> 24;
+        head[2] = (value >> 16) & 0xFF;
+        head[3] = (value >> 8) & 0xFF;
+        head[4] = value & 0xFF;
+        len     = 5;
+    }
+    if (send) { txBufferAppend(reinterpret_cast<const char*>(head), len); }
+    return len;
+}
+
+
+// This writes a UUID as 16 bytes, or as text if it isn't a UUID
+uint8_t CBORPublisher::writeUUID(bool send, const char* uuid) {
+    uint8_t bytes[16];
+    if (Variable::parseUUID(uuid, bytes)) return writeUUID(send, bytes);
+    return writeText(send, uuid);
+}
+uint8_t CBORPublisher::writeUUID(bool send, const uint8_t* bytes) {
+    // Major type 2 is a byte string
+    uint8_t len = writeHead(send, 2, 16);
+    if (send) { txBufferAppend(reinterpret_cast<const char*>(bytes), 16); }
+    return len + 16;
+}
+
+
+uint8_t CBORPublisher::writeText(bool send, const char* text) {
+    // Major type 3 is a text string
+    size_t  textLen = strlen(text);
+    uint8_t len     = writeHead(send, 3, textLen);
+    if (send) { txBufferAppend(text, textLen); }
+    return len + textLen;
+}
+
+
+// The terminator keeps "ab" + "c" apart from "a" + "bc"
+uint32_t CBORPublisher::hashText(uint32_t hash, const char* text) {
+    do {
+        hash ^= static_cast<uint8_t>(*text);
+        hash *= 16777619UL;
+    } while (*text++ != '\0');
+    return hash;
+}
+
+
+uint32_t CBORPublisher::getSchemaHash(void) {
+    char     uuidText[37];
+    uint32_t hash = hashText(2166136261UL,
+                             _baseLogger->getSamplingFeatureUUID());
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        _baseLogger->formatVarUUIDAtI(i, uuidText, sizeof(uuidText));
+        hash = hashText(hash, uuidText);
+        hash = hashText(hash, _baseLogger->getVarCodeAtI(i).c_str());
+        hash = hashText(hash, _baseLogger->getVarUnitAtI(i).c_str());
+    }
+    // 0 is kept for no schema
+    return hash != 0 ? hash : 1;
+}
+
+
+// This rounds a float to the nearest half precision float
+uint16_t CBORPublisher::floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign     = (bits >> 16) & 0x8000;
+    int16_t  exponent = ((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        // Infinity and not-a-number
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    }
+    if (exponent >= 31) {
+        // Too big; round to infinity
+        return sign | 0x7C00;
+    }
+    if (exponent <= 0) {
+        // Subnormal, or too small and rounded to zero
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000;
+        uint8_t  shift = 14 - exponent;
+        uint16_t half  = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1) half++;
+        return sign | half;
+    }
+    // Round the 23 bit mantissa to 10 bits; a carry moves up the exponent
+    uint16_t half = (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000) half++;
+    return sign | half;
+}
+
+
+// This writes a value as a single or half precision float
+uint8_t CBORPublisher::writeValue(bool send, float value) {
+    uint8_t item[5];
+    uint8_t len;
+    if (value == -9999 || isnan(value)) {
+        // Major type 7, simple value 22 is null
+        item[0] = 0xF6;
+        len     = 1;
+    } else if (_halfPrecision) {
+        uint16_t half = floatToHalf(value);
+        item[0]       = 0xF9;
+        item[1]       = half >> 8;
+        item[2]       = half & 0xFF;
+        len           = 3;
+    } else {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        item[0] = 0xFA;
+        item[1] = bits >> 24;
+        item[2] = (bits >> 16) & 0xFF;
+        item[3] = (bits >> 8) & 0xFF;
+        item[4] = bits & 0xFF;
+        len     = 5;
+    }
+    if (send) { txBufferAppend(reinterpret_cast<const char*>(item), len); }
+    return len;
+}
+
+
+// This writes the CBOR body of a request, or just counts it
+uint32_t CBORPublisher::writeCBOR(bool send, bool batch,
+                                  uint32_t schemaHash) {
+    uint32_t bodyLength = 0;
+    uint8_t  nRecords   = batch ? _baseLogger->getBatchCount() : 1;
+    uint8_t  nVars      = getSentVarCount();
+    bool     withSchema = schemaHash == 0;
+    bool     offsets    = _baseLogger->getMeasurementOffsets();
+
+    // A map of the parts (major type 5); the hash is sent with the schema
+    // too when the schema is only sent once
+    bodyLength += writeHead(send, 5,
+                            (withSchema ? (_schemaOnce ? 7 : 4) : 3) +
+                                (offsets ? 1 : 0));
+
+    if (_schemaOnce) {
+        // 4: The hash of the schema
+        bodyLength += writeHead(send, 0, 4);
+        bodyLength += writeHead(send, 0,
+                                withSchema ? getSchemaHash() : schemaHash);
+    }
+
+    if (withSchema) {
+        // 0: The sampling feature
+        bodyLength += writeHead(send, 0, 0);
+        bodyLength += writeUUID(send, _baseLogger->getSamplingFeatureUUID());
+    }
+
+    // 1: The UTC times (arrays are major type 4)
+    bodyLength += writeHead(send, 0, 1);
+    bodyLength += writeHead(send, 4, nRecords);
+    for (uint8_t k = 0; k < nRecords; k++) {
+        uint32_t utcTime = Logger::markedUTCEpochTime;
+        if (batch) {
+            // The reverse of Logger::markTime()
+            utcTime = _baseLogger->getBatchTime(k) -
+                ((uint32_t)Logger::getTZOffset()) * 3600;
+        }
+        bodyLength += writeHead(send, 0, utcTime);
+    }
+
+    if (withSchema) {
+        // 2: The variable UUIDs
+        bodyLength += writeHead(send, 0, 2);
+        bodyLength += writeHead(send, 4, nVars);
+        for (uint8_t n = 0; n < nVars; n++) {
+            uint8_t i = getSentVarPosition(n);
+            uint8_t uuid[16];
+            if (_baseLogger->getVarUUIDBytesAtI(i, uuid)) {
+                bodyLength += writeUUID(send, uuid);
+            } else {
+                char uuidText[37];
+                _baseLogger->formatVarUUIDAtI(i, uuidText, sizeof(uuidText));
+                bodyLength += writeUUID(send, uuidText);
+            }
+        }
+    }
+
+    if (withSchema && _schemaOnce) {
+        // 5: The variable codes
+        bodyLength += writeHead(send, 0, 5);
+        bodyLength += writeHead(send, 4, nVars);
+        for (uint8_t n = 0; n < nVars; n++) {
+            uint8_t i = getSentVarPosition(n);
+            bodyLength += writeText(send,
+                                    _baseLogger->getVarCodeAtI(i).c_str());
+        }
+        // 6: The variable units
+        bodyLength += writeHead(send, 0, 6);
+        bodyLength += writeHead(send, 4, nVars);
+        for (uint8_t n = 0; n < nVars; n++) {
+            uint8_t i = getSentVarPosition(n);
+            bodyLength += writeText(send,
+                                    _baseLogger->getVarUnitAtI(i).c_str());
+        }
+    }
+
+    // 3: The values of each record
+    bodyLength += writeHead(send, 0, 3);
+    bodyLength += writeHead(send, 4, nRecords);
+    for (uint8_t k = 0; k < nRecords; k++) {
+        bodyLength += writeHead(send, 4, nVars);
+        for (uint8_t n = 0; n < nVars; n++) {
+            uint8_t i = getSentVarPosition(n);
+            float value;
+            if (batch) {
+                value = _baseLogger->getBatchValueAtI(k, i);
+            } else {
+                // The current record may be a saved one, so use its text
+                char valueBuffer[MS_VALUE_BUFFER_SIZE];
+                formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+                value = atof(valueBuffer);
+            }
+            bodyLength += writeValue(send, value);
+        }
+    }
+
+    if (offsets) {
+        // 7: The measurement offsets of each record, in milliseconds
+        bodyLength += writeHead(send, 0, 7);
+        bodyLength += writeHead(send, 4, nRecords);
+        for (uint8_t k = 0; k < nRecords; k++) {
+            bodyLength += writeHead(send, 4, nVars);
+            for (uint8_t n = 0; n < nVars; n++) {
+                uint8_t i = getSentVarPosition(n);
+                int32_t offset;
+                if (batch) {
+                    offset = _baseLogger->getBatchOffsetAtI(k, i);
+                } else {
+                    offset = _baseLogger->getMeasurementOffsetAtI(i);
+                }
+                // Negative integers are major type 1, holding -1 - value
+                bodyLength += offset < 0
+                    ? writeHead(send, 1, static_cast<uint32_t>(-1 - offset))
+                    : writeHead(send, 0, static_cast<uint32_t>(offset));
+            }
+        }
+    }
+
+    return bodyLength;
+}
+
+
+// The request line and headers only change with the receiver or the
+// authorization
+uint8_t CBORPublisher::getRequestPrefixParts(const char* parts[]) {
+    uint8_t n  = 0;
+    parts[n++] = postHeader;
+    parts[n++] = _path;
+    parts[n++] = HTTPtag;
+    parts[n++] = hostHeader;
+    parts[n++] = _host;
+    if (_authHeaderName != nullptr) {
+        parts[n++] = "\r\n";
+        parts[n++] = _authHeaderName;
+        parts[n++] = ": ";
+        parts[n++] = _authHeaderValue;
+    }
+    parts[n++] = "\r\nContent-Length: ";
+    return n;
+}
+
+
+// A receiver that has lost the schema gets it again in the same interval, so
+// the backlog doesn't drop a record it can't take
+int16_t CBORPublisher::postRequest(Client* outClient, bool batch) {
+    uint32_t schemaHash = 0;
+    if (_schemaOnce) {
+        schemaHash = getSchemaHash();
+        if (schemaHash != _schemaSentHash) {
+            MS_DBG(F("Sending the schema"), schemaHash);
+            schemaHash = 0;
+        }
+    }
+    int16_t responseCode = postBody(outClient, batch, schemaHash);
+    if (responseCode == 412 && schemaHash != 0) {
+        MS_DBG(F("The receiver doesn't know the schema; sending it"));
+        _schemaSentHash = 0;
+        schemaHash      = 0;
+        responseCode    = postBody(outClient, batch, schemaHash);
+    }
+    // A 202 may only mean the request went out unanswered
+    if (_schemaOnce && schemaHash == 0 && responseCode >= 200 &&
+        responseCode < 300 && responseCode != 202) {
+        _schemaSentHash = getSchemaHash();
+    }
+    return responseCode;
+}
+
+
+// This posts the body to the receiver
+int16_t CBORPublisher::postBody(Client* outClient, bool batch,
+                                uint32_t schemaHash) {
+    char    tempBuffer[12] = "";
+    int16_t responseCode   = 504;
+
+    uint32_t bodySize = writeCBOR(false, batch, schemaHash);
+    MS_DBG(F("Outgoing CBOR size:"), bodySize);
+
+    MS_DBG(F("Connecting client"));
+    MS_START_DEBUG_TIMER;
+    if (connectClient(outClient, _host, _port)) {
+        MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
+
+        // Build the request in the tx buffer, which is sent out to the client
+        // each time it fills
+        txBufferInit(outClient);
+        // The request line and the headers up to the content length, all
+        // rendered ahead of time
+        txBufferAppendPrefix();
+        ltoa(bodySize, tempBuffer, 10);  // BASE 10
+        txBufferAppend(tempBuffer);
+        txBufferAppend("\r\nContent-Type: application/cbor\r\n\r\n");
+        writeCBOR(true, batch, schemaHash);
+
+        // Send out the finished request (or the last unsent section of it)
+        txBufferFlush();
+
+        // Read the response, or leave it to be read later, and close the
+        // connection unless it can be kept for the next request
+        responseCode = finishRequest(outClient);
+    } else {
+        PRINTOUT(F("\n -- Unable to Establish Connection to"), _host, F("--"));
+    }
+
+    return responseCode;
+}
+
+
+// This sends the current record
+int16_t CBORPublisher::publishData(Client* outClient) {
+    return postRequest(outClient, false);
+}
+
+
+// This sends a batch of backlogged records
+int16_t CBORPublisher::publishBatch(Client* outClient) {
+    return postRequest(outClient, true);
+}
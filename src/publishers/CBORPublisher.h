@@ -0,0 +1,323 @@
+/**
+ * @file CBORPublisher.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the CBORPublisher subclass of dataPublisher for posting
+ * compact binary (CBOR) records to a web service.
+ */
+
+// Header Guards
+#ifndef SRC_PUBLISHERS_CBORPUBLISHER_H_
+#define SRC_PUBLISHERS_CBORPUBLISHER_H_
+
+// Debugging Statement
+// #define MS_CBORPUBLISHER_DEBUG
+
+#ifdef MS_CBORPUBLISHER_DEBUG
+#define MS_DEBUGGING_STD "CBORPublisher"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "dataPublisherBase.h"
+
+
+// ============================================================================
+//  Functions for a receiver of CBOR records
+// ============================================================================
+/**
+ * @brief The CBORPublisher subclass of dataPublisher for posting records as
+ * [CBOR](https://cbor.io) to a web service.
+ *
+ * Every request is a single CBOR map with small integer keys:
+ *
+ * - `0`: the sampling feature UUID, as a 16 byte string
+ * - `1`: an array of the record times, as unsigned UTC epoch seconds
+ * - `2`: an array of the variable UUIDs, as 16 byte strings
+ * - `3`: an array holding, for each record, an array of the values in the
+ * same order as the UUIDs; as single or half precision floats, or null for
+ * a missing (-9999) value
+ *
+ * Any UUID that is not 32 hex digits is sent as a text string instead.  A
+ * single record is sent as a batch of one.  Compared to the JSON sent to
+ * Monitor My Watershed, the body is several times smaller, and backlogged
+ * records can be packed many to a request.
+ *
+ * With setSchemaOnce(), the identifiers are only sent while the receiver may
+ * not know them.  Each request instead carries:
+ *
+ * - `4`: a 32 bit hash of the schema: the sampling feature UUID and the UUID,
+ * code, and unit of each variable sent, in order
+ *
+ * along with the times (`1`) and values (`3`).  The first request after the
+ * logger starts, and the first after any change to the variables sent, adds
+ * the sampling feature (`0`) and UUIDs (`2`), with:
+ *
+ * - `5`: an array of the variable codes, as text strings
+ * - `6`: an array of the variable units, as text strings
+ *
+ * Once a request with the schema is accepted, the later ones leave it out.  A
+ * receiver that doesn't know the hash of a request should answer 412
+ * (Precondition Failed); the request is then sent again straight away with the
+ * schema.  A 202 (Accepted), which is also what a request sent without
+ * reading the response gives, doesn't confirm the schema; neither does a
+ * response left to be read later.  In the responseFireAndForget and
+ * responseDeferred modes every request keeps the schema.
+ *
+ * With Logger::setMeasurementOffsets() on, each request also carries:
+ *
+ * - `7`: an array holding, for each record, an array of the millisecond
+ * offsets of the measurements from the record time, as integers in the same
+ * order as the values
+ *
+ * The request is an HTTP POST with the content type `application/cbor`.
+ *
+ * @ingroup the_publishers
+ */
+class CBORPublisher : public dataPublisher {
+ public:
+    // Constructors
+    /**
+     * @brief Construct a new CBOR Publisher object with no members
+     * initialized.
+     */
+    CBORPublisher();
+    /**
+     * @brief Construct a new CBOR Publisher object
+     *
+     * @note If a client is never specified, the publisher will attempt to
+     * create and use a client on a LoggerModem instance tied to the attached
+     * logger.
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    explicit CBORPublisher(Logger& baseLogger, uint8_t sendEveryX = 1,
+                           uint8_t sendOffset = 0);
+    /**
+     * @brief Construct a new CBOR Publisher object
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param inClient An Arduino client instance to use to print data to.
+     * Allows the use of any type of client and multiple clients tied to a
+     * single TinyGSM modem instance
+     * @param host The host name of the receiver
+     * @param port The port of the receiver
+     * @param path The path to post the records to
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    CBORPublisher(Logger& baseLogger, Client* inClient, const char* host,
+                  uint16_t port, const char* path, uint8_t sendEveryX = 1,
+                  uint8_t sendOffset = 0);
+    /**
+     * @brief Destroy the CBOR Publisher object
+     */
+    virtual ~CBORPublisher();
+
+    // Returns the data destination
+    String getEndpoint(void) override {
+        return String(_host);
+    }
+
+    /**
+     * @brief Set where to post the records.
+     *
+     * @param host The host name of the receiver
+     * @param port The port of the receiver
+     * @param path The path to post the records to, starting with "/"
+     */
+    void setReceiver(const char* host, uint16_t port, const char* path);
+    /**
+     * @brief Set a header to authorize the requests with.
+     *
+     * @param headerName The name of the header, like "TOKEN" or
+     * "Authorization"
+     * @param headerValue The value of the header
+     */
+    void setAuthHeader(const char* headerName, const char* headerValue);
+    /**
+     * @brief Set whether the values are sent as half precision floats.
+     *
+     * Half precision floats take 3 bytes instead of 5, but only keep about
+     * three significant digits, with a largest value of 65504.
+     *
+     * @param halfPrecision True to send half precision values.  Default is
+     * false.
+     */
+    void setHalfPrecision(bool halfPrecision) {
+        _halfPrecision = halfPrecision;
+    }
+    /**
+     * @brief Set the most backlogged records to send in a single request.
+     *
+     * @param maxBatchRecords The most records per request; 1 to send each
+     * record in its own request.  Default is 1.
+     */
+    void setMaxBatchRecords(uint8_t maxBatchRecords) {
+        _maxBatchRecords = maxBatchRecords > 0 ? maxBatchRecords : 1;
+    }
+    /**
+     * @brief Set whether the schema is sent only until the receiver has it,
+     * with a hash of it in each request.
+     *
+     * @param schemaOnce True to send the schema once.  Default is false.
+     */
+    void setSchemaOnce(bool schemaOnce) {
+        _schemaOnce     = schemaOnce;
+        _schemaSentHash = 0;
+    }
+    /**
+     * @brief Get the hash of the schema of the records: the sampling feature
+     * UUID and the UUID, code, and unit of each variable sent, in order.
+     *
+     * @return **uint32_t** The 32 bit FNV-1a hash of the schema; never 0
+     */
+    uint32_t getSchemaHash(void);
+    /**
+     * @copydoc dataPublisher::getMaxBatchRecords()
+     */
+    uint8_t getMaxBatchRecords(void) override {
+        return _maxBatchRecords;
+    }
+
+    // A way to begin with everything already set
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger, Client* inClient)
+     * @param host The host name of the receiver
+     * @param port The port of the receiver
+     * @param path The path to post the records to
+     */
+    void begin(Logger& baseLogger, Client* inClient, const char* host,
+               uint16_t port, const char* path);
+
+    // This sends the current record
+    int16_t publishData(Client* outClient) override;
+    // This sends a batch of backlogged records
+    int16_t publishBatch(Client* outClient) override;
+
+ protected:
+    /**
+     * @brief Post the current record or the current backlog batch, again
+     * with the schema if the receiver doesn't know its hash.
+     *
+     * @param outClient The client to send the request on
+     * @param batch True to send the logger's backlog batch; false for the
+     * current record
+     * @return **int16_t** The http response code
+     */
+    int16_t postRequest(Client* outClient, bool batch);
+    /**
+     * @brief Post a single request.
+     *
+     * @param outClient The client to send the request on
+     * @param batch True to send the logger's backlog batch; false for the
+     * current record
+     * @param schemaHash The hash of the schema to send in place of it, or 0 to
+     * send the whole schema
+     * @return **int16_t** The http response code
+     */
+    virtual int16_t postBody(Client* outClient, bool batch,
+                             uint32_t schemaHash);
+    /**
+     * @brief Write the CBOR body of a request, or just count its length.
+     *
+     * @param send True to add the body to the TX buffer; false to only count
+     * it
+     * @param batch True to encode the logger's backlog batch; false for the
+     * current record
+     * @param schemaHash The hash of the schema to send in place of it, or 0 to
+     * send the whole schema.  Default is 0.
+     * @return **uint32_t** The length of the body in bytes
+     */
+    uint32_t writeCBOR(bool send, bool batch, uint32_t schemaHash = 0);
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+    /**
+     * @brief Write a CBOR data item head, or just count it.
+     *
+     * @param send True to add the head to the TX buffer
+     * @param majorType The CBOR major type, 0-7
+     * @param value The argument of the head: the value, length, or count
+     * @return **uint8_t** The number of bytes in the head
+     */
+    static uint8_t writeHead(bool send, uint8_t majorType, uint32_t value);
+    /**
+     * @brief Write a UUID as a 16 byte string, or as a text string if it is
+     * not a valid UUID, or just count it.
+     *
+     * @param send True to add the UUID to the TX buffer
+     * @param uuid The UUID text
+     * @return **uint8_t** The number of bytes written
+     */
+    static uint8_t writeUUID(bool send, const char* uuid);
+    /**
+     * @brief Write the 16 raw bytes of a UUID as a byte string, or just count
+     * it.
+     *
+     * @param send True to add the UUID to the TX buffer
+     * @param bytes The 16 bytes of the UUID
+     * @return **uint8_t** The number of bytes written
+     */
+    static uint8_t writeUUID(bool send, const uint8_t* bytes);
+    /**
+     * @brief Write a text string, or just count it.
+     *
+     * @param send True to add the text to the TX buffer
+     * @param text The text to write
+     * @return **uint8_t** The number of bytes written
+     */
+    static uint8_t writeText(bool send, const char* text);
+    /**
+     * @brief Write a value as a float, or null for -9999, or just count it.
+     *
+     * @param send True to add the value to the TX buffer
+     * @param value The value to write
+     * @return **uint8_t** The number of bytes written
+     */
+    uint8_t writeValue(bool send, float value);
+    /**
+     * @brief Convert a float to the bits of an IEEE 754 half precision float,
+     * rounding to the nearest value.
+     *
+     * @param value The value to convert
+     * @return **uint16_t** The half precision bits
+     */
+    static uint16_t floatToHalf(float value);
+    /**
+     * @brief Add a text and its terminator to a running FNV-1a hash.
+     *
+     * @param hash The hash so far
+     * @param text The text to add
+     * @return **uint32_t** The new hash
+     */
+    static uint32_t hashText(uint32_t hash, const char* text);
+
+    // Where to send the records
+    const char* _host = nullptr;
+    uint16_t    _port = 80;
+    const char* _path = "/";
+
+ private:
+    const char* _authHeaderName  = nullptr;
+    const char* _authHeaderValue = nullptr;
+    bool        _halfPrecision   = false;
+    uint8_t     _maxBatchRecords = 1;
+    bool        _schemaOnce      = false;
+    /**
+     * @brief The hash of the schema the receiver last accepted; 0 if none
+     */
+    uint32_t _schemaSentHash = 0;
+};
+
+#endif  // SRC_PUBLISHERS_CBORPUBLISHER_H_
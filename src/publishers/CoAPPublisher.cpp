@@ -0,0 +1,263 @@
+/**
+ * @file CoAPPublisher.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the CoAPPublisher class.
+ */
+
+#include "CoAPPublisher.h"
+
+
+// ============================================================================
+//  Functions for a CoAP receiver of CBOR records
+// ============================================================================
+
+// The parts of a CoAP message header
+#define COAP_VERSION 0x40
+#define COAP_TYPE_CON 0
+#define COAP_TYPE_NON 1
+#define COAP_TYPE_ACK 2
+#define COAP_TYPE_RST 3
+#define COAP_CODE_POST 0x02
+#define COAP_PAYLOAD_MARKER 0xFF
+// The options, in the order they must be sent
+#define COAP_OPTION_URI_HOST 3
+#define COAP_OPTION_URI_PATH 11
+#define COAP_OPTION_CONTENT_FORMAT 12
+// The content format number of application/cbor
+#define COAP_FORMAT_CBOR 60
+
+
+// Constructors
+CoAPPublisher::CoAPPublisher() : CBORPublisher() {}
+CoAPPublisher::CoAPPublisher(Logger& baseLogger, UDP* udp, const char* host,
+                             uint16_t port, const char* path,
+                             uint8_t sendEveryX, uint8_t sendOffset)
+    : CBORPublisher(baseLogger, sendEveryX, sendOffset),
+      _udp(udp) {
+    setReceiver(host, port, path);
+}
+// Destructor
+CoAPPublisher::~CoAPPublisher() {}
+
+
+// A way to begin with everything already set
+void CoAPPublisher::begin(Logger& baseLogger, UDP* udp, const char* host,
+                          uint16_t port, const char* path) {
+    setUDP(udp);
+    setReceiver(host, port, path);
+    dataPublisher::begin(baseLogger);
+}
+
+
+// There are no HTTP headers to render ahead of time
+uint8_t CoAPPublisher::getRequestPrefixParts(const char* parts[]) {
+    (void)parts;
+    return 0;
+}
+
+
+// This adds one option, with its number as the difference from the last
+void CoAPPublisher::writeOption(uint16_t delta, const uint8_t* value,
+                                uint16_t length) {
+    uint8_t head[5];
+    uint8_t headLen = 1;
+    uint8_t deltaNibble;
+    uint8_t lengthNibble;
+    if (delta < 13) {
+        deltaNibble = delta;
+    } else if (delta < 269) {
+        deltaNibble     = 13;
+        head[headLen++] = delta - 13;
+    } else {
+        deltaNibble     = 14;
+        head[headLen++] = (delta - 269) >> 8;
+        head[headLen++] = (delta - 269) & 0xFF;
+    }
+    if (length < 13) {
+        lengthNibble = length;
+    } else if (length < 269) {
+        lengthNibble    = 13;
+        head[headLen++] = length - 13;
+    } else {
+        lengthNibble    = 14;
+        head[headLen++] = (length - 269) >> 8;
+        head[headLen++] = (length - 269) & 0xFF;
+    }
+    head[0] = (deltaNibble << 4) | lengthNibble;
+    txBufferAppend(reinterpret_cast<const char*>(head), headLen);
+    txBufferAppend(reinterpret_cast<const char*>(value), length);
+}
+
+
+// This writes the header, the token, and the options of a POST
+void CoAPPublisher::writeCoAPHeader(uint16_t messageID) {
+    uint8_t type = _confirmable ? COAP_TYPE_CON : COAP_TYPE_NON;
+    // The message ID doubles as a two byte token
+    uint8_t head[6] = {
+        static_cast<uint8_t>(COAP_VERSION | (type << 4) | 2),
+        COAP_CODE_POST,
+        static_cast<uint8_t>(messageID >> 8),
+        static_cast<uint8_t>(messageID & 0xFF),
+        static_cast<uint8_t>(messageID >> 8),
+        static_cast<uint8_t>(messageID & 0xFF)};
+    txBufferAppend(reinterpret_cast<const char*>(head), sizeof(head));
+
+    writeOption(COAP_OPTION_URI_HOST, reinterpret_cast<const uint8_t*>(_host),
+                strlen(_host));
+    // Each segment of the path is its own option
+    uint16_t    lastOption = COAP_OPTION_URI_HOST;
+    const char* segment    = _path;
+    while (*segment != '\0') {
+        if (*segment == '/') {
+            segment++;
+            continue;
+        }
+        const char* end = strchr(segment, '/');
+        uint16_t    len = end != nullptr ? end - segment : strlen(segment);
+        writeOption(COAP_OPTION_URI_PATH - lastOption,
+                    reinterpret_cast<const uint8_t*>(segment), len);
+        lastOption = COAP_OPTION_URI_PATH;
+        segment += len;
+    }
+    uint8_t format = COAP_FORMAT_CBOR;
+    writeOption(COAP_OPTION_CONTENT_FORMAT - lastOption, &format, 1);
+}
+
+
+// This waits for the acknowledgement, or a separate response, to a request
+int16_t CoAPPublisher::waitForResponse(uint16_t messageID,
+                                       uint32_t timeout_ms) {
+    uint32_t start = millis();
+    while (millis() - start < timeout_ms) {
+        int size = _udp->parsePacket();
+        if (size < 4) {
+            delay(10);
+            continue;
+        }
+        // Only the header and the token are needed
+        uint8_t head[6];
+        int     got = _udp->read(head, size < 6 ? size : 6);
+        if (got < 4 || (head[0] & 0xC0) != COAP_VERSION) continue;
+        uint8_t  type     = (head[0] >> 4) & 0x03;
+        uint8_t  code     = head[1];
+        uint16_t id       = (head[2] << 8) | head[3];
+        bool     forToken = (head[0] & 0x0F) == 2 && got == 6 &&
+            head[4] == (messageID >> 8) && head[5] == (messageID & 0xFF);
+
+        if ((type == COAP_TYPE_ACK || type == COAP_TYPE_RST) &&
+            id == messageID) {
+            if (type == COAP_TYPE_RST) {
+                MS_DBG(F("Request was reset"));
+                return 0;
+            }
+            // An empty acknowledgement means the response will come later
+            if (code == 0) {
+                MS_DBG(F("Request acknowledged; waiting for the response"));
+                continue;
+            }
+            return (code >> 5) * 100 + (code & 0x1F);
+        }
+        if ((type == COAP_TYPE_CON || type == COAP_TYPE_NON) && forToken &&
+            code != 0) {
+            // Acknowledge a confirmable separate response
+            if (type == COAP_TYPE_CON) {
+                uint8_t ack[4] = {COAP_VERSION | (COAP_TYPE_ACK << 4), 0,
+                                  head[2], head[3]};
+                _udp->beginPacket(_host, _port);
+                _udp->write(ack, sizeof(ack));
+                _udp->endPacket();
+                _bytesSent += sizeof(ack);
+                _totalBytesSent += sizeof(ack);
+            }
+            return (code >> 5) * 100 + (code & 0x1F);
+        }
+    }
+    return -1;
+}
+
+
+// This sends the request, and sends it again until it is acknowledged
+int16_t CoAPPublisher::postBody(Client* outClient, bool batch,
+                                uint32_t schemaHash) {
+    (void)outClient;
+    if (_udp == nullptr) {
+        PRINTOUT(F("ERROR! No UDP instance assigned to publish data!"));
+        return 0;
+    }
+
+    uint32_t bodySize  = writeCBOR(false, batch, schemaHash);
+    uint16_t messageID = ++_messageID;
+    MS_DBG(F("Outgoing CBOR size:"), bodySize);
+
+    // The whole datagram is built in the tx buffer before it is sent
+    txBufferInit(nullptr);
+    writeCoAPHeader(messageID);
+    if (txBufferLen + 1 + bodySize > MS_SEND_BUFFER_SIZE - 1) {
+        PRINTOUT(F("Request of"), txBufferLen + 1 + bodySize,
+                 F("bytes is too big for the TX buffer!"));
+        emptyTxBuffer();
+        return 413;
+    }
+    txBufferAppend(static_cast<char>(COAP_PAYLOAD_MARKER));
+    writeCBOR(true, batch, schemaHash);
+
+    _udp->begin(_port);
+    int16_t responseCode = 504;
+    // The first timeout is randomized to spread out the retries of a fleet
+    uint32_t timeout = _ackTimeout_ms + random(_ackTimeout_ms / 2 + 1);
+    uint8_t  tries   = _confirmable ? _maxRetransmit + 1 : 1;
+    for (uint8_t t = 0; t < tries; t++) {
+        MS_DBG(F("Sending"), txBufferLen, F("byte CoAP request"), messageID);
+        uint32_t sentAt = millis();
+        if (!_udp->beginPacket(_host, _port)) {
+            PRINTOUT(F("\n -- Unable to send a datagram to"), _host, F("--"));
+            responseCode = 0;
+            break;
+        }
+        _udp->write(reinterpret_cast<const uint8_t*>(txBuffer), txBufferLen);
+        _udp->endPacket();
+        _bytesSent += txBufferLen;
+        _totalBytesSent += txBufferLen;
+        if (!_confirmable) {
+            responseCode = 202;
+            break;
+        }
+        int16_t response = waitForResponse(messageID, timeout);
+        if (response >= 0) {
+            _lastResponseTime = millis() - sentAt;
+            responseCode      = response;
+            break;
+        }
+        MS_DBG(F("No acknowledgement after"), timeout, F("ms"));
+        _lastResponseTime = -1;
+        timeout *= 2;
+    }
+    _udp->stop();
+    emptyTxBuffer();
+
+    PRINTOUT(F("-- Response Code --"));
+    PRINTOUT(responseCode);
+
+    return responseCode;
+}
+
+
+// This sends the current record
+int16_t CoAPPublisher::publishData(Client* outClient) {
+    return postRequest(outClient, false);
+}
+int16_t CoAPPublisher::publishData(void) {
+    return postRequest(nullptr, false);
+}
+
+
+// This sends a batch of backlogged records
+int16_t CoAPPublisher::publishBatch(Client* outClient) {
+    return postRequest(outClient, true);
+}
+int16_t CoAPPublisher::publishBatch(void) {
+    return postRequest(nullptr, true);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file CoAPPublisher.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the CoAPPublisher subclass of CBORPublisher for sending
+ * CBOR records over UDP as CoAP messages.
+ */
+
+// Header Guards
+#ifndef SRC_PUBLISHERS_COAPPUBLISHER_H_
+#define SRC_PUBLISHERS_COAPPUBLISHER_H_
+
+// Debugging Statement
+// #define MS_COAPPUBLISHER_DEBUG
+
+#ifdef MS_COAPPUBLISHER_DEBUG
+#define MS_DEBUGGING_STD "CoAPPublisher"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "CBORPublisher.h"
+#include <Udp.h>
+
+
+// ============================================================================
+//  Functions for a CoAP receiver of CBOR records
+// ============================================================================
+/**
+ * @brief The CoAPPublisher subclass of CBORPublisher for sending records as
+ * [CoAP](https://datatracker.ietf.org/doc/html/rfc7252) POST requests over
+ * UDP.
+ *
+ * The payload is the same CBOR map that the CBORPublisher posts over HTTP, so
+ * one receiver can take both, and CBORPublisher::setSchemaOnce() works the
+ * same way; a 4.12 (Precondition Failed) asks for the schema.  Each request
+ * is a single datagram with no connection to open, which keeps a record to
+ * one short radio burst on NB-IoT and LTE-M.  The request and its whole
+ * payload must fit in #MS_SEND_BUFFER_SIZE; keep
+ * dataPublisher::setMaxBatchRecords() small enough for the batches to fit.
+ *
+ * Requests are confirmable by default: the request is sent again after the
+ * acknowledgement timeout, doubling the timeout each time, until it is
+ * acknowledged or has been sent the most times allowed.  The CoAP response
+ * code is returned as the matching http code, so 2.01 (Created) is 201 and
+ * 4.00 (Bad Request) is 400.  A request that is never acknowledged gives a
+ * 504.  A non-confirmable request gets no acknowledgement, and gives a 202 as
+ * soon as it is sent.
+ *
+ * TinyGSM does not have UDP sockets, so this takes an instance of the Arduino
+ * UDP class for whichever modem or network interface you have.  It does not
+ * use the Client given to the publisher.
+ *
+ * @ingroup the_publishers
+ */
+class CoAPPublisher : public CBORPublisher {
+ public:
+    // Constructors
+    /**
+     * @brief Construct a new CoAP Publisher object with no members
+     * initialized.
+     */
+    CoAPPublisher();
+    /**
+     * @brief Construct a new CoAP Publisher object
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param udp The UDP instance to send the requests with
+     * @param host The host name of the receiver
+     * @param port The port of the receiver; CoAP uses 5683
+     * @param path The path to post the records to, like "/records"
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    CoAPPublisher(Logger& baseLogger, UDP* udp, const char* host,
+                  uint16_t port, const char* path, uint8_t sendEveryX = 1,
+                  uint8_t sendOffset = 0);
+    /**
+     * @brief Destroy the CoAP Publisher object
+     */
+    virtual ~CoAPPublisher();
+
+    /**
+     * @brief Set the UDP instance to send the requests with.
+     *
+     * @param udp The UDP instance
+     */
+    void setUDP(UDP* udp) {
+        _udp = udp;
+    }
+    /**
+     * @brief Set whether the requests are confirmable.
+     *
+     * @param confirmable True to wait for each request to be acknowledged,
+     * sending it again if it isn't; false to send each request once and not
+     * wait.  Default is true.
+     */
+    void setConfirmable(bool confirmable) {
+        _confirmable = confirmable;
+    }
+    /**
+     * @brief Set how long to wait for an acknowledgement and how many times
+     * to send a confirmable request again.
+     *
+     * The timeout doubles after each try.  The defaults are those of RFC
+     * 7252.
+     *
+     * @param ackTimeout_ms The time to wait for the first acknowledgement in
+     * milliseconds.  Default is 2000.
+     * @param maxRetransmit The most times to send a request again.  Default
+     * is 4.
+     */
+    void setRetransmission(uint16_t ackTimeout_ms, uint8_t maxRetransmit) {
+        _ackTimeout_ms = ackTimeout_ms;
+        _maxRetransmit = maxRetransmit;
+    }
+
+    // A way to begin with everything already set
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger)
+     * @param udp The UDP instance to send the requests with
+     * @param host The host name of the receiver
+     * @param port The port of the receiver; CoAP uses 5683
+     * @param path The path to post the records to
+     */
+    void begin(Logger& baseLogger, UDP* udp, const char* host, uint16_t port,
+               const char* path);
+
+    // This sends the current record
+    int16_t publishData(Client* outClient) override;
+    // This sends the current record without needing a client
+    int16_t publishData(void) override;
+    // This sends a batch of backlogged records
+    int16_t publishBatch(Client* outClient) override;
+    // This sends a batch of backlogged records without needing a client
+    int16_t publishBatch(void) override;
+
+ protected:
+    /**
+     * @brief Send the current record or the current backlog batch as a CoAP
+     * POST request and wait for its acknowledgement.
+     *
+     * @param outClient Unused; the request goes out over the UDP instance
+     * @param batch True to send the logger's backlog batch; false for the
+     * current record
+     * @param schemaHash The hash of the schema to send in place of it, or 0 to
+     * send the whole schema
+     * @return **int16_t** The CoAP response code as an http code
+     */
+    int16_t postBody(Client* outClient, bool batch,
+                     uint32_t schemaHash) override;
+    /**
+     * @brief Add the CoAP header and options of a request to the TX buffer.
+     *
+     * @param messageID The message ID, also used as the token
+     */
+    void writeCoAPHeader(uint16_t messageID);
+    /**
+     * @brief Add a CoAP option to the TX buffer.
+     *
+     * @param delta The difference from the number of the last option
+     * @param value The value of the option
+     * @param length The length of the value
+     */
+    static void writeOption(uint16_t delta, const uint8_t* value,
+                            uint16_t length);
+    /**
+     * @brief Wait for the response to a request.
+     *
+     * @param messageID The message ID and token of the request
+     * @param timeout_ms How long to wait
+     * @return **int16_t** The CoAP response code as an http code, 0 if the
+     * request was reset, or -1 if nothing came in time
+     */
+    int16_t waitForResponse(uint16_t messageID, uint32_t timeout_ms);
+    /**
+     * @brief There is no HTTP prefix to render for CoAP.
+     *
+     * @param parts Unused
+     * @return **uint8_t** 0
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+
+ private:
+    UDP*     _udp           = nullptr;
+    bool     _confirmable   = true;
+    uint16_t _ackTimeout_ms = 2000;
+    uint8_t  _maxRetransmit = 4;
+    uint16_t _messageID     = 0;
+};
+
+#endif  // SRC_PUBLISHERS_COAPPUBLISHER_H_
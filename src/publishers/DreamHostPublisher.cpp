@@ -49,6 +49,16 @@ DreamHostPublisher::~DreamHostPublisher() {}
 // Functions for private SWRC server
 void DreamHostPublisher::setDreamHostPortalRX(const char* dhUrl) {
     _DreamHostPortalRX = dhUrl;
+    clearRequestPrefix();
+}
+
+
+// The start of the URL only changes with the receiver
+uint8_t DreamHostPublisher::getRequestPrefixParts(const char* parts[]) {
+    parts[0] = getHeader;
+    parts[1] = _DreamHostPortalRX;
+    parts[2] = loggerTag;
+    return 3;
 }
 
 
@@ -58,14 +68,19 @@ void DreamHostPublisher::printSensorDataDreamHost(Stream* stream) {
     stream->print(loggerTag);
     stream->print(_baseLogger->getLoggerID());
     stream->print(timestampTagDH);
-    stream->print(String(Logger::markedLocalEpochTime -
-                         946684800));  // Correct time from epoch to y2k
+    stream->print(Logger::markedLocalEpochTime -
+                  946684800);  // Correct time from epoch to y2k
 
-    for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
+    char codeBuffer[37];
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
         stream->print('&');
-        stream->print(_baseLogger->getVarCodeAtI(i));
+        _baseLogger->formatVarCodeAtI(i, codeBuffer, sizeof(codeBuffer));
+        stream->print(codeBuffer);
         stream->print('=');
-        stream->print(_baseLogger->getValueStringAtI(i));
+        formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+        stream->print(valueBuffer);
     }
 }
 
@@ -104,101 +119,52 @@ void DreamHostPublisher::begin(Logger& baseLogger, const char* dhUrl) {
 int16_t DreamHostPublisher::publishData(Client* outClient) {
     // Create a buffer for the portions of the request and response
     char     tempBuffer[37] = "";
-    uint16_t did_respond    = 0;
+    int16_t  responseCode   = 504;
 
     // Open a TCP/IP connection to DreamHost
     MS_DBG(F("Connecting client"));
     MS_START_DEBUG_TIMER;
-    if (outClient->connect(dreamhostHost, dreamhostPort)) {
+    if (connectClient(outClient, dreamhostHost, dreamhostPort)) {
         MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
 
-        // copy the initial post header into the tx buffer
-        snprintf(txBuffer, sizeof(txBuffer), "%s", getHeader);
-
-        // add in the dreamhost receiver URL
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", _DreamHostPortalRX);
+        // Build the request in the tx buffer, which is sent out to the client
+        // each time it fills
+        txBufferInit(outClient);
+        // The receiver URL and the start of the URL parameters, rendered
+        // ahead of time
+        txBufferAppendPrefix();
+        txBufferAppend(_baseLogger->getLoggerID());
 
-        // start the URL parameters
-        if (bufferFree() < 16) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", loggerTag);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 _baseLogger->getLoggerID());
-
-        if (bufferFree() < 22) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", timestampTagDH);
+        txBufferAppend(timestampTagDH);
         ltoa((Logger::markedLocalEpochTime - 946684800), tempBuffer,
              10);  // BASE 10
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-
-        for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
-            // Once the buffer fills, send it out
-            if (bufferFree() < 47) printTxBuffer(outClient);
-
-            txBuffer[strlen(txBuffer)] = '&';
-            _baseLogger->getVarCodeAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            txBuffer[strlen(txBuffer)] = '=';
-            _baseLogger->getValueStringAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
+        txBufferAppend(tempBuffer);
+
+        for (uint8_t n = 0; n < getSentVarCount(); n++) {
+            uint8_t i = getSentVarPosition(n);
+            txBufferAppend('&');
+            _baseLogger->formatVarCodeAtI(i, tempBuffer, 37);
+            txBufferAppend(tempBuffer);
+            txBufferAppend('=');
+            formatSentValueAtI(i, tempBuffer, sizeof(tempBuffer));
+            txBufferAppend(tempBuffer);
         }
 
         // add the rest of the HTTP GET headers to the outgoing buffer
-        if (bufferFree() < 52) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", HTTPtag);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", hostHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", dreamhostHost);
-        txBuffer[strlen(txBuffer)] = '\r';
-        txBuffer[strlen(txBuffer)] = '\n';
-        txBuffer[strlen(txBuffer)] = '\r';
-        txBuffer[strlen(txBuffer)] = '\n';
+        txBufferAppend(HTTPtag);
+        txBufferAppend(hostHeader);
+        txBufferAppend(dreamhostHost);
+        txBufferAppend("\r\n\r\n");
 
         // Send out the finished request (or the last unsent section of it)
-        printTxBuffer(outClient);
-
-        // Wait 10 seconds for a response from the server
-        uint32_t start = millis();
-        while ((millis() - start) < 10000L && outClient->available() < 12) {
-            delay(10);
-        }
+        txBufferFlush();
 
-        // Read only the first 12 characters of the response
-        // We're only reading as far as the http code, anything beyond that
-        // we don't care about.
-        did_respond = outClient->readBytes(tempBuffer, 12);
-
-        // Close the TCP/IP connection
-        MS_DBG(F("Stopping client"));
-        MS_RESET_DEBUG_TIMER;
-        outClient->stop();
-        MS_DBG(F("Client stopped after"), MS_PRINT_DEBUG_TIMER, F("ms"));
+        // Read the response, or leave it to be read later, and close the
+        // connection unless it can be kept for the next request
+        responseCode = finishRequest(outClient);
     } else {
         PRINTOUT(F("\n -- Unable to Establish Connection to DreamHost --"));
     }
 
-    // Process the HTTP response
-    int16_t responseCode = 0;
-    if (did_respond > 0) {
-        char responseCode_char[4];
-        for (uint8_t i = 0; i < 3; i++) {
-            responseCode_char[i] = tempBuffer[i + 9];
-        }
-        responseCode = atoi(responseCode_char);
-    } else {
-        responseCode = 504;
-    }
-
-    PRINTOUT(F("-- Response Code --"));
-    PRINTOUT(responseCode);
-
     return responseCode;
 }
@@ -51,11 +51,10 @@ class DreamHostPublisher : public dataPublisher {
      * logger.
      *
      * @param baseLogger The logger supplying the data to be published
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -72,11 +71,10 @@ class DreamHostPublisher : public dataPublisher {
      * @param inClient An Arduino client instance to use to print data to.
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -91,11 +89,10 @@ class DreamHostPublisher : public dataPublisher {
      *
      * @param baseLogger The logger supplying the data to be published
      * @param dhUrl The URL for sending data to DreamHost
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     DreamHostPublisher(Logger& baseLogger, const char* dhUrl,
                        uint8_t sendEveryX = 1, uint8_t sendOffset = 0);
@@ -107,11 +104,10 @@ class DreamHostPublisher : public dataPublisher {
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
      * @param dhUrl The URL for sending data to DreamHost
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     DreamHostPublisher(Logger& baseLogger, Client* inClient, const char* dhUrl,
                        uint8_t sendEveryX = 1, uint8_t sendOffset = 0);
@@ -195,6 +191,11 @@ class DreamHostPublisher : public dataPublisher {
     static const char* timestampTagDH;  ///< The timestamp
                                         /**@}*/
 
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+
 
  private:
     const char* _DreamHostPortalRX = nullptr;
@@ -24,9 +24,15 @@ const char* EnviroDIYPublisher::tokenHeader         = "\r\nTOKEN: ";
 const char* EnviroDIYPublisher::contentLengthHeader = "\r\nContent-Length: ";
 const char* EnviroDIYPublisher::contentTypeHeader =
     "\r\nContent-Type: application/json\r\n\r\n";
+#if defined(MS_GZIP_WINDOW_SIZE)
+const char* EnviroDIYPublisher::contentEncodingHeader =
+    "\r\nContent-Encoding: gzip";
+GzipWriter EnviroDIYPublisher::gzipWriter;
+#endif
 
 const char* EnviroDIYPublisher::samplingFeatureTag = "{\"sampling_feature\":\"";
 const char* EnviroDIYPublisher::timestampTag       = "\",\"timestamp\":\"";
+const char* EnviroDIYPublisher::timestampArrayTag  = "\",\"timestamp\":[";
 
 
 // Constructors
@@ -59,6 +65,21 @@ EnviroDIYPublisher::~EnviroDIYPublisher() {}
 
 void EnviroDIYPublisher::setToken(const char* registrationToken) {
     _registrationToken = registrationToken;
+    clearRequestPrefix();
+}
+
+
+// The headers before the content length only change with the token
+uint8_t EnviroDIYPublisher::getRequestPrefixParts(const char* parts[]) {
+    parts[0] = postHeader;
+    parts[1] = postEndpoint;
+    parts[2] = HTTPtag;
+    parts[3] = hostHeader;
+    parts[4] = enviroDIYHost;
+    parts[5] = tokenHeader;
+    parts[6] = _registrationToken;
+    parts[7] = contentLengthHeader;
+    return 8;
 }
 
 
@@ -67,18 +88,15 @@ uint16_t EnviroDIYPublisher::calculateJsonSize() {
     uint16_t jsonLength = 21;  // {"sampling_feature":"
     jsonLength += 36;          // sampling feature UUID
     jsonLength += 15;          // ","timestamp":"
-    jsonLength += 25;          // markedISO8601Time
-    jsonLength += 2;           //  ",
-    for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
-        jsonLength += 1;   //  "
-        jsonLength += 36;  // variable UUID
-        jsonLength += 2;   //  ":
-        jsonLength += _baseLogger->getValueStringAtI(i).length();
-        if (i + 1 != _baseLogger->getArrayVarCount()) {
-            jsonLength += 1;  // ,
-        }
-    }
-    jsonLength += 1;  // }
+    jsonLength += strlen(Logger::markedISO8601Time);
+    jsonLength += 1;  //  "
+    // all of the values to send, already formatted in the logger's record
+    uint8_t nSent;
+    jsonLength += getSentValuesLength(nSent);
+    jsonLength += nSent * 2;   //  ,"
+    jsonLength += nSent * 36;  // variable UUID
+    jsonLength += nSent * 2;   //  ":
+    jsonLength += 1;           // }
 
     return jsonLength;
 }
@@ -88,15 +106,20 @@ void EnviroDIYPublisher::printSensorDataJSON(Stream* stream) {
     stream->print(samplingFeatureTag);
     stream->print(_baseLogger->getSamplingFeatureUUID());
     stream->print(timestampTag);
-    stream->print(Logger::formatDateTime_ISO8601(Logger::markedLocalEpochTime));
-    stream->print(F("\","));
-
-    for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
-        stream->print('"');
-        stream->print(_baseLogger->getVarUUIDAtI(i));
+    stream->print(Logger::markedISO8601Time);
+    stream->print('"');
+
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    char uuidBuffer[37];
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        if (!isValueSentAtI(i)) continue;
+        stream->print(F(",\""));
+        _baseLogger->formatVarUUIDAtI(i, uuidBuffer, sizeof(uuidBuffer));
+        stream->print(uuidBuffer);
         stream->print(F("\":"));
-        stream->print(_baseLogger->getValueStringAtI(i));
-        if (i + 1 != _baseLogger->getArrayVarCount()) { stream->print(','); }
+        formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+        stream->print(valueBuffer);
     }
 
     stream->print('}');
@@ -146,130 +169,203 @@ void EnviroDIYPublisher::begin(Logger&     baseLogger,
 // The return is the http status code of the response.
 // int16_t EnviroDIYPublisher::postDataEnviroDIY(void)
 int16_t EnviroDIYPublisher::publishData(Client* outClient) {
+    return postRequest(outClient, false);
+}
+
+
+// This sends all of the records in the logger's backlog batch in one request
+int16_t EnviroDIYPublisher::publishBatch(Client* outClient) {
+    return postRequest(outClient, true);
+}
+
+
+// This writes (or just measures) the JSON for a batch of records, with an
+// array of timestamps and an array of values for each variable
+uint32_t EnviroDIYPublisher::writeBatchJson(bool send) {
+    // Big enough for a UUID (36 + null) or any formatted value
+    char     tempBuffer[37];
+    uint32_t jsonLength = 0;
+    uint8_t  nRecords   = _baseLogger->getBatchCount();
+    uint8_t  nVars      = getSentVarCount();
+
+    // Add a string to the outgoing buffer or just count it
+#define BATCH_JSON_ADD(str)                         \
+    {                                               \
+        const char* toAdd = str;                    \
+        if (send) { bodyAppend(toAdd); }            \
+        jsonLength += strlen(toAdd);                \
+    }
+
+    BATCH_JSON_ADD(samplingFeatureTag)
+    BATCH_JSON_ADD(_baseLogger->getSamplingFeatureUUID())
+    BATCH_JSON_ADD(timestampArrayTag)
+    for (uint8_t k = 0; k < nRecords; k++) {
+        BATCH_JSON_ADD("\"")
+        char timeBuffer[MS_ISO8601_BUFFER_SIZE];
+        Logger::formatDateTime_ISO8601(_baseLogger->getBatchTime(k), timeBuffer,
+                                       sizeof(timeBuffer));
+        BATCH_JSON_ADD(timeBuffer)
+        BATCH_JSON_ADD(k + 1 != nRecords ? "\"," : "\"]")
+    }
+    for (uint8_t n = 0; n < nVars; n++) {
+        uint8_t i = getSentVarPosition(n);
+        BATCH_JSON_ADD(",\"")
+        _baseLogger->formatVarUUIDAtI(i, tempBuffer, sizeof(tempBuffer));
+        BATCH_JSON_ADD(tempBuffer)
+        BATCH_JSON_ADD("\":[")
+        for (uint8_t k = 0; k < nRecords; k++) {
+            _baseLogger->formatBatchValueAtI(k, i, tempBuffer,
+                                             sizeof(tempBuffer));
+            BATCH_JSON_ADD(tempBuffer)
+            BATCH_JSON_ADD(k + 1 != nRecords ? "," : "]")
+        }
+    }
+    BATCH_JSON_ADD("}")
+#undef BATCH_JSON_ADD
+
+    return jsonLength;
+}
+
+
+// This writes (or just measures) the JSON for the current record
+uint32_t EnviroDIYPublisher::writeRecordJson(bool send) {
+    // Big enough for a UUID (36 + null) or any formatted value
+    char     tempBuffer[37];
+    uint32_t jsonLength = 0;
+
+    // Add a string to the outgoing buffer or just count it
+#define RECORD_JSON_ADD(str)                        \
+    {                                               \
+        const char* toAdd = str;                    \
+        if (send) { bodyAppend(toAdd); }            \
+        jsonLength += strlen(toAdd);                \
+    }
+
+    RECORD_JSON_ADD(samplingFeatureTag)
+    RECORD_JSON_ADD(_baseLogger->getSamplingFeatureUUID())
+    RECORD_JSON_ADD(timestampTag)
+    RECORD_JSON_ADD(Logger::markedISO8601Time)
+    RECORD_JSON_ADD("\"")
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        if (!isValueSentAtI(i)) continue;
+        RECORD_JSON_ADD(",\"")
+        _baseLogger->formatVarUUIDAtI(i, tempBuffer, sizeof(tempBuffer));
+        RECORD_JSON_ADD(tempBuffer)
+        RECORD_JSON_ADD("\":")
+        formatSentValueAtI(i, tempBuffer, sizeof(tempBuffer));
+        RECORD_JSON_ADD(tempBuffer)
+    }
+    RECORD_JSON_ADD("}")
+#undef RECORD_JSON_ADD
+
+    return jsonLength;
+}
+
+
+// This adds to the JSON, through the compressor if it is in use
+void EnviroDIYPublisher::bodyAppend(const char* str) {
+#if defined(MS_GZIP_WINDOW_SIZE)
+    if (_gzipping) {
+        gzipWriter.write(str, strlen(str));
+        return;
+    }
+#endif
+    txBufferAppend(str);
+}
+
+
+// This makes the connection and sends either the current record or the
+// logger's backlog batch
+int16_t EnviroDIYPublisher::postRequest(Client* outClient, bool batch) {
     // Create a buffer for the portions of the request and response
     char     tempBuffer[37] = "";
-    uint16_t did_respond    = 0;
+    int16_t  responseCode   = 504;
 
-    MS_DBG(F("Outgoing JSON size:"), calculateJsonSize());
+    uint32_t jsonSize = batch ? writeBatchJson(false) : writeRecordJson(false);
+    MS_DBG(F("Outgoing JSON size:"), jsonSize);
+
+#if defined(MS_GZIP_WINDOW_SIZE)
+    // A server that turned down the last compressed request gets them plain
+    if (_lastCompressed && (_lastResult == 400 || _lastResult == 415)) {
+        PRINTOUT(F("Compressed request refused; sending uncompressed"));
+        _compressBody = false;
+    }
+    bool compress = _compressBody;
+    if (compress) {
+        // Compress the JSON once without sending it, to get its length
+        _gzipping = true;
+        gzipWriter.begin(nullptr);
+        if (batch) {
+            writeBatchJson(true);
+        } else {
+            writeRecordJson(true);
+        }
+        jsonSize  = gzipWriter.finish();
+        _gzipping = false;
+        MS_DBG(F("Compressed JSON size:"), jsonSize);
+    }
+#endif
 
     // Open a TCP/IP connection to the Enviro DIY Data Portal (WebSDL)
     MS_DBG(F("Connecting client"));
     MS_START_DEBUG_TIMER;
-    if (outClient->connect(enviroDIYHost, enviroDIYPort)) {
+    if (connectClient(outClient, enviroDIYHost, enviroDIYPort)) {
         MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
 
-        // copy the initial post header into the tx buffer
-        snprintf(txBuffer, sizeof(txBuffer), "%s", postHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", postEndpoint);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", HTTPtag);
+        // Build the request in the tx buffer, which is sent out to the client
+        // each time it fills
+        txBufferInit(outClient);
+        // The request line and the headers up to the content length, all
+        // rendered ahead of time
+        txBufferAppendPrefix();
 
         // add the rest of the HTTP POST headers to the outgoing buffer
-        // before adding each line/chunk to the outgoing buffer, we make sure
-        // there is space for that line, sending out buffer if not
-        if (bufferFree() < 28) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", hostHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", enviroDIYHost);
-
-        if (bufferFree() < 47) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tokenHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", _registrationToken);
-
-        if (bufferFree() < 26) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 contentLengthHeader);
-        itoa(calculateJsonSize(), tempBuffer, 10);  // BASE 10
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-
-        if (bufferFree() < 42) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", contentTypeHeader);
-
-        // put the start of the JSON into the outgoing response_buffer
-        if (bufferFree() < 21) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", samplingFeatureTag);
-
-        if (bufferFree() < 36) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 _baseLogger->getSamplingFeatureUUID());
-
-        if (bufferFree() < 42) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", timestampTag);
-        Logger::formatDateTime_ISO8601(Logger::markedLocalEpochTime)
-            .toCharArray(tempBuffer, 37);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-        txBuffer[strlen(txBuffer)] = '"';
-        txBuffer[strlen(txBuffer)] = ',';
-
-        for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
-            // Once the buffer fills, send it out
-            if (bufferFree() < 47) printTxBuffer(outClient);
-
-            txBuffer[strlen(txBuffer)] = '"';
-            _baseLogger->getVarUUIDAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            txBuffer[strlen(txBuffer)] = '"';
-            txBuffer[strlen(txBuffer)] = ':';
-            _baseLogger->getValueStringAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            if (i + 1 != _baseLogger->getArrayVarCount()) {
-                txBuffer[strlen(txBuffer)] = ',';
-            } else {
-                txBuffer[strlen(txBuffer)] = '}';
-            }
+        ltoa(jsonSize, tempBuffer, 10);  // BASE 10
+        txBufferAppend(tempBuffer);
+#if defined(MS_GZIP_WINDOW_SIZE)
+        if (compress) {
+            txBufferAppend(contentEncodingHeader);
+            // The compressed output goes straight into the tx buffer
+            _gzipping = true;
+            gzipWriter.begin(
+                static_cast<GzipWriter::outputFxn>(&txBufferAppend));
         }
+#endif
+        txBufferAppend(contentTypeHeader);
 
-        // Send out the finished request (or the last unsent section of it)
-        printTxBuffer(outClient, true);
-
-        // Wait 10 seconds for a response from the server
-        uint32_t start = millis();
-        while ((millis() - start) < 10000L && outClient->available() < 12) {
-            delay(10);
+        if (batch) {
+            writeBatchJson(true);
+        } else {
+            writeRecordJson(true);
         }
+#if defined(MS_GZIP_WINDOW_SIZE)
+        if (compress) {
+            gzipWriter.finish();
+            _gzipping = false;
+        }
+#endif
 
-        // Read only the first 12 characters of the response
-        // We're only reading as far as the http code, anything beyond that
-        // we don't care about.
-        did_respond = outClient->readBytes(tempBuffer, 12);
+        // Send out the finished request (or the last unsent section of it)
+        txBufferFlush(true);
 
-        // Close the TCP/IP connection
-        MS_DBG(F("Stopping client"));
-        MS_RESET_DEBUG_TIMER;
-        outClient->stop();
-        MS_DBG(F("Client stopped after"), MS_PRINT_DEBUG_TIMER, F("ms"));
+        // Read the response, or leave it to be read later, and close the
+        // connection unless it can be kept for the next request
+        responseCode = finishRequest(outClient);
     } else {
         PRINTOUT(F("\n -- Unable to Establish Connection to EnviroDIY Data "
                    "Portal --"));
     }
 
-    // Process the HTTP response
-    int16_t responseCode = 0;
-    if (did_respond > 0) {
-        char responseCode_char[4];
-        for (uint8_t i = 0; i < 3; i++) {
-            responseCode_char[i] = tempBuffer[i + 9];
-        }
-        responseCode = atoi(responseCode_char);
-    } else {
-        responseCode = 504;
+#if defined(MS_GZIP_WINDOW_SIZE)
+    _lastCompressed = compress;
+    // Send again right away if the compressed request was turned down
+    if (compress && (responseCode == 400 || responseCode == 415)) {
+        PRINTOUT(F("Compressed request refused; sending uncompressed"));
+        _compressBody = false;
+        return postRequest(outClient, batch);
     }
-
-    PRINTOUT(F("-- Response Code --"));
-    PRINTOUT(responseCode);
+#endif
 
     return responseCode;
 }
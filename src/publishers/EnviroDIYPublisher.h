@@ -24,6 +24,7 @@
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 #include "dataPublisherBase.h"
+#include "GzipWriter.h"
 
 
 // ============================================================================
@@ -51,11 +52,10 @@ class EnviroDIYPublisher : public dataPublisher {
      * logger.
      *
      * @param baseLogger The logger supplying the data to be published
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -72,11 +72,10 @@ class EnviroDIYPublisher : public dataPublisher {
      * @param inClient An Arduino client instance to use to print data to.
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -94,11 +93,10 @@ class EnviroDIYPublisher : public dataPublisher {
      * Monitor My Watershed data portal.
      * @param samplingFeatureUUID The sampling feature UUID for the site on the
      * Monitor My Watershed data portal.
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     EnviroDIYPublisher(Logger& baseLogger, const char* registrationToken,
                        const char* samplingFeatureUUID, uint8_t sendEveryX = 1,
@@ -114,11 +112,10 @@ class EnviroDIYPublisher : public dataPublisher {
      * Monitor My Watershed data portal.
      * @param samplingFeatureUUID The sampling feature UUID for the site on the
      * Monitor My Watershed data portal.
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     EnviroDIYPublisher(Logger& baseLogger, Client* inClient,
                        const char* registrationToken,
@@ -210,7 +207,94 @@ class EnviroDIYPublisher : public dataPublisher {
      */
     int16_t publishData(Client* outClient) override;
 
+    /**
+     * @brief Set the most backlogged records to send in a single request.
+     *
+     * Batched records are sent as one JSON object with an array of
+     * timestamps and an array of values for each variable UUID.  This only
+     * applies to records replayed from a backlog kept with
+     * dataPublisher::setBacklog().
+     *
+     * @param maxBatchRecords The most records per request; 1 to send each
+     * record in its own request.  Default is 1.
+     */
+    void setMaxBatchRecords(uint8_t maxBatchRecords) {
+        _maxBatchRecords = maxBatchRecords > 0 ? maxBatchRecords : 1;
+    }
+    /**
+     * @copydoc dataPublisher::getMaxBatchRecords()
+     */
+    uint8_t getMaxBatchRecords(void) override {
+        return _maxBatchRecords;
+    }
+    /**
+     * @brief Send all of the records in the logger's current backlog batch to
+     * Monitor My Watershed in one post request.
+     *
+     * @param outClient An Arduino client instance to use to print data to.
+     * @return **int16_t** The http status code of the response.
+     */
+    int16_t publishBatch(Client* outClient) override;
+
+#if defined(MS_GZIP_WINDOW_SIZE)
+    /**
+     * @brief Set whether to gzip the JSON of each post request.
+     *
+     * The compressed body is sent with a `Content-Encoding: gzip` header.  The
+     * repeated variable UUIDs of a batch of records compress very well.  If
+     * the server answers a compressed request with a 400 or a 415, the rest
+     * are sent uncompressed; a response that is read immediately is sent
+     * again uncompressed right away.
+     *
+     * This is only available when `MS_GZIP_WINDOW_SIZE` is defined.
+     *
+     * @param compress True to compress the requests.  Default is false.
+     */
+    void setCompression(bool compress) {
+        _compressBody = compress;
+    }
+#endif
+
  protected:
+    /**
+     * @brief Open the connection and post either the current record or the
+     * logger's backlog batch.
+     *
+     * @param outClient An Arduino client instance to use to print data to.
+     * @param batch True to send the logger's backlog batch
+     * @return **int16_t** The http status code of the response.
+     */
+    int16_t postRequest(Client* outClient, bool batch);
+    /**
+     * @brief Add the JSON for the logger's backlog batch to the TX buffer, or
+     * just calculate its length.
+     *
+     * @param send True to add the JSON to the TX buffer; false to only return
+     * its length.
+     * @return **uint32_t** The number of characters in the JSON
+     */
+    uint32_t writeBatchJson(bool send);
+    /**
+     * @brief Add the JSON for the current record to the TX buffer, or just
+     * calculate its length.
+     *
+     * @param send True to add the JSON to the TX buffer; false to only return
+     * its length.
+     * @return **uint32_t** The number of characters in the JSON
+     */
+    uint32_t writeRecordJson(bool send);
+    /**
+     * @brief Add part of the JSON to the request: through the compressor when
+     * compressing, or straight to the TX buffer.
+     *
+     * @param str The part of the JSON to add
+     */
+    void bodyAppend(const char* str);
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+
     /**
      * @anchor envirodiy_post_vars
      * @name Portions of the POST request to EnviroDIY
@@ -225,6 +309,9 @@ class EnviroDIYPublisher : public dataPublisher {
     // static const char *connectionHeader;  ///< The keep alive header text
     static const char* contentLengthHeader;  ///< The content length header text
     static const char* contentTypeHeader;    ///< The content type header text
+#if defined(MS_GZIP_WINDOW_SIZE)
+    static const char* contentEncodingHeader;  ///< The content encoding header
+#endif
     /**@}*/
 
     /**
@@ -235,11 +322,24 @@ class EnviroDIYPublisher : public dataPublisher {
      */
     static const char* samplingFeatureTag;  ///< The JSON feature UUID tag
     static const char* timestampTag;        ///< The JSON feature timestamp tag
+    static const char* timestampArrayTag;   ///< The JSON timestamp array tag
                                             /**@}*/
 
  private:
     // Tokens and UUID's for EnviroDIY
     const char* _registrationToken = nullptr;
+    // The most backlogged records to send in one request
+    uint8_t _maxBatchRecords = 1;
+#if defined(MS_GZIP_WINDOW_SIZE)
+    // The compressor, shared like the TX buffer it writes to
+    static GzipWriter gzipWriter;
+    // Whether to compress the requests
+    bool _compressBody = false;
+    // Whether the JSON is going through the compressor
+    bool _gzipping = false;
+    // Whether the last request sent was compressed
+    bool _lastCompressed = false;
+#endif
 };
 
 #endif  // SRC_PUBLISHERS_ENVIRODIYPUBLISHER_H_
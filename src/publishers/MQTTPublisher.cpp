@@ -0,0 +1,342 @@
+/**
+ * @file MQTTPublisher.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the MQTTPublisher class.
+ */
+
+#include "MQTTPublisher.h"
+
+
+// ============================================================================
+//  Functions for a generic MQTT broker
+// ============================================================================
+
+// Constructors
+MQTTPublisher::MQTTPublisher() : dataPublisher() {}
+MQTTPublisher::MQTTPublisher(Logger& baseLogger, uint8_t sendEveryX,
+                             uint8_t sendOffset)
+    : dataPublisher(baseLogger, sendEveryX, sendOffset) {}
+MQTTPublisher::MQTTPublisher(Logger& baseLogger, Client* inClient,
+                             uint8_t sendEveryX, uint8_t sendOffset)
+    : dataPublisher(baseLogger, inClient, sendEveryX, sendOffset) {}
+MQTTPublisher::MQTTPublisher(Logger& baseLogger, Client* inClient,
+                             const char* brokerHost, uint16_t brokerPort,
+                             const char* topicTemplate, uint8_t sendEveryX,
+                             uint8_t sendOffset)
+    : dataPublisher(baseLogger, inClient, sendEveryX, sendOffset) {
+    setBroker(brokerHost, brokerPort);
+    setTopic(topicTemplate);
+}
+// Destructor
+MQTTPublisher::~MQTTPublisher() {}
+
+
+void MQTTPublisher::setBroker(const char* brokerHost, uint16_t brokerPort) {
+    _brokerHost = brokerHost;
+    _brokerPort = brokerPort;
+}
+
+
+void MQTTPublisher::setCredentials(const char* clientID, const char* userName,
+                                   const char* password) {
+    _clientID = clientID;
+    _userName = userName;
+    _password = password;
+}
+
+
+void MQTTPublisher::setTopic(const char* topicTemplate) {
+    _topicTemplate = topicTemplate;
+}
+
+
+void MQTTPublisher::setQoS(uint8_t qos, bool retained) {
+    _qos      = qos > 0 ? 1 : 0;
+    _retained = retained;
+}
+
+
+void MQTTPublisher::setKeepSession(bool keepSession,
+                                   uint16_t keepAliveSeconds) {
+    _keepSession = keepSession;
+    _mqttClient.setKeepAlive(keepAliveSeconds);
+}
+
+
+// A way to begin with everything already set
+void MQTTPublisher::begin(Logger& baseLogger, Client* inClient,
+                          const char* brokerHost, uint16_t brokerPort,
+                          const char* topicTemplate) {
+    setBroker(brokerHost, brokerPort);
+    setTopic(topicTemplate);
+    dataPublisher::begin(baseLogger, inClient);
+}
+void MQTTPublisher::begin(Logger& baseLogger, const char* brokerHost,
+                          uint16_t brokerPort, const char* topicTemplate) {
+    setBroker(brokerHost, brokerPort);
+    setTopic(topicTemplate);
+    dataPublisher::begin(baseLogger);
+}
+
+
+// This connects to the broker, unless already connected on the same client
+bool MQTTPublisher::connectBroker(Client* outClient) {
+    // Count the bytes of the coming messages for this publisher
+    txBufferPublisher = this;
+    if (_sessionClient == outClient && _mqttClient.connected()) {
+        MS_DBG(F("Reusing the open MQTT connection"));
+        _lastConnectTime = 0;
+        return true;
+    }
+    disconnectBroker();
+
+    // Set the client connection parameters
+    _mqttClient.setClient(*outClient);
+    _mqttClient.setServer(_brokerHost, _brokerPort);
+
+    // Make sure any previous TCP connections are closed
+    // NOTE:  The PubSubClient library used for MQTT connect assumes that as
+    // long as the client is connected, it must be connected to the right place.
+    closeConnection();
+    if (outClient->connected()) { outClient->stop(); }
+
+    const char* clientID = _clientID != nullptr ? _clientID
+                                                : _baseLogger->getLoggerID();
+    MS_DBG(F("Opening MQTT Connection to"), _brokerHost, F("as"), clientID);
+    uint32_t start = millis();
+    if (!_mqttClient.connect(clientID, _userName, _password)) {
+        PRINTOUT(F("MQTT connection failed with state:"),
+                 parseMQTTState(_mqttClient.state()));
+        return false;
+    }
+    _lastConnectTime = millis() - start;
+    MS_DBG(F("MQTT connected after"), _lastConnectTime, F("ms"));
+    _sessionClient = outClient;
+    _pendingAcks   = 0;
+    return true;
+}
+
+
+// This closes the MQTT connection
+void MQTTPublisher::disconnectBroker(void) {
+    if (_sessionClient == nullptr) return;
+    MS_DBG(F("Disconnecting from MQTT"));
+    _mqttClient.disconnect();
+    _sessionClient = nullptr;
+}
+
+
+// This fills in the topic template
+size_t MQTTPublisher::buildTopic(char* buffer, size_t bufferLen) {
+    size_t      len = 0;
+    const char* in  = _topicTemplate != nullptr ? _topicTemplate : "";
+    while (*in != '\0' && len + 1 < bufferLen) {
+        const char* value = nullptr;
+        if (strncmp(in, "{logger}", 8) == 0) {
+            value = _baseLogger->getLoggerID();
+            in += 8;
+        } else if (strncmp(in, "{feature}", 9) == 0) {
+            value = _baseLogger->getSamplingFeatureUUID();
+            in += 9;
+        }
+        if (value == nullptr) {
+            buffer[len++] = *in++;
+        } else {
+            while (*value != '\0' && len + 1 < bufferLen) {
+                buffer[len++] = *value++;
+            }
+        }
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+
+// This writes the message for a record to the TX buffer or counts it
+uint32_t MQTTPublisher::writePayload(bool send, int16_t record_k) {
+    // Big enough for any formatted value or the timestamp
+    char     tempBuffer[MS_ISO8601_BUFFER_SIZE + 11];
+    uint32_t payloadLength = 0;
+    uint8_t  nVars         = getSentVarCount();
+    bool     json          = _payloadFormat == mqttJSON;
+
+    // Add a string to the outgoing buffer or just count it
+#define MQTT_PAYLOAD_ADD(str)                \
+    {                                        \
+        const char* toAdd = str;             \
+        if (send) { txBufferAppend(toAdd); } \
+        payloadLength += strlen(toAdd);      \
+    }
+
+    if (record_k < 0) {
+        snprintf(tempBuffer, sizeof(tempBuffer), "%s",
+                 Logger::markedISO8601Time);
+    } else {
+        Logger::formatDateTime_ISO8601(_baseLogger->getBatchTime(record_k),
+                                       tempBuffer, sizeof(tempBuffer));
+    }
+    if (json) MQTT_PAYLOAD_ADD("{\"timestamp\":\"")
+    MQTT_PAYLOAD_ADD(tempBuffer)
+    if (json) MQTT_PAYLOAD_ADD("\"")
+    for (uint8_t n = 0; n < nVars; n++) {
+        uint8_t i = getSentVarPosition(n);
+        MQTT_PAYLOAD_ADD(",")
+        if (json) {
+            _baseLogger->formatVarCodeAtI(i, tempBuffer, sizeof(tempBuffer));
+            MQTT_PAYLOAD_ADD("\"")
+            MQTT_PAYLOAD_ADD(tempBuffer)
+            MQTT_PAYLOAD_ADD("\":")
+        }
+        if (record_k < 0) {
+            formatSentValueAtI(i, tempBuffer, sizeof(tempBuffer));
+        } else {
+            _baseLogger->formatBatchValueAtI(record_k, i, tempBuffer,
+                                             sizeof(tempBuffer));
+        }
+        MQTT_PAYLOAD_ADD(tempBuffer)
+    }
+    if (json) MQTT_PAYLOAD_ADD("}")
+#undef MQTT_PAYLOAD_ADD
+
+    return payloadLength;
+}
+
+
+// This writes a whole MQTT PUBLISH packet for a record
+bool MQTTPublisher::publishRecord(Client* outClient, const char* topic,
+                                  int16_t record_k) {
+    uint16_t topicLen      = strlen(topic);
+    uint32_t payloadLength = writePayload(false, record_k);
+    uint32_t remaining     = 2 + topicLen + (_qos > 0 ? 2 : 0) + payloadLength;
+
+    // The packet is streamed out through the TX buffer as it fills
+    txBufferInit(outClient);
+    // Fixed header: the packet type and flags, then the remaining length
+    txBufferAppend(static_cast<char>(0x30 | (_qos << 1) | (_retained ? 1 : 0)));
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        if (remaining > 0) digit |= 0x80;
+        txBufferAppend(static_cast<char>(digit));
+    } while (remaining > 0);
+    // Variable header: the topic and, for QoS 1, the packet ID
+    txBufferAppend(static_cast<char>(topicLen >> 8));
+    txBufferAppend(static_cast<char>(topicLen & 0xFF));
+    txBufferAppend(topic);
+    if (_qos > 0) {
+        if (_pendingAcks == 0) _firstUnacked = _nextPacketID;
+        txBufferAppend(static_cast<char>(_nextPacketID >> 8));
+        txBufferAppend(static_cast<char>(_nextPacketID & 0xFF));
+        _pendingAcks++;
+        // Packet ID 0 is not allowed
+        if (++_nextPacketID == 0) _nextPacketID = 1;
+    }
+    writePayload(true, record_k);
+    txBufferFlush();
+    return outClient->connected();
+}
+
+
+// This reads packets from the broker until all of the PUBACKs are in
+bool MQTTPublisher::waitForAcks(Client* outClient) {
+    uint32_t start = millis();
+    while (_pendingAcks > 0 && millis() - start < _responseTimeoutMax) {
+        if (outClient->available() < 2) {
+            if (!outClient->connected()) break;
+            delay(10);
+            continue;
+        }
+        uint8_t  packetType = outClient->read();
+        uint32_t length     = 0;
+        uint8_t  shift      = 0;
+        int      digit;
+        do {
+            while (outClient->available() < 1 &&
+                   millis() - start < _responseTimeoutMax) {
+                delay(2);
+            }
+            digit = outClient->read();
+            if (digit < 0) break;
+            length |= static_cast<uint32_t>(digit & 0x7F) << shift;
+            shift += 7;
+        } while ((digit & 0x80) && shift < 28);
+        uint8_t  body[2]  = {0, 0};
+        uint32_t bodyRead = 0;
+        while (bodyRead < length && millis() - start < _responseTimeoutMax) {
+            if (outClient->available() < 1) {
+                delay(2);
+                continue;
+            }
+            int b = outClient->read();
+            if (bodyRead < 2) body[bodyRead] = b;
+            bodyRead++;
+        }
+        // Count every PUBACK for a packet sent since the last wait
+        uint16_t packetID = (body[0] << 8) | body[1];
+        if ((packetType & 0xF0) == 0x40 && length == 2 &&
+            static_cast<uint16_t>(packetID - _firstUnacked) < _pendingAcks) {
+            _pendingAcks--;
+        }
+    }
+    if (_pendingAcks > 0) {
+        PRINTOUT(F("The broker did not acknowledge"), _pendingAcks,
+                 F("messages"));
+        _pendingAcks      = 0;
+        _lastResponseTime = -1;
+        return false;
+    }
+    _lastResponseTime = millis() - start;
+    return true;
+}
+
+
+// This sends the current record to the broker
+int16_t MQTTPublisher::publishData(Client* outClient) {
+    char topicBuffer[MQTT_TOPIC_BUFFER_SIZE];
+    buildTopic(topicBuffer, sizeof(topicBuffer));
+    MS_DBG(F("Topic ["), strlen(topicBuffer), F("]:"), topicBuffer);
+
+    if (!connectBroker(outClient)) return 0;
+    bool success = publishRecord(outClient, topicBuffer, -1);
+    if (success && _qos > 0) success = waitForAcks(outClient);
+    if (!success) {
+        PRINTOUT(F("MQTT publish failed with state:"),
+                 parseMQTTState(_mqttClient.state()));
+        disconnectBroker();
+        return 0;
+    }
+    PRINTOUT(F("MQTT topic published!"));
+    return 1;
+}
+
+
+// This sends each record of a backlog batch before waiting for the acks
+int16_t MQTTPublisher::publishBatch(Client* outClient) {
+    char topicBuffer[MQTT_TOPIC_BUFFER_SIZE];
+    buildTopic(topicBuffer, sizeof(topicBuffer));
+
+    if (!connectBroker(outClient)) return 0;
+    bool    success  = true;
+    uint8_t nRecords = _baseLogger->getBatchCount();
+    for (uint8_t k = 0; k < nRecords && success; k++) {
+        success = publishRecord(outClient, topicBuffer, k);
+    }
+    if (success && _qos > 0) success = waitForAcks(outClient);
+    if (!success) {
+        PRINTOUT(F("MQTT batch publish failed with state:"),
+                 parseMQTTState(_mqttClient.state()));
+        disconnectBroker();
+        return 0;
+    }
+    MS_DBG(nRecords, F("backlogged records published"));
+    return 1;
+}
+
+
+// This closes the connection at the end of the interval, unless it is kept
+void MQTTPublisher::endPublishing(void) {
+    if (!_keepSession) disconnectBroker();
+}
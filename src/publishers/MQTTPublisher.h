@@ -0,0 +1,318 @@
+/**
+ * @file MQTTPublisher.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the MQTTPublisher subclass of dataPublisher for publishing
+ * data to any MQTT broker.
+ */
+
+// Header Guards
+#ifndef SRC_PUBLISHERS_MQTTPUBLISHER_H_
+#define SRC_PUBLISHERS_MQTTPUBLISHER_H_
+
+// Debugging Statement
+// #define MS_MQTTPUBLISHER_DEBUG
+
+#ifdef MS_MQTTPUBLISHER_DEBUG
+#define MS_DEBUGGING_STD "MQTTPublisher"
+#endif
+
+#ifndef MQTT_TOPIC_BUFFER_SIZE
+/**
+ * @brief The size of the buffer for the topic, after the placeholders in the
+ * topic template are filled in.
+ */
+#define MQTT_TOPIC_BUFFER_SIZE 96
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "dataPublisherBase.h"
+#include "PubSubClient.h"
+
+
+// ============================================================================
+//  Functions for a generic MQTT broker
+// ============================================================================
+/**
+ * @brief The MQTTPublisher subclass of dataPublisher for publishing data to
+ * any MQTT broker.
+ *
+ * Each record is published as one message, on a topic made from a template.
+ * In the template, `{logger}` is replaced with the logger ID and `{feature}`
+ * with the sampling feature UUID; for example `"stations/{logger}/data"`.
+ *
+ * The message is either a JSON object with the ISO-8601 timestamp and each
+ * value keyed by its variable code:
+ * `{"timestamp":"2022-01-01T12:00:00-05:00","SonarRange":1234,...}`
+ * or a CSV line of the timestamp and the values.
+ *
+ * The MQTT connection is kept open for all of the records and backlogged
+ * records sent in one call to Logger::publishDataToRemotes(), and optionally
+ * between logging intervals.  Messages are published with QoS 0 or QoS 1; with
+ * QoS 1 a record only counts as sent once the broker acknowledges it.
+ * Messages are streamed out as they are written, so they are not limited by
+ * the size of the transmit buffer.
+ *
+ * @ingroup the_publishers
+ */
+class MQTTPublisher : public dataPublisher {
+ public:
+    /**
+     * @brief The formats a record can be published in.
+     */
+    typedef enum {
+        mqttJSON = 0,  ///< A JSON object keyed by variable code
+        mqttCSV        ///< A CSV line of the timestamp and the values
+    } payloadFormat;
+
+    // Constructors
+    /**
+     * @brief Construct a new MQTT Publisher object with no members
+     * initialized.
+     */
+    MQTTPublisher();
+    /**
+     * @brief Construct a new MQTT Publisher object
+     *
+     * @note If a client is never specified, the publisher will attempt to
+     * create and use a client on a LoggerModem instance tied to the attached
+     * logger.
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     *
+     * @note It is possible (though very unlikey) that using this constructor
+     * could cause errors if the compiler attempts to initialize the publisher
+     * instance before the logger instance.  If you suspect you are seeing that
+     * issue, use the null constructor and a populated begin(...) within your
+     * set-up function.
+     */
+    explicit MQTTPublisher(Logger& baseLogger, uint8_t sendEveryX = 1,
+                           uint8_t sendOffset = 0);
+    /**
+     * @brief Construct a new MQTT Publisher object
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param inClient An Arduino client instance to use to print data to.
+     * Allows the use of any type of client and multiple clients tied to a
+     * single TinyGSM modem instance
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     *
+     * @note It is possible (though very unlikey) that using this constructor
+     * could cause errors if the compiler attempts to initialize the publisher
+     * instance before the logger instance.  If you suspect you are seeing that
+     * issue, use the null constructor and a populated begin(...) within your
+     * set-up function.
+     */
+    MQTTPublisher(Logger& baseLogger, Client* inClient, uint8_t sendEveryX = 1,
+                  uint8_t sendOffset = 0);
+    /**
+     * @brief Construct a new MQTT Publisher object
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param inClient An Arduino client instance to use to print data to.
+     * Allows the use of any type of client and multiple clients tied to a
+     * single TinyGSM modem instance
+     * @param brokerHost The host name of the MQTT broker
+     * @param brokerPort The port of the MQTT broker
+     * @param topicTemplate The template for the topic to publish to
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    MQTTPublisher(Logger& baseLogger, Client* inClient, const char* brokerHost,
+                  uint16_t brokerPort, const char* topicTemplate,
+                  uint8_t sendEveryX = 1, uint8_t sendOffset = 0);
+    /**
+     * @brief Destroy the MQTT Publisher object
+     */
+    virtual ~MQTTPublisher();
+
+    // Returns the data destination
+    String getEndpoint(void) override {
+        return String(_brokerHost);
+    }
+
+    /**
+     * @brief Set the MQTT broker to publish to.
+     *
+     * @param brokerHost The host name of the MQTT broker
+     * @param brokerPort The port of the MQTT broker.  Default is 1883.
+     */
+    void setBroker(const char* brokerHost, uint16_t brokerPort = 1883);
+    /**
+     * @brief Set the client ID and the credentials to connect to the broker
+     * with.
+     *
+     * @param clientID The MQTT client ID.  If this is a nullptr, the logger ID
+     * is used.
+     * @param userName The MQTT user name, or a nullptr for none
+     * @param password The MQTT password, or a nullptr for none
+     */
+    void setCredentials(const char* clientID, const char* userName = nullptr,
+                        const char* password = nullptr);
+    /**
+     * @brief Set the template for the topic to publish to.
+     *
+     * @param topicTemplate The topic template.  `{logger}` is replaced with
+     * the logger ID and `{feature}` with the sampling feature UUID.
+     */
+    void setTopic(const char* topicTemplate);
+    /**
+     * @brief Set the format of the published messages.
+     *
+     * @param format The payload format.  Default is mqttJSON.
+     */
+    void setPayloadFormat(payloadFormat format) {
+        _payloadFormat = format;
+    }
+    /**
+     * @brief Set the quality of service level and whether messages are
+     * retained by the broker.
+     *
+     * With QoS 1, each record is only reported as sent after the broker
+     * acknowledges it, so unacknowledged records can be kept in the backlog.
+     *
+     * @param qos The MQTT QoS level, 0 or 1.  Default is 0.
+     * @param retained True to ask the broker to keep the last message on the
+     * topic.  Default is false.
+     */
+    void setQoS(uint8_t qos, bool retained = false);
+    /**
+     * @brief Set whether the MQTT connection is kept open between logging
+     * intervals.
+     *
+     * By default the connection is closed at the end of each call to
+     * Logger::publishDataToRemotes().  Keeping it open only saves a
+     * reconnection when the modem also stays connected between intervals.
+     * The broker will close the connection if no message arrives within one
+     * and a half times the keep-alive, so that must be longer than the
+     * logging interval.
+     *
+     * @param keepSession True to leave the connection open between intervals
+     * @param keepAliveSeconds The MQTT keep-alive to ask the broker for, in
+     * seconds.  Default is 15, the PubSubClient default.
+     */
+    void setKeepSession(bool keepSession, uint16_t keepAliveSeconds = 15);
+    /**
+     * @brief Set the most backlogged records to publish before waiting for
+     * the broker's acknowledgements.
+     *
+     * Each record is still its own message.
+     *
+     * @param maxRecords The most records per batch.  Default is 1.
+     */
+    void setMaxBatchRecords(uint8_t maxRecords) {
+        _maxBatchRecords = maxRecords;
+    }
+    uint8_t getMaxBatchRecords(void) override {
+        return _maxBatchRecords;
+    }
+
+    // A way to begin with everything already set
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger, Client* inClient)
+     * @param brokerHost The host name of the MQTT broker
+     * @param brokerPort The port of the MQTT broker
+     * @param topicTemplate The template for the topic to publish to
+     */
+    void begin(Logger& baseLogger, Client* inClient, const char* brokerHost,
+               uint16_t brokerPort, const char* topicTemplate);
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger)
+     * @param brokerHost The host name of the MQTT broker
+     * @param brokerPort The port of the MQTT broker
+     * @param topicTemplate The template for the topic to publish to
+     */
+    void begin(Logger& baseLogger, const char* brokerHost, uint16_t brokerPort,
+               const char* topicTemplate);
+
+    // This sends the data to the broker
+    int16_t publishData(Client* outClient) override;
+    // This sends a batch of backlogged records to the broker
+    int16_t publishBatch(Client* outClient) override;
+    // This closes the MQTT connection, unless it is kept between intervals
+    void endPublishing(void) override;
+
+ protected:
+    /**
+     * @brief Connect to the broker, unless the connection is already open.
+     *
+     * @param outClient The client to connect with
+     * @return **bool** True if connected to the broker
+     */
+    bool connectBroker(Client* outClient);
+    /**
+     * @brief Close the MQTT connection.
+     */
+    void disconnectBroker(void);
+    /**
+     * @brief Fill in the placeholders of the topic template.
+     *
+     * @param buffer The buffer to write the topic into
+     * @param bufferLen The size of the buffer
+     * @return **size_t** The length of the topic
+     */
+    size_t buildTopic(char* buffer, size_t bufferLen);
+    /**
+     * @brief Write the message for a record, or just count its length.
+     *
+     * @param send True to add the message to the TX buffer; false to only
+     * count it
+     * @param record_k The position of the record in the backlog batch, or -1
+     * for the current record
+     * @return **uint32_t** The length of the message
+     */
+    uint32_t writePayload(bool send, int16_t record_k);
+    /**
+     * @brief Publish one record as an MQTT message.
+     *
+     * @param outClient The client connected to the broker
+     * @param topic The topic to publish to
+     * @param record_k The position of the record in the backlog batch, or -1
+     * for the current record
+     * @return **bool** True if the whole message was written
+     */
+    bool publishRecord(Client* outClient, const char* topic, int16_t record_k);
+    /**
+     * @brief Wait for the broker to acknowledge the QoS 1 messages sent since
+     * the last call.
+     *
+     * @param outClient The client connected to the broker
+     * @return **bool** True if every message was acknowledged
+     */
+    bool waitForAcks(Client* outClient);
+
+ private:
+    const char*   _brokerHost      = nullptr;
+    uint16_t      _brokerPort      = 1883;
+    const char*   _clientID        = nullptr;
+    const char*   _userName        = nullptr;
+    const char*   _password        = nullptr;
+    const char*   _topicTemplate   = nullptr;
+    payloadFormat _payloadFormat   = mqttJSON;
+    uint8_t       _qos             = 0;
+    bool          _retained        = false;
+    bool          _keepSession     = false;
+    uint8_t       _maxBatchRecords = 1;
+    // The client the open MQTT connection is on
+    Client* _sessionClient = nullptr;
+    // The QoS 1 packet IDs waiting for an acknowledgement
+    uint16_t _nextPacketID  = 1;
+    uint16_t _firstUnacked  = 1;
+    uint8_t  _pendingAcks   = 0;
+    PubSubClient _mqttClient;
+};
+
+#endif  // SRC_PUBLISHERS_MQTTPUBLISHER_H_
@@ -0,0 +1,88 @@
+/**
+ * @file NodeLinkPublisher.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the NodeLinkPublisher class.
+ */
+
+#include "NodeLinkPublisher.h"
+
+
+// ============================================================================
+//  Functions for sending records to a gateway logger over a local radio
+// ============================================================================
+
+// Constructors
+NodeLinkPublisher::NodeLinkPublisher() : dataPublisher() {}
+NodeLinkPublisher::NodeLinkPublisher(Logger& baseLogger, NodeLink* link,
+                                     uint8_t nodeID, uint8_t sendEveryX,
+                                     uint8_t sendOffset)
+    : dataPublisher(baseLogger, sendEveryX, sendOffset),
+      _link(link),
+      _nodeID(nodeID) {}
+// Destructor
+NodeLinkPublisher::~NodeLinkPublisher() {}
+
+
+// A way to begin with everything already set
+void NodeLinkPublisher::begin(Logger& baseLogger, NodeLink* link,
+                              uint8_t nodeID) {
+    _link   = link;
+    _nodeID = nodeID;
+    dataPublisher::begin(baseLogger);
+}
+
+
+// The values are read back from the formatted record, so a record loaded from
+// the backlog is sent the same way as the live one
+int16_t NodeLinkPublisher::publishData(void) {
+    if (_link == nullptr) {
+        PRINTOUT(F("ERROR! No node link assigned to publish data!"));
+        return 0;
+    }
+    uint8_t nVars = getSentVarCount();
+    if (sizeof(uint32_t) + nVars * sizeof(float) > MS_NODE_LINK_MAX_PAYLOAD) {
+        PRINTOUT(F("Record of"), nVars,
+                 F("variables is too big for a node link frame!"));
+        return 413;
+    }
+    uint8_t payload[MS_NODE_LINK_MAX_PAYLOAD];
+    uint8_t length = 0;
+    memcpy(payload, &Logger::markedUTCEpochTime, sizeof(uint32_t));
+    length += sizeof(uint32_t);
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    for (uint8_t n = 0; n < nVars; n++) {
+        formatSentValueAtI(getSentVarPosition(n), valueBuffer,
+                           sizeof(valueBuffer));
+        float value = atof(valueBuffer);
+        memcpy(payload + length, &value, sizeof(float));
+        length += sizeof(float);
+    }
+
+    uint32_t sentAt   = millis();
+    int16_t  response = _link->sendRecord(_nodeID, payload, length,
+                                          _ackTimeout_ms);
+    // The frame adds two sync bytes, three head bytes, and the CRC
+    _bytesSent += length + 7;
+    _totalBytesSent += length + 7;
+    _lastResponseTime = response == 504 ? -1 : millis() - sentAt;
+
+    // Only a gateway that knows its clock to the millisecond is followed
+    uint32_t gatewayTime;
+    uint16_t gatewayMs;
+    if (response == 201 && _clockDiscipline &&
+        _link->getLinkTime(gatewayTime, gatewayMs)) {
+        _baseLogger->setRTClockPhase(gatewayTime, gatewayMs);
+    }
+
+    PRINTOUT(F("-- Response Code --"));
+    PRINTOUT(response);
+
+    return response;
+}
+int16_t NodeLinkPublisher::publishData(Client* outClient) {
+    (void)outClient;
+    return publishData();
+}
@@ -0,0 +1,132 @@
+/**
+ * @file NodeLinkPublisher.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the NodeLinkPublisher subclass of dataPublisher for sending
+ * records from a node logger to a gateway logger over a local radio.
+ */
+
+// Header Guards
+#ifndef SRC_PUBLISHERS_NODELINKPUBLISHER_H_
+#define SRC_PUBLISHERS_NODELINKPUBLISHER_H_
+
+// Debugging Statement
+// #define MS_NODELINKPUBLISHER_DEBUG
+
+#ifdef MS_NODELINKPUBLISHER_DEBUG
+#define MS_DEBUGGING_STD "NodeLinkPublisher"
+#endif
+
+/**
+ * @brief The default time to wait for the gateway to answer a record, in
+ * milliseconds.
+ */
+#define NODE_LINK_ACK_TIMEOUT_MS 2000
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "dataPublisherBase.h"
+#include "NodeLink.h"
+
+
+// ============================================================================
+//  Functions for sending records to a gateway logger over a local radio
+// ============================================================================
+/**
+ * @brief The NodeLinkPublisher subclass of dataPublisher for sending each
+ * record of a node logger over a [local radio](@ref modem_node_link) to a
+ * gateway logger.
+ *
+ * Each record is sent as a single frame with the UTC epoch time and one four
+ * byte float per variable sent, which the gateway takes into its own records
+ * with a NodeRelay sensor.  Attach a NodeLinkModem for the radio to the
+ * logger, so the radio is woken to send.
+ *
+ * The gateway takes one record from each node per interval, so log the nodes
+ * on the same interval as the gateway and send every record.  A record the
+ * gateway doesn't answer gives a 504, and one it already has a record for
+ * gives a 429; both are kept in the backlog, if there is one, and sent again
+ * on the next interval.  The gateway's answer carries its clock to the
+ * millisecond, and unless setClockDiscipline() turns it off the node sets
+ * its own clock from it with Logger::setRTClockPhase(), so the node wakes and
+ * measures in step with the gateway without a network time of its own.
+ *
+ * @ingroup the_publishers
+ */
+class NodeLinkPublisher : public dataPublisher {
+ public:
+    // Constructors
+    /**
+     * @brief Construct a new node link publisher object with no members
+     * initialized.
+     */
+    NodeLinkPublisher();
+    /**
+     * @brief Construct a new node link publisher object
+     *
+     * @param baseLogger The logger supplying the data to be published
+     * @param link The node link run over the radio
+     * @param nodeID The ID of this node, unique among the nodes of the
+     * gateway
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    NodeLinkPublisher(Logger& baseLogger, NodeLink* link, uint8_t nodeID,
+                      uint8_t sendEveryX = 1, uint8_t sendOffset = 0);
+    /**
+     * @brief Destroy the node link publisher object
+     */
+    virtual ~NodeLinkPublisher();
+
+    // Returns the data destination
+    String getEndpoint(void) override {
+        return String(F("node link gateway"));
+    }
+
+    /**
+     * @brief Set how long to wait for the gateway to answer each record.
+     *
+     * @param timeout_ms The time to wait in milliseconds.  Default is
+     * #NODE_LINK_ACK_TIMEOUT_MS.
+     */
+    void setAckTimeout(uint32_t timeout_ms) {
+        _ackTimeout_ms = timeout_ms;
+    }
+
+    /**
+     * @brief Set whether to set the node's clock from each answer of the
+     * gateway.
+     *
+     * @param discipline True to set the clock from the gateway.  Default is
+     * true.
+     */
+    void setClockDiscipline(bool discipline) {
+        _clockDiscipline = discipline;
+    }
+
+    // A way to begin with everything already set
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger)
+     * @param link The node link run over the radio
+     * @param nodeID The ID of this node
+     */
+    void begin(Logger& baseLogger, NodeLink* link, uint8_t nodeID);
+
+    // This sends the current record
+    int16_t publishData(Client* outClient) override;
+    // This sends the current record without needing a client
+    int16_t publishData(void) override;
+
+ private:
+    NodeLink* _link            = nullptr;
+    uint8_t   _nodeID          = 0;
+    uint32_t  _ackTimeout_ms   = NODE_LINK_ACK_TIMEOUT_MS;
+    bool      _clockDiscipline = true;
+};
+
+#endif  // SRC_PUBLISHERS_NODELINKPUBLISHER_H_
@@ -0,0 +1,193 @@
+/**
+ * @file RemoteConfigPublisher.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the RemoteConfigPublisher class.
+ */
+
+#include "RemoteConfigPublisher.h"
+
+
+// ============================================================================
+//  Functions for fetching the logger's settings
+// ============================================================================
+
+// Constructors
+RemoteConfigPublisher::RemoteConfigPublisher() : dataPublisher() {}
+RemoteConfigPublisher::RemoteConfigPublisher(Logger& baseLogger,
+                                             uint8_t sendEveryX,
+                                             uint8_t sendOffset)
+    : dataPublisher(baseLogger, sendEveryX, sendOffset) {
+    baseLogger.setSettingsCache(true);
+}
+RemoteConfigPublisher::RemoteConfigPublisher(Logger& baseLogger,
+                                             Client* inClient,
+                                             const char* host, uint16_t port,
+                                             const char* path,
+                                             uint8_t sendEveryX,
+                                             uint8_t sendOffset)
+    : dataPublisher(baseLogger, inClient, sendEveryX, sendOffset) {
+    baseLogger.setSettingsCache(true);
+    setServer(host, port, path);
+}
+// Destructor
+RemoteConfigPublisher::~RemoteConfigPublisher() {}
+
+
+void RemoteConfigPublisher::setServer(const char* host, uint16_t port,
+                                      const char* path) {
+    _host = host;
+    _port = port;
+    _path = path;
+    clearRequestPrefix();
+}
+
+
+// A way to begin with everything already set
+void RemoteConfigPublisher::begin(Logger& baseLogger, Client* inClient,
+                                  const char* host, uint16_t port,
+                                  const char* path) {
+    setServer(host, port, path);
+    baseLogger.setSettingsCache(true);
+    dataPublisher::begin(baseLogger, inClient);
+}
+
+
+// The request line and host header only change with the server
+uint8_t RemoteConfigPublisher::getRequestPrefixParts(const char* parts[]) {
+    parts[0] = getHeader;
+    parts[1] = _path;
+    parts[2] = HTTPtag;
+    parts[3] = hostHeader;
+    parts[4] = _host;
+    return 5;
+}
+
+
+// Only a body whose length is given up front, and that fits, is kept
+bool RemoteConfigPublisher::readSettings(Client* outClient, bool hasBody,
+                                         char* etag, char* settings) {
+    char     line[MS_SETTINGS_ETAG_SIZE + 8];
+    uint8_t  lineLen       = 0;
+    bool     headersDone   = false;
+    bool     keepOpen      = true;
+    int32_t  contentLength = -1;
+    uint32_t start         = millis();
+    etag[0]                = '\0';
+    settings[0]            = '\0';
+    while (!headersDone && millis() - start < 5000L) {
+        if (!outClient->available()) {
+            if (!outClient->connected()) return false;
+            delay(2);
+            continue;
+        }
+        char c = outClient->read();
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (lineLen < sizeof(line) - 1) line[lineLen++] = c;
+            continue;
+        }
+        line[lineLen] = '\0';
+        if (lineLen == 0) {
+            headersDone = true;
+        } else if (strncasecmp(line, "ETag:", 5) == 0) {
+            const char* value = line + 5;
+            while (*value == ' ') value++;
+            strncpy(etag, value, MS_SETTINGS_ETAG_SIZE - 1);
+            etag[MS_SETTINGS_ETAG_SIZE - 1] = '\0';
+        } else if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            contentLength = atol(line + 15);
+        } else if (strncasecmp(line, "Connection: close", 17) == 0 ||
+                   strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+            keepOpen = false;
+        }
+        lineLen = 0;
+    }
+    if (!hasBody) contentLength = 0;
+    if (!headersDone || contentLength < 0) {
+        etag[0] = '\0';
+        return false;
+    }
+    if (contentLength > MS_SETTINGS_SIZE) {
+        PRINTOUT(F("Settings of"), contentLength, F("bytes are too long!"));
+        etag[0] = '\0';
+    }
+    int32_t bodyLen = 0;
+    while (bodyLen < contentLength && millis() - start < 5000L) {
+        if (outClient->available()) {
+            char c = outClient->read();
+            if (bodyLen < MS_SETTINGS_SIZE) settings[bodyLen] = c;
+            bodyLen++;
+        } else if (!outClient->connected()) {
+            break;
+        } else {
+            delay(2);
+        }
+    }
+    settings[bodyLen < MS_SETTINGS_SIZE ? bodyLen : MS_SETTINGS_SIZE] = '\0';
+    // Half a body could leave out a setting, or cut one short
+    if (bodyLen < contentLength) {
+        etag[0] = '\0';
+        return false;
+    }
+    return keepOpen;
+}
+
+
+// This checks for new settings
+int16_t RemoteConfigPublisher::publishData(Client* outClient) {
+    char    etag[MS_SETTINGS_ETAG_SIZE] = "";
+    char    settings[MS_SETTINGS_SIZE + 1];
+    int16_t responseCode = 504;
+
+    // Pick up the saved settings if begin() wasn't told to
+    if (!_cacheChecked) {
+        _cacheChecked = true;
+        if (_baseLogger->getSettingsETag()[0] == '\0') {
+            _baseLogger->loadSettings();
+        }
+    }
+
+    MS_DBG(F("Connecting client"));
+    MS_START_DEBUG_TIMER;
+    if (connectClient(outClient, _host, _port)) {
+        MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
+
+        txBufferInit(outClient);
+        txBufferAppendPrefix();
+        const char* knownTag = _baseLogger->getSettingsETag();
+        if (knownTag[0] != '\0') {
+            txBufferAppend("\r\nIf-None-Match: ");
+            txBufferAppend(knownTag);
+        }
+        txBufferAppend("\r\n\r\n");
+        txBufferFlush();
+
+        // The settings are needed now, so the response is never deferred;
+        // a 304 has no body, whatever its headers say
+        responseCode  = readResponseCode(outClient, millis());
+        bool keepOpen = responseCode != 504 &&
+            readSettings(outClient, responseCode != 304, etag, settings);
+        if (_keepAlive && _openClient == outClient && keepOpen) {
+            MS_DBG(F("Keeping the connection to"), _openHost, F("open"));
+        } else {
+            if (_openClient == outClient) _openClient = nullptr;
+            outClient->stop();
+        }
+    } else {
+        PRINTOUT(F("\n -- Unable to Establish Connection to"), _host, F("--"));
+    }
+
+    if (responseCode == 304) {
+        MS_DBG(F("The settings haven't changed"));
+    } else if (responseCode == 200 && etag[0] != '\0') {
+        PRINTOUT(F("Applied"), _baseLogger->applySettings(settings),
+                 F("new settings"));
+        _baseLogger->saveSettings(settings, etag);
+    } else if (responseCode == 200) {
+        PRINTOUT(F("Settings without an ETag or a whole body were ignored"));
+    }
+    return responseCode;
+}
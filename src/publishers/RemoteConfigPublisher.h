@@ -0,0 +1,165 @@
+/**
+ * @file RemoteConfigPublisher.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the RemoteConfigPublisher subclass of dataPublisher for
+ * fetching the logger's settings from a web server.
+ */
+
+// Header Guards
+#ifndef SRC_PUBLISHERS_REMOTECONFIGPUBLISHER_H_
+#define SRC_PUBLISHERS_REMOTECONFIGPUBLISHER_H_
+
+// Debugging Statement
+// #define MS_REMOTECONFIGPUBLISHER_DEBUG
+
+#ifdef MS_REMOTECONFIGPUBLISHER_DEBUG
+#define MS_DEBUGGING_STD "RemoteConfigPublisher"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "dataPublisherBase.h"
+
+
+// ============================================================================
+//  Functions for fetching the logger's settings
+// ============================================================================
+/**
+ * @brief The RemoteConfigPublisher subclass of dataPublisher for fetching
+ * the logger's settings from a web server, so the logging interval, the send
+ * frequencies and the averaging of the sensors can be changed without
+ * reflashing the board.
+ *
+ * Rather than sending data, each "publish" is a conditional GET of the
+ * settings text described in Logger::applySettings().  The ETag of the
+ * settings last taken is sent in an `If-None-Match` header, so when nothing
+ * has changed the server answers 304 (Not Modified) with no body, and the
+ * check only costs a short request and the response headers.  A 200 (OK)
+ * with an `ETag` header and a `Content-Length` of at most #MS_SETTINGS_SIZE
+ * is applied right away and saved with Logger::saveSettings();
+ * Logger::begin() applies the saved settings again after every restart, and
+ * their ETag is sent with the next check.
+ *
+ * Use the send frequency to check less often than the logging interval.
+ * Register this publisher after the data publishers, and with
+ * dataPublisher::setKeepAlive() and the same host as one of them it rides on
+ * that publisher's connection instead of opening its own.  A response is
+ * always read straight away, never deferred.
+ *
+ * @code{cpp}
+ * // Check for new settings once a day, on a 15 minute interval
+ * RemoteConfigPublisher config(dataLogger, &modem.gsmClient,
+ *                              "config.example.com", 80,
+ *                              "/loggers/site1.txt", 96);
+ * @endcode
+ *
+ * @ingroup the_publishers
+ */
+class RemoteConfigPublisher : public dataPublisher {
+ public:
+    // Constructors
+    /**
+     * @brief Construct a new Remote Config Publisher object with no members
+     * initialized.
+     */
+    RemoteConfigPublisher();
+    /**
+     * @brief Construct a new Remote Config Publisher object
+     *
+     * @note If a client is never specified, the publisher will attempt to
+     * create and use a client on a LoggerModem instance tied to the attached
+     * logger.
+     *
+     * @param baseLogger The logger whose settings are fetched
+     * @param sendEveryX Check on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay checking
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    explicit RemoteConfigPublisher(Logger& baseLogger, uint8_t sendEveryX = 1,
+                                   uint8_t sendOffset = 0);
+    /**
+     * @brief Construct a new Remote Config Publisher object
+     *
+     * @param baseLogger The logger whose settings are fetched
+     * @param inClient An Arduino client instance to use to print data to.
+     * Allows the use of any type of client and multiple clients tied to a
+     * single TinyGSM modem instance
+     * @param host The host name of the settings server
+     * @param port The port of the settings server
+     * @param path The path of the settings, starting with "/"
+     * @param sendEveryX Check on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay checking
+     * after each multiple of sendEveryX.  Defaults to 0.
+     */
+    RemoteConfigPublisher(Logger& baseLogger, Client* inClient,
+                          const char* host, uint16_t port, const char* path,
+                          uint8_t sendEveryX = 1, uint8_t sendOffset = 0);
+    /**
+     * @brief Destroy the Remote Config Publisher object
+     */
+    virtual ~RemoteConfigPublisher();
+
+    // Returns the data destination
+    String getEndpoint(void) override {
+        return String(_host);
+    }
+
+    /**
+     * @brief Set where to fetch the settings from.
+     *
+     * @param host The host name of the settings server
+     * @param port The port of the settings server
+     * @param path The path of the settings, starting with "/"
+     */
+    void setServer(const char* host, uint16_t port, const char* path);
+
+    // A way to begin with everything already set
+    /**
+     * @copydoc dataPublisher::begin(Logger& baseLogger, Client* inClient)
+     * @param host The host name of the settings server
+     * @param port The port of the settings server
+     * @param path The path of the settings
+     */
+    void begin(Logger& baseLogger, Client* inClient, const char* host,
+               uint16_t port, const char* path);
+
+    // This checks for new settings
+    int16_t publishData(Client* outClient) override;
+
+ protected:
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+    /**
+     * @brief Read the headers and the body of the response to a check.
+     *
+     * @param outClient The client the response comes in on
+     * @param hasBody False for a response that never has a body, like a 304
+     * @param etag The buffer for the ETag, of #MS_SETTINGS_ETAG_SIZE
+     * @param settings The buffer for the body, of #MS_SETTINGS_SIZE + 1
+     * @return **bool** True if the whole response was read and the
+     * connection can be kept open
+     */
+    bool readSettings(Client* outClient, bool hasBody, char* etag,
+                      char* settings);
+
+    // Where to fetch the settings from
+    const char* _host = nullptr;
+    uint16_t    _port = 80;
+    const char* _path = "/";
+
+ private:
+    /**
+     * @brief True once the saved settings have been looked for
+     */
+    bool _cacheChecked = false;
+};
+
+#endif  // SRC_PUBLISHERS_REMOTECONFIGPUBLISHER_H_
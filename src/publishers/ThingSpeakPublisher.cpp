@@ -21,6 +21,8 @@ const char* ThingSpeakPublisher::mqttServer     = "mqtt.thingspeak.com";
 const int   ThingSpeakPublisher::mqttPort       = 1883;
 const char* ThingSpeakPublisher::mqttClientName = THING_SPEAK_CLIENT_NAME;
 const char* ThingSpeakPublisher::mqttUser       = THING_SPEAK_USER_NAME;
+const char* ThingSpeakPublisher::bulkHost       = "api.thingspeak.com";
+const int   ThingSpeakPublisher::bulkPort       = 80;
 
 
 // Constructors
@@ -62,6 +64,7 @@ void ThingSpeakPublisher::setMQTTKey(const char* thingSpeakMQTTKey) {
 
 void ThingSpeakPublisher::setChannelID(const char* thingSpeakChannelID) {
     _thingSpeakChannelID = thingSpeakChannelID;
+    clearRequestPrefix();
 }
 
 
@@ -107,12 +110,12 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
 
     // Make sure we don't have too many fields
     // A channel can have a max of 8 fields
-    if (_baseLogger->getArrayVarCount() > 8) {
+    if (getSentVarCount() > 8) {
         MS_DBG(F("No more than 8 fields of data can be sent to a single "
                  "ThingSpeak channel!"));
         MS_DBG(F("Only the first 8 fields worth of data will be sent."));
     }
-    uint8_t numChannels = min(_baseLogger->getArrayVarCount(), 8);
+    uint8_t numChannels = min(getSentVarCount(), 8);
     MS_DBG(numChannels, F("fields will be sent to ThingSpeak"));
 
     // Create a buffer for the portions of the request and response
@@ -127,31 +130,26 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
     snprintf(topicBuffer + strlen(topicBuffer),
              sizeof(topicBuffer) - strlen(topicBuffer), "%s",
              _thingSpeakChannelKey);
-    MS_DBG(F("Topic ["), strlen(topicBuffer), F("]:"), String(topicBuffer));
-
-    emptyTxBuffer();
-
-    Logger::formatDateTime_ISO8601(Logger::markedLocalEpochTime)
-        .toCharArray(tempBuffer, 26);
-    snprintf(txBuffer + strlen(txBuffer), sizeof(txBuffer) - strlen(txBuffer),
-             "%s", "created_at=");
-    snprintf(txBuffer + strlen(txBuffer), sizeof(txBuffer) - strlen(txBuffer),
-             "%s", tempBuffer);
-    txBuffer[strlen(txBuffer)] = '&';
-
-    for (uint8_t i = 0; i < numChannels; i++) {
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", "field");
-        itoa(i + 1, tempBuffer, 10);  // BASE 10
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-        txBuffer[strlen(txBuffer)] = '=';
-        _baseLogger->getValueStringAtI(i).toCharArray(tempBuffer, 26);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-        if (i + 1 != numChannels) { txBuffer[strlen(txBuffer)] = '&'; }
+    MS_DBG(F("Topic ["), strlen(topicBuffer), F("]:"), topicBuffer);
+
+    // The whole message has to fit in the buffer to be published, so there is
+    // no client to send it to as it fills
+    txBufferInit(nullptr);
+    txBufferAppend("created_at=");
+    txBufferAppend(Logger::markedISO8601Time);
+
+    for (uint8_t n = 0; n < numChannels; n++) {
+        uint8_t i = getSentVarPosition(n);
+        // A field left out is just empty in the new channel entry
+        if (!isValueSentAtI(i)) continue;
+        txBufferAppend("&field");
+        itoa(n + 1, tempBuffer, 10);  // BASE 10
+        txBufferAppend(tempBuffer);
+        txBufferAppend('=');
+        formatSentValueAtI(i, tempBuffer, sizeof(tempBuffer));
+        txBufferAppend(tempBuffer);
     }
-    MS_DBG(F("Message ["), strlen(txBuffer), F("]:"), String(txBuffer));
+    MS_DBG(F("Message ["), txBufferLen, F("]:"), txBuffer);
 
     // Set the client connection parameters
     _mqttClient.setClient(*outClient);
@@ -163,6 +161,7 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
     // Closing any stray client sockets here ensures that a new client socket
     // is opened to the right place.
     // client is connected when a different socket is open
+    closeConnection();
     if (outClient->connected()) { outClient->stop(); }
 
     // Make the MQTT connection
@@ -174,6 +173,9 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
         MS_DBG(F("MQTT connected after"), MS_PRINT_DEBUG_TIMER, F("ms"));
 
         if (_mqttClient.publish(topicBuffer, txBuffer)) {
+            // PubSubClient doesn't report its packet overhead
+            _bytesSent += strlen(topicBuffer) + txBufferLen;
+            _totalBytesSent += strlen(topicBuffer) + txBufferLen;
             PRINTOUT(F("ThingSpeak topic published!  Current state:"),
                      parseMQTTState(_mqttClient.state()));
             retVal = true;
@@ -196,3 +198,98 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient) {
     MS_DBG(F("Disconnected after"), MS_PRINT_DEBUG_TIMER, F("ms"));
     return retVal;
 }
+
+
+// This sends a batch of backlogged records to the bulk-update API
+int16_t ThingSpeakPublisher::publishBatch(Client* outClient) {
+    char    tempBuffer[12] = "";
+    int16_t responseCode   = 504;
+
+    uint32_t jsonSize = writeBulkJson(false);
+    MS_DBG(F("Outgoing JSON size:"), jsonSize);
+
+    MS_DBG(F("Connecting client"));
+    MS_START_DEBUG_TIMER;
+    if (connectClient(outClient, bulkHost, bulkPort)) {
+        MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
+
+        // Build the request in the tx buffer, which is sent out to the client
+        // each time it fills
+        txBufferInit(outClient);
+        // The request line and the headers up to the content length, all
+        // rendered ahead of time
+        txBufferAppendPrefix();
+        ltoa(jsonSize, tempBuffer, 10);  // BASE 10
+        txBufferAppend(tempBuffer);
+        txBufferAppend("\r\nContent-Type: application/json\r\n\r\n");
+        writeBulkJson(true);
+
+        // Send out the finished request (or the last unsent section of it)
+        txBufferFlush(true);
+
+        // Read the response, or leave it to be read later, and close the
+        // connection unless it can be kept for the next request
+        responseCode = finishRequest(outClient);
+    } else {
+        PRINTOUT(F("\n -- Unable to Establish Connection to ThingSpeak --"));
+    }
+
+    return responseCode;
+}
+
+
+// The bulk-update request line and headers only change with the channel
+uint8_t ThingSpeakPublisher::getRequestPrefixParts(const char* parts[]) {
+    parts[0] = postHeader;
+    parts[1] = "/channels/";
+    parts[2] = _thingSpeakChannelID;
+    parts[3] = "/bulk_update.json";
+    parts[4] = HTTPtag;
+    parts[5] = hostHeader;
+    parts[6] = bulkHost;
+    parts[7] = "\r\nContent-Length: ";
+    return 8;
+}
+
+
+// This writes the JSON body of a bulk update, or just counts it
+uint32_t ThingSpeakPublisher::writeBulkJson(bool send) {
+    // Big enough for any formatted value or the timestamp
+    char     tempBuffer[MS_ISO8601_BUFFER_SIZE + 11];
+    uint32_t jsonLength  = 0;
+    uint8_t  nRecords    = _baseLogger->getBatchCount();
+    uint8_t  numChannels = min(getSentVarCount(), 8);
+
+    // Add a string to the outgoing buffer or just count it
+#define BULK_JSON_ADD(str)                   \
+    {                                        \
+        const char* toAdd = str;             \
+        if (send) { txBufferAppend(toAdd); } \
+        jsonLength += strlen(toAdd);         \
+    }
+
+    BULK_JSON_ADD("{\"write_api_key\":\"")
+    BULK_JSON_ADD(_thingSpeakChannelKey)
+    BULK_JSON_ADD("\",\"updates\":[")
+    for (uint8_t k = 0; k < nRecords; k++) {
+        BULK_JSON_ADD("{\"created_at\":\"")
+        Logger::formatDateTime_ISO8601(_baseLogger->getBatchTime(k), tempBuffer,
+                                       sizeof(tempBuffer));
+        BULK_JSON_ADD(tempBuffer)
+        BULK_JSON_ADD("\"")
+        for (uint8_t n = 0; n < numChannels; n++) {
+            BULK_JSON_ADD(",\"field")
+            itoa(n + 1, tempBuffer, 10);  // BASE 10
+            BULK_JSON_ADD(tempBuffer)
+            BULK_JSON_ADD("\":")
+            _baseLogger->formatBatchValueAtI(k, getSentVarPosition(n),
+                                             tempBuffer, sizeof(tempBuffer));
+            BULK_JSON_ADD(tempBuffer)
+        }
+        BULK_JSON_ADD(k + 1 != nRecords ? "}," : "}")
+    }
+    BULK_JSON_ADD("]}")
+#undef BULK_JSON_ADD
+
+    return jsonLength;
+}
@@ -76,11 +76,10 @@ class ThingSpeakPublisher : public dataPublisher {
      * logger.
      *
      * @param baseLogger The logger supplying the data to be published
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -97,11 +96,10 @@ class ThingSpeakPublisher : public dataPublisher {
      * @param inClient An Arduino client instance to use to print data to.
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -118,10 +116,10 @@ class ThingSpeakPublisher : public dataPublisher {
      * @param thingSpeakMQTTKey Your MQTT API Key from Account > MyProfile.
      * @param thingSpeakChannelID The numeric channel id for your channel
      * @param thingSpeakChannelKey The write API key for your channel
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     ThingSpeakPublisher(Logger& baseLogger, const char* thingSpeakMQTTKey,
                         const char* thingSpeakChannelID,
@@ -137,11 +135,10 @@ class ThingSpeakPublisher : public dataPublisher {
      * @param thingSpeakMQTTKey Your MQTT API Key from Account > MyProfile.
      * @param thingSpeakChannelID The numeric channel id for your channel
      * @param thingSpeakChannelKey The write API key for your channel
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     ThingSpeakPublisher(Logger& baseLogger, Client* inClient,
                         const char* thingSpeakMQTTKey,
@@ -209,9 +206,34 @@ class ThingSpeakPublisher : public dataPublisher {
                const char* thingSpeakChannelID,
                const char* thingSpeakChannelKey);
 
+    /**
+     * @brief Set the most backlogged records to send in a single bulk
+     * update.
+     *
+     * Live records are always published over MQTT.  Records replayed from a
+     * backlog (see dataPublisher::setBacklog()) are instead sent to the
+     * ThingSpeak bulk-update JSON API over HTTP, many timestamped entries
+     * per request.  The request is streamed from the backlog file as it is
+     * written, so it does not need to fit in memory.
+     *
+     * @param maxBatchRecords The most records per bulk update; 1 to publish
+     * each backlogged record over MQTT.  Default is 1.
+     */
+    void setBulkUpdate(uint8_t maxBatchRecords) {
+        _maxBatchRecords = maxBatchRecords > 0 ? maxBatchRecords : 1;
+    }
+    /**
+     * @copydoc dataPublisher::getMaxBatchRecords()
+     */
+    uint8_t getMaxBatchRecords(void) override {
+        return _maxBatchRecords;
+    }
+
     // This sends the data to ThingSpeak
     // bool mqttThingSpeak(void);
     int16_t publishData(Client* outClient) override;
+    // This sends a batch of backlogged records in a bulk update
+    int16_t publishBatch(Client* outClient) override;
 
  protected:
     /**
@@ -226,12 +248,37 @@ class ThingSpeakPublisher : public dataPublisher {
     static const char* mqttUser;        ///< The MQTT user name
                                         /**@}*/
 
+    /**
+     * @anchor ts_bulk_vars
+     * @name Portions of the bulk-update request
+     *
+     * @{
+     */
+    static const char* bulkHost;  ///< The host for the bulk-update API
+    static const int   bulkPort;  ///< The port for the bulk-update API
+                                  /**@}*/
+
+    /**
+     * @brief Write the JSON body of a bulk update of the current backlog
+     * batch, or just count its length.
+     *
+     * @param send True to add the body to the TX buffer; false to only count
+     * it
+     * @return **uint32_t** The length of the body
+     */
+    uint32_t writeBulkJson(bool send);
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+
  private:
     // Keys for ThingSpeak
     const char*  _thingSpeakMQTTKey    = nullptr;
     const char*  _thingSpeakChannelID  = nullptr;
     const char*  _thingSpeakChannelKey = nullptr;
     PubSubClient _mqttClient;
+    uint8_t      _maxBatchRecords = 1;
 };
 
 #endif  // SRC_PUBLISHERS_THINGSPEAKPUBLISHER_H_
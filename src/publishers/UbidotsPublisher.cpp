@@ -64,10 +64,28 @@ UbidotsPublisher::~UbidotsPublisher() {}
 
 void UbidotsPublisher::setToken(const char* authentificationToken) {
     _authentificationToken = authentificationToken;
+    clearRequestPrefix();
     MS_DBG(F("Registration token set!"));
 }
 
 
+// The headers before the content length only change with the device or token
+uint8_t UbidotsPublisher::getRequestPrefixParts(const char* parts[]) {
+    _prefixDeviceID = _baseLogger->getSamplingFeatureUUID();
+    parts[0]        = postHeader;
+    parts[1]        = postEndpoint;
+    parts[2]        = _prefixDeviceID;
+    parts[3]        = "/";
+    parts[4]        = HTTPtag;
+    parts[5]        = hostHeader;
+    parts[6]        = ubidotsHost;
+    parts[7]        = tokenHeader;
+    parts[8]        = _authentificationToken;
+    parts[9]        = contentLengthHeader;
+    return 10;
+}
+
+
 // Calculates how long the JSON will be
 uint16_t UbidotsPublisher::calculateJsonSize() {
     uint16_t jsonLength = 1;  // {
@@ -75,19 +93,23 @@ uint16_t UbidotsPublisher::calculateJsonSize() {
     // jsonLength += 15;          // ","timestamp":"
     // jsonLength += 25;          // markedISO8601Time
     // jsonLength += 2;           //  ",
-    for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
+    // all of the values to send, already formatted in the logger's record
+    uint8_t nSent;
+    jsonLength += getSentValuesLength(nSent);
+    char uuidBuffer[37];
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        if (!isValueSentAtI(i)) continue;
         jsonLength += 1;  //  "
-        jsonLength +=
-            _baseLogger->getVarUUIDAtI(i).length();  // parameter ID length
-        jsonLength += 11;                            //  ":{"value":
-        jsonLength += _baseLogger->getValueStringAtI(i).length();
+        jsonLength += _baseLogger->formatVarUUIDAtI(
+            i, uuidBuffer, sizeof(uuidBuffer));  // parameter ID length
+        jsonLength += 11;                        //  ":{"value":
         jsonLength += 13;  // ,"timestamp":
         jsonLength += 13;  // epoch time in milliseconds
-        if (i + 1 != _baseLogger->getArrayVarCount()) {
-            jsonLength += 2;  // ,
-        }
+        jsonLength += 1;   // }
     }
-    jsonLength += 2;  // }
+    if (nSent > 0) { jsonLength += nSent - 1; }  // ,
+    jsonLength += 1;                             // }
 
     return jsonLength;
 }
@@ -97,19 +119,27 @@ uint16_t UbidotsPublisher::calculateJsonSize() {
 void UbidotsPublisher::printSensorDataJSON(Stream* stream) {
     stream->print(payload);
 
-    for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
+    char valueBuffer[MS_VALUE_BUFFER_SIZE];
+    char uuidBuffer[37];
+    bool first = true;
+    for (uint8_t n = 0; n < getSentVarCount(); n++) {
+        uint8_t i = getSentVarPosition(n);
+        if (!isValueSentAtI(i)) continue;
+        if (!first) { stream->print(','); }
+        first = false;
         stream->print('"');
-        stream->print(_baseLogger->getVarUUIDAtI(i));
+        _baseLogger->formatVarUUIDAtI(i, uuidBuffer, sizeof(uuidBuffer));
+        stream->print(uuidBuffer);
         stream->print(F("\":{'value':"));
-        stream->print(_baseLogger->getValueStringAtI(i));
+        formatSentValueAtI(i, valueBuffer, sizeof(valueBuffer));
+        stream->print(valueBuffer);
         stream->print(",'timestamp':");
         stream->print(Logger::markedUTCEpochTime);
         stream->print(
             F("000}"));  // Convert microseconds to milliseconds for ubidots
-        if (i + 1 != _baseLogger->getArrayVarCount()) { stream->print(','); }
     }
 
-    stream->print(F("}}"));
+    stream->print('}');
 }
 
 
@@ -140,6 +170,7 @@ void UbidotsPublisher::begin(Logger& baseLogger, Client* inClient,
     setToken(authentificationToken);
     dataPublisher::begin(baseLogger, inClient);
     _baseLogger->setSamplingFeatureUUID(deviceID);
+    renderRequestPrefix();
 }
 void UbidotsPublisher::begin(Logger&     baseLogger,
                              const char* authentificationToken,
@@ -147,6 +178,7 @@ void UbidotsPublisher::begin(Logger&     baseLogger,
     setToken(authentificationToken);
     dataPublisher::begin(baseLogger);
     _baseLogger->setSamplingFeatureUUID(deviceID);
+    renderRequestPrefix();
 }
 
 
@@ -156,139 +188,145 @@ void UbidotsPublisher::begin(Logger&     baseLogger,
 // The return is the http status code of the response.
 // int16_t EnviroDIYPublisher::postDataEnviroDIY(void)
 int16_t UbidotsPublisher::publishData(Client* outClient) {
+    return postRequest(outClient, false);
+}
+
+
+// This sends all of the records in the logger's backlog batch in one request
+int16_t UbidotsPublisher::publishBatch(Client* outClient) {
+    return postRequest(outClient, true);
+}
+
+
+// This writes (or just measures) the JSON for a batch of records, with an
+// array of values and timestamps for each variable
+uint32_t UbidotsPublisher::writeBatchJson(bool send) {
+    // Big enough for a UUID (36 + null) or any formatted value
+    char     tempBuffer[37];
+    uint32_t jsonLength = 0;
+    uint8_t  nRecords   = _baseLogger->getBatchCount();
+    uint8_t  nVars      = getSentVarCount();
+
+    // Add a string to the outgoing buffer or just count it
+#define BATCH_JSON_ADD(str)                         \
+    {                                               \
+        const char* toAdd = str;                    \
+        if (send) { txBufferAppend(toAdd); }        \
+        jsonLength += strlen(toAdd);                \
+    }
+
+    BATCH_JSON_ADD(payload)
+    bool firstVar = true;
+    for (uint8_t n = 0; n < nVars; n++) {
+        uint8_t i          = getSentVarPosition(n);
+        bool    firstValue = true;
+        for (uint8_t k = 0; k < nRecords; k++) {
+            // Missing values are left out, rather than sent as -9999
+            if (_baseLogger->getBatchValueAtI(k, i) == -9999) continue;
+            if (firstValue) {
+                if (!firstVar) BATCH_JSON_ADD(",")
+                firstVar = false;
+                BATCH_JSON_ADD("\"")
+                _baseLogger->formatVarUUIDAtI(i, tempBuffer,
+                                              sizeof(tempBuffer));
+                BATCH_JSON_ADD(tempBuffer)
+                BATCH_JSON_ADD("\":[")
+            } else {
+                BATCH_JSON_ADD(",")
+            }
+            firstValue = false;
+            BATCH_JSON_ADD("{\"value\":")
+            _baseLogger->formatBatchValueAtI(k, i, tempBuffer,
+                                             sizeof(tempBuffer));
+            BATCH_JSON_ADD(tempBuffer)
+            BATCH_JSON_ADD(",\"timestamp\":")
+            // The reverse of Logger::markTime()
+            uint32_t utcTime = _baseLogger->getBatchTime(k) -
+                ((uint32_t)Logger::getTZOffset()) * 3600;
+            ltoa(utcTime, tempBuffer, 10);  // BASE 10
+            BATCH_JSON_ADD(tempBuffer)
+            // Convert seconds to milliseconds for ubidots
+            BATCH_JSON_ADD("000}")
+        }
+        if (!firstValue) BATCH_JSON_ADD("]")
+    }
+    BATCH_JSON_ADD("}")
+#undef BATCH_JSON_ADD
+
+    return jsonLength;
+}
+
+
+// This makes the connection and sends either the current record or the
+// logger's backlog batch
+int16_t UbidotsPublisher::postRequest(Client* outClient, bool batch) {
     // Create a buffer for the portions of the request and response
     char     tempBuffer[37] = "";
-    uint16_t did_respond    = 0;
+    int16_t  responseCode   = 504;
 
-    MS_DBG(F("Outgoing JSON size:"), calculateJsonSize());
+    uint32_t jsonSize = batch ? writeBatchJson(false) : calculateJsonSize();
+    MS_DBG(F("Outgoing JSON size:"), jsonSize);
 
     // Open a TCP/IP connection to the Enviro DIY Data Portal (WebSDL)
     MS_DBG(F("Connecting client"));
     MS_START_DEBUG_TIMER;
-    if (outClient->connect(ubidotsHost, ubidotsPort)) {
+    if (connectClient(outClient, ubidotsHost, ubidotsPort)) {
         MS_DBG(F("Client connected after"), MS_PRINT_DEBUG_TIMER, F("ms\n"));
 
-        // copy the initial post header into the tx buffer
-        snprintf(txBuffer, sizeof(txBuffer), "%s", postHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", postEndpoint);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 _baseLogger->getSamplingFeatureUUID());
-        txBuffer[strlen(txBuffer)] = '/';
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", HTTPtag);
+        // Build the request in the tx buffer, which is sent out to the client
+        // each time it fills
+        txBufferInit(outClient);
+        // The request line and the headers up to the content length, all
+        // rendered ahead of time, unless the device ID has changed since
+        if (_baseLogger->getSamplingFeatureUUID() != _prefixDeviceID) {
+            clearRequestPrefix();
+        }
+        txBufferAppendPrefix();
 
         // add the rest of the HTTP POST headers to the outgoing buffer
-        // before adding each line/chunk to the outgoing buffer, we make sure
-        // there is space for that line, sending out buffer if not
-        if (bufferFree() < 28) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", hostHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", ubidotsHost);
-
-        if (bufferFree() < 47) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tokenHeader);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 _authentificationToken);
-
-        if (bufferFree() < 26) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s",
-                 contentLengthHeader);
-        itoa(calculateJsonSize(), tempBuffer, 10);  // BASE 10
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-
-        if (bufferFree() < 42) printTxBuffer(outClient);
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", contentTypeHeader);
-
-        // put the start of the JSON into the outgoing response_buffer
-        if (bufferFree() < 21) printTxBuffer(outClient);
-
-        snprintf(txBuffer + strlen(txBuffer),
-                 sizeof(txBuffer) - strlen(txBuffer), "%s", payload);
-
-        for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
-            // Once the buffer fills, send it out
-            if (bufferFree() < 47) printTxBuffer(outClient);
-
-            txBuffer[strlen(txBuffer)] = '"';
-            _baseLogger->getVarUUIDAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            txBuffer[strlen(txBuffer)] = '"';
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", ":{");
-            txBuffer[strlen(txBuffer)] = '"';
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", "value");
-            txBuffer[strlen(txBuffer)] = '"';
-            txBuffer[strlen(txBuffer)] = ':';
-            _baseLogger->getValueStringAtI(i).toCharArray(tempBuffer, 37);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            txBuffer[strlen(txBuffer)] = ',';
-            txBuffer[strlen(txBuffer)] = '"';
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", "timestamp");
-            txBuffer[strlen(txBuffer)] = '"';
-            txBuffer[strlen(txBuffer)] = ':';
-            ltoa(Logger::markedUTCEpochTime, tempBuffer, 10);  // BASE 10
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", tempBuffer);
-            snprintf(txBuffer + strlen(txBuffer),
-                     sizeof(txBuffer) - strlen(txBuffer), "%s", "000");
-            if (i + 1 != _baseLogger->getArrayVarCount()) {
-                txBuffer[strlen(txBuffer)] = '}';
-                txBuffer[strlen(txBuffer)] = ',';
-            } else {
-                txBuffer[strlen(txBuffer)] = '}';
-                txBuffer[strlen(txBuffer)] = '}';
+        ltoa(jsonSize, tempBuffer, 10);  // BASE 10
+        txBufferAppend(tempBuffer);
+        txBufferAppend(contentTypeHeader);
+
+        if (batch) {
+            writeBatchJson(true);
+        } else {
+            // put the start of the JSON into the outgoing response_buffer
+            txBufferAppend(payload);
+
+            // The timestamp is the same for every variable
+            char timestamp[14];
+            ltoa(Logger::markedUTCEpochTime, timestamp, 10);  // BASE 10
+
+            bool first = true;
+            for (uint8_t n = 0; n < getSentVarCount(); n++) {
+                uint8_t i = getSentVarPosition(n);
+                if (!isValueSentAtI(i)) continue;
+                if (!first) { txBufferAppend(','); }
+                first = false;
+                txBufferAppend('"');
+                _baseLogger->formatVarUUIDAtI(i, tempBuffer,
+                                              sizeof(tempBuffer));
+                txBufferAppend(tempBuffer);
+                txBufferAppend("\":{\"value\":");
+                formatSentValueAtI(i, tempBuffer, sizeof(tempBuffer));
+                txBufferAppend(tempBuffer);
+                txBufferAppend(",\"timestamp\":");
+                txBufferAppend(timestamp);
+                txBufferAppend("000}");
             }
+            txBufferAppend('}');
         }
 
         // Send out the finished request (or the last unsent section of it)
-        printTxBuffer(outClient, true);
+        txBufferFlush(true);
 
-        // Wait 10 seconds for a response from the server
-        uint32_t start = millis();
-        while ((millis() - start) < 10000L && outClient->available() < 12) {
-            delay(10);
-        }
-
-        // Read only the first 12 characters of the response
-        // We're only reading as far as the http code, anything beyond that
-        // we don't care about.
-        did_respond = outClient->readBytes(tempBuffer, 12);
-
-        // Close the TCP/IP connection
-        MS_DBG(F("Stopping client"));
-        MS_RESET_DEBUG_TIMER;
-        outClient->stop();
-        MS_DBG(F("Client stopped after"), MS_PRINT_DEBUG_TIMER, F("ms"));
+        // Read the response, or leave it to be read later, and close the
+        // connection unless it can be kept for the next request
+        responseCode = finishRequest(outClient);
     } else {
         PRINTOUT(F("\n -- Unable to Establish Connection to Ubiots --"));
     }
 
-    // Process the HTTP response
-    int16_t responseCode = 0;
-    if (did_respond > 0) {
-        char responseCode_char[4];
-        for (uint8_t i = 0; i < 3; i++) {
-            responseCode_char[i] = tempBuffer[i + 9];
-        }
-        responseCode = atoi(responseCode_char);
-    } else {
-        responseCode = 504;
-    }
-
-    PRINTOUT(F("-- Response Code --"));
-    PRINTOUT(responseCode);
-
     return responseCode;
 }
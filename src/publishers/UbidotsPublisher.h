@@ -50,11 +50,10 @@ class UbidotsPublisher : public dataPublisher {
      * logger.
      *
      * @param baseLogger The logger supplying the data to be published
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -71,11 +70,10 @@ class UbidotsPublisher : public dataPublisher {
      * @param inClient An Arduino client instance to use to print data to.
      * Allows the use of any type of client and multiple clients tied to a
      * single TinyGSM modem instance
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      *
      * @note It is possible (though very unlikey) that using this constructor
      * could cause errors if the compiler attempts to initialize the publisher
@@ -95,11 +93,10 @@ class UbidotsPublisher : public dataPublisher {
      * specific device's setup panel).
      * @param deviceID The device API Label from Ubidots, derived from the
      * user-specified device name.
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     UbidotsPublisher(Logger& baseLogger, const char* authentificationToken,
                      const char* deviceID, uint8_t sendEveryX = 1,
@@ -117,11 +114,10 @@ class UbidotsPublisher : public dataPublisher {
      * specific device's setup panel).
      * @param deviceID The device API Label from Ubidots, derived from the
      * user-specified device name.
-     * @param sendEveryX Currently unimplemented, intended for future use to
-     * enable caching and bulk publishing
-     * @param sendOffset Currently unimplemented, intended for future use to
-     * enable publishing data at a time slightly delayed from when it is
-     * collected
+     * @param sendEveryX Send on every Xth logging interval; see
+     * dataPublisher::setSendFrequency().  Defaults to 1.
+     * @param sendOffset The number of logging intervals to delay sending
+     * after each multiple of sendEveryX.  Defaults to 0.
      */
     UbidotsPublisher(Logger& baseLogger, Client* inClient,
                      const char* authentificationToken, const char* deviceID,
@@ -218,7 +214,61 @@ class UbidotsPublisher : public dataPublisher {
      */
     int16_t publishData(Client* outClient) override;
 
+    /**
+     * @brief Set the most backlogged records to send in a single request.
+     *
+     * Batched records are sent as one JSON object with an array of
+     * `{"value":...,"timestamp":...}` entries for each variable label; missing
+     * values are left out.  This only applies to records replayed from a
+     * backlog kept with dataPublisher::setBacklog().  The request is streamed
+     * out in pieces the size of the TX buffer, so the batch is not limited
+     * by #MS_SEND_BUFFER_SIZE.
+     *
+     * @param maxBatchRecords The most records per request; 1 to send each
+     * record in its own request.  Default is 1.
+     */
+    void setMaxBatchRecords(uint8_t maxBatchRecords) {
+        _maxBatchRecords = maxBatchRecords > 0 ? maxBatchRecords : 1;
+    }
+    /**
+     * @copydoc dataPublisher::getMaxBatchRecords()
+     */
+    uint8_t getMaxBatchRecords(void) override {
+        return _maxBatchRecords;
+    }
+    /**
+     * @brief Send all of the records in the logger's current backlog batch to
+     * Ubidots in one post request.
+     *
+     * @param outClient An Arduino client instance to use to print data to.
+     * @return **int16_t** The http status code of the response.
+     */
+    int16_t publishBatch(Client* outClient) override;
+
  protected:
+    /**
+     * @brief Open the connection and post either the current record or the
+     * logger's backlog batch.
+     *
+     * @param outClient An Arduino client instance to use to print data to.
+     * @param batch True to send the logger's backlog batch
+     * @return **int16_t** The http status code of the response.
+     */
+    int16_t postRequest(Client* outClient, bool batch);
+    /**
+     * @brief Add the JSON for the logger's backlog batch to the TX buffer, or
+     * just calculate its length.
+     *
+     * @param send True to add the JSON to the TX buffer; false to only return
+     * its length.
+     * @return **uint32_t** The number of characters in the JSON
+     */
+    uint32_t writeBatchJson(bool send);
+    /**
+     * @copydoc dataPublisher::getRequestPrefixParts()
+     */
+    uint8_t getRequestPrefixParts(const char* parts[]) override;
+
     /**
      * @anchor ubidots_post_vars
      * @name Portions of the POST request to Ubidots
@@ -247,6 +297,10 @@ class UbidotsPublisher : public dataPublisher {
  private:
     // Tokens for Ubidots
     const char* _authentificationToken = nullptr;
+    // The device ID in the rendered request prefix
+    const char* _prefixDeviceID = nullptr;
+    // The most backlogged records to send in one request
+    uint8_t _maxBatchRecords = 1;
 };
 
 #endif  // SRC_PUBLISHERS_UBIDOTSPUBLISHER_H_
@@ -89,9 +89,19 @@
 /// @brief Sensor::_stabilizationTime_ms; the AM2315 is stable after 500ms
 /// (estimated).
 #define AM2315_STABILIZATION_TIME_MS 500
-/// @brief Sensor::_measurementTime_ms; the AM2315 takes 2000ms (2s) to complete
-/// a measurement.
-#define AM2315_MEASUREMENT_TIME_MS 2000
+/**
+ * @brief Sensor::_measurementTime_ms; the AM2315 is woken and measures when it
+ * is read, and the library waits out that conversion itself.
+ */
+#define AM2315_MEASUREMENT_TIME_MS 0
+/**
+ * @brief Sensor::_minMeasurementInterval_ms; the AM2315 needs 2000ms (2s)
+ * between reads, or the library returns the last values again.
+ *
+ * A little is added to cover the time between the scheduler marking the
+ * result and the library reading it.
+ */
+#define AM2315_MIN_INTERVAL_MS 2050
 /**@}*/
 
 /**
@@ -16,8 +16,16 @@ AOSongDHT::AOSongDHT(int8_t powerPin, int8_t dataPin, const uint8_t type,
     : Sensor("AOSongDHT", DHT_NUM_VARIABLES, DHT_WARM_UP_TIME_MS,
              DHT_STABILIZATION_TIME_MS, DHT_MEASUREMENT_TIME_MS, powerPin,
              dataPin, measurementsToAverage, DHT_INC_CALC_VARIABLES),
-      dht_internal(dataPin, type),
-      _dhtType(type) {}
+      dht_internal(dataPin, type) {
+    // The name includes the type, so it needs no String to make
+    switch (type) {
+        case 11: _sensorName = "AOSongDHT11"; break;
+        case 12: _sensorName = "AOSongDHT12"; break;
+        case 21: _sensorName = "AOSongDHT21"; break;  // DHT 21 or AM2301
+        default: _sensorName = "AOSongDHT22"; break;
+    }
+    setMinMeasurementInterval(DHT_MIN_INTERVAL_MS);
+}
 
 // Destructor - does nothing.
 AOSongDHT::~AOSongDHT() {}
@@ -30,16 +38,6 @@ bool AOSongDHT::setup(void) {
 }
 
 
-String AOSongDHT::getSensorName(void) {
-    switch (_dhtType) {
-        case 11: return "AOSongDHT11";
-        case 12: return "AOSongDHT12";
-        case 21: return "AOSongDHT21";  // DHT 21 or AM2301
-        default: return "AOSongDHT22";
-    }
-}
-
-
 bool AOSongDHT::addSingleMeasurementResult(void) {
     bool success = false;
 
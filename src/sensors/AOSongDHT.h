@@ -111,9 +111,19 @@ static const uint8_t AM2301{21}; /**< AM2301 */
 /// @brief Sensor::_stabilizationTime_ms; We assume the sensor is stable
 /// immediately after warm-up
 #define DHT_STABILIZATION_TIME_MS 0
-/// @brief Sensor::_measurementTime_ms; DHT takes 2000ms (2s) to complete a
-/// measurement.
-#define DHT_MEASUREMENT_TIME_MS 2000
+/**
+ * @brief Sensor::_measurementTime_ms; the DHT measures when it is read, and the
+ * library waits out that conversion itself.
+ */
+#define DHT_MEASUREMENT_TIME_MS 0
+/**
+ * @brief Sensor::_minMeasurementInterval_ms; the DHT needs 2000ms (2s) between
+ * reads, or the library returns the last values again.
+ *
+ * A little is added to cover the time between the scheduler marking the
+ * result and the library reading it.
+ */
+#define DHT_MIN_INTERVAL_MS 2050
 /**@}*/
 
 /**
@@ -235,19 +245,13 @@ class AOSongDHT : public Sensor {
      */
     bool setup(void) override;
 
-    /**
-     * @copydoc Sensor::getSensorName()
-     */
-    String getSensorName(void) override;
-
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
-    DHT     dht_internal;
-    uint8_t _dhtType;
+    DHT dht_internal;
 };
 
 
@@ -23,7 +23,8 @@ AnalogElecConductivity::AnalogElecConductivity(int8_t powerPin, int8_t dataPin,
       _EcPowerPin(powerPin),
       _EcAdcPin(dataPin),
       _Rseries_ohms(Rseries_ohms),
-      _sensorEC_Konst(sensorEC_Konst) {}
+      _sensorEC_Konst(sensorEC_Konst),
+      _ecCurve(makeECCurve(Rseries_ohms, sensorEC_Konst)) {}
 // Destructor
 AnalogElecConductivity::~AnalogElecConductivity() {}
 
@@ -40,9 +41,8 @@ float AnalogElecConductivity::readEC() {
 
 
 float AnalogElecConductivity::readEC(uint8_t analogPinNum) {
-    uint32_t sensorEC_adc;
-    float    Rwater_ohms;      // literal value of water
-    float    EC_uScm = -9999;  // units are uS per cm
+    float sensorEC_adc;
+    float EC_uScm = -9999;  // units are uS per cm
 
     // Set the resolution for the processor ADC, only applies to SAMD boards.
 #if !defined ARDUINO_ARCH_AVR
@@ -54,15 +54,13 @@ float AnalogElecConductivity::readEC(uint8_t analogPinNum) {
     analogReference(ANALOG_EC_ADC_REFERENCE_MODE);
 
     // First measure the analog voltage.
-    // The return value from analogRead() is IN BITS NOT IN VOLTS!!
-    // Take a priming reading.
-    // First reading will be low - discard
-    analogRead(analogPinNum);
-    // Take the reading we'll keep
-    sensorEC_adc = analogRead(analogPinNum);
+    // The return value is IN BITS NOT IN VOLTS!!
+    // The priming reading is taken and discarded within the averaged read
+    sensorEC_adc = processorAnalogRead(analogPinNum, ANALOG_EC_ADC_RESOLUTION,
+                                       ANALOG_EC_ADC_SAMPLES);
     MS_DEEP_DBG("adc bits=", sensorEC_adc);
 
-    if (0 == sensorEC_adc) {
+    if (sensorEC_adc < 1) {
         // Prevent underflow, can never be ANALOG_EC_ADC_RANGE
         sensorEC_adc = 1;
     }
@@ -70,14 +68,12 @@ float AnalogElecConductivity::readEC(uint8_t analogPinNum) {
     // Estimate Resistance of Liquid
 
     // see the header for an explanation of this calculation
-    Rwater_ohms = _Rseries_ohms /
-        ((static_cast<float>(ANALOG_EC_ADC_RANGE) /
-          static_cast<float>(sensorEC_adc)) -
-         1);
-    MS_DEEP_DBG("ohms=", Rwater_ohms);
-
-    // Convert to EC
-    EC_uScm = 1000000 / (Rwater_ohms * _sensorEC_Konst);
+    float rangeRatio = static_cast<float>(ANALOG_EC_ADC_RANGE) / sensorEC_adc;
+    MS_DEEP_DBG("ohms=", _Rseries_ohms / (rangeRatio - 1));
+
+    // Convert to EC; the constants are folded into the curve, so this takes
+    // one division and one multiply
+    EC_uScm = _ecCurve.apply(rangeRatio);
     MS_DEEP_DBG("cond=", EC_uScm);
 
     return EC_uScm;
@@ -116,6 +116,9 @@
  * - `-D ANALOG_EC_ADC_REFERENCE_MODE=xxx`
  *      - used to set the processor ADC value reference mode
  *      - @see #ANALOG_EC_ADC_REFERENCE_MODE
+ * - `-D ANALOG_EC_ADC_SAMPLES=##`
+ *      - used to set the number of ADC samples averaged in each reading
+ *      - @see #ANALOG_EC_ADC_SAMPLES
  *
  * @section sensor_analog_cond_ctor Sensor Constructor
  * {{ @ref AnalogElecConductivity::AnalogElecConductivity }}
@@ -145,6 +148,8 @@
 #undef MS_DEBUGGING_STD
 #undef MS_DEBUGGING_DEEP
 #include "SensorBase.h"
+#include "ProcessorAnalog.h"
+#include "CalibrationCurve.h"
 #include "VariableBase.h"
 #include "math.h"
 
@@ -232,6 +237,16 @@
 /// bit.
 #define ANALOG_EC_ADC_RANGE (1 << ANALOG_EC_ADC_RESOLUTION)
 
+#if !defined ANALOG_EC_ADC_SAMPLES
+/**
+ * @brief The number of ADC samples averaged in each reading.
+ *
+ * On SAMD boards the ADC's averaging hardware takes these in one conversion;
+ * use a power of two.
+ */
+#define ANALOG_EC_ADC_SAMPLES PROCESSOR_ANALOG_SAMPLES
+#endif  // ANALOG_EC_ADC_SAMPLES
+
 /* clang-format off */
 #if !defined ANALOG_EC_ADC_REFERENCE_MODE
 #if defined (ARDUINO_ARCH_AVR) || defined (DOXYGEN)
@@ -364,6 +379,7 @@ class AnalogElecConductivity : public Sensor {
      */
     void setEC_k(float sourceResistance_ohms) {
         _Rseries_ohms = sourceResistance_ohms;
+        _ecCurve      = makeECCurve(_Rseries_ohms, _sensorEC_Konst);
     }
 
     /**
@@ -393,6 +409,26 @@ class AnalogElecConductivity : public Sensor {
 
     /// @brief the cell constant for the circuit
     float _sensorEC_Konst = SENSOREC_KONST_DEF;
+
+    /// @brief The EC from the ratio of the ADC range to the reading, with
+    /// the series resistance and cell constant folded in
+    LinearCalibration _ecCurve;
+
+    /**
+     * @brief Fold the constants of the EC calculation into one line.
+     *
+     * With Rwater = Rseries / (range / adc - 1) and EC = 10^6 / (Rwater * K),
+     * EC = k * (range / adc) - k, where k = 10^6 / (Rseries * K).
+     *
+     * @param Rseries_ohms The series resistance
+     * @param sensorEC_Konst The cell constant
+     * @return **LinearCalibration** The EC from range / adc
+     */
+    static constexpr LinearCalibration makeECCurve(float Rseries_ohms,
+                                                   float sensorEC_Konst) {
+        return LinearCalibration(1000000 / (Rseries_ohms * sensorEC_Konst),
+                                 -1000000 / (Rseries_ohms * sensorEC_Konst));
+    }
 };
 
 /**
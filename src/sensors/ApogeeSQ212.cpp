@@ -14,6 +14,9 @@
 #include "ApogeeSQ212.h"
 #include <Adafruit_ADS1015.h>
 
+// Apogee SQ-212 Calibration Factor = 1.0 μmol m-2 s-1 per mV, folded into one
+// multiply when compiled
+constexpr LinearCalibration SQ212_PAR_CURVE(1000.0f * SQ212_CALIBRATION_FACTOR);
 
 // The constructor - need the power pin and the data pin
 ApogeeSQ212::ApogeeSQ212(int8_t powerPin, uint8_t adsChannel,
@@ -28,6 +31,14 @@ ApogeeSQ212::ApogeeSQ212(int8_t powerPin, uint8_t adsChannel,
 ApogeeSQ212::~ApogeeSQ212() {}
 
 
+// Reads through a shared ADC, registering our channel for its scans
+void ApogeeSQ212::setADC(TIADS1x15Bus& adc) {
+    _adsBus     = &adc;
+    _i2cAddress = adc.getI2CAddress();
+    adc.registerChannel(_adsChannel);
+}
+
+
 String ApogeeSQ212::getSensorLocation(void) {
 #ifndef MS_USE_ADS1015
     String sensorLocation = F("ADS1115_0x");
@@ -51,44 +62,52 @@ bool ApogeeSQ212::addSingleMeasurementResult(void) {
     if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
+        if (_adsBus != nullptr) {
+            // The shared ADC is already set up, and may have converted this
+            // channel in a scan for another sensor
+            adcVoltage = _adsBus->readVoltage(_adsChannel);
+            MS_DBG(F("  Shared ADS channel"), _adsChannel, F(":"), adcVoltage);
+        } else {
 // Create an Auxillary ADD object
 // We create and set up the ADC object here so that each sensor using
 // the ADC may set the gain appropriately without effecting others.
 #ifndef MS_USE_ADS1015
-        Adafruit_ADS1115 ads(_i2cAddress);  // Use this for the 16-bit version
+            // Use this for the 16-bit version
+            Adafruit_ADS1115 ads(_i2cAddress);
 #else
-        Adafruit_ADS1015 ads(_i2cAddress);  // Use this for the 12-bit version
+            // Use this for the 12-bit version
+            Adafruit_ADS1015 ads(_i2cAddress);
 #endif
-        // ADS Library default settings:
-        //  - TI1115 (16 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 128 samples per second (8ms conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-        //  - TI1015 (12 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 1600 samples per second (625µs conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-
-        // Bump the gain up to 1x = +/- 4.096V range
-        // Sensor return range is 0-2.5V, but the next gain option is 2x which
-        // only allows up to 2.048V
-        ads.setGain(GAIN_ONE);
-        // Begin ADC
-        ads.begin();
-
-        // Read Analog to Digital Converter (ADC)
-        // Taking this reading includes the 8ms conversion delay.
-        // We're allowing the ADS1115 library to do the bit-to-volts conversion
-        // for us
-        adcVoltage =
-            ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
-        MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
-               adcVoltage);
+            // ADS Library default settings:
+            //  - TI1115 (16 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 128 samples per second (8ms conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+            //  - TI1015 (12 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 1600 samples per second (625µs conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+
+            // Bump the gain up to 1x = +/- 4.096V range
+            // Sensor return range is 0-2.5V, but the next gain option is 2x
+            // which only allows up to 2.048V
+            ads.setGain(GAIN_ONE);
+            // Begin ADC
+            ads.begin();
+
+            // Read Analog to Digital Converter (ADC)
+            // Taking this reading includes the 8ms conversion delay.
+            // We're allowing the ADS1115 library to do the bit-to-volts
+            // conversion for us
+            adcVoltage =
+                ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
+            MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
+                   adcVoltage);
+        }
 
         if (adcVoltage < 3.6 && adcVoltage > -0.3) {
             // Skip results out of range
-            // Apogee SQ-212 Calibration Factor = 1.0 μmol m-2 s-1 per mV
-            calibResult = 1000 * adcVoltage * SQ212_CALIBRATION_FACTOR;
+            calibResult = SQ212_PAR_CURVE.apply(adcVoltage);
             MS_DBG(F("  calibResult:"), calibResult);
         } else {
             // set invalid voltages back to -9999
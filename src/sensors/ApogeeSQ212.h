@@ -87,6 +87,8 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "TIADS1x15Bus.h"
+#include "CalibrationCurve.h"
 
 /** @ingroup sensor_sq212 */
 /**@{*/
@@ -265,9 +267,22 @@ class ApogeeSQ212 : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Read the channel through an ADS shared with other sensors.
+     *
+     * The shared ADC is configured once and scans all of its channels
+     * together, instead of this sensor setting up its own ADS object for
+     * every reading.  The I2C address is taken from the shared ADC.
+     *
+     * @param adc The TIADS1x15Bus the channel is on
+     */
+    void setADC(TIADS1x15Bus& adc);
+
  private:
     uint8_t _adsChannel;
     uint8_t _i2cAddress;
+    // The shared ADC, if any
+    TIADS1x15Bus* _adsBus = nullptr;
 };
 
 
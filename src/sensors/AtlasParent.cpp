@@ -118,6 +118,10 @@ bool AtlasParent::startSingleMeasurement(void) {
     if (success) {
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        // Start checking the status again
+        _responseCode       = 0;
+        _lastStatusPoll     = _millisMeasurementRequested;
+        _statusPollInterval = ATLAS_STATUS_POLL_INTERVAL_MS;
     } else {
         // Otherwise, make sure that the measurement start time and success bit
         // (bit 6) are unset
@@ -131,16 +135,82 @@ bool AtlasParent::startSingleMeasurement(void) {
 }
 
 
+// The first byte of any response is the status code
+int AtlasParent::readResponse(void) {
+    // call the circuit and request 40 bytes (this may be more than we need)
+    _i2c->requestFrom(static_cast<int>(_i2cAddressHex), 40, 1);
+    int code = _i2c->read();
+    if (code == 1) {
+        uint8_t len = 0;
+        while (_i2c->available() && len < ATLAS_RESPONSE_BUFFER_SIZE - 1) {
+            char c = _i2c->read();
+            // The response ends with a null
+            if (c == '\0') break;
+            _response[len++] = c;
+        }
+        _response[len] = '\0';
+    }
+    return code;
+}
+
+
+// Reading the status code while the circuit is still processing doesn't
+// disturb the reading, so it can be checked well before the measurement time
+bool AtlasParent::isMeasurementComplete(bool debug) {
+    if (!bitRead(_sensorStatus, 6) || _responseCode > 0) { return true; }
+    if (Sensor::isMeasurementComplete(debug)) { return true; }
+
+    uint32_t now     = millis();
+    uint32_t elapsed = now - _millisMeasurementRequested;
+    if (elapsed < _measurementTime_ms / 2 ||
+        now - _lastStatusPoll < _statusPollInterval) {
+        return false;
+    }
+
+    _lastStatusPoll = now;
+    int code        = readResponse();
+    if (code > 0 && code != 254) {
+        _responseCode = code;
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("returned code"), code,
+                   F("after"), elapsed, F("ms"));
+        }
+        return true;
+    }
+    // Still processing, so back off
+    _statusPollInterval *= 2;
+    if (_statusPollInterval > ATLAS_STATUS_POLL_MAX_INTERVAL_MS) {
+        _statusPollInterval = ATLAS_STATUS_POLL_MAX_INTERVAL_MS;
+    }
+    return false;
+}
+
+
+uint32_t AtlasParent::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (remaining == 0 || _responseCode > 0) { return 0; }
+    uint32_t now        = millis();
+    uint32_t pollStart  = _millisMeasurementRequested + _measurementTime_ms / 2;
+    uint32_t nextPollAt = _lastStatusPoll + _statusPollInterval;
+    uint32_t untilPoll  = 0;
+    if (static_cast<int32_t>(pollStart - nextPollAt) > 0) {
+        nextPollAt = pollStart;
+    }
+    if (static_cast<int32_t>(nextPollAt - now) > 0) {
+        untilPoll = nextPollAt - now;
+    }
+    return untilPoll < remaining ? untilPoll : remaining;
+}
+
+
 bool AtlasParent::addSingleMeasurementResult(void) {
     bool success = false;
 
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
     if (bitRead(_sensorStatus, 6)) {
-        // call the circuit and request 40 bytes (this may be more than we need)
-        _i2c->requestFrom(static_cast<int>(_i2cAddressHex), 40, 1);
-        // the first byte is the response code, we read this separately.
-        int code = _i2c->read();
+        // Read the response now if it wasn't already read by a status check
+        int code = _responseCode > 0 ? _responseCode : readResponse();
 
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
         // Parse the response code
@@ -164,14 +234,22 @@ bool AtlasParent::addSingleMeasurementResult(void) {
 
             default: break;
         }
-        // If the response code is successful, parse the remaining results
+        // If the response code is successful, parse the comma separated
+        // results
         if (success) {
+            char* next = _response;
             for (uint8_t i = 0; i < _numReturnedValues; i++) {
-                float result = _i2c->parseFloat();
+                char* end    = next;
+                float result = strtod(next, &end);
+                if (end == next) { result = -9999; }
                 if (isnan(result)) { result = -9999; }
                 if (result < -1020) { result = -9999; }
                 MS_DBG(F("  Result #"), i, ':', result);
                 verifyAndAddMeasurementResult(i, result);
+                // Skip to the next value
+                next = end;
+                while (*next != '\0' && *next != ',') { next++; }
+                if (*next == ',') { next++; }
             }
         }
     } else {
@@ -185,6 +263,7 @@ bool AtlasParent::addSingleMeasurementResult(void) {
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
+    _responseCode               = 0;
     // Unset the status bits for a measurement request (bits 5 & 6)
     _sensorStatus &= 0b10011111;
 
@@ -85,6 +85,32 @@
 #include "SensorBase.h"
 #include <Wire.h>
 
+#ifndef ATLAS_RESPONSE_BUFFER_SIZE
+/**
+ * @brief The most characters of an EZO response kept after the status code.
+ *
+ * The AVR Wire library can't read more than 32 bytes at a time anyway.
+ */
+#define ATLAS_RESPONSE_BUFFER_SIZE 32
+#endif
+
+#ifndef ATLAS_STATUS_POLL_INTERVAL_MS
+/**
+ * @brief The wait between the first two checks of whether an EZO circuit has
+ * finished a reading, in milliseconds.  The wait doubles after each check, up
+ * to #ATLAS_STATUS_POLL_MAX_INTERVAL_MS.
+ */
+#define ATLAS_STATUS_POLL_INTERVAL_MS 20
+#endif
+
+#ifndef ATLAS_STATUS_POLL_MAX_INTERVAL_MS
+/**
+ * @brief The longest wait between checks of whether an EZO circuit has
+ * finished a reading, in milliseconds.
+ */
+#define ATLAS_STATUS_POLL_MAX_INTERVAL_MS 160
+#endif
+
 /**
  * @brief A parent class for Atlas EZO circuits and sensors
  *
@@ -214,6 +240,26 @@ class AtlasParent : public Sensor {
      * successfully.
      */
     bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check whether the EZO circuit has finished its reading.
+     *
+     * Once half of the measurement time has passed, the status code of the
+     * circuit is read, first after #ATLAS_STATUS_POLL_INTERVAL_MS and then at
+     * doubling intervals.  A code of 254 means the reading is still being
+     * processed; any other code finishes the measurement, and the response is
+     * kept for addSingleMeasurementResult().  The full measurement time is
+     * still the longest that is waited.
+     *
+     * @param debug True to output the result to the debugging Serial
+     * @return **bool** True if the circuit has a response ready
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     *
+     * This is the time until the next check of the status code.
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -246,6 +292,33 @@ class AtlasParent : public Sensor {
      * within the wait period.
      */
     bool waitForProcessing(uint32_t timeout = 1000L);
+    /**
+     * @brief Read the response to a reading command.
+     *
+     * If the code is 1, the rest of the response is kept in #_response.
+     *
+     * @return **int** The status code, or -1 if nothing was read
+     */
+    int readResponse(void);
+
+ private:
+    /**
+     * @brief The status code of the last response read, or 0 if none has been
+     * read for the current measurement
+     */
+    int _responseCode = 0;
+    /**
+     * @brief The text of the last successful response
+     */
+    char _response[ATLAS_RESPONSE_BUFFER_SIZE];
+    /**
+     * @brief The millis() of the last status check
+     */
+    uint32_t _lastStatusPoll = 0;
+    /**
+     * @brief The wait until the next status check
+     */
+    uint16_t _statusPollInterval = ATLAS_STATUS_POLL_INTERVAL_MS;
 };
 
 #endif  // SRC_SENSORS_ATLASPARENT_H_
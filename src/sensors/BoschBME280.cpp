@@ -16,6 +16,12 @@ BoschBME280::BoschBME280(TwoWire* theI2C, int8_t powerPin,
     : Sensor("BoschBME280", BME280_NUM_VARIABLES, BME280_WARM_UP_TIME_MS,
              BME280_STABILIZATION_TIME_MS, BME280_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage),
+      _mode(Adafruit_BME280::MODE_FORCED),
+      _pressureOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _tempOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _humidityOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _filterCoeffEnum(Adafruit_BME280::FILTER_OFF),
+      _standbyEnum(Adafruit_BME280::STANDBY_MS_1000),
       _i2cAddressHex(i2cAddressHex),
       _i2c(theI2C) {}
 
@@ -24,9 +30,54 @@ BoschBME280::BoschBME280(int8_t powerPin, uint8_t i2cAddressHex,
     : Sensor("BoschBME280", BME280_NUM_VARIABLES, BME280_WARM_UP_TIME_MS,
              BME280_STABILIZATION_TIME_MS, BME280_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage, BME280_INC_CALC_VARIABLES),
+      _mode(Adafruit_BME280::MODE_FORCED),
+      _pressureOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _tempOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _humidityOversampleEnum(Adafruit_BME280::SAMPLING_X16),
+      _filterCoeffEnum(Adafruit_BME280::FILTER_OFF),
+      _standbyEnum(Adafruit_BME280::STANDBY_MS_1000),
       _i2cAddressHex(i2cAddressHex),
       _i2c(&Wire) {}
 
+BoschBME280::BoschBME280(int8_t powerPin, Adafruit_BME280::sensor_mode mode,
+                         Adafruit_BME280::sensor_sampling  pressureOversample,
+                         Adafruit_BME280::sensor_sampling  tempOversample,
+                         Adafruit_BME280::sensor_sampling  humidityOversample,
+                         Adafruit_BME280::sensor_filter    filterCoeff,
+                         Adafruit_BME280::standby_duration timeStandby,
+                         uint8_t i2cAddressHex, uint8_t measurementsToAverage)
+    : Sensor("BoschBME280", BME280_NUM_VARIABLES, BME280_WARM_UP_TIME_MS,
+             BME280_STABILIZATION_TIME_MS, BME280_MEASUREMENT_TIME_MS, powerPin,
+             -1, measurementsToAverage, BME280_INC_CALC_VARIABLES),
+      _mode(mode),
+      _pressureOversampleEnum(pressureOversample),
+      _tempOversampleEnum(tempOversample),
+      _humidityOversampleEnum(humidityOversample),
+      _filterCoeffEnum(filterCoeff),
+      _standbyEnum(timeStandby),
+      _i2cAddressHex(i2cAddressHex),
+      _i2c(&Wire) {}
+
+BoschBME280::BoschBME280(TwoWire* theI2C, int8_t powerPin,
+                         Adafruit_BME280::sensor_mode      mode,
+                         Adafruit_BME280::sensor_sampling  pressureOversample,
+                         Adafruit_BME280::sensor_sampling  tempOversample,
+                         Adafruit_BME280::sensor_sampling  humidityOversample,
+                         Adafruit_BME280::sensor_filter    filterCoeff,
+                         Adafruit_BME280::standby_duration timeStandby,
+                         uint8_t i2cAddressHex, uint8_t measurementsToAverage)
+    : Sensor("BoschBME280", BME280_NUM_VARIABLES, BME280_WARM_UP_TIME_MS,
+             BME280_STABILIZATION_TIME_MS, BME280_MEASUREMENT_TIME_MS, powerPin,
+             -1, measurementsToAverage, BME280_INC_CALC_VARIABLES),
+      _mode(mode),
+      _pressureOversampleEnum(pressureOversample),
+      _tempOversampleEnum(tempOversample),
+      _humidityOversampleEnum(humidityOversample),
+      _filterCoeffEnum(filterCoeff),
+      _standbyEnum(timeStandby),
+      _i2cAddressHex(i2cAddressHex),
+      _i2c(theI2C) {}
+
 // Destructor
 BoschBME280::~BoschBME280() {}
 
@@ -38,6 +89,13 @@ String BoschBME280::getSensorLocation(void) {
 }
 
 
+// The sampling enum values are the register codes; 1 is 1x and 5 is 16x
+static uint8_t osrRepetitions(Adafruit_BME280::sensor_sampling sampling) {
+    return sampling == Adafruit_BME280::SAMPLING_NONE ? 0
+                                                      : 1 << (sampling - 1);
+}
+
+
 bool BoschBME280::setup(void) {
     bool retVal =
         Sensor::setup();  // this will set pin modes and the setup status bit
@@ -48,14 +106,48 @@ bool BoschBME280::setup(void) {
     if (!wasOn) { powerUp(); }
     waitForWarmUp();
 
+    // Check for the settings that need continuous power
+    if (_powerPin >= 0 && _mode == Adafruit_BME280::MODE_NORMAL) {
+        MS_DBG(F("WARNING:  BME280 will be used in forced mode!  To use in "
+                 "'normal' (continuous sampling) mode the power must be "
+                 "continuously on."));
+        _mode = Adafruit_BME280::MODE_FORCED;
+    }
+    if (_powerPin >= 0 && _filterCoeffEnum != Adafruit_BME280::FILTER_OFF) {
+        MS_DBG(F("WARNING:  BME280's IIR filter is only supported with "
+                 "continuous power!  The filter will not be used!"));
+        _filterCoeffEnum = Adafruit_BME280::FILTER_OFF;
+    }
+
+    // In forced mode, set the measurement time from the oversampling settings
+    if (_mode == Adafruit_BME280::MODE_FORCED) {
+        // From 9.1 of the datasheet, the maximum measurement time is:
+        // 1.25ms + [2.3ms x T_osr] + [2.3ms x P_osr + 0.575ms] +
+        // [2.3ms x H_osr + 0.575ms]
+        // Where each osr is the number of oversampling repetitions, and each
+        // bracketed term is left out if that channel is skipped.
+        uint8_t tOsr = osrRepetitions(_tempOversampleEnum);
+        uint8_t pOsr = osrRepetitions(_pressureOversampleEnum);
+        uint8_t hOsr = osrRepetitions(_humidityOversampleEnum);
+        uint32_t max_measurementTime_us = 1250 + 2300L * tOsr +
+            (pOsr ? 2300L * pOsr + 575 : 0) + (hOsr ? 2300L * hOsr + 575 : 0);
+        _measurementTime_ms = (max_measurementTime_us + 999) / 1000;
+        MS_DBG(F("Expected BME280 max measurement time is"),
+               max_measurementTime_us, F("µs ="), _measurementTime_ms,
+               F("ms"));
+    }
+
     // Run begin fxn because it returns true or false for success in contact
     // Make 5 attempts
     uint8_t ntries  = 0;
     bool    success = false;
     while (!success && ntries < 5) {
+        // This reads the calibration coefficients, which stay with the
+        // library object even if the sensor loses power
         success = bme_internal.begin(_i2cAddressHex, _i2c);
         ntries++;
     }
+    if (success) sendSamplingSettings();
     if (!success) {
         // Set the status error bit (bit 7)
         _sensorStatus |= 0b10000000;
@@ -71,42 +163,59 @@ bool BoschBME280::setup(void) {
 }
 
 
+// The calibration coefficients read at setup don't change, so after power-up
+// the sensor only needs its settings again
 bool BoschBME280::wake(void) {
     // Sensor::wake() checks if the power pin is on and sets the wake timestamp
     // and status bits.  If it returns false, there's no reason to go on.
     if (!Sensor::wake()) return false;
 
-    // Restart always needed after power-up to set sampling modes
-    // As of Adafruit library version 1.0.7, this function includes all of the
-    // various delays to allow the chip to wake up, get calibrations, get
-    // coefficients, and set sampling modes.
-    // This will also restart "Wire"
-    // Currently this is using the settings that Adafruit considered to be
-    // 'default'
-    //  - sensor mode = normal (sensor measures, sleeps for the "standby time"
-    //  and then automatically remeasures
-    //  - temperature oversampling = 16x
-    //  - pressure oversampling = 16x
-    //  - humidity oversampling = 16x
-    //  - built-in IIR filter = off
-    //  - sleep time between measurements = 0.5ms
-    // TODO(SRGDamia1):  Figure out why this is necessary; setSampling should be
-    // enough and this adds a bunch of small delays...
-    bme_internal.begin(_i2cAddressHex, _i2c);
-
-    // When the Adafruit library is updated to remove the built-in delay after
-    // forcing a sample, it would be better to operate in forced mode.
-    bme_internal.setSampling(
-        Adafruit_BME280::MODE_NORMAL,  // sensor mode
-        // bme_internal.setSampling(Adafruit_BME280::MODE_FORCED,  // sensor
-        // mode
-        Adafruit_BME280::SAMPLING_X16,      // temperature oversampling
-        Adafruit_BME280::SAMPLING_X16,      //  pressure oversampling
-        Adafruit_BME280::SAMPLING_X16,      //  humidity oversampling
-        Adafruit_BME280::FILTER_OFF,        // built-in IIR filter
-        Adafruit_BME280::STANDBY_MS_1000);  // sleep time between measurements
-                                            // (N/A in forced mode)
-    delay(100);  // Need this delay after changing sampling mode
+    // A continuously powered sensor keeps its settings
+    if (_powerPin >= 0) sendSamplingSettings();
+
+    return true;
+}
+
+
+void BoschBME280::sendSamplingSettings(void) {
+    // In forced mode, the sensor is left asleep until a measurement is started
+    MS_DBG(F("Sending BME280 sampling settings"));
+    bme_internal.setSampling(_mode == Adafruit_BME280::MODE_NORMAL
+                                 ? Adafruit_BME280::MODE_NORMAL
+                                 : Adafruit_BME280::MODE_SLEEP,
+                             _tempOversampleEnum, _pressureOversampleEnum,
+                             _humidityOversampleEnum, _filterCoeffEnum,
+                             _standbyEnum);
+}
+
+
+// The Adafruit library's takeForcedMeasurement() waits for the conversion to
+// finish, so the forced mode is set by writing the control register directly
+bool BoschBME280::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    // in normal mode, the sensor is already measuring at its own pace
+    if (_mode == Adafruit_BME280::MODE_FORCED) {
+        MS_DBG(F("Starting forced measurement on"), getSensorNameAndLocation());
+        // ctrl_meas (0xF4): temperature and pressure oversampling, then mode
+        _i2c->beginTransmission(_i2cAddressHex);
+        _i2c->write(static_cast<uint8_t>(0xF4));
+        _i2c->write(static_cast<uint8_t>((_tempOversampleEnum << 5) |
+                                         (_pressureOversampleEnum << 2) |
+                                         Adafruit_BME280::MODE_FORCED));
+        if (_i2c->endTransmission() != 0) {
+            MS_DBG(getSensorNameAndLocation(),
+                   F("did not respond to measurement request!"));
+            _millisMeasurementRequested = 0;
+            _sensorStatus &= 0b10111111;
+            return false;
+        }
+        // Update the time that a measurement was requested
+        _millisMeasurementRequested = millis();
+    }
 
     return true;
 }
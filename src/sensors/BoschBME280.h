@@ -71,9 +71,21 @@
  *      - The same sea level pressure flag is used for both the BMP3xx and the BME280.
  * Whatever you select will be used for both sensors.
  *
+ * @section sensor_bme280_modes Sampling Modes
+ * By default, the BME280 is used in forced mode with 16x oversampling of all
+ * three channels and the IIR filter off.  A single measurement is made when it
+ * is requested and the sensor goes back to sleep.  The measurement time is
+ * calculated from the oversampling settings using the maximum times in section
+ * 9.1 of the datasheet - about 113ms at 16x oversampling.
+ *
+ * Normal mode, where the sensor measures continuously and the IIR filter can
+ * be used, is only supported if the sensor is continuously powered.
+ *
  * @section sensor_bme280_ctor Sensor Constructors
  * {{ @ref BoschBME280::BoschBME280(int8_t, uint8_t, uint8_t) }}
  * {{ @ref BoschBME280::BoschBME280(TwoWire*, int8_t, uint8_t, uint8_t) }}
+ * {{ @ref BoschBME280::BoschBME280(int8_t, Adafruit_BME280::sensor_mode, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_filter, Adafruit_BME280::standby_duration, uint8_t, uint8_t) }}
+ * {{ @ref BoschBME280::BoschBME280(TwoWire*, int8_t, Adafruit_BME280::sensor_mode, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_filter, Adafruit_BME280::standby_duration, uint8_t, uint8_t) }}
  *
  * ___
  * @section sensor_bme280_examples Example Code
@@ -128,7 +140,10 @@
 #define BME280_STABILIZATION_TIME_MS 4000
 /**
  * @brief Sensor::_measurementTime_ms; BME280 takes 1100ms to complete a
- * measurement.
+ * measurement in normal mode.
+ *
+ * In forced mode, the measurement time is instead calculated from the
+ * oversampling settings at setup.
  *
  * 1.0 s according to datasheet, but slightly better stdev when 1.1 s
  * For details on BME280 stabilization time updates, include testing sketch and
@@ -293,6 +308,92 @@ class BoschBME280 : public Sensor {
      */
     explicit BoschBME280(int8_t powerPin, uint8_t i2cAddressHex = 0x76,
                          uint8_t measurementsToAverage = 1);
+    /**
+     * @brief Construct a new Bosch BME280 object using the primary hardware I2C
+     * instance and the given sampling settings.
+     *
+     * @param powerPin The pin on the mcu controlling power to the BME280
+     * Use -1 if it is continuously powered.
+     * - The BME280 requires a 1.7 - 3.6V power source
+     * @param mode Data sampling mode
+     * <br>Possible values are:
+     * - `Adafruit_BME280::MODE_FORCED` - a single measurement is made upon
+     * request and the sensor immediately returns to sleep.
+     * - `Adafruit_BME280::MODE_NORMAL` - the sensor alternates between
+     * sampling and sleeping for the standby time.  This mode is only supported
+     * if the sensor is continuously powered.
+     * @param pressureOversample Pressure oversampling setting
+     * <br>Possible values are `Adafruit_BME280::SAMPLING_NONE` (skipped),
+     * `SAMPLING_X1`, `SAMPLING_X2`, `SAMPLING_X4`, `SAMPLING_X8` and
+     * `SAMPLING_X16`.
+     * @param tempOversample Temperature oversampling setting; the values are
+     * the same as for pressureOversample.  The temperature is needed to
+     * compensate both the pressure and humidity, so it should not be skipped.
+     * @param humidityOversample Humidity oversampling setting; the values are
+     * the same as for pressureOversample.
+     * @param filterCoeff Coefficient of the IIR filter.  This is **ignored**
+     * unless the sensor is continuously powered.
+     * <br>Possible values are `Adafruit_BME280::FILTER_OFF`, `FILTER_X2`,
+     * `FILTER_X4`, `FILTER_X8` and `FILTER_X16`.
+     * @param timeStandby Standby time between measurements in normal mode;
+     * ignored in forced mode.  One of the `Adafruit_BME280::STANDBY_MS_`
+     * values, from 0.5ms to 1000ms.
+     * @param i2cAddressHex The I2C address of the BME280; must be either 0x76
+     * or 0x77.  The default value is 0x76.
+     * @param measurementsToAverage The number of measurements to take and
+     * average before giving a "final" result from the sensor; optional with a
+     * default value of 1.
+     */
+    BoschBME280(int8_t powerPin, Adafruit_BME280::sensor_mode mode,
+                Adafruit_BME280::sensor_sampling pressureOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_sampling tempOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_sampling humidityOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_filter filterCoeff =
+                    Adafruit_BME280::FILTER_OFF,
+                Adafruit_BME280::standby_duration timeStandby =
+                    Adafruit_BME280::STANDBY_MS_1000,
+                uint8_t i2cAddressHex         = 0x76,
+                uint8_t measurementsToAverage = 1);
+    /**
+     * @brief Construct a new Bosch BME280 object using a secondary *hardware*
+     * I2C instance and the given sampling settings.
+     *
+     * @param theI2C A TwoWire instance for I2C communication.  See
+     * BoschBME280(TwoWire*, int8_t, uint8_t, uint8_t).
+     * @param powerPin The pin on the mcu controlling power to the BME280
+     * Use -1 if it is continuously powered.
+     * @param mode Data sampling mode
+     * @param pressureOversample Pressure oversampling setting
+     * @param tempOversample Temperature oversampling setting
+     * @param humidityOversample Humidity oversampling setting
+     * @param filterCoeff Coefficient of the IIR filter
+     * @param timeStandby Standby time between measurements in normal mode
+     * @param i2cAddressHex The I2C address of the BME280
+     * @param measurementsToAverage The number of measurements to average
+     *
+     * @see BoschBME280(int8_t, Adafruit_BME280::sensor_mode,
+     * Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_sampling,
+     * Adafruit_BME280::sensor_sampling, Adafruit_BME280::sensor_filter,
+     * Adafruit_BME280::standby_duration, uint8_t, uint8_t) for the possible
+     * values of the settings
+     */
+    BoschBME280(TwoWire* theI2C, int8_t powerPin,
+                Adafruit_BME280::sensor_mode     mode,
+                Adafruit_BME280::sensor_sampling pressureOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_sampling tempOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_sampling humidityOversample =
+                    Adafruit_BME280::SAMPLING_X16,
+                Adafruit_BME280::sensor_filter filterCoeff =
+                    Adafruit_BME280::FILTER_OFF,
+                Adafruit_BME280::standby_duration timeStandby =
+                    Adafruit_BME280::STANDBY_MS_1000,
+                uint8_t i2cAddressHex         = 0x76,
+                uint8_t measurementsToAverage = 1);
     /**
      * @brief Destroy the Bosch BME280 object
      */
@@ -315,7 +416,8 @@ class BoschBME280 : public Sensor {
      * to take readings.
      *
      * This begins the Wire library (sets pin modes for I2C), reads
-     * calibration coefficients from the BME280, and updates the #_sensorStatus.
+     * calibration coefficients from the BME280, calculates the measurement
+     * time from the oversampling settings, and updates the #_sensorStatus.
      * The BME280 must be powered for setup.
      *
      * @return **bool** True if the setup was successful.
@@ -326,7 +428,12 @@ class BoschBME280 : public Sensor {
      */
     String getSensorLocation(void) override;
 
-    // bool startSingleMeasurement(void) override;  // for forced mode
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * In forced mode, this starts a single conversion without waiting for it.
+     */
+    bool startSingleMeasurement(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -337,6 +444,35 @@ class BoschBME280 : public Sensor {
      * @brief Internal reference the the Adafruit BME object
      */
     Adafruit_BME280 bme_internal;
+    /**
+     * @brief Data sampling mode; forced or normal.
+     */
+    Adafruit_BME280::sensor_mode _mode;
+    /**
+     * @brief Pressure oversampling setting
+     */
+    Adafruit_BME280::sensor_sampling _pressureOversampleEnum;
+    /**
+     * @brief Temperature oversampling setting
+     */
+    Adafruit_BME280::sensor_sampling _tempOversampleEnum;
+    /**
+     * @brief Humidity oversampling setting
+     */
+    Adafruit_BME280::sensor_sampling _humidityOversampleEnum;
+    /**
+     * @brief Coefficient of the IIR filter; only used with continuous power.
+     */
+    Adafruit_BME280::sensor_filter _filterCoeffEnum;
+    /**
+     * @brief Standby time between measurements in normal mode.
+     */
+    Adafruit_BME280::standby_duration _standbyEnum;
+    /**
+     * @brief Send the sampling settings to the BME280, leaving it asleep in
+     * forced mode or sampling in normal mode.
+     */
+    void sendSamplingSettings(void);
     /**
      * @brief The I2C address of the BME280.
      */
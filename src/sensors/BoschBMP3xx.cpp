@@ -145,11 +145,27 @@ bool BoschBMP3xx::setup(void) {
             pow(2, static_cast<int>(_filterCoeffEnum)), F("samples"));
     }
 
-    if (_mode == FORCED_MODE) {
+    if (_mode == FORCED_MODE && _burstSamples == 0) {
         MS_DBG(
             F("BMP388/390's standby time setting is ignored in forced mode."));
     }
 
+    // A burst can't sample faster than a conversion takes, and the
+    // measurement has to wait for the whole burst
+    if (_burstSamples > 0) {
+        while (5.0f * pow(2, static_cast<int>(_burstStandbyEnum)) <
+               max_measurementTime_us / 1000) {
+            _burstStandbyEnum = static_cast<TimeStandby>(
+                static_cast<int>(_burstStandbyEnum) + 1);
+        }
+        uint32_t burstInterval_ms = 5UL << static_cast<int>(_burstStandbyEnum);
+        // Allow 10% for the sensor's oscillator
+        _measurementTime_ms += burstInterval_ms * _burstSamples * 11 / 10;
+        MS_DBG(F("BMP388/390 will take bursts of"), _burstSamples,
+               F("samples"), burstInterval_ms, F("ms apart, taking"),
+               _measurementTime_ms, F("ms"));
+    }
+
     // Run begin fxn because it returns true or false for success in contact
     // Make 5 attempts
     uint8_t ntries  = 0;
@@ -261,7 +277,18 @@ bool BoschBMP3xx::startSingleMeasurement(void) {
     // we only need to start a measurement in forced mode
     // in "normal" mode, the sensor to automatically alternates between
     // measuring and sleeping at the prescribed intervals
-    if (_mode == FORCED_MODE) {
+    if (_burstSamples > 0) {
+        // The FIFO collects the burst while the sensor samples on its own
+        MS_DBG(F("Starting a burst of"), _burstSamples, F("samples on"),
+               getSensorNameAndLocation());
+        bmp_internal.setTimeStandby(_burstStandbyEnum);
+        bmp_internal.setFIFONoOfMeasurements(_burstSamples);
+        bmp_internal.enableFIFO();
+        bmp_internal.flushFIFO();
+        bmp_internal.startNormalConversion();
+        // Update the time that a measurement was requested
+        _millisMeasurementRequested = millis();
+    } else if (_mode == FORCED_MODE) {
         MS_DBG(F("Starting forced measurement on"), getSensorNameAndLocation());
         // unfortunately, there's no return value here
         bmp_internal.startForcedConversion();
@@ -273,17 +300,69 @@ bool BoschBMP3xx::startSingleMeasurement(void) {
 }
 
 
+void BoschBMP3xx::setBurstMode(uint8_t numSamples, TimeStandby timeStandby) {
+    _burstSamples = numSamples;
+    if (_burstSamples > BMP3XX_BURST_MAX_SAMPLES) {
+        _burstSamples = BMP3XX_BURST_MAX_SAMPLES;
+    }
+    _burstStandbyEnum = timeStandby;
+}
+
+
 bool BoschBMP3xx::addSingleMeasurementResult(void) {
     bool success = false;
 
     // Initialize float variables
-    float temp  = -9999;
-    float press = -9999;
-    float alt   = -9999;
+    float temp   = -9999;
+    float press  = -9999;
+    float alt    = -9999;
+    float stdDev = -9999;
+    float waveHt = -9999;
 
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
-    if (bitRead(_sensorStatus, 6)) {
+    if (bitRead(_sensorStatus, 6) && _burstSamples > 0) {
+        MS_DBG(getSensorNameAndLocation(), F("is reporting a burst of"),
+               _burstSamples, F("samples:"));
+
+        // Read the whole FIFO at once, and put the sensor back to sleep
+        volatile float    temps[BMP3XX_BURST_MAX_SAMPLES];
+        volatile float    presses[BMP3XX_BURST_MAX_SAMPLES];
+        volatile float    alts[BMP3XX_BURST_MAX_SAMPLES];
+        volatile uint32_t sensorTime;
+        success = bmp_internal.getFIFOData(temps, presses, alts, sensorTime) ==
+            DATA_READY;
+        bmp_internal.stopConversion();
+
+        if (success) {
+            float sumTemp = 0, sumPress = 0, sumAlt = 0;
+            for (uint8_t i = 0; i < _burstSamples; i++) {
+                sumTemp += temps[i];
+                sumPress += presses[i];
+                sumAlt += alts[i];
+            }
+            temp  = sumTemp / _burstSamples;
+            press = sumPress / _burstSamples;
+            alt   = sumAlt / _burstSamples;
+            // A second pass keeps the small deviations from being lost in the
+            // rounding of a sum of squares of ~100000 Pa
+            float sumSq = 0;
+            for (uint8_t i = 0; i < _burstSamples; i++) {
+                sumSq += (presses[i] - press) * (presses[i] - press);
+            }
+            stdDev = sqrt(sumSq / _burstSamples);
+            // Significant wave height is 4 standard deviations of the surface
+            waveHt = 4 * stdDev / (BMP3XX_WATER_DENSITY * 9.80665);
+        } else {
+            MS_DBG(F("  The burst did not fill the FIFO!"));
+        }
+
+        MS_DBG(F("  Mean Temperature:"), temp, F("°C"));
+        MS_DBG(F("  Mean Barometric Pressure:"), press, F("Pa"));
+        MS_DBG(F("  Mean Calculated Altitude:"), alt, F("m ASL"));
+        MS_DBG(F("  Pressure Standard Deviation:"), stdDev, F("Pa"));
+        MS_DBG(F("  Significant Wave Height:"), waveHt, F("m"));
+    } else if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Read values
@@ -307,6 +386,8 @@ bool BoschBMP3xx::addSingleMeasurementResult(void) {
     verifyAndAddMeasurementResult(BMP3XX_TEMP_VAR_NUM, temp);
     verifyAndAddMeasurementResult(BMP3XX_PRESSURE_VAR_NUM, press);
     verifyAndAddMeasurementResult(BMP3XX_ALTITUDE_VAR_NUM, alt);
+    verifyAndAddMeasurementResult(BMP3XX_PRESSURE_STDEV_VAR_NUM, stdDev);
+    verifyAndAddMeasurementResult(BMP3XX_WAVE_HEIGHT_VAR_NUM, waveHt);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
@@ -116,6 +116,14 @@
  *      - The same sea level pressure flag is used for both the BMP3xx and the BME280.
  * Whatever you select will be used for both sensors.
  *
+ * @section sensor_bmp3xx_burst Burst Sampling
+ * For waves and surge, BoschBMP3xx::setBurstMode() has each measurement record
+ * a burst of pressure samples at a fixed output data rate into the sensor's
+ * FIFO.  The mcu is free while the FIFO fills, and the whole FIFO is read once
+ * the burst is done.  The burst is reported as the mean temperature, pressure
+ * and altitude, the standard deviation of the pressure, and a significant wave
+ * height of four times that standard deviation as a height of water.
+ *
  * @section sensor_bmp3xx_ctor Sensor Constructors
  * {{ @ref BoschBMP3xx::BoschBMP3xx(int8_t, Mode, Oversampling, Oversampling, IIRFilter, TimeStandby, uint8_t) }}
  *
@@ -149,11 +157,30 @@
 /**@{*/
 
 // Sensor Specific Defines
-/// @brief Sensor::_numReturnedValues; the BMP3xx can report 3 values.
-#define BMP3XX_NUM_VARIABLES 3
+/// @brief Sensor::_numReturnedValues; the BMP3xx can report 5 values.
+#define BMP3XX_NUM_VARIABLES 5
 /// @brief Sensor::_incCalcValues; altitude is calculted within the Adafruit
-/// library.
-#define BMP3XX_INC_CALC_VARIABLES 1
+/// library, and the pressure standard deviation and wave height are
+/// calculated from a burst.
+#define BMP3XX_INC_CALC_VARIABLES 3
+
+#ifndef BMP3XX_BURST_MAX_SAMPLES
+/**
+ * @brief The most samples in one burst.
+ *
+ * The 512 byte FIFO holds 73 frames of pressure and temperature.  Each sample
+ * takes 12 bytes of stack while the burst is read.
+ */
+#define BMP3XX_BURST_MAX_SAMPLES 48
+#endif
+
+#ifndef BMP3XX_WATER_DENSITY
+/**
+ * @brief The density of the water used to convert the pressure deviations of
+ * a burst into a wave height, in kg/m³.
+ */
+#define BMP3XX_WATER_DENSITY 1000.0
+#endif
 
 /**
  * @anchor sensor_bmp3xx_timing
@@ -302,6 +329,62 @@
 #define BMP3XX_ALTITUDE_DEFAULT_CODE "BoschBMP3xxAltitude"
 /**@}*/
 
+/**
+ * @anchor sensor_bmp3xx_pressure_stdev
+ * @name Pressure Standard Deviation
+ * The standard deviation of the pressure samples in a burst from a Bosch BMP388
+ * or BMP390.  This is only reported in burst mode.
+ *
+ * {{ @ref BoschBMP3xx_PressureStdDev::BoschBMP3xx_PressureStdDev }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the standard deviation
+/// should have 3, the same as the pressure.
+#define BMP3XX_PRESSURE_STDEV_RESOLUTION 3
+/// @brief Sensor variable number; the standard deviation is stored in
+/// sensorValues[3].
+#define BMP3XX_PRESSURE_STDEV_VAR_NUM 3
+/// @brief Variable name; "pressureStandardDeviation", as there is no
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/) term
+/// for a standard deviation
+#define BMP3XX_PRESSURE_STDEV_VAR_NAME "pressureStandardDeviation"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "pascal"
+/// (Pa)
+#define BMP3XX_PRESSURE_STDEV_UNIT_NAME "pascal"
+/// @brief Default variable short code; "BoschBMP3xxPressureStdDev"
+#define BMP3XX_PRESSURE_STDEV_DEFAULT_CODE "BoschBMP3xxPressureStdDev"
+/**@}*/
+
+/**
+ * @anchor sensor_bmp3xx_wave_height
+ * @name Significant Wave Height
+ * A significant wave height calculated from a burst from a Bosch BMP388 or
+ * BMP390.  This is four times the standard deviation of the pressure, as a
+ * height of water of #BMP3XX_WATER_DENSITY, and is only reported in burst
+ * mode.  The pressure waves fade with depth, so this is only a proxy for the
+ * height of the waves at the surface.
+ *
+ * {{ @ref BoschBMP3xx_WaveHeight::BoschBMP3xx_WaveHeight }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the wave height should
+/// have 4 - 0.016 Pa of pressure is 0.0016 mm of water.
+#define BMP3XX_WAVE_HEIGHT_RESOLUTION 4
+/// @brief Sensor variable number; the wave height is stored in
+/// sensorValues[4].
+#define BMP3XX_WAVE_HEIGHT_VAR_NUM 4
+/// @brief Variable name; "significantWaveHeight", as there is no
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/) term
+/// for this wave height
+#define BMP3XX_WAVE_HEIGHT_VAR_NAME "significantWaveHeight"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "meter"
+#define BMP3XX_WAVE_HEIGHT_UNIT_NAME "meter"
+/// @brief Default variable short code; "BoschBMP3xxWaveHeight"
+#define BMP3XX_WAVE_HEIGHT_DEFAULT_CODE "BoschBMP3xxWaveHeight"
+/**@}*/
+
 /// The atmospheric pressure at sea level
 #ifndef SEALEVELPRESSURE_HPA
 #define SEALEVELPRESSURE_HPA (1013.25)
@@ -456,11 +539,40 @@ class BoschBMP3xx : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Set each measurement to record a burst of samples into the
+     * sensor's FIFO.
+     *
+     * The sensor samples in normal mode at the output data rate of the standby
+     * time for the burst, and goes back to sleep once the FIFO is read.  The
+     * measurement time includes the whole burst.  This must be called before
+     * setup().
+     *
+     * @param numSamples The number of samples in each burst, up to
+     * #BMP3XX_BURST_MAX_SAMPLES; 0 for single measurements.
+     * @param timeStandby The time between the samples of the burst.  Default
+     * is `TIME_STANDBY_40MS`, an ODR of 25 Hz.  A time shorter than a single
+     * conversion with the oversampling set is lengthened.
+     *
+     * @see @ref sensor_bmp3xx_burst
+     */
+    void setBurstMode(uint8_t     numSamples,
+                      TimeStandby timeStandby = TIME_STANDBY_40MS);
+
  private:
     /**
      * @brief Internal reference the the BMP388_DEV object
      */
     BMP388_DEV bmp_internal;
+    /**
+     * @brief The number of samples in each burst, or 0 for single
+     * measurements.
+     */
+    uint8_t _burstSamples = 0;
+    /**
+     * @brief The standby time between the samples of a burst.
+     */
+    TimeStandby _burstStandbyEnum = TIME_STANDBY_40MS;
 
     /**
      * @brief Data sampling mode
@@ -691,5 +803,88 @@ class BoschBMP3xx_Altitude : public Variable {
                    BMP3XX_ALTITUDE_VAR_NAME, BMP3XX_ALTITUDE_UNIT_NAME,
                    BMP3XX_ALTITUDE_DEFAULT_CODE) {}
 };
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [pressure standard deviation](@ref sensor_bmp3xx_pressure_stdev) of a burst
+ * from a [Bosch BMP3xx](@ref sensor_bmp3xx).
+ *
+ * @ingroup sensor_bmp3xx
+ */
+/* clang-format on */
+class BoschBMP3xx_PressureStdDev : public Variable {
+ public:
+    /**
+     * @brief Construct a new BoschBMP3xx_PressureStdDev object.
+     *
+     * @param parentSense The parent BoschBMP3xx providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "BoschBMP3xxPressureStdDev".
+     */
+    explicit BoschBMP3xx_PressureStdDev(
+        BoschBMP3xx* parentSense, const char* uuid = "",
+        const char* varCode = BMP3XX_PRESSURE_STDEV_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)BMP3XX_PRESSURE_STDEV_VAR_NUM,
+                   (uint8_t)BMP3XX_PRESSURE_STDEV_RESOLUTION,
+                   BMP3XX_PRESSURE_STDEV_VAR_NAME,
+                   BMP3XX_PRESSURE_STDEV_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new BoschBMP3xx_PressureStdDev object.
+     *
+     * @note This must be tied with a parent BoschBMP3xx before it can be used.
+     */
+    BoschBMP3xx_PressureStdDev()
+        : Variable((const uint8_t)BMP3XX_PRESSURE_STDEV_VAR_NUM,
+                   (uint8_t)BMP3XX_PRESSURE_STDEV_RESOLUTION,
+                   BMP3XX_PRESSURE_STDEV_VAR_NAME,
+                   BMP3XX_PRESSURE_STDEV_UNIT_NAME,
+                   BMP3XX_PRESSURE_STDEV_DEFAULT_CODE) {}
+};
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [significant wave height](@ref sensor_bmp3xx_wave_height) calculated from a
+ * burst from a [Bosch BMP3xx](@ref sensor_bmp3xx).
+ *
+ * @ingroup sensor_bmp3xx
+ */
+/* clang-format on */
+class BoschBMP3xx_WaveHeight : public Variable {
+ public:
+    /**
+     * @brief Construct a new BoschBMP3xx_WaveHeight object.
+     *
+     * @param parentSense The parent BoschBMP3xx providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "BoschBMP3xxWaveHeight".
+     */
+    explicit BoschBMP3xx_WaveHeight(
+        BoschBMP3xx* parentSense, const char* uuid = "",
+        const char* varCode = BMP3XX_WAVE_HEIGHT_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)BMP3XX_WAVE_HEIGHT_VAR_NUM,
+                   (uint8_t)BMP3XX_WAVE_HEIGHT_RESOLUTION,
+                   BMP3XX_WAVE_HEIGHT_VAR_NAME, BMP3XX_WAVE_HEIGHT_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new BoschBMP3xx_WaveHeight object.
+     *
+     * @note This must be tied with a parent BoschBMP3xx before it can be used.
+     */
+    BoschBMP3xx_WaveHeight()
+        : Variable((const uint8_t)BMP3XX_WAVE_HEIGHT_VAR_NUM,
+                   (uint8_t)BMP3XX_WAVE_HEIGHT_RESOLUTION,
+                   BMP3XX_WAVE_HEIGHT_VAR_NAME, BMP3XX_WAVE_HEIGHT_UNIT_NAME,
+                   BMP3XX_WAVE_HEIGHT_DEFAULT_CODE) {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_BOSCHBMP3XX_H_
@@ -20,14 +20,20 @@ CampbellOBS3::CampbellOBS3(int8_t powerPin, uint8_t adsChannel,
              OBS3_STABILIZATION_TIME_MS, OBS3_MEASUREMENT_TIME_MS, powerPin, -1,
              measurementsToAverage, OBS3_INC_CALC_VARIABLES),
       _adsChannel(adsChannel),
-      _x2_coeff_A(x2_coeff_A),
-      _x1_coeff_B(x1_coeff_B),
-      _x0_coeff_C(x0_coeff_C),
+      _calibration(x2_coeff_A, x1_coeff_B, x0_coeff_C),
       _i2cAddress(i2cAddress) {}
 // Destructor
 CampbellOBS3::~CampbellOBS3() {}
 
 
+// Reads through a shared ADC, registering our channel for its scans
+void CampbellOBS3::setADC(TIADS1x15Bus& adc) {
+    _adsBus     = &adc;
+    _i2cAddress = adc.getI2CAddress();
+    adc.registerChannel(_adsChannel);
+}
+
+
 String CampbellOBS3::getSensorLocation(void) {
 #ifndef MS_USE_ADS1015
     String sensorLocation = F("ADS1115_0x");
@@ -51,49 +57,59 @@ bool CampbellOBS3::addSingleMeasurementResult(void) {
     if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
+        if (_adsBus != nullptr) {
+            // The shared ADC is already set up, and may have converted this
+            // channel in a scan for another sensor
+            adcVoltage = _adsBus->readVoltage(_adsChannel);
+            MS_DBG(F("  Shared ADS channel"), _adsChannel, F(":"), adcVoltage);
+        } else {
 // Create an Auxillary ADD object
 // We create and set up the ADC object here so that each sensor using
 // the ADC may set the gain appropriately without effecting others.
 #ifndef MS_USE_ADS1015
-        Adafruit_ADS1115 ads(_i2cAddress);  // Use this for the 16-bit version
+            // Use this for the 16-bit version
+            Adafruit_ADS1115 ads(_i2cAddress);
 #else
-        Adafruit_ADS1015 ads(_i2cAddress);  // Use this for the 12-bit version
+            // Use this for the 12-bit version
+            Adafruit_ADS1015 ads(_i2cAddress);
 #endif
-        // ADS Library default settings:
-        //  - TI1115 (16 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 128 samples per second (8ms conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-        //  - TI1015 (12 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 1600 samples per second (625µs conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-
-        // Bump the gain up to 1x = +/- 4.096V range
-        // Sensor return range is 0-2.5V, but the next gain option is 2x which
-        // only allows up to 2.048V
-        ads.setGain(GAIN_ONE);
-        // Begin ADC
-        ads.begin();
-
-        // Print out the calibration curve
-        MS_DBG(F("  Input calibration Curve:"), _x2_coeff_A, F("x^2 +"),
-               _x1_coeff_B, F("x +"), _x0_coeff_C);
-
-        // Read Analog to Digital Converter (ADC)
-        // Taking this reading includes the 8ms conversion delay.
-        // We're allowing the ADS1115 library to do the bit-to-volts conversion
-        // for us
-        adcVoltage =
-            ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
-        MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
-               adcVoltage);
+            // ADS Library default settings:
+            //  - TI1115 (16 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 128 samples per second (8ms conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+            //  - TI1015 (12 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 1600 samples per second (625µs conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+
+            // Bump the gain up to 1x = +/- 4.096V range
+            // Sensor return range is 0-2.5V, but the next gain option is 2x
+            // which only allows up to 2.048V
+            ads.setGain(GAIN_ONE);
+            // Begin ADC
+            ads.begin();
+
+            // Print out the calibration curve
+            MS_DBG(F("  Input calibration Curve:"),
+                   _calibration.getCoefficient(2), F("x^2 +"),
+                   _calibration.getCoefficient(1), F("x +"),
+                   _calibration.getCoefficient(0));
+
+            // Read Analog to Digital Converter (ADC)
+            // Taking this reading includes the 8ms conversion delay.
+            // We're allowing the ADS1115 library to do the bit-to-volts
+            // conversion for us
+            adcVoltage =
+                ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
+            MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
+                   adcVoltage);
+        }
 
         if (adcVoltage < 3.6 && adcVoltage > -0.3) {
             // Skip results out of range
             // Apply the unique calibration curve for the given sensor
-            calibResult = (_x2_coeff_A * sq(adcVoltage)) +
-                (_x1_coeff_B * adcVoltage) + _x0_coeff_C;
+            calibResult = _calibration.apply(adcVoltage);
             MS_DBG(F("  calibResult:"), calibResult);
         } else {  // set invalid voltages back to -9999
             adcVoltage = -9999;
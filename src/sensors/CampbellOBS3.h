@@ -80,6 +80,8 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "TIADS1x15Bus.h"
+#include "CalibrationCurve.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_obs3 */
@@ -268,10 +270,23 @@ class CampbellOBS3 : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Read the channel through an ADS shared with other sensors.
+     *
+     * The shared ADC is configured once and scans all of its channels
+     * together, instead of this sensor setting up its own ADS object for
+     * every reading.  The I2C address is taken from the shared ADC.
+     *
+     * @param adc The TIADS1x15Bus the channel is on
+     */
+    void setADC(TIADS1x15Bus& adc);
+
  private:
-    uint8_t _adsChannel;
-    float   _x2_coeff_A, _x1_coeff_B, _x0_coeff_C;
-    uint8_t _i2cAddress;
+    uint8_t                  _adsChannel;
+    PolynomialCalibration<2> _calibration;
+    uint8_t                  _i2cAddress;
+    // The shared ADC, if any
+    TIADS1x15Bus* _adsBus = nullptr;
 };
 
 
@@ -19,16 +19,17 @@ EverlightALSPT19::EverlightALSPT19(int8_t powerPin, int8_t dataPin,
              ALSPT19_WARM_UP_TIME_MS, ALSPT19_STABILIZATION_TIME_MS,
              ALSPT19_MEASUREMENT_TIME_MS, powerPin, dataPin,
              measurementsToAverage),
-      _supplyVoltage(supplyVoltage),
-      _loadResistor(loadResistor) {}
+      _toVolts(supplyVoltage / static_cast<float>(ALSPT19_ADC_MAX)),
+      _toMicroamps(1000 / loadResistor) {}
 EverlightALSPT19::EverlightALSPT19(uint8_t measurementsToAverage)
     : Sensor("Everlight ALS-PT19", ALSPT19_NUM_VARIABLES,
              ALSPT19_WARM_UP_TIME_MS, ALSPT19_STABILIZATION_TIME_MS,
              ALSPT19_MEASUREMENT_TIME_MS, MAYFLY_ALS_POWER_PIN,
              MAYFLY_ALS_DATA_PIN, measurementsToAverage,
              ALSPT19_INC_CALC_VARIABLES),
-      _supplyVoltage(MAYFLY_ALS_SUPPLY_VOLTAGE),
-      _loadResistor(MAYFLY_ALS_LOADING_RESISTANCE) {}
+      _toVolts(MAYFLY_ALS_SUPPLY_VOLTAGE /
+               static_cast<float>(ALSPT19_ADC_MAX)),
+      _toMicroamps(1000.0f / MAYFLY_ALS_LOADING_RESISTANCE) {}
 EverlightALSPT19::~EverlightALSPT19() {}
 
 
@@ -66,11 +67,10 @@ bool EverlightALSPT19::addSingleMeasurementResult(void) {
             sensor_adc = 1;
         }
         // convert bits to volts
-        volt_val = (_supplyVoltage / static_cast<float>(ALSPT19_ADC_MAX)) *
-            static_cast<float>(sensor_adc);
+        volt_val = _toVolts.apply(static_cast<float>(sensor_adc));
         // convert volts to current
         // resistance is entered in kΩ and we want µA
-        current_val = (volt_val / (_loadResistor * 1000)) * 1e6;
+        current_val = _toMicroamps.apply(volt_val);
         // convert current to illuminance
         // from sensor datasheet, typical 200µA current for1000 Lux
         lux_val = current_val * (1000. / 200.);
@@ -58,6 +58,7 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "CalibrationCurve.h"
 
 /** @ingroup sensor_alspt19 */
 /**@{*/
@@ -308,13 +309,15 @@ class EverlightALSPT19 : public Sensor {
 
  private:
     /**
-     * @brief The power supply voltage
+     * @brief The conversion of ADC counts to volts, from the power supply
+     * voltage
      */
-    float _supplyVoltage;
+    LinearCalibration _toVolts;
     /**
-     * @brief The loading resistance
+     * @brief The conversion of volts to microamps, from the loading
+     * resistance
      */
-    float _loadResistor;
+    LinearCalibration _toMicroamps;
 };
 
 
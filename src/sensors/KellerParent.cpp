@@ -46,6 +46,21 @@ KellerParent::KellerParent(byte modbusAddress, Stream& stream, int8_t powerPin,
 KellerParent::~KellerParent() {}
 
 
+void KellerParent::setBus(RS485Bus& bus) {
+    _bus = &bus;
+    bus.addSensor(this);
+}
+
+
+// Holds a finished result while other sensors on the bus still need starting
+bool KellerParent::isMeasurementComplete(bool debug) {
+    if (!Sensor::isMeasurementComplete(debug)) return false;
+    if (_bus == nullptr || !bitRead(_sensorStatus, 6)) return true;
+    return !_bus->deferResult(_millisMeasurementRequested +
+                              _measurementTime_ms);
+}
+
+
 // The sensor installation location on the Mayfly
 String KellerParent::getSensorLocation(void) {
     String sensorLocation = F("modbus_0x");
@@ -69,6 +84,9 @@ bool KellerParent::setup(void) {
     // required This realy can't fail so adding the return value is just for
     // show
     retVal &= _ksensor.begin(_model, _modbusAddress, _stream, _RS485EnablePin);
+    if (_batchedRead) {
+        retVal &= _modbus.begin(_modbusAddress, _stream, _RS485EnablePin);
+    }
 
     return retVal;
 }
@@ -76,54 +94,40 @@ bool KellerParent::setup(void) {
 
 // This turns on sensor power
 void KellerParent::powerUp(void) {
-    if (_powerPin >= 0) {
-        MS_DBG(F("Powering"), getSensorNameAndLocation(), F("with pin"),
-               _powerPin);
-        digitalWrite(_powerPin, HIGH);
-        // Mark the time that the sensor was powered
-        _millisPowerOn = millis();
-    }
+    // The primary power, and any rail it is on, is handled by the base class
+    Sensor::powerUp();
     if (_powerPin2 >= 0) {
         MS_DBG(F("Applying secondary power to"), getSensorNameAndLocation(),
                F("with pin"), _powerPin2);
         digitalWrite(_powerPin2, HIGH);
     }
-    if (_powerPin < 0 && _powerPin2 < 0) {
-        MS_DBG(F("Power to"), getSensorNameAndLocation(),
-               F("is not controlled by this library."));
-    }
-    // Set the status bit for sensor power attempt (bit 1) and success (bit 2)
-    _sensorStatus |= 0b00000110;
 }
 
 
 // This turns off sensor power
 void KellerParent::powerDown(void) {
-    if (_powerPin >= 0) {
-        MS_DBG(F("Turning off power to"), getSensorNameAndLocation(),
-               F("with pin"), _powerPin);
-        digitalWrite(_powerPin, LOW);
-        // Unset the power-on time
-        _millisPowerOn = 0;
-        // Unset the activation time
-        _millisSensorActivated = 0;
-        // Unset the measurement request time
-        _millisMeasurementRequested = 0;
-        // Unset the status bits for sensor power (bits 1 & 2),
-        // activation (bits 3 & 4), and measurement request (bits 5 & 6)
-        _sensorStatus &= 0b10000001;
-    }
+    Sensor::powerDown();
     if (_powerPin2 >= 0) {
         MS_DBG(F("Turning off secondary power to"), getSensorNameAndLocation(),
                F("with pin"), _powerPin2);
         digitalWrite(_powerPin2, LOW);
     }
-    if (_powerPin < 0 && _powerPin2 < 0) {
-        MS_DBG(F("Power to"), getSensorNameAndLocation(),
-               F("is not controlled by this library."));
-        // Do NOT unset any status bits or timestamps if we didn't really power
-        // down!
+}
+
+
+// Reads P1 through TOB1 in one request, instead of one request for each
+bool KellerParent::getBatchedValues(float& waterPressureBar,
+                                    float& waterTempertureC) {
+    if (!_modbus.getRegisters(0x03, KELLER_BATCH_FIRST_REGISTER,
+                              KELLER_BATCH_REGISTER_COUNT)) {
+        MS_DBG(F("  Batched read failed"));
+        return false;
     }
+    // The data starts after the address, function code, and byte count
+    waterPressureBar = _modbus.float32FromFrame(bigEndian, 3);
+    waterTempertureC = _modbus.float32FromFrame(bigEndian,
+                                                3 + KELLER_BATCH_TOB1_OFFSET);
+    return true;
 }
 
 
@@ -142,7 +146,13 @@ bool KellerParent::addSingleMeasurementResult(void) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         // Get Values
-        success     = _ksensor.getValues(waterPressureBar, waterTempertureC);
+        beginFrame();
+        if (_batchedRead) {
+            success = getBatchedValues(waterPressureBar, waterTempertureC);
+        } else {
+            success = _ksensor.getValues(waterPressureBar, waterTempertureC);
+        }
+        endFrame();
         waterDepthM = _ksensor.calcWaterDepthM(
             waterPressureBar,
             waterTempertureC);  // float calcWaterDepthM(float waterPressureBar,
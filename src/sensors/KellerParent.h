@@ -96,7 +96,9 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "RS485Bus.h"
 #include <KellerModbus.h>
+#include <SensorModbusMaster.h>
 
 /** @ingroup keller_group */
 /**@{*/
@@ -160,6 +162,21 @@
 #define KELLER_HEIGHT_UNIT_NAME "meter"
 /**@}*/
 
+/**
+ * @anchor keller_batch
+ * @name Batched Reads
+ * The process value registers read together by KellerParent::setBatchedRead()
+ */
+/**@{*/
+/// @brief The first register of a batched read; the pressure P1, as a big
+/// endian float in two registers
+#define KELLER_BATCH_FIRST_REGISTER 0x0002
+/// @brief The number of registers in a batched read; P1, P2, T, and TOB1
+#define KELLER_BATCH_REGISTER_COUNT 8
+/// @brief The offset of the TOB1 temperature from P1, in bytes of the frame
+#define KELLER_BATCH_TOB1_OFFSET 12
+/**@}*/
+
 /**
  * @brief The Sensor sub-class for all
  * [Keller water level sensors](@ref keller_group).
@@ -248,13 +265,72 @@ class KellerParent : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Share an RS485 bus with other modbus sensors.
+     *
+     * The bus keeps a quiet interval between the transactions of different
+     * sensors and starts every sensor's measurement before collecting any of
+     * their results; see RS485Bus.
+     *
+     * @param bus The RS485Bus of the stream the sensor is on
+     */
+    void setBus(RS485Bus& bus);
+    /**
+     * @copydoc Sensor::isMeasurementComplete()
+     *
+     * On a shared bus, a finished result may be held back while other sensors
+     * on the bus are waiting to be started.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+
+    /**
+     * @brief Set whether the pressure and temperature are read in a single
+     * modbus request.
+     *
+     * The Keller library reads the pressure (P1) and the temperature (TOB1)
+     * in two requests, each with its own response timeout and inter-frame
+     * gap.  A batched read fetches all of the process values from P1 through
+     * TOB1 in one request instead.  This must be set before setup().
+     *
+     * @note A faster bus is set by the baud rate of the stream given to the
+     * constructor; it must match the rate programmed into the sensor.
+     *
+     * @param batchedRead True to read both values in one request.  Default is
+     * false.
+     */
+    void setBatchedRead(bool batchedRead) {
+        _batchedRead = batchedRead;
+    }
+
  private:
+    // Wait for, and then release, a shared bus around each transaction
+    void beginFrame(void) {
+        if (_bus != nullptr) _bus->beginFrame(this);
+    }
+    void endFrame(void) {
+        if (_bus != nullptr) _bus->endFrame(this);
+    }
+
+    /**
+     * @brief Read the pressure and the temperature in a single request.
+     *
+     * @param waterPressureBar The pressure, in bar
+     * @param waterTempertureC The temperature, in °C
+     * @return **bool** True if the request was answered
+     */
+    bool getBatchedValues(float& waterPressureBar, float& waterTempertureC);
+
     keller      _ksensor;
     kellerModel _model;
     byte        _modbusAddress;
     Stream*     _stream;
     int8_t      _RS485EnablePin;
     int8_t      _powerPin2;
+    // The shared bus, if any
+    RS485Bus* _bus = nullptr;
+    // The modbus instance for batched reads, on the same stream
+    bool         _batchedRead = false;
+    modbusMaster _modbus;
 };
 /**@}*/
 #endif  // SRC_SENSORS_KELLERPARENT_H_
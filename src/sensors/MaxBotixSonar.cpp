@@ -51,6 +51,43 @@ bool MaxBotixSonar::setup(void) {
 }
 
 
+// If it cannot obtain a result, the sonar is supposed to send a value just
+// above it's max range.  For 10m models, this is 9999, for 5m models it's 4999.
+// The sonar might also send readings of 300 or 500 (the blanking distance) if
+// there are too many acoustic echos.  If the result becomes garbled or the
+// sonar is disconnected, there is no frame and the range is 0.  Luckily, these
+// sensors are not capable of reading 0, so we also know the 0 value is bad.
+static bool isBadRange(int16_t range) {
+    return range <= 300 || range == 500 || range == 4999 || range == 9999;
+}
+
+
+// Sorts a short array in place
+static void sortRanges(int16_t* values, uint8_t n) {
+    for (uint8_t i = 1; i < n; i++) {
+        int16_t value = values[i];
+        uint8_t j     = i;
+        for (; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+
+// The median of a sorted array
+static float sortedMedian(const int16_t* values, uint8_t n) {
+    if (n % 2) return values[n / 2];
+    return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+
+void MaxBotixSonar::setBurstMode(uint8_t burstReadings) {
+    if (burstReadings > HRXL_BURST_MAX_READINGS) {
+        burstReadings = HRXL_BURST_MAX_READINGS;
+    }
+    _burstReadings = burstReadings;
+}
+
+
 // Parsing and tossing the header lines in the wake-up
 bool MaxBotixSonar::wake(void) {
     // Sensor::wake() checks if the power pin is on and sets the wake timestamp
@@ -95,8 +132,9 @@ bool MaxBotixSonar::wake(void) {
 
 bool MaxBotixSonar::addSingleMeasurementResult(void) {
     // Initialize values
-    bool    success = false;
-    int16_t result  = -9999;
+    bool  success = false;
+    float result  = -9999;
+    float spread  = -9999;
 
     // Clear anything out of the stream buffer
     auto junkChars = static_cast<uint8_t>(_stream->available());
@@ -117,7 +155,10 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
 
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
-    if (bitRead(_sensorStatus, 6)) {
+    if (bitRead(_sensorStatus, 6) && _burstReadings > 0) {
+        MS_DBG(getSensorNameAndLocation(), F("is reporting a burst:"));
+        success = readBurst(result, spread);
+    } else if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
         uint8_t rangeAttempts = 0;
@@ -135,28 +176,18 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
                 digitalWrite(_triggerPin, LOW);
             }
 
-            // Immediately ask for a result and let the stream timeout be our
+            // Immediately ask for a result and let the frame timeout be our
             // "wait" for the measurement.
-            result = static_cast<uint16_t>(_stream->parseInt());
-            _stream->read();  // To throw away the carriage return
-            MS_DBG(F("  Sonar Range:"), result);
+            int16_t range = readRangeFrame();
+            MS_DBG(F("  Sonar Range:"), range);
             rangeAttempts++;
 
-            // If it cannot obtain a result , the sonar is supposed to send a
-            // value just above it's max range.  For 10m models, this is 9999,
-            // for 5m models it's 4999.  The sonar might also send readings of
-            // 300 or 500 (the blanking distance) if there are too many acoustic
-            // echos. If the result becomes garbled or the sonar is
-            // disconnected, the parseInt function returns 0.  Luckily, these
-            // sensors are not capable of reading 0, so we also know the 0 value
-            // is bad.
-            if (result <= 300 || result == 500 || result == 4999 ||
-                result == 9999 || result == 0) {
+            if (isBadRange(range)) {
                 MS_DBG(F("  Bad or Suspicious Result, Retry Attempt #"),
                        rangeAttempts);
-                result = -9999;
             } else {
                 MS_DBG(F("  Good result found"));
+                result  = range;
                 success = true;
             }
         }
@@ -165,6 +196,7 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
     }
 
     verifyAndAddMeasurementResult(HRXL_VAR_NUM, result);
+    verifyAndAddMeasurementResult(HRXL_SPREAD_VAR_NUM, spread);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
@@ -174,3 +206,72 @@ bool MaxBotixSonar::addSingleMeasurementResult(void) {
     // Return values shows if we got a not-obviously-bad reading
     return success;
 }
+
+
+// Reads the characters as they come in, so nothing waits on a stream timeout
+// once the carriage return arrives
+int16_t MaxBotixSonar::readRangeFrame(void) {
+    int16_t  range  = -1;  // -1 until the frame's 'R' is seen
+    uint8_t  digits = 0;
+    uint32_t start  = millis();
+    while (millis() - start < HRXL_FRAME_TIMEOUT_MS) {
+        int c = _stream->read();
+        if (c < 0) continue;
+        if (c == 'R') {
+            range  = 0;
+            digits = 0;
+        } else if (range >= 0 && c >= '0' && c <= '9' && digits < 4) {
+            range = range * 10 + (c - '0');
+            digits++;
+        } else if (range >= 0 && c == '\r' && digits > 0) {
+            return range;
+        } else {
+            // Garbled; wait for the start of the next frame
+            range = -1;
+        }
+    }
+    return 0;
+}
+
+
+bool MaxBotixSonar::readBurst(float& median, float& spread) {
+    median = -9999;
+    spread = -9999;
+
+    // Holding the trigger high makes the sensor range continuously
+    if (_triggerPin >= 0) { digitalWrite(_triggerPin, HIGH); }
+
+    int16_t ranges[HRXL_BURST_MAX_READINGS];
+    uint8_t nGood    = 0;
+    uint8_t attempts = 0;
+    // Allow as many bad frames as the number of good ones wanted
+    while (nGood < _burstReadings && attempts < 2 * _burstReadings) {
+        int16_t range = readRangeFrame();
+        attempts++;
+        if (isBadRange(range)) {
+            MS_DBG(F("  Bad or Suspicious Result:"), range);
+        } else {
+            ranges[nGood++] = range;
+        }
+    }
+
+    if (_triggerPin >= 0) { digitalWrite(_triggerPin, LOW); }
+
+    MS_DBG(F("  Good ranges:"), nGood, F("of"), attempts);
+    if (nGood == 0) return false;
+
+    sortRanges(ranges, nGood);
+    median = sortedMedian(ranges, nGood);
+    // Reuse the array for the absolute deviations
+    for (uint8_t i = 0; i < nGood; i++) {
+        float deviation = ranges[i] - median;
+        // The deviations are whole or half millimeters; keep them as doubled
+        // integers so they sort the same way
+        ranges[i] = static_cast<int16_t>(2 * fabs(deviation));
+    }
+    sortRanges(ranges, nGood);
+    spread = sortedMedian(ranges, nGood) / 2;
+    MS_DBG(F("  Median Range:"), median);
+    MS_DBG(F("  Range Spread:"), spread);
+    return true;
+}
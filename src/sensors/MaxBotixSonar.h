@@ -116,10 +116,23 @@
 /**@{*/
 
 // Sensor Specific Defines
-/// @brief Sensor::_numReturnedValues; the HRXL can report 1 value.
-#define HRXL_NUM_VARIABLES 1
-/// @brief Sensor::_incCalcValues; we don't calculate any additional values.
-#define HRXL_INC_CALC_VARIABLES 0
+/// @brief Sensor::_numReturnedValues; the HRXL can report 2 values.
+#define HRXL_NUM_VARIABLES 2
+/// @brief Sensor::_incCalcValues; the range spread is calculated from a burst
+/// of readings.
+#define HRXL_INC_CALC_VARIABLES 1
+
+#ifndef HRXL_BURST_MAX_READINGS
+/**
+ * @brief The most readings in one burst.
+ *
+ * The readings are held on the stack while the median is found.
+ */
+#define HRXL_BURST_MAX_READINGS 31
+#endif
+/// @brief The longest wait for one range frame; even the slowest sensors
+/// should respond at a rate of 6Hz (166ms).
+#define HRXL_FRAME_TIMEOUT_MS 180
 
 /**
  * @anchor sensor_maxbotix_timing
@@ -164,6 +177,32 @@
 #define HRXL_DEFAULT_CODE "SonarRange"
 /**@}*/
 
+/**
+ * @anchor sensor_maxbotix_spread
+ * @name Range Spread
+ * The spread of a burst of ranges from a Maxbotix HRXL ultrasonic range finder
+ * - This is the median absolute deviation of the burst from its median.
+ * - It is only reported in burst mode.
+ *
+ * {{ @ref MaxBotixSonar_RangeSpread::MaxBotixSonar_RangeSpread }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the spread should have 1.
+#define HRXL_SPREAD_RESOLUTION 1
+/// @brief Sensor variable number; the spread is stored in sensorValues[1].
+#define HRXL_SPREAD_VAR_NUM 1
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "distance"
+#define HRXL_SPREAD_VAR_NAME "distance"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millimeter"
+#define HRXL_SPREAD_UNIT_NAME "millimeter"
+/// @brief Default variable short code; "SonarRangeSpread"
+#define HRXL_SPREAD_DEFAULT_CODE "SonarRangeSpread"
+/**@}*/
+
 
 /* clang-format off */
 /**
@@ -234,6 +273,21 @@ class MaxBotixSonar : public Sensor {
      */
     bool wake(void) override;
 
+    /**
+     * @brief Set the sensor to take a burst of readings for each measurement.
+     *
+     * In burst mode the sensor free-runs, with the trigger held high if there
+     * is one, and ranges are read as fast as the sensor sends them.  The result
+     * is the median of the good ranges in the burst, and the spread is their
+     * median absolute deviation.  This is much less sensitive to waves and
+     * stray echoes than an average.
+     *
+     * @param burstReadings The number of good ranges in each burst, up to
+     * #HRXL_BURST_MAX_READINGS, or 0 for one range per measurement.  Default
+     * is 0.
+     */
+    void setBurstMode(uint8_t burstReadings);
+
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -242,6 +296,26 @@ class MaxBotixSonar : public Sensor {
  private:
     int8_t  _triggerPin;
     Stream* _stream;
+    /**
+     * @brief The number of good ranges in each burst, or 0 if not bursting
+     */
+    uint8_t _burstReadings = 0;
+    /**
+     * @brief Read one range frame, "R" and the digits ending with a carriage
+     * return, straight from the stream.  Partial frames are skipped.
+     *
+     * @return **int16_t** The range, or 0 if no frame arrived in
+     * #HRXL_FRAME_TIMEOUT_MS
+     */
+    int16_t readRangeFrame(void);
+    /**
+     * @brief Take a burst of ranges.
+     *
+     * @param median The median of the good ranges
+     * @param spread The median absolute deviation of the good ranges
+     * @return **bool** True if any good ranges were read
+     */
+    bool readBurst(float& median, float& spread);
 };
 
 
@@ -286,5 +360,50 @@ class MaxBotixSonar_Range : public Variable {
      */
     ~MaxBotixSonar_Range() {}
 };
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [range spread output](@ref sensor_maxbotix_spread) from a
+ * [MaxBotix HRXL-MaxSonar ultrasonic range finder](@ref sensor_maxbotix) in
+ * burst mode.
+ *
+ * @ingroup sensor_maxbotix
+ */
+/* clang-format on */
+class MaxBotixSonar_RangeSpread : public Variable {
+ public:
+    /**
+     * @brief Construct a new MaxBotixSonar_RangeSpread object.
+     *
+     * @param parentSense The parent MaxBotixSonar providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SonarRangeSpread".
+     */
+    explicit MaxBotixSonar_RangeSpread(
+        MaxBotixSonar* parentSense, const char* uuid = "",
+        const char* varCode = HRXL_SPREAD_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)HRXL_SPREAD_VAR_NUM,
+                   (uint8_t)HRXL_SPREAD_RESOLUTION, HRXL_SPREAD_VAR_NAME,
+                   HRXL_SPREAD_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new MaxBotixSonar_RangeSpread object.
+     *
+     * @note This must be tied with a parent MaxBotixSonar before it can be
+     * used.
+     */
+    MaxBotixSonar_RangeSpread()
+        : Variable((const uint8_t)HRXL_SPREAD_VAR_NUM,
+                   (uint8_t)HRXL_SPREAD_RESOLUTION, HRXL_SPREAD_VAR_NAME,
+                   HRXL_SPREAD_UNIT_NAME, HRXL_SPREAD_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the MaxBotixSonar_RangeSpread object - no action needed.
+     */
+    ~MaxBotixSonar_RangeSpread() {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_MAXBOTIXSONAR_H_
@@ -10,6 +10,54 @@
 #include "MaximDS18.h"
 
 
+// The bus coordinator for several probes on one pin
+MaximDS18Bus::MaximDS18Bus(int8_t dataPin)
+    : _dataPin(dataPin),
+      _busOneWire(dataPin) {}
+// Destructor
+MaximDS18Bus::~MaximDS18Bus() {}
+
+
+// Reads the power supply of the probes; any parasitic probe pulls the line low
+void MaximDS18Bus::begin(void) {
+    if (_busOneWire.reset()) {
+        _busOneWire.skip();
+        _busOneWire.write(0xB4);  // Read Power Supply
+        _parasitePower = (_busOneWire.read_bit() == 0);
+        _busOneWire.reset();
+    }
+    MS_DBG(F("DS18 bus on pin"), _dataPin,
+           _parasitePower ? F("is using parasitic power")
+                          : F("has powered probes"));
+}
+
+
+// Starts a conversion on every probe, or lets a probe join the running one
+bool MaximDS18Bus::requestConversion(uint8_t& lastConversion,
+                                     uint32_t conversionTime_ms,
+                                     uint32_t& startedAt) {
+    if (_conversionStart != 0 && lastConversion != _conversionID &&
+        millis() - _conversionStart < conversionTime_ms) {
+        MS_DBG(F("Joining the conversion started on pin"), _dataPin,
+               millis() - _conversionStart, F("ms ago"));
+    } else {
+        MS_DBG(F("Starting a conversion on every DS18 on pin"), _dataPin);
+        // Skip-ROM ConvertT; with parasitic power the line must be held high
+        // through the conversion
+        if (!_busOneWire.reset()) return false;
+        _busOneWire.skip();
+        _busOneWire.write(0x44, _parasitePower ? 1 : 0);
+        _conversionStart = millis();
+        // Keep the start non-zero so it can't be mistaken for no conversion
+        if (_conversionStart == 0) _conversionStart = 1;
+        _conversionID++;
+    }
+    lastConversion = _conversionID;
+    startedAt      = _conversionStart;
+    return true;
+}
+
+
 // The constructor - if the hex address is known - also need the power pin and
 // the data pin
 MaximDS18::MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin,
@@ -33,6 +81,18 @@ MaximDS18::MaximDS18(int8_t powerPin, int8_t dataPin,
       _addressKnown(false),
       _internalOneWire(dataPin),
       _internalDallasTemp(&_internalOneWire) {}
+// The constructor for a sensor on a shared bus
+MaximDS18::MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin,
+                     MaximDS18Bus& bus, uint8_t measurementsToAverage)
+    : Sensor("MaximDS18", DS18_NUM_VARIABLES, DS18_WARM_UP_TIME_MS,
+             DS18_STABILIZATION_TIME_MS, DS18_MEASUREMENT_TIME_MS, powerPin,
+             bus.getDataPin(), measurementsToAverage, DS18_INC_CALC_VARIABLES),
+      _addressKnown(true),
+      _bus(&bus),
+      _internalOneWire(bus.getDataPin()),
+      _internalDallasTemp(&_internalOneWire) {
+    for (uint8_t i = 0; i < 8; i++) _OneWireAddress[i] = OneWireAddress[i];
+}
 // Destructor
 MaximDS18::~MaximDS18() {}
 
@@ -74,6 +134,7 @@ bool MaximDS18::setup(void) {
     waitForWarmUp();
 
     _internalDallasTemp.begin();
+    if (_bus != nullptr) { _bus->begin(); }
 
     // Find the address if it's not known
     if (!_addressKnown) {
@@ -117,14 +178,18 @@ bool MaximDS18::setup(void) {
         }
     }
 
-    // Set resolution to 12 bit
+    // Set the resolution, 12 bit unless another was asked for
     // All variable resolution sensors start up at 12 bit resolution by default
-    if (!_internalDallasTemp.setResolution(_OneWireAddress, 12)) {
+    if (!_internalDallasTemp.setResolution(_OneWireAddress, _resolution)) {
         MS_DBG(F("Unable to set the resolution of this sensor:"),
                makeAddressString(_OneWireAddress));
         // We're not setting the error bit if this fails because not all sensors
         // have variable resolution.
     }
+    // The fixed resolution DS18S20 always takes the full conversion time
+    if (_OneWireAddress[0] == DS18S20MODEL) {
+        _measurementTime_ms = DS18_MEASUREMENT_TIME_MS;
+    }
 
     // Tell the sensor that we do NOT want to wait for conversions to finish
     // That is, we're in ASYNC mode and will get values when we're ready
@@ -154,14 +219,20 @@ bool MaximDS18::startSingleMeasurement(void) {
     if (!Sensor::startSingleMeasurement()) return false;
 
     // Send the command to get temperatures
-    MS_DBG(F("Asking DS18 to take a measurement"));
-    bool success =
-        _internalDallasTemp.requestTemperaturesByAddress(_OneWireAddress);
-
-    if (success) {
-        // Update the time that a measurement was requested
-        _millisMeasurementRequested = millis();
+    bool success;
+    if (_bus != nullptr) {
+        // On a shared bus, the measurement starts when the broadcast did
+        success = _bus->requestConversion(_busConversion, _measurementTime_ms,
+                                          _millisMeasurementRequested);
     } else {
+        MS_DBG(F("Asking DS18 to take a measurement"));
+        success =
+            _internalDallasTemp.requestTemperaturesByAddress(_OneWireAddress);
+        // Update the time that a measurement was requested
+        if (success) { _millisMeasurementRequested = millis(); }
+    }
+
+    if (!success) {
         // Otherwise, make sure that the measurement start time and success bit
         // (bit 6) are unset
         MS_DBG(getSensorNameAndLocation(),
@@ -174,6 +245,45 @@ bool MaximDS18::startSingleMeasurement(void) {
 }
 
 
+// Sets the resolution; each bit less halves the conversion time, rounded up
+void MaximDS18::setResolution(uint8_t resolutionBits) {
+    if (resolutionBits < 9) resolutionBits = 9;
+    if (resolutionBits > 12) resolutionBits = 12;
+    _resolution         = resolutionBits;
+    uint8_t shift       = 12 - resolutionBits;
+    _measurementTime_ms = (DS18_MEASUREMENT_TIME_MS + (1 << shift) - 1) >>
+        shift;
+}
+
+
+// Checks the time, and then the bus if polling, for the end of a conversion
+bool MaximDS18::isMeasurementComplete(bool debug) {
+    if (Sensor::isMeasurementComplete(debug)) return true;
+    // Powered probes send 0 bits while converting and 1 bits once done
+    if (_pollConversion && !_internalDallasTemp.isParasitePowerMode() &&
+        _internalDallasTemp.isConversionComplete()) {
+        if (debug) {
+            MS_DBG(F("Conversion by"), getSensorNameAndLocation(),
+                   F("finished after"), millis() - _millisMeasurementRequested,
+                   F("ms"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
+// Never idles past the next poll of the bus
+uint32_t MaximDS18::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (_pollConversion && !_internalDallasTemp.isParasitePowerMode() &&
+        remaining > DS18_POLL_INTERVAL_MS) {
+        return DS18_POLL_INTERVAL_MS;
+    }
+    return remaining;
+}
+
+
 bool MaximDS18::addSingleMeasurementResult(void) {
     bool success = false;
 
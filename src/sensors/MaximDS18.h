@@ -59,6 +59,15 @@
  * example provided within the Dallas Temperature library.  The sensor address
  * is programmed at the factory and cannot be changed.
  *
+ * @section sensor_ds18_bus Several Probes on One Pin
+ *
+ * When several probes share a data pin, create a MaximDS18Bus for the pin and
+ * give it to each probe's constructor.  The first probe to start a measurement
+ * then starts a conversion on every probe at once with a single Skip-ROM
+ * ConvertT command, and the other probes read their results from that same
+ * conversion instead of each waiting through a conversion of its own.  All of
+ * the probes on the bus should share the same power pin.
+ *
  * @section sensor_ds18_datasheet Sensor Datasheet
  * - [DS18B20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18B20-1-Wire-Temperature-Probe-Datasheet.pdf)
  * - [DS18S20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18S20-1-Wire-Temperature-Probe-Datasheet.pdf)
@@ -117,8 +126,14 @@
 /// up (0ms stabilization).
 #define DS18_STABILIZATION_TIME_MS 0
 /// @brief Sensor::_measurementTime_ms; the DS18 takes 750ms to complete a
-/// measurement (at 12-bit: 750ms).
+/// measurement at 12-bit resolution.  Each bit less halves the time: 375ms at
+/// 11-bit, 188ms at 10-bit, and 94ms at 9-bit.
 #define DS18_MEASUREMENT_TIME_MS 750
+#ifndef DS18_POLL_INTERVAL_MS
+/// @brief The time between checks of the bus for a finished conversion when
+/// polling is enabled with MaximDS18::setPollConversion().
+#define DS18_POLL_INTERVAL_MS 10
+#endif
 /**@}*/
 
 /**
@@ -155,6 +170,68 @@
 #define DS18_TEMP_DEFAULT_CODE "DS18Temp"
 /**@}*/
 
+/**
+ * @brief A coordinator for the DS18 probes sharing a single OneWire data pin.
+ *
+ * The bus broadcasts one temperature conversion to every probe on the pin, so
+ * a whole string of probes takes a single conversion time to measure.
+ *
+ * @ingroup sensor_ds18
+ */
+class MaximDS18Bus {
+ public:
+    /**
+     * @brief Construct a new Maxim DS18 bus object
+     *
+     * @param dataPin The pin on the mcu of the OneWire bus.
+     */
+    explicit MaximDS18Bus(int8_t dataPin);
+    /**
+     * @brief Destroy the Maxim DS18 bus object
+     */
+    ~MaximDS18Bus();
+
+    /**
+     * @brief Check whether the probes on the bus are taking parasitic power
+     * from the data line.
+     *
+     * The probes must be powered for this.
+     */
+    void begin(void);
+    /**
+     * @brief Get the pin of the OneWire bus.
+     *
+     * @return **int8_t** The data pin
+     */
+    int8_t getDataPin(void) {
+        return _dataPin;
+    }
+    /**
+     * @brief Start a conversion on every probe on the bus, unless a probe can
+     * still join the one already in progress.
+     *
+     * A probe joins the running conversion if it has not already read a
+     * result from it and it started less than one conversion time ago.
+     *
+     * @param lastConversion The number of the last conversion the probe used;
+     * updated to the number of the conversion it should read.
+     * @param conversionTime_ms The time the probe needs for a conversion
+     * @param startedAt Set to the millis() the conversion started at
+     * @return **bool** True if a probe answered the reset, or the probe joined
+     * a running conversion
+     */
+    bool requestConversion(uint8_t& lastConversion, uint32_t conversionTime_ms,
+                           uint32_t& startedAt);
+
+ private:
+    int8_t   _dataPin;
+    bool     _parasitePower   = false;
+    uint8_t  _conversionID    = 0;
+    uint32_t _conversionStart = 0;
+    OneWire  _busOneWire;
+};
+
+
 /* clang-format off */
 /**
  * @brief The Sensor sub-class for the
@@ -208,6 +285,26 @@ class MaximDS18 : public Sensor {
      */
     MaximDS18(int8_t powerPin, int8_t dataPin,
               uint8_t measurementsToAverage = 1);
+    /**
+     * @brief Construct a new Maxim DS18 with a known sensor address on a
+     * shared bus.
+     *
+     * Use this version for strings of sensors on one pin; every sensor on the
+     * bus is measured with a single broadcast conversion.
+     *
+     * @param OneWireAddress The unique address of the sensor.  Should be an
+     * array of 8 values.
+     * @param powerPin The pin on the mcu controlling power to the DS18, if
+     * using a separate power pin.  Use -1 if the DS18 is continuously powered
+     * or you are using "parasitic" power.
+     * - Requires a 3.0 - 5.5V power source
+     * @param bus The MaximDS18Bus of the data pin the sensor is on
+     * @param measurementsToAverage The number of measurements to take and
+     * average before giving a "final" result from the sensor; optional with a
+     * default value of 1.
+     */
+    MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin, MaximDS18Bus& bus,
+              uint8_t measurementsToAverage = 1);
     /**
      * @brief Destroy the Maxim DS18 object
      */
@@ -247,9 +344,54 @@ class MaximDS18 : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Set the resolution of the conversions.
+     *
+     * The measurement time follows from the resolution; see
+     * #DS18_MEASUREMENT_TIME_MS.  This must be called before setup().  The
+     * DS18S20 and DS1820 always convert at 9-bit in the full 750ms.
+     *
+     * @param resolutionBits The resolution, from 9 to 12 bits.  Default is
+     * 12.
+     */
+    void setResolution(uint8_t resolutionBits);
+    /**
+     * @brief Set whether to poll the bus for the end of a conversion instead
+     * of always waiting the full measurement time.
+     *
+     * Powered probes hold the bus low while they convert, so a conversion is
+     * seen to be done as soon as every probe on the pin has finished.  This
+     * has no effect with parasitic power.
+     *
+     * @param pollConversion True to poll the bus every
+     * #DS18_POLL_INTERVAL_MS.  Default is false.
+     */
+    void setPollConversion(bool pollConversion) {
+        _pollConversion = pollConversion;
+    }
+
+    /**
+     * @copydoc Sensor::isMeasurementComplete()
+     *
+     * When polling, this also checks whether the conversion has finished early.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     *
+     * When polling, this is at most #DS18_POLL_INTERVAL_MS.
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
+
  private:
     DeviceAddress _OneWireAddress;
     bool          _addressKnown;
+    // The shared bus, if any, and the last of its conversions we've read
+    MaximDS18Bus* _bus           = nullptr;
+    uint8_t       _busConversion = 0;
+    // The conversion resolution and whether we poll for its end
+    uint8_t _resolution     = 12;
+    bool    _pollConversion = false;
     // Setup an internal OneWire instance to communicate with any OneWire
     // devices (not just Maxim/Dallas temperature ICs)
     OneWire _internalOneWire;
@@ -8,8 +8,14 @@
  */
 
 #include <Sodaq_DS3231.h>
+#include <Wire.h>
 #include "MaximDS3231.h"
 
+// The DS3231 registers with the conversion and busy bits
+#define DS3231_CONTROL_REGISTER 0x0E
+#define DS3231_CONV_BIT 5
+#define DS3231_BSY_BIT 2
+
 // Only input is the number of readings to average
 MaximDS3231::MaximDS3231(uint8_t measurementsToAverage)
     : Sensor("MaximDS3231", DS3231_NUM_VARIABLES, DS3231_WARM_UP_TIME_MS,
@@ -31,6 +37,26 @@ bool MaximDS3231::setup(void) {
 }
 
 
+void MaximDS3231::setForcedConversion(bool forceConversion) {
+    _forceConversion    = forceConversion;
+    _measurementTime_ms = forceConversion ? DS3231_MEASUREMENT_TIME_MS : 0;
+}
+
+
+// The control register is followed by the status register
+bool MaximDS3231::isConverting(void) {
+    Wire.beginTransmission(0x68);
+    Wire.write(DS3231_CONTROL_REGISTER);
+    if (Wire.endTransmission() != 0 || Wire.requestFrom(0x68, 2) != 2) {
+        // If the RTC can't be read, don't wait on it
+        return false;
+    }
+    uint8_t control = Wire.read();
+    uint8_t status  = Wire.read();
+    return bitRead(control, DS3231_CONV_BIT) || bitRead(status, DS3231_BSY_BIT);
+}
+
+
 // Sending the device a request to start temp conversion.
 bool MaximDS3231::startSingleMeasurement(void) {
     // Sensor::startSingleMeasurement() checks that if it's awake/active and
@@ -38,17 +64,56 @@ bool MaximDS3231::startSingleMeasurement(void) {
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
-    // force a temperature sampling and conversion
-    // this function already has a forced wait for the conversion to complete
-    // TODO(SRGDamia1):  Test how long the conversion takes, update DS3231 lib
-    // accordingly!
-    MS_DBG(F("Forcing new temperature reading by DS3231"));
-    rtc.convertTemperature(false);
+    _conversionDone = !_forceConversion;
+    _lastStatusPoll = millis();
+    if (!_forceConversion) return true;
+
+    // force a temperature sampling and conversion, unless the DS3231 is
+    // already doing one of its own, which will do just as well
+    if (isConverting()) {
+        MS_DBG(F("DS3231 is already converting the temperature"));
+    } else {
+        MS_DBG(F("Forcing new temperature reading by DS3231"));
+        rtc.convertTemperature(false);
+    }
 
     return true;
 }
 
 
+bool MaximDS3231::isMeasurementComplete(bool debug) {
+    if (!bitRead(_sensorStatus, 6) || _conversionDone) { return true; }
+    if (Sensor::isMeasurementComplete(debug)) { return true; }
+
+    uint32_t now = millis();
+    if (now - _lastStatusPoll < DS3231_STATUS_POLL_INTERVAL_MS) {
+        return false;
+    }
+    _lastStatusPoll = now;
+    if (!isConverting()) {
+        _conversionDone = true;
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("finished converting after"),
+                   now - _millisMeasurementRequested, F("ms"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
+uint32_t MaximDS3231::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (remaining == 0 || _conversionDone) { return 0; }
+    uint32_t untilPoll = 0;
+    uint32_t sincePoll = millis() - _lastStatusPoll;
+    if (sincePoll < DS3231_STATUS_POLL_INTERVAL_MS) {
+        untilPoll = DS3231_STATUS_POLL_INTERVAL_MS - sincePoll;
+    }
+    return untilPoll < remaining ? untilPoll : remaining;
+}
+
+
 bool MaximDS3231::addSingleMeasurementResult(void) {
     // get the temperature value
     MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
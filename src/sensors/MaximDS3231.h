@@ -98,9 +98,17 @@
 #define DS3231_STABILIZATION_TIME_MS 0
 /**
  * @brief Sensor::_measurementTime_ms; the DS3231 takes 200ms to complete a
- * measurement - A single temperature conversion takes 200ms.
+ * measurement - A single temperature conversion takes 200ms at most.
+ *
+ * A forced conversion is read as soon as the busy bit clears, which is usually
+ * sooner.  Without forced conversions there is no measurement time.
  */
 #define DS3231_MEASUREMENT_TIME_MS 200
+/**
+ * @brief The time between checks of the busy bit of the DS3231 during a
+ * forced conversion.
+ */
+#define DS3231_STATUS_POLL_INTERVAL_MS 10
 /**@}*/
 
 /**
@@ -184,10 +192,58 @@ class MaximDS3231 : public Sensor {
      * successfully. successfully.
      */
     bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check the busy bit of the DS3231 during a forced conversion.
+     *
+     * @copydetails Sensor::isMeasurementComplete()
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
+
+    /**
+     * @brief Set whether each measurement forces a new temperature
+     * conversion.
+     *
+     * The DS3231 converts the temperature by itself every 64 seconds, for its
+     * own temperature compensation.  Without forced conversions, a
+     * measurement reads the last of those with no measurement time at all.
+     * A forced conversion also updates the compensation of the clock, and its
+     * result is read as soon as the busy bit clears.
+     *
+     * @param forceConversion True to force a conversion for each measurement.
+     * Default is true.
+     */
+    void setForcedConversion(bool forceConversion);
+
+ private:
+    /**
+     * @brief Check whether the DS3231 is converting the temperature, from
+     * the conversion bit of the control register and the busy bit of the
+     * status register.
+     *
+     * @return **bool** True if a conversion is under way.
+     */
+    bool isConverting(void);
+
+    /**
+     * @brief True to force a conversion for each measurement
+     */
+    bool _forceConversion = true;
+    /**
+     * @brief True once the current forced conversion has finished
+     */
+    bool _conversionDone = false;
+    /**
+     * @brief The last time the busy bit was checked
+     */
+    uint32_t _lastStatusPoll = 0;
 };
 
 
@@ -19,7 +19,9 @@ MeaSpecMS5803::MeaSpecMS5803(int8_t powerPin, uint8_t i2cAddressHex,
              MS5803_STABILIZATION_TIME_MS, MS5803_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage, MS5803_INC_CALC_VARIABLES),
       _i2cAddressHex(i2cAddressHex),
-      _maxPressure(maxPressure) {}
+      _maxPressure(maxPressure) {
+    setOversampling(MS5803_DEFAULT_OVERSAMPLING);
+}
 // Destructor
 MeaSpecMS5803::~MeaSpecMS5803() {}
 
@@ -31,6 +33,22 @@ String MeaSpecMS5803::getSensorLocation(void) {
 }
 
 
+// Picks the lowest supported ratio at or above the one asked for; the library
+// precision codes for ratios 256 through 4096 go up by 2 from 0
+void MeaSpecMS5803::setOversampling(uint16_t oversamplingRatio) {
+    uint8_t  step  = 0;
+    uint16_t ratio = 256;
+    while (step < 4 && ratio < oversamplingRatio) {
+        step++;
+        ratio *= 2;
+    }
+    _pressurePrecision = 2 * step;
+    _tempPrecision     = step > 0 ? ADC_512 : ADC_256;
+    MS_DBG(getSensorNameAndLocation(), F("converting at oversampling ratio"),
+           ratio);
+}
+
+
 bool MeaSpecMS5803::setup(void) {
     bool retVal =
         Sensor::setup();  // this will set pin modes and the setup status bit
@@ -66,9 +84,11 @@ bool MeaSpecMS5803::addSingleMeasurementResult(void) {
         // Read values
         // NOTE:  These functions actually include the request to begin
         // a measurement and the wait for said measurement to finish.
-        // It's pretty fast (max of 11 ms) so we'll just wait.
-        temp  = MS5803_internal.getTemperature(CELSIUS, ADC_512);
-        press = MS5803_internal.getPressure(ADC_4096);
+        // It's pretty fast (max of 11 ms per conversion) so we'll just wait.
+        temp = MS5803_internal.getTemperature(
+            CELSIUS, static_cast<precision>(_tempPrecision));
+        press = MS5803_internal.getPressure(
+            static_cast<precision>(_pressurePrecision));
 
         if (isnan(temp)) temp = -9999;
         if (isnan(press)) press = -9999;
@@ -112,14 +112,29 @@
 /// warms up (0ms stabilization).
 #define MS5803_STABILIZATION_TIME_MS 0
 /**
- * @brief Sensor::_measurementTime_ms; the MS5803 takes 10ms to complete a
- * measurement.
- * - Sensor takes about 0.5 / 1.1 / 2.1 / 4.1 / 8.22 ms to respond
- * at oversampling ratios: 256 / 512 / 1024 / 2048 / 4096, respectively.
+ * @brief Sensor::_measurementTime_ms; the MS5803 needs no wait between the
+ * measurement request and the result (0ms).
+ *
+ * The MS5803 library starts each conversion and waits for it to finish within
+ * the call that reads it, so the wait happens while the result is collected
+ * instead.  The sensor takes about 0.5 / 1.1 / 2.1 / 4.1 / 8.22 ms to convert
+ * at oversampling ratios 256 / 512 / 1024 / 2048 / 4096, for which the library
+ * waits 1 / 3 / 4 / 6 / 10 ms.  Each of the temperature and pressure reads
+ * converts both the temperature and the pressure, so collecting a result at
+ * the default oversampling takes about 26ms.
  */
-#define MS5803_MEASUREMENT_TIME_MS 10
+#define MS5803_MEASUREMENT_TIME_MS 0
 /**@}*/
 
+#ifndef MS5803_DEFAULT_OVERSAMPLING
+/**
+ * @brief The default oversampling ratio of the pressure conversion; 4096.
+ *
+ * The temperature is converted at the same ratio, up to 512.
+ */
+#define MS5803_DEFAULT_OVERSAMPLING 4096
+#endif
+
 /**
  * @anchor sensor_ms5803_temp
  * @name Temperature
@@ -241,6 +256,23 @@ class MeaSpecMS5803 : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Set the oversampling ratio of the conversions.
+     *
+     * The nearest ratio the MS5803 supports at or above the one given is used;
+     * the supported ratios are 256, 512, 1024, 2048 and 4096.  Higher ratios
+     * have finer resolution but take longer to convert.  At a turbulent site a
+     * low ratio averaged over more measurements may be better, while in a
+     * still well a single reading at a high ratio is enough.
+     *
+     * The pressure is converted at this ratio and the temperature at the same
+     * ratio up to 512.
+     *
+     * @param oversamplingRatio The oversampling ratio.  Default is
+     * #MS5803_DEFAULT_OVERSAMPLING.
+     */
+    void setOversampling(uint16_t oversamplingRatio);
+
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -259,6 +291,15 @@ class MeaSpecMS5803 : public Sensor {
      * @brief Maximum pressure supported by the MS5803.
      */
     int16_t _maxPressure;
+    /**
+     * @brief The MS5803 library precision code for the pressure conversions.
+     */
+    uint8_t _pressurePrecision;
+    /**
+     * @brief The MS5803 library precision code for the temperature
+     * conversions.
+     */
+    uint8_t _tempPrecision;
 };
 
 
@@ -0,0 +1,161 @@
+/**
+ * @file NodeRelay.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the NodeRelay class.
+ */
+
+#include "NodeRelay.h"
+
+// The registered relays
+NodeRelay* NodeRelay::_relays[MS_MAX_NODE_RELAYS] = {nullptr};
+
+
+// The constructor registers the relay in the first free slot
+NodeRelay::NodeRelay(NodeLink* link, uint8_t nodeID, uint8_t numValues,
+                     int8_t powerPin, uint8_t firstValue,
+                     uint32_t listenTime_ms)
+    : Sensor("NodeRelay", numValues > MAX_NUMBER_VARS ? MAX_NUMBER_VARS
+                                                      : numValues,
+             NODE_RELAY_WARM_UP_TIME_MS, NODE_RELAY_STABILIZATION_TIME_MS,
+             listenTime_ms, powerPin, -1, 1, NODE_RELAY_INC_CALC_VARIABLES),
+      _link(link),
+      _nodeID(nodeID),
+      _firstValue(firstValue) {
+    for (uint8_t i = 0; i < MS_MAX_NODE_RELAYS; i++) {
+        if (_relays[i] == nullptr) {
+            _relays[i] = this;
+            return;
+        }
+    }
+}
+// Destructor
+NodeRelay::~NodeRelay() {
+    for (uint8_t i = 0; i < MS_MAX_NODE_RELAYS; i++) {
+        if (_relays[i] == this) _relays[i] = nullptr;
+    }
+}
+
+
+String NodeRelay::getSensorLocation(void) {
+    String sensorLocation = F("node_");
+    sensorLocation += String(_nodeID);
+    return sensorLocation;
+}
+
+
+bool NodeRelay::startSingleMeasurement(void) {
+    // Anything heard before now was for the last interval
+    _haveRecord = false;
+    _recordTime = 0;
+    return Sensor::startSingleMeasurement();
+}
+
+
+bool NodeRelay::isMeasurementComplete(bool debug) {
+    if (!bitRead(_sensorStatus, 6)) {
+        return Sensor::isMeasurementComplete(debug);
+    }
+    receiveRecords(_link);
+    if (_haveRecord) {
+        if (debug) {
+            MS_DBG(F("Record from"), getSensorNameAndLocation(),
+                   F("came in after"), millis() - _millisMeasurementRequested,
+                   F("ms"));
+        }
+        return true;
+    }
+    return Sensor::isMeasurementComplete(debug);
+}
+
+
+// Never idles past the next read of the radio
+uint32_t NodeRelay::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (_haveRecord) return 0;
+    return remaining > NODE_RELAY_POLL_INTERVAL_MS ? NODE_RELAY_POLL_INTERVAL_MS
+                                                   : remaining;
+}
+
+
+bool NodeRelay::addSingleMeasurementResult(void) {
+    bool success = false;
+
+    // Check a measurement was *successfully* started (status bit 6 set)
+    // Only go on to get a result if it was
+    if (bitRead(_sensorStatus, 6) && _haveRecord) {
+        MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
+        for (uint8_t i = 0; i < _numReturnedValues; i++) {
+            MS_DBG(F("  Value"), i, ':', _values[i]);
+            verifyAndAddMeasurementResult(i, _values[i]);
+        }
+        success = true;
+    } else {
+        MS_DBG(getSensorNameAndLocation(), F("has no record!"));
+        for (uint8_t i = 0; i < _numReturnedValues; i++) {
+            verifyAndAddMeasurementResult(i, static_cast<float>(-9999));
+        }
+    }
+
+    // Unset the time stamp for the beginning of this measurement
+    _millisMeasurementRequested = 0;
+    // Unset the status bits for a measurement request (bits 5 & 6)
+    _sensorStatus &= 0b10011111;
+
+    return success;
+}
+
+
+// Keeps the newest record, so a node catching up on its backlog doesn't
+// replace the record of this interval with an older one
+bool NodeRelay::takeRecord(const uint8_t* payload, uint8_t length) {
+    if (!bitRead(_sensorStatus, 6)) return false;
+    uint32_t recordTime;
+    if (length < sizeof(recordTime)) return false;
+    memcpy(&recordTime, payload, sizeof(recordTime));
+    if (_haveRecord && recordTime <= _recordTime) return true;
+    uint8_t nValues = (length - sizeof(recordTime)) / sizeof(float);
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        _values[i] = -9999;
+        if (_firstValue + i < nValues) {
+            memcpy(&_values[i],
+                   payload + sizeof(recordTime) +
+                       (_firstValue + i) * sizeof(float),
+                   sizeof(float));
+        }
+    }
+    _recordTime = recordTime;
+    _haveRecord = true;
+    return true;
+}
+
+
+// A node with no relay on this link is left unanswered; it may belong to
+// another gateway in range
+void NodeRelay::receiveRecords(NodeLink* link) {
+    while (link != nullptr && link->receiveFrame()) {
+        if (link->getFrameType() != NODE_LINK_RECORD) continue;
+        uint8_t nodeID   = link->getFrameNode();
+        bool    known    = false;
+        bool    accepted = false;
+        for (uint8_t i = 0; i < MS_MAX_NODE_RELAYS; i++) {
+            NodeRelay* relay = _relays[i];
+            if (relay == nullptr || relay->_link != link ||
+                relay->_nodeID != nodeID) {
+                continue;
+            }
+            known = true;
+            if (relay->takeRecord(link->getFramePayload(),
+                                  link->getFrameLength())) {
+                accepted = true;
+            }
+        }
+        if (known) {
+            MS_DBG(F("Record from node"), nodeID,
+                   accepted ? F("taken") : F("heard while not listening"));
+            link->answerRecord(nodeID, accepted);
+        }
+    }
+}
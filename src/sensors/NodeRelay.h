@@ -0,0 +1,271 @@
+/**
+ * @file NodeRelay.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the NodeRelay sensor subclass and the variable subclass
+ * NodeRelay_Value.
+ *
+ * These are for a gateway logger taking the records of node loggers over a
+ * local radio.
+ */
+/* clang-format off */
+/**
+ * @defgroup sensor_node_relay Node Relay
+ * Classes for the values of a node logger, taken by a gateway logger over a
+ * local radio.
+ *
+ * @ingroup the_sensors
+ *
+ * @tableofcontents
+ * @m_footernavigation
+ *
+ * @section sensor_node_relay_notes Quick Notes
+ * - Each node logger sends its records with a NodeLinkPublisher
+ * - The gateway has one NodeRelay for each node, all on the NodeLink of its
+ * radio
+ * - The values of each node go into the gateway's records, so they are
+ * logged, kept in the backlogs, and published in batches along with the
+ * gateway's own values, over the gateway's one cellular modem
+ *
+ * A gateway logger with a handful of node loggers around it takes the place
+ * of a cellular modem and data plan on each node.  Each measurement by a relay
+ * listens on the radio until its node's record comes in, or until the listening
+ * time runs out for a node that didn't send.  Every record from a node heard
+ * while its relay is listening is acknowledged, with the gateway's clock if
+ * NodeLink::setTimeSource() was given one; the nodes set their clocks from
+ * it, so they measure at the same time as the gateway.  Only the newest of
+ * them is kept, so log the nodes on the same interval as the gateway; a record
+ * a node sends while its relay isn't listening is answered as busy, and the
+ * node keeps it to send again.
+ *
+ * A relay holds up to 8 values.  For a node with more, give it more relays
+ * with the same node ID, each starting from a later value.
+ *
+ * @section sensor_node_relay_ctor Sensor Constructor
+ * {{ @ref NodeRelay::NodeRelay }}
+ *
+ * @section sensor_node_relay_example Example Code
+ * @code{cpp}
+ * NodeLink  radioLink(&Serial1);
+ * NodeRelay node1(&radioLink, 1, 3, radioPowerPin);
+ * Variable* node1Temp =
+ *     new NodeRelay_Value(&node1, 0, "12345678-abcd-1234-ef00-1234567890ab",
+ *                         "Node1Temp", 2, "temperature", "degreeCelsius");
+ * // ...
+ * radioLink.setTimeSource(Logger::getCycleUTCTime);
+ * @endcode
+ */
+/* clang-format on */
+
+// Header Guards
+#ifndef SRC_SENSORS_NODERELAY_H_
+#define SRC_SENSORS_NODERELAY_H_
+
+// Debugging Statement
+// #define MS_NODERELAY_DEBUG
+
+#ifdef MS_NODERELAY_DEBUG
+#define MS_DEBUGGING_STD "NodeRelay"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "VariableBase.h"
+#include "SensorBase.h"
+#include "NodeLink.h"
+
+/** @ingroup sensor_node_relay */
+/**@{*/
+
+#ifndef MS_MAX_NODE_RELAYS
+/**
+ * @brief The most relays a gateway can have, across all of its links.
+ */
+#define MS_MAX_NODE_RELAYS 16
+#endif
+
+// Sensor Specific Defines
+/// @brief Sensor::_incCalcValues; a relay has no calculated values.
+#define NODE_RELAY_INC_CALC_VARIABLES 0
+
+/**
+ * @anchor sensor_node_relay_timing
+ * @name Sensor Timing
+ * The timing of a relay
+ */
+/**@{*/
+/// @brief Sensor::_warmUpTime_ms; the radio is ready about 100 ms after it is
+/// powered.
+#define NODE_RELAY_WARM_UP_TIME_MS 100
+/// @brief Sensor::_stabilizationTime_ms; the radio doesn't need to
+/// stabilize.
+#define NODE_RELAY_STABILIZATION_TIME_MS 0
+/// @brief The default Sensor::_measurementTime_ms; how long to listen for a
+/// node's record - 60 seconds.
+#define NODE_RELAY_LISTEN_TIME_MS 60000L
+/// @brief The longest the update idles between reads of the radio.
+#define NODE_RELAY_POLL_INTERVAL_MS 20
+/**@}*/
+
+/**
+ * @anchor sensor_node_relay_value
+ * @name Value
+ * A value sent by a node
+ *
+ * {{ @ref NodeRelay_Value::NodeRelay_Value }}
+ */
+/**@{*/
+/// @brief The default decimal places in string representation.
+#define NODE_RELAY_RESOLUTION 3
+/// @brief The default variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "unknown"
+#define NODE_RELAY_VAR_NAME "unknown"
+/// @brief The default variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "unknown"
+#define NODE_RELAY_UNIT_NAME "unknown"
+/// @brief Default variable short code; "NodeValue"
+#define NODE_RELAY_DEFAULT_CODE "NodeValue"
+/**@}*/
+
+
+/* clang-format off */
+/**
+ * @brief The Sensor sub-class for the values of a
+ * [node logger](@ref sensor_node_relay), taken by a gateway logger.
+ */
+/* clang-format on */
+class NodeRelay : public Sensor {
+ public:
+    /**
+     * @brief Construct a new NodeRelay object and register it.
+     *
+     * @param link The node link run over the gateway's radio
+     * @param nodeID The ID the node sends its records with
+     * @param numValues The number of the node's values this relay takes, up
+     * to 8
+     * @param powerPin The pin on the mcu controlling power to the radio.  Use
+     * -1 if it is continuously powered.
+     * @param firstValue The number of the node's first value this relay
+     * takes; 0 for the first value the node sends.  Default is 0.
+     * @param listenTime_ms How long to listen for the node's record.  Default
+     * is #NODE_RELAY_LISTEN_TIME_MS.
+     */
+    NodeRelay(NodeLink* link, uint8_t nodeID, uint8_t numValues,
+              int8_t powerPin = -1, uint8_t firstValue = 0,
+              uint32_t listenTime_ms = NODE_RELAY_LISTEN_TIME_MS);
+    /**
+     * @brief Destroy the NodeRelay object and remove it from the registry.
+     */
+    ~NodeRelay();
+
+    /**
+     * @copydoc Sensor::getSensorLocation()
+     */
+    String getSensorLocation(void) override;
+
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @brief Read the radio and check whether the node's record has come in.
+     *
+     * @param debug True to print a debugging message
+     * @return **bool** True once the record has come in, or the listening
+     * time has run out
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
+    /**
+     * @copydoc Sensor::addSingleMeasurementResult()
+     */
+    bool addSingleMeasurementResult(void) override;
+
+    /**
+     * @brief Read every frame the radio has received and give each record to
+     * the relays of its node, answering the node.
+     *
+     * @param link The node link to read
+     */
+    static void receiveRecords(NodeLink* link);
+
+ private:
+    /**
+     * @brief Take a record from the node, if this relay is listening.
+     *
+     * @param payload The record
+     * @param length The length of the record
+     * @return **bool** True if the relay was listening for the record
+     */
+    bool takeRecord(const uint8_t* payload, uint8_t length);
+
+    NodeLink* _link;
+    uint8_t   _nodeID;
+    uint8_t   _firstValue;
+    /**
+     * @brief True once a record has come in for the current measurement
+     */
+    bool _haveRecord = false;
+    /**
+     * @brief The UTC epoch time of the record kept
+     */
+    uint32_t _recordTime = 0;
+    /**
+     * @brief The values of the record kept
+     */
+    float _values[MAX_NUMBER_VARS];
+    /**
+     * @brief The registered relays
+     */
+    static NodeRelay* _relays[MS_MAX_NODE_RELAYS];
+};
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for a
+ * [value](@ref sensor_node_relay_value) sent by a
+ * [node logger](@ref sensor_node_relay).
+ */
+/* clang-format on */
+class NodeRelay_Value : public Variable {
+ public:
+    /**
+     * @brief Construct a new NodeRelay_Value object.
+     *
+     * @param parentSense The parent NodeRelay providing the result values.
+     * @param valueNum The number of the value within the relay, from 0
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "NodeValue".
+     * @param decimalResolution The decimal places to give the value with;
+     * optional with a default value of #NODE_RELAY_RESOLUTION.
+     * @param varName The name of the variable; optional with a default value
+     * of "unknown".
+     * @param varUnit The unit of the variable; optional with a default value
+     * of "unknown".
+     */
+    NodeRelay_Value(NodeRelay* parentSense, uint8_t valueNum,
+                    const char* uuid              = "",
+                    const char* varCode           = NODE_RELAY_DEFAULT_CODE,
+                    uint8_t     decimalResolution = NODE_RELAY_RESOLUTION,
+                    const char* varName           = NODE_RELAY_VAR_NAME,
+                    const char* varUnit           = NODE_RELAY_UNIT_NAME)
+        : Variable(parentSense, valueNum, decimalResolution, varName, varUnit,
+                   varCode, uuid) {}
+    /**
+     * @brief Destroy the NodeRelay_Value object - no action needed.
+     */
+    ~NodeRelay_Value() {}
+};
+/**@}*/
+#endif  // SRC_SENSORS_NODERELAY_H_
@@ -49,7 +49,7 @@ PaleoTerraRedox::PaleoTerraRedox(TwoWire* theI2C, int8_t powerPin,
 PaleoTerraRedox::PaleoTerraRedox(int8_t powerPin, uint8_t i2cAddressHex,
                                  uint8_t measurementsToAverage)
     : Sensor("PaleoTerraRedox", PTR_NUM_VARIABLES, PTR_WARM_UP_TIME_MS,
-             PTR_STABILIZATION_TIME_MS, PTR_MEASUREMENT_TIME_MS, powerPin,
+             PTR_STABILIZATION_TIME_MS, PTR_MEASUREMENT_TIME_MS, powerPin, -1,
              measurementsToAverage, PTR_INC_CALC_VARIABLES),
       _i2cAddressHex(i2cAddressHex),
       _i2c(&Wire) {}
@@ -96,61 +96,146 @@ bool PaleoTerraRedox::setup(void) {
 }
 
 
+// The conversion time, and the longest it can take, go with the resolution
+void PaleoTerraRedox::setResolution(uint8_t resolutionBits) {
+    switch (resolutionBits) {
+        case 12: _conversionTime_ms = 5; break;
+        case 14: _conversionTime_ms = 17; break;
+        case 16: _conversionTime_ms = 67; break;
+        default:
+            resolutionBits     = 18;
+            _conversionTime_ms = 267;
+            break;
+    }
+    _resolutionBits     = resolutionBits;
+    _measurementTime_ms = _conversionTime_ms * 3 / 2;
+}
+
+
+bool PaleoTerraRedox::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    _i2c->beginTransmission(_i2cAddressHex);
+    // initiate conversion, One-Shot mode, PGA x1, with the sample rate bits
+    // for the resolution
+    _i2c->write(0b10000000 | (((_resolutionBits - 12) / 2) << 2));
+    byte i2c_status = _i2c->endTransmission();
+    // NOTE: The return of 0 from endTransmission indicates success
+
+    _resultReady = false;
+    if (i2c_status == 0) {
+        _millisMeasurementRequested = millis();
+        _lastStatusPoll             = _millisMeasurementRequested;
+        return true;
+    }
+    // Otherwise, make sure that the measurement start time and success bit
+    // (bit 6) are unset
+    MS_DBG(getSensorNameAndLocation(),
+           F("did not successfully start a measurement."));
+    _millisMeasurementRequested = 0;
+    _sensorStatus &= 0b10111111;
+    return false;
+}
+
+
+// The result is followed by the configuration byte, whose ready bit is
+// cleared once the result is from the conversion that was started
+bool PaleoTerraRedox::readConversion(void) {
+    uint8_t nBytes = _resolutionBits == 18 ? 4 : 3;
+    if (_i2c->requestFrom(int(_i2cAddressHex), int(nBytes)) != nBytes) {
+        return false;
+    }
+    for (uint8_t i = 0; i < nBytes; i++) { _rawData[i] = _i2c->read(); }
+    _resultReady = !bitRead(_rawData[nBytes - 1], 7);
+    return _resultReady;
+}
+
+
+bool PaleoTerraRedox::isMeasurementComplete(bool debug) {
+    if (!bitRead(_sensorStatus, 6) || _resultReady) { return true; }
+    if (Sensor::isMeasurementComplete(debug)) { return true; }
+
+    // The internal clock can run fast, so start checking a bit early
+    uint32_t now     = millis();
+    uint32_t elapsed = now - _millisMeasurementRequested;
+    if (elapsed < _conversionTime_ms * 3 / 4 ||
+        now - _lastStatusPoll < PTR_STATUS_POLL_INTERVAL_MS) {
+        return false;
+    }
+
+    _lastStatusPoll = now;
+    if (readConversion()) {
+        if (debug) {
+            MS_DBG(getSensorNameAndLocation(), F("finished converting after"),
+                   elapsed, F("ms"));
+        }
+        return true;
+    }
+    return false;
+}
+
+
+uint32_t PaleoTerraRedox::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (remaining == 0 || _resultReady) { return 0; }
+    uint32_t now = millis();
+    uint32_t pollStart =
+        _millisMeasurementRequested + _conversionTime_ms * 3 / 4;
+    uint32_t nextPollAt = _lastStatusPoll + PTR_STATUS_POLL_INTERVAL_MS;
+    uint32_t untilPoll  = 0;
+    if (static_cast<int32_t>(pollStart - nextPollAt) > 0) {
+        nextPollAt = pollStart;
+    }
+    if (static_cast<int32_t>(nextPollAt - now) > 0) {
+        untilPoll = nextPollAt - now;
+    }
+    return untilPoll < remaining ? untilPoll : remaining;
+}
+
+
 bool PaleoTerraRedox::addSingleMeasurementResult(void) {
     bool success = false;
 
-    byte config = 0;  // Data transfer values
-
-    float res = 0;  // Calculated voltage in uV
-
-    byte i2c_status = -1;
-    if (_millisMeasurementRequested > 0) {
-        _i2c->beginTransmission(_i2cAddressHex);
-        _i2c->write(0b10001100);  // initiate conversion, One-Shot mode, 18
-                                  // bits, PGA x1
-        i2c_status = _i2c->endTransmission();
-
-        delay(300);
-
-        _i2c->requestFrom(int(_i2cAddressHex),
-                          4);  // Get 4 bytes from device
-        byte res1 = _i2c->read();
-        byte res2 = _i2c->read();
-        byte res3 = _i2c->read();
-        config    = _i2c->read();
-
-        res      = 0;
-        int sign = bitRead(res1, 1);  // one but least significant bit
-        if (sign == 1) {
-            res1 = ~res1;
-            res2 = ~res2;
-            res3 = ~res3;  // two's complements
-            res  = bitRead(res1, 0) *
-                -1024;  // 256 * 256 * 15.625 uV per LSB = 16
-            res -= res2 * 4;
-            res -= res3 * 0.015625;
-            res -= 0.015625;
+    float res = -9999;  // Calculated voltage in mV
+
+    // Check a measurement was *successfully* started (status bit 6 set)
+    // Only go on to get a result if it was
+    if (bitRead(_sensorStatus, 6)) {
+        // Read the result now if it wasn't already read by a status check
+        if (_resultReady || readConversion()) {
+            int32_t raw;
+            if (_resolutionBits == 18) {
+                // 18 bits in three bytes; the sign is in bit 1 of the first
+                raw = (static_cast<int32_t>(_rawData[0] & 0x03) << 16) |
+                    (static_cast<int32_t>(_rawData[1]) << 8) | _rawData[2];
+                if (raw & 0x20000) raw -= 0x40000;  // two's complement
+            } else {
+                // Fewer bits come sign extended to two bytes
+                raw = static_cast<int16_t>((_rawData[0] << 8) | _rawData[1]);
+            }
+            // The full scale of +/-2048 mV over the resolution; 15.625 uV per
+            // LSB at 18 bits
+            res     = raw * (2048.0 / (1L << (_resolutionBits - 1)));
+            success = true;
         } else {
-            res = bitRead(res1, 0) *
-                1024;  // 256 * 256 * 15.625 uV per LSB = 16
-            res += res2 * 4;
-            res += res3 * 0.015625;
+            // List a failure when the sensor is not connected or never
+            // finished
+            MS_DBG(getSensorNameAndLocation(),
+                   F("did not return a finished conversion"));
         }
     } else {
         MS_DBG(F("Sensor is not currently measuring!\n"));
     }
 
-    // ADD FAILURE CONDITIONS!!
-    if (isnan(res))
-        res = -9999;  // list a failure if the sensor returns nan (not sure
-                      // how this would happen, keep to be safe)
-    else if (res == 0 && i2c_status == 0 && config == 0)
-        res = -9999;  // List a failure when the sensor is not connected
     // Store the results in the sensorValues array
     verifyAndAddMeasurementResult(PTR_VOLTAGE_VAR_NUM, res);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
+    _resultReady                = false;
     // Unset the status bit for a measurement having been requested (bit 5)
     _sensorStatus &= 0b11011111;
     // Set the status bit for measurement completion (bit 6)
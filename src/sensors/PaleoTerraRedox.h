@@ -100,9 +100,21 @@
 /// @brief Sensor::_stabilizationTime_ms; the PaleoTerra redox sensor is
 /// immediately stable.
 #define PTR_STABILIZATION_TIME_MS 0
-/// @brief Sensor::_measurementTime_ms; the PaleoTerra redox sensor takes 67ms
-/// to complete a measurement.
-#define PTR_MEASUREMENT_TIME_MS 67
+/**
+ * @brief Sensor::_measurementTime_ms; the longest the PaleoTerra redox sensor
+ * takes to complete a measurement at the default 18 bit resolution.
+ *
+ * The MCP3421 converts at 3.75 samples per second (267ms) at 18 bits, but its
+ * internal clock can be as much as a third slower.  The time is set again for
+ * the other resolutions by PaleoTerraRedox::setResolution().  The measurement
+ * is usually read sooner, as soon as the ready bit says it is done.
+ */
+#define PTR_MEASUREMENT_TIME_MS 400
+/**
+ * @brief The time between checks of the ready bit of the MCP3421, once the
+ * conversion could be done.
+ */
+#define PTR_STATUS_POLL_INTERVAL_MS 5
 /**@}*/
 
 /**
@@ -248,16 +260,73 @@ class PaleoTerraRedox : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Set the resolution of the MCP3421 conversions.
+     *
+     * Each two bits less resolution makes a conversion four times faster:
+     * 267ms at 18 bits, 67ms at 16, 17ms at 14, and 4ms at 12.  The
+     * measurement time of the sensor is set to match.
+     *
+     * @param resolutionBits The resolution; 12, 14, 16, or 18 bits.  Default
+     * is 18.
+     */
+    void setResolution(uint8_t resolutionBits);
+
+    /**
+     * @brief Start a one-shot conversion on the MCP3421.
+     *
+     * @return **bool** True if the conversion was started.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @brief Check the ready bit of the MCP3421 once the conversion could be
+     * done, and keep the result if it is.
+     *
+     * @copydetails Sensor::isMeasurementComplete()
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
+    /**
+     * @brief Read the result and the configuration byte from the MCP3421.
+     *
+     * @return **bool** True if the result is from a finished conversion.
+     */
+    bool readConversion(void);
+
     /**
      * @brief The I2C address of the redox sensor.
      */
     uint8_t _i2cAddressHex;
+    /**
+     * @brief The resolution of the conversions, in bits.
+     */
+    uint8_t _resolutionBits = 18;
+    /**
+     * @brief The typical time for a conversion at the resolution, in ms.
+     */
+    uint16_t _conversionTime_ms = 267;
+    /**
+     * @brief The last time the ready bit was checked.
+     */
+    uint32_t _lastStatusPoll = 0;
+    /**
+     * @brief The bytes read from the MCP3421: the result and the
+     * configuration.
+     */
+    uint8_t _rawData[4] = {0, 0, 0, 0};
+    /**
+     * @brief True when #_rawData holds a finished conversion.
+     */
+    bool _resultReady = false;
 #if defined MS_PALEOTERRA_SOFTWAREWIRE
     /**
      * @brief An internal reference to the SoftwareWire instance.
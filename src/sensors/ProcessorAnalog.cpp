@@ -0,0 +1,95 @@
+/**
+ * @file ProcessorAnalog.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the processorAnalogRead() function.
+ */
+
+#include "ProcessorAnalog.h"
+
+
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
+
+#if defined(__SAMD51__)
+// The SAMD51 has two ADCs; the core picks the second for the alternate pins
+static Adc* adcForPin(uint8_t pin) {
+    if (g_APinDescription[pin].ulPinAttribute & PIN_ATTR_ANALOG_ALT) {
+        return ADC1;
+    }
+    return ADC0;
+}
+#define ADC_SYNC(adc) \
+    while ((adc)->SYNCBUSY.reg) {}
+#else
+static Adc* adcForPin(uint8_t) {
+    return ADC;
+}
+#define ADC_SYNC(adc) \
+    while ((adc)->STATUS.bit.SYNCBUSY) {}
+#endif
+
+
+// One triggered conversion; with averaging on, this runs all of the samples
+static uint16_t runConversion(Adc* adc) {
+    adc->INTFLAG.reg      = ADC_INTFLAG_RESRDY;
+    adc->SWTRIG.bit.START = 1;
+    while (!adc->INTFLAG.bit.RESRDY) {}
+    return adc->RESULT.reg;
+}
+
+
+float processorAnalogRead(uint8_t pin, uint8_t resolution, uint16_t nSamples) {
+    // The hardware accumulates 2^n samples
+    uint8_t log2Samples = 0;
+    while (log2Samples < 10 && (2U << log2Samples) <= nSamples) {
+        log2Samples++;
+    }
+
+    // Let the core set the input mux and reference; this is also the priming
+    // reading
+    analogRead(pin);
+
+    Adc*    adc        = adcForPin(pin);
+    uint8_t oldResSel  = adc->CTRLB.bit.RESSEL;
+    uint8_t oldAvgCtrl = adc->AVGCTRL.reg;
+    // The sum is shifted right by at most 4, so over 16 samples the result
+    // keeps the extra bits
+    uint8_t adjRes = log2Samples > 4 ? 4 : log2Samples;
+
+    adc->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM(log2Samples) |
+        ADC_AVGCTRL_ADJRES(adjRes);
+    adc->CTRLB.bit.RESSEL = ADC_CTRLB_RESSEL_16BIT_Val;
+    ADC_SYNC(adc);
+    adc->CTRLA.bit.ENABLE = 1;
+    ADC_SYNC(adc);
+
+    uint32_t raw = runConversion(adc);
+
+    // Put everything back the way the core expects it
+    adc->CTRLA.bit.ENABLE = 0;
+    ADC_SYNC(adc);
+    adc->AVGCTRL.reg      = oldAvgCtrl;
+    adc->CTRLB.bit.RESSEL = oldResSel;
+    ADC_SYNC(adc);
+
+    // The result is a 12-bit average with (log2Samples - adjRes) extra bits
+    float average = static_cast<float>(raw) /
+        static_cast<float>(1UL << (log2Samples - adjRes));
+    MS_DBG(F("Averaged"), 1U << log2Samples, F("samples on pin"), pin,
+           F("to"), average, F("of 4096"));
+    return average * static_cast<float>(1UL << resolution) / 4096.0f;
+}
+
+#else
+
+float processorAnalogRead(uint8_t pin, uint8_t, uint16_t nSamples) {
+    if (nSamples == 0) nSamples = 1;
+    analogRead(pin);  // priming reading
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < nSamples; i++) { sum += analogRead(pin); }
+    return static_cast<float>(sum) / nSamples;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file ProcessorAnalog.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the processorAnalogRead() function, an averaged reading of
+ * the processor's own ADC.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_PROCESSORANALOG_H_
+#define SRC_SENSORS_PROCESSORANALOG_H_
+
+// Debugging Statement
+// #define MS_PROCESSORANALOG_DEBUG
+
+#ifdef MS_PROCESSORANALOG_DEBUG
+#define MS_DEBUGGING_STD "ProcessorAnalog"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+
+#ifndef PROCESSOR_ANALOG_SAMPLES
+/**
+ * @brief The default number of ADC samples averaged in each reading.
+ *
+ * On a SAMD board this must be a power of two, up to 1024; any other number is
+ * rounded down to one.
+ */
+#define PROCESSOR_ANALOG_SAMPLES 16
+#endif
+
+/**
+ * @brief Read an analog pin as the average of several samples.
+ *
+ * On SAMD21 and SAMD51 boards the samples are accumulated by the ADC's own
+ * averaging hardware, started with a single trigger, so there is no per-sample
+ * overhead from the core's analogRead().  The core still sets up the pin,
+ * reference and resolution, so analogReference() and analogReadResolution()
+ * work as usual.  Other boards average repeated analogRead() calls.
+ *
+ * A priming reading is always taken and discarded first.
+ *
+ * @param pin The analog pin to read
+ * @param resolution The resolution of the returned value, in bits.  This
+ * should match the one set with analogReadResolution(); it is always 10 on
+ * AVR boards.  Default is 10.
+ * @param nSamples The number of samples to average.  Default is
+ * #PROCESSOR_ANALOG_SAMPLES.
+ * @return **float** The average reading, in the same units as analogRead()
+ */
+float processorAnalogRead(uint8_t pin, uint8_t resolution = 10,
+                          uint16_t nSamples = PROCESSOR_ANALOG_SAMPLES);
+
+#endif  // SRC_SENSORS_PROCESSORANALOG_H_
@@ -8,6 +8,13 @@
  */
 
 #include "ProcessorStats.h"
+#include "LoggerBase.h"
+#include "MemoryReport.h"
+
+// The marker written to the unused RAM, and the stack space left unmarked for
+// the interrupts and calls below the current function
+#define PROCESSOR_RAM_MARKER 0xA5
+#define PROCESSOR_STACK_MARGIN 64
 
 // EnviroDIY boards
 #if defined(ARDUINO_AVR_ENVIRODIY_MAYFLY)
@@ -124,16 +131,44 @@ String ProcessorStats::getSensorLocation(void) {
 }
 
 
-#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
-extern "C" char* sbrk(int i);
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO) || \
+    defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+// Everything between the top of the heap and the bottom of the stack is
+// unused, so it's marked to show later how deep the stack or heap ever got
+static void markFreeRam(void) {
+    char  stack_dummy = 0;
+    char* end         = &stack_dummy - PROCESSOR_STACK_MARGIN;
+    // No interrupt can push onto the stack while the marking is done
+    noInterrupts();
+    for (char* p = MemoryReport::getHeapTop(); p < end; p++) {
+        *p = static_cast<char>(PROCESSOR_RAM_MARKER);
+    }
+    interrupts();
+}
+
 
-int16_t FreeRam() {
-    char stack_dummy = 0;
-    return &stack_dummy - sbrk(0);
+static uint32_t countUntouchedRam(void) {
+    char     stack_dummy = 0;
+    uint32_t untouched   = 0;
+    for (char* p = MemoryReport::getHeapTop(); p < &stack_dummy &&
+         *p == static_cast<char>(PROCESSOR_RAM_MARKER);
+         p++) {
+        untouched++;
+    }
+    return untouched;
 }
 #endif
 
 
+bool ProcessorStats::setup(void) {
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO) || \
+    defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+    markFreeRam();
+#endif
+    return Sensor::setup();  // this will set pin modes and the setup status bit
+}
+
+
 bool ProcessorStats::addSingleMeasurementResult(void) {
     // Get the battery voltage
     MS_DBG(F("Getting battery voltage"));
@@ -143,25 +178,25 @@ bool ProcessorStats::addSingleMeasurementResult(void) {
 #if defined(ARDUINO_AVR_ENVIRODIY_MAYFLY)
     if (strcmp(_version, "v0.3") == 0 || strcmp(_version, "v0.4") == 0) {
         // Get the battery voltage
-        // The return value from analogRead() is IN BITS NOT IN VOLTS!!
-        analogRead(_batteryPin);  // priming reading
-        float rawBattery = analogRead(_batteryPin);
+        // The return value is IN BITS NOT IN VOLTS!!
+        // The priming reading is taken within the averaged read
+        float rawBattery = processorAnalogRead(_batteryPin);
         // convert bits to volts
         sensorValue_battery = (3.3 / 1023.) * 1.47 * rawBattery;
     }
     if (strcmp(_version, "v0.5") == 0 || strcmp(_version, "v0.5b") ||
         strcmp(_version, "v1.0") || strcmp(_version, "v1.1") == 0) {
         // Get the battery voltage
-        // The return value from analogRead() is IN BITS NOT IN VOLTS!!
-        analogRead(_batteryPin);  // priming reading
-        float rawBattery = analogRead(_batteryPin);
+        // The return value is IN BITS NOT IN VOLTS!!
+        // The priming reading is taken within the averaged read
+        float rawBattery = processorAnalogRead(_batteryPin);
         // convert bits to volts
         sensorValue_battery = (3.3 / 1023.) * 4.7 * rawBattery;
     }
 
 #elif defined(ARDUINO_AVR_FEATHER32U4) || defined(ARDUINO_SAMD_FEATHER_M0) || \
     defined(ARDUINO_SAMD_FEATHER_M0_EXPRESS)
-    float measuredvbat = analogRead(_batteryPin);
+    float measuredvbat = processorAnalogRead(_batteryPin);
     measuredvbat *= 2;     // we divided by 2, so multiply back
     measuredvbat *= 3.3;   // Multiply by 3.3V, our reference voltage
     measuredvbat /= 1024;  // convert to voltage
@@ -170,19 +205,19 @@ bool ProcessorStats::addSingleMeasurementResult(void) {
 #elif defined(ARDUINO_SODAQ_ONE) || defined(ARDUINO_SODAQ_ONE_BETA)
     if (strcmp(_version, "v0.1") == 0) {
         // Get the battery voltage
-        float rawBattery    = analogRead(_batteryPin);
+        float rawBattery    = processorAnalogRead(_batteryPin);
         sensorValue_battery = (3.3 / 1023.) * 2 * rawBattery;
     }
     if (strcmp(_version, "v0.2") == 0) {
         // Get the battery voltage
-        float rawBattery    = analogRead(_batteryPin);
+        float rawBattery    = processorAnalogRead(_batteryPin);
         sensorValue_battery = (3.3 / 1023.) * 1.47 * rawBattery;
     }
 
 #elif defined(ARDUINO_AVR_SODAQ_NDOGO) || defined(ARDUINO_SODAQ_AUTONOMO) || \
     defined(ARDUINO_AVR_SODAQ_MBILI)
     // Get the battery voltage
-    float rawBattery    = analogRead(_batteryPin);
+    float rawBattery    = processorAnalogRead(_batteryPin);
     sensorValue_battery = (3.3 / 1023.) * 1.47 * rawBattery;
 
 #else
@@ -196,18 +231,7 @@ bool ProcessorStats::addSingleMeasurementResult(void) {
     // Used only for debugging - can be removed
     MS_DBG(F("Getting Free RAM"));
 
-#if defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
-    extern int16_t __heap_start, *__brkval;
-    int16_t        v;
-    float          sensorValue_freeRam = (int)&v -
-        (__brkval == 0 ? (int)&__heap_start : (int)__brkval);
-
-#elif defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
-    float sensorValue_freeRam = FreeRam();
-
-#else
-    float sensorValue_freeRam = -9999;
-#endif
+    float sensorValue_freeRam = MemoryReport::getFreeRam();
 
     verifyAndAddMeasurementResult(PROCESSOR_RAM_VAR_NUM, sensorValue_freeRam);
 
@@ -216,6 +240,50 @@ bool ProcessorStats::addSingleMeasurementResult(void) {
 
     verifyAndAddMeasurementResult(PROCESSOR_SAMPNUM_VAR_NUM, sampNum);
 
+    float minFreeRam   = -9999;
+    float largestBlock = -9999;
+    float barks        = -9999;
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_SAMD_ZERO)
+    minFreeRam   = countUntouchedRam();
+    largestBlock = MemoryReport::getLargestFreeBlock();
+    barks        = extendedWatchDogSAMD::_barkCount;
+#elif defined(__AVR__) || defined(ARDUINO_ARCH_AVR)
+    minFreeRam   = countUntouchedRam();
+    largestBlock = MemoryReport::getLargestFreeBlock();
+    barks        = extendedWatchDogAVR::_barkCount;
+#endif
+    MS_DBG(F("Minimum free RAM:"), minFreeRam);
+    MS_DBG(F("Largest free block:"), largestBlock);
+    verifyAndAddMeasurementResult(PROCESSOR_MINRAM_VAR_NUM, minFreeRam);
+    verifyAndAddMeasurementResult(PROCESSOR_HEAPBLOCK_VAR_NUM, largestBlock);
+
+    float awakeTime = Logger::getLastAwakeTime();
+    float sleepTime = Logger::getLastSleepTime();
+    MS_DBG(F("Last awake time:"), awakeTime, F("ms"));
+    MS_DBG(F("Last sleep time:"), sleepTime, F("s"));
+    MS_DBG(F("Watchdog barks:"), barks);
+    verifyAndAddMeasurementResult(PROCESSOR_AWAKE_VAR_NUM, awakeTime);
+    verifyAndAddMeasurementResult(PROCESSOR_SLEEP_VAR_NUM, sleepTime);
+    verifyAndAddMeasurementResult(PROCESSOR_BARKS_VAR_NUM, barks);
+
+    float sdWorst    = -9999;
+    float sdP95      = -9999;
+    float sdFailures = -9999;
+#if defined(MS_SD_LATENCY_STATS)
+    // Nothing has been saved before the first record
+    if (Logger::getSDLatencyPercentile(95) >= 0) {
+        sdWorst = Logger::getSDWorstLatency();
+        sdP95   = Logger::getSDLatencyPercentile(95);
+    }
+    sdFailures = Logger::getSDFailureCount();
+#endif
+    MS_DBG(F("SD card worst latency:"), sdWorst, F("ms"));
+    MS_DBG(F("SD card 95th percentile latency:"), sdP95, F("ms"));
+    MS_DBG(F("SD card failures:"), sdFailures);
+    verifyAndAddMeasurementResult(PROCESSOR_SDWORST_VAR_NUM, sdWorst);
+    verifyAndAddMeasurementResult(PROCESSOR_SDP95_VAR_NUM, sdP95);
+    verifyAndAddMeasurementResult(PROCESSOR_SDFAIL_VAR_NUM, sdFailures);
+
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
     // Unset the status bits for a measurement request (bits 5 & 6)
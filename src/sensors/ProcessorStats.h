@@ -5,8 +5,12 @@
  * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
  *
  * @brief Contains the ProcessorStats sensor subclass and the variable
- * subclasses ProcessorStats_Battery, ProcessorStats_FreeRam, and
- * ProcessorStats_SampleNumber.
+ * subclasses ProcessorStats_Battery, ProcessorStats_FreeRam,
+ * ProcessorStats_SampleNumber, ProcessorStats_MinFreeRam,
+ * ProcessorStats_LargestFreeBlock, ProcessorStats_AwakeTime,
+ * ProcessorStats_SleepTime, ProcessorStats_WatchdogBarks,
+ * ProcessorStats_SDWorstLatency, ProcessorStats_SDLatencyP95, and
+ * ProcessorStats_SDFailures.
  *
  * These are for metadata on the processor functionality.
  */
@@ -31,6 +35,15 @@
  * makes no sense to do so for the processor.  These values are only intended to be
  * used as diagnostics.
  *
+ * For tuning a deployed program, it can also return the least free RAM since
+ * setup, the largest block of RAM that can be allocated, how long the last
+ * logging cycle was awake, how long the processor last slept, and how many
+ * times the watchdog's early warning interrupt has fired.  When the library is
+ * built with `MS_SD_LATENCY_STATS` defined, it can also return the longest and
+ * the 95th percentile time to save a record to the SD card and the number of
+ * SD card operations that failed, to find cards wearing out before they lose
+ * data.
+ *
  * @section sensor_processor_datasheet Sensor Datasheet
  * - [Atmel ATmega1284P Datasheet Summary](https://github.com/EnviroDIY/ModularSensors/wiki/Processor-Datasheets/Atmel-ATmega1284P-Datasheet-Summary.pdf)
  * - [Atmel ATmega1284P Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Processor-Datasheets/Atmel-ATmega1284P-Datasheet.pdf)
@@ -67,13 +80,14 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "ProcessorAnalog.h"
 
 /** @ingroup sensor_processor */
 /**@{*/
 
 // Sensor Specific Defines
-/// @brief Sensor::_numReturnedValues; the processor can report 3 values.
-#define PROCESSOR_NUM_VARIABLES 3
+/// @brief Sensor::_numReturnedValues; the processor can report 8 values.
+#define PROCESSOR_NUM_VARIABLES 11
 /// @brief Sensor::_incCalcValues; sample number is (sort-of) calculated.
 #define PROCESSOR_INC_CALC_VARIABLES 1
 
@@ -190,6 +204,217 @@
 #define PROCESSOR_SAMPNUM_DEFAULT_CODE "SampNum"
 /**@}*/
 
+/**
+ * @anchor sensor_processor_minram
+ * @name Minimum Free RAM
+ * The least free RAM there has been since the processor statistics were set up
+ *
+ * This is the stack and heap high-water mark.  The unused RAM is filled with a
+ * marker in setup(), and this counts how much of it is still untouched.  If it
+ * creeps toward zero from one firmware version to the next, the program is
+ * getting close to running out of memory.
+ *
+ * {{ @ref ProcessorStats_MinFreeRam::ProcessorStats_MinFreeRam }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_MINRAM_RESOLUTION 0
+/// @brief The minimum free RAM is stored in sensorValues[3]
+#define PROCESSOR_MINRAM_VAR_NUM 3
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// freeSRAM
+#define PROCESSOR_MINRAM_VAR_NAME "freeSRAM"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "Bit"
+#define PROCESSOR_MINRAM_UNIT_NAME "Bit"
+/// @brief Default variable short code; "MinFreeRam"
+#define PROCESSOR_MINRAM_DEFAULT_CODE "MinFreeRam"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_heapblock
+ * @name Largest Free Block
+ * The largest block of RAM that could be allocated at once
+ *
+ * This is the larger of the biggest block on the heap's free list and the space
+ * between the heap and the stack.  When it is much less than the free RAM, the
+ * heap is fragmented.
+ *
+ * {{ @ref ProcessorStats_LargestFreeBlock::ProcessorStats_LargestFreeBlock }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_HEAPBLOCK_RESOLUTION 0
+/// @brief The largest free block is stored in sensorValues[4]
+#define PROCESSOR_HEAPBLOCK_VAR_NUM 4
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// freeSRAM
+#define PROCESSOR_HEAPBLOCK_VAR_NAME "freeSRAM"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "Bit"
+#define PROCESSOR_HEAPBLOCK_UNIT_NAME "Bit"
+/// @brief Default variable short code; "LargestFreeBlock"
+#define PROCESSOR_HEAPBLOCK_DEFAULT_CODE "LargestFreeBlock"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_awake
+ * @name Awake Time
+ * How long the processor was awake in the last logging cycle, before it went
+ * back to sleep
+ *
+ * {{ @ref ProcessorStats_AwakeTime::ProcessorStats_AwakeTime }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_AWAKE_RESOLUTION 0
+/// @brief The awake time is stored in sensorValues[5]
+#define PROCESSOR_AWAKE_VAR_NUM 5
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// timeElapsed
+#define PROCESSOR_AWAKE_VAR_NAME "timeElapsed"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millisecond"
+#define PROCESSOR_AWAKE_UNIT_NAME "millisecond"
+/// @brief Default variable short code; "AwakeTime"
+#define PROCESSOR_AWAKE_DEFAULT_CODE "AwakeTime"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_sleep
+ * @name Sleep Time
+ * How long the processor slept before this logging cycle, by the RTC
+ *
+ * {{ @ref ProcessorStats_SleepTime::ProcessorStats_SleepTime }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_SLEEP_RESOLUTION 0
+/// @brief The sleep time is stored in sensorValues[6]
+#define PROCESSOR_SLEEP_VAR_NUM 6
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// timeElapsed
+#define PROCESSOR_SLEEP_VAR_NAME "timeElapsed"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "second"
+#define PROCESSOR_SLEEP_UNIT_NAME "second"
+/// @brief Default variable short code; "SleepTime"
+#define PROCESSOR_SLEEP_DEFAULT_CODE "SleepTime"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_barks
+ * @name Watchdog Barks
+ * The number of times the watchdog's early warning interrupt has fired since
+ * the processor started
+ *
+ * Each bark is about 8 seconds awake without the watchdog being fed.
+ *
+ * {{ @ref ProcessorStats_WatchdogBarks::ProcessorStats_WatchdogBarks }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_BARKS_RESOLUTION 0
+/// @brief The watchdog barks is stored in sensorValues[7]
+#define PROCESSOR_BARKS_VAR_NUM 7
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// counter
+#define PROCESSOR_BARKS_VAR_NAME "counter"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "event"
+#define PROCESSOR_BARKS_UNIT_NAME "event"
+/// @brief Default variable short code; "WatchdogBarks"
+#define PROCESSOR_BARKS_DEFAULT_CODE "WatchdogBarks"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_sdworst
+ * @name SD Card Worst Latency
+ * The longest time saving a record to the SD card has taken since the
+ * processor started
+ *
+ * This is only measured when `MS_SD_LATENCY_STATS` is defined.
+ *
+ * {{ @ref ProcessorStats_SDWorstLatency::ProcessorStats_SDWorstLatency }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_SDWORST_RESOLUTION 0
+/// @brief The SD card worst latency is stored in sensorValues[8]
+#define PROCESSOR_SDWORST_VAR_NUM 8
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// timeElapsed
+#define PROCESSOR_SDWORST_VAR_NAME "timeElapsed"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millisecond"
+#define PROCESSOR_SDWORST_UNIT_NAME "millisecond"
+/// @brief Default variable short code; "SDWorstLatency"
+#define PROCESSOR_SDWORST_DEFAULT_CODE "SDWorstLatency"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_sdp95
+ * @name SD Card 95th Percentile Latency
+ * The 95th percentile of the times saving a record to the SD card has taken
+ * since the processor started
+ *
+ * This is read from a histogram with buckets doubling in width, so it may be
+ * up to twice the true percentile.  It is only measured when
+ * `MS_SD_LATENCY_STATS` is defined.
+ *
+ * {{ @ref ProcessorStats_SDLatencyP95::ProcessorStats_SDLatencyP95 }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_SDP95_RESOLUTION 0
+/// @brief The SD card 95th percentile latency is stored in sensorValues[9]
+#define PROCESSOR_SDP95_VAR_NUM 9
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// timeElapsed
+#define PROCESSOR_SDP95_VAR_NAME "timeElapsed"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millisecond"
+#define PROCESSOR_SDP95_UNIT_NAME "millisecond"
+/// @brief Default variable short code; "SDLatencyP95"
+#define PROCESSOR_SDP95_DEFAULT_CODE "SDLatencyP95"
+/**@}*/
+
+/**
+ * @anchor sensor_processor_sdfail
+ * @name SD Card Failures
+ * The number of SD card operations that have failed since the processor
+ * started
+ *
+ * This is only counted when `MS_SD_LATENCY_STATS` is defined.
+ *
+ * {{ @ref ProcessorStats_SDFailures::ProcessorStats_SDFailures }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; should have 0.
+#define PROCESSOR_SDFAIL_RESOLUTION 0
+/// @brief The SD card failures is stored in sensorValues[10]
+#define PROCESSOR_SDFAIL_VAR_NUM 10
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// counter
+#define PROCESSOR_SDFAIL_VAR_NAME "counter"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "event"
+#define PROCESSOR_SDFAIL_UNIT_NAME "event"
+/// @brief Default variable short code; "SDFailures"
+#define PROCESSOR_SDFAIL_DEFAULT_CODE "SDFailures"
+/**@}*/
+
 
 // The main class for the Processor
 // Only need a sleep and wake since these DON'T use the default of powering
@@ -228,6 +453,13 @@ class ProcessorStats : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @copydoc Sensor::setup()
+     *
+     * This also fills the unused RAM with a marker, for the minimum free RAM.
+     */
+    bool setup(void) override;
+
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -381,5 +613,345 @@ class ProcessorStats_SampleNumber : public Variable {
      */
     ~ProcessorStats_SampleNumber() {}
 };
+
+/**
+ * @brief The Variable sub-class used for the
+ * [minimum free RAM output](@ref sensor_processor_minram) from the main
+ * processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_MinFreeRam : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_MinFreeRam object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "MinFreeRam".
+     */
+    explicit ProcessorStats_MinFreeRam(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_MINRAM_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_MINRAM_VAR_NUM,
+                   (uint8_t)PROCESSOR_MINRAM_RESOLUTION,
+                   PROCESSOR_MINRAM_VAR_NAME, PROCESSOR_MINRAM_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_MinFreeRam object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_MinFreeRam()
+        : Variable((const uint8_t)PROCESSOR_MINRAM_VAR_NUM,
+                   (uint8_t)PROCESSOR_MINRAM_RESOLUTION,
+                   PROCESSOR_MINRAM_VAR_NAME, PROCESSOR_MINRAM_UNIT_NAME,
+                   PROCESSOR_MINRAM_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_MinFreeRam object - no action needed.
+     */
+    ~ProcessorStats_MinFreeRam() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the
+ * [largest free block output](@ref sensor_processor_heapblock) from the main
+ * processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_LargestFreeBlock : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_LargestFreeBlock object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "LargestFreeBlock".
+     */
+    explicit ProcessorStats_LargestFreeBlock(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_HEAPBLOCK_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_HEAPBLOCK_VAR_NUM,
+                   (uint8_t)PROCESSOR_HEAPBLOCK_RESOLUTION,
+                   PROCESSOR_HEAPBLOCK_VAR_NAME, PROCESSOR_HEAPBLOCK_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_LargestFreeBlock object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_LargestFreeBlock()
+        : Variable((const uint8_t)PROCESSOR_HEAPBLOCK_VAR_NUM,
+                   (uint8_t)PROCESSOR_HEAPBLOCK_RESOLUTION,
+                   PROCESSOR_HEAPBLOCK_VAR_NAME, PROCESSOR_HEAPBLOCK_UNIT_NAME,
+                   PROCESSOR_HEAPBLOCK_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_LargestFreeBlock object - no action
+     * needed.
+     */
+    ~ProcessorStats_LargestFreeBlock() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the
+ * [awake time output](@ref sensor_processor_awake) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_AwakeTime : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_AwakeTime object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "AwakeTime".
+     */
+    explicit ProcessorStats_AwakeTime(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_AWAKE_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_AWAKE_VAR_NUM,
+                   (uint8_t)PROCESSOR_AWAKE_RESOLUTION,
+                   PROCESSOR_AWAKE_VAR_NAME, PROCESSOR_AWAKE_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_AwakeTime object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_AwakeTime()
+        : Variable((const uint8_t)PROCESSOR_AWAKE_VAR_NUM,
+                   (uint8_t)PROCESSOR_AWAKE_RESOLUTION,
+                   PROCESSOR_AWAKE_VAR_NAME, PROCESSOR_AWAKE_UNIT_NAME,
+                   PROCESSOR_AWAKE_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_AwakeTime object - no action needed.
+     */
+    ~ProcessorStats_AwakeTime() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the
+ * [sleep time output](@ref sensor_processor_sleep) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_SleepTime : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_SleepTime object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SleepTime".
+     */
+    explicit ProcessorStats_SleepTime(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_SLEEP_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_SLEEP_VAR_NUM,
+                   (uint8_t)PROCESSOR_SLEEP_RESOLUTION,
+                   PROCESSOR_SLEEP_VAR_NAME, PROCESSOR_SLEEP_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_SleepTime object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_SleepTime()
+        : Variable((const uint8_t)PROCESSOR_SLEEP_VAR_NUM,
+                   (uint8_t)PROCESSOR_SLEEP_RESOLUTION,
+                   PROCESSOR_SLEEP_VAR_NAME, PROCESSOR_SLEEP_UNIT_NAME,
+                   PROCESSOR_SLEEP_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_SleepTime object - no action needed.
+     */
+    ~ProcessorStats_SleepTime() {}
+};
+
+/**
+ * @brief The Variable sub-class used for the
+ * [watchdog barks output](@ref sensor_processor_barks) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_WatchdogBarks : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_WatchdogBarks object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "WatchdogBarks".
+     */
+    explicit ProcessorStats_WatchdogBarks(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_BARKS_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_BARKS_VAR_NUM,
+                   (uint8_t)PROCESSOR_BARKS_RESOLUTION,
+                   PROCESSOR_BARKS_VAR_NAME, PROCESSOR_BARKS_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_WatchdogBarks object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_WatchdogBarks()
+        : Variable((const uint8_t)PROCESSOR_BARKS_VAR_NUM,
+                   (uint8_t)PROCESSOR_BARKS_RESOLUTION,
+                   PROCESSOR_BARKS_VAR_NAME, PROCESSOR_BARKS_UNIT_NAME,
+                   PROCESSOR_BARKS_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_WatchdogBarks object - no action
+     * needed.
+     */
+    ~ProcessorStats_WatchdogBarks() {}
+};
+/**
+ * @brief The Variable sub-class used for the
+ * [SD card worst latency output](@ref sensor_processor_sdworst) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_SDWorstLatency : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_SDWorstLatency object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SDWorstLatency".
+     */
+    explicit ProcessorStats_SDWorstLatency(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_SDWORST_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_SDWORST_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDWORST_RESOLUTION,
+                   PROCESSOR_SDWORST_VAR_NAME, PROCESSOR_SDWORST_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_SDWorstLatency object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_SDWorstLatency()
+        : Variable((const uint8_t)PROCESSOR_SDWORST_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDWORST_RESOLUTION,
+                   PROCESSOR_SDWORST_VAR_NAME, PROCESSOR_SDWORST_UNIT_NAME,
+                   PROCESSOR_SDWORST_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_SDWorstLatency object - no action
+     * needed.
+     */
+    ~ProcessorStats_SDWorstLatency() {}
+};
+/**
+ * @brief The Variable sub-class used for the
+ * [SD card 95th percentile latency output](@ref sensor_processor_sdp95) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_SDLatencyP95 : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_SDLatencyP95 object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SDLatencyP95".
+     */
+    explicit ProcessorStats_SDLatencyP95(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_SDP95_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_SDP95_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDP95_RESOLUTION,
+                   PROCESSOR_SDP95_VAR_NAME, PROCESSOR_SDP95_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_SDLatencyP95 object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_SDLatencyP95()
+        : Variable((const uint8_t)PROCESSOR_SDP95_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDP95_RESOLUTION,
+                   PROCESSOR_SDP95_VAR_NAME, PROCESSOR_SDP95_UNIT_NAME,
+                   PROCESSOR_SDP95_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_SDLatencyP95 object - no action
+     * needed.
+     */
+    ~ProcessorStats_SDLatencyP95() {}
+};
+/**
+ * @brief The Variable sub-class used for the
+ * [SD card failures output](@ref sensor_processor_sdfail) from the main processor.
+ *
+ * @ingroup sensor_processor
+ */
+class ProcessorStats_SDFailures : public Variable {
+ public:
+    /**
+     * @brief Construct a new ProcessorStats_SDFailures object.
+     *
+     * @param parentSense The parent ProcessorStats providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SDFailures".
+     */
+    explicit ProcessorStats_SDFailures(
+        ProcessorStats* parentSense, const char* uuid = "",
+        const char* varCode = PROCESSOR_SDFAIL_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)PROCESSOR_SDFAIL_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDFAIL_RESOLUTION,
+                   PROCESSOR_SDFAIL_VAR_NAME, PROCESSOR_SDFAIL_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new ProcessorStats_SDFailures object.
+     *
+     * @note This must be tied with a parent ProcessorStats before it can be
+     * used.
+     */
+    ProcessorStats_SDFailures()
+        : Variable((const uint8_t)PROCESSOR_SDFAIL_VAR_NUM,
+                   (uint8_t)PROCESSOR_SDFAIL_RESOLUTION,
+                   PROCESSOR_SDFAIL_VAR_NAME, PROCESSOR_SDFAIL_UNIT_NAME,
+                   PROCESSOR_SDFAIL_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the ProcessorStats_SDFailures object - no action
+     * needed.
+     */
+    ~ProcessorStats_SDFailures() {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_PROCESSORSTATS_H_
@@ -0,0 +1,60 @@
+/**
+ * @file RS485Bus.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the RS485Bus class.
+ */
+
+#include "RS485Bus.h"
+
+
+// The constructor
+RS485Bus::RS485Bus(uint16_t silentInterval_ms)
+    : _silentInterval_ms(silentInterval_ms) {}
+// Destructor
+RS485Bus::~RS485Bus() {}
+
+
+bool RS485Bus::addSensor(Sensor* sensor) {
+    for (uint8_t i = 0; i < _nSensors; i++) {
+        if (_sensors[i] == sensor) return true;
+    }
+    if (_nSensors >= RS485_BUS_MAX_SENSORS) {
+        MS_DBG(F("No room on the RS485 bus for"),
+               sensor->getSensorNameAndLocation());
+        return false;
+    }
+    _sensors[_nSensors++] = sensor;
+    return true;
+}
+
+
+// Only a different device needs the gap; a sensor's own library already
+// spaces out its requests
+void RS485Bus::beginFrame(Sensor* sensor) {
+    if (_lastSensor == nullptr || _lastSensor == sensor) return;
+    while (millis() - _lastFrameEnd < _silentInterval_ms) {}
+}
+
+
+void RS485Bus::endFrame(Sensor* sensor) {
+    _lastSensor   = sensor;
+    _lastFrameEnd = millis();
+}
+
+
+// A sensor is waiting to be started if it's powered and warmed up, but no
+// attempt has been made to wake it (status bit 3)
+bool RS485Bus::deferResult(uint32_t readyAt) {
+    if (millis() - readyAt > RS485_MAX_RESULT_DEFER_MS) return false;
+    for (uint8_t i = 0; i < _nSensors; i++) {
+        uint8_t status = _sensors[i]->getStatus();
+        if (bitRead(status, 2) && !bitRead(status, 3) &&
+            _sensors[i]->isWarmedUp()) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file RS485Bus.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the RS485Bus class, which coordinates the modbus sensors
+ * sharing a single RS485 stream.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_RS485BUS_H_
+#define SRC_SENSORS_RS485BUS_H_
+
+// Debugging Statement
+// #define MS_RS485BUS_DEBUG
+
+#ifdef MS_RS485BUS_DEBUG
+#define MS_DEBUGGING_STD "RS485Bus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "SensorBase.h"
+
+#ifndef RS485_BUS_MAX_SENSORS
+/**
+ * @brief The most sensors that can share one RS485 bus.
+ */
+#define RS485_BUS_MAX_SENSORS 8
+#endif
+
+#ifndef RS485_SILENT_INTERVAL_MS
+/**
+ * @brief The default quiet time on the bus between the end of one sensor's
+ * transaction and the start of another's, in milliseconds.
+ *
+ * Modbus RTU marks the end of a frame with 3.5 character times of silence,
+ * which is just under 4ms at 9600 baud.
+ */
+#define RS485_SILENT_INTERVAL_MS 5
+#endif
+
+#ifndef RS485_MAX_RESULT_DEFER_MS
+/**
+ * @brief The longest a finished measurement is left uncollected while other
+ * sensors on the bus are waiting to be started, in milliseconds.
+ */
+#define RS485_MAX_RESULT_DEFER_MS 1000L
+#endif
+
+/**
+ * @brief A coordinator for the modbus sensors that share one RS485 stream.
+ *
+ * Each sensor on the bus is still its own Sensor in the VariableArray, which
+ * already runs their measurement times side by side.  The bus adds the two
+ * things the sensors can't do alone:
+ *
+ * - A quiet interval is kept between one sensor's transaction and the next
+ * sensor's, so a request isn't lost by following another device's response
+ * too closely and then retried.
+ * - Frames that start a measurement go first.  A sensor's finished result is
+ * not collected while another sensor on the bus is warmed up and waiting to be
+ * woken, so every measurement on the bus is triggered before any of the
+ * results are read.  The wait is capped at #RS485_MAX_RESULT_DEFER_MS.
+ *
+ * Sensors join the bus with their `setBus()` functions.
+ */
+class RS485Bus {
+ public:
+    /**
+     * @brief Construct a new RS485 bus object
+     *
+     * @param silentInterval_ms The quiet time to keep between transactions of
+     * different sensors.  Default is #RS485_SILENT_INTERVAL_MS.
+     */
+    explicit RS485Bus(uint16_t silentInterval_ms = RS485_SILENT_INTERVAL_MS);
+    /**
+     * @brief Destroy the RS485 bus object
+     */
+    ~RS485Bus();
+
+    /**
+     * @brief Add a sensor to the bus.
+     *
+     * @param sensor The sensor sharing the bus
+     * @return **bool** True if there was room for the sensor
+     */
+    bool addSensor(Sensor* sensor);
+    /**
+     * @brief Wait for the bus to be quiet before a sensor starts a
+     * transaction.
+     *
+     * @param sensor The sensor about to use the bus
+     */
+    void beginFrame(Sensor* sensor);
+    /**
+     * @brief Mark the end of a transaction.
+     *
+     * @param sensor The sensor that used the bus
+     */
+    void endFrame(Sensor* sensor);
+    /**
+     * @brief Check whether a finished result should wait so that other
+     * sensors can be started first.
+     *
+     * @param readyAt The millis() the result became ready
+     * @return **bool** True if another sensor on the bus is warmed up and
+     * waiting to be woken, and the result hasn't waited too long already
+     */
+    bool deferResult(uint32_t readyAt);
+
+ private:
+    Sensor*  _sensors[RS485_BUS_MAX_SENSORS];
+    uint8_t  _nSensors = 0;
+    uint16_t _silentInterval_ms;
+    uint32_t _lastFrameEnd = 0;
+    Sensor*  _lastSensor   = nullptr;
+};
+
+#endif  // SRC_SENSORS_RS485BUS_H_
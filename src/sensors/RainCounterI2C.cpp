@@ -89,24 +89,60 @@ bool RainCounterI2C::setup(void) {
 }
 
 
+#if !defined(MS_RAIN_SOFTWAREWIRE)
+// The count is the only read, so it can run alone while the other sensors
+// take their steps; the tip log is still read in the result
+bool RainCounterI2C::startSingleMeasurement(void) {
+    bool success = Sensor::startSingleMeasurement();
+    if (success && _i2cBus != nullptr && _i2cBus->getWire() == _i2c) {
+        _countRead.set(_i2cAddressHex, nullptr, 0, _countBuffer, 4);
+        _i2cBus->queue(&_countRead);
+    }
+    return success;
+}
+
+
+bool RainCounterI2C::isMeasurementComplete(bool debug) {
+    if (!_countRead.isFinished()) {
+        _i2cBus->service();
+        if (!_countRead.isFinished()) return false;
+    }
+    return Sensor::isMeasurementComplete(debug);
+}
+#endif
+
+
 bool RainCounterI2C::addSingleMeasurementResult(void) {
     // intialize values
     float   rain = -9999;  // Number of mm of rain
     int32_t tips = -9999;  // Number of tip events, increased for anemometer
 
-    // Get data from external tip counter
-    // if the 'requestFrom' returns 0, it means no bytes were received
+    // Get data from external tip counter, from the queued read if there was
+    // one; no bytes means no count
+    uint8_t SerialBuffer[4] = {0, 0, 0, 0};  // Create a byte array of 4 bytes
+    uint8_t byte_in         = 0;             // Start iterator for reading Bytes
+#if !defined(MS_RAIN_SOFTWAREWIRE)
+    if (_countRead.status != I2CTransaction::idle) {
+        if (_countRead.status == I2CTransaction::done) {
+            byte_in = _countRead.rxCount;
+            memcpy(SerialBuffer, _countBuffer, byte_in);
+        }
+        _countRead.status = I2CTransaction::idle;
+    } else if (_i2c->requestFrom(static_cast<uint8_t>(_i2cAddressHex),
+                                 static_cast<uint8_t>(4))) {
+#else
     if (_i2c->requestFrom(static_cast<uint8_t>(_i2cAddressHex),
                           static_cast<uint8_t>(4))) {
+#endif
+        // slave may send less than requested
+        while (_i2c->available() && byte_in < 4) {
+            SerialBuffer[byte_in++] = _i2c->read();
+        }
+    }
+    if (byte_in > 0) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
-
-        uint8_t SerialBuffer[4];    // Create a byte array of 4 bytes
-        uint8_t byte_in = 0;        // Start iterator for reading Bytes
-        while (Wire.available()) {  // slave may send less than requested
-            SerialBuffer[byte_in] = Wire.read();
-            MS_DBG(F("  SerialBuffer["), byte_in, F("] = "),
-                   SerialBuffer[byte_in]);
-            byte_in++;  // increment by 1
+        for (uint8_t i = 0; i < byte_in; i++) {
+            MS_DBG(F("  SerialBuffer["), i, F("] = "), SerialBuffer[i]);
         }
 
         // Concatenate bytes into uint32_t by bit-shifting
@@ -146,8 +182,29 @@ bool RainCounterI2C::addSingleMeasurementResult(void) {
         MS_DBG(F("No bytes received from"), getSensorNameAndLocation());
     }
 
+    // The tip log is read after the count, since reading the count is what
+    // clears it on older firmware
+    float peak1 = -9999;  // Peak 1-minute intensity, depth per hour
+    float peak5 = -9999;  // Peak 5-minute intensity, depth per hour
+    if (_tipLogging && tips >= 0) {
+        uint16_t ages[TIP_LOG_MAX_TIPS];
+        int16_t  nTips = readTipLog(_i2c, _i2cAddressHex, ages,
+                                    TIP_LOG_MAX_TIPS);
+        if (nTips >= 0) {
+            peak1 = peakTipsInWindow(ages, nTips, 60) * _rainPerTip * 60;
+            peak5 = peakTipsInWindow(ages, nTips, 300) * _rainPerTip * 12;
+            MS_DBG(F("  Logged tips:"), nTips);
+            MS_DBG(F("  Peak 1-minute intensity:"), peak1);
+            MS_DBG(F("  Peak 5-minute intensity:"), peak5);
+        } else {
+            MS_DBG(F("  No tip log from"), getSensorNameAndLocation());
+        }
+    }
+
     verifyAndAddMeasurementResult(BUCKET_RAIN_VAR_NUM, rain);
     verifyAndAddMeasurementResult(BUCKET_TIPS_VAR_NUM, tips);
+    verifyAndAddMeasurementResult(BUCKET_PEAK1_VAR_NUM, peak1);
+    verifyAndAddMeasurementResult(BUCKET_PEAK5_VAR_NUM, peak5);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
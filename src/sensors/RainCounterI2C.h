@@ -51,6 +51,13 @@
  * not supported. Though, honestly, having more than one attached seems pretty
  * unlikely anyway.
  *
+ * @section sensor_i2c_rain_intensity Rain Intensity
+ * A counter whose firmware also keeps a log of tip times can report the peak
+ * rain intensity within each logging interval.  Call
+ * RainCounterI2C::setTipLogging() to read the log after each count; the
+ * protocol is described in TipTimestampLog.h.  Logging intervals longer than
+ * about 18 hours aren't covered, because the tip ages are 16-bit seconds.
+ *
  * @section sensor_i2c_rain_ctor Sensor Constructors
  * {{ @ref RainCounterI2C::RainCounterI2C(uint8_t, float) }}
  * {{ @ref RainCounterI2C::RainCounterI2C(TwoWire*, uint8_t, float) }}
@@ -82,6 +89,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "TipTimestampLog.h"
 #include <Wire.h>
 
 #if defined MS_RAIN_SOFTWAREWIRE
@@ -92,12 +100,13 @@
 /**@{*/
 
 // Sensor Specific Defines
-/// @brief Sensor::_numReturnedValues; the tipping bucket counter can report 2
+/// @brief Sensor::_numReturnedValues; the tipping bucket counter can report 4
 /// values.
-#define BUCKET_NUM_VARIABLES 2
+#define BUCKET_NUM_VARIABLES 4
 /// @brief Sensor::_incCalcValues; we calculate rain depth from the number of
-/// tips, assuming either English or metric calibration.
-#define BUCKET_INC_CALC_VARIABLES 1
+/// tips, assuming either English or metric calibration, and the peak
+/// intensities from the tip log.
+#define BUCKET_INC_CALC_VARIABLES 3
 
 /**
  * @anchor sensor_i2c_rain_timing
@@ -175,6 +184,62 @@
 #define BUCKET_TIPS_DEFAULT_CODE "RainCounterI2CTips"
 /**@}*/
 
+/**
+ * @anchor sensor_i2c_rain_peak1
+ * @name Peak 1-Minute Intensity
+ * Defines for the peak 1-minute rain intensity from a Trinket-based tipping
+ * bucket counter with a tip log.
+ * - The rate is in the depth units of the tip calibration per hour.
+ *
+ * {{ @ref RainCounterI2C_Peak1MinIntensity::RainCounterI2C_Peak1MinIntensity }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the peak intensity should
+/// have 1.
+#define BUCKET_PEAK1_RESOLUTION 1
+/// @brief Sensor variable number; the peak 1-minute intensity is stored in
+/// sensorValues[2].
+#define BUCKET_PEAK1_VAR_NUM 2
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "rainfallRate"
+#define BUCKET_PEAK1_VAR_NAME "rainfallRate"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millimeterPerHour"
+#define BUCKET_PEAK1_UNIT_NAME "millimeterPerHour"
+/// @brief Default variable short code; "RainCounterI2CPeak1Min"
+#define BUCKET_PEAK1_DEFAULT_CODE "RainCounterI2CPeak1Min"
+/**@}*/
+
+/**
+ * @anchor sensor_i2c_rain_peak5
+ * @name Peak 5-Minute Intensity
+ * Defines for the peak 5-minute rain intensity from a Trinket-based tipping
+ * bucket counter with a tip log.
+ * - The rate is in the depth units of the tip calibration per hour.
+ *
+ * {{ @ref RainCounterI2C_Peak5MinIntensity::RainCounterI2C_Peak5MinIntensity }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the peak intensity should
+/// have 1.
+#define BUCKET_PEAK5_RESOLUTION 1
+/// @brief Sensor variable number; the peak 5-minute intensity is stored in
+/// sensorValues[3].
+#define BUCKET_PEAK5_VAR_NUM 3
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "rainfallRate"
+#define BUCKET_PEAK5_VAR_NAME "rainfallRate"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "millimeterPerHour"
+#define BUCKET_PEAK5_UNIT_NAME "millimeterPerHour"
+/// @brief Default variable short code; "RainCounterI2CPeak5Min"
+#define BUCKET_PEAK5_DEFAULT_CODE "RainCounterI2CPeak5Min"
+/**@}*/
+
 
 /* clang-format off */
 /**
@@ -274,6 +339,34 @@ class RainCounterI2C : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Set whether the log of tip times is read after the count, to give
+     * the peak 1- and 5-minute intensities.
+     *
+     * @warning Only enable this if the counter firmware keeps a tip log!
+     *
+     * @param tipLogging True to read the tip log.  Default is false.
+     */
+    void setTipLogging(bool tipLogging) {
+        _tipLogging = tipLogging;
+    }
+
+#if !defined(MS_RAIN_SOFTWAREWIRE) || defined(DOXYGEN)
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * With the sensor attached to its I2C bus by Sensor::setI2CBus(), this
+     * also queues the read of the count on the bus, so it runs while the
+     * other sensors take their steps.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @copydoc Sensor::isMeasurementComplete()
+     *
+     * A queued read of the count must also have finished.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+#endif
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -284,6 +377,10 @@ class RainCounterI2C : public Sensor {
      * @brief The depth of rain per tip.
      */
     float _rainPerTip;
+    /**
+     * @brief True if the tip log is read
+     */
+    bool _tipLogging = false;
     /**
      * @brief The I2C address of the Trinket counter.
      */
@@ -305,6 +402,14 @@ class RainCounterI2C : public Sensor {
      * @brief An internal reference to the hardware Wire instance.
      */
     TwoWire* _i2c;  // Hardware Wire
+    /**
+     * @brief The read of the count queued on the sensor's I2C bus
+     */
+    I2CTransaction _countRead;
+    /**
+     * @brief The bytes of the count read by #_countRead
+     */
+    uint8_t _countBuffer[4];
 #endif
 };
 
@@ -392,5 +497,95 @@ class RainCounterI2C_Depth : public Variable {
      */
     ~RainCounterI2C_Depth() {}
 };
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [peak 1-minute intensity output](@ref sensor_i2c_rain_peak1) from an
+ * [Adafruit Trinket based I2C tipping bucket counter](@ref sensor_i2c_rain)
+ * - gives the highest rain rate over any minute since the last reading.
+ *
+ * @ingroup sensor_i2c_rain
+ */
+/* clang-format on */
+class RainCounterI2C_Peak1MinIntensity : public Variable {
+ public:
+    /**
+     * @brief Construct a new RainCounterI2C_Peak1MinIntensity object.
+     *
+     * @param parentSense The parent RainCounterI2C providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "RainCounterI2CPeak1Min".
+     */
+    explicit RainCounterI2C_Peak1MinIntensity(
+        RainCounterI2C* parentSense, const char* uuid = "",
+        const char* varCode = BUCKET_PEAK1_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)BUCKET_PEAK1_VAR_NUM,
+                   (uint8_t)BUCKET_PEAK1_RESOLUTION, BUCKET_PEAK1_VAR_NAME,
+                   BUCKET_PEAK1_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new RainCounterI2C_Peak1MinIntensity object.
+     *
+     * @note This must be tied with a parent RainCounterI2C before it can be
+     * used.
+     */
+    RainCounterI2C_Peak1MinIntensity()
+        : Variable((const uint8_t)BUCKET_PEAK1_VAR_NUM,
+                   (uint8_t)BUCKET_PEAK1_RESOLUTION, BUCKET_PEAK1_VAR_NAME,
+                   BUCKET_PEAK1_UNIT_NAME, BUCKET_PEAK1_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the RainCounterI2C_Peak1MinIntensity object - no action
+     * needed.
+     */
+    ~RainCounterI2C_Peak1MinIntensity() {}
+};
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [peak 5-minute intensity output](@ref sensor_i2c_rain_peak5) from an
+ * [Adafruit Trinket based I2C tipping bucket counter](@ref sensor_i2c_rain)
+ * - gives the highest rain rate over any five minutes since the last reading.
+ *
+ * @ingroup sensor_i2c_rain
+ */
+/* clang-format on */
+class RainCounterI2C_Peak5MinIntensity : public Variable {
+ public:
+    /**
+     * @brief Construct a new RainCounterI2C_Peak5MinIntensity object.
+     *
+     * @param parentSense The parent RainCounterI2C providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "RainCounterI2CPeak5Min".
+     */
+    explicit RainCounterI2C_Peak5MinIntensity(
+        RainCounterI2C* parentSense, const char* uuid = "",
+        const char* varCode = BUCKET_PEAK5_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)BUCKET_PEAK5_VAR_NUM,
+                   (uint8_t)BUCKET_PEAK5_RESOLUTION, BUCKET_PEAK5_VAR_NAME,
+                   BUCKET_PEAK5_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new RainCounterI2C_Peak5MinIntensity object.
+     *
+     * @note This must be tied with a parent RainCounterI2C before it can be
+     * used.
+     */
+    RainCounterI2C_Peak5MinIntensity()
+        : Variable((const uint8_t)BUCKET_PEAK5_VAR_NUM,
+                   (uint8_t)BUCKET_PEAK5_RESOLUTION, BUCKET_PEAK5_VAR_NAME,
+                   BUCKET_PEAK5_UNIT_NAME, BUCKET_PEAK5_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the RainCounterI2C_Peak5MinIntensity object - no action
+     * needed.
+     */
+    ~RainCounterI2C_Peak5MinIntensity() {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_RAINCOUNTERI2C_H_
@@ -0,0 +1,167 @@
+/**
+ * @file SDI12Bus.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the SDI12Bus and SDI12BusGroup classes.
+ */
+
+#include "SDI12Bus.h"
+
+
+// The constructor
+SDI12Bus::SDI12Bus() {}
+// Destructor
+SDI12Bus::~SDI12Bus() {
+    if (_group == nullptr) return;
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < _group->_nBuses; i++) {
+        if (_group->_buses[i] != this) {
+            _group->_buses[kept++] = _group->_buses[i];
+        }
+    }
+    _group->_nBuses = kept;
+}
+
+
+bool SDI12Bus::addSensor(Sensor* sensor) {
+    if (indexOf(sensor) >= 0) return true;
+    if (_nSensors >= SDI12_BUS_MAX_SENSORS) {
+        MS_DBG(F("No room on the SDI-12 bus for"),
+               sensor->getSensorNameAndLocation());
+        return false;
+    }
+    _sensors[_nSensors++] = sensor;
+    return true;
+}
+
+
+int8_t SDI12Bus::indexOf(Sensor* sensor) {
+    for (uint8_t i = 0; i < _nSensors; i++) {
+        if (_sensors[i] == sensor) return i;
+    }
+    return -1;
+}
+
+
+void SDI12Bus::measurementStarted(Sensor* sensor, uint32_t dueAt) {
+    int8_t i = indexOf(sensor);
+    if (i < 0) return;
+    _dueAt[i] = dueAt;
+    _measuringMask |= (1 << i);
+}
+
+
+void SDI12Bus::measurementCollected(Sensor* sensor) {
+    int8_t i = indexOf(sensor);
+    if (i >= 0) _measuringMask &= ~(1 << i);
+}
+
+
+// A sensor is waiting to be started if it's powered and warmed up, but no
+// attempt has been made to wake it (status bit 3)
+bool SDI12Bus::otherWaitingToStart(Sensor* sensor) {
+    for (uint8_t i = 0; i < _nSensors; i++) {
+        if (_sensors[i] == sensor) continue;
+        uint8_t status = _sensors[i]->getStatus();
+        if (bitRead(status, 2) && !bitRead(status, 3) &&
+            _sensors[i]->isWarmedUp()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Only a measurement that is already due holds up another; one that isn't due
+// yet may never finish early
+bool SDI12Bus::otherDueBefore(Sensor* sensor, uint32_t dueAt, uint32_t now) {
+    for (uint8_t i = 0; i < _nSensors; i++) {
+        if (_sensors[i] == sensor || !(_measuringMask & (1 << i))) continue;
+        if (static_cast<int32_t>(now - _dueAt[i]) >= 0 &&
+            static_cast<int32_t>(_dueAt[i] - dueAt) < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool SDI12Bus::otherMeasuring(Sensor* sensor) {
+    int8_t   self   = indexOf(sensor);
+    uint16_t others = _measuringMask;
+    if (self >= 0) others &= ~(1 << self);
+    return others != 0;
+}
+
+
+// In a group, the sensors on every pin are checked
+bool SDI12Bus::deferResult(Sensor* sensor) {
+    int8_t self = indexOf(sensor);
+    if (self < 0 || !(_measuringMask & (1 << self))) return false;
+    uint32_t now = millis();
+    if (static_cast<int32_t>(now - _dueAt[self]) > SDI12_MAX_RESULT_DEFER_MS) {
+        return false;
+    }
+    if (_group != nullptr) {
+        return _group->otherWaitingToStart(sensor) ||
+            _group->otherDueBefore(sensor, _dueAt[self], now);
+    }
+    return otherWaitingToStart(sensor) ||
+        otherDueBefore(sensor, _dueAt[self], now);
+}
+
+
+bool SDI12Bus::keepActive(Sensor* sensor) {
+    if (_group != nullptr) {
+        return _group->otherMeasuring(sensor) ||
+            _group->otherWaitingToStart(sensor);
+    }
+    return otherMeasuring(sensor) || otherWaitingToStart(sensor);
+}
+
+
+// The constructor
+SDI12BusGroup::SDI12BusGroup() {}
+// Destructor
+SDI12BusGroup::~SDI12BusGroup() {
+    for (uint8_t i = 0; i < _nBuses; i++) _buses[i]->_group = nullptr;
+}
+
+
+bool SDI12BusGroup::addBus(SDI12Bus& bus) {
+    if (bus._group == this) return true;
+    if (bus._group != nullptr || _nBuses >= SDI12_GROUP_MAX_BUSES) {
+        MS_DBG(F("No room in the SDI-12 bus group for another bus"));
+        return false;
+    }
+    _buses[_nBuses++] = &bus;
+    bus._group        = this;
+    return true;
+}
+
+
+bool SDI12BusGroup::otherWaitingToStart(Sensor* sensor) {
+    for (uint8_t i = 0; i < _nBuses; i++) {
+        if (_buses[i]->otherWaitingToStart(sensor)) return true;
+    }
+    return false;
+}
+
+
+bool SDI12BusGroup::otherDueBefore(Sensor* sensor, uint32_t dueAt,
+                                   uint32_t now) {
+    for (uint8_t i = 0; i < _nBuses; i++) {
+        if (_buses[i]->otherDueBefore(sensor, dueAt, now)) return true;
+    }
+    return false;
+}
+
+
+bool SDI12BusGroup::otherMeasuring(Sensor* sensor) {
+    for (uint8_t i = 0; i < _nBuses; i++) {
+        if (_buses[i]->otherMeasuring(sensor)) return true;
+    }
+    return false;
+}
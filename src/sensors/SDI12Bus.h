@@ -0,0 +1,257 @@
+/**
+ * @file SDI12Bus.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the SDI12Bus class, which coordinates the SDI-12 sensors
+ * sharing a single data pin, and the SDI12BusGroup class, which interleaves
+ * the buses of several pins.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_SDI12BUS_H_
+#define SRC_SENSORS_SDI12BUS_H_
+
+// Debugging Statement
+// #define MS_SDI12BUS_DEBUG
+
+#ifdef MS_SDI12BUS_DEBUG
+#define MS_DEBUGGING_STD "SDI12Bus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "SensorBase.h"
+
+#ifndef SDI12_BUS_MAX_SENSORS
+/**
+ * @brief The most sensors that can share one SDI-12 bus; one for each of the
+ * ten numeric addresses.
+ */
+#define SDI12_BUS_MAX_SENSORS 10
+#endif
+
+#ifndef SDI12_GROUP_MAX_BUSES
+/**
+ * @brief The most SDI-12 buses, on separate data pins, in one group.
+ */
+#define SDI12_GROUP_MAX_BUSES 4
+#endif
+
+#ifndef SDI12_MAX_RESULT_DEFER_MS
+/**
+ * @brief The longest a finished measurement is left uncollected for other
+ * sensors on the bus, in milliseconds.
+ */
+#define SDI12_MAX_RESULT_DEFER_MS 1000L
+#endif
+
+/**
+ * @brief A coordinator for the SDI-12 sensors that share one data pin.
+ *
+ * Each sensor on the bus is still its own Sensor in the VariableArray, which
+ * already runs their concurrent measurements side by side.  The bus adds:
+ *
+ * - The SDI-12 interface stays active, with its timer set, from the first
+ * measurement started until the last one is collected, instead of being set up
+ * and torn down around every command.
+ * - The separate acknowledgement before each measurement is skipped; the reply
+ * to the concurrent measurement command already confirms the sensor is there.
+ * - Measurement commands go first.  No result is collected while another
+ * sensor on the bus is warmed up and waiting to be started, so every [a]C!
+ * goes out back to back.
+ * - Results are collected in the order their measurements are due, so a
+ * sensor that was ready first isn't kept waiting behind another's data
+ * commands.
+ *
+ * A finished result waits at most #SDI12_MAX_RESULT_DEFER_MS past its due time.
+ *
+ * Sensors join the bus with their `setBus()` functions.
+ *
+ * Buses on separate data pins can be joined in an SDI12BusGroup, so these
+ * rules hold across all of them.
+ *
+ * @note A break is still sent before every command.  An SDI-12 sensor that
+ * isn't addressed by a command goes back to sleep, so a single break can't
+ * wake several sensors for commands to each of them in turn.
+ */
+class SDI12BusGroup;
+class SDI12Bus {
+ public:
+    /**
+     * @brief Construct a new SDI-12 bus object
+     */
+    SDI12Bus();
+    /**
+     * @brief Destroy the SDI-12 bus object, taking it out of its group
+     */
+    ~SDI12Bus();
+
+    /**
+     * @brief Add a sensor to the bus.
+     *
+     * @param sensor The sensor sharing the bus
+     * @return **bool** True if there was room for the sensor
+     */
+    bool addSensor(Sensor* sensor);
+    /**
+     * @brief Note that a sensor has started a measurement.
+     *
+     * @param sensor The sensor measuring
+     * @param dueAt The millis() the measurement is due to be ready
+     */
+    void measurementStarted(Sensor* sensor, uint32_t dueAt);
+    /**
+     * @brief Note that a sensor's measurement has been collected.
+     *
+     * @param sensor The sensor that was measuring
+     */
+    void measurementCollected(Sensor* sensor);
+    /**
+     * @brief Check whether a finished result should wait for the other
+     * sensors on the bus.
+     *
+     * @param sensor The sensor with the finished result
+     * @return **bool** True if another sensor on the bus is waiting to be
+     * started, or has a measurement that was due earlier and is still
+     * uncollected
+     */
+    bool deferResult(Sensor* sensor);
+    /**
+     * @brief Check whether the SDI-12 interface should be left active after a
+     * sensor is done with it.
+     *
+     * @param sensor The sensor done with the interface
+     * @return **bool** True if another sensor on the bus is measuring or
+     * waiting to be started
+     */
+    bool keepActive(Sensor* sensor);
+
+ private:
+    /**
+     * @brief Get the position of a sensor on the bus.
+     *
+     * @param sensor The sensor to find
+     * @return **int8_t** The position, or -1 if the sensor isn't on the bus
+     */
+    int8_t indexOf(Sensor* sensor);
+    /**
+     * @brief Check whether any sensor other than the one given is powered and
+     * warmed up, but hasn't been woken (status bit 3) to start measuring.
+     *
+     * @param sensor The sensor to skip
+     * @return **bool** True if another sensor is waiting to be started
+     */
+    bool otherWaitingToStart(Sensor* sensor);
+    /**
+     * @brief Check whether any sensor other than the one given has an
+     * uncollected measurement that is due, and was due before a time.
+     *
+     * @param sensor The sensor to skip
+     * @param dueAt The millis() to compare with
+     * @param now The millis() now
+     * @return **bool** True if another result was due first
+     */
+    bool otherDueBefore(Sensor* sensor, uint32_t dueAt, uint32_t now);
+    /**
+     * @brief Check whether any sensor other than the one given is measuring.
+     *
+     * @param sensor The sensor to skip
+     * @return **bool** True if another sensor is measuring
+     */
+    bool otherMeasuring(Sensor* sensor);
+
+    Sensor*        _sensors[SDI12_BUS_MAX_SENSORS];
+    uint32_t       _dueAt[SDI12_BUS_MAX_SENSORS];
+    uint16_t       _measuringMask = 0;
+    uint8_t        _nSensors      = 0;
+    SDI12BusGroup* _group         = nullptr;
+
+    friend class SDI12BusGroup;
+};
+
+
+/**
+ * @brief A group of SDI-12 buses on separate data pins, interleaved as if
+ * they were one.
+ *
+ * Only one data pin can have the SDI-12 timer and interrupts at a time, so
+ * each command takes them for its own pin in turn.  The group keeps the
+ * commands on every pin in the order a single bus would:
+ *
+ * - Every [a]C! on every pin goes out before any result is collected, so
+ * the measurement windows on the pins overlap instead of adding together.
+ * - Results are collected in the order they are due, whichever pin they are
+ * on.
+ * - The interface isn't torn down while a sensor on any pin is measuring or
+ * waiting to be started.
+ *
+ * A standard measurement waiting on its service request only hears it while
+ * its pin has the interrupts, so on a pin of a group it mostly waits its full
+ * time; use concurrent measurements there.
+ *
+ * @code{.cpp}
+ * SDI12Bus      bus1, bus2;
+ * SDI12BusGroup sdi12Pins;
+ * sdi12Pins.addBus(bus1);
+ * sdi12Pins.addBus(bus2);
+ * @endcode
+ * with each sensor joined to the bus of its pin by its `setBus()` function.
+ */
+class SDI12BusGroup {
+ public:
+    /**
+     * @brief Construct a new SDI-12 bus group object
+     */
+    SDI12BusGroup();
+    /**
+     * @brief Destroy the SDI-12 bus group object, leaving its buses on their
+     * own
+     */
+    ~SDI12BusGroup();
+
+    /**
+     * @brief Add a bus to the group.
+     *
+     * @param bus The bus of one data pin; it can only be in one group
+     * @return **bool** True if there was room for the bus
+     */
+    bool addBus(SDI12Bus& bus);
+
+ private:
+    /**
+     * @brief Check whether any sensor on any bus of the group, other than the
+     * one given, is waiting to be started.
+     *
+     * @param sensor The sensor to skip
+     * @return **bool** True if another sensor is waiting to be started
+     */
+    bool otherWaitingToStart(Sensor* sensor);
+    /**
+     * @brief Check whether any sensor on any bus of the group, other than the
+     * one given, has an uncollected result that was due first.
+     *
+     * @param sensor The sensor to skip
+     * @param dueAt The millis() to compare with
+     * @param now The millis() now
+     * @return **bool** True if another result was due first
+     */
+    bool otherDueBefore(Sensor* sensor, uint32_t dueAt, uint32_t now);
+    /**
+     * @brief Check whether any sensor on any bus of the group, other than the
+     * one given, is measuring.
+     *
+     * @param sensor The sensor to skip
+     * @return **bool** True if another sensor is measuring
+     */
+    bool otherMeasuring(Sensor* sensor);
+
+    SDI12Bus* _buses[SDI12_GROUP_MAX_BUSES];
+    uint8_t   _nBuses = 0;
+
+    friend class SDI12Bus;
+};
+
+#endif  // SRC_SENSORS_SDI12BUS_H_
@@ -11,6 +11,23 @@
 #include <EnableInterrupt.h>     // To handle external and pin change interrupts
 
 #include "SDI12Sensors.h"
+#ifdef MS_SDI12_CACHE_INFO
+#include <avr/eeprom.h>
+
+// The layout of the saved info of one sensor
+#define SDI12_INFO_CACHE_MAGIC 0x5D
+struct SDI12InfoRecord {
+    uint8_t magic;
+    char    address;
+    int8_t  dataPin;
+    char    vendor[9];
+    char    model[7];
+    char    version[4];
+    char    serialNumber[14];
+};
+static_assert(sizeof(SDI12InfoRecord) <= SDI12_INFO_CACHE_SLOT_SIZE,
+              "The SDI-12 info cache slots are too small");
+#endif
 
 
 // The constructor - need the number of measurements the sensor will return,
@@ -65,10 +82,17 @@ bool SDI12Sensors::setup(void) {
     bool retVal =
         Sensor::setup();  // this will set pin modes and the setup status bit
 
+#ifdef MS_SDI12_CACHE_INFO
+    // Info saved at an earlier setup means the sensor needn't be asked again
+    bool cached = readCachedInfo();
+#else
+    bool cached = false;
+#endif
+
     // This sensor needs power for setup!
     bool wasOn = checkPowerOn();
-    if (!wasOn) { powerUp(); }
-    waitForWarmUp();
+    if (!wasOn && !cached) { powerUp(); }
+    if (!cached) { waitForWarmUp(); }
 
     // Begin the SDI-12 interface
     _SDI12Internal.begin();
@@ -86,7 +110,16 @@ bool SDI12Sensors::setup(void) {
     enableInterrupt(_dataPin, SDI12::handleInterrupt, CHANGE);
 #endif
 
-    retVal &= getSensorInfo();
+    if (cached) {
+        MS_DBG(F("  Using the saved sensor info for"),
+               getSensorNameAndLocation());
+    } else if (getSensorInfo()) {
+#ifdef MS_SDI12_CACHE_INFO
+        saveCachedInfo();
+#endif
+    } else {
+        retVal = false;
+    }
 
     // Empty the SDI-12 buffer
     _SDI12Internal.clearBuffer();
@@ -96,7 +129,7 @@ bool SDI12Sensors::setup(void) {
     _SDI12Internal.end();
 
     // Turn the power back off it it had been turned on
-    if (!wasOn) { powerDown(); }
+    if (!wasOn && !cached) { powerDown(); }
 
     if (!retVal) {  // if set-up failed
         // Set the status error bit (bit 7)
@@ -109,36 +142,64 @@ bool SDI12Sensors::setup(void) {
 }
 
 
+// Sends [address][command]
+void SDI12Sensors::sendSDI12Command(const char* command) {
+    char fullCommand[8];
+    fullCommand[0] = _SDI12address;
+    strncpy(fullCommand + 1, command, sizeof(fullCommand) - 1);
+    fullCommand[sizeof(fullCommand) - 1] = '\0';
+    _SDI12Internal.sendCommand(fullCommand, _extraWakeTime);
+    MS_DEEP_DBG(F("    >>>"), fullCommand);
+}
+
+
+// Reads up to the line ending, returning as soon as it arrives
+uint8_t SDI12Sensors::readSDI12Response(char* buffer, uint8_t bufferSize) {
+    uint8_t  len      = 0;
+    uint32_t lastChar = millis();
+    uint32_t timeout  = SDI12_RESPONSE_TIMEOUT_MS;
+    while (millis() - lastChar < timeout) {
+        if (!_SDI12Internal.available()) continue;
+        char c   = static_cast<char>(_SDI12Internal.read());
+        lastChar = millis();
+        timeout  = SDI12_CHARACTER_TIMEOUT_MS;
+        if (c == '\n') break;
+        // Drop the carriage return, and any leading spaces or line noise
+        if (c == '\r' || (len == 0 && (c == ' ' || c == '\0'))) continue;
+        if (len < bufferSize - 1) buffer[len++] = c;
+    }
+    // Trim trailing spaces
+    while (len > 0 && buffer[len - 1] == ' ') len--;
+    buffer[len] = '\0';
+    MS_DEEP_DBG(F("    <<<"), buffer);
+    return len;
+}
+
+
 bool SDI12Sensors::requestSensorAcknowledgement(void) {
     // Empty the buffer
     _SDI12Internal.clearBuffer();
 
     MS_DBG(F("  Asking for sensor acknowlegement"));
-    String myCommand = "";
-    myCommand += _SDI12address;
-    myCommand += "!";  // sends 'acknowledge active' command [address][!]
-
+    char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
     bool    didAcknowledge = false;
     uint8_t ntries         = 0;
     while (!didAcknowledge && ntries < 5) {
-        _SDI12Internal.sendCommand(myCommand, _extraWakeTime);
-        MS_DEEP_DBG(F("    >>>"), myCommand);
-        delay(30);
+        // sends 'acknowledge active' command [address][!]
+        sendSDI12Command("!");
 
         // wait for acknowlegement with format:
         // [address]<CR><LF>
-        String sdiResponse = _SDI12Internal.readStringUntil('\n');
-        sdiResponse.trim();
-        MS_DEEP_DBG(F("    <<<"), sdiResponse);
+        uint8_t len = readSDI12Response(sdiResponse, sizeof(sdiResponse));
 
         // Empty the buffer again
         _SDI12Internal.clearBuffer();
 
-        if (sdiResponse == String(_SDI12address)) {
+        if (len == 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied as expected."));
             didAcknowledge = true;
-        } else if (sdiResponse.startsWith(String(_SDI12address))) {
+        } else if (len > 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied, unexpectedly"));
             didAcknowledge = true;
@@ -168,19 +229,15 @@ bool SDI12Sensors::getSensorInfo(void) {
     if (!requestSensorAcknowledgement()) return false;
 
     MS_DBG(F("  Getting sensor info"));
-    String myCommand = "";
-    myCommand += _SDI12address;
-    myCommand += "I!";  // sends 'info' command [address][I][!]
-    _SDI12Internal.sendCommand(myCommand, _extraWakeTime);
-    MS_DEEP_DBG(F("    >>>"), myCommand);
-    delay(30);
+    sendSDI12Command("I!");  // sends 'info' command [address][I][!]
 
     // wait for acknowlegement with format:
     // [address][SDI12 version supported (2 char)][vendor (8 char)][model (6
     // char)][version (3 char)][serial number (<14 char)]<CR><LF>
-    String sdiResponse = _SDI12Internal.readStringUntil('\n');
-    sdiResponse.trim();
-    MS_DEEP_DBG(F("    <<<"), sdiResponse);
+    char sdiResponseBuffer[SDI12_RESPONSE_BUFFER_SIZE];
+    readSDI12Response(sdiResponseBuffer, sizeof(sdiResponseBuffer));
+    // The info is only read once, at setup, so it's split up as a String
+    String sdiResponse = sdiResponseBuffer;
 
     // Empty the buffer again
     _SDI12Internal.clearBuffer();
@@ -212,18 +269,11 @@ bool SDI12Sensors::getSensorInfo(void) {
         // explicitly suppress it just in case.
         if (_sensorVendor == "METER" && _SDI12address == 0) {
             MS_DBG(F("  Suppressing DDI string on Meter sensor"));
-            myCommand = "";
-            myCommand += _SDI12address;
-            myCommand += "XO1!";  // sends extended command
-                                  // [address][XO][suppressionState][!]
-                                  // 0: DDI unsuppressed
-                                  // 1: DDI suppressed
-            _SDI12Internal.sendCommand(myCommand, _extraWakeTime);
-            MS_DEEP_DBG(F("    >>>"), myCommand);
-            delay(30);
-            String supressionResponse = _SDI12Internal.readStringUntil('\n');
-            supressionResponse.trim();
-            MS_DEEP_DBG(F("    <<<"), supressionResponse);
+            // sends extended command [address][XO][suppressionState][!]
+            // 0: DDI unsuppressed
+            // 1: DDI suppressed
+            sendSDI12Command("XO1!");
+            readSDI12Response(sdiResponseBuffer, sizeof(sdiResponseBuffer));
         }
         return true;
     } else {
@@ -260,10 +310,128 @@ String SDI12Sensors::getSensorLocation(void) {
     return sensorLocation;
 }
 
+#ifdef MS_SDI12_CACHE_INFO
+// Finds the slot of this address and pin, or else an unused slot
+static uint8_t* findInfoSlot(char address, int8_t dataPin, bool& found) {
+    uint8_t* freeSlot = nullptr;
+    found             = false;
+    for (uint8_t i = 0; i < SDI12_INFO_CACHE_SLOTS; i++) {
+        auto* slot = reinterpret_cast<uint8_t*>(SDI12_INFO_CACHE_START +
+                                                i * SDI12_INFO_CACHE_SLOT_SIZE);
+        SDI12InfoRecord record;
+        eeprom_read_block(&record, slot, 3);
+        if (record.magic != SDI12_INFO_CACHE_MAGIC) {
+            if (freeSlot == nullptr) freeSlot = slot;
+        } else if (record.address == address && record.dataPin == dataPin) {
+            found = true;
+            return slot;
+        }
+    }
+    return freeSlot;
+}
+
+
+bool SDI12Sensors::readCachedInfo(void) {
+    bool     found;
+    uint8_t* slot = findInfoSlot(_SDI12address, _dataPin, found);
+    if (!found) return false;
+    SDI12InfoRecord record;
+    eeprom_read_block(&record, slot, sizeof(record));
+    // Make sure a damaged record can't run off the end of a field
+    record.vendor[sizeof(record.vendor) - 1]             = '\0';
+    record.model[sizeof(record.model) - 1]               = '\0';
+    record.version[sizeof(record.version) - 1]           = '\0';
+    record.serialNumber[sizeof(record.serialNumber) - 1] = '\0';
+    _sensorVendor       = record.vendor;
+    _sensorModel        = record.model;
+    _sensorVersion      = record.version;
+    _sensorSerialNumber = record.serialNumber;
+    return true;
+}
+
+
+void SDI12Sensors::saveCachedInfo(void) {
+    bool     found;
+    uint8_t* slot = findInfoSlot(_SDI12address, _dataPin, found);
+    if (slot == nullptr) {
+        MS_DBG(F("  No room to save the sensor info"));
+        return;
+    }
+    SDI12InfoRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic   = SDI12_INFO_CACHE_MAGIC;
+    record.address = _SDI12address;
+    record.dataPin = _dataPin;
+    _sensorVendor.toCharArray(record.vendor, sizeof(record.vendor));
+    _sensorModel.toCharArray(record.model, sizeof(record.model));
+    _sensorVersion.toCharArray(record.version, sizeof(record.version));
+    _sensorSerialNumber.toCharArray(record.serialNumber,
+                                    sizeof(record.serialNumber));
+    // Update only writes the bytes that changed, to spare the EEPROM
+    eeprom_update_block(&record, slot, sizeof(record));
+}
+
+
+void SDI12Sensors::clearCachedInfo(void) {
+    bool     found;
+    uint8_t* slot = findInfoSlot(_SDI12address, _dataPin, found);
+    if (found) eeprom_update_byte(slot, 0xFF);
+}
+#endif
+
+
+void SDI12Sensors::setUseCRC(bool useCRC) {
+    _useCRC = useCRC;
+}
+
+
+// CRC-16 with the reversed polynomial, as given in the SDI-12 specification
+uint16_t SDI12Sensors::calculateCRC(const char* response, uint8_t len) {
+    uint16_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint8_t>(response[i]);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (crc & 0x0001) {
+                crc = (crc >> 1) ^ 0xA001;
+            } else {
+                crc >>= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+
+bool SDI12Sensors::checkCRC(char* response, uint8_t& len) {
+    // The address, then the three CRC characters
+    if (len < 4) return false;
+    uint8_t  dataLen     = len - 3;
+    uint16_t crc         = calculateCRC(response, dataLen);
+    char     expected[3] = {static_cast<char>(0x40 | (crc >> 12)),
+                        static_cast<char>(0x40 | ((crc >> 6) & 0x3F)),
+                        static_cast<char>(0x40 | (crc & 0x3F))};
+    if (strncmp(response + dataLen, expected, 3) != 0) return false;
+    response[dataLen] = '\0';
+    len               = dataLen;
+    return true;
+}
+
+
+// Continuous measurements are ready as soon as they are asked for
+void SDI12Sensors::setContinuous(bool continuous) {
+    if (continuous && !_continuous) {
+        _discreteMeasurementTime_ms = _measurementTime_ms;
+        _measurementTime_ms         = 0;
+    } else if (!continuous && _continuous) {
+        _measurementTime_ms = _discreteMeasurementTime_ms;
+    }
+    _continuous = continuous;
+}
+
+
 // Sending the command to start a measurement
 int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
-    String startCommand;
-    String sdiResponse;
+    char sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
 
     // Try up to 3 times to start a measurement
     uint8_t numVariables = 0;
@@ -278,33 +446,30 @@ int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
             MS_DBG(F("  Beginning NON-concurrent (standard) measurement on"),
                    getSensorNameAndLocation());
         }
-        startCommand = "";
-        startCommand += _SDI12address;
+        _SDI12Internal.clearBuffer();
         if (isConcurrent) {
-            startCommand += "C!";  // Start concurrent measurement - format
-                                   // [address]['C'][!]
+            // Start concurrent measurement - format [address]['C'][!], or
+            // [address]['C']['C'][!] to have the data sent with a CRC
+            sendSDI12Command(_useCRC ? "CC!" : "C!");
         } else {
-            startCommand += "M!";  // Start standard measurement - format
-            // [address]['M'][!]
+            // Start standard measurement - format [address]['M'][!], or
+            // [address]['M']['C'][!] to have the data sent with a CRC
+            sendSDI12Command(_useCRC ? "MC!" : "M!");
         }
-        _SDI12Internal.clearBuffer();
-        _SDI12Internal.sendCommand(startCommand, _extraWakeTime);
-        delay(30);  // It just needs this little delay
-        MS_DEEP_DBG(F("    >>>"), startCommand);
 
         // wait for acknowlegement with format
         // [address][ttt (3 char, seconds)][number of values to be returned,
         // 0-9]<CR><LF>
-        sdiResponse = _SDI12Internal.readStringUntil('\n');
-        sdiResponse.trim();
+        uint8_t len = readSDI12Response(sdiResponse, sizeof(sdiResponse));
         _SDI12Internal.clearBuffer();
-        MS_DEEP_DBG(F("    <<<"), sdiResponse);
 
         // find out how long we have to wait (in seconds).
-        if (sdiResponse.length() > 3) {
-            wait = static_cast<uint8_t>(sdiResponse.substring(1, 4).toInt());
-            numVariables =
-                static_cast<uint8_t>(sdiResponse.substring(4).toInt());
+        if (len > 3) {
+            // The three digits of ttt, then the rest are the count
+            char ttt[4] = {sdiResponse[1], sdiResponse[2], sdiResponse[3],
+                           '\0'};
+            wait         = static_cast<uint8_t>(atoi(ttt));
+            numVariables = static_cast<uint8_t>(atoi(sdiResponse + 4));
         }
 
         // Empty the buffer again
@@ -317,6 +482,10 @@ int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
         PRINTOUT(numVariables, F("results expected"),
                  F("This differs from the sensor's standard design of"),
                  (_numReturnedValues - _incCalcValues), F("measurements!!"));
+#ifdef MS_SDI12_CACHE_INFO
+        // The sensor may be missing or replaced, so ask again at next setup
+        clearCachedInfo();
+#endif
     }
 
     // Return how long we're expecting to wait for a measurement
@@ -334,6 +503,17 @@ bool SDI12Sensors::startSingleMeasurement(void) {
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
+    // There's nothing to start for a continuous measurement; reading the
+    // values will show whether the sensor is there
+    if (_continuous) {
+        MS_DBG(F("    Continuous measurement will be read."));
+        _dataReady = true;
+        if (_bus != nullptr) {
+            _bus->measurementStarted(this, _millisMeasurementRequested);
+        }
+        return true;
+    }
+
     // Check if this the currently active SDI-12 Object
     bool wasActive = _SDI12Internal.isActive();
     // If it wasn't active, activate it now.
@@ -342,26 +522,39 @@ bool SDI12Sensors::startSingleMeasurement(void) {
     // Empty the buffer
     _SDI12Internal.clearBuffer();
 
-    // Check that the sensor is there and responding
-    if (!requestSensorAcknowledgement()) {
+    // Check that the sensor is there and responding; on a shared bus, the
+    // reply to the measurement command is acknowledgement enough
+    if (_bus == nullptr && !requestSensorAcknowledgement()) {
         _millisMeasurementRequested = 0;
         _sensorStatus &= 0b10111111;
         return false;
     }
 
-    // send the commands to start the measurement; true = concurrent
+    // send the commands to start the measurement; concurrent unless we're
+    // listening for the service request of a standard measurement
     // the returned wait time should always be non-zero
-    int8_t wait = startSDI12Measurement(true);
+    int8_t wait = startSDI12Measurement(!_useServiceRequest);
 
-    // De-activate the SDI-12 Object
+    // De-activate the SDI-12 Object, unless it has to hear the service request
     // Use end() instead of just forceHold to un-set the timers
-    if (!wasActive) _SDI12Internal.end();
+    if (!wasActive && !_useServiceRequest && !keepBusActive()) {
+        _SDI12Internal.end();
+    }
 
     // Set the times we've activated the sensor and asked for a measurement
     if (wait >= 0) {
-        MS_DBG(F("    Concurrent measurement started."));
+        MS_DBG(_useServiceRequest ? F("    Standard measurement started.")
+                                  : F("    Concurrent measurement started."));
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        // Nothing is ready yet, and the polls start over
+        _dataReady       = false;
+        _pollInterval_ms = SDI12_FIRST_POLL_MS;
+        _nextPoll_ms     = SDI12_FIRST_POLL_MS;
+        if (_bus != nullptr) {
+            _bus->measurementStarted(this, _millisMeasurementRequested +
+                                         _measurementTime_ms);
+        }
         // Set the status bit for measurement start success (bit 6)
         _sensorStatus |= 0b01000000;
         return true;
@@ -373,6 +566,93 @@ bool SDI12Sensors::startSingleMeasurement(void) {
         return false;
     }
 }
+
+
+void SDI12Sensors::setEarlyCompletion(bool useServiceRequest,
+                                      bool pollConcurrent) {
+    _useServiceRequest = useServiceRequest;
+    _pollConcurrent    = pollConcurrent;
+}
+
+
+void SDI12Sensors::setBus(SDI12Bus& bus) {
+    if (bus.addSensor(this)) _bus = &bus;
+}
+
+
+// Reads the service request, [address]<CR><LF>, if it has arrived
+bool SDI12Sensors::checkServiceRequest(void) {
+    // If another sensor has taken over the SDI-12 interrupts since we started,
+    // we can't hear the request and have to wait out the full time instead
+    if (!_SDI12Internal.isActive() || _SDI12Internal.available() < 3) {
+        return false;
+    }
+    char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+    uint8_t len = readSDI12Response(sdiResponse, sizeof(sdiResponse));
+    return len > 0 && sdiResponse[0] == _SDI12address;
+}
+
+
+// Asks for the first set of data; a finished measurement returns values
+bool SDI12Sensors::pollForData(void) {
+    bool wasActive = _SDI12Internal.isActive();
+    if (!wasActive) _SDI12Internal.begin();
+    _SDI12Internal.clearBuffer();
+
+    sendSDI12Command("D0!");
+    char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+    uint8_t len = readSDI12Response(sdiResponse, sizeof(sdiResponse));
+    _SDI12Internal.clearBuffer();
+
+    if (!wasActive && !keepBusActive()) _SDI12Internal.end();
+
+    // Every value starts with its sign, right after the address
+    return len > 1 && (sdiResponse[1] == '+' || sdiResponse[1] == '-');
+}
+
+
+// Checks the time, and then for a service request or polled data
+bool SDI12Sensors::isMeasurementComplete(bool debug) {
+    bool ready = Sensor::isMeasurementComplete(debug) || _dataReady ||
+        isDataReadyEarly(debug);
+    // Leave a finished result for the other sensors on a shared bus
+    if (ready && _bus != nullptr && _bus->deferResult(this)) return false;
+    return ready;
+}
+
+
+// Checks for a service request, or polls when the next poll is due
+bool SDI12Sensors::isDataReadyEarly(bool debug) {
+    uint32_t elapsed = millis() - _millisMeasurementRequested;
+    if (_useServiceRequest) {
+        _dataReady = checkServiceRequest();
+    } else if (_pollConcurrent && elapsed >= _nextPoll_ms) {
+        _dataReady = pollForData();
+        // Back off, so a slow sensor isn't asked over and over
+        _pollInterval_ms *= 2;
+        _nextPoll_ms += _pollInterval_ms;
+    }
+    if (_dataReady && debug) {
+        MS_DBG(getSensorNameAndLocation(), F("finished early, after"), elapsed,
+               F("ms"));
+    }
+    return _dataReady;
+}
+
+
+// Never idles past the next check for early data
+uint32_t SDI12Sensors::getMeasurementTimeRemaining(void) {
+    uint32_t remaining = Sensor::getMeasurementTimeRemaining();
+    if (remaining == 0 || _dataReady) return 0;
+    uint32_t untilCheck = remaining;
+    if (_useServiceRequest) {
+        untilCheck = SDI12_SERVICE_REQUEST_CHECK_MS;
+    } else if (_pollConcurrent) {
+        uint32_t elapsed = millis() - _millisMeasurementRequested;
+        untilCheck = elapsed >= _nextPoll_ms ? 0 : _nextPoll_ms - elapsed;
+    }
+    return untilCheck < remaining ? untilCheck : remaining;
+}
 #endif
 
 bool SDI12Sensors::getResults(void) {
@@ -400,74 +680,60 @@ bool SDI12Sensors::getResults(void) {
         bool gotResults = false;
         // Assemble the command based on how many commands we've already sent,
         // starting with D0 and ending with D9
-        // SDI-12 command to get data [address][D][dataOption][!]
-        String getDataCommand = "";
-        getDataCommand += _SDI12address;
-        getDataCommand += "D";
-        getDataCommand += cmd_number;
-        getDataCommand += "!";
-        _SDI12Internal.sendCommand(getDataCommand, _extraWakeTime);
-        delay(30);  // It just needs this little delay
-        MS_DEEP_DBG(F("    >>>"), getDataCommand);
-
-        // Wait for the first few charaters to arrive.  The response from a data
-        // request should always have more than three characters
-        uint32_t start = millis();
-        while (_SDI12Internal.available() < 3 && (millis() - start) < 1500) {
-            // wait
+        // SDI-12 command to get data [address][D][dataOption][!], or for a
+        // continuous measurement [address][R][C if CRC][dataOption][!]
+        char    getDataCommand[5];
+        uint8_t cmdLen          = 0;
+        getDataCommand[cmdLen++] = _continuous ? 'R' : 'D';
+        if (_continuous && _useCRC) getDataCommand[cmdLen++] = 'C';
+        getDataCommand[cmdLen++] = '0' + cmd_number;
+        getDataCommand[cmdLen++] = '!';
+        getDataCommand[cmdLen]   = '\0';
+
+        // Read the whole line, which ends as soon as the line ending arrives.
+        // A line with a bad CRC is asked for again, but the measurement isn't
+        // started over.
+        char    sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+        uint8_t len = 0;
+        for (uint8_t attempt = 0; attempt <= SDI12_CRC_RETRIES; attempt++) {
+            sendSDI12Command(getDataCommand);
+            len = readSDI12Response(sdiResponse, sizeof(sdiResponse));
+            if (!_useCRC || checkCRC(sdiResponse, len)) break;
+            MS_DBG(F("  Bad CRC on"), getDataCommand, F("response"));
+            len = 0;
         }
-        // read the returned address to remove it from the buffer
-        auto returnedAddress = static_cast<char>(_SDI12Internal.read());
         // print out a warning if the address doesn't match up
-        if (returnedAddress != _SDI12address) {
+        if (len > 0 && sdiResponse[0] != _SDI12address) {
             MS_DBG(F("Warning, expecting data from"), _SDI12address,
-                   F("but got data from"), returnedAddress);
+                   F("but got data from"), sdiResponse[0]);
         }
-        // Start printing out the returned data
-        MS_DEEP_DBG(F("    <<<"), returnedAddress);
-
-        // While there is any data left in the buffer
-        while (_SDI12Internal.available() && (millis() - start) < 3000) {
-            // First peek to see if the next character in the buffer is a number
-            int c = _SDI12Internal.peek();
-            // if there's a number, a decimal, or a negative sign next in the
-            // buffer, start reading it as a float.
-            if (c == '-' || (c >= '0' && c <= '9') || c == '.') {
-                // Read the float without skipping any in-valid characters.
-                // We don't want to skip anything because we want to be able to
-                // debug and see exactly which characters the sensor sent over
-                // if they weren't numbers.
-                // Reading the numbers as a float will remove them from the
-                // buffer.
-                float result = _SDI12Internal.parseFloat(SKIP_NONE);
-                // The SDI-12 library should return -9999 on timeout
-                if (result == -9999 || isnan(result)) result = -9999;
-                // Print out what we got
-                MS_DBG(F("    <<<"), String(result, 10));
-                // Verify that the number is valid and add it to the result
-                // array. After each result is read, tick up the number of
-                // results received so that the next one goes in the next spot
-                // in the variable array.
-                verifyAndAddMeasurementResult(resultsReceived, result);
-                if (result != -9999) {
-                    gotResults = true;
-                    resultsReceived++;
-                }
-                // if the next spot in the buffer isn't a number, we don't want
-                // to try and parse it, but we do want to print it out to the
-                // debugging port
-            } else {
-// if we're debugging print out the non-numeric character
-#ifdef MS_SDI12SENSORS_DEBUG_DEEP
-                MS_DEEP_DBG(F("    <<<"),
-                            static_cast<char>(_SDI12Internal.read()));
-#else
-                // if we're not debugging, just read the character to make sure
-                // it's removed from the buffer
-                _SDI12Internal.read();
-#endif
+
+        // Each value starts with its sign, so the sign of the next value ends
+        // the one before it
+        char* next = sdiResponse + 1;
+        while (len > 0 && *next != '\0') {
+            char* end    = next;
+            float result = -9999;
+            if (*next == '+' || *next == '-') {
+                result = static_cast<float>(strtod(next, &end));
+            }
+            if (end == next) {
+                // Skip anything that isn't a number
+                next++;
+                continue;
+            }
+            next = end;
+            // Print out what we got
+            MS_DBG(F("    <<<"), String(result, 10));
+            // Verify that the number is valid and add it to the result
+            // array. After each result is read, tick up the number of
+            // results received so that the next one goes in the next spot
+            // in the variable array.
+            verifyAndAddMeasurementResult(resultsReceived, result);
+            if (result != -9999) {
+                gotResults = true;
+                resultsReceived++;
             }
-            delay(10);  // 1 character ~ 7.5ms
         }
         if (!gotResults) {
             MS_DBG(F("  No results received, will not continue requests!"));
@@ -484,7 +750,7 @@ bool SDI12Sensors::getResults(void) {
 
     // De-activate the SDI-12 Object
     // Use end() instead of just forceHold to un-set the timers
-    if (!wasActive) _SDI12Internal.end();
+    if (!wasActive && !keepBusActive()) _SDI12Internal.end();
 
     return (_numReturnedValues - _incCalcValues) == resultsReceived;
 }
@@ -497,7 +763,10 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
     if (bitRead(_sensorStatus, 6)) {
+        if (_bus != nullptr) _bus->measurementCollected(this);
         success = getResults();
+        // Stop listening, now that the standard measurement is read
+        if (_useServiceRequest && !keepBusActive()) _SDI12Internal.end();
     } else {
         // If there's no measurement, need to make sure we send over all
         // of the "failed" result values
@@ -518,9 +787,6 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
 bool SDI12Sensors::addSingleMeasurementResult(void) {
     bool success = false;
 
-    String startCommand;
-    String sdiResponse;
-
     // Check if this the currently active SDI-12 Object
     bool wasActive = _SDI12Internal.isActive();
     // If it wasn't active, activate it now.
@@ -530,8 +796,14 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
     // Empty the buffer
     _SDI12Internal.clearBuffer();
 
-    // Check that the sensor is there and responding
-    if (requestSensorAcknowledgement()) {
+    if (_continuous) {
+        // The latest values can be read right away
+        MS_DBG(F("    Reading continuous measurement."));
+        _millisMeasurementRequested = millis();
+        _sensorStatus |= 0b01000000;
+        success = getResults();
+    } else if (requestSensorAcknowledgement()) {
+        // Check that the sensor is there and responding
         // send the commands to start the measurement; false = not concurrent
         // the returned wait time should always be non-zero
         int8_t wait = startSDI12Measurement(false);
@@ -552,23 +824,12 @@ bool SDI12Sensors::addSingleMeasurementResult(void) {
             while ((millis() - timerStart) < (1000 * (wait))) {
                 // sensor can interrupt us to let us know it is done early
                 if (_SDI12Internal.available()) {
-#ifdef MS_SDI12SENSORS_DEBUG_DEEP
-                    // if we're debugging print out early response
-                    MS_DEEP_DBG(F("    <<<"),
-                                _SDI12Internal.readStringUntil('\n'));
-                    _SDI12Internal.clearBuffer();
+                    // read the whole request to remove it from the buffer
+                    char sdiResponse[SDI12_RESPONSE_BUFFER_SIZE];
+                    readSDI12Response(sdiResponse, sizeof(sdiResponse));
                     break;
-#else
-                    // if we're not debugging, just read the response to make
-                    // sure it's removed from the buffer
-                    _SDI12Internal.readStringUntil('\n');
-                    _SDI12Internal.clearBuffer();
-                    break;
-#endif
                 }
             }
-            // Wait for anything else and clear it out
-            delay(30);
             _SDI12Internal.clearBuffer();
 
             // get the results
@@ -76,12 +76,97 @@
 #define MS_DEBUGGING_DEEP "SDI12Sensors"
 #endif
 
+#ifdef MS_SDI12_CACHE_INFO
+#if !defined(__AVR__)
+#error The SDI-12 sensor info cache needs the EEPROM of an AVR board!
+#endif
+
+#ifndef SDI12_INFO_CACHE_SLOTS
+/**
+ * @brief The number of SDI-12 sensors whose info can be saved in EEPROM.
+ */
+#define SDI12_INFO_CACHE_SLOTS 10
+#endif
+
+#ifndef SDI12_INFO_CACHE_SLOT_SIZE
+/**
+ * @brief The EEPROM bytes kept for the saved info of each sensor.
+ */
+#define SDI12_INFO_CACHE_SLOT_SIZE 40
+#endif
+
+#ifndef SDI12_INFO_CACHE_START
+/**
+ * @brief The first EEPROM address of the saved sensor info.  By default the
+ * info is kept at the very end of the EEPROM.
+ */
+#define SDI12_INFO_CACHE_START \
+    (E2END + 1 - SDI12_INFO_CACHE_SLOTS * SDI12_INFO_CACHE_SLOT_SIZE)
+#endif
+#endif
+
+#ifndef SDI12_RESPONSE_BUFFER_SIZE
+/**
+ * @brief The size of the buffer for a single line of a response.
+ *
+ * This holds the 75 characters of values allowed in the response to a
+ * concurrent data command, plus the address, a CRC and the terminator.  Any
+ * more of a line is dropped.
+ */
+#define SDI12_RESPONSE_BUFFER_SIZE 80
+#endif
+
+#ifndef SDI12_RESPONSE_TIMEOUT_MS
+/**
+ * @brief The longest to wait for the first character of a response, in
+ * milliseconds; ten times the 15ms the SDI-12 protocol allows a sensor.
+ */
+#define SDI12_RESPONSE_TIMEOUT_MS 150
+#endif
+
+#ifndef SDI12_CHARACTER_TIMEOUT_MS
+/**
+ * @brief The longest to wait between the characters of a response, in
+ * milliseconds.
+ *
+ * A character takes 8.33ms at 1200 baud, and the protocol allows 1.66ms of
+ * marking between characters.
+ */
+#define SDI12_CHARACTER_TIMEOUT_MS 20
+#endif
+
+#ifndef SDI12_CRC_RETRIES
+/**
+ * @brief The number of times a data line with a bad CRC is requested again.
+ */
+#define SDI12_CRC_RETRIES 2
+#endif
+
+#ifndef SDI12_FIRST_POLL_MS
+/**
+ * @brief The time after starting a concurrent measurement before the first
+ * data poll, when polling is enabled with SDI12Sensors::setEarlyCompletion().
+ *
+ * Each poll after that waits twice as long as the one before.
+ */
+#define SDI12_FIRST_POLL_MS 250
+#endif
+
+#ifndef SDI12_SERVICE_REQUEST_CHECK_MS
+/**
+ * @brief The longest the processor idles between checks for a service request,
+ * when listening for one with SDI12Sensors::setEarlyCompletion().
+ */
+#define SDI12_SERVICE_REQUEST_CHECK_MS 20
+#endif
+
 // Included Dependencies
 #include "ModSensorDebugger.h"
 #undef MS_DEBUGGING_STD
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "SDI12Bus.h"
 #ifdef SDI12_EXTERNAL_PCINT
 #include <SDI12.h>
 #else
@@ -198,6 +283,37 @@ class SDI12Sensors : public Sensor {
      * and the SDI-12 address.
      */
     String getSensorLocation(void) override;
+    /**
+     * @brief Set whether measurements are started with the CRC variants of
+     * the measurement commands, `aMC!` and `aCC!`.
+     *
+     * Each line of data the sensor returns then ends with a 16-bit CRC.  A
+     * line with a bad CRC is requested again, up to #SDI12_CRC_RETRIES times,
+     * without starting the measurement over.  This is worth turning on for
+     * long cables, where characters are sometimes corrupted.
+     *
+     * @param useCRC True to request and check CRCs.  Default is false.
+     */
+    void setUseCRC(bool useCRC);
+    /**
+     * @brief Set whether results are read with the continuous measurement
+     * commands, `aR0!` to `aR9!`, instead of starting a measurement.
+     *
+     * A sensor that supports continuous measurements samples on its own and
+     * returns its latest values right away, so there is no measurement to
+     * start and no measurement time to wait out.  While this is on the
+     * measurement time is 0, and turning it off restores the measurement
+     * time given to the constructor.  With setUseCRC(), the values are read
+     * with `aRC0!` to `aRC9!`.
+     *
+     * @note Only turn this on for sensors that support continuous
+     * measurements; see the sensor's SDI-12 manual.  Many sensors answer
+     * `aR0!` with no values at all.
+     *
+     * @param continuous True to read continuous measurements.  Default is
+     * false.
+     */
+    void setContinuous(bool continuous);
 
     /**
      * @brief Do any one-time preparations needed before the sensor will be able
@@ -210,6 +326,12 @@ class SDI12Sensors : public Sensor {
      * sensor and calls the getSensorInfo() function.  Sensor power **is**
      * required.
      *
+     * When built with `MS_SDI12_CACHE_INFO` on an AVR board, the info is saved
+     * in EEPROM and later setups use it without powering or querying the
+     * sensor.  The saved info is forgotten whenever the sensor doesn't answer
+     * a measurement command with the expected number of values, so the next
+     * setup asks the sensor again.
+     *
      * @return **bool** True if the setup was successful.
      */
     bool setup(void) override;
@@ -229,6 +351,52 @@ class SDI12Sensors : public Sensor {
      * successfully.
      */
     bool startSingleMeasurement(void) override;
+
+    /**
+     * @brief Set how the end of a measurement can be detected before the full
+     * measurement time has passed.
+     *
+     * With a service request, measurements are started with a standard `aM!`
+     * command and the sensor's `a<CR><LF>` service request ends the wait as
+     * soon as its data is ready.  The request can only be heard while no other
+     * SDI-12 sensor is being talked to, so this suits a sensor alone on its
+     * pin; otherwise the wait falls back to the full measurement time.
+     *
+     * With polling, concurrent `aC!` measurements are checked with `aD0!`,
+     * first after #SDI12_FIRST_POLL_MS and then with a doubling backoff, and
+     * the measurement is done as soon as the sensor returns values.
+     *
+     * @param useServiceRequest True to start standard measurements and listen
+     * for the service request.  Default is false.
+     * @param pollConcurrent True to poll concurrent measurements for data.
+     * Default is false.
+     */
+    void setEarlyCompletion(bool useServiceRequest, bool pollConcurrent);
+    /**
+     * @brief Share an SDI-12 bus with the other sensors on the same data pin.
+     *
+     * The interface is kept active across the whole measurement cycle, every
+     * sensor on the bus is started before any results are collected, and the
+     * results are collected in the order they are due.  See SDI12Bus; join
+     * the buses of several data pins in an SDI12BusGroup to interleave them.
+     *
+     * @param bus The bus shared by every sensor on this data pin
+     */
+    void setBus(SDI12Bus& bus);
+    /**
+     * @copydoc Sensor::isMeasurementComplete()
+     *
+     * This also checks for a service request or polls for data, if set with
+     * setEarlyCompletion().  On a shared bus, a finished result may wait for
+     * the other sensors; see SDI12Bus::deferResult().
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+    /**
+     * @copydoc Sensor::getMeasurementTimeRemaining()
+     *
+     * When polling, this is at most the time until the next poll.
+     */
+    uint32_t getMeasurementTimeRemaining(void) override;
 #endif
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
@@ -236,6 +404,78 @@ class SDI12Sensors : public Sensor {
     bool addSingleMeasurementResult(void) override;
 
  protected:
+    /**
+     * @brief Send a command to the sensor, after its address.
+     *
+     * @param command The command without the address, like "M!"
+     */
+    void sendSDI12Command(const char* command);
+    /**
+     * @brief Read one line of a response into a buffer, without the line
+     * ending.
+     *
+     * The read ends as soon as the line ending arrives, after
+     * #SDI12_RESPONSE_TIMEOUT_MS with no response, or after
+     * #SDI12_CHARACTER_TIMEOUT_MS without another character.
+     *
+     * @param buffer The buffer to read into; always null terminated
+     * @param bufferSize The size of the buffer
+     * @return **uint8_t** The length of the response in the buffer
+     */
+    uint8_t readSDI12Response(char* buffer, uint8_t bufferSize);
+    /**
+     * @brief Check whether the SDI-12 interface should be left active for the
+     * other sensors on a shared bus, instead of ended.
+     *
+     * @return **bool** True if another sensor on the bus still needs it
+     */
+    /**
+     * @brief Calculate the SDI-12 CRC of a response.
+     *
+     * This is the CRC-16 of polynomial 0xA001 with an initial value of 0, run
+     * over every character from the address to the end of the data.
+     *
+     * @param response The response
+     * @param len The number of characters to include
+     * @return **uint16_t** The CRC
+     */
+    static uint16_t calculateCRC(const char* response, uint8_t len);
+    /**
+     * @brief Check the CRC at the end of a line of data and remove it.
+     *
+     * The CRC is sent as three ASCII characters, each holding 6 of its bits
+     * with 0x40 added, before the line ending.
+     *
+     * @param response The line of data, without its line ending
+     * @param len The length of the line; shortened by the three CRC
+     * characters if the CRC matches
+     * @return **bool** True if the CRC matches the data
+     */
+    static bool checkCRC(char* response, uint8_t& len);
+#ifdef MS_SDI12_CACHE_INFO
+    /**
+     * @brief Load the sensor info saved in EEPROM at an earlier setup.
+     *
+     * @return **bool** True if info was saved for this address and pin
+     */
+    bool readCachedInfo(void);
+    /**
+     * @brief Save the sensor info in EEPROM, for the next setup.
+     */
+    void saveCachedInfo(void);
+    /**
+     * @brief Forget the saved sensor info, so the next setup asks the sensor
+     * again.
+     */
+    void clearCachedInfo(void);
+#endif
+    bool keepBusActive(void) {
+#ifndef MS_SDI12_NON_CONCURRENT
+        return _bus != nullptr && _bus->keepActive(this);
+#else
+        return false;
+#endif
+    }
     /**
      * @brief Send the SDI-12 'acknowledge active' command [address][!] to a
      * sensor and confirm that the correct sensor responded.
@@ -274,6 +514,31 @@ class SDI12Sensors : public Sensor {
      * returned.
      */
     virtual bool getResults(void);
+#ifndef MS_SDI12_NON_CONCURRENT
+    /**
+     * @brief Check whether the data is ready before the full measurement time,
+     * as set with setEarlyCompletion().
+     *
+     * @param debug True to print out when the data is ready
+     * @return **bool** True if the service request arrived or a poll returned
+     * values
+     */
+    bool isDataReadyEarly(bool debug);
+    /**
+     * @brief Check whether the sensor has sent its service request, saying the
+     * data of a standard measurement is ready.
+     *
+     * @return **bool** True if the service request was received
+     */
+    bool checkServiceRequest(void);
+    /**
+     * @brief Send a data command to see whether a concurrent measurement has
+     * finished.
+     *
+     * @return **bool** True if the sensor returned values
+     */
+    bool pollForData(void);
+#endif
     /**
      * @brief Internal reference to the SDI-12 object.
      */
@@ -289,6 +554,22 @@ class SDI12Sensors : public Sensor {
     int8_t _extraWakeTime;
 
  private:
+    // Whether measurements are started with the CRC commands
+    bool _useCRC = false;
+    // Whether continuous measurements are read, and the measurement time to
+    // go back to when they aren't
+    bool     _continuous                 = false;
+    uint32_t _discreteMeasurementTime_ms = 0;
+#ifndef MS_SDI12_NON_CONCURRENT
+    // How to finish a measurement early, and when the next data poll is due
+    bool     _useServiceRequest = false;
+    bool     _pollConcurrent    = false;
+    bool     _dataReady         = false;
+    uint32_t _nextPoll_ms       = 0;
+    uint32_t _pollInterval_ms   = SDI12_FIRST_POLL_MS;
+    // The bus shared with the other sensors on the pin, if any
+    SDI12Bus* _bus = nullptr;
+#endif
     String _sensorVendor;
     String _sensorModel;
     String _sensorVersion;
@@ -9,6 +9,12 @@
 
 #include "SensirionSHT4x.h"
 
+// The measurement commands, and the I2C address of every SHT4x
+#define SHT4X_I2C_ADDRESS 0x44
+#define SHT4X_CMD_MEASURE_HIGH 0xFD
+#define SHT4X_CMD_MEASURE_MED 0xF6
+#define SHT4X_CMD_MEASURE_LOW 0xE0
+
 
 // The constructors
 SensirionSHT4x::SensirionSHT4x(TwoWire* theI2C, int8_t powerPin, bool useHeater,
@@ -63,8 +69,8 @@ bool SensirionSHT4x::setup(void) {
         ntries++;
     }
 
-    // Set sensor for high precision
-    sht4x_internal.setPrecision(SHT4X_HIGH_PRECISION);
+    // Set the sensor precision
+    sht4x_internal.setPrecision(_precision);
 
     // Initially, set the sensor up to *not* use the heater
     sht4x_internal.setHeater(SHT4X_NO_HEATER);
@@ -85,6 +91,96 @@ bool SensirionSHT4x::setup(void) {
 }
 
 
+void SensirionSHT4x::setPrecision(sht4x_precision_t precision) {
+    _precision = precision;
+    switch (precision) {
+        case SHT4X_LOW_PRECISION:
+            _measurementTime_ms = SHT4X_LOW_MEASUREMENT_TIME_MS;
+            break;
+        case SHT4X_MED_PRECISION:
+            _measurementTime_ms = SHT4X_MED_MEASUREMENT_TIME_MS;
+            break;
+        default: _measurementTime_ms = SHT4X_MEASUREMENT_TIME_MS; break;
+    }
+}
+
+
+// Moves the number of measurements to the batch, and back
+void SensirionSHT4x::setBatchedAveraging(bool batched) {
+    if (batched && _batchReadings == 0) {
+        _batchReadings         = _measurementsToAverage;
+        _measurementsToAverage = 1;
+    } else if (!batched && _batchReadings > 0) {
+        _measurementsToAverage = _batchReadings;
+        _batchReadings         = 0;
+    }
+}
+
+
+// The Adafruit library's getEvent() sends the command and then waits, so
+// the command is sent directly to let the measurement run in the meantime
+bool SensirionSHT4x::sendMeasurementCommand(void) {
+    uint8_t command = SHT4X_CMD_MEASURE_HIGH;
+    if (_precision == SHT4X_MED_PRECISION) command = SHT4X_CMD_MEASURE_MED;
+    if (_precision == SHT4X_LOW_PRECISION) command = SHT4X_CMD_MEASURE_LOW;
+    _i2c->beginTransmission(SHT4X_I2C_ADDRESS);
+    _i2c->write(command);
+    return _i2c->endTransmission() == 0;
+}
+
+
+// CRC-8 with polynomial 0x31 and initial value 0xFF, from the datasheet
+static uint8_t sht4xCRC(const uint8_t* data) {
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < 2; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+bool SensirionSHT4x::readMeasurement(float& temp, float& humid) {
+    temp  = -9999;
+    humid = -9999;
+    // Temperature, then humidity, each as two bytes and a CRC
+    uint8_t data[6];
+    if (_i2c->requestFrom(SHT4X_I2C_ADDRESS, 6) != 6) return false;
+    for (uint8_t i = 0; i < 6; i++) data[i] = _i2c->read();
+    if (sht4xCRC(data) != data[2] || sht4xCRC(data + 3) != data[5]) {
+        MS_DBG(F("  Bad CRC from"), getSensorNameAndLocation());
+        return false;
+    }
+    uint16_t rawTemp  = (static_cast<uint16_t>(data[0]) << 8) | data[1];
+    uint16_t rawHumid = (static_cast<uint16_t>(data[3]) << 8) | data[4];
+    temp              = -45 + 175 * (rawTemp / 65535.0);
+    humid             = -6 + 125 * (rawHumid / 65535.0);
+    // Crop the humidity to the physical range, as the datasheet suggests
+    if (humid > 100) humid = 100;
+    if (humid < 0) humid = 0;
+    return true;
+}
+
+
+bool SensirionSHT4x::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+
+    if (!sendMeasurementCommand()) {
+        MS_DBG(getSensorNameAndLocation(),
+               F("did not respond to measurement request!"));
+        _millisMeasurementRequested = 0;
+        _sensorStatus &= 0b10111111;
+        return false;
+    }
+    return true;
+}
+
+
 bool SensirionSHT4x::addSingleMeasurementResult(void) {
     // Initialize float variables
     float temp_val  = -9999;
@@ -96,31 +192,30 @@ bool SensirionSHT4x::addSingleMeasurementResult(void) {
     if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
-        // Make sure the heater is *not* going to run.  We want the ambient
-        // values.
-        sht4x_internal.setHeater(SHT4X_NO_HEATER);
-
-        // we need to create Adafruit "sensor events" to use the library
-        sensors_event_t temp_event;
-        sensors_event_t humidity_event;
-        ret_val = sht4x_internal.getEvent(&humidity_event, &temp_event);
-
-        // get the values from the sensor events
-        temp_val  = temp_event.temperature;
-        humid_val = humidity_event.relative_humidity;
-
-        if (!ret_val || isnan(temp_val)) temp_val = -9999;
-        if (!ret_val || isnan(humid_val)) humid_val = -9999;
+        ret_val = readMeasurement(temp_val, humid_val);
 
         MS_DBG(F("  Temp:"), temp_val, F("°C"));
         MS_DBG(F("  Humidity:"), humid_val, '%');
+        verifyAndAddMeasurementResult(SHT4X_TEMP_VAR_NUM, temp_val);
+        verifyAndAddMeasurementResult(SHT4X_HUMIDITY_VAR_NUM, humid_val);
+
+        // Read the rest of a batch back to back
+        for (uint8_t i = 1; i < _batchReadings; i++) {
+            if (!sendMeasurementCommand()) break;
+            delay(_measurementTime_ms);
+            bool success = readMeasurement(temp_val, humid_val);
+            MS_DBG(F("  Temp:"), temp_val, F("°C"));
+            MS_DBG(F("  Humidity:"), humid_val, '%');
+            verifyAndAddMeasurementResult(SHT4X_TEMP_VAR_NUM, temp_val);
+            verifyAndAddMeasurementResult(SHT4X_HUMIDITY_VAR_NUM, humid_val);
+            ret_val |= success;
+        }
     } else {
         MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
+        verifyAndAddMeasurementResult(SHT4X_TEMP_VAR_NUM, temp_val);
+        verifyAndAddMeasurementResult(SHT4X_HUMIDITY_VAR_NUM, humid_val);
     }
 
-    verifyAndAddMeasurementResult(SHT4X_TEMP_VAR_NUM, temp_val);
-    verifyAndAddMeasurementResult(SHT4X_HUMIDITY_VAR_NUM, humid_val);
-
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
     // Unset the status bits for a measurement request (bits 5 & 6)
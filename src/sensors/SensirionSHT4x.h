@@ -103,6 +103,10 @@
 /// measurement at the highest precision.  At medium precision measurement time
 /// is 4.5ms (max) and it is 1.7ms (max) at low precision.
 #define SHT4X_MEASUREMENT_TIME_MS 9
+/// @brief The measurement time at medium precision; 4.5ms (max).
+#define SHT4X_MED_MEASUREMENT_TIME_MS 5
+/// @brief The measurement time at low precision; 1.7ms (max).
+#define SHT4X_LOW_MEASUREMENT_TIME_MS 2
 /**@}*/
 
 /**
@@ -260,6 +264,34 @@ class SensirionSHT4x : public Sensor {
      */
     bool setup(void) override;
 
+    /**
+     * @brief Set the measurement precision, and the measurement time to match.
+     *
+     * @param precision The precision; one of `SHT4X_HIGH_PRECISION` (the
+     * default), `SHT4X_MED_PRECISION` or `SHT4X_LOW_PRECISION`.  Lower
+     * precision has more noise, but takes less time and power.
+     */
+    void setPrecision(sht4x_precision_t precision);
+    /**
+     * @brief Set whether all of the measurements to average are read back to
+     * back in a single call to addSingleMeasurementResult().
+     *
+     * The variable array then treats the sensor as taking only one
+     * measurement, instead of starting and collecting each of them in turn.
+     * Call this after setting the number of measurements to average.
+     *
+     * @param batched True to read all the measurements at once.  Default is
+     * false.
+     */
+    void setBatchedAveraging(bool batched);
+
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * This sends the measurement command, so the measurement runs while the
+     * measurement time passes.
+     */
+    bool startSingleMeasurement(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -278,6 +310,29 @@ class SensirionSHT4x : public Sensor {
      * @brief Internal variable for the heating setting
      */
     bool _useHeater;
+    /**
+     * @brief The measurement precision
+     */
+    sht4x_precision_t _precision = SHT4X_HIGH_PRECISION;
+    /**
+     * @brief The number of measurements read in each batch, or 0 if the
+     * measurements aren't batched
+     */
+    uint8_t _batchReadings = 0;
+    /**
+     * @brief Send the measurement command for the precision set.
+     *
+     * @return **bool** True if the sensor acknowledged the command
+     */
+    bool sendMeasurementCommand(void);
+    /**
+     * @brief Read a finished measurement and convert it.
+     *
+     * @param temp The temperature in °C
+     * @param humid The relative humidity in percent
+     * @return **bool** True if both values were read with a good CRC
+     */
+    bool readMeasurement(float& temp, float& humid);
     /**
      * @brief Internal reference the the Adafruit BME object
      */
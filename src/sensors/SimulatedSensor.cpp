@@ -0,0 +1,58 @@
+/**
+ * @file SimulatedSensor.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the SimulatedSensor class.
+ */
+
+#include "SimulatedSensor.h"
+
+
+// The constructor - there is no data pin
+SimulatedSensor::SimulatedSensor(uint32_t warmUpTime_ms,
+                                 uint32_t stabilizationTime_ms,
+                                 uint32_t measurementTime_ms, int8_t powerPin,
+                                 uint8_t measurementsToAverage)
+    : Sensor("SimulatedSensor", SIMULATED_NUM_VARIABLES, warmUpTime_ms,
+             stabilizationTime_ms, measurementTime_ms, powerPin, -1,
+             measurementsToAverage, SIMULATED_INC_CALC_VARIABLES) {}
+// Destructor
+SimulatedSensor::~SimulatedSensor() {}
+
+
+void SimulatedSensor::setValues(float startValue, float step) {
+    _startValue       = startValue;
+    _step             = step;
+    _measurementCount = 0;
+}
+void SimulatedSensor::setFailEvery(uint8_t failEvery) {
+    _failEvery = failEvery;
+}
+
+
+bool SimulatedSensor::addSingleMeasurementResult(void) {
+    float value = -9999;
+
+    // Check a measurement was *successfully* started (status bit 6 set)
+    // Only go on to get a result if it was
+    if (bitRead(_sensorStatus, 6)) {
+        _measurementCount++;
+        if (_failEvery == 0 || _measurementCount % _failEvery != 0) {
+            value = _startValue + _step * (_measurementCount - 1);
+        }
+        MS_DBG(getSensorNameAndLocation(), F("is reporting:"), value);
+    } else {
+        MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
+    }
+
+    verifyAndAddMeasurementResult(SIMULATED_VALUE_VAR_NUM, value);
+
+    // Unset the time stamp for the beginning of this measurement
+    _millisMeasurementRequested = 0;
+    // Unset the status bits for a measurement request (bits 5 & 6)
+    _sensorStatus &= 0b10011111;
+
+    return true;
+}
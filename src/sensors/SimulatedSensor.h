@@ -0,0 +1,215 @@
+/**
+ * @file SimulatedSensor.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the SimulatedSensor sensor subclass and the variable
+ * subclass SimulatedSensor_Value.
+ *
+ * These are for a sensor that takes the time of a real one but needs nothing
+ * attached, for timing and testing a logger on the bench.
+ */
+/* clang-format off */
+/**
+ * @defgroup sensor_simulated Simulated Sensor
+ * Classes for a simulated sensor, with no hardware.
+ *
+ * @ingroup the_sensors
+ *
+ * @tableofcontents
+ * @m_footernavigation
+ *
+ * @section sensor_simulated_notes Quick Notes
+ * - Needs nothing attached to the board
+ * - The warm-up, stabilization and measurement times are set in the
+ * constructor, so it can stand in for any real sensor
+ * - Each measurement gives the next value of a straight line, so the
+ * averaging can be checked from the logged values
+ * - A failed measurement can be given every so many measurements
+ *
+ * The simulated sensor goes through the same steps as any other sensor, with
+ * its power pin switched if one is given, so a logger with a few of them
+ * times its update cycles, writes its files and publishes its data the way a
+ * station in the field would.  This lets changes to the update cycle, the
+ * files or the publishers be timed on a bare board, without the 300 stations'
+ * worth of sensors.
+ *
+ * @section sensor_simulated_ctor Sensor Constructor
+ * {{ @ref SimulatedSensor::SimulatedSensor }}
+ *
+ * @section sensor_simulated_examples Example Code
+ *
+ * The simulated sensor is used in the @menulink{simulated_sensor} example
+ *
+ * @menusnip{simulated_sensor}
+ */
+/* clang-format on */
+
+// Header Guards
+#ifndef SRC_SENSORS_SIMULATEDSENSOR_H_
+#define SRC_SENSORS_SIMULATEDSENSOR_H_
+
+// Debugging Statement
+// #define MS_SIMULATEDSENSOR_DEBUG
+
+#ifdef MS_SIMULATEDSENSOR_DEBUG
+#define MS_DEBUGGING_STD "SimulatedSensor"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "VariableBase.h"
+#include "SensorBase.h"
+
+/** @ingroup sensor_simulated */
+/**@{*/
+
+// Sensor Specific Defines
+/// @brief Sensor::_numReturnedValues; the simulated sensor gives 1 value.
+#define SIMULATED_NUM_VARIABLES 1
+/// @brief Sensor::_incCalcValues; the simulated sensor has no calculated
+/// values.
+#define SIMULATED_INC_CALC_VARIABLES 0
+
+/**
+ * @anchor sensor_simulated_value
+ * @name Value
+ * The value variable from a simulated sensor
+ * - The first measurement gives the start value and each one after that adds
+ * the step to it, failed or not
+ *
+ * {{ @ref SimulatedSensor_Value::SimulatedSensor_Value }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the value should have 3.
+#define SIMULATED_VALUE_RESOLUTION 3
+/// @brief Sensor variable number; the value is stored in sensorValues[0].
+#define SIMULATED_VALUE_VAR_NUM 0
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "sequenceNumber"
+#define SIMULATED_VALUE_VAR_NAME "sequenceNumber"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "dimensionless"
+#define SIMULATED_VALUE_UNIT_NAME "dimensionless"
+/// @brief Default variable short code; "SimulatedValue"
+#define SIMULATED_VALUE_DEFAULT_CODE "SimulatedValue"
+/**@}*/
+
+
+/* clang-format off */
+/**
+ * @brief The Sensor sub-class for a [simulated sensor](@ref sensor_simulated).
+ */
+/* clang-format on */
+class SimulatedSensor : public Sensor {
+ public:
+    /**
+     * @brief Construct a new SimulatedSensor object.
+     *
+     * @param warmUpTime_ms @copydoc Sensor::_warmUpTime_ms
+     * @param stabilizationTime_ms @copydoc Sensor::_stabilizationTime_ms
+     * @param measurementTime_ms @copydoc Sensor::_measurementTime_ms
+     * @param powerPin The pin on the mcu to switch as if it powered the
+     * sensor.  Use -1 to switch none.
+     * @param measurementsToAverage The number of measurements to take and
+     * average before giving a "final" result from the sensor; optional with a
+     * default value of 1.
+     */
+    SimulatedSensor(uint32_t warmUpTime_ms, uint32_t stabilizationTime_ms,
+                    uint32_t measurementTime_ms, int8_t powerPin = -1,
+                    uint8_t measurementsToAverage = 1);
+    /**
+     * @brief Destroy the SimulatedSensor object - no action needed.
+     */
+    ~SimulatedSensor();
+
+    /**
+     * @brief Set the values the measurements give.
+     *
+     * This starts the line over from the next measurement.
+     *
+     * @param startValue The value of the next measurement
+     * @param step The amount added to the value by each measurement
+     */
+    void setValues(float startValue, float step = 1);
+    /**
+     * @brief Give a failed measurement, of -9999, every so many measurements.
+     *
+     * @param failEvery The number of measurements to each failed one; 0 for
+     * none to fail.
+     */
+    void setFailEvery(uint8_t failEvery);
+
+    /**
+     * @copydoc Sensor::addSingleMeasurementResult()
+     */
+    bool addSingleMeasurementResult(void) override;
+
+ private:
+    /**
+     * @brief The value of the first measurement
+     */
+    float _startValue = 0;
+    /**
+     * @brief The amount added by each measurement
+     */
+    float _step = 1;
+    /**
+     * @brief The number of measurements to each failed one
+     */
+    uint8_t _failEvery = 0;
+    /**
+     * @brief The number of measurements since the values were set
+     */
+    uint16_t _measurementCount = 0;
+};
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [value output](@ref sensor_simulated_value) from a
+ * [simulated sensor](@ref sensor_simulated).
+ */
+/* clang-format on */
+class SimulatedSensor_Value : public Variable {
+ public:
+    /**
+     * @brief Construct a new SimulatedSensor_Value object.
+     *
+     * @param parentSense The parent SimulatedSensor providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "SimulatedValue".
+     */
+    explicit SimulatedSensor_Value(
+        SimulatedSensor* parentSense, const char* uuid = "",
+        const char* varCode = SIMULATED_VALUE_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)SIMULATED_VALUE_VAR_NUM,
+                   (uint8_t)SIMULATED_VALUE_RESOLUTION,
+                   SIMULATED_VALUE_VAR_NAME, SIMULATED_VALUE_UNIT_NAME,
+                   varCode, uuid) {}
+    /**
+     * @brief Construct a new SimulatedSensor_Value object.
+     *
+     * @note This must be tied with a parent SimulatedSensor before it can be
+     * used.
+     */
+    SimulatedSensor_Value()
+        : Variable((const uint8_t)SIMULATED_VALUE_VAR_NUM,
+                   (uint8_t)SIMULATED_VALUE_RESOLUTION,
+                   SIMULATED_VALUE_VAR_NAME, SIMULATED_VALUE_UNIT_NAME,
+                   SIMULATED_VALUE_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the SimulatedSensor_Value object - no action needed.
+     */
+    ~SimulatedSensor_Value() {}
+};
+/**@}*/
+#endif  // SRC_SENSORS_SIMULATEDSENSOR_H_
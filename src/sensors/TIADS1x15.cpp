@@ -28,6 +28,14 @@ TIADS1x15::TIADS1x15(int8_t powerPin, uint8_t adsChannel, float gain,
 TIADS1x15::~TIADS1x15() {}
 
 
+// Reads through a shared ADC, registering our channel for its scans
+void TIADS1x15::setADC(TIADS1x15Bus& adc) {
+    _adsBus     = &adc;
+    _i2cAddress = adc.getI2CAddress();
+    adc.registerChannel(_adsChannel);
+}
+
+
 String TIADS1x15::getSensorLocation(void) {
 #ifndef MS_USE_ADS1015
     String sensorLocation = F("ADS1115_0x");
@@ -51,37 +59,46 @@ bool TIADS1x15::addSingleMeasurementResult(void) {
     if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
+        if (_adsBus != nullptr) {
+            // The shared ADC is already set up, and may have converted this
+            // channel in a scan for another sensor
+            adcVoltage = _adsBus->readVoltage(_adsChannel);
+            MS_DBG(F("  Shared ADS channel"), _adsChannel, F(":"), adcVoltage);
+        } else {
 // Create an Auxillary ADD object
 // We create and set up the ADC object here so that each sensor using
 // the ADC may set the gain appropriately without effecting others.
 #ifndef MS_USE_ADS1015
-        Adafruit_ADS1115 ads(_i2cAddress);  // Use this for the 16-bit version
+            // Use this for the 16-bit version
+            Adafruit_ADS1115 ads(_i2cAddress);
 #else
-        Adafruit_ADS1015 ads(_i2cAddress);  // Use this for the 12-bit version
+            // Use this for the 12-bit version
+            Adafruit_ADS1015 ads(_i2cAddress);
 #endif
-        // ADS Library default settings:
-        //  - TI1115 (16 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 128 samples per second (8ms conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-        //  - TI1015 (12 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 1600 samples per second (625µs conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-
-        // Bump the gain up to 1x = +/- 4.096V range
-        ads.setGain(GAIN_ONE);
-        // Begin ADC
-        ads.begin();
-
-        // Read Analog to Digital Converter (ADC)
-        // Taking this reading includes the 8ms conversion delay.
-        // We're allowing the ADS1115 library to do the bit-to-volts conversion
-        // for us
-        adcVoltage =
-            ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
-        MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
-               adcVoltage);
+            // ADS Library default settings:
+            //  - TI1115 (16 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 128 samples per second (8ms conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+            //  - TI1015 (12 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 1600 samples per second (625µs conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+
+            // Bump the gain up to 1x = +/- 4.096V range
+            ads.setGain(GAIN_ONE);
+            // Begin ADC
+            ads.begin();
+
+            // Read Analog to Digital Converter (ADC)
+            // Taking this reading includes the 8ms conversion delay.
+            // We're allowing the ADS1115 library to do the bit-to-volts
+            // conversion for us
+            adcVoltage =
+                ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
+            MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
+                   adcVoltage);
+        }
 
         if (adcVoltage < 3.6 && adcVoltage > -0.3) {
             // Skip results out of range
@@ -0,0 +1,236 @@
+/**
+ * @file TIADS1x15Bus.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the TIADS1x15Bus class.
+ */
+
+#include "TIADS1x15Bus.h"
+
+// The ADS registers
+#define ADS1X15_REG_CONVERSION 0x00
+#define ADS1X15_REG_CONFIG 0x01
+#define ADS1X15_REG_LO_THRESH 0x02
+#define ADS1X15_REG_HI_THRESH 0x03
+// Configuration bits: start a single-shot conversion
+#define ADS1X15_CONFIG_START 0x8000
+#define ADS1X15_CONFIG_SINGLE_SHOT 0x0100
+#define ADS1X15_CONFIG_COMP_QUE_OFF 0x0003
+// The PGA settings auto-ranging picks from; wider than ±4.096V is beyond VDD
+#define ADS1X15_PGA_4_096V 1
+#define ADS1X15_PGA_0_256V 5
+// Both chips left-justify the result, so anything from here is clipped
+#define ADS1X15_CLIP_RAW 0x7FF0
+
+// The full scale voltage of each PGA setting
+static const float ads1x15FullScale[6] = {6.144, 4.096, 2.048,
+                                          1.024, 0.512, 0.256};
+
+// The samples per second of each data rate code
+#ifndef MS_USE_ADS1015
+static const uint16_t ads1x15DataRates[8] = {8,   16,  32,  64,
+                                             128, 250, 475, 860};
+#define ADS1X15_DEFAULT_RATE_BITS 4  // 128 SPS
+#else
+static const uint16_t ads1x15DataRates[8] = {128,  250,  490,  920,
+                                             1600, 2400, 3300, 3300};
+#define ADS1X15_DEFAULT_RATE_BITS 4  // 1600 SPS
+#endif
+
+
+// The constructor
+TIADS1x15Bus::TIADS1x15Bus(uint8_t i2cAddress, int8_t alertPin)
+    : _i2cAddress(i2cAddress),
+      _alertPin(alertPin) {
+    setDataRate(ads1x15DataRates[ADS1X15_DEFAULT_RATE_BITS]);
+}
+// Destructor
+TIADS1x15Bus::~TIADS1x15Bus() {}
+
+
+// Picks the slowest supported rate at or above the one asked for
+void TIADS1x15Bus::setDataRate(uint16_t samplesPerSecond) {
+    uint8_t bits = 0;
+    while (bits < 7 && ads1x15DataRates[bits] < samplesPerSecond) bits++;
+    _dataRateBits = bits;
+    // The internal oscillator is within 10% of the nominal rate
+    _conversionTime_us = 1100000UL / ads1x15DataRates[bits] + 100;
+    MS_DBG(F("ADS1x15 at 0x"), String(_i2cAddress, HEX), F("converting at"),
+           ads1x15DataRates[bits], F("samples per second"));
+}
+
+
+void TIADS1x15Bus::registerChannel(uint8_t channel) {
+    if (channel < 4) _channelMask |= (1 << channel);
+}
+
+
+void TIADS1x15Bus::setGain(uint8_t channel, uint8_t pgaBits) {
+    if (channel > 3 || pgaBits > ADS1X15_PGA_0_256V) return;
+    _pgaBits[channel] = pgaBits;
+    _autoRangeMask &= ~(1 << channel);
+}
+
+
+void TIADS1x15Bus::setAutoRange(uint8_t channel, bool autoRange) {
+    if (channel > 3) return;
+    if (autoRange) {
+        _autoRangeMask |= (1 << channel);
+        _pgaBits[channel] = ADS1X15_PGA_4_096V;
+    } else {
+        _autoRangeMask &= ~(1 << channel);
+    }
+}
+
+
+// Writes a register, most significant byte first
+bool TIADS1x15Bus::writeRegister(uint8_t reg, uint16_t value) {
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(reg);
+    Wire.write(static_cast<uint8_t>(value >> 8));
+    Wire.write(static_cast<uint8_t>(value & 0xFF));
+    return Wire.endTransmission() == 0;
+}
+
+
+// Reads a register, most significant byte first
+bool TIADS1x15Bus::readRegister(uint8_t reg, uint16_t& value) {
+    Wire.beginTransmission(_i2cAddress);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0) return false;
+    if (Wire.requestFrom(static_cast<int>(_i2cAddress), 2) != 2) return false;
+    value = static_cast<uint16_t>(Wire.read()) << 8;
+    value |= Wire.read();
+    return true;
+}
+
+
+// Sets the thresholds so the ALERT/RDY pin goes low when a conversion is done
+bool TIADS1x15Bus::configure(void) {
+    Wire.begin();
+    if (_alertPin >= 0) {
+        pinMode(_alertPin, INPUT_PULLUP);
+        // A high threshold MSB of 1 and low threshold MSB of 0 turn the
+        // comparator into a conversion-ready signal
+        _configured = writeRegister(ADS1X15_REG_HI_THRESH, 0x8000) &&
+            writeRegister(ADS1X15_REG_LO_THRESH, 0x0000);
+    } else {
+        uint16_t config;
+        _configured = readRegister(ADS1X15_REG_CONFIG, config);
+    }
+    if (!_configured) {
+        MS_DBG(F("ADS1x15 at 0x"), String(_i2cAddress, HEX),
+               F("did not respond"));
+    }
+    return _configured;
+}
+
+
+// Runs one single-shot conversion and waits only as long as it takes
+bool TIADS1x15Bus::convertRaw(uint8_t channel, uint8_t pgaBits, int16_t& raw) {
+    if (!_configured && !configure()) return false;
+
+    uint16_t config = ADS1X15_CONFIG_START | ((0x04 | channel) << 12) |
+        (pgaBits << 9) | ADS1X15_CONFIG_SINGLE_SHOT | (_dataRateBits << 5);
+    if (_alertPin < 0) config |= ADS1X15_CONFIG_COMP_QUE_OFF;
+    if (!writeRegister(ADS1X15_REG_CONFIG, config)) {
+        // Configure again next time, in case the ADS lost power
+        _configured = false;
+        return false;
+    }
+
+    uint32_t start = micros();
+    bool     done  = false;
+    if (_alertPin >= 0) {
+        while (!done && micros() - start < 2 * _conversionTime_us) {
+            done = (digitalRead(_alertPin) == LOW);
+        }
+    } else {
+        // Nothing to gain from checking the I2C bus before the nominal time
+        delay(_conversionTime_us / 1000);
+        delayMicroseconds(_conversionTime_us % 1000);
+    }
+    // The start bit reads as 1 once the conversion is finished
+    while (!done && micros() - start < 2 * _conversionTime_us) {
+        uint16_t status;
+        if (!readRegister(ADS1X15_REG_CONFIG, status)) return false;
+        done = (status & ADS1X15_CONFIG_START) != 0;
+    }
+    if (!done) {
+        MS_DBG(F("ADS1x15 channel"), channel, F("conversion timed out"));
+        return false;
+    }
+
+    uint16_t value;
+    if (!readRegister(ADS1X15_REG_CONVERSION, value)) return false;
+    raw = static_cast<int16_t>(value);
+    return true;
+}
+
+
+// Converts a channel at its range, re-reading once wider if an auto-ranged
+// channel clips, and picks the range for the next reading from the result
+bool TIADS1x15Bus::convertChannel(uint8_t channel, float& volts) {
+    volts = -9999;
+
+    bool    autoRange = _autoRangeMask & (1 << channel);
+    uint8_t pgaBits   = _pgaBits[channel];
+    int16_t raw;
+    if (!convertRaw(channel, pgaBits, raw)) return false;
+    if (autoRange && pgaBits > ADS1X15_PGA_4_096V &&
+        (raw >= ADS1X15_CLIP_RAW || raw <= -ADS1X15_CLIP_RAW)) {
+        MS_DBG(F("ADS1x15 channel"), channel, F("clipped at ±"),
+               ads1x15FullScale[pgaBits], F("V; reading again"));
+        pgaBits--;
+        if (!convertRaw(channel, pgaBits, raw)) return false;
+    }
+    // 1 LSB of the 16-bit register is the full scale over 32768
+    volts = raw * (ads1x15FullScale[pgaBits] / 32768.0);
+
+    if (autoRange) {
+        float needed = fabs(volts) * TIADS1X15_AUTORANGE_HEADROOM;
+        pgaBits      = ADS1X15_PGA_0_256V;
+        while (pgaBits > ADS1X15_PGA_4_096V &&
+               ads1x15FullScale[pgaBits] < needed) {
+            pgaBits--;
+        }
+        if (pgaBits != _pgaBits[channel]) {
+            MS_DBG(F("ADS1x15 channel"), channel, F("range now ±"),
+                   ads1x15FullScale[pgaBits], F("V"));
+        }
+    }
+    _pgaBits[channel] = pgaBits;
+    return true;
+}
+
+
+// Converts every registered channel back to back
+uint8_t TIADS1x15Bus::scanChannels(void) {
+    uint8_t nConverted = 0;
+    _unreadMask        = 0;
+    MS_START_DEBUG_TIMER;
+    for (uint8_t channel = 0; channel < 4; channel++) {
+        if (!(_channelMask & (1 << channel))) continue;
+        if (convertChannel(channel, _volts[channel])) nConverted++;
+        _unreadMask |= (1 << channel);
+    }
+    _scanTime = millis();
+    MS_DBG(F("Scanned"), nConverted, F("ADS1x15 channels in"),
+           MS_PRINT_DEBUG_TIMER, F("ms"));
+    return nConverted;
+}
+
+
+// Returns the value from the last scan, if it's recent and unread
+float TIADS1x15Bus::readVoltage(uint8_t channel) {
+    if (channel > 3) return -9999;
+    registerChannel(channel);
+    if (!(_unreadMask & (1 << channel)) ||
+        millis() - _scanTime > TIADS1X15_SCAN_MAX_AGE_MS) {
+        scanChannels();
+    }
+    _unreadMask &= ~(1 << channel);
+    return _volts[channel];
+}
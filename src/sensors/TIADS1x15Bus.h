@@ -0,0 +1,228 @@
+/**
+ * @file TIADS1x15Bus.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the TIADS1x15Bus class, a single TI ADS1115 or ADS1015
+ * shared by all of the analog sensors attached to its channels.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_TIADS1X15BUS_H_
+#define SRC_SENSORS_TIADS1X15BUS_H_
+
+// Debugging Statement
+// #define MS_TIADS1X15BUS_DEBUG
+
+#ifdef MS_TIADS1X15BUS_DEBUG
+#define MS_DEBUGGING_STD "TIADS1x15Bus"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include <Arduino.h>
+#include <Wire.h>
+
+/** @ingroup sensor_ads1x15 */
+/**@{*/
+
+#ifndef ADS1115_ADDRESS
+/// @brief The assumed address of the ADS1115, 1001 000 (ADDR = GND)
+#define ADS1115_ADDRESS 0x48
+#endif
+
+#ifndef TIADS1X15_AUTORANGE_HEADROOM
+/**
+ * @brief How much larger than the last reading of an auto-ranged channel the
+ * full scale of the range picked for the next reading must be.
+ *
+ * This leaves room for the signal to rise between readings without clipping.
+ */
+#define TIADS1X15_AUTORANGE_HEADROOM 1.25
+#endif
+
+#ifndef TIADS1X15_SCAN_MAX_AGE_MS
+/**
+ * @brief The longest a scanned channel value is kept for a sensor that has not
+ * read it yet, in milliseconds.
+ */
+#define TIADS1X15_SCAN_MAX_AGE_MS 100
+#endif
+
+/**
+ * @brief A TI ADS1115 or ADS1015 shared by the sensors on its channels.
+ *
+ * Without a shared ADC, each sensor creates and configures its own ADS object
+ * on every reading and waits out the library's fixed conversion delay.  The
+ * shared ADC is configured once, reads each channel at a selectable data rate,
+ * and waits on the ALERT/RDY pin, if it is wired, or on the conversion-done
+ * bit of the configuration register.
+ *
+ * Sensors attached with their `setADC()` functions register their channels.
+ * When one of them asks for a reading, every registered channel is converted
+ * back to back, and the other sensors take their values from that scan if they
+ * ask within #TIADS1X15_SCAN_MAX_AGE_MS.
+ *
+ * All conversions are single-ended.  By default each channel uses the ±4.096V
+ * range (1x gain), the same as the sensors use on their own ADS objects.  A
+ * channel can instead be given a fixed gain with setGain(), or be auto-ranged
+ * with setAutoRange().
+ *
+ * @note Only the primary hardware I2C instance is supported.
+ */
+class TIADS1x15Bus {
+ public:
+    /**
+     * @brief Construct a new shared ADS1x15 object
+     *
+     * @param i2cAddress The I2C address of the ADS 1x15, default is 0x48 (ADDR
+     * = GND)
+     * @param alertPin The pin on the mcu attached to the ALERT/RDY pin of the
+     * ADS, or -1 if it is not wired.  The pin is open-drain and needs a
+     * pull-up.
+     */
+    explicit TIADS1x15Bus(uint8_t i2cAddress = ADS1115_ADDRESS,
+                          int8_t  alertPin   = -1);
+    /**
+     * @brief Destroy the shared ADS1x15 object
+     */
+    ~TIADS1x15Bus();
+
+    /**
+     * @brief Get the I2C address of the ADS.
+     *
+     * @return **uint8_t** The I2C address
+     */
+    uint8_t getI2CAddress(void) {
+        return _i2cAddress;
+    }
+    /**
+     * @brief Set the data rate of the conversions.
+     *
+     * The nearest rate the chip supports at or above the one given is used.
+     * The ADS1115 supports 8, 16, 32, 64, 128, 250, 475 and 860 samples per
+     * second; the ADS1015 128, 250, 490, 920, 1600, 2400 and 3300.  Faster
+     * rates are noisier.
+     *
+     * @param samplesPerSecond The data rate.  Default is 128 for the ADS1115
+     * and 1600 for the ADS1015, the same as the ADS library.
+     */
+    void setDataRate(uint16_t samplesPerSecond);
+    /**
+     * @brief Add a channel to the ones converted in each scan.
+     *
+     * @param channel The single-ended channel, 0-3
+     */
+    void registerChannel(uint8_t channel);
+    /**
+     * @brief Set a fixed gain for a channel, and stop auto-ranging it.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @param pgaBits The PGA setting of the config register: 0 for ±6.144V,
+     * 1 for ±4.096V, 2 for ±2.048V, 3 for ±1.024V, 4 for ±0.512V, or 5 for
+     * ±0.256V.  Default is 1.
+     */
+    void setGain(uint8_t channel, uint8_t pgaBits);
+    /**
+     * @brief Set whether a channel is auto-ranged.
+     *
+     * An auto-ranged channel is converted with the narrowest range that holds
+     * its last reading with #TIADS1X15_AUTORANGE_HEADROOM to spare, from
+     * ±4.096V down to ±0.256V.  If the reading clips, it is converted once
+     * more at the next wider range.  Small signals then get up to 16 times
+     * the resolution of the 1x gain, without averaging more readings.
+     *
+     * The first reading uses the ±4.096V range.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @param autoRange True to auto-range the channel
+     */
+    void setAutoRange(uint8_t channel, bool autoRange);
+    /**
+     * @brief Get the PGA setting the channel was last converted with.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @return **uint8_t** The PGA setting of the config register; see
+     * setGain()
+     */
+    uint8_t getGain(uint8_t channel) {
+        return channel < 4 ? _pgaBits[channel] : 0;
+    }
+    /**
+     * @brief Get the voltage on a channel.
+     *
+     * If the channel was converted in a scan less than
+     * #TIADS1X15_SCAN_MAX_AGE_MS ago and its value hasn't been read, that value
+     * is returned.  Otherwise every registered channel is scanned again.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @return **float** The voltage, or -9999 if the conversion failed
+     */
+    float readVoltage(uint8_t channel);
+    /**
+     * @brief Convert each of the registered channels back to back.
+     *
+     * @return **uint8_t** The number of channels successfully converted
+     */
+    uint8_t scanChannels(void);
+
+ protected:
+    /**
+     * @brief Set up the comparator thresholds for the ALERT/RDY pin to signal
+     * the end of each conversion.  This is only needed once after power-up.
+     *
+     * @return **bool** True if the ADS answered
+     */
+    bool configure(void);
+    /**
+     * @brief Run a single-shot conversion of one channel.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @param volts The voltage read
+     * @return **bool** True if the conversion finished and was read
+     */
+    bool convertChannel(uint8_t channel, float& volts);
+    /**
+     * @brief Run a single-shot conversion of one channel at one range.
+     *
+     * @param channel The single-ended channel, 0-3
+     * @param pgaBits The PGA setting of the config register
+     * @param raw The raw conversion result
+     * @return **bool** True if the conversion finished and was read
+     */
+    bool convertRaw(uint8_t channel, uint8_t pgaBits, int16_t& raw);
+    /**
+     * @brief Write a 16-bit ADS register.
+     *
+     * @param reg The register pointer
+     * @param value The value to write
+     * @return **bool** True if the ADS acknowledged the write
+     */
+    bool writeRegister(uint8_t reg, uint16_t value);
+    /**
+     * @brief Read a 16-bit ADS register.
+     *
+     * @param reg The register pointer
+     * @param value The value read
+     * @return **bool** True if both bytes were read
+     */
+    bool readRegister(uint8_t reg, uint16_t& value);
+
+ private:
+    uint8_t  _i2cAddress;
+    int8_t   _alertPin;
+    bool     _configured = false;
+    uint16_t _dataRateBits;
+    uint16_t _conversionTime_us;
+    // The registered channels, and the scanned ones not yet read
+    uint8_t  _channelMask   = 0;
+    uint8_t  _unreadMask    = 0;
+    uint8_t  _autoRangeMask = 0;
+    uint32_t _scanTime      = 0;
+    float    _volts[4]      = {-9999, -9999, -9999, -9999};
+    uint8_t  _pgaBits[4]    = {1, 1, 1, 1};
+};
+/**@}*/
+#endif  // SRC_SENSORS_TIADS1X15BUS_H_
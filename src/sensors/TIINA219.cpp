@@ -16,6 +16,7 @@ TIINA219::TIINA219(TwoWire* theI2C, int8_t powerPin, uint8_t i2cAddressHex,
     : Sensor("TIINA219", INA219_NUM_VARIABLES, INA219_WARM_UP_TIME_MS,
              INA219_STABILIZATION_TIME_MS, INA219_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage),
+      ina219_phy(i2cAddressHex),
       _i2cAddressHex(i2cAddressHex),
       _i2c(theI2C) {}
 TIINA219::TIINA219(int8_t powerPin, uint8_t i2cAddressHex,
@@ -23,6 +24,7 @@ TIINA219::TIINA219(int8_t powerPin, uint8_t i2cAddressHex,
     : Sensor("TIINA219", INA219_NUM_VARIABLES, INA219_WARM_UP_TIME_MS,
              INA219_STABILIZATION_TIME_MS, INA219_MEASUREMENT_TIME_MS, powerPin,
              -1, measurementsToAverage, INA219_INC_CALC_VARIABLES),
+      ina219_phy(i2cAddressHex),
       _i2cAddressHex(i2cAddressHex),
       _i2c(&Wire) {}
 // Destructor
@@ -69,6 +71,58 @@ bool TIINA219::wake(void) {
 }
 
 
+// The ADC setting is the same four bits for the shunt and the bus
+void TIINA219::setADC(uint8_t resolutionBits, uint8_t samplesToAverage) {
+    uint16_t adcCode;
+    uint32_t conversion_us;
+    if (samplesToAverage > 1) {
+        // Averaging is 0b1nnn, for 2^nnn samples of 532us
+        uint8_t n = 1;
+        while (n < 7 && (1 << n) < samplesToAverage) n++;
+        adcCode       = 0b1000 | n;
+        conversion_us = 532UL << n;
+    } else {
+        static const uint16_t single_us[4] = {84, 148, 276, 532};
+        if (resolutionBits < 9 || resolutionBits > 12) resolutionBits = 12;
+        adcCode       = resolutionBits - 9;
+        conversion_us = single_us[adcCode];
+    }
+    _adcConfig = INA219_CONFIG_RANGES | (adcCode << 7) | (adcCode << 3) |
+        INA219_CONFIG_MODE_TRIGGERED;
+    // A shunt and a bus conversion, with 10% for the clock tolerance
+    _measurementTime_ms = (conversion_us * 2 * 11 / 10) / 1000 + 1;
+    MS_DBG(getSensorNameAndLocation(), F("configured to 0x"),
+           String(_adcConfig, HEX), F("taking"), _measurementTime_ms,
+           F("ms per measurement"));
+}
+
+
+bool TIINA219::startSingleMeasurement(void) {
+    // Sensor::startSingleMeasurement() checks that if it's awake/active and
+    // sets the timestamp and status bits.  If it returns false, there's no
+    // reason to go on.
+    if (!Sensor::startSingleMeasurement()) return false;
+    if (_adcConfig == 0) return true;
+
+    // Writing the configuration in a triggered mode starts a conversion
+    _i2c->beginTransmission(_i2cAddressHex);
+    _i2c->write(0x00);  // The configuration register
+    _i2c->write(static_cast<uint8_t>(_adcConfig >> 8));
+    _i2c->write(static_cast<uint8_t>(_adcConfig & 0xFF));
+    if (_i2c->endTransmission() == 0) {
+        _millisMeasurementRequested = millis();
+        return true;
+    }
+    // Otherwise, make sure that the measurement start time and success bit
+    // (bit 6) are unset
+    MS_DBG(getSensorNameAndLocation(),
+           F("did not successfully start a measurement."));
+    _millisMeasurementRequested = 0;
+    _sensorStatus &= 0b10111111;
+    return false;
+}
+
+
 bool TIINA219::addSingleMeasurementResult(void) {
     bool success = false;
 
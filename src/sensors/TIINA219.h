@@ -110,6 +110,18 @@
 #define INA219_MEASUREMENT_TIME_MS 1100
 /**@}*/
 
+/**
+ * @brief The settings of the INA219 configuration register (0x00) that this
+ * library doesn't change: the 32V bus range and the ±320mV shunt range set up
+ * by the Adafruit library's default calibration.
+ */
+#define INA219_CONFIG_RANGES 0x3800
+/**
+ * @brief The mode bits of the INA219 configuration register for one
+ * triggered conversion of both the shunt and bus voltages.
+ */
+#define INA219_CONFIG_MODE_TRIGGERED 0x0003
+
 /**
  * @anchor sensor_ina219_current
  * @name Current
@@ -275,12 +287,44 @@ class TIINA219 : public Sensor {
      */
     String getSensorLocation(void) override;
 
+    /**
+     * @brief Set the resolution and on-chip averaging of the INA219's ADC
+     * conversions, for both the shunt and the bus voltages.
+     *
+     * Once this is called, each measurement is a single triggered conversion
+     * of the shunt and bus voltages, averaged in the INA219, and the
+     * measurement time is set to the time it takes: about 1.1ms for one 12
+     * bit sample of each, up to about 150ms for 128 samples of each.  This
+     * is much faster than averaging the same number of samples with the
+     * measurementsToAverage of the constructor.  Until this is called, the
+     * INA219 converts continuously at 12 bits with no averaging and the
+     * measurement time is #INA219_MEASUREMENT_TIME_MS.
+     *
+     * @param resolutionBits The resolution of a single sample; 9, 10, 11, or
+     * 12 bits.  Averaging is only available at 12 bits.
+     * @param samplesToAverage The number of 12 bit samples the INA219 averages
+     * into each result; 1, 2, 4, 8, 16, 32, 64, or 128.
+     */
+    void setADC(uint8_t resolutionBits = 12, uint8_t samplesToAverage = 1);
+
+    /**
+     * @brief Start a triggered conversion, if the ADC has been set with
+     * setADC().
+     *
+     * @return **bool** True if the measurement was started.
+     */
+    bool startSingleMeasurement(void) override;
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
     bool addSingleMeasurementResult(void) override;
 
  private:
+    /**
+     * @brief The configuration register for the ADC settings; 0 to leave the
+     * Adafruit library's continuous conversions.
+     */
+    uint16_t _adcConfig = 0;
     /**
      * @brief Private reference to the internal INA219 object.
      */
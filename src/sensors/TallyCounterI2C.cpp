@@ -70,6 +70,8 @@ bool TallyCounterI2C::addSingleMeasurementResult(void) {
 
     // Initialize variables
     int16_t events = -9999;  // Number of events
+    int16_t peak1  = -9999;  // Most events in one minute
+    int16_t peak5  = -9999;  // Most events in five minutes
 
     // Check a measurement was *successfully* started (status bit 6 set)
     // Only go on to get a result if it was
@@ -99,11 +101,28 @@ bool TallyCounterI2C::addSingleMeasurementResult(void) {
 
         MS_DBG(F("  Events:"), events);
 
+        if (_tipLogging && success) {
+            uint16_t ages[TIP_LOG_MAX_TIPS];
+            int16_t  nTips = readTipLog(&Wire, _i2cAddressHex, ages,
+                                        TIP_LOG_MAX_TIPS);
+            if (nTips >= 0) {
+                peak1 = peakTipsInWindow(ages, nTips, 60);
+                peak5 = peakTipsInWindow(ages, nTips, 300);
+                MS_DBG(F("  Logged events:"), nTips);
+                MS_DBG(F("  Peak 1-minute events:"), peak1);
+                MS_DBG(F("  Peak 5-minute events:"), peak5);
+            } else {
+                MS_DBG(F("  No event log from"), getSensorNameAndLocation());
+            }
+        }
+
     } else {
         MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
     }
 
     verifyAndAddMeasurementResult(TALLY_EVENTS_VAR_NUM, events);
+    verifyAndAddMeasurementResult(TALLY_PEAK1_VAR_NUM, peak1);
+    verifyAndAddMeasurementResult(TALLY_PEAK5_VAR_NUM, peak5);
 
     // Unset the time stamp for the beginning of this measurement
     _millisMeasurementRequested = 0;
@@ -57,6 +57,12 @@
  * - https://github.com/EnviroDIY/Project-Tally​
  * - https://github.com/EnviroDIY/Tally_Library/tree/Dev_I2C
  *
+ * @section sensor_tally_peaks Peak Counts
+ * A Tally whose firmware also keeps a log of event times can report the most
+ * events within any one and any five minutes of each logging interval.  Call
+ * TallyCounterI2C::setTipLogging() to read the log after each count; the
+ * protocol is described in TipTimestampLog.h.
+ *
  * @section sensor_tally_ctor Sensor Constructor
  * {{ @ref TallyCounterI2C::TallyCounterI2C }}
  *
@@ -82,6 +88,7 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "TipTimestampLog.h"
 #include <Tally_I2C.h>
 
 
@@ -89,10 +96,11 @@
 /**@{*/
 
 // Sensor Specific Defines
-/// @brief Sensor::_numReturnedValues; the Tally can report 1 value.
-#define TALLY_NUM_VARIABLES 1
-/// @brief Sensor::_incCalcValues; we don't calculate any additional values.
-#define TALLY_INC_CALC_VARIABLES 0
+/// @brief Sensor::_numReturnedValues; the Tally can report 3 values.
+#define TALLY_NUM_VARIABLES 3
+/// @brief Sensor::_incCalcValues; we calculate the peak counts from the event
+/// log.
+#define TALLY_INC_CALC_VARIABLES 2
 
 /**
  * @anchor sensor_tally_timing
@@ -139,6 +147,58 @@
 #define TALLY_EVENTS_DEFAULT_CODE "TallyCounterI2CEvents"
 /**@}*/
 
+/**
+ * @anchor sensor_tally_peak1
+ * @name Peak 1-Minute Events
+ * The most events within any one minute, from a Northern Widget Tally event
+ * counter with an event log
+ *
+ * {{ @ref TallyCounterI2C_Peak1MinEvents::TallyCounterI2C_Peak1MinEvents }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; events are an integer
+/// should be 0 - resolution is 1 event.
+#define TALLY_PEAK1_RESOLUTION 0
+/// @brief Sensor variable number; the peak 1-minute count is stored in
+/// sensorValues[1].
+#define TALLY_PEAK1_VAR_NUM 1
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "counter"
+#define TALLY_PEAK1_VAR_NAME "counter"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "event"
+#define TALLY_PEAK1_UNIT_NAME "event"
+/// @brief Default variable short code; "TallyCounterI2CPeak1Min"
+#define TALLY_PEAK1_DEFAULT_CODE "TallyCounterI2CPeak1Min"
+/**@}*/
+
+/**
+ * @anchor sensor_tally_peak5
+ * @name Peak 5-Minute Events
+ * The most events within any five minutes, from a Northern Widget Tally event
+ * counter with an event log
+ *
+ * {{ @ref TallyCounterI2C_Peak5MinEvents::TallyCounterI2C_Peak5MinEvents }}
+ */
+/**@{*/
+/// @brief Decimals places in string representation; events are an integer
+/// should be 0 - resolution is 1 event.
+#define TALLY_PEAK5_RESOLUTION 0
+/// @brief Sensor variable number; the peak 5-minute count is stored in
+/// sensorValues[2].
+#define TALLY_PEAK5_VAR_NUM 2
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "counter"
+#define TALLY_PEAK5_VAR_NAME "counter"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/); "event"
+#define TALLY_PEAK5_UNIT_NAME "event"
+/// @brief Default variable short code; "TallyCounterI2CPeak5Min"
+#define TALLY_PEAK5_DEFAULT_CODE "TallyCounterI2CPeak5Min"
+/**@}*/
+
 /// @brief The default address of the Tally
 #define TALLY_ADDRESS_BASE 0x33
 
@@ -202,6 +262,17 @@ class TallyCounterI2C : public Sensor {
     String getSensorLocation(void) override;
 
     // bool startSingleMeasurement(void) override;  // for forced mode
+    /**
+     * @brief Set whether the log of event times is read after the count, to
+     * give the peak 1- and 5-minute counts.
+     *
+     * @warning Only enable this if the Tally firmware keeps an event log!
+     *
+     * @param tipLogging True to read the event log.  Default is false.
+     */
+    void setTipLogging(bool tipLogging) {
+        _tipLogging = tipLogging;
+    }
     /**
      * @copydoc Sensor::addSingleMeasurementResult()
      */
@@ -216,6 +287,10 @@ class TallyCounterI2C : public Sensor {
      * @brief The I2C address of the Tally counter.
      */
     uint8_t _i2cAddressHex;
+    /**
+     * @brief True if the event log is read
+     */
+    bool _tipLogging = false;
 };
 
 /* clang-format off */
@@ -261,5 +336,95 @@ class TallyCounterI2C_Events : public Variable {
      */
     ~TallyCounterI2C_Events() {}
 };
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [peak 1-minute events output](@ref sensor_tally_peak1) from a
+ * [Tally Counter I2C](@ref sensor_tally) - shows the most events within any
+ * one minute since the last read.
+ *
+ * @ingroup sensor_tally
+ */
+/* clang-format on */
+class TallyCounterI2C_Peak1MinEvents : public Variable {
+ public:
+    /**
+     * @brief Construct a new TallyCounterI2C_Peak1MinEvents object.
+     *
+     * @param parentSense The parent TallyCounterI2C providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "TallyCounterI2CPeak1Min".
+     */
+    explicit TallyCounterI2C_Peak1MinEvents(
+        TallyCounterI2C* parentSense, const char* uuid = "",
+        const char* varCode = TALLY_PEAK1_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)TALLY_PEAK1_VAR_NUM,
+                   (uint8_t)TALLY_PEAK1_RESOLUTION, TALLY_PEAK1_VAR_NAME,
+                   TALLY_PEAK1_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new TallyCounterI2C_Peak1MinEvents object.
+     *
+     * @note This must be tied with a parent TallyCounterI2C before it can be
+     * used.
+     */
+    TallyCounterI2C_Peak1MinEvents()
+        : Variable((const uint8_t)TALLY_PEAK1_VAR_NUM,
+                   (uint8_t)TALLY_PEAK1_RESOLUTION, TALLY_PEAK1_VAR_NAME,
+                   TALLY_PEAK1_UNIT_NAME, TALLY_PEAK1_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the TallyCounterI2C_Peak1MinEvents object - no action
+     * needed.
+     */
+    ~TallyCounterI2C_Peak1MinEvents() {}
+};
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for the
+ * [peak 5-minute events output](@ref sensor_tally_peak5) from a
+ * [Tally Counter I2C](@ref sensor_tally) - shows the most events within any
+ * five minutes since the last read.
+ *
+ * @ingroup sensor_tally
+ */
+/* clang-format on */
+class TallyCounterI2C_Peak5MinEvents : public Variable {
+ public:
+    /**
+     * @brief Construct a new TallyCounterI2C_Peak5MinEvents object.
+     *
+     * @param parentSense The parent TallyCounterI2C providing the result
+     * values.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "TallyCounterI2CPeak5Min".
+     */
+    explicit TallyCounterI2C_Peak5MinEvents(
+        TallyCounterI2C* parentSense, const char* uuid = "",
+        const char* varCode = TALLY_PEAK5_DEFAULT_CODE)
+        : Variable(parentSense, (const uint8_t)TALLY_PEAK5_VAR_NUM,
+                   (uint8_t)TALLY_PEAK5_RESOLUTION, TALLY_PEAK5_VAR_NAME,
+                   TALLY_PEAK5_UNIT_NAME, varCode, uuid) {}
+    /**
+     * @brief Construct a new TallyCounterI2C_Peak5MinEvents object.
+     *
+     * @note This must be tied with a parent TallyCounterI2C before it can be
+     * used.
+     */
+    TallyCounterI2C_Peak5MinEvents()
+        : Variable((const uint8_t)TALLY_PEAK5_VAR_NUM,
+                   (uint8_t)TALLY_PEAK5_RESOLUTION, TALLY_PEAK5_VAR_NAME,
+                   TALLY_PEAK5_UNIT_NAME, TALLY_PEAK5_DEFAULT_CODE) {}
+    /**
+     * @brief Destroy the TallyCounterI2C_Peak5MinEvents object - no action
+     * needed.
+     */
+    ~TallyCounterI2C_Peak5MinEvents() {}
+};
 /**@}*/
 #endif  // SRC_SENSORS_TallyCounterI2C_H_
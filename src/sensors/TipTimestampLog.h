@@ -0,0 +1,101 @@
+/**
+ * @file TipTimestampLog.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the functions to read the optional log of event times from
+ * an I2C event counter and find the busiest minute and five minutes in it.
+ *
+ * The log protocol is:
+ * - The logger writes the single command byte #TIP_LOG_COMMAND.
+ * - Each read that follows returns a count byte of up to
+ * #TIP_LOG_TIPS_PER_BLOCK and then that many event ages.  Each age is two
+ * bytes, most significant byte first, and is the number of seconds before the
+ * command that the event happened.  The newest events come first.
+ * - A block with fewer than #TIP_LOG_TIPS_PER_BLOCK ages is the last one.  The
+ * counter then empties its log.
+ *
+ * A counter keeps its log in a ring buffer, so only the newest events are kept
+ * if there were more than fit.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_TIPTIMESTAMPLOG_H_
+#define SRC_SENSORS_TIPTIMESTAMPLOG_H_
+
+#include <Arduino.h>
+
+#ifndef TIP_LOG_MAX_TIPS
+/**
+ * @brief The most event times read from a counter's log in each reading.
+ *
+ * The times are held on the stack only while the reading is processed.
+ */
+#define TIP_LOG_MAX_TIPS 90
+#endif
+
+/// @brief The command byte asking a counter for its log of event times.
+#define TIP_LOG_COMMAND 0x54
+/// @brief The most event times in each block read; one count byte and 15
+/// two-byte ages fit in the 32 byte buffer of the AVR Wire library.
+#define TIP_LOG_TIPS_PER_BLOCK 15
+
+/**
+ * @brief Read the log of event times from a counter.
+ *
+ * @tparam WireType The I2C class, TwoWire or SoftwareWire
+ * @param i2c The I2C instance the counter is on
+ * @param i2cAddressHex The I2C address of the counter
+ * @param ages The array for the event ages, in seconds, newest first
+ * @param maxTips The size of the age array
+ * @return **int16_t** The number of ages read, or -1 if the counter didn't
+ * answer
+ */
+template <typename WireType>
+int16_t readTipLog(WireType* i2c, uint8_t i2cAddressHex, uint16_t* ages,
+                   uint8_t maxTips) {
+    i2c->beginTransmission(i2cAddressHex);
+    i2c->write(static_cast<uint8_t>(TIP_LOG_COMMAND));
+    if (i2c->endTransmission() != 0) return -1;
+
+    uint8_t nTips = 0;
+    uint8_t nBlock;
+    do {
+        uint8_t blockSize = 1 + 2 * TIP_LOG_TIPS_PER_BLOCK;
+        if (i2c->requestFrom(i2cAddressHex, blockSize) == 0) {
+            return nTips > 0 ? nTips : -1;
+        }
+        nBlock = i2c->read();
+        if (nBlock > TIP_LOG_TIPS_PER_BLOCK) return -1;
+        for (uint8_t i = 0; i < nBlock && i2c->available() >= 2; i++) {
+            uint16_t age = static_cast<uint16_t>(i2c->read()) << 8;
+            age |= i2c->read();
+            // Keep the newest ones if they don't all fit
+            if (nTips < maxTips) ages[nTips++] = age;
+        }
+    } while (nBlock == TIP_LOG_TIPS_PER_BLOCK && nTips < maxTips);
+    return nTips;
+}
+
+/**
+ * @brief Find the most events within any window of the given length.
+ *
+ * @param ages The event ages, in seconds, newest first
+ * @param nTips The number of ages
+ * @param window_s The window length in seconds
+ * @return **uint8_t** The largest number of events in one window
+ */
+inline uint8_t peakTipsInWindow(const uint16_t* ages, uint8_t nTips,
+                                uint16_t window_s) {
+    uint8_t peak  = 0;
+    uint8_t first = 0;
+    // The ages only go up, so the window start only moves forward
+    for (uint8_t last = 0; last < nTips; last++) {
+        while (ages[last] - ages[first] >= window_s) first++;
+        if (last - first + 1 > peak) peak = last - first + 1;
+    }
+    return peak;
+}
+
+#endif  // SRC_SENSORS_TIPTIMESTAMPLOG_H_
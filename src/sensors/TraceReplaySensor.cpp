@@ -0,0 +1,188 @@
+/**
+ * @file TraceReplaySensor.cpp
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Implements the TraceReplaySensor class.
+ */
+
+#include "TraceReplaySensor.h"
+
+
+// The constructor - there is no data pin
+TraceReplaySensor::TraceReplaySensor(Stream* trace, uint8_t traceIndex,
+                                     uint8_t numValues, int8_t powerPin,
+                                     uint8_t  measurementsToAverage,
+                                     uint32_t warmUpTime_ms,
+                                     uint32_t stabilizationTime_ms,
+                                     uint32_t measurementTime_ms)
+    : Sensor("TraceReplaySensor", numValues, warmUpTime_ms,
+             stabilizationTime_ms, measurementTime_ms, powerPin, -1,
+             measurementsToAverage, TRACE_REPLAY_INC_CALC_VARIABLES),
+      _trace(trace),
+      _traceIndex(traceIndex) {
+    for (uint8_t k = 0; k < MAX_NUMBER_VARS; k++) _values[k] = -9999;
+}
+// Destructor
+TraceReplaySensor::~TraceReplaySensor() {}
+
+
+void TraceReplaySensor::setTimeScale(uint8_t timeScale) {
+    _timeScale = timeScale > 0 ? timeScale : 1;
+}
+
+
+// Carriage returns are dropped, so files with either line ending work
+int TraceReplaySensor::readField(char* buffer) {
+    uint8_t len = 0;
+    int     c;
+    while ((c = _trace->read()) >= 0 && c != ',' && c != '\n') {
+        if (c != '\r' && len < MS_TRACE_REPLAY_FIELD_SIZE - 1) {
+            buffer[len++] = c;
+        }
+    }
+    buffer[len] = '\0';
+    // A last line without an end still counts
+    if (c < 0 && len > 0) return '\n';
+    return c;
+}
+
+
+// Each event line is the millis(), the name of the event and the index
+bool TraceReplaySensor::readCycle(void) {
+    char     field[MS_TRACE_REPLAY_FIELD_SIZE];
+    char     event[MS_TRACE_REPLAY_FIELD_SIZE];
+    bool     powered = false, awake = false, started = false;
+    uint32_t poweredAt = 0, awakeAt = 0, firstStartAt = 0, lastStartAt = 0;
+    uint32_t measureSum = 0;
+    uint8_t  measured   = 0;
+    _wakeFails          = false;
+    _startFails         = 0;
+
+    int end;
+    while (_trace != nullptr && (end = readField(field)) >= 0) {
+        // Skip the lines of a single field, like the time of the cycle
+        if (end != ',') continue;
+
+        if (strcmp(field, "values") == 0) {
+            int16_t first = static_cast<int16_t>(_traceIndex) + 1 -
+                _numReturnedValues;
+            int16_t column = 0;
+            do {
+                end       = readField(field);
+                int16_t k = column - first;
+                if (k >= 0 && k < _numReturnedValues) {
+                    _values[k] = field[0] != '\0' ? atof(field) : -9999;
+                }
+                column++;
+            } while (end == ',');
+
+            if (powered && awake) {
+                _warmUpTime_ms = scaleTime(awakeAt - poweredAt);
+            }
+            if (awake && started) {
+                _stabilizationTime_ms = scaleTime(firstStartAt - awakeAt);
+            }
+            if (measured > 0) {
+                _measurementTime_ms = scaleTime(measureSum / measured);
+            }
+            _cyclesReplayed++;
+            MS_DBG(getSensorNameAndLocation(), F("replaying cycle"),
+                   _cyclesReplayed, F("with times"), _warmUpTime_ms,
+                   _stabilizationTime_ms, _measurementTime_ms);
+            return true;
+        }
+
+        uint32_t time = strtoul(field, nullptr, 10);
+        if (readField(event) != ',') continue;
+        end           = readField(field);
+        uint8_t index = atoi(field);
+        while (end == ',') end = readField(field);
+        if (index != _traceIndex) continue;
+
+        if (strcmp(event, "powered") == 0) {
+            powered   = true;
+            poweredAt = time;
+        } else if (strcmp(event, "awake") == 0) {
+            awake   = true;
+            awakeAt = time;
+        } else if (strcmp(event, "wake failed") == 0) {
+            _wakeFails = true;
+        } else if (strcmp(event, "measuring") == 0) {
+            if (!started) firstStartAt = time;
+            started     = true;
+            lastStartAt = time;
+        } else if (strcmp(event, "start failed") == 0) {
+            if (_startFails < 0xFF) _startFails++;
+        } else if (strcmp(event, "result") == 0 && lastStartAt != 0) {
+            measureSum += time - lastStartAt;
+            measured++;
+            lastStartAt = 0;
+        }
+    }
+
+    MS_DBG(getSensorNameAndLocation(), F("has replayed the whole trace"));
+    _traceFinished = true;
+    for (uint8_t k = 0; k < MAX_NUMBER_VARS; k++) _values[k] = -9999;
+    return false;
+}
+
+
+void TraceReplaySensor::powerUp(void) {
+    _startsMade = 0;
+    if (!_traceFinished) readCycle();
+    Sensor::powerUp();
+}
+
+
+bool TraceReplaySensor::wake(void) {
+    bool success = Sensor::wake();
+    if (success && _wakeFails) {
+        MS_DBG(getSensorNameAndLocation(), F("failed to wake in the trace"));
+        // Make sure that the wake time and wake success bit (bit 4) are unset
+        _millisSensorActivated = 0;
+        _sensorStatus &= 0b11101111;
+        success = false;
+    }
+    return success;
+}
+
+
+bool TraceReplaySensor::startSingleMeasurement(void) {
+    bool success = Sensor::startSingleMeasurement();
+    if (success && _startsMade < _startFails) {
+        MS_DBG(getSensorNameAndLocation(),
+               F("failed to start a measurement in the trace"));
+        // Make sure that the measurement start time and success bit (bit 6)
+        // are unset
+        _millisMeasurementRequested = 0;
+        _sensorStatus &= 0b10111111;
+        success = false;
+    }
+    if (_startsMade < 0xFF) _startsMade++;
+    return success;
+}
+
+
+bool TraceReplaySensor::addSingleMeasurementResult(void) {
+    bool measuring = bitRead(_sensorStatus, 6);
+
+    // Check a measurement was *successfully* started (status bit 6 set)
+    // Only go on to get a result if it was
+    if (measuring) {
+        MS_DBG(getSensorNameAndLocation(), F("is reporting:"), _values[0]);
+    } else {
+        MS_DBG(getSensorNameAndLocation(), F("is not currently measuring!"));
+    }
+    for (uint8_t k = 0; k < _numReturnedValues; k++) {
+        verifyAndAddMeasurementResult(k, measuring ? _values[k] : -9999);
+    }
+
+    // Unset the time stamp for the beginning of this measurement
+    _millisMeasurementRequested = 0;
+    // Unset the status bits for a measurement request (bits 5 & 6)
+    _sensorStatus &= 0b10011111;
+
+    return true;
+}
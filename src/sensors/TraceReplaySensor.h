@@ -0,0 +1,313 @@
+/**
+ * @file TraceReplaySensor.h
+ * @copyright 2017-2022 Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino
+ * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
+ *
+ * @brief Contains the TraceReplaySensor sensor subclass and the variable
+ * subclass TraceReplaySensor_Value.
+ *
+ * These are for a sensor that replays the timing and values of a real one
+ * from the update trace of a logger in the field.
+ */
+/* clang-format off */
+/**
+ * @defgroup sensor_trace_replay Trace Replay Sensor
+ * Classes for a sensor replayed from an update trace, with no hardware.
+ *
+ * @ingroup the_sensors
+ *
+ * @tableofcontents
+ * @m_footernavigation
+ *
+ * @section sensor_trace_replay_notes Quick Notes
+ * - Needs nothing attached to the board
+ * - Replays one sensor of the `<logger id>_trace.txt` file written by a
+ * logger built with `MS_TRACE_BUFFER_SIZE`, one logged cycle per update
+ * - The warm-up, stabilization and measurement times of each update are the
+ * ones the real sensor took in that cycle, optionally sped up
+ * - Wakes and measurement starts that failed in the field fail again
+ * - Each measurement gives the values the real sensor gave in that cycle
+ *
+ * The SimulatedSensor stands in for a sensor with fixed timing.  Real
+ * sensors aren't so tidy: SDI-12 and Modbus sensors answer late, some fail to
+ * wake now and then, and the worst stations are the ones worth timing a
+ * change of the update cycle against.  A logger built with
+ * `MS_TRACE_BUFFER_SIZE` writes each sensor's steps through each cycle to its
+ * trace file, closed by a `values` line with the value of each variable.  A
+ * bench logger with a TraceReplaySensor for each traced sensor then goes
+ * through the same cycles, with the same delays, failures and values, so
+ * changes to the scheduler, the files or the publishers can be timed against
+ * a real station's record.
+ *
+ * The times of each cycle are taken from the trace: the warm-up from when the
+ * sensor was powered to when it woke, the stabilization from when it woke to
+ * its first measurement, and the measurement time as the mean of its
+ * measurements.  Steps missing from a cycle, like the power up of a sensor
+ * that is always on, keep the times given to the constructor.  A time scale
+ * given to setTimeScale() divides every time replayed, to run through a long
+ * trace quickly.  Replay on the board itself runs on the real millis(); the
+ * library has no host build to run it on a virtual clock.
+ *
+ * Each replayed sensor reads its own way through the trace, so each needs its
+ * own Stream of it; with SdFat, open the file once for each sensor.  A cycle
+ * is read each time the sensor is powered up, which the variable array does
+ * once for each update.
+ *
+ * @section sensor_trace_replay_ctor Sensor Constructor
+ * {{ @ref TraceReplaySensor::TraceReplaySensor }}
+ *
+ * @section sensor_trace_replay_examples Example Code
+ *
+ * The trace replay sensor is used in the @menulink{trace_replay_sensor}
+ * example
+ *
+ * @menusnip{trace_replay_sensor}
+ */
+/* clang-format on */
+
+// Header Guards
+#ifndef SRC_SENSORS_TRACEREPLAYSENSOR_H_
+#define SRC_SENSORS_TRACEREPLAYSENSOR_H_
+
+// Debugging Statement
+// #define MS_TRACEREPLAYSENSOR_DEBUG
+
+#ifdef MS_TRACEREPLAYSENSOR_DEBUG
+#define MS_DEBUGGING_STD "TraceReplaySensor"
+#endif
+
+// Included Dependencies
+#include "ModSensorDebugger.h"
+#undef MS_DEBUGGING_STD
+#include "VariableBase.h"
+#include "SensorBase.h"
+
+/** @ingroup sensor_trace_replay */
+/**@{*/
+
+// Sensor Specific Defines
+/// @brief Sensor::_incCalcValues; the replayed sensor has no calculated
+/// values.
+#define TRACE_REPLAY_INC_CALC_VARIABLES 0
+
+#if !defined(MS_TRACE_REPLAY_FIELD_SIZE)
+/**
+ * @brief The longest field of a trace line that is kept, in characters.
+ *
+ * Event names and values are far shorter; anything longer is cut short.
+ */
+#define MS_TRACE_REPLAY_FIELD_SIZE 24
+#endif
+
+/**
+ * @anchor sensor_trace_replay_value
+ * @name Value
+ * A value replayed from the trace
+ * - The name, unit and resolution are those of the variable traced
+ *
+ * {{ @ref TraceReplaySensor_Value::TraceReplaySensor_Value }}
+ */
+/**@{*/
+/// @brief Default variable short code; "ReplayedValue"
+#define TRACE_REPLAY_VALUE_DEFAULT_CODE "ReplayedValue"
+/**@}*/
+
+
+/* clang-format off */
+/**
+ * @brief The Sensor sub-class for a
+ * [sensor replayed from a trace](@ref sensor_trace_replay).
+ */
+/* clang-format on */
+class TraceReplaySensor : public Sensor {
+ public:
+    /**
+     * @brief Construct a new TraceReplaySensor object.
+     *
+     * @param trace The trace to replay, like a File of the
+     * `<logger id>_trace.txt` file opened for reading.  It must stay open
+     * while the sensor is used.
+     * @param traceIndex The index of the sensor in the trace: the position of
+     * its last variable in the traced logger's variable array.  The values
+     * are taken from the `values` columns ending at this one.
+     * @param numValues The number of values the real sensor gave, at most
+     * #MAX_NUMBER_VARS
+     * @param powerPin The pin on the mcu to switch as if it powered the
+     * sensor.  Use -1 to switch none.
+     * @param measurementsToAverage The number of measurements to take and
+     * average before giving a "final" result from the sensor; optional with a
+     * default value of 1.
+     * @param warmUpTime_ms The warm-up time for a cycle whose trace doesn't
+     * show one; optional with a default of 0.
+     * @param stabilizationTime_ms The stabilization time for a cycle whose
+     * trace doesn't show one; optional with a default of 0.
+     * @param measurementTime_ms The measurement time for a cycle whose trace
+     * doesn't show one; optional with a default of 0.
+     */
+    TraceReplaySensor(Stream* trace, uint8_t traceIndex, uint8_t numValues,
+                      int8_t powerPin = -1, uint8_t measurementsToAverage = 1,
+                      uint32_t warmUpTime_ms        = 0,
+                      uint32_t stabilizationTime_ms = 0,
+                      uint32_t measurementTime_ms   = 0);
+    /**
+     * @brief Destroy the TraceReplaySensor object - no action needed.
+     */
+    ~TraceReplaySensor();
+
+    /**
+     * @brief Speed up the replay by dividing every time in the trace.
+     *
+     * @param timeScale The factor to divide the times by; 1 (the default) to
+     * replay them as they were.
+     */
+    void setTimeScale(uint8_t timeScale);
+    /**
+     * @brief Check whether the whole trace has been replayed.
+     *
+     * Once it has, each update keeps the times of the last cycle, and gives
+     * -9999 for every value.
+     *
+     * @return **bool** True if there are no more cycles in the trace
+     */
+    bool isTraceFinished(void) {
+        return _traceFinished;
+    }
+    /**
+     * @brief Get the number of cycles of the trace replayed so far.
+     *
+     * @return **uint16_t** The number of cycles
+     */
+    uint16_t getCyclesReplayed(void) {
+        return _cyclesReplayed;
+    }
+
+    /**
+     * @copydoc Sensor::powerUp()
+     *
+     * This also reads the next cycle of the trace, so it starts every replayed
+     * update.
+     */
+    void powerUp(void) override;
+    /**
+     * @copydoc Sensor::wake()
+     *
+     * This fails if the real sensor failed to wake in the cycle replayed.
+     */
+    bool wake(void) override;
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * As many starts fail as failed for the real sensor in the cycle
+     * replayed.
+     */
+    bool startSingleMeasurement(void) override;
+    /**
+     * @copydoc Sensor::addSingleMeasurementResult()
+     */
+    bool addSingleMeasurementResult(void) override;
+
+ private:
+    /**
+     * @brief Read the next cycle of the trace, through its `values` line,
+     * and set the times, failures and values to replay.
+     *
+     * @return **bool** True if a whole cycle was read
+     */
+    bool readCycle(void);
+    /**
+     * @brief Read one comma separated field of the trace.
+     *
+     * @param buffer The buffer for the field, of #MS_TRACE_REPLAY_FIELD_SIZE
+     * @return **int** The character that ended the field, ',' or '\\n', or
+     * -1 at the end of the trace
+     */
+    int readField(char* buffer);
+    /**
+     * @brief Divide a time in the trace by the time scale.
+     *
+     * @param time_ms The time in the trace
+     * @return **uint32_t** The time to replay
+     */
+    uint32_t scaleTime(uint32_t time_ms) {
+        return time_ms / _timeScale;
+    }
+
+    /**
+     * @brief The trace being replayed
+     */
+    Stream* _trace;
+    /**
+     * @brief The index of the sensor in the trace
+     */
+    uint8_t _traceIndex;
+    /**
+     * @brief The factor all times are divided by
+     */
+    uint8_t _timeScale = 1;
+    /**
+     * @brief True once the end of the trace has been reached
+     */
+    bool _traceFinished = false;
+    /**
+     * @brief The number of cycles replayed
+     */
+    uint16_t _cyclesReplayed = 0;
+    /**
+     * @brief True if the sensor failed to wake in the cycle replayed
+     */
+    bool _wakeFails = false;
+    /**
+     * @brief The number of starts that failed in the cycle replayed
+     */
+    uint8_t _startFails = 0;
+    /**
+     * @brief The number of starts made so far in this update
+     */
+    uint8_t _startsMade = 0;
+    /**
+     * @brief The values of the cycle replayed
+     */
+    float _values[MAX_NUMBER_VARS];
+};
+
+
+/* clang-format off */
+/**
+ * @brief The Variable sub-class used for a
+ * [value replayed](@ref sensor_trace_replay_value) from a
+ * [trace](@ref sensor_trace_replay).
+ */
+/* clang-format on */
+class TraceReplaySensor_Value : public Variable {
+ public:
+    /**
+     * @brief Construct a new TraceReplaySensor_Value object.
+     *
+     * @param parentSense The parent TraceReplaySensor providing the result
+     * values.
+     * @param varNum The position of the value among the values of the real
+     * sensor, from 0
+     * @param varName The name of the variable traced, in the
+     * [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/)
+     * @param varUnit The unit of the variable traced, in the
+     * [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/)
+     * @param decimalResolution The decimal places of the variable traced
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "ReplayedValue".
+     */
+    TraceReplaySensor_Value(
+        TraceReplaySensor* parentSense, uint8_t varNum, const char* varName,
+        const char* varUnit, uint8_t decimalResolution, const char* uuid = "",
+        const char* varCode = TRACE_REPLAY_VALUE_DEFAULT_CODE)
+        : Variable(parentSense, varNum, decimalResolution, varName, varUnit,
+                   varCode, uuid) {}
+    /**
+     * @brief Destroy the TraceReplaySensor_Value object - no action needed.
+     */
+    ~TraceReplaySensor_Value() {}
+};
+/**@}*/
+#endif  // SRC_SENSORS_TRACEREPLAYSENSOR_H_
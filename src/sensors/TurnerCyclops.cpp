@@ -20,14 +20,28 @@ TurnerCyclops::TurnerCyclops(int8_t powerPin, uint8_t adsChannel,
              CYCLOPS_STABILIZATION_TIME_MS, CYCLOPS_MEASUREMENT_TIME_MS,
              powerPin, -1, measurementsToAverage, CYCLOPS_INC_CALC_VARIABLES),
       _adsChannel(adsChannel),
-      _conc_std(conc_std),
-      _volt_std(volt_std),
-      _volt_blank(volt_blank),
+      _calibration(LinearCalibration::fromPoints(volt_blank, 0, volt_std,
+                                                 conc_std)),
       _i2cAddress(i2cAddress) {}
 // Destructor
 TurnerCyclops::~TurnerCyclops() {}
 
 
+// Reads through a shared ADC, registering our channel for its scans
+void TurnerCyclops::setADC(TIADS1x15Bus& adc) {
+    _adsBus     = &adc;
+    _i2cAddress = adc.getI2CAddress();
+    adc.registerChannel(_adsChannel);
+    if (_autoRange) adc.setAutoRange(_adsChannel, true);
+}
+
+
+void TurnerCyclops::setAutoRange(bool autoRange) {
+    _autoRange = autoRange;
+    if (_adsBus != nullptr) _adsBus->setAutoRange(_adsChannel, autoRange);
+}
+
+
 String TurnerCyclops::getSensorLocation(void) {
 #ifndef MS_USE_ADS1015
     String sensorLocation = F("ADS1115_0x");
@@ -51,49 +65,59 @@ bool TurnerCyclops::addSingleMeasurementResult(void) {
     if (bitRead(_sensorStatus, 6)) {
         MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
+        if (_adsBus != nullptr) {
+            // The shared ADC is already set up, and may have converted this
+            // channel in a scan for another sensor
+            adcVoltage = _adsBus->readVoltage(_adsChannel);
+            MS_DBG(F("  Shared ADS channel"), _adsChannel, F(":"), adcVoltage,
+                   F("with PGA setting"), _adsBus->getGain(_adsChannel));
+        } else {
 // Create an Auxillary ADD object
 // We create and set up the ADC object here so that each sensor using
 // the ADC may set the gain appropriately without effecting others.
 #ifndef MS_USE_ADS1015
-        Adafruit_ADS1115 ads(_i2cAddress);  // Use this for the 16-bit version
+            // Use this for the 16-bit version
+            Adafruit_ADS1115 ads(_i2cAddress);
 #else
-        Adafruit_ADS1015 ads(_i2cAddress);  // Use this for the 12-bit version
+            // Use this for the 12-bit version
+            Adafruit_ADS1015 ads(_i2cAddress);
 #endif
-        // ADS Library default settings:
-        //  - TI1115 (16 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 128 samples per second (8ms conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-        //  - TI1015 (12 bit)
-        //    - single-shot mode (powers down between conversions)
-        //    - 1600 samples per second (625µs conversion time)
-        //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
-
-        // Bump the gain up to 1x = +/- 4.096V range
-        // Sensor return range is 0-2.5V, but the next gain option is 2x which
-        // only allows up to 2.048V
-        ads.setGain(GAIN_ONE);
-        // Begin ADC
-        ads.begin();
-
-        // Print out the calibration curve
-        MS_DBG(F("  Input calibration Curve:"), _volt_std, F("V at"), _conc_std,
-               F(".  "), _volt_blank, F("V blank."));
-
-        // Read Analog to Digital Converter (ADC)
-        // Taking this reading includes the 8ms conversion delay.
-        // We're allowing the ADS1115 library to do the bit-to-volts conversion
-        // for us
-        adcVoltage =
-            ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
-        MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
-               adcVoltage);
+            // ADS Library default settings:
+            //  - TI1115 (16 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 128 samples per second (8ms conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+            //  - TI1015 (12 bit)
+            //    - single-shot mode (powers down between conversions)
+            //    - 1600 samples per second (625µs conversion time)
+            //    - 2/3 gain +/- 6.144V range (limited to VDD +0.3V max)
+
+            // Bump the gain up to 1x = +/- 4.096V range
+            // Sensor return range is 0-2.5V, but the next gain option is 2x
+            // which only allows up to 2.048V
+            ads.setGain(GAIN_ONE);
+            // Begin ADC
+            ads.begin();
+
+            // Print out the calibration curve
+            MS_DBG(F("  Input calibration Curve:"),
+                   _calibration.getSlope(), F("x +"),
+                   _calibration.getOffset());
+
+            // Read Analog to Digital Converter (ADC)
+            // Taking this reading includes the 8ms conversion delay.
+            // We're allowing the ADS1115 library to do the bit-to-volts
+            // conversion for us
+            adcVoltage =
+                ads.readADC_SingleEnded_V(_adsChannel);  // Getting the reading
+            MS_DBG(F("  ads.readADC_SingleEnded_V("), _adsChannel, F("):"),
+                   adcVoltage);
+        }
 
         if (adcVoltage < 3.6 && adcVoltage > -0.3) {
             // Skip results out of range
             // Apply the unique calibration curve for the given sensor
-            calibResult = (_conc_std / (_volt_std - _volt_blank)) *
-                (adcVoltage - _volt_blank);
+            calibResult = _calibration.apply(adcVoltage);
             MS_DBG(F("  calibResult:"), calibResult);
         } else {  // set invalid voltages back to -9999
             adcVoltage = -9999;
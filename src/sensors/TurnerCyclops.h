@@ -140,6 +140,8 @@
 #undef MS_DEBUGGING_STD
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "TIADS1x15Bus.h"
+#include "CalibrationCurve.h"
 
 // Sensor Specific Defines
 /** @ingroup sensor_cyclops */
@@ -327,10 +329,38 @@ class TurnerCyclops : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Read the channel through an ADS shared with other sensors.
+     *
+     * The shared ADC is configured once and scans all of its channels
+     * together, instead of this sensor setting up its own ADS object for
+     * every reading.  The I2C address is taken from the shared ADC.
+     *
+     * @param adc The TIADS1x15Bus the channel is on
+     */
+    void setADC(TIADS1x15Bus& adc);
+    /**
+     * @brief Set whether the gain of the ADS is picked for each reading.
+     *
+     * Each reading uses the narrowest range of the ADS that holds the last
+     * reading, and is read again at a wider range if it clips.  This gives
+     * low concentrations up to 16 times the resolution of the fixed ±4.096V
+     * range.  See TIADS1x15Bus::setAutoRange().
+     *
+     * @note Auto-ranging needs a shared ADC; it is ignored for a sensor that
+     * sets up its own ADS object.
+     *
+     * @param autoRange True to auto-range the readings.  Default is false.
+     */
+    void setAutoRange(bool autoRange);
+
  private:
-    uint8_t _adsChannel;
-    float   _conc_std, _volt_std, _volt_blank;
-    uint8_t _i2cAddress;
+    uint8_t           _adsChannel;
+    LinearCalibration _calibration;
+    uint8_t           _i2cAddress;
+    // The shared ADC, if any
+    TIADS1x15Bus* _adsBus    = nullptr;
+    bool          _autoRange = false;
 };
 
 
@@ -43,6 +43,21 @@ YosemitechParent::YosemitechParent(
 YosemitechParent::~YosemitechParent() {}
 
 
+void YosemitechParent::setBus(RS485Bus& bus) {
+    _bus = &bus;
+    bus.addSensor(this);
+}
+
+
+// Holds a finished result while other sensors on the bus still need starting
+bool YosemitechParent::isMeasurementComplete(bool debug) {
+    if (!Sensor::isMeasurementComplete(debug)) return false;
+    if (_bus == nullptr || !bitRead(_sensorStatus, 6)) return true;
+    return !_bus->deferResult(_millisMeasurementRequested +
+                              _measurementTime_ms);
+}
+
+
 // The sensor installation location on the Mayfly
 String YosemitechParent::getSensorLocation(void) {
     String sensorLocation = F("modbus_0x");
@@ -85,7 +100,9 @@ bool YosemitechParent::wake(void) {
     MS_DBG(F("Start Measurement on"), getSensorNameAndLocation());
     while (!success && ntries < 5) {
         MS_DBG('(', ntries + 1, F("):"));
+        beginFrame();
         success = _ysensor.startMeasurement();
+        endFrame();
         ntries++;
     }
 
@@ -106,7 +123,10 @@ bool YosemitechParent::wake(void) {
     if (_model == Y511 || _model == Y514 || _model == Y551 || _model == Y560 ||
         _model == Y4000) {
         MS_DBG(F("Activate Brush on"), getSensorNameAndLocation());
-        if (_ysensor.activateBrush()) {
+        beginFrame();
+        bool brushed = _ysensor.activateBrush();
+        endFrame();
+        if (brushed) {
             MS_DBG(F("Brush activated."));
         } else {
             MS_DBG(F("Brush NOT activated!"));
@@ -132,7 +152,9 @@ bool YosemitechParent::sleep(void) {
     MS_DBG(F("Stop Measurement on"), getSensorNameAndLocation());
     while (!success && ntries < 5) {
         MS_DBG('(', ntries + 1, F("):"));
+        beginFrame();
         success = _ysensor.stopMeasurement();
+        endFrame();
         ntries++;
     }
     if (success) {
@@ -154,54 +176,24 @@ bool YosemitechParent::sleep(void) {
 
 // This turns on sensor power
 void YosemitechParent::powerUp(void) {
-    if (_powerPin >= 0) {
-        MS_DBG(F("Powering"), getSensorNameAndLocation(), F("with pin"),
-               _powerPin);
-        digitalWrite(_powerPin, HIGH);
-        // Mark the time that the sensor was powered
-        _millisPowerOn = millis();
-    }
+    // The primary power, and any rail it is on, is handled by the base class
+    Sensor::powerUp();
     if (_powerPin2 >= 0) {
         MS_DBG(F("Applying secondary power to"), getSensorNameAndLocation(),
                F("with pin"), _powerPin2);
         digitalWrite(_powerPin2, HIGH);
     }
-    if (_powerPin < 0 && _powerPin2 < 0) {
-        MS_DBG(F("Power to"), getSensorNameAndLocation(),
-               F("is not controlled by this library."));
-    }
-    // Set the status bit for sensor power attempt (bit 1) and success (bit 2)
-    _sensorStatus |= 0b00000110;
 }
 
 
 // This turns off sensor power
 void YosemitechParent::powerDown(void) {
-    if (_powerPin >= 0) {
-        MS_DBG(F("Turning off power to"), getSensorNameAndLocation(),
-               F("with pin"), _powerPin);
-        digitalWrite(_powerPin, LOW);
-        // Unset the power-on time
-        _millisPowerOn = 0;
-        // Unset the activation time
-        _millisSensorActivated = 0;
-        // Unset the measurement request time
-        _millisMeasurementRequested = 0;
-        // Unset the status bits for sensor power (bits 1 & 2),
-        // activation (bits 3 & 4), and measurement request (bits 5 & 6)
-        _sensorStatus &= 0b10000001;
-    }
+    Sensor::powerDown();
     if (_powerPin2 >= 0) {
         MS_DBG(F("Turning off secondary power to"), getSensorNameAndLocation(),
                F("with pin"), _powerPin2);
         digitalWrite(_powerPin2, LOW);
     }
-    if (_powerPin < 0 && _powerPin2 < 0) {
-        MS_DBG(F("Power to"), getSensorNameAndLocation(),
-               F("is not controlled by this library."));
-        // Do NOT unset any status bits or timestamps if we didn't really power
-        // down!
-    }
 }
 
 
@@ -225,8 +217,10 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
 
                 // Get Values
                 MS_DBG(F("Get Values from"), getSensorNameAndLocation());
+                beginFrame();
                 success = _ysensor.getValues(DOmgL, Turbidity, Cond, pH, Temp,
                                              ORP, Chlorophyll, BGA);
+                endFrame();
 
                 // Fix not-a-number values
                 if (!success || isnan(DOmgL)) DOmgL = -9999;
@@ -265,7 +259,9 @@ bool YosemitechParent::addSingleMeasurementResult(void) {
 
                 // Get Values
                 MS_DBG(F("Get Values from"), getSensorNameAndLocation());
+                beginFrame();
                 success = _ysensor.getValues(parmValue, tempValue, thirdValue);
+                endFrame();
 
                 // Fix not-a-number values
                 if (!success || isnan(parmValue)) parmValue = -9999;
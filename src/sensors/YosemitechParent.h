@@ -131,6 +131,7 @@
 #undef MS_DEBUGGING_DEEP
 #include "VariableBase.h"
 #include "SensorBase.h"
+#include "RS485Bus.h"
 #include "YosemitechModbus.h"
 
 /* clang-format off */
@@ -251,13 +252,41 @@ class YosemitechParent : public Sensor {
      */
     bool addSingleMeasurementResult(void) override;
 
+    /**
+     * @brief Share an RS485 bus with other modbus sensors.
+     *
+     * The bus keeps a quiet interval between the transactions of different
+     * sensors and starts every sensor's measurement before collecting any of
+     * their results; see RS485Bus.
+     *
+     * @param bus The RS485Bus of the stream the sensor is on
+     */
+    void setBus(RS485Bus& bus);
+    /**
+     * @copydoc Sensor::isMeasurementComplete()
+     *
+     * On a shared bus, a finished result may be held back while other sensors
+     * on the bus are waiting to be started.
+     */
+    bool isMeasurementComplete(bool debug = false) override;
+
  private:
+    // Wait for, and then release, a shared bus around each transaction
+    void beginFrame(void) {
+        if (_bus != nullptr) _bus->beginFrame(this);
+    }
+    void endFrame(void) {
+        if (_bus != nullptr) _bus->endFrame(this);
+    }
+
     yosemitech      _ysensor;
     yosemitechModel _model;
     byte            _modbusAddress;
     Stream*         _stream;
     int8_t          _RS485EnablePin;
     int8_t          _powerPin2;
+    // The shared bus, if any
+    RS485Bus* _bus = nullptr;
 };
 
 #endif  // SRC_SENSORS_YOSEMITECHPARENT_H_